@@ -166,6 +166,10 @@ main (int argc, char *argv[])
     {
     	Config::SetDefault ("ns3::TcpL4Protocol::SocketType", TypeIdValue (TcpVegas::GetTypeId ()));
     }
+    else if (protocol == "TcpBbr")
+    {
+    	Config::SetDefault ("ns3::TcpL4Protocol::SocketType", TypeIdValue (TcpBbr::GetTypeId ()));
+    }
     else
     {
 		std::cout<<protocol<<" Unkown protocol.\n";
@@ -178,6 +182,8 @@ main (int argc, char *argv[])
 	Config::SetDefault ("ns3::MmWave3gppPropagationLossModel::Shadowing", BooleanValue(true)); // enable or disable the shadowing effect
 
 	Config::SetDefault ("ns3::MmWave3gppChannel::UpdatePeriod", TimeValue (MilliSeconds (100))); // Set channel update period, 0 stands for no update.
+	Config::SetDefault ("ns3::MmWave3gppChannel::UpdateDistance", DoubleValue (0)); // Set channel update distance in meters, 0 stands for no update by distance.
+	Config::SetDefault ("ns3::MmWave3gppChannel::UpdateStaticLinks", BooleanValue (false)); // Keep the channel of the static UEs instead of redrawing it every period.
 	Config::SetDefault ("ns3::MmWave3gppChannel::CellScan", BooleanValue(false)); // Set true to use cell scanning method, false to use the default power method.
 	Config::SetDefault ("ns3::MmWave3gppChannel::Blockage", BooleanValue(false)); // use blockage or not
 	Config::SetDefault ("ns3::MmWave3gppChannel::PortraitMode", BooleanValue(true)); // use blockage model with UT in portrait mode
@@ -20,6 +20,9 @@
 
 #include "event-impl.h"
 #include "log.h"
+#include <atomic>
+#include <new>
+#include <thread>
 
 /**
  * \file
@@ -31,6 +34,214 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("EventImpl");
 
+namespace {
+
+/** Size of the size classes, and alignment of the blocks. */
+const std::size_t CLASS_SIZE = 16;
+/** Number of size classes: the largest block is 256 bytes. */
+const uint32_t N_CLASSES = 16;
+/** Size of the chunks the blocks are carved from. */
+const std::size_t CHUNK_SIZE = 64 * 1024;
+/** Number of free blocks of a size class above which a thread releases a batch. */
+const uint32_t CACHE_MAX = 1024;
+/** Number of free blocks released to the depot at once. */
+const uint32_t BATCH_SIZE = 256;
+
+/** A free block, linked in a free list. */
+struct FreeBlock
+{
+  FreeBlock *next;                      //!< Next block of the batch
+  FreeBlock *nextBatch;                 //!< Next batch, in the first block of a batch of the depot
+};
+
+/**
+ * The free blocks and the statistics of a thread.
+ *
+ * It is trivially constructible, so that the thread-local instances
+ * need no dynamic initialization.
+ */
+struct EventCache
+{
+  FreeBlock *free[N_CLASSES];           //!< Free lists, by size class
+  uint32_t count[N_CLASSES];            //!< Lengths of the free lists
+  std::atomic<uint64_t> allocations;    //!< Number of events allocated
+  std::atomic<uint64_t> bytes;          //!< Size of the events allocated
+  EventCache *next;                     //!< Next cache registered in the depot
+  bool registered;                      //!< True once registered in the depot
+};
+
+/**
+ * The batches of free blocks shared by the threads, the chunks, and
+ * the caches of the running threads. It is never destroyed, as events
+ * may be freed by static destructors.
+ */
+struct EventDepot
+{
+  std::atomic<bool> locked;             //!< Spin lock of the depot
+  FreeBlock *batches[N_CLASSES];        //!< Stacks of batches, by size class
+  void *chunks;                         //!< Chunks, linked by their first word
+  EventCache *caches;                   //!< Caches of the running threads
+  uint64_t allocations;                 //!< Events allocated by the exited threads
+  uint64_t bytes;                       //!< Size of the events allocated by the exited threads
+};
+
+/** The depot, zero-initialized. */
+EventDepot g_depot;
+/** The cache of the thread. */
+thread_local EventCache g_cache;
+
+/** Lock of the depot, for a scope. */
+class DepotLock
+{
+public:
+  DepotLock ()
+  {
+    while (g_depot.locked.exchange (true, std::memory_order_acquire))
+      {
+        std::this_thread::yield ();
+      }
+  }
+  ~DepotLock ()
+  {
+    g_depot.locked.store (false, std::memory_order_release);
+  }
+};
+
+/** Returns the blocks of the cache of a thread to the depot when it exits. */
+class EventCacheGuard
+{
+public:
+  ~EventCacheGuard ()
+  {
+    DepotLock lock;
+    for (uint32_t i = 0; i < N_CLASSES; i++)
+      {
+        if (g_cache.free[i] != 0)
+          {
+            g_cache.free[i]->nextBatch = g_depot.batches[i];
+            g_depot.batches[i] = g_cache.free[i];
+            g_cache.free[i] = 0;
+            g_cache.count[i] = 0;
+          }
+      }
+    g_depot.allocations += g_cache.allocations.load (std::memory_order_relaxed);
+    g_depot.bytes += g_cache.bytes.load (std::memory_order_relaxed);
+    g_cache.allocations.store (0, std::memory_order_relaxed);
+    g_cache.bytes.store (0, std::memory_order_relaxed);
+    for (EventCache **i = &g_depot.caches; *i != 0; i = &(*i)->next)
+      {
+        if (*i == &g_cache)
+          {
+            *i = g_cache.next;
+            break;
+          }
+      }
+    // The events freed later by the thread stay in its cache
+  }
+};
+
+/** Register the cache of the thread in the depot. */
+void
+RegisterCache (void)
+{
+  static thread_local EventCacheGuard guard;
+  DepotLock lock;
+  g_cache.next = g_depot.caches;
+  g_depot.caches = &g_cache;
+  g_cache.registered = true;
+}
+
+/**
+ * Refill the empty free list of a size class from the depot, or from
+ * a new chunk.
+ *
+ * \param [in] c The size class.
+ */
+void
+RefillCache (uint32_t c)
+{
+  FreeBlock *batch;
+  {
+    DepotLock lock;
+    batch = g_depot.batches[c];
+    if (batch != 0)
+      {
+        g_depot.batches[c] = batch->nextBatch;
+      }
+  }
+  uint32_t count = 0;
+  if (batch != 0)
+    {
+      for (FreeBlock *i = batch; i != 0; i = i->next)
+        {
+          count++;
+        }
+    }
+  else
+    {
+      // The first block of the chunk holds the link to the next chunk
+      char *chunk = static_cast<char *> (::operator new (CHUNK_SIZE));
+      std::size_t size = (c + 1) * CLASS_SIZE;
+      count = (CHUNK_SIZE - CLASS_SIZE) / size;
+      batch = reinterpret_cast<FreeBlock *> (chunk + CLASS_SIZE);
+      FreeBlock *block = batch;
+      for (uint32_t i = 1; i < count; i++)
+        {
+          block->next = reinterpret_cast<FreeBlock *> (reinterpret_cast<char *> (block) + size);
+          block = block->next;
+        }
+      block->next = 0;
+      DepotLock lock;
+      *reinterpret_cast<void **> (chunk) = g_depot.chunks;
+      g_depot.chunks = chunk;
+    }
+  g_cache.free[c] = batch;
+  g_cache.count[c] = count;
+}
+
+/**
+ * Release a batch of the free list of a size class to the depot.
+ *
+ * \param [in] c The size class.
+ */
+void
+ReleaseBatch (uint32_t c)
+{
+  if (!g_cache.registered)
+    {
+      RegisterCache ();
+    }
+  // Keep the block just freed, which is the most likely in the cache
+  FreeBlock *head = g_cache.free[c];
+  FreeBlock *batch = head->next;
+  FreeBlock *last = batch;
+  for (uint32_t i = 1; i < BATCH_SIZE; i++)
+    {
+      last = last->next;
+    }
+  head->next = last->next;
+  g_cache.count[c] -= BATCH_SIZE;
+  last->next = 0;
+  DepotLock lock;
+  batch->nextBatch = g_depot.batches[c];
+  g_depot.batches[c] = batch;
+}
+
+/**
+ * Add to a statistic of the cache of the thread. Only the thread writes
+ * it, so that it needs no atomic read-modify-write.
+ *
+ * \param [in,out] counter The statistic.
+ * \param [in] value The value to add.
+ */
+inline void
+AddToCounter (std::atomic<uint64_t> &counter, uint64_t value)
+{
+  counter.store (counter.load (std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+} // anonymous namespace
+
 EventImpl::~EventImpl ()
 {
   NS_LOG_FUNCTION (this);
@@ -66,4 +277,72 @@ EventImpl::IsCancelled (void)
   return m_cancel;
 }
 
+void *
+EventImpl::operator new (std::size_t size)
+{
+  if (!g_cache.registered)
+    {
+      RegisterCache ();
+    }
+  AddToCounter (g_cache.allocations, 1);
+  AddToCounter (g_cache.bytes, size);
+  if (size > N_CLASSES * CLASS_SIZE)
+    {
+      return ::operator new (size);
+    }
+  uint32_t c = (size - 1) / CLASS_SIZE;
+  if (g_cache.free[c] == 0)
+    {
+      RefillCache (c);
+    }
+  FreeBlock *block = g_cache.free[c];
+  g_cache.free[c] = block->next;
+  g_cache.count[c]--;
+  return block;
+}
+
+void
+EventImpl::operator delete (void *p, std::size_t size)
+{
+  if (size > N_CLASSES * CLASS_SIZE)
+    {
+      ::operator delete (p);
+      return;
+    }
+  uint32_t c = (size - 1) / CLASS_SIZE;
+  FreeBlock *block = static_cast<FreeBlock *> (p);
+  block->next = g_cache.free[c];
+  g_cache.free[c] = block;
+  if (++g_cache.count[c] > CACHE_MAX)
+    {
+      ReleaseBatch (c);
+    }
+}
+
+uint64_t
+EventImpl::GetAllocations (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  DepotLock lock;
+  uint64_t allocations = g_depot.allocations;
+  for (EventCache *i = g_depot.caches; i != 0; i = i->next)
+    {
+      allocations += i->allocations.load (std::memory_order_relaxed);
+    }
+  return allocations;
+}
+
+uint64_t
+EventImpl::GetAllocatedBytes (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  DepotLock lock;
+  uint64_t bytes = g_depot.bytes;
+  for (EventCache *i = g_depot.caches; i != 0; i = i->next)
+    {
+      bytes += i->bytes.load (std::memory_order_relaxed);
+    }
+  return bytes;
+}
+
 } // namespace ns3
@@ -21,6 +21,7 @@
 #define EVENT_IMPL_H
 
 #include <stdint.h>
+#include <cstddef>
 #include "simple-ref-count.h"
 
 /**
@@ -40,6 +41,14 @@ namespace ns3 {
  * when it reaches the time associated to this event. Most subclasses
  * are usually created by one of the many Simulator::Schedule
  * methods.
+ *
+ * The events are allocated from a pool: an event up to 256 bytes,
+ * i.e., with the arguments bound by MakeEvent() stored inline, gets a
+ * block of its 16-byte size class, taken from a free list of the
+ * calling thread. The free lists are refilled from chunks of 64 KiB,
+ * and exchange batches of blocks through a shared depot, so that an
+ * event may be freed by another thread than the one which allocated it.
+ * Larger events are allocated with the global operator new.
  */
 class EventImpl : public SimpleRefCount<EventImpl>
 {
@@ -66,6 +75,33 @@ public:
    */
   bool IsCancelled (void);
 
+  /**
+   * Allocate an event from the free list of its size class.
+   *
+   * \param [in] size The size of the event.
+   * \returns The memory of the event.
+   */
+  static void * operator new (std::size_t size);
+  /**
+   * Return the memory of an event to the free list of its size class.
+   *
+   * \param [in] p The memory of the event.
+   * \param [in] size The size of the event.
+   */
+  static void operator delete (void *p, std::size_t size);
+  /**
+   * Get the number of events allocated by all the threads.
+   *
+   * \returns The number of events allocated since the start of the program.
+   */
+  static uint64_t GetAllocations (void);
+  /**
+   * Get the number of bytes of the events allocated by all the threads.
+   *
+   * \returns The size of the events allocated since the start of the program.
+   */
+  static uint64_t GetAllocatedBytes (void);
+
 protected:
   /**
    * Implementation for Invoke().
@@ -0,0 +1,335 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ladder-scheduler.h"
+#include "event-impl.h"
+#include "assert.h"
+#include "log.h"
+#include <algorithm>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * Implementation of ns3::LadderScheduler class.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LadderScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED (LadderScheduler);
+
+namespace {
+
+/**
+ * \ingroup scheduler
+ * Compare two events by EventKey, to sort the buckets.
+ * \param [in] a The first event.
+ * \param [in] b The second event.
+ * \returns \c true if \c a is earlier than \c b
+ */
+bool
+EventLess (const Scheduler::Event &a, const Scheduler::Event &b)
+{
+  return a.key < b.key;
+}
+
+} // anonymous namespace
+
+TypeId
+LadderScheduler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LadderScheduler")
+    .SetParent<Scheduler> ()
+    .SetGroupName ("Core")
+    .AddConstructor<LadderScheduler> ()
+  ;
+  return tid;
+}
+
+LadderScheduler::LadderScheduler ()
+  : m_topStart (0),
+    m_topMin (~0ULL),
+    m_topMax (0),
+    m_nRungs (0),
+    m_bottomHead (0),
+    m_size (0)
+{
+  NS_LOG_FUNCTION (this);
+  // Allocated once, so that the rungs and their buckets do not move
+  m_rungs.resize (MAX_RUNGS);
+}
+
+LadderScheduler::~LadderScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+uint64_t
+LadderScheduler::GetCurrentStart (const Rung &rung)
+{
+  return rung.m_start + rung.m_current * rung.m_width;
+}
+
+uint32_t
+LadderScheduler::GetBucket (const Rung &rung, uint64_t ts)
+{
+  uint64_t bucket = (ts - rung.m_start) / rung.m_width;
+  // The last bucket also gets the events up to the current bucket of
+  // the previous rung
+  if (bucket >= rung.m_nBuckets)
+    {
+      return rung.m_nBuckets - 1;
+    }
+  return bucket;
+}
+
+uint32_t
+LadderScheduler::FindRung (uint64_t ts) const
+{
+  for (uint32_t i = 0; i < m_nRungs; i++)
+    {
+      // A rung whose buckets are all dequeued only waits to be removed:
+      // its events go to the next rung, or to Bottom
+      const Rung &rung = m_rungs[i];
+      if (rung.m_current < rung.m_nBuckets && ts >= GetCurrentStart (rung))
+        {
+          return i;
+        }
+    }
+  return m_nRungs;
+}
+
+void
+LadderScheduler::SpawnRung (Bucket &events, uint64_t min, uint64_t max)
+{
+  NS_LOG_FUNCTION (this << events.size () << min << max);
+  NS_ASSERT (m_nRungs < MAX_RUNGS);
+
+  // About one event per bucket
+  Rung &rung = m_rungs[m_nRungs];
+  uint64_t range = max - min;
+  rung.m_start = min;
+  rung.m_width = range / events.size () + 1;
+  rung.m_nBuckets = range / rung.m_width + 1;
+  rung.m_current = 0;
+  rung.m_count = events.size ();
+  if (rung.m_buckets.size () < rung.m_nBuckets)
+    {
+      rung.m_buckets.resize (rung.m_nBuckets);
+    }
+  for (Bucket::const_iterator i = events.begin (); i != events.end (); i++)
+    {
+      rung.m_buckets[(i->key.m_ts - min) / rung.m_width].push_back (*i);
+    }
+  events.clear ();
+  m_nRungs++;
+}
+
+void
+LadderScheduler::Refill (void)
+{
+  while (m_bottomHead == m_bottom.size () && m_size != 0)
+    {
+      m_bottom.clear ();
+      m_bottomHead = 0;
+
+      if (m_nRungs == 0)
+        {
+          NS_ASSERT (!m_top.empty ());
+          SpawnRung (m_top, m_topMin, m_topMax);
+          m_topStart = m_rungs[0].m_start + m_rungs[0].m_nBuckets * m_rungs[0].m_width;
+          m_topMin = ~0ULL;
+          m_topMax = 0;
+          continue;
+        }
+
+      Rung &rung = m_rungs[m_nRungs - 1];
+      if (rung.m_count == 0)
+        {
+          m_nRungs--;
+          continue;
+        }
+      while (rung.m_buckets[rung.m_current].empty ())
+        {
+          rung.m_current++;
+        }
+      Bucket &bucket = rung.m_buckets[rung.m_current];
+      rung.m_current++;
+      rung.m_count -= bucket.size ();
+
+      if (bucket.size () > BUCKET_THRESHOLD && m_nRungs < MAX_RUNGS)
+        {
+          uint64_t min = bucket.front ().key.m_ts;
+          uint64_t max = min;
+          for (Bucket::const_iterator i = bucket.begin (); i != bucket.end (); i++)
+            {
+              min = std::min (min, i->key.m_ts);
+              max = std::max (max, i->key.m_ts);
+            }
+          // Events at the same time cannot be split
+          if (min != max)
+            {
+              SpawnRung (bucket, min, max);
+              continue;
+            }
+        }
+
+      // The bucket gets the empty storage of Bottom
+      m_bottom.swap (bucket);
+      std::sort (m_bottom.begin (), m_bottom.end (), EventLess);
+    }
+}
+
+void
+LadderScheduler::InsertBottom (const Scheduler::Event &ev)
+{
+  if (m_bottomHead == m_bottom.size () || !(ev.key < m_bottom.back ().key))
+    {
+      m_bottom.push_back (ev);
+      return;
+    }
+  Bucket::iterator i = std::upper_bound (m_bottom.begin () + m_bottomHead, m_bottom.end (),
+                                         ev, EventLess);
+  if (i == m_bottom.begin () + m_bottomHead && m_bottomHead > 0)
+    {
+      m_bottomHead--;
+      m_bottom[m_bottomHead] = ev;
+      return;
+    }
+  m_bottom.insert (i, ev);
+}
+
+void
+LadderScheduler::Insert (const Scheduler::Event &ev)
+{
+  NS_LOG_FUNCTION (this << &ev);
+  uint64_t ts = ev.key.m_ts;
+  if (ts >= m_topStart)
+    {
+      m_top.push_back (ev);
+      m_topMin = std::min (m_topMin, ts);
+      m_topMax = std::max (m_topMax, ts);
+    }
+  else
+    {
+      uint32_t i = FindRung (ts);
+      if (i < m_nRungs)
+        {
+          Rung &rung = m_rungs[i];
+          rung.m_buckets[GetBucket (rung, ts)].push_back (ev);
+          rung.m_count++;
+        }
+      else
+        {
+          InsertBottom (ev);
+        }
+    }
+  m_size++;
+}
+
+bool
+LadderScheduler::IsEmpty (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_size == 0;
+}
+
+Scheduler::Event
+LadderScheduler::PeekNext (void) const
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!IsEmpty ());
+  // Bottom is refilled lazily, so that the events scheduled for the
+  // current time after it is emptied are appended to it
+  const_cast<LadderScheduler *> (this)->Refill ();
+  return m_bottom[m_bottomHead];
+}
+
+Scheduler::Event
+LadderScheduler::RemoveNext (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!IsEmpty ());
+  Refill ();
+  Scheduler::Event ev = m_bottom[m_bottomHead];
+  m_bottomHead++;
+  m_size--;
+  if (m_bottomHead == m_bottom.size ())
+    {
+      m_bottom.clear ();
+      m_bottomHead = 0;
+    }
+  return ev;
+}
+
+void
+LadderScheduler::Remove (const Scheduler::Event &ev)
+{
+  NS_LOG_FUNCTION (this << &ev);
+  NS_ASSERT (!IsEmpty ());
+  uint64_t ts = ev.key.m_ts;
+  Bucket *bucket;
+  if (ts >= m_topStart)
+    {
+      bucket = &m_top;
+    }
+  else
+    {
+      uint32_t i = FindRung (ts);
+      if (i == m_nRungs)
+        {
+          Bucket::iterator j = std::lower_bound (m_bottom.begin () + m_bottomHead, m_bottom.end (),
+                                                 ev, EventLess);
+          NS_ASSERT (j != m_bottom.end () && j->key.m_uid == ev.key.m_uid);
+          if (j == m_bottom.begin () + m_bottomHead)
+            {
+              m_bottomHead++;
+            }
+          else
+            {
+              m_bottom.erase (j);
+            }
+          m_size--;
+          return;
+        }
+      Rung &rung = m_rungs[i];
+      bucket = &rung.m_buckets[GetBucket (rung, ts)];
+      rung.m_count--;
+    }
+
+  // The buckets are not sorted: swap with the last event
+  for (Bucket::iterator j = bucket->begin (); j != bucket->end (); j++)
+    {
+      if (j->key.m_uid == ev.key.m_uid)
+        {
+          NS_ASSERT (ev.impl == j->impl);
+          *j = bucket->back ();
+          bucket->pop_back ();
+          if (m_top.empty ())
+            {
+              m_topMin = ~0ULL;
+              m_topMax = 0;
+            }
+          m_size--;
+          return;
+        }
+    }
+  NS_ASSERT (false);
+}
+
+} // namespace ns3
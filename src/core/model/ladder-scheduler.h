@@ -0,0 +1,162 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef LADDER_SCHEDULER_H
+#define LADDER_SCHEDULER_H
+
+#include "scheduler.h"
+#include <stdint.h>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * Declaration of ns3::LadderScheduler class.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup scheduler
+ * \brief a ladder queue event scheduler
+ *
+ * This event scheduler implements the ladder queue of "Ladder Queue: An
+ * O(1) Priority Queue Structure for Large-Scale Discrete Event Simulation"
+ * by Tang, Goh and Thng, 2005. The events are kept in three tiers:
+ *
+ * - Top: an unsorted array of the far future events;
+ * - the ladder: up to MAX_RUNGS rungs of buckets, each an unsorted array.
+ *   The first rung is built from Top when the ladder is empty, with about
+ *   one event per bucket. A bucket with more than BUCKET_THRESHOLD events
+ *   is split into a finer rung before it is dequeued;
+ * - Bottom: a sorted array of the earliest events, which is refilled from
+ *   the first non-empty bucket of the last rung.
+ *
+ * Insertion is O(1) in Top and the ladder. Events at the same timestamp
+ * cannot be split, so a bucket of such events goes to Bottom whatever its
+ * size, where the events are in the order of their uids. An event inserted
+ * in Bottom at the latest timestamp, as the events scheduled for the
+ * current time, is appended in O(1). This suits the bursts of events at
+ * identical timestamps of the slotted PHYs.
+ *
+ * The buckets are contiguous arrays, reused across rungs to avoid
+ * allocations. Remove is O(1) amortized in the ladder and Bottom, but
+ * linear in Top.
+ */
+class LadderScheduler : public Scheduler
+{
+public:
+  /**
+   *  Register this type.
+   *  \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  /** Constructor. */
+  LadderScheduler ();
+  /** Destructor. */
+  virtual ~LadderScheduler ();
+
+  // Inherited
+  virtual void Insert (const Scheduler::Event &ev);
+  virtual bool IsEmpty (void) const;
+  virtual Scheduler::Event PeekNext (void) const;
+  virtual Scheduler::Event RemoveNext (void);
+  virtual void Remove (const Scheduler::Event &ev);
+
+private:
+  /** Bucket type: an unsorted array of events. */
+  typedef std::vector<Scheduler::Event> Bucket;
+
+  /** A rung of the ladder: buckets of equal width. */
+  struct Rung
+  {
+    uint64_t m_start;                   //!< Timestamp of the first bucket
+    uint64_t m_width;                   //!< Width of the buckets, in time steps
+    uint32_t m_current;                 //!< First bucket not dequeued yet
+    uint32_t m_nBuckets;                //!< Number of buckets in use
+    uint32_t m_count;                   //!< Number of events in the rung
+    std::vector<Bucket> m_buckets;      //!< The buckets, some maybe unused
+  };
+
+  /**
+   * Get the first timestamp of the buckets not dequeued yet of a rung.
+   *
+   * \param [in] rung The rung.
+   * \returns The start of the current bucket.
+   */
+  static uint64_t GetCurrentStart (const Rung &rung);
+  /**
+   * Get the bucket of a timestamp in a rung.
+   *
+   * \param [in] rung The rung.
+   * \param [in] ts The timestamp, not earlier than the current bucket.
+   * \returns The bucket index.
+   */
+  static uint32_t GetBucket (const Rung &rung, uint64_t ts);
+  /**
+   * Find the rung of a timestamp.
+   *
+   * \param [in] ts The timestamp, earlier than Top.
+   * \returns The rung index, m_nRungs for Bottom.
+   */
+  uint32_t FindRung (uint64_t ts) const;
+  /**
+   * Add a rung for events between two timestamps, and move them to it.
+   *
+   * \param [in,out] events The events, cleared.
+   * \param [in] min The earliest timestamp of the events.
+   * \param [in] max The latest timestamp of the events.
+   */
+  void SpawnRung (Bucket &events, uint64_t min, uint64_t max);
+  /** Refill Bottom from the ladder, or the ladder from Top, if Bottom is empty. */
+  void Refill (void);
+  /**
+   * Insert an event in Bottom, keeping it sorted.
+   *
+   * \param [in] ev The event.
+   */
+  void InsertBottom (const Scheduler::Event &ev);
+
+  /** Bucket size above which a bucket is split into a finer rung. */
+  static const uint32_t BUCKET_THRESHOLD = 50;
+  /** Maximum number of rungs. */
+  static const uint32_t MAX_RUNGS = 8;
+
+  /** Top: the unsorted events later than m_topStart. */
+  Bucket m_top;
+  /** The start of Top. */
+  uint64_t m_topStart;
+  /** The earliest timestamp in Top. */
+  uint64_t m_topMin;
+  /** The latest timestamp in Top. */
+  uint64_t m_topMax;
+  /** The rungs; the first m_nRungs are in use. */
+  std::vector<Rung> m_rungs;
+  /** Number of rungs in use. */
+  uint32_t m_nRungs;
+  /** Bottom: the sorted earliest events, from m_bottomHead. */
+  Bucket m_bottom;
+  /** Index of the first event of Bottom. */
+  uint32_t m_bottomHead;
+  /** Number of events in the queue. */
+  uint32_t m_size;
+};
+
+} // namespace ns3
+
+#endif /* LADDER_SCHEDULER_H */
@@ -29,6 +29,7 @@
 #include <sstream>
 #include <cstdlib>
 #include <cstring>
+#include <atomic>
 
 /**
  * \file
@@ -46,6 +47,21 @@ NS_LOG_COMPONENT_DEFINE ("Object");
 
 NS_OBJECT_ENSURE_REGISTERED (Object);
 
+namespace {
+
+/** Number of entries of the lookup cache of an aggregate, a power of 2. */
+const uint32_t CACHE_SIZE = 16;
+
+/**
+ * Number of DoGetObject() lookups answered by a lookup cache. Objects may
+ * be looked up by several threads, e.g. with the threaded simulator.
+ */
+std::atomic<uint64_t> g_cacheHits (0);
+/** Number of DoGetObject() lookups that scanned the aggregate array. */
+std::atomic<uint64_t> g_cacheMisses (0);
+
+} // anonymous namespace
+
 Object::AggregateIterator::AggregateIterator ()
   : m_object (0),
     m_current (0)
@@ -102,6 +118,7 @@ Object::Object ()
 {
   NS_LOG_FUNCTION (this);
   m_aggregates->n = 1;
+  m_aggregates->cache = NewCache ();
   m_aggregates->buffer[0] = this;
 }
 Object::~Object () 
@@ -120,10 +137,13 @@ Object::~Object ()
           m_aggregates->n--;
         }
     }
+  // the cache may point to this object
+  ClearCache (m_aggregates);
   // finally, if all objects have been removed from the list,
   // delete the aggregate list
   if (m_aggregates->n == 0)
     {
+      delete [] m_aggregates->cache;
       std::free (m_aggregates);
     }
   m_aggregates = 0;
@@ -136,6 +156,7 @@ Object::Object (const Object &o)
     m_getObjectCount (0)
 {
   m_aggregates->n = 1;
+  m_aggregates->cache = NewCache ();
   m_aggregates->buffer[0] = this;
 }
 void
@@ -151,6 +172,16 @@ Object::DoGetObject (TypeId tid) const
   NS_LOG_FUNCTION (this << tid);
   NS_ASSERT (CheckLoose ());
 
+  // the acquire load of the uid pairs with the release store below: a hit
+  // always reads the object stored with that uid
+  struct CacheEntry *entry = &m_aggregates->cache[tid.GetUid () & (CACHE_SIZE - 1)];
+  if (entry->uid.load (std::memory_order_acquire) == tid.GetUid ())
+    {
+      g_cacheHits.fetch_add (1, std::memory_order_relaxed);
+      return entry->object.load (std::memory_order_relaxed);
+    }
+  g_cacheMisses.fetch_add (1, std::memory_order_relaxed);
+
   uint32_t n = m_aggregates->n;
   TypeId objectTid = Object::GetTypeId ();
   for (uint32_t i = 0; i < n; i++)
@@ -173,10 +204,14 @@ Object::DoGetObject (TypeId tid) const
           current->m_getObjectCount++;
           // then, update the sort
           UpdateSortedArray (m_aggregates, i);
-          // finally, return the match
+          // finally, remember and return the match
+          entry->object.store (current, std::memory_order_relaxed);
+          entry->uid.store (tid.GetUid (), std::memory_order_release);
           return const_cast<Object *> (current);
         }
     }
+  entry->object.store (0, std::memory_order_relaxed);
+  entry->uid.store (tid.GetUid (), std::memory_order_release);
   return 0;
 }
 void
@@ -263,6 +298,7 @@ Object::AggregateObject (Ptr<Object> o)
   struct Aggregates *aggregates = 
     (struct Aggregates *)std::malloc (sizeof(struct Aggregates)+(total-1)*sizeof(Object*));
   aggregates->n = total;
+  aggregates->cache = NewCache ();
 
   // copy our buffer to the new buffer
   std::memcpy (&aggregates->buffer[0], 
@@ -314,9 +350,46 @@ Object::AggregateObject (Ptr<Object> o)
     }
 
   // Now that we are done with them, we can free our old aggregate buffers
+  // and their lookup caches
+  delete [] a->cache;
+  delete [] b->cache;
   std::free (a);
   std::free (b);
 }
+struct Object::CacheEntry *
+Object::NewCache (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  struct CacheEntry *cache = new struct CacheEntry [CACHE_SIZE];
+  for (uint32_t i = 0; i < CACHE_SIZE; i++)
+    {
+      cache[i].uid.store (0, std::memory_order_relaxed);
+      cache[i].object.store (0, std::memory_order_relaxed);
+    }
+  return cache;
+}
+void
+Object::ClearCache (struct Aggregates *aggregates)
+{
+  NS_LOG_FUNCTION (aggregates);
+  for (uint32_t i = 0; i < CACHE_SIZE; i++)
+    {
+      aggregates->cache[i].uid.store (0, std::memory_order_relaxed);
+      aggregates->cache[i].object.store (0, std::memory_order_relaxed);
+    }
+}
+uint64_t
+Object::GetObjectCacheHits (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  return g_cacheHits.load (std::memory_order_relaxed);
+}
+uint64_t
+Object::GetObjectCacheMisses (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  return g_cacheMisses.load (std::memory_order_relaxed);
+}
 /**
  * This function must be implemented in the stack that needs to notify
  * other stacks connected to the node of their presence in the node.
@@ -24,6 +24,7 @@
 #include <stdint.h>
 #include <string>
 #include <vector>
+#include <atomic>
 #include "ptr.h"
 #include "attribute.h"
 #include "object-base.h"
@@ -178,6 +179,20 @@ private:
    * This method is typically used to break reference cycles.
    */
   void Dispose (void);
+  /**
+   * Get the number of DoGetObject() lookups, over all the Objects,
+   * that were answered by the lookup cache of the aggregate.
+   *
+   * \returns The number of lookup cache hits.
+   */
+  static uint64_t GetObjectCacheHits (void);
+  /**
+   * Get the number of DoGetObject() lookups, over all the Objects,
+   * that had to scan the aggregate array.
+   *
+   * \returns The number of lookup cache misses.
+   */
+  static uint64_t GetObjectCacheMisses (void);
   /**
    * Aggregate two Objects together.
    *
@@ -323,6 +338,23 @@ private:
   friend class AggregateIterator;
   friend struct ObjectDeleter;
 
+  /**
+   * An entry of the lookup cache of an aggregate.
+   *
+   * The cache is direct-mapped on the TypeId uid: the result of a
+   * lookup of the TypeId with uid \c u is kept in the entry
+   * <tt>u % CACHE_SIZE</tt>, so a repeated lookup is a single probe.
+   * Unsuccessful lookups are cached too, with a zero \c object.
+   * An entry is filled once the aggregate has been scanned, by storing
+   * \c object before publishing \c uid with release semantics.
+   */
+  struct CacheEntry {
+    /** The uid of the TypeId looked up, zero if the entry is empty. */
+    std::atomic<uint16_t> uid;
+    /** The Object found for that TypeId, or zero. */
+    std::atomic<Object *> object;
+  };
+
   /**
    * The list of Objects aggregated to this one.
    *
@@ -338,10 +370,30 @@ private:
   struct Aggregates {
     /** The number of entries in \c buffer. */
     uint32_t n;
+    /**
+     * The lookup cache, allocated with the aggregate, so that
+     * DoGetObject() only reads and updates its entries.
+     */
+    struct CacheEntry *cache;
     /** The array of Objects. */
     Object *buffer[1];
   };
 
+  /**
+   * Allocate an empty lookup cache for a new aggregate.
+   *
+   * \returns The CACHE_SIZE entries of the cache.
+   */
+  static struct CacheEntry *NewCache (void);
+
+  /**
+   * Empty the lookup cache of an aggregate, when the set of
+   * Objects it contains changes.
+   *
+   * \param [in,out] aggregates The list of aggregated Objects.
+   */
+  static void ClearCache (struct Aggregates *aggregates);
+
   /**
    * Find an Object of TypeId tid in the aggregates of this Object.
    *
@@ -25,8 +25,12 @@
 #include "empty.h"
 #include "default-deleter.h"
 #include "assert.h"
+#include "ns3/core-config.h"
 #include <stdint.h>
 #include <limits>
+#ifdef ENABLE_THREADED_SIMULATOR
+#include <atomic>
+#endif
 
 /**
  * \file
@@ -67,6 +71,10 @@ namespace ns3 {
  *      to the object it manages exist anymore.
  *
  * Interesting users of this class include ns3::Object as well as ns3::Packet.
+ *
+ * When ns-3 is configured with --enable-threaded-simulator, the count
+ * is atomic, so that objects can be shared by the threads of
+ * ns3::ThreadedSimulatorImpl.
  */
 template <typename T, typename PARENT = empty, typename DELETER = DefaultDeleter<T> >
 class SimpleRefCount : public PARENT
@@ -110,8 +118,7 @@ public:
    */
   inline void Unref (void) const
   {
-    m_count--;
-    if (m_count == 0)
+    if (--m_count == 0)
       {
         DELETER::Delete (static_cast<T*> (const_cast<SimpleRefCount *> (this)));
       }
@@ -140,7 +147,11 @@ private:
    * Note we make this mutable so that the const methods can still
    * change it.
    */
+#ifdef ENABLE_THREADED_SIMULATOR
+  mutable std::atomic<uint32_t> m_count;
+#else
   mutable uint32_t m_count;
+#endif
 };
 
 } // namespace ns3
@@ -349,6 +349,20 @@ Simulator::GetMaximumSimulationTime (void)
   return GetImpl ()->GetMaximumSimulationTime ();
 }
 
+uint64_t
+Simulator::GetEventAllocations (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  return EventImpl::GetAllocations ();
+}
+
+uint64_t
+Simulator::GetEventAllocatedBytes (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  return EventImpl::GetAllocatedBytes ();
+}
+
 uint32_t
 Simulator::GetContext (void)
 {
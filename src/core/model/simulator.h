@@ -1137,6 +1137,28 @@ public:
    */
   static Time GetMaximumSimulationTime (void);
 
+  /**
+   * Get the number of events allocated.
+   *
+   * Together with the number of events run, this gives the rate of the
+   * events; see EventImpl for their allocation.
+   *
+   * @return The number of events allocated since the start of the
+   *         program, by all the threads.
+   */
+  static uint64_t GetEventAllocations (void);
+
+  /**
+   * Get the number of bytes of the events allocated.
+   *
+   * Divided by GetEventAllocations(), this gives the bytes allocated
+   * per event, including the bound arguments.
+   *
+   * @return The size of the events allocated since the start of the
+   *         program, by all the threads.
+   */
+  static uint64_t GetEventAllocatedBytes (void);
+
   /**
    * Schedule a future event execution (in the same context).
    *
@@ -431,6 +431,64 @@ ObjectFactoryTestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_NE (a->GetObject<DerivedA> (), 0, "Unexpectedly able to work around C++ type system");
 }
 
+// ===========================================================================
+// Test case to make sure that the lookup cache of an aggregation follows
+// the changes of the aggregation
+// ===========================================================================
+class GetObjectCacheTestCase : public TestCase
+{
+public:
+  GetObjectCacheTestCase ();
+  virtual ~GetObjectCacheTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+GetObjectCacheTestCase::GetObjectCacheTestCase ()
+  : TestCase ("Check the GetObject lookup cache")
+{
+}
+
+GetObjectCacheTestCase::~GetObjectCacheTestCase ()
+{
+}
+
+void
+GetObjectCacheTestCase::DoRun (void)
+{
+  Ptr<BaseA> baseA = CreateObject<BaseA> ();
+  Ptr<BaseB> baseB = CreateObject<BaseB> ();
+  baseA->AggregateObject (baseB);
+
+  //
+  // The first lookup scans the aggregation, the next ones hit the cache
+  // and return the same Object.
+  //
+  uint64_t hits = Object::GetObjectCacheHits ();
+  uint64_t misses = Object::GetObjectCacheMisses ();
+  NS_TEST_ASSERT_MSG_EQ (baseA->GetObject<BaseB> (BaseB::GetTypeId ()), baseB, "Cannot GetObject for BaseB");
+  NS_TEST_ASSERT_MSG_EQ (Object::GetObjectCacheMisses (), misses + 1, "The first lookup did not scan the aggregation");
+  for (uint32_t i = 0; i < 10; i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (baseA->GetObject<BaseB> (BaseB::GetTypeId ()), baseB, "Cached GetObject for BaseB differs");
+    }
+  NS_TEST_ASSERT_MSG_EQ (Object::GetObjectCacheHits (), hits + 10, "The repeated lookups missed the cache");
+  NS_TEST_ASSERT_MSG_EQ (Object::GetObjectCacheMisses (), misses + 1, "The repeated lookups scanned the aggregation");
+
+  //
+  // An unsuccessful lookup is cached too, until a matching Object is
+  // aggregated.
+  //
+  Ptr<BaseB> other = CreateObject<BaseB> ();
+  NS_TEST_ASSERT_MSG_EQ (other->GetObject<DerivedA> (DerivedA::GetTypeId ()), 0, "Unexpectedly found a DerivedA");
+  NS_TEST_ASSERT_MSG_EQ (other->GetObject<DerivedA> (DerivedA::GetTypeId ()), 0, "Unexpectedly found a cached DerivedA");
+  Ptr<DerivedA> derivedA = CreateObject<DerivedA> ();
+  other->AggregateObject (derivedA);
+  NS_TEST_ASSERT_MSG_EQ (other->GetObject<DerivedA> (DerivedA::GetTypeId ()), derivedA, "Cannot GetObject for the new DerivedA");
+  NS_TEST_ASSERT_MSG_EQ (derivedA->GetObject<BaseB> (BaseB::GetTypeId ()), other, "Cannot GetObject (through derivedA) for BaseB");
+}
+
 // ===========================================================================
 // The Test Suite that glues the Test Cases together.
 // ===========================================================================
@@ -446,6 +504,7 @@ ObjectTestSuite::ObjectTestSuite ()
   AddTestCase (new CreateObjectTestCase, TestCase::QUICK);
   AddTestCase (new AggregateObjectTestCase, TestCase::QUICK);
   AddTestCase (new ObjectFactoryTestCase, TestCase::QUICK);
+  AddTestCase (new GetObjectCacheTestCase, TestCase::QUICK);
 }
 
 static ObjectTestSuite objectTestSuite;
@@ -23,6 +23,8 @@
 #include "ns3/heap-scheduler.h"
 #include "ns3/map-scheduler.h"
 #include "ns3/calendar-scheduler.h"
+#include "ns3/ladder-scheduler.h"
+#include <map>
 
 using namespace ns3;
 
@@ -459,6 +461,157 @@ SimulatorTemplateTestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+class SchedulerOrderTestCase : public TestCase
+{
+public:
+  SchedulerOrderTestCase (ObjectFactory schedulerFactory);
+  virtual void DoRun (void);
+  uint32_t Random (uint32_t max);
+  uint32_t m_seed;
+  ObjectFactory m_schedulerFactory;
+};
+
+SchedulerOrderTestCase::SchedulerOrderTestCase (ObjectFactory schedulerFactory)
+  : TestCase ("Check the order of bursts of events at the same time with " +
+              schedulerFactory.GetTypeId ().GetName ()),
+    m_seed (1),
+    m_schedulerFactory (schedulerFactory)
+{
+}
+
+uint32_t
+SchedulerOrderTestCase::Random (uint32_t max)
+{
+  m_seed = m_seed * 1103515245 + 12345;
+  return (m_seed >> 8) % max;
+}
+
+void
+SchedulerOrderTestCase::DoRun (void)
+{
+  // Slot-periodic bursts, as the mmWave PHYs, compared to a MapScheduler
+  Ptr<Scheduler> scheduler = m_schedulerFactory.Create<Scheduler> ();
+  Ptr<Scheduler> reference = CreateObject<MapScheduler> ();
+  std::map<uint32_t, Scheduler::Event> pending;
+  uint64_t now = 0;
+  uint32_t uid = 4;
+  uint64_t delays[] = { 0, 125000, 250000, 1000000000 };
+
+  for (uint32_t i = 0; i < 5000; i++)
+    {
+      uint32_t op = Random (10);
+      if (op < 4 || pending.empty ())
+        {
+          uint64_t delay = Random (2) ? delays[Random (4)] : Random (1000000);
+          uint32_t burst = 1 + Random (100);
+          for (uint32_t j = 0; j < burst; j++)
+            {
+              Scheduler::Event ev;
+              ev.impl = 0;
+              ev.key.m_ts = now + delay;
+              ev.key.m_uid = uid++;
+              ev.key.m_context = 0;
+              scheduler->Insert (ev);
+              reference->Insert (ev);
+              pending[ev.key.m_uid] = ev;
+            }
+        }
+      else if (op < 9)
+        {
+          uint32_t n = 1 + Random (100);
+          for (uint32_t j = 0; j < n && !pending.empty (); j++)
+            {
+              Scheduler::Event expected = reference->RemoveNext ();
+              NS_TEST_ASSERT_MSG_EQ (scheduler->PeekNext ().key.m_uid, expected.key.m_uid, "Wrong next event");
+              Scheduler::Event ev = scheduler->RemoveNext ();
+              NS_TEST_ASSERT_MSG_EQ (ev.key.m_uid, expected.key.m_uid, "Wrong event removed");
+              NS_TEST_ASSERT_MSG_EQ (ev.key.m_ts, expected.key.m_ts, "Wrong event removed");
+              now = ev.key.m_ts;
+              pending.erase (ev.key.m_uid);
+            }
+        }
+      else
+        {
+          std::map<uint32_t, Scheduler::Event>::iterator it = pending.begin ();
+          std::advance (it, Random (pending.size ()));
+          scheduler->Remove (it->second);
+          reference->Remove (it->second);
+          pending.erase (it);
+        }
+      NS_TEST_ASSERT_MSG_EQ (scheduler->IsEmpty (), pending.empty (), "Wrong number of events");
+    }
+
+  while (!reference->IsEmpty ())
+    {
+      Scheduler::Event expected = reference->RemoveNext ();
+      Scheduler::Event ev = scheduler->RemoveNext ();
+      NS_TEST_ASSERT_MSG_EQ (ev.key.m_uid, expected.key.m_uid, "Wrong event removed");
+    }
+  NS_TEST_EXPECT_MSG_EQ (scheduler->IsEmpty (), true, "Events left");
+}
+
+class EventAllocationTestCase : public TestCase
+{
+public:
+  EventAllocationTestCase ();
+  virtual void DoRun (void);
+  struct Block
+  {
+    uint8_t data[512];
+  };
+  void Small (uint32_t a);
+  void Large (Block b);
+  uint32_t m_sum;
+};
+
+EventAllocationTestCase::EventAllocationTestCase ()
+  : TestCase ("Check the allocation of the events")
+{
+}
+
+void
+EventAllocationTestCase::Small (uint32_t a)
+{
+  m_sum += a;
+}
+
+void
+EventAllocationTestCase::Large (Block b)
+{
+  m_sum += b.data[0];
+}
+
+void
+EventAllocationTestCase::DoRun (void)
+{
+  m_sum = 0;
+  uint64_t allocations = Simulator::GetEventAllocations ();
+  uint64_t bytes = Simulator::GetEventAllocatedBytes ();
+  for (uint32_t i = 0; i < 5000; i++)
+    {
+      Simulator::Schedule (NanoSeconds (i), &EventAllocationTestCase::Small, this, 1);
+    }
+  Block block;
+  block.data[0] = 1;
+  for (uint32_t i = 0; i < 10; i++)
+    {
+      Simulator::Schedule (NanoSeconds (i), &EventAllocationTestCase::Large, this, block);
+    }
+  NS_TEST_EXPECT_MSG_EQ (Simulator::GetEventAllocations () - allocations, 5010, "Wrong number of allocations");
+  uint64_t size = Simulator::GetEventAllocatedBytes () - bytes;
+  NS_TEST_EXPECT_MSG_GT (size, 5000 * sizeof (EventImpl) + 10 * sizeof (Block), "Wrong allocated bytes");
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_EQ (m_sum, 5010, "Events not run");
+
+  // The block of an event is reused by the next event of its size
+  EventImpl *event = MakeEvent (&EventAllocationTestCase::Small, this, 1);
+  event->Unref ();
+  EventImpl *next = MakeEvent (&EventAllocationTestCase::Small, this, 2);
+  NS_TEST_EXPECT_MSG_EQ (next, event, "Block not reused");
+  next->Unref ();
+  Simulator::Destroy ();
+}
+
 class SimulatorTestSuite : public TestSuite
 {
 public:
@@ -475,5 +628,9 @@ public:
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
     factory.SetTypeId (CalendarScheduler::GetTypeId ());
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (LadderScheduler::GetTypeId ());
+    AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+    AddTestCase (new SchedulerOrderTestCase (factory), TestCase::QUICK);
+    AddTestCase (new EventAllocationTestCase (), TestCase::QUICK);
   }
 } g_simulatorTestSuite;
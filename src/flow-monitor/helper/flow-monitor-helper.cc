@@ -174,5 +174,14 @@ FlowMonitorHelper::SerializeToXmlFile (std::string fileName, bool enableHistogra
     }
 }
 
+Ptr<FlowMonitorStream>
+FlowMonitorHelper::EnableStreaming (std::string fileName, Time interval)
+{
+  Ptr<FlowMonitorStream> stream = CreateObject<FlowMonitorStream> ();
+  stream->SetAttribute ("Interval", TimeValue (interval));
+  stream->Start (GetMonitor (), fileName);
+  return stream;
+}
+
 
 } // namespace ns3
@@ -23,6 +23,7 @@
 #include "ns3/node-container.h"
 #include "ns3/object-factory.h"
 #include "ns3/flow-monitor.h"
+#include "ns3/flow-monitor-stream.h"
 #include "ns3/flow-classifier.h"
 #include <string>
 
@@ -112,6 +113,16 @@ public:
    */
   void SerializeToXmlFile (std::string fileName, bool enableHistograms, bool enableProbes);
 
+  /**
+   * Write the changes of the flow statistics to a file every interval,
+   * instead of, or besides, serializing the whole statistics at the end.
+   * The format is set with the ns3::FlowMonitorStream::Format attribute.
+   * \param fileName name or path of the output file that will be created
+   * \param interval time between two writes
+   * \returns the FlowMonitorStream writing the file
+   */
+  Ptr<FlowMonitorStream> EnableStreaming (std::string fileName, Time interval);
+
 private:
   /**
    * \brief Copy constructor
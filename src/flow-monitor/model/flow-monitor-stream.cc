@@ -0,0 +1,377 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation;
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include "flow-monitor-stream.h"
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include "ns3/enum.h"
+#include "ns3/uinteger.h"
+#include <cstring>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("FlowMonitorStream");
+
+NS_OBJECT_ENSURE_REGISTERED (FlowMonitorStream);
+
+namespace {
+
+const char g_binaryMagic[8] = {'N', 'S', '3', 'F', 'L', 'O', 'W', 'S'};
+
+// the maximum length of a single CSV record
+const size_t MAX_CSV_RECORD = 256;
+
+inline void
+EncodeU16 (char* p, uint16_t v)
+{
+  p[0] = v & 0xff;
+  p[1] = (v >> 8) & 0xff;
+}
+
+inline void
+EncodeU32 (char* p, uint32_t v)
+{
+  for (int i = 0; i < 4; i++)
+    {
+      p[i] = (v >> (8 * i)) & 0xff;
+    }
+}
+
+inline void
+EncodeU64 (char* p, uint64_t v)
+{
+  for (int i = 0; i < 8; i++)
+    {
+      p[i] = (v >> (8 * i)) & 0xff;
+    }
+}
+
+// the sum of the drops of a flow over all the reason codes
+template <typename T>
+inline uint64_t
+SumDrops (const std::vector<T> &drops)
+{
+  uint64_t sum = 0;
+  for (typename std::vector<T>::const_iterator it = drops.begin (); it != drops.end (); ++it)
+    {
+      sum += *it;
+    }
+  return sum;
+}
+
+inline uint16_t
+DecodeU16 (const uint8_t* p)
+{
+  return p[0] | (p[1] << 8);
+}
+
+inline uint32_t
+DecodeU32 (const uint8_t* p)
+{
+  uint32_t v = 0;
+  for (int i = 3; i >= 0; i--)
+    {
+      v = (v << 8) | p[i];
+    }
+  return v;
+}
+
+inline uint64_t
+DecodeU64 (const uint8_t* p)
+{
+  uint64_t v = 0;
+  for (int i = 7; i >= 0; i--)
+    {
+      v = (v << 8) | p[i];
+    }
+  return v;
+}
+
+} // anonymous namespace
+
+FlowMonitorStream::FlowMonitorStream ()
+  : m_file (0),
+    m_used (0),
+    m_format (CSV_FORMAT),
+    m_interval (Seconds (1)),
+    m_bufferSize (65536)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+FlowMonitorStream::~FlowMonitorStream ()
+{
+  NS_LOG_FUNCTION (this);
+  if (m_file != 0)
+    {
+      Flush ();
+      fclose (m_file);
+    }
+}
+
+TypeId
+FlowMonitorStream::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::FlowMonitorStream")
+    .SetParent<Object> ()
+    .SetGroupName ("FlowMonitor")
+    .AddConstructor<FlowMonitorStream> ()
+    .AddAttribute ("Format",
+                   "Output format of the flow statistics",
+                   EnumValue (FlowMonitorStream::CSV_FORMAT),
+                   MakeEnumAccessor (&FlowMonitorStream::m_format),
+                   MakeEnumChecker (FlowMonitorStream::CSV_FORMAT, "Csv",
+                                    FlowMonitorStream::BINARY_FORMAT, "Binary"))
+    .AddAttribute ("Interval",
+                   "Time between two writes of the changes of the flows",
+                   TimeValue (Seconds (1)),
+                   MakeTimeAccessor (&FlowMonitorStream::m_interval),
+                   MakeTimeChecker ())
+    .AddAttribute ("BufferSize",
+                   "Number of bytes buffered before writing to disk, within an interval",
+                   UintegerValue (65536),
+                   MakeUintegerAccessor (&FlowMonitorStream::m_bufferSize),
+                   MakeUintegerChecker<uint32_t> (MAX_CSV_RECORD))
+  ;
+  return tid;
+}
+
+void
+FlowMonitorStream::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  Stop ();
+  m_monitor = 0;
+  Object::DoDispose ();
+}
+
+void
+FlowMonitorStream::Start (Ptr<FlowMonitor> monitor, std::string fileName)
+{
+  NS_LOG_FUNCTION (this << monitor << fileName);
+  NS_ABORT_MSG_IF (m_file != 0, "FlowMonitorStream already started");
+  NS_ABORT_MSG_IF (!m_interval.IsStrictlyPositive (), "FlowMonitorStream Interval must be positive");
+  m_monitor = monitor;
+  m_file = fopen (fileName.c_str (), m_format == BINARY_FORMAT ? "wb" : "w");
+  if (m_file == 0)
+    {
+      NS_FATAL_ERROR ("Could not open flow statistics file " << fileName);
+    }
+  m_buffer.resize (m_bufferSize);
+  m_used = 0;
+  m_last.clear ();
+
+  if (m_format == BINARY_FORMAT)
+    {
+      char header[BINARY_HEADER_SIZE];
+      std::memcpy (header, g_binaryMagic, sizeof (g_binaryMagic));
+      EncodeU16 (header + 8, BINARY_VERSION);
+      EncodeU16 (header + 10, RECORD_SIZE);
+      EncodeU32 (header + 12, 0);
+      Append (header, BINARY_HEADER_SIZE);
+    }
+  else
+    {
+      std::string line = GetCsvHeader ();
+      Append (line.data (), line.size ());
+    }
+  Flush ();
+  m_writeEvent = Simulator::Schedule (m_interval, &FlowMonitorStream::PeriodicWrite, this);
+  // the last interval is written even if the stream outlives the simulation
+  Simulator::ScheduleDestroy (&FlowMonitorStream::Stop, Ptr<FlowMonitorStream> (this));
+}
+
+void
+FlowMonitorStream::Stop (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_file == 0)
+    {
+      return;
+    }
+  Simulator::Cancel (m_writeEvent);
+  WriteChanges ();
+  fclose (m_file);
+  m_file = 0;
+  m_last.clear ();
+}
+
+void
+FlowMonitorStream::PeriodicWrite (void)
+{
+  WriteChanges ();
+  m_writeEvent = Simulator::Schedule (m_interval, &FlowMonitorStream::PeriodicWrite, this);
+}
+
+void
+FlowMonitorStream::WriteChanges (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_monitor->CheckForLostPackets ();
+  int64_t now = Simulator::Now ().GetNanoSeconds ();
+  const FlowMonitor::FlowStatsContainer &stats = m_monitor->GetFlowStats ();
+  // both containers are ordered by flow id
+  std::map<FlowId, Record>::iterator last = m_last.begin ();
+  uint32_t records = 0;
+  for (FlowMonitor::FlowStatsContainerCI flow = stats.begin (); flow != stats.end (); ++flow)
+    {
+      const FlowMonitor::FlowStats &s = flow->second;
+      while (last != m_last.end () && last->first < flow->first)
+        {
+          ++last;
+        }
+      if (last == m_last.end () || last->first != flow->first)
+        {
+          Record zero;
+          std::memset (&zero, 0, sizeof (zero));
+          last = m_last.insert (last, std::make_pair (flow->first, zero));
+        }
+      Record &prev = last->second;
+      uint32_t packetsDropped = SumDrops (s.packetsDropped);
+      if (s.txPackets == prev.txPackets && s.rxPackets == prev.rxPackets
+          && s.lostPackets == prev.lostPackets && s.timesForwarded == prev.timesForwarded
+          && packetsDropped == prev.packetsDropped)
+        {
+          continue;
+        }
+
+      Record delta;
+      delta.timeNs = now;
+      delta.flowId = flow->first;
+      delta.txPackets = s.txPackets - prev.txPackets;
+      delta.txBytes = s.txBytes - prev.txBytes;
+      delta.rxPackets = s.rxPackets - prev.rxPackets;
+      delta.lostPackets = s.lostPackets - prev.lostPackets;
+      delta.rxBytes = s.rxBytes - prev.rxBytes;
+      delta.delaySumNs = s.delaySum.GetNanoSeconds () - prev.delaySumNs;
+      delta.jitterSumNs = s.jitterSum.GetNanoSeconds () - prev.jitterSumNs;
+      delta.timesForwarded = s.timesForwarded - prev.timesForwarded;
+      delta.packetsDropped = packetsDropped - prev.packetsDropped;
+      delta.bytesDropped = SumDrops (s.bytesDropped) - prev.bytesDropped;
+
+      prev.txPackets = s.txPackets;
+      prev.txBytes = s.txBytes;
+      prev.rxPackets = s.rxPackets;
+      prev.lostPackets = s.lostPackets;
+      prev.rxBytes = s.rxBytes;
+      prev.delaySumNs = s.delaySum.GetNanoSeconds ();
+      prev.jitterSumNs = s.jitterSum.GetNanoSeconds ();
+      prev.timesForwarded = s.timesForwarded;
+      prev.packetsDropped = packetsDropped;
+      prev.bytesDropped += delta.bytesDropped;
+
+      if (m_format == BINARY_FORMAT)
+        {
+          char record[RECORD_SIZE];
+          EncodeU64 (record, delta.timeNs);
+          EncodeU32 (record + 8, delta.flowId);
+          EncodeU32 (record + 12, delta.txPackets);
+          EncodeU64 (record + 16, delta.txBytes);
+          EncodeU32 (record + 24, delta.rxPackets);
+          EncodeU32 (record + 28, delta.lostPackets);
+          EncodeU64 (record + 32, delta.rxBytes);
+          EncodeU64 (record + 40, delta.delaySumNs);
+          EncodeU64 (record + 48, delta.jitterSumNs);
+          EncodeU32 (record + 56, delta.timesForwarded);
+          EncodeU32 (record + 60, delta.packetsDropped);
+          EncodeU64 (record + 64, delta.bytesDropped);
+          Append (record, RECORD_SIZE);
+        }
+      else
+        {
+          std::string line = FormatCsv (delta);
+          Append (line.data (), line.size ());
+        }
+      records++;
+    }
+  NS_LOG_LOGIC ("Wrote " << records << " flow records at " << Simulator::Now ().GetSeconds ());
+  Flush ();
+}
+
+void
+FlowMonitorStream::Append (const char *data, size_t size)
+{
+  if (m_used + size > m_buffer.size ())
+    {
+      Flush ();
+    }
+  std::memcpy (&m_buffer[m_used], data, size);
+  m_used += size;
+}
+
+void
+FlowMonitorStream::Flush (void)
+{
+  if (m_used > 0)
+    {
+      size_t written = fwrite (&m_buffer[0], 1, m_used, m_file);
+      NS_ABORT_MSG_IF (written != m_used, "Error writing flow statistics file");
+      m_used = 0;
+    }
+  fflush (m_file);
+}
+
+std::string
+FlowMonitorStream::GetCsvHeader (void)
+{
+  return "timeNs,flowId,txPackets,txBytes,rxPackets,lostPackets,rxBytes,"
+         "delaySumNs,jitterSumNs,timesForwarded,packetsDropped,bytesDropped\n";
+}
+
+std::string
+FlowMonitorStream::FormatCsv (const Record &record)
+{
+  char line[MAX_CSV_RECORD];
+  int len = snprintf (line, sizeof (line), "%lld,%u,%u,%llu,%u,%u,%llu,%lld,%lld,%u,%u,%llu\n",
+                      (long long) record.timeNs, record.flowId, record.txPackets,
+                      (long long unsigned) record.txBytes, record.rxPackets, record.lostPackets,
+                      (long long unsigned) record.rxBytes, (long long) record.delaySumNs,
+                      (long long) record.jitterSumNs, record.timesForwarded,
+                      record.packetsDropped, (long long unsigned) record.bytesDropped);
+  return std::string (line, len);
+}
+
+bool
+FlowMonitorStream::DecodeHeader (const uint8_t *data, BinaryHeader &header)
+{
+  std::memcpy (header.m_magic, data, sizeof (header.m_magic));
+  header.m_version = DecodeU16 (data + 8);
+  header.m_recordSize = DecodeU16 (data + 10);
+  header.m_reserved = DecodeU32 (data + 12);
+  return std::memcmp (header.m_magic, g_binaryMagic, sizeof (g_binaryMagic)) == 0
+         && header.m_version == BINARY_VERSION
+         && header.m_recordSize == RECORD_SIZE;
+}
+
+void
+FlowMonitorStream::DecodeRecord (const uint8_t *data, Record &record)
+{
+  record.timeNs = DecodeU64 (data);
+  record.flowId = DecodeU32 (data + 8);
+  record.txPackets = DecodeU32 (data + 12);
+  record.txBytes = DecodeU64 (data + 16);
+  record.rxPackets = DecodeU32 (data + 24);
+  record.lostPackets = DecodeU32 (data + 28);
+  record.rxBytes = DecodeU64 (data + 32);
+  record.delaySumNs = DecodeU64 (data + 40);
+  record.jitterSumNs = DecodeU64 (data + 48);
+  record.timesForwarded = DecodeU32 (data + 56);
+  record.packetsDropped = DecodeU32 (data + 60);
+  record.bytesDropped = DecodeU64 (data + 64);
+}
+
+} // namespace ns3
@@ -0,0 +1,176 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation;
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#ifndef FLOW_MONITOR_STREAM_H
+#define FLOW_MONITOR_STREAM_H
+
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
+#include "ns3/flow-monitor.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup flow-monitor
+ * \brief Periodic exporter of the flow statistics of a FlowMonitor
+ *
+ * Every Interval, the stream appends one record per flow whose
+ * statistics changed, holding the changes since the previous interval.
+ * The file is written at the end of each interval, so that a long run
+ * can be monitored while it goes on, and what was written survives if
+ * it is killed. The memory used does not grow with the run: the stream
+ * keeps only the last totals of each flow, and no histograms.
+ *
+ * Two output formats are supported. The CSV format starts with a line
+ * naming the columns, as returned by GetCsvHeader (). The binary format
+ * starts with a 16-byte BinaryHeader followed by fixed-width
+ * little-endian records of RECORD_SIZE bytes:
+ *
+ * - int64 time in nanoseconds, uint32 flow id, uint32 tx packets,
+ * - uint64 tx bytes, uint32 rx packets, uint32 lost packets,
+ * - uint64 rx bytes, int64 delay sum in nanoseconds,
+ * - int64 jitter sum in nanoseconds, uint32 times forwarded,
+ *   uint32 packets dropped, uint64 bytes dropped
+ *
+ * The dropped packets and bytes are summed over all the drop reasons.
+ *
+ * utils/flow-monitor-stream-reader converts binary files to CSV, and
+ * sums the records of each flow.
+ */
+class FlowMonitorStream : public Object
+{
+public:
+  /// The output formats
+  enum Format
+  {
+    CSV_FORMAT,
+    BINARY_FORMAT
+  };
+
+  /// The changes of the statistics of a flow during an interval
+  struct Record
+  {
+    int64_t timeNs;         //!< end of the interval
+    FlowId flowId;          //!< flow identification
+    uint32_t txPackets;     //!< packets transmitted
+    uint64_t txBytes;       //!< bytes transmitted
+    uint32_t rxPackets;     //!< packets received
+    uint32_t lostPackets;   //!< packets lost
+    uint64_t rxBytes;       //!< bytes received
+    int64_t delaySumNs;     //!< sum of the delays of the packets received
+    int64_t jitterSumNs;    //!< sum of the jitters of the packets received
+    uint32_t timesForwarded; //!< forwards of the packets received
+    uint32_t packetsDropped; //!< packets dropped, for any reason
+    uint64_t bytesDropped;  //!< bytes dropped, for any reason
+  };
+
+  /// Header written at the beginning of each binary file
+  struct BinaryHeader
+  {
+    char m_magic[8];       ///< "NS3FLOWS"
+    uint16_t m_version;    ///< format version, currently 2
+    uint16_t m_recordSize; ///< size in bytes of each record
+    uint32_t m_reserved;
+  };
+
+  static const uint16_t BINARY_VERSION = 2;
+  static const uint32_t BINARY_HEADER_SIZE = 16;
+  static const uint32_t RECORD_SIZE = 72;
+
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  FlowMonitorStream ();
+  virtual ~FlowMonitorStream ();
+
+  /**
+   * Start writing the statistics of a monitor every Interval. The file
+   * is truncated.
+   *
+   * \param monitor the FlowMonitor
+   * \param fileName name or path of the output file
+   */
+  void Start (Ptr<FlowMonitor> monitor, std::string fileName);
+
+  /// Write the changes since the last interval, and close the file
+  void Stop (void);
+
+  /**
+   * \return the first line of a CSV file, including the trailing newline
+   */
+  static std::string GetCsvHeader (void);
+
+  /**
+   * Convert a record to a line of CSV
+   * \param record the record
+   * \return the line, including the trailing newline
+   */
+  static std::string FormatCsv (const Record &record);
+
+  /**
+   * Parse a binary header
+   * \param data pointer to BINARY_HEADER_SIZE bytes
+   * \param header the decoded header
+   * \return true if the magic, version and record size are valid
+   */
+  static bool DecodeHeader (const uint8_t *data, BinaryHeader &header);
+
+  /**
+   * Parse a binary record
+   * \param data pointer to RECORD_SIZE bytes
+   * \param record the decoded record
+   */
+  static void DecodeRecord (const uint8_t *data, Record &record);
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /// Write the changes of the flows during the interval, and schedule the next one
+  void PeriodicWrite (void);
+  /// Write the changes of the flows since the last write
+  void WriteChanges (void);
+  /**
+   * Append data to the buffer, writing the buffer first if full
+   * \param data the data
+   * \param size the size of the data
+   */
+  void Append (const char *data, size_t size);
+  /// Write the buffer to the file
+  void Flush (void);
+
+  Ptr<FlowMonitor> m_monitor;     //!< The monitor of the flows
+  FILE *m_file;                   //!< The output file, or 0 if stopped
+  std::vector<char> m_buffer;     //!< The records not yet written
+  size_t m_used;                  //!< Bytes used in the buffer
+  std::map<FlowId, Record> m_last; //!< Totals of each flow at the last write
+  EventId m_writeEvent;           //!< The next periodic write
+  Format m_format;                //!< The output format
+  Time m_interval;                //!< Time between two writes
+  uint32_t m_bufferSize;          //!< Size of the buffer
+};
+
+} // namespace ns3
+
+#endif /* FLOW_MONITOR_STREAM_H */
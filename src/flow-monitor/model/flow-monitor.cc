@@ -29,6 +29,9 @@
 
 #define PERIODIC_CHECK_INTERVAL (Seconds (1))
 
+/// Largest flow id whose stats are accessed through the dense index
+#define MAX_INDEXED_FLOW_ID (1 << 20)
+
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("FlowMonitor");
@@ -83,7 +86,9 @@ FlowMonitor::GetInstanceTypeId (void) const
 }
 
 FlowMonitor::FlowMonitor ()
-  : m_enabled (false)
+  : m_expiryHead (0),
+    m_expiryTail (0),
+    m_enabled (false)
 {
   // m_histogramBinWidth=DEFAULT_BIN_WIDTH;
 }
@@ -108,11 +113,24 @@ FlowMonitor::DoDispose (void)
 inline FlowMonitor::FlowStats&
 FlowMonitor::GetStatsForFlow (FlowId flowId)
 {
+  if (flowId < m_flowStatsIndex.size () && m_flowStatsIndex[flowId] != 0)
+    {
+      return *m_flowStatsIndex[flowId];
+    }
   FlowStatsContainerI iter;
   iter = m_flowStats.find (flowId);
   if (iter == m_flowStats.end ())
     {
       FlowMonitor::FlowStats &ref = m_flowStats[flowId];
+      // the map nodes are stable, and the flows are never removed
+      if (flowId < MAX_INDEXED_FLOW_ID)
+        {
+          if (flowId >= m_flowStatsIndex.size ())
+            {
+              m_flowStatsIndex.resize (flowId + 1, 0);
+            }
+          m_flowStatsIndex[flowId] = &ref;
+        }
       ref.delaySum = Seconds (0);
       ref.jitterSum = Seconds (0);
       ref.lastDelay = Seconds (0);
@@ -143,16 +161,26 @@ FlowMonitor::ReportFirstTx (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t pack
       return;
     }
   Time now = Simulator::Now ();
-  TrackedPacket &tracked = m_trackedPackets[std::make_pair (flowId, packetId)];
+  FlowStats &stats = GetStatsForFlow (flowId);
+  uint64_t key = (static_cast<uint64_t> (flowId) << 32) | packetId;
+  std::pair<TrackedPacketMap::iterator, bool> inserted =
+    m_trackedPackets.insert (std::make_pair (key, TrackedPacket ()));
+  TrackedPacket &tracked = inserted.first->second;
+  if (!inserted.second)
+    {
+      RemoveFromExpiryList (&tracked);
+    }
   tracked.firstSeenTime = now;
   tracked.lastSeenTime = tracked.firstSeenTime;
   tracked.timesForwarded = 0;
+  tracked.key = key;
+  tracked.stats = &stats;
+  AppendToExpiryList (&tracked);
   NS_LOG_DEBUG ("ReportFirstTx: adding tracked packet (flowId=" << flowId << ", packetId=" << packetId
                                                                 << ").");
 
   probe->AddPacketStats (flowId, packetSize, Seconds (0));
 
-  FlowStats &stats = GetStatsForFlow (flowId);
   stats.txBytes += packetSize;
   stats.txPackets++;
   if (stats.txPackets == 1)
@@ -170,7 +198,7 @@ FlowMonitor::ReportForwarding (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t p
     {
       return;
     }
-  std::pair<FlowId, FlowPacketId> key (flowId, packetId);
+  uint64_t key = (static_cast<uint64_t> (flowId) << 32) | packetId;
   TrackedPacketMap::iterator tracked = m_trackedPackets.find (key);
   if (tracked == m_trackedPackets.end ())
     {
@@ -181,6 +209,9 @@ FlowMonitor::ReportForwarding (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t p
 
   tracked->second.timesForwarded++;
   tracked->second.lastSeenTime = Simulator::Now ();
+  // the packet is now the last seen
+  RemoveFromExpiryList (&tracked->second);
+  AppendToExpiryList (&tracked->second);
 
   Time delay = (Simulator::Now () - tracked->second.firstSeenTime);
   probe->AddPacketStats (flowId, packetSize, delay);
@@ -194,7 +225,8 @@ FlowMonitor::ReportLastRx (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t packe
     {
       return;
     }
-  TrackedPacketMap::iterator tracked = m_trackedPackets.find (std::make_pair (flowId, packetId));
+  uint64_t key = (static_cast<uint64_t> (flowId) << 32) | packetId;
+  TrackedPacketMap::iterator tracked = m_trackedPackets.find (key);
   if (tracked == m_trackedPackets.end ())
     {
       NS_LOG_WARN ("Received packet last-tx report (flowId=" << flowId << ", packetId=" << packetId
@@ -206,7 +238,7 @@ FlowMonitor::ReportLastRx (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t packe
   Time delay = (now - tracked->second.firstSeenTime);
   probe->AddPacketStats (flowId, packetSize, delay);
 
-  FlowStats &stats = GetStatsForFlow (flowId);
+  FlowStats &stats = *tracked->second.stats;
   stats.delaySum += delay;
   stats.delayHistogram.AddValue (delay.GetSeconds ());
   if (stats.rxPackets > 0 )
@@ -247,6 +279,7 @@ FlowMonitor::ReportLastRx (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t packe
   NS_LOG_DEBUG ("ReportLastTx: removing tracked packet (flowId="
                 << flowId << ", packetId=" << packetId << ").");
 
+  RemoveFromExpiryList (&tracked->second);
   m_trackedPackets.erase (tracked); // we don't need to track this packet anymore
 }
 
@@ -272,13 +305,15 @@ FlowMonitor::ReportDrop (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t packetI
   stats.bytesDropped[reasonCode] += packetSize;
   NS_LOG_DEBUG ("++stats.packetsDropped[" << reasonCode<< "]; // becomes: " << stats.packetsDropped[reasonCode]);
 
-  TrackedPacketMap::iterator tracked = m_trackedPackets.find (std::make_pair (flowId, packetId));
+  uint64_t key = (static_cast<uint64_t> (flowId) << 32) | packetId;
+  TrackedPacketMap::iterator tracked = m_trackedPackets.find (key);
   if (tracked != m_trackedPackets.end ())
     {
       // we don't need to track this packet anymore
       // FIXME: this will not necessarily be true with broadcast/multicast
       NS_LOG_DEBUG ("ReportDrop: removing tracked packet (flowId="
                     << flowId << ", packetId=" << packetId << ").");
+      RemoveFromExpiryList (&tracked->second);
       m_trackedPackets.erase (tracked);
     }
 }
@@ -290,28 +325,59 @@ FlowMonitor::GetFlowStats () const
 }
 
 
+void
+FlowMonitor::AppendToExpiryList (TrackedPacket *tracked)
+{
+  tracked->prev = m_expiryTail;
+  tracked->next = 0;
+  if (m_expiryTail != 0)
+    {
+      m_expiryTail->next = tracked;
+    }
+  else
+    {
+      m_expiryHead = tracked;
+    }
+  m_expiryTail = tracked;
+}
+
+void
+FlowMonitor::RemoveFromExpiryList (TrackedPacket *tracked)
+{
+  if (tracked->prev != 0)
+    {
+      tracked->prev->next = tracked->next;
+    }
+  else
+    {
+      m_expiryHead = tracked->next;
+    }
+  if (tracked->next != 0)
+    {
+      tracked->next->prev = tracked->prev;
+    }
+  else
+    {
+      m_expiryTail = tracked->prev;
+    }
+}
+
 void
 FlowMonitor::CheckForLostPackets (Time maxDelay)
 {
   Time now = Simulator::Now ();
 
-  for (TrackedPacketMap::iterator iter = m_trackedPackets.begin ();
-       iter != m_trackedPackets.end (); )
+  // the packets are seen at the current time, so that the expiry list
+  // is ordered by lastSeenTime: stop at the first packet not lost
+  while (m_expiryHead != 0 && now - m_expiryHead->lastSeenTime >= maxDelay)
     {
-      if (now - iter->second.lastSeenTime >= maxDelay)
-        {
-          // packet is considered lost, add it to the loss statistics
-          FlowStatsContainerI flow = m_flowStats.find (iter->first.first);
-          NS_ASSERT (flow != m_flowStats.end ());
-          flow->second.lostPackets++;
+      // packet is considered lost, add it to the loss statistics
+      TrackedPacket *tracked = m_expiryHead;
+      tracked->stats->lostPackets++;
 
-          // we won't track it anymore
-          m_trackedPackets.erase (iter++);
-        }
-      else
-        {
-          iter++;
-        }
+      // we won't track it anymore
+      RemoveFromExpiryList (tracked);
+      m_trackedPackets.erase (tracked->key);
     }
 }
 
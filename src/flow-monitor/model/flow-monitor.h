@@ -23,6 +23,7 @@
 
 #include <vector>
 #include <map>
+#include <unordered_map>
 
 #include "ns3/ptr.h"
 #include "ns3/object.h"
@@ -270,14 +271,24 @@ private:
     Time firstSeenTime; //!< absolute time when the packet was first seen by a probe
     Time lastSeenTime; //!< absolute time when the packet was last seen by a probe
     uint32_t timesForwarded; //!< number of times the packet was reportedly forwarded
+    uint64_t key; //!< key of the packet in m_trackedPackets
+    FlowStats *stats; //!< stats of the flow of the packet
+    TrackedPacket *prev; //!< previous packet in the expiry list
+    TrackedPacket *next; //!< next packet in the expiry list
   };
 
   /// FlowId --> FlowStats
   FlowStatsContainer m_flowStats;
+  /// FlowId --> FlowStats, for the flow ids up to MAX_INDEXED_FLOW_ID
+  std::vector<FlowStats *> m_flowStatsIndex;
 
-  /// (FlowId,PacketId) --> TrackedPacket
-  typedef std::map< std::pair<FlowId, FlowPacketId>, TrackedPacket> TrackedPacketMap;
+  /// (FlowId,PacketId) --> TrackedPacket, keyed by FlowId << 32 | PacketId
+  typedef std::unordered_map<uint64_t, TrackedPacket> TrackedPacketMap;
   TrackedPacketMap m_trackedPackets; //!< Tracked packets
+  /// The tracked packets, linked by increasing lastSeenTime, so that
+  /// the packets considered lost are at the head of the list
+  TrackedPacket *m_expiryHead;
+  TrackedPacket *m_expiryTail; //!< The packet seen last
   Time m_maxPerHopDelay; //!< Minimum per-hop delay
   FlowProbeContainer m_flowProbes; //!< all the FlowProbes
 
@@ -300,6 +311,14 @@ private:
 
   /// Periodic function to check for lost packets and prune statistics
   void PeriodicCheckForLostPackets ();
+
+  /// Append a packet just seen to the tail of the expiry list
+  /// \param tracked the packet
+  void AppendToExpiryList (TrackedPacket *tracked);
+
+  /// Remove a packet from the expiry list
+  /// \param tracked the packet
+  void RemoveFromExpiryList (TrackedPacket *tracked);
 };
 
 
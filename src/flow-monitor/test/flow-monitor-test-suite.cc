@@ -0,0 +1,286 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation;
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include "ns3/flow-monitor.h"
+#include "ns3/flow-monitor-stream.h"
+#include "ns3/flow-probe.h"
+#include "ns3/simulator.h"
+#include "ns3/nstime.h"
+#include "ns3/test.h"
+#include "ns3/enum.h"
+#include <cstdio>
+#include <map>
+
+using namespace ns3;
+
+/// A probe reporting the packets of the tests
+class TestFlowProbe : public FlowProbe
+{
+public:
+  /// Constructor
+  /// \param monitor the FlowMonitor
+  TestFlowProbe (Ptr<FlowMonitor> monitor)
+    : FlowProbe (monitor)
+  {
+  }
+};
+
+class FlowMonitorLostPacketsTestCase : public ns3::TestCase {
+public:
+  FlowMonitorLostPacketsTestCase ();
+  virtual void DoRun (void);
+
+private:
+  void FirstTx (FlowId flowId, FlowPacketId packetId);
+  void Forward (FlowId flowId, FlowPacketId packetId);
+  void LastRx (FlowId flowId, FlowPacketId packetId);
+  void Drop (FlowId flowId, FlowPacketId packetId);
+  void Check (FlowId flowId, uint32_t lostPackets);
+
+  Ptr<FlowMonitor> m_monitor;
+  Ptr<TestFlowProbe> m_probe;
+};
+
+FlowMonitorLostPacketsTestCase::FlowMonitorLostPacketsTestCase ()
+  : ns3::TestCase ("Check the packets considered lost by the FlowMonitor")
+{
+}
+
+void
+FlowMonitorLostPacketsTestCase::FirstTx (FlowId flowId, FlowPacketId packetId)
+{
+  m_monitor->ReportFirstTx (m_probe, flowId, packetId, 100);
+}
+
+void
+FlowMonitorLostPacketsTestCase::Forward (FlowId flowId, FlowPacketId packetId)
+{
+  m_monitor->ReportForwarding (m_probe, flowId, packetId, 100);
+}
+
+void
+FlowMonitorLostPacketsTestCase::LastRx (FlowId flowId, FlowPacketId packetId)
+{
+  m_monitor->ReportLastRx (m_probe, flowId, packetId, 100);
+}
+
+void
+FlowMonitorLostPacketsTestCase::Drop (FlowId flowId, FlowPacketId packetId)
+{
+  m_monitor->ReportDrop (m_probe, flowId, packetId, 100, 0);
+}
+
+void
+FlowMonitorLostPacketsTestCase::Check (FlowId flowId, uint32_t lostPackets)
+{
+  m_monitor->CheckForLostPackets (Seconds (1));
+  const FlowMonitor::FlowStatsContainer &stats = m_monitor->GetFlowStats ();
+  FlowMonitor::FlowStatsContainerCI flow = stats.find (flowId);
+  NS_TEST_ASSERT_MSG_EQ ((flow != stats.end ()), true, "Flow " << flowId << " not found");
+  NS_TEST_EXPECT_MSG_EQ (flow->second.lostPackets, lostPackets,
+                         "Wrong lost packets of flow " << flowId << " at " << Simulator::Now ().GetSeconds ());
+}
+
+void
+FlowMonitorLostPacketsTestCase::DoRun (void)
+{
+  m_monitor = CreateObject<FlowMonitor> ();
+  m_probe = Create<TestFlowProbe> (m_monitor);
+  m_monitor->StartRightNow ();
+
+  // flow 1: packet 2 received, packet 1 forwarded at 1s, packet 3 never seen again
+  for (FlowPacketId i = 1; i <= 3; i++)
+    {
+      Simulator::Schedule (Seconds (0.1), &FlowMonitorLostPacketsTestCase::FirstTx, this, 1, i);
+    }
+  Simulator::Schedule (Seconds (0.5), &FlowMonitorLostPacketsTestCase::LastRx, this, 1, 2);
+  Simulator::Schedule (Seconds (1.0), &FlowMonitorLostPacketsTestCase::Forward, this, 1, 1);
+  // flow 7: packet 1 dropped, packet 2 sent after the packets of flow 1
+  Simulator::Schedule (Seconds (0.2), &FlowMonitorLostPacketsTestCase::FirstTx, this, 7, 1);
+  Simulator::Schedule (Seconds (0.3), &FlowMonitorLostPacketsTestCase::Drop, this, 7, 1);
+  Simulator::Schedule (Seconds (0.6), &FlowMonitorLostPacketsTestCase::FirstTx, this, 7, 2);
+
+  Simulator::Schedule (Seconds (1.05), &FlowMonitorLostPacketsTestCase::Check, this, 1, 0);
+  Simulator::Schedule (Seconds (1.15), &FlowMonitorLostPacketsTestCase::Check, this, 1, 1);
+  Simulator::Schedule (Seconds (1.15), &FlowMonitorLostPacketsTestCase::Check, this, 7, 1);
+  Simulator::Schedule (Seconds (1.65), &FlowMonitorLostPacketsTestCase::Check, this, 7, 2);
+  Simulator::Schedule (Seconds (1.65), &FlowMonitorLostPacketsTestCase::Check, this, 1, 1);
+  Simulator::Schedule (Seconds (2.05), &FlowMonitorLostPacketsTestCase::Check, this, 1, 2);
+  Simulator::Stop (Seconds (2.5));
+  Simulator::Run ();
+
+  const FlowMonitor::FlowStats &stats = m_monitor->GetFlowStats ().find (1)->second;
+  NS_TEST_EXPECT_MSG_EQ (stats.txPackets, 3, "Wrong sent packets");
+  NS_TEST_EXPECT_MSG_EQ (stats.rxPackets, 1, "Wrong received packets");
+  NS_TEST_EXPECT_MSG_EQ (stats.timesForwarded, 0, "Wrong forwards of the received packets");
+
+  m_probe = 0;
+  m_monitor->Dispose ();
+  m_monitor = 0;
+  Simulator::Destroy ();
+}
+
+class FlowMonitorStreamTestCase : public ns3::TestCase {
+public:
+  FlowMonitorStreamTestCase ();
+  virtual void DoRun (void);
+
+private:
+  void FirstTx (FlowId flowId, FlowPacketId packetId);
+  void LastRx (FlowId flowId, FlowPacketId packetId);
+  void Drop (FlowId flowId, FlowPacketId packetId, uint32_t reasonCode);
+
+  Ptr<FlowMonitor> m_monitor;
+  Ptr<TestFlowProbe> m_probe;
+};
+
+FlowMonitorStreamTestCase::FlowMonitorStreamTestCase ()
+  : ns3::TestCase ("Check the flow statistics streamed by FlowMonitorStream")
+{
+}
+
+void
+FlowMonitorStreamTestCase::FirstTx (FlowId flowId, FlowPacketId packetId)
+{
+  m_monitor->ReportFirstTx (m_probe, flowId, packetId, 100 + flowId);
+}
+
+void
+FlowMonitorStreamTestCase::LastRx (FlowId flowId, FlowPacketId packetId)
+{
+  m_monitor->ReportLastRx (m_probe, flowId, packetId, 100 + flowId);
+}
+
+void
+FlowMonitorStreamTestCase::Drop (FlowId flowId, FlowPacketId packetId, uint32_t reasonCode)
+{
+  m_monitor->ReportDrop (m_probe, flowId, packetId, 100 + flowId, reasonCode);
+}
+
+void
+FlowMonitorStreamTestCase::DoRun (void)
+{
+  m_monitor = CreateObject<FlowMonitor> ();
+  m_monitor->SetAttribute ("MaxPerHopDelay", TimeValue (Seconds (0.5)));
+  m_probe = Create<TestFlowProbe> (m_monitor);
+  m_monitor->StartRightNow ();
+  std::string fileName = CreateTempDirFilename ("flow-monitor-stream.bin");
+  Ptr<FlowMonitorStream> stream = CreateObject<FlowMonitorStream> ();
+  stream->SetAttribute ("Format", EnumValue (FlowMonitorStream::BINARY_FORMAT));
+  stream->SetAttribute ("Interval", TimeValue (Seconds (0.25)));
+  stream->Start (m_monitor, fileName);
+
+  // flow 2 is idle during the second second, every third packet of flow 1 is lost,
+  // the first five ones being dropped for two different reasons
+  for (FlowPacketId i = 0; i < 40; i++)
+    {
+      Time t = MilliSeconds (50 * i + 10);
+      Simulator::Schedule (t, &FlowMonitorStreamTestCase::FirstTx, this, 1, i);
+      if (i % 3 != 0)
+        {
+          Simulator::Schedule (t + MilliSeconds (20), &FlowMonitorStreamTestCase::LastRx, this, 1, i);
+        }
+      else if (i < 15)
+        {
+          Simulator::Schedule (t + MilliSeconds (20), &FlowMonitorStreamTestCase::Drop, this, 1, i, i % 2);
+        }
+      if (i < 20 || i >= 30)
+        {
+          Simulator::Schedule (t, &FlowMonitorStreamTestCase::FirstTx, this, 2, i);
+          Simulator::Schedule (t + MilliSeconds (i % 7), &FlowMonitorStreamTestCase::LastRx, this, 2, i);
+        }
+    }
+  Simulator::Stop (Seconds (3));
+  Simulator::Run ();
+  stream->Stop ();
+
+  FILE *in = fopen (fileName.c_str (), "rb");
+  NS_TEST_ASSERT_MSG_NE (in, 0, "Cannot open " << fileName);
+  uint8_t data[FlowMonitorStream::RECORD_SIZE];
+  FlowMonitorStream::BinaryHeader header;
+  NS_TEST_ASSERT_MSG_EQ (fread (data, 1, FlowMonitorStream::BINARY_HEADER_SIZE, in),
+                         FlowMonitorStream::BINARY_HEADER_SIZE, "Missing header");
+  NS_TEST_EXPECT_MSG_EQ (FlowMonitorStream::DecodeHeader (data, header), true, "Bad header");
+  std::map<FlowId, FlowMonitorStream::Record> sums;
+  std::map<FlowId, uint32_t> records;
+  int64_t lastTime = 0;
+  while (fread (data, 1, FlowMonitorStream::RECORD_SIZE, in) == FlowMonitorStream::RECORD_SIZE)
+    {
+      FlowMonitorStream::Record record;
+      FlowMonitorStream::DecodeRecord (data, record);
+      NS_TEST_EXPECT_MSG_GT_OR_EQ (record.timeNs, lastTime, "Records not in time order");
+      NS_TEST_EXPECT_MSG_EQ (record.timeNs % MilliSeconds (250).GetNanoSeconds (), 0, "Record not at an interval");
+      lastTime = record.timeNs;
+      FlowMonitorStream::Record &sum = sums[record.flowId];
+      sum.txPackets += record.txPackets;
+      sum.txBytes += record.txBytes;
+      sum.rxPackets += record.rxPackets;
+      sum.lostPackets += record.lostPackets;
+      sum.rxBytes += record.rxBytes;
+      sum.delaySumNs += record.delaySumNs;
+      sum.jitterSumNs += record.jitterSumNs;
+      sum.packetsDropped += record.packetsDropped;
+      sum.bytesDropped += record.bytesDropped;
+      records[record.flowId]++;
+    }
+  fclose (in);
+
+  // flow 1 changes until its last loss is detected at 2.5s, flow 2 is
+  // idle between 1s and 1.5s
+  NS_TEST_EXPECT_MSG_EQ (records[1], 10, "Wrong records of flow 1");
+  NS_TEST_EXPECT_MSG_EQ (records[2], 6, "Wrong records of flow 2");
+  const FlowMonitor::FlowStatsContainer &stats = m_monitor->GetFlowStats ();
+  for (FlowMonitor::FlowStatsContainerCI flow = stats.begin (); flow != stats.end (); ++flow)
+    {
+      const FlowMonitorStream::Record &sum = sums[flow->first];
+      NS_TEST_EXPECT_MSG_EQ (sum.txPackets, flow->second.txPackets, "Wrong sent packets");
+      NS_TEST_EXPECT_MSG_EQ (sum.txBytes, flow->second.txBytes, "Wrong sent bytes");
+      NS_TEST_EXPECT_MSG_EQ (sum.rxPackets, flow->second.rxPackets, "Wrong received packets");
+      NS_TEST_EXPECT_MSG_EQ (sum.lostPackets, flow->second.lostPackets, "Wrong lost packets");
+      NS_TEST_EXPECT_MSG_EQ (sum.rxBytes, flow->second.rxBytes, "Wrong received bytes");
+      NS_TEST_EXPECT_MSG_EQ (sum.delaySumNs, flow->second.delaySum.GetNanoSeconds (), "Wrong delay sum");
+      NS_TEST_EXPECT_MSG_EQ (sum.jitterSumNs, flow->second.jitterSum.GetNanoSeconds (), "Wrong jitter sum");
+    }
+  NS_TEST_EXPECT_MSG_EQ (sums[1].lostPackets, 14, "Wrong lost packets of flow 1");
+  NS_TEST_EXPECT_MSG_EQ (sums[1].packetsDropped, 5, "Wrong dropped packets of flow 1");
+  NS_TEST_EXPECT_MSG_EQ (sums[1].bytesDropped, 505, "Wrong dropped bytes of flow 1");
+  NS_TEST_EXPECT_MSG_EQ (sums[2].packetsDropped, 0, "Wrong dropped packets of flow 2");
+
+  FlowMonitorStream::Record record = sums[2];
+  record.timeNs = 1;
+  record.flowId = 2;
+  record.timesForwarded = 0;
+  std::string line = FlowMonitorStream::FormatCsv (record);
+  NS_TEST_EXPECT_MSG_EQ (line.substr (0, 12), "1,2,30,3060,", "Wrong CSV record");
+  NS_TEST_EXPECT_MSG_EQ (line.substr (line.size () - 5), ",0,0\n", "Wrong CSV drops");
+
+  m_probe = 0;
+  stream->Dispose ();
+  m_monitor->Dispose ();
+  m_monitor = 0;
+  Simulator::Destroy ();
+}
+
+static class FlowMonitorTestSuite : public TestSuite
+{
+public:
+  FlowMonitorTestSuite ()
+    : TestSuite ("flow-monitor", UNIT)
+  {
+    AddTestCase (new FlowMonitorLostPacketsTestCase (), TestCase::QUICK);
+    AddTestCase (new FlowMonitorStreamTestCase (), TestCase::QUICK);
+  }
+} g_FlowMonitorTestSuite;
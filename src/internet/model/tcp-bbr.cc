@@ -0,0 +1,603 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "tcp-bbr.h"
+#include "ns3/tcp-socket-base.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TcpBbr");
+NS_OBJECT_ENSURE_REGISTERED (TcpBbr);
+
+namespace {
+
+/// Number of phases of the pacing gain cycle of PROBE_BW
+const uint32_t BBR_CYCLE_LEN = 8;
+
+/// Pacing gains of the PROBE_BW cycle: probe, drain, then cruise
+const double BBR_PACING_GAIN[BBR_CYCLE_LEN] = { 1.25, 0.75, 1, 1, 1, 1, 1, 1 };
+
+/// Growth of the bandwidth in a round showing that the pipe is not full
+const double BBR_FULL_BW_THRESH = 1.25;
+
+/// Rounds without growth after which the pipe is full
+const uint32_t BBR_FULL_BW_COUNT = 3;
+
+/// Minimum cWnd, in segments, to keep the ACK clock running
+const uint32_t BBR_MIN_PIPE_CWND = 4;
+
+} // anonymous namespace
+
+const char* const
+TcpBbr::BbrModeName[TcpBbr::BBR_PROBE_RTT + 1] =
+{
+  "BBR_STARTUP", "BBR_DRAIN", "BBR_PROBE_BW", "BBR_PROBE_RTT"
+};
+
+TypeId
+TcpBbr::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TcpBbr")
+    .SetParent<TcpCongestionOps> ()
+    .AddConstructor<TcpBbr> ()
+    .SetGroupName ("Internet")
+    .AddAttribute ("HighGain", "Pacing and cWnd gain of STARTUP",
+                   DoubleValue (2.885),
+                   MakeDoubleAccessor (&TcpBbr::m_highGain),
+                   MakeDoubleChecker<double> (1.0))
+    .AddAttribute ("CwndGain", "cWnd gain of PROBE_BW",
+                   DoubleValue (2.0),
+                   MakeDoubleAccessor (&TcpBbr::m_cwndGainProbeBw),
+                   MakeDoubleChecker<double> (1.0))
+    .AddAttribute ("BwWindowLength", "Length of the bandwidth filter window, in rounds",
+                   UintegerValue (10),
+                   MakeUintegerAccessor (&TcpBbr::m_bwWindowLength),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("MinRttWindow", "Length of the minimum RTT filter window",
+                   TimeValue (Seconds (10)),
+                   MakeTimeAccessor (&TcpBbr::m_minRttWindow),
+                   MakeTimeChecker ())
+    .AddAttribute ("ProbeRttDuration", "Minimum time spent in PROBE_RTT",
+                   TimeValue (MilliSeconds (200)),
+                   MakeTimeAccessor (&TcpBbr::m_probeRttDuration),
+                   MakeTimeChecker ())
+  ;
+  return tid;
+}
+
+TcpBbr::TcpBbr (void)
+  : TcpCongestionOps (),
+    m_highGain (2.885),
+    m_cwndGainProbeBw (2.0),
+    m_bwWindowLength (10),
+    m_minRttWindow (Seconds (10)),
+    m_probeRttDuration (MilliSeconds (200)),
+    m_minRtt (Time::Max ()),
+    m_minRttStamp (Seconds (0)),
+    m_hasSeenRtt (false),
+    m_mode (BBR_STARTUP),
+    m_pacingGain (2.885),
+    m_cwndGain (2.885),
+    m_nextRoundDelivered (0),
+    m_roundCount (0),
+    m_roundStart (false),
+    m_fullBw (0),
+    m_fullBwCount (0),
+    m_fullBwReached (false),
+    m_cycleIndex (0),
+    m_cycleStamp (Seconds (0)),
+    m_probeRttDoneStamp (Seconds (0)),
+    m_probeRttRoundDone (false),
+    m_priorCwnd (0),
+    m_packetConservation (false),
+    m_prevCongState (TcpSocketState::CA_OPEN)
+{
+  NS_LOG_FUNCTION (this);
+  for (uint32_t i = 0; i < 3; ++i)
+    {
+      m_bw[i].m_round = 0;
+      m_bw[i].m_bw = 0;
+    }
+  m_uv = CreateObject<UniformRandomVariable> ();
+}
+
+TcpBbr::TcpBbr (const TcpBbr& sock)
+  : TcpCongestionOps (sock),
+    m_highGain (sock.m_highGain),
+    m_cwndGainProbeBw (sock.m_cwndGainProbeBw),
+    m_bwWindowLength (sock.m_bwWindowLength),
+    m_minRttWindow (sock.m_minRttWindow),
+    m_probeRttDuration (sock.m_probeRttDuration),
+    m_minRtt (sock.m_minRtt),
+    m_minRttStamp (sock.m_minRttStamp),
+    m_hasSeenRtt (sock.m_hasSeenRtt),
+    m_mode (sock.m_mode),
+    m_pacingGain (sock.m_pacingGain),
+    m_cwndGain (sock.m_cwndGain),
+    m_nextRoundDelivered (sock.m_nextRoundDelivered),
+    m_roundCount (sock.m_roundCount),
+    m_roundStart (sock.m_roundStart),
+    m_fullBw (sock.m_fullBw),
+    m_fullBwCount (sock.m_fullBwCount),
+    m_fullBwReached (sock.m_fullBwReached),
+    m_cycleIndex (sock.m_cycleIndex),
+    m_cycleStamp (sock.m_cycleStamp),
+    m_probeRttDoneStamp (sock.m_probeRttDoneStamp),
+    m_probeRttRoundDone (sock.m_probeRttRoundDone),
+    m_priorCwnd (sock.m_priorCwnd),
+    m_packetConservation (sock.m_packetConservation),
+    m_prevCongState (sock.m_prevCongState)
+{
+  NS_LOG_FUNCTION (this);
+  for (uint32_t i = 0; i < 3; ++i)
+    {
+      m_bw[i] = sock.m_bw[i];
+    }
+  m_uv = CreateObject<UniformRandomVariable> ();
+}
+
+TcpBbr::~TcpBbr (void)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+std::string
+TcpBbr::GetName () const
+{
+  return "TcpBbr";
+}
+
+Ptr<TcpCongestionOps>
+TcpBbr::Fork (void)
+{
+  return CopyObject<TcpBbr> (this);
+}
+
+bool
+TcpBbr::HasPacingRate (void) const
+{
+  return true;
+}
+
+bool
+TcpBbr::HasCongControl (void) const
+{
+  return true;
+}
+
+TcpBbr::BbrMode_t
+TcpBbr::GetMode (void) const
+{
+  return m_mode;
+}
+
+DataRate
+TcpBbr::GetBw (void) const
+{
+  return DataRate (m_bw[0].m_bw);
+}
+
+Time
+TcpBbr::GetMinRtt (void) const
+{
+  return m_minRtt;
+}
+
+void
+TcpBbr::Init (Ptr<TcpSocketState> tcb)
+{
+  NS_LOG_FUNCTION (this << tcb);
+
+  m_mode = BBR_STARTUP;
+  m_pacingGain = m_highGain;
+  m_cwndGain = m_highGain;
+  m_nextRoundDelivered = tcb->m_delivered;
+  m_minRttStamp = Simulator::Now ();
+  m_cycleStamp = Simulator::Now ();
+  m_prevCongState = tcb->m_congState;
+
+  // Without an RTT sample, assume 1 ms as Linux does
+  tcb->m_pacing = true;
+  DataRate rate (static_cast<uint64_t> (m_highGain * tcb->m_cWnd.Get () * 8 / 0.001));
+  tcb->m_pacingRate = std::min (rate, tcb->m_maxPacingRate);
+}
+
+void
+TcpBbr::IncreaseWindow (Ptr<TcpSocketState> tcb, uint32_t segmentsAcked)
+{
+  NS_LOG_FUNCTION (this << tcb << segmentsAcked);
+  // cWnd is set in CongControl
+}
+
+uint32_t
+TcpBbr::GetSsThresh (Ptr<const TcpSocketState> tcb, uint32_t bytesInFlight)
+{
+  NS_LOG_FUNCTION (this << tcb << bytesInFlight);
+
+  // BBR does not reduce its model on a loss: it restores cWnd once the
+  // recovery is over, and keeps it at the flight size meanwhile
+  SaveCwnd (tcb);
+  return std::max (2 * tcb->m_segmentSize, bytesInFlight);
+}
+
+void
+TcpBbr::CongestionStateSet (Ptr<TcpSocketState> tcb,
+                            const TcpSocketState::TcpCongState_t newState)
+{
+  NS_LOG_FUNCTION (this << tcb << newState);
+
+  if (newState == TcpSocketState::CA_LOSS)
+    {
+      // After an RTO the bandwidth has to be probed again; cWnd is
+      // restored when the loss state is left
+      SaveCwnd (tcb);
+      m_prevCongState = TcpSocketState::CA_LOSS;
+      m_fullBw = 0;
+    }
+}
+
+void
+TcpBbr::CongControl (Ptr<TcpSocketState> tcb, const TcpRateSample &rs)
+{
+  NS_LOG_FUNCTION (this << tcb);
+
+  UpdateBw (tcb, rs);
+  UpdateCyclePhase (tcb);
+  CheckFullBwReached (rs);
+  CheckDrain (tcb);
+  UpdateMinRtt (tcb, rs);
+
+  if (!m_hasSeenRtt && rs.m_rtt.IsStrictlyPositive ())
+    {
+      // First RTT sample: pace the current window over it
+      m_hasSeenRtt = true;
+      DataRate rate (static_cast<uint64_t> (m_highGain * tcb->m_cWnd.Get () * 8
+                                            / rs.m_rtt.GetSeconds ()));
+      tcb->m_pacingRate = std::min (rate, tcb->m_maxPacingRate);
+    }
+
+  SetPacingRate (tcb);
+  SetCwnd (tcb, rs);
+
+  NS_LOG_DEBUG (BbrModeName[m_mode] << " bw " << GetBw () << " minRtt " <<
+                m_minRtt << " pacing " << tcb->m_pacingRate << " cWnd " <<
+                tcb->m_cWnd << " inflight " << tcb->m_bytesInFlight);
+}
+
+void
+TcpBbr::UpdateBw (Ptr<TcpSocketState> tcb, const TcpRateSample &rs)
+{
+  m_roundStart = false;
+  if (!rs.m_interval.IsStrictlyPositive ())
+    {
+      return; // Not a valid sample
+    }
+
+  // A round ends when the segment sent at its start is acknowledged
+  if (rs.m_priorDelivered >= m_nextRoundDelivered)
+    {
+      m_nextRoundDelivered = tcb->m_delivered;
+      m_roundCount++;
+      m_roundStart = true;
+      m_packetConservation = false;
+    }
+
+  // An application limited sample only shows a lower bound of the
+  // bandwidth: it may raise the estimate, not age it
+  uint64_t bw = rs.m_deliveryRate.GetBitRate ();
+  if (bw > 0 && (!rs.m_isAppLimited || bw >= m_bw[0].m_bw))
+    {
+      RunningMaxBw (m_roundCount, bw);
+    }
+}
+
+void
+TcpBbr::RunningMaxBw (uint32_t round, uint64_t bw)
+{
+  BwSample sample;
+  sample.m_round = round;
+  sample.m_bw = bw;
+
+  // New maximum, or nothing left in the window: reset the three samples
+  if (bw >= m_bw[0].m_bw || round - m_bw[2].m_round > m_bwWindowLength)
+    {
+      m_bw[0] = m_bw[1] = m_bw[2] = sample;
+      return;
+    }
+
+  if (bw >= m_bw[1].m_bw)
+    {
+      m_bw[2] = m_bw[1] = sample;
+    }
+  else if (bw >= m_bw[2].m_bw)
+    {
+      m_bw[2] = sample;
+    }
+
+  // Age the samples: the best one must stay in the window, and the others
+  // must be taken from the later quarter and half of it
+  uint32_t age = round - m_bw[0].m_round;
+  if (age > m_bwWindowLength)
+    {
+      m_bw[0] = m_bw[1];
+      m_bw[1] = m_bw[2];
+      m_bw[2] = sample;
+      if (round - m_bw[0].m_round > m_bwWindowLength)
+        {
+          m_bw[0] = m_bw[1];
+          m_bw[1] = m_bw[2];
+          m_bw[2] = sample;
+        }
+    }
+  else if (m_bw[1].m_round == m_bw[0].m_round && age > m_bwWindowLength / 4)
+    {
+      m_bw[2] = m_bw[1] = sample;
+    }
+  else if (m_bw[2].m_round == m_bw[1].m_round && age > m_bwWindowLength / 2)
+    {
+      m_bw[2] = sample;
+    }
+}
+
+uint32_t
+TcpBbr::GetInflight (Ptr<const TcpSocketState> tcb, double gain) const
+{
+  if (m_minRtt == Time::Max ())
+    {
+      // No RTT sample yet: the initial window
+      return tcb->m_initialCWnd * tcb->m_segmentSize;
+    }
+
+  double bdp = m_bw[0].m_bw * m_minRtt.GetSeconds () / 8;
+  // Room for the segments held by the delayed ACKs and by the pacing
+  return static_cast<uint32_t> (gain * bdp) + 3 * tcb->m_segmentSize;
+}
+
+void
+TcpBbr::UpdateCyclePhase (Ptr<TcpSocketState> tcb)
+{
+  if (m_mode != BBR_PROBE_BW)
+    {
+      return;
+    }
+
+  Time now = Simulator::Now ();
+  bool isFullLength = now - m_cycleStamp > m_minRtt;
+  bool next;
+
+  if (m_pacingGain == 1.0)
+    {
+      next = isFullLength;
+    }
+  else if (m_pacingGain > 1.0)
+    {
+      // Probe until the extra data is in flight
+      next = isFullLength
+        && tcb->m_bytesInFlight >= GetInflight (tcb, m_pacingGain);
+    }
+  else
+    {
+      // Drain until the queue of the probe is gone
+      next = isFullLength || tcb->m_bytesInFlight <= GetInflight (tcb, 1.0);
+    }
+
+  if (next)
+    {
+      m_cycleIndex = (m_cycleIndex + 1) % BBR_CYCLE_LEN;
+      m_cycleStamp = now;
+      m_pacingGain = BBR_PACING_GAIN[m_cycleIndex];
+    }
+}
+
+void
+TcpBbr::CheckFullBwReached (const TcpRateSample &rs)
+{
+  if (m_fullBwReached || !m_roundStart || rs.m_isAppLimited)
+    {
+      return;
+    }
+
+  if (m_bw[0].m_bw >= m_fullBw * BBR_FULL_BW_THRESH)
+    {
+      m_fullBw = m_bw[0].m_bw;
+      m_fullBwCount = 0;
+      return;
+    }
+
+  if (++m_fullBwCount >= BBR_FULL_BW_COUNT)
+    {
+      m_fullBwReached = true;
+      NS_LOG_INFO ("Pipe full at " << GetBw ());
+    }
+}
+
+void
+TcpBbr::CheckDrain (Ptr<TcpSocketState> tcb)
+{
+  if (m_mode == BBR_STARTUP && m_fullBwReached)
+    {
+      NS_LOG_DEBUG ("BBR_STARTUP -> BBR_DRAIN");
+      m_mode = BBR_DRAIN;
+      m_pacingGain = 1.0 / m_highGain;
+      m_cwndGain = m_highGain;
+    }
+  if (m_mode == BBR_DRAIN && tcb->m_bytesInFlight <= GetInflight (tcb, 1.0))
+    {
+      EnterProbeBw ();
+    }
+}
+
+void
+TcpBbr::EnterProbeBw (void)
+{
+  NS_LOG_DEBUG (BbrModeName[m_mode] << " -> BBR_PROBE_BW");
+  m_mode = BBR_PROBE_BW;
+  m_cwndGain = m_cwndGainProbeBw;
+
+  // Any phase but the draining one; the next ACK advances it
+  m_cycleIndex = BBR_CYCLE_LEN - 1 - m_uv->GetInteger (0, BBR_CYCLE_LEN - 2);
+  m_cycleIndex = (m_cycleIndex + 1) % BBR_CYCLE_LEN;
+  m_cycleStamp = Simulator::Now ();
+  m_pacingGain = BBR_PACING_GAIN[m_cycleIndex];
+}
+
+void
+TcpBbr::UpdateMinRtt (Ptr<TcpSocketState> tcb, const TcpRateSample &rs)
+{
+  Time now = Simulator::Now ();
+  bool filterExpired = now > m_minRttStamp + m_minRttWindow;
+
+  if (rs.m_rtt.IsStrictlyPositive () && (rs.m_rtt <= m_minRtt || filterExpired))
+    {
+      m_minRtt = rs.m_rtt;
+      m_minRttStamp = now;
+    }
+
+  if (m_probeRttDuration.IsStrictlyPositive () && filterExpired
+      && m_mode != BBR_PROBE_RTT)
+    {
+      NS_LOG_DEBUG (BbrModeName[m_mode] << " -> BBR_PROBE_RTT");
+      m_mode = BBR_PROBE_RTT;
+      m_pacingGain = 1.0;
+      m_cwndGain = 1.0;
+      SaveCwnd (tcb);
+      m_probeRttDoneStamp = Seconds (0);
+    }
+
+  if (m_mode != BBR_PROBE_RTT)
+    {
+      return;
+    }
+
+  if (m_probeRttDoneStamp.IsZero ()
+      && tcb->m_bytesInFlight <= BBR_MIN_PIPE_CWND * tcb->m_segmentSize)
+    {
+      // The flight is down: stay for the duration and a whole round
+      m_probeRttDoneStamp = now + m_probeRttDuration;
+      m_probeRttRoundDone = false;
+      m_nextRoundDelivered = tcb->m_delivered;
+    }
+  else if (!m_probeRttDoneStamp.IsZero ())
+    {
+      if (m_roundStart)
+        {
+          m_probeRttRoundDone = true;
+        }
+      if (m_probeRttRoundDone && now > m_probeRttDoneStamp)
+        {
+          m_minRttStamp = now;
+          tcb->m_cWnd = std::max (tcb->m_cWnd.Get (), m_priorCwnd);
+          if (m_fullBwReached)
+            {
+              EnterProbeBw ();
+            }
+          else
+            {
+              NS_LOG_DEBUG ("BBR_PROBE_RTT -> BBR_STARTUP");
+              m_mode = BBR_STARTUP;
+              m_pacingGain = m_highGain;
+              m_cwndGain = m_highGain;
+            }
+        }
+    }
+}
+
+void
+TcpBbr::SetPacingRate (Ptr<TcpSocketState> tcb)
+{
+  if (m_bw[0].m_bw == 0)
+    {
+      return;
+    }
+
+  DataRate rate (static_cast<uint64_t> (m_pacingGain * m_bw[0].m_bw));
+  rate = std::min (rate, tcb->m_maxPacingRate);
+
+  // Until the pipe is full, do not slow down on a low sample
+  if (m_fullBwReached || rate > tcb->m_pacingRate)
+    {
+      tcb->m_pacingRate = rate;
+    }
+}
+
+void
+TcpBbr::SaveCwnd (Ptr<const TcpSocketState> tcb)
+{
+  if (m_prevCongState < TcpSocketState::CA_RECOVERY && m_mode != BBR_PROBE_RTT)
+    {
+      m_priorCwnd = tcb->m_cWnd;
+    }
+  else
+    {
+      m_priorCwnd = std::max (m_priorCwnd, tcb->m_cWnd.Get ());
+    }
+}
+
+void
+TcpBbr::SetCwnd (Ptr<TcpSocketState> tcb, const TcpRateSample &rs)
+{
+  uint32_t acked = rs.m_ackedSacked;
+  uint32_t cwnd = tcb->m_cWnd;
+  uint32_t minCwnd = BBR_MIN_PIPE_CWND * tcb->m_segmentSize;
+  TcpSocketState::TcpCongState_t state = tcb->m_congState;
+
+  // Packet conservation in the first round of a recovery, then restore the
+  // window saved before the loss once the recovery is over
+  if (state >= TcpSocketState::CA_RECOVERY && m_prevCongState < TcpSocketState::CA_RECOVERY)
+    {
+      m_packetConservation = true;
+      m_nextRoundDelivered = tcb->m_delivered;
+      cwnd = tcb->m_bytesInFlight + acked;
+    }
+  else if (state < TcpSocketState::CA_RECOVERY && m_prevCongState >= TcpSocketState::CA_RECOVERY)
+    {
+      cwnd = std::max (cwnd, m_priorCwnd);
+      m_packetConservation = false;
+    }
+  m_prevCongState = state;
+
+  if (m_packetConservation)
+    {
+      cwnd = std::max (cwnd, tcb->m_bytesInFlight + acked);
+    }
+  else if (acked > 0)
+    {
+      uint32_t target = GetInflight (tcb, m_cwndGain);
+      if (m_fullBwReached)
+        {
+          cwnd = std::min (cwnd + acked, target);
+        }
+      else if (cwnd < target || tcb->m_delivered < tcb->m_initialCWnd * tcb->m_segmentSize)
+        {
+          cwnd = cwnd + acked;
+        }
+      cwnd = std::max (cwnd, minCwnd);
+    }
+
+  if (m_mode == BBR_PROBE_RTT)
+    {
+      cwnd = std::min (cwnd, minCwnd);
+    }
+
+  tcb->m_cWnd = cwnd;
+}
+
+} // namespace ns3
@@ -0,0 +1,257 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef TCPBBR_H
+#define TCPBBR_H
+
+#include "ns3/tcp-congestion-ops.h"
+#include "ns3/random-variable-stream.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup congestionOps
+ *
+ * \brief An implementation of BBR (Bottleneck Bandwidth and RTT)
+ *
+ * BBR builds a model of the path from the delivery rate samples of the ACKs:
+ * the bottleneck bandwidth is the windowed maximum of the delivery rate over
+ * the last BwWindowLength rounds, and the propagation delay is the windowed
+ * minimum of the RTT over the last MinRttWindow. The sender paces at the
+ * bandwidth times a pacing gain, and caps cWnd at the bandwidth-delay
+ * product times a cWnd gain. Losses are not taken as a congestion signal.
+ *
+ * The connection goes through four modes:
+ *
+ * - STARTUP: the pacing gain is 2/ln(2), to double the delivery rate every
+ *   round, until the bandwidth does not grow by 25% for 3 rounds;
+ * - DRAIN: the pacing gain is its inverse, until the flight size falls to
+ *   the bandwidth-delay product;
+ * - PROBE_BW: the pacing gain cycles through 5/4, 3/4 and six times 1,
+ *   one phase per minimum RTT, to probe for more bandwidth and then drain
+ *   the queue built by the probe;
+ * - PROBE_RTT: entered when the minimum RTT has not been refreshed for
+ *   MinRttWindow; cWnd is cut to 4 segments for at least ProbeRttDuration
+ *   and one round, to let the queue empty and measure the propagation delay.
+ *
+ * BBR sets the pacing rate and cWnd in CongControl, on every ACK, and
+ * enables pacing on the socket in Init.
+ *
+ * More information: http://dx.doi.org/10.1145/3012426.3022184
+ */
+class TcpBbr : public TcpCongestionOps
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  /**
+   * \brief BBR modes
+   */
+  typedef enum
+  {
+    BBR_STARTUP,    //!< Ramp up the sending rate to find the bandwidth
+    BBR_DRAIN,      //!< Drain the queue built in STARTUP
+    BBR_PROBE_BW,   //!< Cycle the pacing gain around the bandwidth
+    BBR_PROBE_RTT   //!< Cut the flight size to measure the propagation delay
+  } BbrMode_t;
+
+  TcpBbr ();
+
+  /**
+   * \brief Copy constructor.
+   * \param sock object to copy.
+   */
+  TcpBbr (const TcpBbr& sock);
+
+  ~TcpBbr ();
+
+  std::string GetName () const;
+
+  virtual void Init (Ptr<TcpSocketState> tcb);
+  virtual void CongControl (Ptr<TcpSocketState> tcb, const TcpRateSample &rs);
+  virtual void IncreaseWindow (Ptr<TcpSocketState> tcb, uint32_t segmentsAcked);
+  virtual uint32_t GetSsThresh (Ptr<const TcpSocketState> tcb,
+                                uint32_t bytesInFlight);
+  virtual void CongestionStateSet (Ptr<TcpSocketState> tcb,
+                                   const TcpSocketState::TcpCongState_t newState);
+  virtual bool HasPacingRate (void) const;
+  virtual bool HasCongControl (void) const;
+
+  virtual Ptr<TcpCongestionOps> Fork ();
+
+  /**
+   * \brief Get the current mode
+   * \return the mode
+   */
+  BbrMode_t GetMode (void) const;
+
+  /**
+   * \brief Get the estimate of the bottleneck bandwidth
+   * \return the windowed maximum of the delivery rate
+   */
+  DataRate GetBw (void) const;
+
+  /**
+   * \brief Get the estimate of the propagation delay
+   * \return the windowed minimum of the RTT, Time::Max if not sampled yet
+   */
+  Time GetMinRtt (void) const;
+
+  /**
+   * \brief Literal names of the modes, for use in log messages
+   */
+  static const char* const BbrModeName[BBR_PROBE_RTT + 1];
+
+private:
+  /**
+   * \brief Update the bandwidth filter and count the rounds
+   * \param tcb internal congestion state
+   * \param rs rate sample
+   */
+  void UpdateBw (Ptr<TcpSocketState> tcb, const TcpRateSample &rs);
+
+  /**
+   * \brief Add a sample to the windowed maximum of the bandwidth
+   *
+   * Windowed running maximum of Kathleen Nichols, which keeps the best,
+   * second best and third best samples of the window.
+   *
+   * \param round round of the sample
+   * \param bw delivery rate of the sample, in bps
+   */
+  void RunningMaxBw (uint32_t round, uint64_t bw);
+
+  /**
+   * \brief Advance the pacing gain cycle of PROBE_BW when the phase is over
+   * \param tcb internal congestion state
+   */
+  void UpdateCyclePhase (Ptr<TcpSocketState> tcb);
+
+  /**
+   * \brief Detect that STARTUP has filled the pipe
+   *
+   * Application limited rounds are not counted.
+   *
+   * \param rs rate sample
+   */
+  void CheckFullBwReached (const TcpRateSample &rs);
+
+  /**
+   * \brief Leave STARTUP and DRAIN when they are done
+   * \param tcb internal congestion state
+   */
+  void CheckDrain (Ptr<TcpSocketState> tcb);
+
+  /**
+   * \brief Update the minimum RTT, and enter or leave PROBE_RTT
+   * \param tcb internal congestion state
+   * \param rs rate sample
+   */
+  void UpdateMinRtt (Ptr<TcpSocketState> tcb, const TcpRateSample &rs);
+
+  /**
+   * \brief Enter PROBE_BW, at a random phase of the cycle but the draining one
+   */
+  void EnterProbeBw (void);
+
+  /**
+   * \brief Set the pacing rate to the bandwidth times the pacing gain
+   * \param tcb internal congestion state
+   */
+  void SetPacingRate (Ptr<TcpSocketState> tcb);
+
+  /**
+   * \brief Set cWnd towards the bandwidth-delay product times the cWnd gain
+   * \param tcb internal congestion state
+   * \param rs rate sample
+   */
+  void SetCwnd (Ptr<TcpSocketState> tcb, const TcpRateSample &rs);
+
+  /**
+   * \brief Get the flight size for a gain
+   * \param tcb internal congestion state
+   * \param gain gain applied to the bandwidth-delay product
+   * \return the bandwidth-delay product times gain, plus 3 segments
+   */
+  uint32_t GetInflight (Ptr<const TcpSocketState> tcb, double gain) const;
+
+  /**
+   * \brief Remember cWnd before a loss or PROBE_RTT, to restore it later
+   * \param tcb internal congestion state
+   */
+  void SaveCwnd (Ptr<const TcpSocketState> tcb);
+
+  /**
+   * \brief One bandwidth sample of the windowed maximum
+   */
+  struct BwSample
+  {
+    uint32_t m_round;  //!< Round of the sample
+    uint64_t m_bw;     //!< Delivery rate, in bps
+  };
+
+  // Parameters
+  double   m_highGain;          //!< Pacing and cWnd gain of STARTUP
+  double   m_cwndGainProbeBw;   //!< cWnd gain of PROBE_BW
+  uint32_t m_bwWindowLength;    //!< Length of the bandwidth window, in rounds
+  Time     m_minRttWindow;      //!< Length of the minimum RTT window
+  Time     m_probeRttDuration;  //!< Minimum time spent in PROBE_RTT
+
+  // Model
+  BwSample m_bw[3];             //!< Best three samples of the bandwidth window
+  Time     m_minRtt;            //!< Minimum RTT of the window
+  Time     m_minRttStamp;       //!< Time m_minRtt was sampled
+  bool     m_hasSeenRtt;        //!< True once the pacing rate was derived from an RTT
+
+  // Mode
+  BbrMode_t m_mode;             //!< Current mode
+  double   m_pacingGain;        //!< Current pacing gain
+  double   m_cwndGain;          //!< Current cWnd gain
+
+  // Rounds
+  uint64_t m_nextRoundDelivered; //!< Delivered bytes ending the current round
+  uint32_t m_roundCount;        //!< Number of rounds
+  bool     m_roundStart;        //!< True if the last ACK started a round
+
+  // STARTUP
+  uint64_t m_fullBw;            //!< Bandwidth at the last 25% growth, in bps
+  uint32_t m_fullBwCount;       //!< Rounds without 25% growth
+  bool     m_fullBwReached;     //!< True if the pipe was filled
+
+  // PROBE_BW
+  uint32_t m_cycleIndex;        //!< Phase of the pacing gain cycle
+  Time     m_cycleStamp;        //!< Start of the phase
+
+  // PROBE_RTT
+  Time     m_probeRttDoneStamp; //!< End of PROBE_RTT, zero if not scheduled yet
+  bool     m_probeRttRoundDone; //!< True if a round passed in PROBE_RTT
+
+  // Loss recovery
+  uint32_t m_priorCwnd;         //!< cWnd before the loss or PROBE_RTT
+  bool     m_packetConservation; //!< True in the first round of a recovery
+  TcpSocketState::TcpCongState_t m_prevCongState; //!< Congestion state on the previous ACK
+
+  Ptr<UniformRandomVariable> m_uv; //!< Random phase on PROBE_BW entry
+};
+
+} // namespace ns3
+
+#endif // TCPBBR_H
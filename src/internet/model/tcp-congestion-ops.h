@@ -136,6 +136,62 @@ public:
   {
   }
 
+  /**
+   * \brief Initialize the congestion control on the connection
+   *
+   * The function is called when the connection is established, before any
+   * data is sent. The default implementation does nothing.
+   *
+   * \param tcb internal congestion state
+   */
+  virtual void Init (Ptr<TcpSocketState> tcb)
+  {
+  }
+
+  /**
+   * \brief Control the window and the pacing rate from a rate sample
+   *
+   * This function mimics the function cong_control in Linux. It is called
+   * on every ACK, after the ACK has been processed, with the delivery rate
+   * sample of the ACK; tcb->m_bytesInFlight is up to date. It is optional:
+   * it is only called when HasCongControl returns true, and the default
+   * implementation does nothing.
+   *
+   * \param tcb internal congestion state
+   * \param rs rate sample of the ACK
+   */
+  virtual void CongControl (Ptr<TcpSocketState> tcb, const TcpRateSample &rs)
+  {
+  }
+
+  /**
+   * \brief Tell if the congestion control uses the rate samples
+   *
+   * The socket only runs its delivery rate estimator, which keeps a record
+   * of every sent segment, for a congestion control returning true; the
+   * others never see CongControl called nor tcb->m_delivered updated.
+   *
+   * \return true if CongControl needs the rate samples
+   */
+  virtual bool HasCongControl (void) const
+  {
+    return false;
+  }
+
+  /**
+   * \brief Tell if the congestion control sets the pacing rate
+   *
+   * By default, the socket derives the pacing rate of tcb from cWnd and the
+   * RTT. A congestion control returning true sets tcb->m_pacingRate itself,
+   * e.g. in PktsAcked, and the socket leaves it untouched.
+   *
+   * \return true if the congestion control sets the pacing rate
+   */
+  virtual bool HasPacingRate (void) const
+  {
+    return false;
+  }
+
   // Present in Linux but not in ns-3 yet:
   /* call when cwnd event occurs (optional) */
   // void (*cwnd_event)(struct sock *sk, enum tcp_ca_event ev);
@@ -0,0 +1,202 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "tcp-rate-estimator.h"
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TcpRateEstimator");
+
+TcpRateSample::TcpRateSample ()
+  : m_deliveryRate (0),
+    m_interval (Seconds (0.0)),
+    m_delivered (0),
+    m_priorDelivered (0),
+    m_rtt (Seconds (0.0)),
+    m_ackedSacked (0),
+    m_isAppLimited (false)
+{
+}
+
+TcpRateEstimator::TcpRateEstimator ()
+  : m_delivered (0),
+    m_deliveredTime (Seconds (0.0)),
+    m_firstSentTime (Seconds (0.0)),
+    m_appLimited (0),
+    m_minRtt (Time::Max ())
+{
+}
+
+void
+TcpRateEstimator::OnSent (const SequenceNumber32 &seq, uint32_t size,
+                          bool isRetransmission, uint32_t unAcked)
+{
+  NS_LOG_FUNCTION (this << seq << size << isRetransmission << unAcked);
+
+  Time now = Simulator::Now ();
+
+  // Nothing in flight: the sampling interval restarts with this segment
+  if (unAcked == 0)
+    {
+      m_firstSentTime = now;
+      m_deliveredTime = now;
+    }
+
+  TxRecord &record = m_records[seq];
+  record.m_size = size;
+  record.m_delivered = m_delivered;
+  record.m_deliveredTime = m_deliveredTime;
+  record.m_firstSentTime = m_firstSentTime;
+  record.m_sentTime = now;
+  record.m_retx = isRetransmission;
+  record.m_isAppLimited = (m_appLimited != 0);
+  record.m_sacked = false;
+}
+
+void
+TcpRateEstimator::OnAppLimited (uint32_t bytesInFlight)
+{
+  NS_LOG_FUNCTION (this << bytesInFlight);
+
+  // Never 0, which means not application limited
+  m_appLimited = std::max<uint64_t> (m_delivered + bytesInFlight, 1);
+}
+
+TcpRateSample
+TcpRateEstimator::OnAck (const SequenceNumber32 &ackNumber, const TcpOptionSack::SackList &sackList,
+                         const TcpScoreboard &scoreboard)
+{
+  NS_LOG_FUNCTION (this << ackNumber << sackList.size ());
+
+  TcpRateSample rs;
+  Time now = Simulator::Now ();
+  bool found = false;
+  TxRecord sampled;
+
+  // The sample is taken from the most recently sent segment among the
+  // delivered ones. The segments below the ACK are delivered, unless
+  // already SACKed
+  std::map<SequenceNumber32, TxRecord>::iterator it = m_records.begin ();
+  while (it != m_records.end () && it->first + it->second.m_size <= ackNumber)
+    {
+      if (!it->second.m_sacked)
+        {
+          Deliver (it->second, rs, sampled, found);
+        }
+      m_records.erase (it++);
+    }
+
+  // The segments beyond the ACK can only be delivered by the blocks of this
+  // ACK, possibly merged with older ones: only the segments overlapping a
+  // block are checked
+  for (TcpOptionSack::SackList::const_iterator block = sackList.begin ();
+       block != sackList.end (); ++block)
+    {
+      it = m_records.lower_bound (block->first);
+      if (it != m_records.begin ())
+        {
+          std::map<SequenceNumber32, TxRecord>::iterator prev = it;
+          --prev;
+          if (prev->first + prev->second.m_size > block->first)
+            {
+              it = prev;
+            }
+        }
+      for (; it != m_records.end () && it->first < block->second; ++it)
+        {
+          TxRecord &record = it->second;
+          if (!record.m_sacked && scoreboard.IsSacked (it->first, it->first + record.m_size))
+            {
+              Deliver (record, rs, sampled, found);
+            }
+        }
+    }
+
+  if (rs.m_ackedSacked == 0)
+    {
+      return rs;
+    }
+
+  m_delivered += rs.m_ackedSacked;
+  m_deliveredTime = now;
+  if (m_appLimited != 0 && m_delivered > m_appLimited)
+    {
+      m_appLimited = 0;
+    }
+
+  m_firstSentTime = sampled.m_sentTime;
+  rs.m_priorDelivered = sampled.m_delivered;
+  rs.m_delivered = m_delivered - sampled.m_delivered;
+  rs.m_isAppLimited = sampled.m_isAppLimited;
+
+  if (!sampled.m_retx)
+    {
+      rs.m_rtt = now - sampled.m_sentTime;
+      m_minRtt = std::min (m_minRtt, rs.m_rtt);
+    }
+
+  // The longer of the send and the ACK phases, so that ACK compression does
+  // not inflate the rate
+  Time sendElapsed = sampled.m_sentTime - sampled.m_firstSentTime;
+  Time ackElapsed = now - sampled.m_deliveredTime;
+  Time interval = std::max (sendElapsed, ackElapsed);
+
+  // Shorter than a round trip: the segment was retransmitted, and the ACK is
+  // for an earlier transmission
+  if (interval < m_minRtt || !interval.IsStrictlyPositive ())
+    {
+      NS_LOG_DEBUG ("Invalid rate sample, interval " << interval.GetSeconds () << " s");
+      return rs;
+    }
+
+  rs.m_interval = interval;
+  rs.m_deliveryRate = DataRate (static_cast<uint64_t> (rs.m_delivered * 8
+                                                       / interval.GetSeconds ()));
+
+  NS_LOG_DEBUG ("Rate sample: delivered " << rs.m_delivered << " bytes in " <<
+                interval.GetSeconds () << " s, rate " << rs.m_deliveryRate <<
+                (rs.m_isAppLimited ? " (app limited)" : ""));
+  return rs;
+}
+
+void
+TcpRateEstimator::Deliver (TxRecord &record, TcpRateSample &rs, TxRecord &sampled, bool &found)
+{
+  rs.m_ackedSacked += record.m_size;
+  if (!found || record.m_sentTime >= sampled.m_sentTime)
+    {
+      sampled = record;
+      found = true;
+    }
+  record.m_sacked = true;
+}
+
+uint64_t
+TcpRateEstimator::GetDelivered (void) const
+{
+  return m_delivered;
+}
+
+bool
+TcpRateEstimator::IsAppLimited (void) const
+{
+  return m_appLimited != 0;
+}
+
+} // namespace ns3
@@ -0,0 +1,164 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef TCP_RATE_ESTIMATOR_H
+#define TCP_RATE_ESTIMATOR_H
+
+#include <map>
+#include "ns3/nstime.h"
+#include "ns3/data-rate.h"
+#include "ns3/sequence-number.h"
+#include "tcp-scoreboard.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup tcp
+ *
+ * \brief Delivery rate sample computed on the reception of an ACK
+ *
+ * The sample measures the data delivered to the receiver between the
+ * transmission of the most recently sent segment delivered by the ACK
+ * and the ACK itself. The interval is the longer of the send and of the ACK
+ * phases, so that the rate is not overestimated by ACK compression.
+ * A null m_interval, and a null m_deliveryRate, mark an invalid sample.
+ */
+class TcpRateSample
+{
+public:
+  TcpRateSample ();
+
+  DataRate m_deliveryRate;    //!< Delivery rate of the sample, 0 if invalid
+  Time     m_interval;        //!< Length of the sampling interval, 0 if invalid
+  uint32_t m_delivered;       //!< Bytes delivered over the interval
+  uint64_t m_priorDelivered;  //!< Bytes delivered when the sampled segment was sent
+  Time     m_rtt;             //!< RTT of the sampled segment, zero if retransmitted
+  uint32_t m_ackedSacked;     //!< Bytes newly acknowledged or SACKed by the ACK
+  bool     m_isAppLimited;    //!< True if the sampled segment was sent while application limited
+
+  /**
+   * TracedCallback signature for rate samples.
+   *
+   * \param [in] sample The rate sample.
+   */
+  typedef void (* TracedCallback)(const TcpRateSample &sample);
+};
+
+/**
+ * \ingroup tcp
+ *
+ * \brief Delivery rate estimator of a TCP sender
+ *
+ * The estimator tags every transmitted segment with the delivery state of
+ * the connection: the bytes delivered so far, the time of the last
+ * delivery and the send time of the segment starting the current interval.
+ * When an ACK acknowledges or SACKs segments, the tags of the most
+ * recently sent one give the bytes delivered and the time elapsed since
+ * it was sent, hence a rate sample (draft-cheng-iccrg-delivery-rate-estimation).
+ *
+ * Each segment is delivered once: a SACKed segment is not counted again
+ * when it is cumulatively acknowledged.
+ *
+ * A sender is application limited when it has less than a segment to send
+ * and room in the window. The segments sent until the data in flight at
+ * that time is delivered carry the flag, since the rate they measure says
+ * nothing about the path.
+ */
+class TcpRateEstimator
+{
+public:
+  TcpRateEstimator ();
+
+  /**
+   * \brief Tag a segment being sent
+   * \param seq the first sequence number of the segment
+   * \param size the size of the segment
+   * \param isRetransmission true if the segment is a retransmission
+   * \param unAcked bytes sent and not acknowledged before this segment
+   */
+  void OnSent (const SequenceNumber32 &seq, uint32_t size, bool isRetransmission,
+               uint32_t unAcked);
+
+  /**
+   * \brief Mark the sender as application limited
+   * \param bytesInFlight bytes in flight
+   */
+  void OnAppLimited (uint32_t bytesInFlight);
+
+  /**
+   * \brief Compute the rate sample of an ACK
+   *
+   * The scoreboard must already hold the SACK blocks of the ACK. Only the
+   * segments below the ACK number or overlapping a block of the ACK are
+   * visited, since no other segment can have been newly delivered.
+   *
+   * \param ackNumber the ACK number
+   * \param sackList the SACK blocks of the ACK, empty if none
+   * \param scoreboard the SACK scoreboard of the sender
+   * \returns the rate sample
+   */
+  TcpRateSample OnAck (const SequenceNumber32 &ackNumber, const TcpOptionSack::SackList &sackList,
+                       const TcpScoreboard &scoreboard);
+
+  /**
+   * \brief Get the total bytes delivered
+   * \returns the bytes acknowledged or SACKed since the start of the connection
+   */
+  uint64_t GetDelivered (void) const;
+
+  /**
+   * \brief Check if the sender is application limited
+   * \returns true until the data in flight when it was last marked is delivered
+   */
+  bool IsAppLimited (void) const;
+
+private:
+  /**
+   * \brief Delivery state of the connection when a segment was sent
+   */
+  struct TxRecord
+  {
+    uint32_t m_size;           //!< Size of the segment
+    uint64_t m_delivered;      //!< Bytes delivered when the segment was sent
+    Time     m_deliveredTime;  //!< Time of the last delivery when the segment was sent
+    Time     m_firstSentTime;  //!< Send time of the segment starting the interval
+    Time     m_sentTime;       //!< Time the segment was (last) sent
+    bool     m_retx;           //!< True if the segment was retransmitted
+    bool     m_isAppLimited;   //!< True if sent while application limited
+    bool     m_sacked;         //!< True if already delivered by a SACK
+  };
+
+  /**
+   * \brief Count a segment as delivered by an ACK
+   * \param record the tag of the segment
+   * \param rs the sample of the ACK
+   * \param sampled the tag of the most recently sent segment delivered so far
+   * \param found true if a segment was delivered before
+   */
+  void Deliver (TxRecord &record, TcpRateSample &rs, TxRecord &sampled, bool &found);
+
+  std::map<SequenceNumber32, TxRecord> m_records; //!< Tags of the unacknowledged segments
+  uint64_t m_delivered;      //!< Total bytes delivered
+  Time     m_deliveredTime;  //!< Time of the last delivery
+  Time     m_firstSentTime;  //!< Send time of the segment starting the current interval
+  uint64_t m_appLimited;     //!< Delivered bytes ending the application limited phase, 0 if none
+  Time     m_minRtt;         //!< Lowest RTT sampled
+};
+
+} // namespace ns3
+
+#endif /* TCP_RATE_ESTIMATOR_H */
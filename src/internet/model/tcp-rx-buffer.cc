@@ -23,6 +23,8 @@
 #include "ns3/log.h"
 #include "tcp-rx-buffer.h"
 
+#include <algorithm>
+
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("TcpRxBuffer");
@@ -217,9 +219,62 @@ TcpRxBuffer::Add (Ptr<Packet> p, TcpHeader const& tcph)
     { // Account for the FIN packet
       ++m_nextRxSeq;
     };
+  if (headSeq > m_nextRxSeq)
+    { // Out of order data, to report in the SACK blocks
+      UpdateSackList (headSeq, tailSeq);
+    }
+  ClearSackList ();
   return true;
 }
 
+void
+TcpRxBuffer::UpdateSackList (const SequenceNumber32 &head, const SequenceNumber32 &tail)
+{
+  NS_LOG_FUNCTION (this << head << tail);
+  TcpOptionSack::SackBlock current (head, tail);
+
+  // merge the blocks touching the new data
+  TcpOptionSack::SackList::iterator it = m_sackList.begin ();
+  while (it != m_sackList.end ())
+    {
+      if (it->first <= current.second && current.first <= it->second)
+        {
+          current.first = std::min (current.first, it->first);
+          current.second = std::max (current.second, it->second);
+          it = m_sackList.erase (it);
+        }
+      else
+        {
+          ++it;
+        }
+    }
+  m_sackList.push_front (current);
+}
+
+void
+TcpRxBuffer::ClearSackList (void)
+{
+  NS_LOG_FUNCTION (this);
+  TcpOptionSack::SackList::iterator it = m_sackList.begin ();
+  while (it != m_sackList.end ())
+    {
+      if (it->second <= m_nextRxSeq)
+        {
+          it = m_sackList.erase (it);
+        }
+      else
+        {
+          ++it;
+        }
+    }
+}
+
+const TcpOptionSack::SackList&
+TcpRxBuffer::GetSackList (void) const
+{
+  return m_sackList;
+}
+
 Ptr<Packet>
 TcpRxBuffer::Extract (uint32_t maxSize)
 {
@@ -27,6 +27,7 @@
 #include "ns3/sequence-number.h"
 #include "ns3/ptr.h"
 #include "ns3/tcp-header.h"
+#include "ns3/tcp-option-sack.h"
 
 namespace ns3 {
 class Packet;
@@ -125,7 +126,35 @@ public:
    */
   Ptr<Packet> Extract (uint32_t maxSize);
 
+  /**
+   * \brief Get the blocks of data received beyond NextRxSequence
+   *
+   * The first block is the one holding the most recently received
+   * segment, as required by \RFC{2018}; the others follow in the order
+   * they were last updated.
+   *
+   * \returns the SACK blocks
+   */
+  const TcpOptionSack::SackList& GetSackList (void) const;
+
 private:
+  /**
+   * \brief Record a segment received beyond NextRxSequence in the SACK blocks
+   *
+   * The segment is merged with the blocks it touches, and the resulting
+   * block goes to the front of the list.
+   *
+   * \param head the sequence number of the first byte of the segment
+   * \param tail the sequence number following the last byte of the segment
+   */
+  void UpdateSackList (const SequenceNumber32 &head, const SequenceNumber32 &tail);
+
+  /**
+   * \brief Remove the SACK blocks below NextRxSequence
+   */
+  void ClearSackList (void);
+
+
   /// container for data stored in the buffer
   typedef std::map<SequenceNumber32, Ptr<Packet> >::iterator BufIterator;
   TracedValue<SequenceNumber32> m_nextRxSeq; //!< Seqnum of the first missing byte in data (RCV.NXT)
@@ -135,6 +164,7 @@ private:
   uint32_t m_maxBuffer;                      //!< Upper bound of the number of data bytes in buffer (RCV.WND)
   uint32_t m_availBytes;                     //!< Number of bytes available to read, i.e. contiguous block at head
   std::map<SequenceNumber32, Ptr<Packet> > m_data; //!< Corresponding data (may be null)
+  TcpOptionSack::SackList m_sackList;        //!< Blocks of data received beyond m_nextRxSeq
 };
 
 } //namepsace ns3
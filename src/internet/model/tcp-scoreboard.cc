@@ -0,0 +1,291 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "tcp-scoreboard.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TcpScoreboard");
+
+TcpScoreboard::TcpScoreboard ()
+  : m_sackedBytes (0),
+    m_retransmittedBytes (0)
+{
+}
+
+uint32_t
+TcpScoreboard::AddRange (RangeSet &ranges, SequenceNumber32 start, SequenceNumber32 end)
+{
+  if (end <= start)
+    {
+      return 0;
+    }
+  uint32_t merged = 0;
+  RangeSet::iterator it = ranges.upper_bound (start);
+  if (it != ranges.begin ())
+    {
+      RangeSet::iterator prev = it;
+      --prev;
+      if (prev->second >= start)
+        { // the previous range touches the new one
+          start = prev->first;
+          end = std::max (end, prev->second);
+          merged += prev->second - prev->first;
+          ranges.erase (prev);
+        }
+    }
+  while (it != ranges.end () && it->first <= end)
+    { // the next ranges touch the new one
+      end = std::max (end, it->second);
+      merged += it->second - it->first;
+      ranges.erase (it++);
+    }
+  ranges[start] = end;
+  return (end - start) - merged;
+}
+
+uint32_t
+TcpScoreboard::RemoveRange (RangeSet &ranges, SequenceNumber32 start, SequenceNumber32 end)
+{
+  if (end <= start)
+    {
+      return 0;
+    }
+  uint32_t removed = 0;
+  RangeSet::iterator it = ranges.upper_bound (start);
+  if (it != ranges.begin ())
+    {
+      RangeSet::iterator prev = it;
+      --prev;
+      if (prev->second > start)
+        { // the previous range overlaps the removed one: keep its head
+          SequenceNumber32 prevEnd = prev->second;
+          prev->second = start;
+          if (prevEnd > end)
+            { // and its tail
+              ranges[end] = prevEnd;
+              return end - start;
+            }
+          removed += prevEnd - start;
+        }
+    }
+  while (it != ranges.end () && it->first < end)
+    {
+      if (it->second > end)
+        { // keep the tail of the last range
+          removed += end - it->first;
+          ranges[end] = it->second;
+          ranges.erase (it);
+          break;
+        }
+      removed += it->second - it->first;
+      ranges.erase (it++);
+    }
+  return removed;
+}
+
+uint32_t
+TcpScoreboard::Update (const TcpOptionSack::SackList &list, const SequenceNumber32 &head,
+                       const SequenceNumber32 &highTxMark)
+{
+  NS_LOG_FUNCTION (this << head << highTxMark);
+  uint32_t newlySacked = 0;
+  for (TcpOptionSack::SackList::const_iterator it = list.begin (); it != list.end (); ++it)
+    {
+      SequenceNumber32 start = std::max (it->first, head);
+      SequenceNumber32 end = std::min (it->second, highTxMark);
+      if (end <= start)
+        {
+          NS_LOG_LOGIC ("Ignoring block [" << it->first << ";" << it->second << "]");
+          continue;
+        }
+      uint32_t added = AddRange (m_sacked, start, end);
+      m_sackedBytes += added;
+      newlySacked += added;
+      m_retransmittedBytes -= RemoveRange (m_retransmitted, start, end);
+    }
+  NS_LOG_LOGIC ("SACKed " << newlySacked << " new bytes, " << m_sackedBytes << " bytes in " <<
+                m_sacked.size () << " ranges");
+  return newlySacked;
+}
+
+void
+TcpScoreboard::DiscardUpTo (const SequenceNumber32 &seq)
+{
+  NS_LOG_FUNCTION (this << seq);
+  if (!m_sacked.empty ())
+    {
+      m_sackedBytes -= RemoveRange (m_sacked, m_sacked.begin ()->first, seq);
+    }
+  if (!m_retransmitted.empty ())
+    {
+      m_retransmittedBytes -= RemoveRange (m_retransmitted, m_retransmitted.begin ()->first, seq);
+    }
+}
+
+void
+TcpScoreboard::Clear (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_sacked.clear ();
+  m_sackedBytes = 0;
+  m_retransmitted.clear ();
+  m_retransmittedBytes = 0;
+}
+
+bool
+TcpScoreboard::IsSacked (const SequenceNumber32 &seq) const
+{
+  RangeSet::const_iterator it = m_sacked.upper_bound (seq);
+  if (it == m_sacked.begin ())
+    {
+      return false;
+    }
+  --it;
+  return seq < it->second;
+}
+
+bool
+TcpScoreboard::IsSacked (const SequenceNumber32 &start, const SequenceNumber32 &end) const
+{
+  // Touching ranges are merged: the range must lie in a single one
+  RangeSet::const_iterator it = m_sacked.upper_bound (start);
+  if (it == m_sacked.begin ())
+    {
+      return false;
+    }
+  --it;
+  return start < it->second && end <= it->second;
+}
+
+SequenceNumber32
+TcpScoreboard::GetLostBound (const SequenceNumber32 &head, uint32_t dupThresh,
+                             uint32_t segmentSize, uint32_t &sackedAbove) const
+{
+  uint32_t threshold = dupThresh > 0 ? (dupThresh - 1) * segmentSize : 0;
+  uint32_t ranges = 0;
+  sackedAbove = 0;
+  for (RangeSet::const_reverse_iterator it = m_sacked.rbegin (); it != m_sacked.rend (); ++it)
+    {
+      sackedAbove += it->second - it->first;
+      ++ranges;
+      if (sackedAbove > threshold || ranges >= dupThresh)
+        {
+          return std::max (it->first, head);
+        }
+    }
+  sackedAbove = 0;
+  return head;
+}
+
+bool
+TcpScoreboard::IsLost (const SequenceNumber32 &seq, uint32_t dupThresh, uint32_t segmentSize) const
+{
+  if (m_sacked.empty () || IsSacked (seq))
+    {
+      return false;
+    }
+  uint32_t sackedAbove;
+  return seq < GetLostBound (seq, dupThresh, segmentSize, sackedAbove);
+}
+
+bool
+TcpScoreboard::NextLostHole (const SequenceNumber32 &from, uint32_t dupThresh, uint32_t segmentSize,
+                             SequenceNumber32 &seq, uint32_t &length) const
+{
+  NS_LOG_FUNCTION (this << from);
+  if (m_sacked.empty ())
+    {
+      return false;
+    }
+  uint32_t sackedAbove;
+  SequenceNumber32 bound = GetLostBound (from, dupThresh, segmentSize, sackedAbove);
+
+  // skip the SACKed range holding from, if any
+  SequenceNumber32 start = from;
+  RangeSet::const_iterator next = m_sacked.upper_bound (start);
+  if (next != m_sacked.begin ())
+    {
+      RangeSet::const_iterator prev = next;
+      --prev;
+      if (start < prev->second)
+        {
+          start = prev->second;
+        }
+    }
+  if (start >= bound)
+    {
+      return false;
+    }
+  // the bound is the start of a SACKed range, so the hole ends below it
+  SequenceNumber32 end = (next != m_sacked.end ()) ? std::min (next->first, bound) : bound;
+  seq = start;
+  length = end - start;
+  NS_LOG_LOGIC ("Lost hole [" << seq << ";" << end << "], lost bound " << bound);
+  return true;
+}
+
+void
+TcpScoreboard::MarkRetransmitted (const SequenceNumber32 &seq, uint32_t size)
+{
+  NS_LOG_FUNCTION (this << seq << size);
+  m_retransmittedBytes += AddRange (m_retransmitted, seq, seq + size);
+}
+
+uint32_t
+TcpScoreboard::GetSackedBytes (void) const
+{
+  return m_sackedBytes;
+}
+
+uint32_t
+TcpScoreboard::GetLostBytes (const SequenceNumber32 &head, uint32_t dupThresh, uint32_t segmentSize) const
+{
+  uint32_t sackedAbove;
+  SequenceNumber32 bound = GetLostBound (head, dupThresh, segmentSize, sackedAbove);
+  if (bound <= head)
+    {
+      return 0;
+    }
+  // the bytes below the bound that are not SACKed
+  return (bound - head) - (m_sackedBytes - sackedAbove);
+}
+
+uint32_t
+TcpScoreboard::GetRetransmittedBytes (void) const
+{
+  return m_retransmittedBytes;
+}
+
+uint32_t
+TcpScoreboard::GetPipe (const SequenceNumber32 &head, const SequenceNumber32 &next,
+                        uint32_t dupThresh, uint32_t segmentSize) const
+{
+  if (next <= head)
+    {
+      return m_retransmittedBytes;
+    }
+  uint32_t flightSize = next - head;
+  uint32_t notInFlight = m_sackedBytes + GetLostBytes (head, dupThresh, segmentSize);
+  uint32_t pipe = flightSize > notInFlight ? flightSize - notInFlight : 0;
+  return pipe + m_retransmittedBytes;
+}
+
+} // namespace ns3
@@ -0,0 +1,202 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef TCP_SCOREBOARD_H
+#define TCP_SCOREBOARD_H
+
+#include <map>
+#include "ns3/sequence-number.h"
+#include "ns3/tcp-option-sack.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup tcp
+ *
+ * \brief The SACK scoreboard of a TCP sender, as in \RFC{6675}
+ *
+ * The scoreboard keeps the ranges of sequence numbers the receiver
+ * reported with SACK options, and the ranges retransmitted during the
+ * current loss recovery that are neither acknowledged nor SACKed yet.
+ * Both are kept as sets of disjoint ranges, ordered by their first
+ * sequence number, so that a SACK block or an acknowledgment updates them
+ * in logarithmic time in the number of ranges.
+ *
+ * A sequence number is deemed lost (IsLost() of \RFC{6675}) when more
+ * than (DupThresh - 1) * SMSS bytes, or DupThresh discontiguous ranges,
+ * above it have been SACKed. Since the bytes SACKed above a sequence number
+ * only grow when the sequence number decreases, the lost sequence numbers
+ * are all the unSACKed ones below a bound, found by walking at most
+ * DupThresh ranges from the highest one.
+ */
+class TcpScoreboard
+{
+public:
+  TcpScoreboard ();
+
+  /**
+   * \brief Record the blocks of a SACK option
+   *
+   * The parts of the blocks outside [head, highTxMark) are ignored.
+   *
+   * \param list the blocks of the option
+   * \param head the first unacknowledged sequence number (SND.UNA)
+   * \param highTxMark the highest sequence number sent + 1
+   * \returns the number of bytes newly SACKed
+   */
+  uint32_t Update (const TcpOptionSack::SackList &list, const SequenceNumber32 &head,
+                   const SequenceNumber32 &highTxMark);
+
+  /**
+   * \brief Forget the ranges below a newly acknowledged sequence number
+   * \param seq the first unacknowledged sequence number (SND.UNA)
+   */
+  void DiscardUpTo (const SequenceNumber32 &seq);
+
+  /**
+   * \brief Forget all the SACKed and retransmitted ranges
+   */
+  void Clear (void);
+
+  /**
+   * \brief Check if a sequence number has been SACKed
+   * \param seq the sequence number
+   * \returns true if seq is in a SACKed range
+   */
+  bool IsSacked (const SequenceNumber32 &seq) const;
+
+  /**
+   * \brief Check if a range of sequence numbers has been SACKed
+   * \param start the first sequence number of the range
+   * \param end the sequence number following the range
+   * \returns true if the whole range is in a SACKed range
+   */
+  bool IsSacked (const SequenceNumber32 &start, const SequenceNumber32 &end) const;
+
+  /**
+   * \brief Check if a sequence number is deemed lost (IsLost() of \RFC{6675})
+   * \param seq the sequence number
+   * \param dupThresh the duplicate ACK threshold
+   * \param segmentSize the sender maximum segment size
+   * \returns true if seq is not SACKed and enough data above it is
+   */
+  bool IsLost (const SequenceNumber32 &seq, uint32_t dupThresh, uint32_t segmentSize) const;
+
+  /**
+   * \brief Find the first lost hole at or after a sequence number
+   *
+   * This is the rule (1) of NextSeg() of \RFC{6675}.
+   *
+   * \param from the first sequence number to consider
+   * \param dupThresh the duplicate ACK threshold
+   * \param segmentSize the sender maximum segment size
+   * \param [out] seq the first sequence number of the hole
+   * \param [out] length the number of bytes of the hole
+   * \returns true if a lost hole was found
+   */
+  bool NextLostHole (const SequenceNumber32 &from, uint32_t dupThresh, uint32_t segmentSize,
+                     SequenceNumber32 &seq, uint32_t &length) const;
+
+  /**
+   * \brief Record a retransmission
+   * \param seq the first sequence number retransmitted
+   * \param size the number of bytes retransmitted
+   */
+  void MarkRetransmitted (const SequenceNumber32 &seq, uint32_t size);
+
+  /**
+   * \brief Get the number of bytes SACKed
+   * \returns the number of bytes in the SACKed ranges
+   */
+  uint32_t GetSackedBytes (void) const;
+
+  /**
+   * \brief Get the number of bytes deemed lost
+   * \param head the first unacknowledged sequence number (SND.UNA)
+   * \param dupThresh the duplicate ACK threshold
+   * \param segmentSize the sender maximum segment size
+   * \returns the number of unSACKed bytes from head that are deemed lost
+   */
+  uint32_t GetLostBytes (const SequenceNumber32 &head, uint32_t dupThresh, uint32_t segmentSize) const;
+
+  /**
+   * \brief Get the number of retransmitted bytes neither acknowledged nor SACKed
+   * \returns the number of retransmitted bytes still in flight
+   */
+  uint32_t GetRetransmittedBytes (void) const;
+
+  /**
+   * \brief Get the number of bytes in flight (SetPipe() of \RFC{6675})
+   *
+   * The pipe counts the bytes sent and neither SACKed nor deemed lost, plus
+   * the retransmitted bytes neither acknowledged nor SACKed.
+   *
+   * \param head the first unacknowledged sequence number (SND.UNA)
+   * \param next the next sequence number to send (SND.NXT)
+   * \param dupThresh the duplicate ACK threshold
+   * \param segmentSize the sender maximum segment size
+   * \returns the estimate of the bytes in flight
+   */
+  uint32_t GetPipe (const SequenceNumber32 &head, const SequenceNumber32 &next,
+                    uint32_t dupThresh, uint32_t segmentSize) const;
+
+private:
+  /// Disjoint ranges [first, second), ordered by their first sequence number
+  typedef std::map<SequenceNumber32, SequenceNumber32> RangeSet;
+
+  /**
+   * \brief Add a range to a set, merging it with the ranges it touches
+   * \param ranges the set
+   * \param start the first sequence number of the range
+   * \param end the sequence number following the range
+   * \returns the number of bytes added to the set
+   */
+  static uint32_t AddRange (RangeSet &ranges, SequenceNumber32 start, SequenceNumber32 end);
+
+  /**
+   * \brief Remove a range from a set, splitting the ranges it overlaps
+   * \param ranges the set
+   * \param start the first sequence number of the range
+   * \param end the sequence number following the range
+   * \returns the number of bytes removed from the set
+   */
+  static uint32_t RemoveRange (RangeSet &ranges, SequenceNumber32 start, SequenceNumber32 end);
+
+  /**
+   * \brief Get the bound of the lost sequence numbers
+   *
+   * The unSACKed sequence numbers below the bound are deemed lost, the
+   * ones above are not.
+   *
+   * \param head the first unacknowledged sequence number (SND.UNA)
+   * \param dupThresh the duplicate ACK threshold
+   * \param segmentSize the sender maximum segment size
+   * \param [out] sackedAbove the number of bytes SACKed above the bound
+   * \returns the bound, or head if no sequence number is deemed lost
+   */
+  SequenceNumber32 GetLostBound (const SequenceNumber32 &head, uint32_t dupThresh,
+                                 uint32_t segmentSize, uint32_t &sackedAbove) const;
+
+  RangeSet m_sacked;               //!< SACKed ranges
+  uint32_t m_sackedBytes;          //!< Number of bytes in m_sacked
+  RangeSet m_retransmitted;        //!< Retransmitted ranges, neither acknowledged nor SACKed
+  uint32_t m_retransmittedBytes;   //!< Number of bytes in m_retransmitted
+};
+
+} // namespace ns3
+
+#endif /* TCP_SCOREBOARD_H */
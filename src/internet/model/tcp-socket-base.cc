@@ -49,6 +49,8 @@
 #include "tcp-header.h"
 #include "tcp-option-winscale.h"
 #include "tcp-option-ts.h"
+#include "tcp-option-sack-permitted.h"
+#include "tcp-option-sack.h"
 #include "rtt-estimator.h"
 #include "tcp-congestion-ops.h"
 
@@ -98,6 +100,30 @@ TcpSocketBase::GetTypeId (void)
                    BooleanValue (true),
                    MakeBooleanAccessor (&TcpSocketBase::m_timestampEnabled),
                    MakeBooleanChecker ())
+    .AddAttribute ("Sack", "Enable or disable SACK option",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&TcpSocketBase::m_sackEnabled),
+                   MakeBooleanChecker ())
+    .AddAttribute ("Pacing", "Enable or disable pacing",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&TcpSocketBase::SetPacing,
+                                        &TcpSocketBase::GetPacing),
+                   MakeBooleanChecker ())
+    .AddAttribute ("MaxPacingRate", "Highest pacing rate",
+                   DataRateValue (DataRate ("4Gb/s")),
+                   MakeDataRateAccessor (&TcpSocketBase::SetMaxPacingRate,
+                                         &TcpSocketBase::GetMaxPacingRate),
+                   MakeDataRateChecker ())
+    .AddAttribute ("PacingSsRatio",
+                   "Pacing rate in slow start, in percent of cWnd / RTT",
+                   UintegerValue (200),
+                   MakeUintegerAccessor (&TcpSocketBase::m_pacingSsRatio),
+                   MakeUintegerChecker<uint16_t> ())
+    .AddAttribute ("PacingCaRatio",
+                   "Pacing rate in congestion avoidance, in percent of cWnd / RTT",
+                   UintegerValue (120),
+                   MakeUintegerAccessor (&TcpSocketBase::m_pacingCaRatio),
+                   MakeUintegerChecker<uint16_t> ())
     .AddAttribute ("MinRto",
                    "Minimum retransmit timeout value",
                    TimeValue (Seconds (1.0)), // RFC 6298 says min RTO=1 sec, but Linux uses 200ms.
@@ -177,6 +203,15 @@ TcpSocketBase::GetTypeId (void)
                      "TCP slow start threshold (bytes)",
                      MakeTraceSourceAccessor (&TcpSocketBase::m_ssThTrace),
                      "ns3::TracedValueCallback::Uint32")
+    .AddTraceSource ("PacingRate",
+                     "The current pacing rate",
+                     MakeTraceSourceAccessor (&TcpSocketBase::m_pacingRateTrace),
+                     "ns3::TracedValueCallback::DataRate")
+    .AddTraceSource ("RateSample",
+                     "Delivery rate sample of an ACK delivering data, with a "
+                     "congestion control using rate samples",
+                     MakeTraceSourceAccessor (&TcpSocketBase::m_rateSampleTrace),
+                     "ns3::TcpRateSample::TracedCallback")
     .AddTraceSource ("Tx",
                      "Send tcp packet to IP protocol",
                      MakeTraceSourceAccessor (&TcpSocketBase::m_txTrace),
@@ -223,6 +258,10 @@ TcpSocketState::GetTypeId (void)
                      "Next sequence number to send (SND.NXT)",
                      MakeTraceSourceAccessor (&TcpSocketState::m_nextTxSequence),
                      "ns3::SequenceNumber32TracedValueCallback")
+    .AddTraceSource ("PacingRate",
+                     "The current pacing rate",
+                     MakeTraceSourceAccessor (&TcpSocketState::m_pacingRate),
+                     "ns3::TracedValueCallback::DataRate")
   ;
   return tid;
 }
@@ -238,7 +277,12 @@ TcpSocketState::TcpSocketState (void)
     m_congState (CA_OPEN),
     m_highTxMark (0),
     // Change m_nextTxSequence for non-zero initial sequence number
-    m_nextTxSequence (0)
+    m_nextTxSequence (0),
+    m_pacing (false),
+    m_maxPacingRate (DataRate ("4Gb/s")),
+    m_pacingRate (DataRate ("4Gb/s")),
+    m_delivered (0),
+    m_bytesInFlight (0)
 {
 }
 
@@ -252,7 +296,12 @@ TcpSocketState::TcpSocketState (const TcpSocketState &other)
     m_lastAckedSeq (other.m_lastAckedSeq),
     m_congState (other.m_congState),
     m_highTxMark (other.m_highTxMark),
-    m_nextTxSequence (other.m_nextTxSequence)
+    m_nextTxSequence (other.m_nextTxSequence),
+    m_pacing (other.m_pacing),
+    m_maxPacingRate (other.m_maxPacingRate),
+    m_pacingRate (other.m_pacingRate),
+    m_delivered (other.m_delivered),
+    m_bytesInFlight (other.m_bytesInFlight)
 {
 }
 
@@ -311,7 +360,12 @@ TcpSocketBase::TcpSocketBase (void)
     m_sndWindShift (0),
     m_timestampEnabled (true),
     m_timestampToEcho (0),
+    m_sackEnabled (false),
+    m_highRxt (0),
     m_sendPendingDataEvent (),
+    m_pacingEvent (),
+    m_pacingSsRatio (200),
+    m_pacingCaRatio (120),
     // Set m_recover to the initial sequence number
     m_recover (0),
     m_retxThresh (3),
@@ -346,6 +400,10 @@ TcpSocketBase::TcpSocketBase (void)
   ok = m_tcb->TraceConnectWithoutContext ("HighestSequence",
                                           MakeCallback (&TcpSocketBase::UpdateHighTxMark, this));
   NS_ASSERT (ok == true);
+
+  ok = m_tcb->TraceConnectWithoutContext ("PacingRate",
+                                          MakeCallback (&TcpSocketBase::UpdatePacingRate, this));
+  NS_ASSERT (ok == true);
 }
 
 TcpSocketBase::TcpSocketBase (const TcpSocketBase& sock)
@@ -389,6 +447,11 @@ TcpSocketBase::TcpSocketBase (const TcpSocketBase& sock)
     m_sndWindShift (sock.m_sndWindShift),
     m_timestampEnabled (sock.m_timestampEnabled),
     m_timestampToEcho (sock.m_timestampToEcho),
+    m_sackEnabled (sock.m_sackEnabled),
+    m_scoreboard (sock.m_scoreboard),
+    m_highRxt (sock.m_highRxt),
+    m_pacingSsRatio (sock.m_pacingSsRatio),
+    m_pacingCaRatio (sock.m_pacingCaRatio),
     m_recover (sock.m_recover),
     m_retxThresh (sock.m_retxThresh),
     m_limitedTx (sock.m_limitedTx),
@@ -440,6 +503,10 @@ TcpSocketBase::TcpSocketBase (const TcpSocketBase& sock)
 
   ok = m_tcb->TraceConnectWithoutContext ("HighestSequence",
                                           MakeCallback (&TcpSocketBase::UpdateHighTxMark, this));
+  NS_ASSERT (ok == true);
+
+  ok = m_tcb->TraceConnectWithoutContext ("PacingRate",
+                                          MakeCallback (&TcpSocketBase::UpdatePacingRate, this));
 }
 
 TcpSocketBase::~TcpSocketBase (void)
@@ -1253,6 +1320,12 @@ TcpSocketBase::DoForwardUp (Ptr<Packet> packet, const Address &fromAddress,
           m_timestampEnabled = false;
         }
 
+      // SACK is used only if both ends sent the SACK-permitted option
+      if (!tcpHeader.HasOption (TcpOption::SACKPERMITTED))
+        {
+          m_sackEnabled = false;
+        }
+
       // Initialize cWnd and ssThresh
       m_tcb->m_cWnd = GetInitialCwnd () * GetSegSize ();
       m_tcb->m_ssThresh = GetInitialSSThresh ();
@@ -1284,6 +1357,12 @@ TcpSocketBase::DoForwardUp (Ptr<Packet> packet, const Address &fromAddress,
             }
         }
 
+      if (m_sackEnabled && tcpHeader.HasOption (TcpOption::SACK))
+        {
+          ProcessOptionSack (tcpHeader.GetOption (TcpOption::SACK),
+                             tcpHeader.GetAckNumber ());
+        }
+
       EstimateRtt (tcpHeader);
       UpdateWindowSize (tcpHeader);
     }
@@ -1463,12 +1542,61 @@ TcpSocketBase::FastRetransmit ()
 
   m_tcb->m_ssThresh = m_congestionControl->GetSsThresh (m_tcb,
                                                         BytesInFlight ());
-  m_tcb->m_cWnd = m_tcb->m_ssThresh + m_dupAckCount * m_tcb->m_segmentSize;
+  if (m_sackEnabled)
+    { // The pipe, not an inflated cWnd, accounts for the SACKed data (RFC 6675)
+      m_tcb->m_cWnd = m_tcb->m_ssThresh;
+      m_highRxt = m_txBuffer->HeadSequence ();
+    }
+  else
+    {
+      m_tcb->m_cWnd = m_tcb->m_ssThresh + m_dupAckCount * m_tcb->m_segmentSize;
+    }
 
   NS_LOG_INFO (m_dupAckCount << " dupack. Enter fast recovery mode." <<
                "Reset cwnd to " << m_tcb->m_cWnd << ", ssthresh to " <<
                m_tcb->m_ssThresh << " at fast recovery seqnum " << m_recover);
   DoRetransmit ();
+
+  if (m_sackEnabled)
+    {
+      SendRecoveryData ();
+    }
+}
+
+void
+TcpSocketBase::SendRecoveryData ()
+{
+  NS_LOG_FUNCTION (this);
+
+  while (m_tcb->m_cWnd >= BytesInFlight () + m_tcb->m_segmentSize)
+    {
+      SequenceNumber32 seq;
+      uint32_t length;
+      SequenceNumber32 from = std::max (m_highRxt, m_txBuffer->HeadSequence ());
+
+      // Rule (1) of NextSeg(): the first lost hole not yet retransmitted
+      if (m_scoreboard.NextLostHole (from, m_retxThresh, m_tcb->m_segmentSize, seq, length)
+          && seq < m_tcb->m_nextTxSequence)
+        {
+          uint32_t sz = SendDataPacket (seq, std::min (length, m_tcb->m_segmentSize), true);
+          m_scoreboard.MarkRetransmitted (seq, sz);
+          m_highRxt = seq + sz;
+          ++m_retransOut;
+          NS_LOG_DEBUG ("SACK recovery, retxing seq " << seq << " size " << sz);
+          continue;
+        }
+
+      // Rule (2) of NextSeg(): new data, if the receiver window allows it
+      uint32_t available = m_txBuffer->SizeFromSequence (m_tcb->m_nextTxSequence);
+      if (available == 0 || UnAckDataCount () + m_tcb->m_segmentSize > m_rWnd)
+        {
+          break;
+        }
+
+      uint32_t sz = SendDataPacket (m_tcb->m_nextTxSequence, m_tcb->m_segmentSize, true);
+      m_tcb->m_nextTxSequence += sz;
+      NS_LOG_DEBUG ("SACK recovery, new data of size " << sz);
+    }
 }
 
 void
@@ -1491,7 +1619,14 @@ TcpSocketBase::DupAck ()
 
   if (m_tcb->m_congState == TcpSocketState::CA_DISORDER)
     {
-      if ((m_dupAckCount == m_retxThresh) && (m_highRxAckMark >= m_recover))
+      bool lost = (m_dupAckCount == m_retxThresh);
+      if (m_sackEnabled && !lost)
+        { // RFC 6675: enough SACKed data above the head also marks it lost
+          lost = m_scoreboard.IsLost (m_txBuffer->HeadSequence (),
+                                      m_retxThresh, m_tcb->m_segmentSize);
+        }
+
+      if (lost && (m_highRxAckMark >= m_recover))
         {
           // triple duplicate ack triggers fast retransmit (RFC2582 sec.3 bullet #1)
           NS_LOG_DEBUG (TcpSocketState::TcpCongStateName[m_tcb->m_congState] <<
@@ -1504,6 +1639,10 @@ TcpSocketBase::DupAck ()
           LimitedTransmit ();
         }
     }
+  else if (m_tcb->m_congState == TcpSocketState::CA_RECOVERY && m_sackEnabled)
+    { // The SACK blocks of the dupack have already shrunk the pipe
+      SendRecoveryData ();
+    }
   else if (m_tcb->m_congState == TcpSocketState::CA_RECOVERY)
     { // Increase cwnd for every additional dupack (RFC2582, sec.3 bullet #3)
       m_tcb->m_cWnd += m_tcb->m_segmentSize;
@@ -1533,6 +1672,21 @@ TcpSocketBase::ReceivedAck (Ptr<Packet> packet, const TcpHeader& tcpHeader)
 
   m_tcb->m_lastAckedSeq = ackNumber;
 
+  // Sample the delivery rate, if the congestion control uses it; the
+  // scoreboard already holds the SACK blocks
+  bool rateSampling = m_congestionControl->HasCongControl ();
+  TcpRateSample rs;
+  if (rateSampling)
+    {
+      TcpOptionSack::SackList sackList;
+      if (m_sackEnabled && tcpHeader.HasOption (TcpOption::SACK))
+        {
+          sackList = DynamicCast<const TcpOptionSack> (tcpHeader.GetOption (TcpOption::SACK))->GetSackList ();
+        }
+      rs = m_rateEstimator.OnAck (ackNumber, sackList, m_scoreboard);
+      m_tcb->m_delivered = m_rateEstimator.GetDelivered ();
+    }
+
   if (ackNumber == m_txBuffer->HeadSequence ()
       && ackNumber < m_tcb->m_nextTxSequence
       && packet->GetSize () == 0)
@@ -1619,11 +1773,14 @@ TcpSocketBase::ReceivedAck (Ptr<Packet> packet, const TcpHeader& tcpHeader)
                * fast recovery procedure (i.e., if any duplicate ACKs subsequently
                * arrive, execute step 4 of Section 3.2 of [RFC5681]).
                 */
-              m_tcb->m_cWnd = SafeSubtraction (m_tcb->m_cWnd, bytesAcked);
-
-              if (segsAcked >= 1)
+              if (!m_sackEnabled)
                 {
-                  m_tcb->m_cWnd += m_tcb->m_segmentSize;
+                  m_tcb->m_cWnd = SafeSubtraction (m_tcb->m_cWnd, bytesAcked);
+
+                  if (segsAcked >= 1)
+                    {
+                      m_tcb->m_cWnd += m_tcb->m_segmentSize;
+                    }
                 }
 
               callCongestionControl = false; // No congestion control on cWnd show be invoked
@@ -1631,7 +1788,20 @@ TcpSocketBase::ReceivedAck (Ptr<Packet> packet, const TcpHeader& tcpHeader)
               m_retransOut  = SafeSubtraction (m_retransOut, 1);  // at least one retransmission
                                                                   // has reached the other side
               m_txBuffer->DiscardUpTo (ackNumber);  //Bug 1850:  retransmit before newack
-              DoRetransmit (); // Assume the next seq is lost. Retransmit lost packet
+
+              if (m_sackEnabled)
+                { // With SACK, the scoreboard tells which holes are still lost
+                  m_scoreboard.DiscardUpTo (ackNumber);
+                  if (m_highRxt <= ackNumber)
+                    {
+                      DoRetransmit ();
+                    }
+                  SendRecoveryData ();
+                }
+              else
+                {
+                  DoRetransmit (); // Assume the next seq is lost. Retransmit lost packet
+                }
 
               if (m_isFirstPartialAck)
                 {
@@ -1719,6 +1889,18 @@ TcpSocketBase::ReceivedAck (Ptr<Packet> packet, const TcpHeader& tcpHeader)
         }
     }
 
+  // Give the rate sample, with the flight size left by the ACK, to the
+  // congestion control
+  if (rateSampling)
+    {
+      m_tcb->m_bytesInFlight = ComputeBytesInFlight ();
+      m_congestionControl->CongControl (m_tcb, rs);
+      if (rs.m_ackedSacked > 0)
+        {
+          m_rateSampleTrace (rs);
+        }
+    }
+
   // If there is any data piggybacked, store it into m_rxBuffer
   if (packet->GetSize () > 0)
     {
@@ -1769,6 +1951,7 @@ TcpSocketBase::ProcessSynSent (Ptr<Packet> packet, const TcpHeader& tcpHeader)
     { // Bare data, accept it and move to ESTABLISHED state. This is not a normal behaviour. Remove this?
       NS_LOG_DEBUG ("SYN_SENT -> ESTABLISHED");
       m_congestionControl->CongestionStateSet (m_tcb, TcpSocketState::CA_OPEN);
+      m_congestionControl->Init (m_tcb);
       m_state = ESTABLISHED;
       m_connected = true;
       m_retxEvent.Cancel ();
@@ -1792,6 +1975,7 @@ TcpSocketBase::ProcessSynSent (Ptr<Packet> packet, const TcpHeader& tcpHeader)
     { // Handshake completed
       NS_LOG_DEBUG ("SYN_SENT -> ESTABLISHED");
       m_congestionControl->CongestionStateSet (m_tcb, TcpSocketState::CA_OPEN);
+      m_congestionControl->Init (m_tcb);
       m_state = ESTABLISHED;
       m_connected = true;
       m_retxEvent.Cancel ();
@@ -1835,6 +2019,7 @@ TcpSocketBase::ProcessSynRcvd (Ptr<Packet> packet, const TcpHeader& tcpHeader,
       // handshake is completed nicely.
       NS_LOG_DEBUG ("SYN_RCVD -> ESTABLISHED");
       m_congestionControl->CongestionStateSet (m_tcb, TcpSocketState::CA_OPEN);
+      m_congestionControl->Init (m_tcb);
       m_state = ESTABLISHED;
       m_connected = true;
       m_retxEvent.Cancel ();
@@ -2250,6 +2435,11 @@ TcpSocketBase::SendEmptyPacket (uint8_t flags)
           AddOptionWScale (header);
         }
 
+      if (m_sackEnabled)
+        {
+          AddOptionSackPermitted (header);
+        }
+
       if (m_synCount == 0)
         { // No more connection retries, give up
           NS_LOG_LOGIC ("Connection failed.");
@@ -2587,6 +2777,11 @@ TcpSocketBase::SendDataPacket (SequenceNumber32 seq, uint32_t maxSize, bool with
     }
 
   UpdateRttHistory (seq, sz, isRetransmission);
+  if (m_congestionControl->HasCongControl ())
+    {
+      m_rateEstimator.OnSent (seq, sz, isRetransmission,
+                              m_tcb->m_highTxMark.Get () - m_txBuffer->HeadSequence ());
+    }
 
   // Notify the application of the data being sent unless this is a retransmit
   if (seq + sz > m_tcb->m_highTxMark)
@@ -2631,6 +2826,7 @@ bool
 TcpSocketBase::SendPendingData (bool withAck)
 {
   NS_LOG_FUNCTION (this << withAck);
+  CheckAppLimited ();
   if (m_txBuffer->Size () == 0)
     {
       return false;                           // Nothing to send
@@ -2640,6 +2836,15 @@ TcpSocketBase::SendPendingData (bool withAck)
       NS_LOG_INFO ("TcpSocketBase::SendPendingData: No endpoint; m_shutdownSend=" << m_shutdownSend);
       return false; // Is this the right way to handle this condition?
     }
+  if (m_tcb->m_pacing)
+    {
+      if (m_pacingEvent.IsRunning ())
+        {
+          NS_LOG_LOGIC ("Pacing. Wait to send.");
+          return false; // The pacing event sends the next segment
+        }
+      RefreshPacingRate ();
+    }
   uint32_t nPacketsSent = 0;
   while (m_txBuffer->SizeFromSequence (m_tcb->m_nextTxSequence))
     {
@@ -2675,6 +2880,15 @@ TcpSocketBase::SendPendingData (bool withAck)
       uint32_t sz = SendDataPacket (m_tcb->m_nextTxSequence, s, withAck);
       nPacketsSent++;                             // Count sent this loop
       m_tcb->m_nextTxSequence += sz;                     // Advance next tx sequence
+
+      if (m_tcb->m_pacing)
+        {
+          Time gap = m_tcb->m_pacingRate.Get ().CalculateBytesTxTime (sz);
+          NS_LOG_LOGIC ("Pacing. Next segment in " << gap.GetSeconds () << " s");
+          m_pacingEvent = Simulator::Schedule (gap, &TcpSocketBase::SendPendingData,
+                                               this, m_connected);
+          break;
+        }
     }
   if (nPacketsSent > 0)
     {
@@ -2683,6 +2897,59 @@ TcpSocketBase::SendPendingData (bool withAck)
   return (nPacketsSent > 0);
 }
 
+void
+TcpSocketBase::CheckAppLimited ()
+{
+  NS_LOG_FUNCTION (this);
+
+  if (!m_congestionControl->HasCongControl ())
+    {
+      return; // No rate estimator to tell
+    }
+  if (m_txBuffer->SizeFromSequence (m_tcb->m_nextTxSequence) >= m_tcb->m_segmentSize)
+    {
+      return; // A full segment is waiting
+    }
+
+  uint32_t bytesInFlight = ComputeBytesInFlight ();
+  if (bytesInFlight >= m_tcb->m_cWnd)
+    {
+      return; // Limited by the window
+    }
+  if (m_sackEnabled
+      && m_scoreboard.GetLostBytes (m_txBuffer->HeadSequence (), m_retxThresh,
+                                    m_tcb->m_segmentSize) > m_scoreboard.GetRetransmittedBytes ())
+    {
+      return; // Lost data waits for retransmission
+    }
+
+  m_rateEstimator.OnAppLimited (bytesInFlight);
+}
+
+void
+TcpSocketBase::RefreshPacingRate ()
+{
+  NS_LOG_FUNCTION (this);
+
+  if (!m_tcb->m_pacing || m_congestionControl->HasPacingRate ())
+    {
+      return;
+    }
+
+  if (m_lastRtt.Get ().IsZero ())
+    { // No RTT sample yet
+      m_tcb->m_pacingRate = m_tcb->m_maxPacingRate;
+      return;
+    }
+
+  // Faster in slow start, to let the window grow (Linux tcp_update_pacing_rate)
+  uint16_t ratio = (m_tcb->m_cWnd < m_tcb->m_ssThresh / 2) ? m_pacingSsRatio : m_pacingCaRatio;
+  double rate = ratio / 100.0 * m_tcb->m_cWnd.Get () * 8 / m_lastRtt.Get ().GetSeconds ();
+  rate = std::min (rate, static_cast<double> (m_tcb->m_maxPacingRate.GetBitRate ()));
+  rate = std::max (rate, 1.0);
+  m_tcb->m_pacingRate = DataRate (static_cast<uint64_t> (rate));
+}
+
 uint32_t
 TcpSocketBase::UnAckDataCount () const
 {
@@ -2694,6 +2961,23 @@ uint32_t
 TcpSocketBase::BytesInFlight ()
 {
   NS_LOG_FUNCTION (this);
+
+  uint32_t bytesInFlight = ComputeBytesInFlight ();
+
+  // m_bytesInFlight is traced; avoid useless assignments which would fire
+  // fruitlessly the callback
+  if (m_bytesInFlight != bytesInFlight)
+    {
+      m_bytesInFlight = bytesInFlight;
+    }
+  m_tcb->m_bytesInFlight = bytesInFlight;
+
+  return bytesInFlight;
+}
+
+uint32_t
+TcpSocketBase::ComputeBytesInFlight () const
+{
   // Previous (see bug 1783):
   // uint32_t bytesInFlight = m_highTxMark.Get () - m_txBuffer->HeadSequence ();
   // RFC 4898 page 23
@@ -2704,7 +2988,14 @@ TcpSocketBase::BytesInFlight ()
   uint32_t duplicatedSize;
   uint32_t bytesInFlight;
 
-  if (m_retransOut > m_dupAckCount)
+  if (m_sackEnabled)
+    {
+      // RFC 6675: the pipe excludes the SACKed and the lost bytes
+      bytesInFlight = m_scoreboard.GetPipe (m_txBuffer->HeadSequence (),
+                                            m_tcb->m_nextTxSequence,
+                                            m_retxThresh, m_tcb->m_segmentSize);
+    }
+  else if (m_retransOut > m_dupAckCount)
     {
       duplicatedSize = (m_retransOut - m_dupAckCount)*m_tcb->m_segmentSize;
       bytesInFlight = flightSize + duplicatedSize;
@@ -2715,13 +3006,6 @@ TcpSocketBase::BytesInFlight ()
       bytesInFlight = duplicatedSize > flightSize ? 0 : flightSize - duplicatedSize;
     }
 
-  // m_bytesInFlight is traced; avoid useless assignments which would fire
-  // fruitlessly the callback
-  if (m_bytesInFlight != bytesInFlight)
-    {
-      m_bytesInFlight = bytesInFlight;
-    }
-
   return bytesInFlight;
 }
 
@@ -2901,6 +3185,7 @@ TcpSocketBase::NewAck (SequenceNumber32 const& ack, bool resetRTO)
   NS_LOG_LOGIC ("TCP " << this << " NewAck " << ack <<
                 " numberAck " << (ack - m_txBuffer->HeadSequence ())); // Number bytes ack'ed
   m_txBuffer->DiscardUpTo (ack);
+  m_scoreboard.DiscardUpTo (ack);
   if (GetTxAvailable () > 0)
     {
       NotifySend (GetTxAvailable ());
@@ -3061,6 +3346,10 @@ TcpSocketBase::Retransmit ()
   m_tcb->m_nextTxSequence = m_txBuffer->HeadSequence (); // Restart from highest Ack
   m_dupAckCount = 0;
 
+  // The receiver may have discarded the SACKed data (RFC 2018, sec. 8)
+  m_scoreboard.Clear ();
+  m_highRxt = m_txBuffer->HeadSequence ();
+
   NS_LOG_DEBUG ("RTO. Reset cwnd to " <<  m_tcb->m_cWnd << ", ssthresh to " <<
                 m_tcb->m_ssThresh << ", restart from seqnum " << m_tcb->m_nextTxSequence);
   DoRetransmit ();                          // Retransmit the packet
@@ -3110,6 +3399,12 @@ TcpSocketBase::DoRetransmit ()
   uint32_t sz = SendDataPacket (m_txBuffer->HeadSequence (), m_tcb->m_segmentSize, true);
   ++m_retransOut;
 
+  if (m_sackEnabled && m_tcb->m_congState == TcpSocketState::CA_RECOVERY)
+    {
+      m_scoreboard.MarkRetransmitted (m_txBuffer->HeadSequence (), sz);
+      m_highRxt = std::max (m_highRxt, m_txBuffer->HeadSequence () + sz);
+    }
+
   // In case of RTO, advance m_tcb->m_nextTxSequence
   m_tcb->m_nextTxSequence = std::max (m_tcb->m_nextTxSequence.Get (), m_txBuffer->HeadSequence () + sz);
 
@@ -3125,6 +3420,7 @@ TcpSocketBase::CancelAllTimers ()
   m_lastAckEvent.Cancel ();
   m_timewaitEvent.Cancel ();
   m_sendPendingDataEvent.Cancel ();
+  m_pacingEvent.Cancel ();
 }
 
 /* Move TCP to Time_Wait state and schedule a transition to Closed state */
@@ -3307,6 +3603,11 @@ TcpSocketBase::AddOptions (TcpHeader& header)
     {
       AddOptionTimestamp (header);
     }
+
+  if (m_sackEnabled)
+    {
+      AddOptionSack (header);
+    }
 }
 
 void
@@ -3406,6 +3707,66 @@ TcpSocketBase::AddOptionTimestamp (TcpHeader& header)
                option->GetTimestamp () << " echo=" << m_timestampToEcho);
 }
 
+void
+TcpSocketBase::AddOptionSackPermitted (TcpHeader& header)
+{
+  NS_LOG_FUNCTION (this << header);
+  NS_ASSERT (header.GetFlags () & TcpHeader::SYN);
+
+  header.AppendOption (CreateObject<TcpOptionSackPermitted> ());
+  NS_LOG_INFO (m_node->GetId () << " Add option SACK-permitted");
+}
+
+void
+TcpSocketBase::AddOptionSack (TcpHeader& header)
+{
+  NS_LOG_FUNCTION (this << header);
+
+  const TcpOptionSack::SackList &blocks = m_rxBuffer->GetSackList ();
+  if (blocks.empty ())
+    {
+      return;
+    }
+
+  // Each block takes 8 bytes, after the 2 bytes of kind and length
+  uint32_t space = header.GetMaxOptionLength () - header.GetOptionLength ();
+  if (space < 10)
+    {
+      return;
+    }
+  uint32_t maxBlocks = (space - 2) / 8;
+
+  Ptr<TcpOptionSack> option = CreateObject<TcpOptionSack> ();
+  for (TcpOptionSack::SackList::const_iterator it = blocks.begin ();
+       it != blocks.end () && option->GetNumSackBlocks () < maxBlocks; ++it)
+    {
+      option->AddSackBlock (*it);
+    }
+
+  header.AppendOption (option);
+  NS_LOG_INFO (m_node->GetId () << " Add option SACK with " <<
+               option->GetNumSackBlocks () << " blocks");
+}
+
+uint32_t
+TcpSocketBase::ProcessOptionSack (const Ptr<const TcpOption> option,
+                                  const SequenceNumber32 &ackNumber)
+{
+  NS_LOG_FUNCTION (this << option);
+
+  Ptr<const TcpOptionSack> sack = DynamicCast<const TcpOptionSack> (option);
+
+  // The ACK of the segment is processed later: the blocks below it are old
+  SequenceNumber32 head = std::max (ackNumber, m_txBuffer->HeadSequence ());
+  uint32_t newlySacked = m_scoreboard.Update (sack->GetSackList (), head,
+                                              m_tcb->m_highTxMark);
+
+  NS_LOG_INFO (m_node->GetId () << " Got SACK with " <<
+               sack->GetNumSackBlocks () << " blocks, " <<
+               newlySacked << " bytes newly SACKed");
+  return newlySacked;
+}
+
 void TcpSocketBase::UpdateWindowSize (const TcpHeader &header)
 {
   NS_LOG_FUNCTION (this << header);
@@ -3488,6 +3849,36 @@ TcpSocketBase::GetRxBuffer (void) const
   return m_rxBuffer;
 }
 
+void
+TcpSocketBase::SetPacing (bool pacing)
+{
+  NS_LOG_FUNCTION (this << pacing);
+  m_tcb->m_pacing = pacing;
+}
+
+bool
+TcpSocketBase::GetPacing (void) const
+{
+  return m_tcb->m_pacing;
+}
+
+void
+TcpSocketBase::SetMaxPacingRate (DataRate maxPacingRate)
+{
+  NS_LOG_FUNCTION (this << maxPacingRate);
+  m_tcb->m_maxPacingRate = maxPacingRate;
+  if (m_tcb->m_pacingRate.Get () > maxPacingRate)
+    {
+      m_tcb->m_pacingRate = maxPacingRate;
+    }
+}
+
+DataRate
+TcpSocketBase::GetMaxPacingRate (void) const
+{
+  return m_tcb->m_maxPacingRate;
+}
+
 void
 TcpSocketBase::UpdateCwnd (uint32_t oldValue, uint32_t newValue)
 {
@@ -3507,6 +3898,12 @@ TcpSocketBase::UpdateCongState (TcpSocketState::TcpCongState_t oldValue,
   m_congStateTrace (oldValue, newValue);
 }
 
+void
+TcpSocketBase::UpdatePacingRate (DataRate oldValue, DataRate newValue)
+{
+  m_pacingRateTrace (oldValue, newValue);
+}
+
 void
 TcpSocketBase::UpdateNextTxSequence (SequenceNumber32 oldValue,
                                      SequenceNumber32 newValue)
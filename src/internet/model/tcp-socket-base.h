@@ -33,8 +33,11 @@
 #include "ns3/ipv6-header.h"
 #include "ns3/ipv6-interface.h"
 #include "ns3/event-id.h"
+#include "ns3/data-rate.h"
 #include "tcp-tx-buffer.h"
 #include "tcp-rx-buffer.h"
+#include "tcp-scoreboard.h"
+#include "tcp-rate-estimator.h"
 #include "rtt-estimator.h"
 
 namespace ns3 {
@@ -164,6 +167,15 @@ public:
   TracedValue<SequenceNumber32> m_highTxMark; //!< Highest seqno ever sent, regardless of ReTx
   TracedValue<SequenceNumber32> m_nextTxSequence; //!< Next seqnum to be sent (SND.NXT), ReTx pushes it back
 
+  // Pacing
+  bool                   m_pacing;          //!< Pacing enabled
+  DataRate               m_maxPacingRate;   //!< Highest pacing rate
+  TracedValue<DataRate>  m_pacingRate;      //!< Current pacing rate
+
+  // Delivery
+  uint64_t               m_delivered;       //!< Total bytes delivered to the receiver
+  uint32_t               m_bytesInFlight;   //!< Bytes in flight after the last ACK
+
   /**
    * \brief Get cwnd in segments rather than bytes
    *
@@ -265,6 +277,42 @@ public:
  *
  * The algorithm is implemented in the ReceivedAck method.
  *
+ * Selective acknowledgments
+ * --------------------------
+ *
+ * When the attribute "Sack" is true and the other end sends the
+ * SACK-permitted option in its SYN, the receiver reports the out of order
+ * data in SACK options (RFC 2018) and the sender keeps them in a
+ * TcpScoreboard. Loss recovery then follows RFC 6675: the recovery starts
+ * after ReTxThreshold duplicate ACKs or as soon as the scoreboard deems
+ * the first unacknowledged segment lost, cWnd is not inflated, and every
+ * ACK sends, while cWnd allows it according to the pipe estimate, the next
+ * lost hole or new data. Without SACK, the NewReno recovery above is used.
+ *
+ * Pacing
+ * -------
+ *
+ * When the attribute "Pacing" is true, SendPendingData sends one segment
+ * and then waits for the time the segment takes at the pacing rate of
+ * TcpSocketState before sending the next one, instead of sending the whole
+ * window back-to-back. The wait is a single event per socket, rescheduled
+ * after each segment. As in Linux, the pacing rate is PacingSsRatio percent
+ * of cWnd / RTT in slow start and PacingCaRatio percent afterwards, capped
+ * by MaxPacingRate, unless the congestion control sets it itself (see
+ * TcpCongestionOps::HasPacingRate). Until the first RTT sample, the segments
+ * are paced at MaxPacingRate. Retransmissions are not paced.
+ *
+ * Delivery rate
+ * -------------
+ *
+ * When the congestion control uses rate samples (see
+ * TcpCongestionOps::HasCongControl), a TcpRateEstimator tags every sent
+ * segment with the delivery state of the connection, and computes a
+ * TcpRateSample on every ACK from the segments it acknowledges or SACKs.
+ * The sample is given to TcpCongestionOps::CongControl, and fired on the
+ * "RateSample" trace source when the ACK delivered data. The other
+ * congestion controls pay nothing for the estimator.
+ *
  */
 class TcpSocketBase : public TcpSocket
 {
@@ -341,6 +389,30 @@ public:
    */
   Time GetClockGranularity (void) const;
 
+  /**
+   * \brief Enable or disable pacing
+   * \param pacing true to pace the segments sent
+   */
+  void SetPacing (bool pacing);
+
+  /**
+   * \brief Check if pacing is enabled
+   * \return true if the segments sent are paced
+   */
+  bool GetPacing (void) const;
+
+  /**
+   * \brief Set the highest pacing rate
+   * \param maxPacingRate the highest pacing rate
+   */
+  void SetMaxPacingRate (DataRate maxPacingRate);
+
+  /**
+   * \brief Get the highest pacing rate
+   * \return the highest pacing rate
+   */
+  DataRate GetMaxPacingRate (void) const;
+
   /**
    * \brief Get a pointer to the Tx buffer
    * \return a pointer to the tx buffer
@@ -378,6 +450,11 @@ public:
    */
   TracedCallback<SequenceNumber32, SequenceNumber32> m_nextTxSequenceTrace;
 
+  /**
+   * \brief Callback pointer for pacing rate chaining
+   */
+  TracedCallback<DataRate, DataRate> m_pacingRateTrace;
+
   /**
    * \brief Callback function to hook to TcpSocketState congestion window
    * \param oldValue old cWnd value
@@ -414,6 +491,13 @@ public:
    */
   void UpdateNextTxSequence (SequenceNumber32 oldValue, SequenceNumber32 newValue);
 
+  /**
+   * \brief Callback function to hook to TcpSocketState pacing rate
+   * \param oldValue old pacing rate
+   * \param newValue new pacing rate
+   */
+  void UpdatePacingRate (DataRate oldValue, DataRate newValue);
+
   /**
    * \brief Install a congestion control algorithm on this socket
    *
@@ -600,13 +684,22 @@ protected:
   /**
    * \brief Send as much pending data as possible according to the Tx window.
    *
-   * Note that this function did not implement the PSH flag.
+   * Note that this function did not implement the PSH flag. With pacing,
+   * it sends at most one segment and schedules the next call.
    *
    * \param withAck forces an ACK to be sent
    * \returns true if some data have been sent
    */
   bool SendPendingData (bool withAck = false);
 
+  /**
+   * \brief Derive the pacing rate from cWnd and the RTT
+   *
+   * Nothing is done if pacing is disabled or if the congestion control
+   * sets the pacing rate itself.
+   */
+  void RefreshPacingRate (void);
+
   /**
    * \brief Extract at most maxSize bytes from the TxBuffer at sequence seq, add the
    *        TCP header, and send to TcpL4Protocol
@@ -778,6 +871,12 @@ protected:
    */
   virtual uint32_t BytesInFlight (void);
 
+  /**
+   * \brief Compute the bytes in flight without updating the trace
+   * \returns total bytes in flight
+   */
+  uint32_t ComputeBytesInFlight (void) const;
+
   /**
    * \brief Return the max possible number of unacked bytes
    * \returns the max possible number of unacked bytes
@@ -852,6 +951,12 @@ protected:
   virtual void UpdateRttHistory (const SequenceNumber32 &seq, uint32_t sz,
                                  bool isRetransmission);
 
+  /**
+   * \brief Mark the sender as application limited if it has less than a
+   * segment to send and room in the window
+   */
+  void CheckAppLimited (void);
+
   /**
    * \brief Update buffers w.r.t. ACK
    * \param seq the sequence number
@@ -874,6 +979,14 @@ protected:
    */
   void FastRetransmit ();
 
+  /**
+   * \brief Send the lost holes, then new data, while the pipe allows it
+   *
+   * This is the step (C) of the loss recovery of \RFC{6675}, with the
+   * rules (1) and (2) of NextSeg().
+   */
+  void SendRecoveryData ();
+
   /**
    * \brief Call Retransmit() upon RTO event
    */
@@ -963,6 +1076,33 @@ protected:
    */
   void AddOptionTimestamp (TcpHeader& header);
 
+  /**
+   * \brief Add the SACK-permitted option to the header
+   *
+   * \param header TcpHeader of a SYN segment
+   */
+  void AddOptionSackPermitted (TcpHeader& header);
+
+  /**
+   * \brief Add the SACK option to the header, if there is out of order data
+   *
+   * The option holds as many blocks of the Rx buffer as fit in the option
+   * space left in the header.
+   *
+   * \param header TcpHeader to which add the option to
+   */
+  void AddOptionSack (TcpHeader& header);
+
+  /**
+   * \brief Record the blocks of a SACK option in the scoreboard
+   *
+   * \param option SACK option from the segment
+   * \param ackNumber the acknowledgment number of the segment
+   * \returns the number of bytes newly SACKed
+   */
+  uint32_t ProcessOptionSack (const Ptr<const TcpOption> option,
+                              const SequenceNumber32 &ackNumber);
+
   /**
    * \brief Performs a safe subtraction between a and b (a-b)
    *
@@ -997,6 +1137,7 @@ protected:
   Time              m_persistTimeout;  //!< Time between sending 1-byte probes
   Time              m_cnTimeout;       //!< Timeout for connection retry
   RttHistory_t      m_history;         //!< List of sent packet
+  TcpRateEstimator  m_rateEstimator;   //!< Delivery rate estimator
 
   // Connections to other layers of TCP/IP
   Ipv4EndPoint*       m_endPoint;   //!< the IPv4 endpoint
@@ -1039,8 +1180,17 @@ protected:
   bool     m_timestampEnabled;    //!< Timestamp option enabled
   uint32_t m_timestampToEcho;     //!< Timestamp to echo
 
+  bool          m_sackEnabled;   //!< SACK option enabled (RFC 2018)
+  TcpScoreboard m_scoreboard;    //!< SACKed and retransmitted ranges
+  SequenceNumber32 m_highRxt;    //!< Highest sequence number retransmitted in the recovery (RFC 6675)
+
   EventId m_sendPendingDataEvent; //!< micro-delay event to send pending data
 
+  // Pacing
+  EventId  m_pacingEvent;    //!< Event that sends the next paced segment
+  uint16_t m_pacingSsRatio;  //!< Pacing rate in slow start, in percent of cWnd / RTT
+  uint16_t m_pacingCaRatio;  //!< Pacing rate in congestion avoidance, in percent of cWnd / RTT
+
   // Fast Retransmit and Recovery
   SequenceNumber32       m_recover;      //!< Previous highest Tx seqnum for fast recovery
   uint32_t               m_retxThresh;   //!< Fast Retransmit threshold
@@ -1060,6 +1210,8 @@ protected:
 
   TracedCallback<Ptr<const Packet>, const TcpHeader&,
                  Ptr<const TcpSocketBase> > m_rxTrace; //!< Trace of received packets
+
+  TracedCallback<const TcpRateSample &> m_rateSampleTrace; //!< Trace of the delivery rate samples
 };
 
 /**
@@ -57,7 +57,7 @@ TcpTxBuffer::GetTypeId (void)
  * initialized below is insignificant.
  */
 TcpTxBuffer::TcpTxBuffer (uint32_t n)
-  : m_firstByteSeq (n), m_size (0), m_maxBuffer (32768), m_data (0)
+  : m_firstByteSeq (n), m_size (0), m_maxBuffer (32768), m_headOffset (0)
 {
 }
 
@@ -111,7 +111,10 @@ TcpTxBuffer::Add (Ptr<Packet> p)
     {
       if (p->GetSize () > 0)
         {
-          m_data.push_back (p);
+          TxChunk chunk;
+          chunk.m_offset = m_headOffset + m_size;
+          chunk.m_packet = p;
+          m_data.push_back (chunk);
           m_size += p->GetSize ();
           NS_LOG_LOGIC ("Updated size=" << m_size << ", lastSeq=" << m_firstByteSeq + SequenceNumber32 (m_size));
         }
@@ -133,6 +136,30 @@ TcpTxBuffer::SizeFromSequence (const SequenceNumber32& seq) const
   return lastSeq - seq;
 }
 
+TcpTxBuffer::BufIterator
+TcpTxBuffer::FindChunk (uint32_t offset)
+{
+  NS_LOG_FUNCTION (this << offset);
+  NS_ASSERT (offset < m_size);
+  // the last chunk that starts at or before the byte
+  uint64_t target = m_headOffset + offset;
+  uint32_t first = 0;
+  uint32_t last = m_data.size ();
+  while (last - first > 1)
+    {
+      uint32_t middle = first + (last - first) / 2;
+      if (m_data[middle].m_offset <= target)
+        {
+          first = middle;
+        }
+      else
+        {
+          last = middle;
+        }
+    }
+  return m_data.begin () + first;
+}
+
 Ptr<Packet>
 TcpTxBuffer::CopyFromSequence (uint32_t numBytes, const SequenceNumber32& seq)
 {
@@ -149,53 +176,34 @@ TcpTxBuffer::CopyFromSequence (uint32_t numBytes, const SequenceNumber32& seq)
 
   // Extract data from the buffer and return
   uint32_t offset = seq - m_firstByteSeq.Get ();
-  uint32_t count = 0;      // Offset of the first byte of a packet in the buffer
-  uint32_t pktSize = 0;
-  bool beginFound = false;
-  int pktCount = 0;
-  Ptr<Packet> outPacket;
-  NS_LOG_LOGIC ("There are " << m_data.size () << " number of packets in buffer");
-  for (BufIterator i = m_data.begin (); i != m_data.end (); ++i)
+  BufIterator i = FindChunk (offset);
+  uint32_t packetOffset = m_headOffset + offset - i->m_offset;
+  uint32_t fragmentLength = i->m_packet->GetSize () - packetOffset;
+  NS_LOG_LOGIC ("First byte found at offset " << packetOffset << " of a packet of size "
+                                              << i->m_packet->GetSize ());
+  if (fragmentLength >= s)
+    { // Data to be copied falls entirely in this packet
+      return i->m_packet->CreateFragment (packetOffset, s);
+    }
+
+  // This packet only fulfills part of the request
+  Ptr<Packet> outPacket = i->m_packet->CreateFragment (packetOffset, fragmentLength);
+  uint32_t remaining = s - fragmentLength;
+  for (++i; remaining > 0; ++i)
     {
-      pktCount++;
-      pktSize = (*i)->GetSize ();
-      if (!beginFound)
-        { // Look for first fragment
-          if (count + pktSize > offset)
-            {
-              NS_LOG_LOGIC ("First byte found in packet #" << pktCount << " at buffer offset " << count
-                                                           << ", packet len=" << pktSize);
-              beginFound = true;
-              uint32_t packetOffset = offset - count;
-              uint32_t fragmentLength = count + pktSize - offset;
-              if (fragmentLength >= s)
-                { // Data to be copied falls entirely in this packet
-                  return (*i)->CreateFragment (packetOffset, s);
-                }
-              else
-                { // This packet only fulfills part of the request
-                  outPacket = (*i)->CreateFragment (packetOffset, fragmentLength);
-                }
-              NS_LOG_LOGIC ("Output packet is now of size " << outPacket->GetSize ());
-            }
-        }
-      else if (count + pktSize >= offset + s)
+      NS_ASSERT (i != m_data.end ());
+      uint32_t pktSize = i->m_packet->GetSize ();
+      if (pktSize > remaining)
         { // Last packet fragment found
-          NS_LOG_LOGIC ("Last byte found in packet #" << pktCount << " at buffer offset " << count
-                                                      << ", packet len=" << pktSize);
-          uint32_t fragmentLength = offset + s - count;
-          Ptr<Packet> endFragment = (*i)->CreateFragment (0, fragmentLength);
-          outPacket->AddAtEnd (endFragment);
-          NS_LOG_LOGIC ("Output packet is now of size " << outPacket->GetSize ());
-          break;
+          outPacket->AddAtEnd (i->m_packet->CreateFragment (0, remaining));
+          remaining = 0;
         }
       else
         {
-          NS_LOG_LOGIC ("Appending to output the packet #" << pktCount << " of offset " << count << " len=" << pktSize);
-          outPacket->AddAtEnd (*i);
-          NS_LOG_LOGIC ("Output packet is now of size " << outPacket->GetSize ());
+          outPacket->AddAtEnd (i->m_packet);
+          remaining -= pktSize;
         }
-      count += pktSize;
+      NS_LOG_LOGIC ("Output packet is now of size " << outPacket->GetSize ());
     }
   NS_ASSERT (outPacket->GetSize () == s);
   return outPacket;
@@ -217,32 +225,29 @@ TcpTxBuffer::DiscardUpTo (const SequenceNumber32& seq)
   // Cases do not need to scan the buffer
   if (m_firstByteSeq >= seq) return;
 
-  // Scan the buffer and discard packets
-  uint32_t offset = seq - m_firstByteSeq.Get ();  // Number of bytes to remove
-  uint32_t pktSize;
+  // Discard the packets behind the seqnum, up to the end of the data
+  uint32_t offset = std::min<uint32_t> (seq - m_firstByteSeq.Get (), m_size);  // Number of bytes to remove
+  uint64_t target = m_headOffset + offset;
   NS_LOG_LOGIC ("Offset=" << offset);
-  BufIterator i = m_data.begin ();
-  while (i != m_data.end ())
-    {
-      if (offset > (*i)->GetSize ())
-        { // This packet is behind the seqnum. Remove this packet from the buffer
-          pktSize = (*i)->GetSize ();
-          m_size -= pktSize;
-          offset -= pktSize;
-          m_firstByteSeq += pktSize;
-          i = m_data.erase (i);
-          NS_LOG_LOGIC ("Removed one packet of size " << pktSize << ", offset=" << offset);
-        }
-      else if (offset > 0)
-        { // Part of the packet is behind the seqnum. Fragment
-          pktSize = (*i)->GetSize () - offset;
-          *i = (*i)->CreateFragment (offset, pktSize);
-          m_size -= offset;
-          m_firstByteSeq += offset;
-          NS_LOG_LOGIC ("Fragmented one packet by size " << offset << ", new size=" << pktSize);
-          break;
-        }
+  while (!m_data.empty ()
+         && m_data.front ().m_offset + m_data.front ().m_packet->GetSize () <= target)
+    { // This packet is behind the seqnum. Remove this packet from the buffer
+      NS_LOG_LOGIC ("Removed one packet of size " << m_data.front ().m_packet->GetSize ());
+      m_data.pop_front ();
     }
+  if (!m_data.empty () && m_data.front ().m_offset < target)
+    { // Part of the packet is behind the seqnum. Fragment
+      TxChunk& front = m_data.front ();
+      uint32_t behind = target - front.m_offset;
+      uint32_t pktSize = front.m_packet->GetSize () - behind;
+      front.m_packet = front.m_packet->CreateFragment (behind, pktSize);
+      front.m_offset = target;
+      NS_LOG_LOGIC ("Fragmented one packet by size " << behind << ", new size=" << pktSize);
+    }
+  m_size -= offset;
+  m_headOffset = target;
+  m_firstByteSeq += offset;
+
   // Catching the case of ACKing a FIN
   if (m_size == 0)
     {
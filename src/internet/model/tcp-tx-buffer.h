@@ -21,7 +21,7 @@
 #ifndef TCP_TX_BUFFER_H
 #define TCP_TX_BUFFER_H
 
-#include <list>
+#include <deque>
 #include "ns3/traced-value.h"
 #include "ns3/trace-source-accessor.h"
 #include "ns3/object.h"
@@ -36,6 +36,11 @@ class Packet;
  *
  * \brief class for keeping the data sent by the application to the TCP socket, i.e.
  *        the sending buffer.
+ *
+ * The packets written by the application are kept as they are, each with
+ * the offset of its first byte, so that the packet holding a given
+ * sequence number is found by a binary search and the segments are built
+ * as fragments of the buffered packets, without copying their data.
  */
 class TcpTxBuffer : public Object
 {
@@ -128,13 +133,28 @@ public:
   void DiscardUpTo (const SequenceNumber32& seq);
 
 private:
+  /// A packet of the buffer, with the position of its first byte
+  struct TxChunk
+  {
+    uint64_t m_offset;    //!< Offset of the first byte since the creation of the buffer
+    Ptr<Packet> m_packet; //!< The data
+  };
+
   /// container for data stored in the buffer
-  typedef std::list<Ptr<Packet> >::iterator BufIterator;
+  typedef std::deque<TxChunk>::iterator BufIterator;
+
+  /**
+   * Find the packet holding a byte of the buffer
+   * \param offset offset of the byte from the head of the buffer
+   * \returns the chunk of the packet holding that byte
+   */
+  BufIterator FindChunk (uint32_t offset);
 
   TracedValue<SequenceNumber32> m_firstByteSeq; //!< Sequence number of the first byte in data (SND.UNA)
   uint32_t m_size;                              //!< Number of data bytes
   uint32_t m_maxBuffer;                         //!< Max number of data bytes in buffer (SND.WND)
-  std::list<Ptr<Packet> > m_data;               //!< Corresponding data (may be null)
+  uint64_t m_headOffset;                        //!< Offset of the first byte since the creation of the buffer
+  std::deque<TxChunk> m_data;                   //!< Corresponding data, in sequence order
 };
 
 } // namepsace ns3
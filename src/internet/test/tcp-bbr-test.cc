@@ -0,0 +1,297 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/tcp-congestion-ops.h"
+#include "ns3/tcp-socket-base.h"
+#include "ns3/tcp-bbr.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TcpBbrTestSuite");
+
+/**
+ * \brief Give BBR the rate sample of an ACK
+ *
+ * Every call acknowledges the data sent at the start of the previous one,
+ * hence it starts a new round.
+ *
+ * \param bbr the congestion control
+ * \param tcb internal congestion state
+ * \param acked bytes acknowledged
+ * \param rate delivery rate of the sample
+ * \param rtt RTT of the sample
+ * \param inflight bytes in flight after the ACK
+ * \param appLimited true if the sample is application limited
+ */
+static void
+BbrAck (Ptr<TcpBbr> bbr, Ptr<TcpSocketState> tcb, uint32_t acked,
+        DataRate rate, Time rtt, uint32_t inflight, bool appLimited = false)
+{
+  TcpRateSample rs;
+  rs.m_priorDelivered = tcb->m_delivered;
+  tcb->m_delivered += acked;
+  rs.m_delivered = acked;
+  rs.m_ackedSacked = acked;
+  rs.m_interval = rtt;
+  rs.m_deliveryRate = rate;
+  rs.m_rtt = rtt;
+  rs.m_isAppLimited = appLimited;
+  tcb->m_bytesInFlight = inflight;
+  bbr->CongControl (tcb, rs);
+}
+
+/**
+ * \brief Build the congestion state of a connection with 1000 byte segments
+ * \param cWnd congestion window, in bytes
+ * \returns the congestion state
+ */
+static Ptr<TcpSocketState>
+BbrTcb (uint32_t cWnd)
+{
+  Ptr<TcpSocketState> tcb = CreateObject<TcpSocketState> ();
+  tcb->m_segmentSize = 1000;
+  tcb->m_initialCWnd = 10;
+  tcb->m_cWnd = cWnd;
+  tcb->m_ssThresh = UINT32_MAX;
+  return tcb;
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check STARTUP, DRAIN and the entry in PROBE_BW
+ *
+ * With a constant delivery rate, the pipe is full after 3 rounds without
+ * growth; DRAIN paces below the bandwidth until the flight size is down to
+ * the bandwidth-delay product, then PROBE_BW paces around the bandwidth.
+ */
+class TcpBbrStartupTest : public TestCase
+{
+public:
+  TcpBbrStartupTest ();
+
+private:
+  virtual void DoRun (void);
+};
+
+TcpBbrStartupTest::TcpBbrStartupTest ()
+  : TestCase ("BBR STARTUP, DRAIN and PROBE_BW")
+{
+}
+
+void
+TcpBbrStartupTest::DoRun ()
+{
+  Ptr<TcpSocketState> tcb = BbrTcb (10000);
+  Ptr<TcpBbr> bbr = CreateObject<TcpBbr> ();
+  DataRate bw ("10Mbps");
+  Time rtt = MilliSeconds (100);
+  uint32_t bdp = 125000;
+
+  bbr->Init (tcb);
+  NS_TEST_ASSERT_MSG_EQ (tcb->m_pacing, true, "pacing not enabled");
+  NS_TEST_ASSERT_MSG_EQ (bbr->GetMode (), TcpBbr::BBR_STARTUP, "not in STARTUP");
+  NS_TEST_ASSERT_MSG_EQ_TOL (static_cast<double> (tcb->m_pacingRate.Get ().GetBitRate ()),
+                             2.885 * 10000 * 8 / 0.001, 1000, "initial pacing rate");
+
+  BbrAck (bbr, tcb, 1000, bw, rtt, 9000);
+  NS_TEST_ASSERT_MSG_EQ (bbr->GetBw (), bw, "bandwidth not sampled");
+  NS_TEST_ASSERT_MSG_EQ (bbr->GetMinRtt (), rtt, "min RTT not sampled");
+  NS_TEST_ASSERT_MSG_EQ_TOL (static_cast<double> (tcb->m_pacingRate.Get ().GetBitRate ()),
+                             2.885 * bw.GetBitRate (), 1000, "pacing rate of STARTUP");
+  NS_TEST_ASSERT_MSG_EQ (tcb->m_cWnd.Get (), 11000, "cWnd not grown by the acked bytes");
+
+  BbrAck (bbr, tcb, 1000, bw, rtt, 9000);
+  BbrAck (bbr, tcb, 1000, bw, rtt, 9000);
+  NS_TEST_ASSERT_MSG_EQ (bbr->GetMode (), TcpBbr::BBR_STARTUP, "STARTUP left too early");
+
+  // Third round without growth, with a standing queue
+  BbrAck (bbr, tcb, 1000, bw, rtt, 3 * bdp);
+  NS_TEST_ASSERT_MSG_EQ (bbr->GetMode (), TcpBbr::BBR_DRAIN, "not in DRAIN");
+  NS_TEST_ASSERT_MSG_EQ_TOL (static_cast<double> (tcb->m_pacingRate.Get ().GetBitRate ()),
+                             bw.GetBitRate () / 2.885, 1000, "pacing rate of DRAIN");
+
+  BbrAck (bbr, tcb, 1000, bw, rtt, bdp);
+  NS_TEST_ASSERT_MSG_EQ (bbr->GetMode (), TcpBbr::BBR_PROBE_BW, "not in PROBE_BW");
+  uint64_t rate = tcb->m_pacingRate.Get ().GetBitRate ();
+  NS_TEST_ASSERT_MSG_EQ ((rate == bw.GetBitRate () || rate == bw.GetBitRate () * 5 / 4), true,
+                         "PROBE_BW entered in the draining phase");
+
+  // cWnd converges to twice the BDP, plus 3 segments
+  for (uint32_t i = 0; i < 300; ++i)
+    {
+      BbrAck (bbr, tcb, 1000, bw, rtt, bdp);
+    }
+  NS_TEST_ASSERT_MSG_EQ (tcb->m_cWnd.Get (), 2 * bdp + 3000, "cWnd not capped at 2 BDP");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check the PROBE_RTT mode
+ *
+ * Without a lower RTT for MinRttWindow, cWnd is cut to 4 segments for
+ * ProbeRttDuration and a round, then restored.
+ */
+class TcpBbrProbeRttTest : public TestCase
+{
+public:
+  TcpBbrProbeRttTest ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \brief ACK of a segment with a RTT of 150 ms
+   * \param inflight bytes in flight after the ACK
+   */
+  void Ack (uint32_t inflight);
+
+  /**
+   * \brief Check the mode and cWnd
+   * \param mode expected mode
+   * \param cWnd expected cWnd
+   */
+  void Check (TcpBbr::BbrMode_t mode, uint32_t cWnd);
+
+  Ptr<TcpSocketState> m_tcb; //!< Congestion state
+  Ptr<TcpBbr> m_bbr;         //!< Congestion control
+};
+
+TcpBbrProbeRttTest::TcpBbrProbeRttTest ()
+  : TestCase ("BBR PROBE_RTT")
+{
+}
+
+void
+TcpBbrProbeRttTest::Ack (uint32_t inflight)
+{
+  BbrAck (m_bbr, m_tcb, 1000, DataRate ("10Mbps"), MilliSeconds (150), inflight);
+}
+
+void
+TcpBbrProbeRttTest::Check (TcpBbr::BbrMode_t mode, uint32_t cWnd)
+{
+  NS_TEST_ASSERT_MSG_EQ (m_bbr->GetMode (), mode, "wrong mode at " << Simulator::Now ());
+  NS_TEST_ASSERT_MSG_EQ (m_tcb->m_cWnd.Get (), cWnd, "wrong cWnd at " << Simulator::Now ());
+}
+
+void
+TcpBbrProbeRttTest::DoRun ()
+{
+  m_tcb = BbrTcb (10000);
+  m_bbr = CreateObject<TcpBbr> ();
+  m_bbr->Init (m_tcb);
+  BbrAck (m_bbr, m_tcb, 1000, DataRate ("10Mbps"), MilliSeconds (100), 9000);
+  Check (TcpBbr::BBR_STARTUP, 11000);
+
+  // The min RTT expires at 10 s: the flight is cut to 4 segments
+  Simulator::Schedule (Seconds (10.5), &TcpBbrProbeRttTest::Ack, this, 10000);
+  Simulator::Schedule (Seconds (10.5), &TcpBbrProbeRttTest::Check, this,
+                       TcpBbr::BBR_PROBE_RTT, 4000);
+  // Flight down at 10.6 s: stay until 10.8 s and a round
+  Simulator::Schedule (Seconds (10.6), &TcpBbrProbeRttTest::Ack, this, 4000);
+  Simulator::Schedule (Seconds (10.7), &TcpBbrProbeRttTest::Ack, this, 4000);
+  Simulator::Schedule (Seconds (10.7), &TcpBbrProbeRttTest::Check, this,
+                       TcpBbr::BBR_PROBE_RTT, 4000);
+  // The rate did not grow for 3 rounds meanwhile: on to PROBE_BW, from the
+  // cWnd saved on entry
+  Simulator::Schedule (Seconds (10.9), &TcpBbrProbeRttTest::Ack, this, 4000);
+  Simulator::Schedule (Seconds (10.9), &TcpBbrProbeRttTest::Check, this,
+                       TcpBbr::BBR_PROBE_BW, 12000);
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_bbr->GetMinRtt (), MilliSeconds (150), "min RTT not refreshed");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check the window of the bandwidth filter
+ *
+ * A high sample is forgotten after BwWindowLength rounds, unless the later
+ * samples are application limited.
+ */
+class TcpBbrBwFilterTest : public TestCase
+{
+public:
+  TcpBbrBwFilterTest ();
+
+private:
+  virtual void DoRun (void);
+};
+
+TcpBbrBwFilterTest::TcpBbrBwFilterTest ()
+  : TestCase ("BBR bandwidth filter window")
+{
+}
+
+void
+TcpBbrBwFilterTest::DoRun ()
+{
+  Ptr<TcpSocketState> tcb = BbrTcb (10000);
+  Ptr<TcpBbr> bbr = CreateObject<TcpBbr> ();
+  Time rtt = MilliSeconds (100);
+  bbr->Init (tcb);
+
+  BbrAck (bbr, tcb, 1000, DataRate ("20Mbps"), rtt, 9000);
+  for (uint32_t i = 0; i < 10; ++i)
+    {
+      BbrAck (bbr, tcb, 1000, DataRate ("10Mbps"), rtt, 9000);
+      NS_TEST_ASSERT_MSG_EQ (bbr->GetBw (), DataRate ("20Mbps"), "maximum lost in the window");
+    }
+  BbrAck (bbr, tcb, 1000, DataRate ("10Mbps"), rtt, 9000);
+  NS_TEST_ASSERT_MSG_EQ (bbr->GetBw (), DataRate ("10Mbps"), "maximum kept out of the window");
+
+  BbrAck (bbr, tcb, 1000, DataRate ("20Mbps"), rtt, 9000);
+  for (uint32_t i = 0; i < 15; ++i)
+    {
+      BbrAck (bbr, tcb, 1000, DataRate ("5Mbps"), rtt, 9000, true);
+    }
+  NS_TEST_ASSERT_MSG_EQ (bbr->GetBw (), DataRate ("20Mbps"), "maximum aged by app limited samples");
+  BbrAck (bbr, tcb, 1000, DataRate ("30Mbps"), rtt, 9000, true);
+  NS_TEST_ASSERT_MSG_EQ (bbr->GetBw (), DataRate ("30Mbps"), "app limited sample above the maximum");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief TCP BBR TestSuite
+ */
+class TcpBbrTestSuite : public TestSuite
+{
+public:
+  TcpBbrTestSuite ()
+    : TestSuite ("tcp-bbr-test", UNIT)
+  {
+    AddTestCase (new TcpBbrStartupTest, TestCase::QUICK);
+    AddTestCase (new TcpBbrProbeRttTest, TestCase::QUICK);
+    AddTestCase (new TcpBbrBwFilterTest, TestCase::QUICK);
+  }
+};
+
+static TcpBbrTestSuite g_tcpBbrTest; //!< Static variable for test initialization
+
+} // namespace ns3
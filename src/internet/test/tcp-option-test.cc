@@ -22,6 +22,7 @@
 #include "ns3/tcp-option.h"
 #include "ns3/private/tcp-option-winscale.h"
 #include "ns3/private/tcp-option-ts.h"
+#include "ns3/tcp-option-sack.h"
 
 #include <string.h>
 
@@ -164,6 +165,59 @@ TcpOptionTSTestCase::DoTeardown ()
 {
 }
 
+class TcpOptionSackTestCase : public TestCase
+{
+public:
+  TcpOptionSackTestCase (std::string name, uint32_t numBlocks);
+
+private:
+  virtual void DoRun (void);
+
+  uint32_t m_numBlocks;
+};
+
+
+TcpOptionSackTestCase::TcpOptionSackTestCase (std::string name, uint32_t numBlocks)
+  : TestCase (name)
+{
+  m_numBlocks = numBlocks;
+}
+
+void
+TcpOptionSackTestCase::DoRun ()
+{
+  Ptr<UniformRandomVariable> x = CreateObject<UniformRandomVariable> ();
+  TcpOptionSack opt;
+
+  for (uint32_t i = 0; i < m_numBlocks; ++i)
+    {
+      SequenceNumber32 start (x->GetInteger ());
+      opt.AddSackBlock (TcpOptionSack::SackBlock (start, start + x->GetInteger (1, 65535)));
+    }
+
+  NS_TEST_EXPECT_MSG_EQ (opt.GetSerializedSize (), 2 + 8 * m_numBlocks, "Wrong option size");
+
+  Buffer buffer;
+  buffer.AddAtStart (opt.GetSerializedSize ());
+  opt.Serialize (buffer.Begin ());
+
+  Buffer::Iterator start = buffer.Begin ();
+  NS_TEST_EXPECT_MSG_EQ (start.PeekU8 (), TcpOption::SACK, "Different kind found");
+
+  TcpOptionSack copy;
+  NS_TEST_EXPECT_MSG_EQ (copy.Deserialize (start), opt.GetSerializedSize (),
+                         "Different size deserialized");
+  NS_TEST_EXPECT_MSG_EQ (copy.GetNumSackBlocks (), m_numBlocks, "Different number of blocks");
+
+  TcpOptionSack::SackList::const_iterator it = opt.GetSackList ().begin ();
+  TcpOptionSack::SackList::const_iterator jt = copy.GetSackList ().begin ();
+  for (; it != opt.GetSackList ().end () && jt != copy.GetSackList ().end (); ++it, ++jt)
+    {
+      NS_TEST_EXPECT_MSG_EQ (it->first, jt->first, "Different left edge found");
+      NS_TEST_EXPECT_MSG_EQ (it->second, jt->second, "Different right edge found");
+    }
+}
+
 static class TcpOptionTestSuite : public TestSuite
 {
 public:
@@ -176,6 +230,11 @@ public:
                                               "scale value", i), TestCase::QUICK);
       }
     AddTestCase (new TcpOptionTSTestCase ("Testing serialization of random values for timestamp"), TestCase::QUICK);
+    for (uint32_t i = 1; i <= 4; ++i)
+      {
+        AddTestCase (new TcpOptionSackTestCase ("Testing serialization of SACK "
+                                                "blocks", i), TestCase::QUICK);
+      }
   }
 
 } g_TcpOptionTestSuite;
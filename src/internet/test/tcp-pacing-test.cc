@@ -0,0 +1,178 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/test.h"
+#include "ns3/node.h"
+#include "ns3/log.h"
+#include "tcp-general-test.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TcpPacingTestSuite");
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check the spacing of the data segments sent by the sender
+ *
+ * With pacing, each data segment leaves at least the transmission time of
+ * the previous one at the pacing rate after it, and the pacing rate follows
+ * cWnd / RTT. Without pacing, the window leaves in back-to-back bursts.
+ */
+class TcpPacingTestCase : public TcpGeneralTest
+{
+public:
+  /**
+   * \brief Constructor
+   * \param pacing true to enable pacing
+   * \param name the name of the test
+   */
+  TcpPacingTestCase (bool pacing, const std::string &name);
+
+protected:
+  virtual void ConfigureEnvironment ();
+  virtual Ptr<TcpSocketMsgBase> CreateSenderSocket (Ptr<Node> node);
+
+  virtual void Tx (const Ptr<const Packet> p, const TcpHeader&h, SocketWho who);
+  virtual void FinalChecks ();
+
+  /**
+   * \brief Trace the pacing rate of the sender
+   * \param oldValue old pacing rate
+   * \param newValue new pacing rate
+   */
+  void PacingRateTrace (DataRate oldValue, DataRate newValue);
+
+  bool m_pacing;              //!< Pacing enabled
+  SequenceNumber32 m_highTx;  //!< Highest sequence number sent + 1
+  Time m_lastTx;              //!< Time of the last data segment
+  Time m_lastGap;             //!< Transmission time of the last data segment at the pacing rate
+  uint32_t m_segments;        //!< Number of data segments sent
+  uint32_t m_backToBack;      //!< Number of data segments sent at the same time as the previous one
+  uint32_t m_rateChanges;     //!< Number of changes of the pacing rate
+};
+
+TcpPacingTestCase::TcpPacingTestCase (bool pacing, const std::string &name)
+  : TcpGeneralTest (name),
+    m_pacing (pacing),
+    m_highTx (0),
+    m_segments (0),
+    m_backToBack (0),
+    m_rateChanges (0)
+{
+}
+
+void
+TcpPacingTestCase::ConfigureEnvironment ()
+{
+  TcpGeneralTest::ConfigureEnvironment ();
+  SetAppPktCount (200);
+  SetAppPktInterval (MicroSeconds (1));
+}
+
+Ptr<TcpSocketMsgBase>
+TcpPacingTestCase::CreateSenderSocket (Ptr<Node> node)
+{
+  Ptr<TcpSocketMsgBase> socket = TcpGeneralTest::CreateSenderSocket (node);
+  socket->SetAttribute ("Pacing", BooleanValue (m_pacing));
+  socket->TraceConnectWithoutContext ("PacingRate",
+                                      MakeCallback (&TcpPacingTestCase::PacingRateTrace, this));
+  return socket;
+}
+
+void
+TcpPacingTestCase::PacingRateTrace (DataRate oldValue, DataRate newValue)
+{
+  NS_LOG_INFO ("Pacing rate " << oldValue << " -> " << newValue);
+  m_rateChanges++;
+}
+
+void
+TcpPacingTestCase::Tx (const Ptr<const Packet> p, const TcpHeader &h, SocketWho who)
+{
+  if (who != SENDER || p->GetSize () == 0 || h.GetSequenceNumber () < m_highTx)
+    {
+      return;
+    }
+
+  Time now = Simulator::Now ();
+  if (m_segments > 0)
+    {
+      if (now == m_lastTx)
+        {
+          m_backToBack++;
+        }
+      if (m_pacing)
+        {
+          NS_TEST_ASSERT_MSG_GT_OR_EQ (now - m_lastTx, m_lastGap,
+                                       "segment " << h.GetSequenceNumber () << " not paced");
+        }
+    }
+
+  Ptr<TcpSocketState> tcb = GetTcb (SENDER);
+  m_lastTx = now;
+  m_lastGap = tcb->m_pacingRate.Get ().CalculateBytesTxTime (p->GetSize ());
+  m_highTx = h.GetSequenceNumber () + p->GetSize ();
+  m_segments++;
+
+  if (m_pacing && tcb->m_pacingRate.Get () != tcb->m_maxPacingRate)
+    {
+      // After the first RTT sample, in slow start: twice cWnd per RTT
+      double expected = 2.0 * tcb->m_cWnd * 8 / GetRttEstimator (SENDER)->GetEstimate ().GetSeconds ();
+      NS_TEST_ASSERT_MSG_EQ_TOL (static_cast<double> (tcb->m_pacingRate.Get ().GetBitRate ()),
+                                 expected, expected / 100 + 1,
+                                 "pacing rate not derived from cWnd / RTT");
+    }
+}
+
+void
+TcpPacingTestCase::FinalChecks ()
+{
+  NS_TEST_ASSERT_MSG_EQ (m_segments, 200, "not all the segments were sent");
+  if (m_pacing)
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_backToBack, 0, "back-to-back segments with pacing");
+      NS_TEST_ASSERT_MSG_GT (m_rateChanges, 0, "PacingRate trace not fired");
+    }
+  else
+    {
+      NS_TEST_ASSERT_MSG_GT (m_backToBack, 0, "no burst without pacing");
+      NS_TEST_ASSERT_MSG_EQ (m_rateChanges, 0, "PacingRate changed without pacing");
+    }
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief TCP pacing TestSuite
+ */
+class TcpPacingTestSuite : public TestSuite
+{
+public:
+  TcpPacingTestSuite ()
+    : TestSuite ("tcp-pacing", UNIT)
+  {
+    AddTestCase (new TcpPacingTestCase (true, "Segments paced at 2 cWnd per RTT"), TestCase::QUICK);
+    AddTestCase (new TcpPacingTestCase (false, "Segments in bursts without pacing"), TestCase::QUICK);
+  }
+};
+
+static TcpPacingTestSuite g_tcpPacingTestSuite; //!< Static variable for test initialization
+
+} // namespace ns3
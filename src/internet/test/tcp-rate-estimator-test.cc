@@ -0,0 +1,376 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/tcp-rate-estimator.h"
+#include "ns3/node.h"
+#include "ns3/object-factory.h"
+#include "ns3/tcp-bbr.h"
+#include "ns3/tcp-congestion-ops.h"
+#include "tcp-general-test.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check the rate samples of a TcpRateEstimator
+ *
+ * The segments are 1000 bytes long; the events are scheduled by the
+ * subclasses, which check the samples of the ACKs.
+ */
+class TcpRateEstimatorTestCase : public TestCase
+{
+public:
+  /**
+   * \brief Constructor
+   * \param name the name of the test
+   */
+  TcpRateEstimatorTestCase (const std::string &name);
+
+protected:
+  /**
+   * \brief Send the segment starting at seq
+   * \param seq the first sequence number of the segment
+   */
+  void Send (uint32_t seq);
+
+  /**
+   * \brief Receive an ACK and check its sample
+   * \param ack the ACK number
+   * \param ackedSacked expected bytes newly acknowledged or SACKed
+   * \param delivered expected bytes delivered over the interval
+   * \param interval expected interval, zero for an invalid sample
+   * \param appLimited expected application limited flag
+   */
+  void Ack (uint32_t ack, uint32_t ackedSacked, uint32_t delivered, Time interval,
+            bool appLimited);
+
+  TcpRateEstimator m_estimator;   //!< Estimator under test
+  TcpScoreboard    m_scoreboard;  //!< SACK scoreboard
+  TcpOptionSack::SackList m_sackList; //!< SACK blocks of the next ACK
+  SequenceNumber32 m_head;        //!< First unacknowledged sequence number
+  SequenceNumber32 m_highTx;      //!< Highest sequence number sent + 1
+};
+
+TcpRateEstimatorTestCase::TcpRateEstimatorTestCase (const std::string &name)
+  : TestCase (name),
+    m_head (1),
+    m_highTx (1)
+{
+}
+
+void
+TcpRateEstimatorTestCase::Send (uint32_t seq)
+{
+  SequenceNumber32 s (seq);
+  m_estimator.OnSent (s, 1000, s < m_highTx, m_highTx - m_head);
+  m_highTx = std::max (m_highTx, s + 1000);
+}
+
+void
+TcpRateEstimatorTestCase::Ack (uint32_t ack, uint32_t ackedSacked, uint32_t delivered,
+                               Time interval, bool appLimited)
+{
+  TcpRateSample rs = m_estimator.OnAck (SequenceNumber32 (ack), m_sackList, m_scoreboard);
+  m_sackList.clear ();
+  m_head = std::max (m_head, SequenceNumber32 (ack));
+  m_scoreboard.DiscardUpTo (m_head);
+
+  NS_TEST_ASSERT_MSG_EQ (rs.m_ackedSacked, ackedSacked, "newly delivered bytes of ACK " << ack);
+  NS_TEST_ASSERT_MSG_EQ (rs.m_delivered, delivered, "delivered bytes of ACK " << ack);
+  NS_TEST_ASSERT_MSG_EQ (rs.m_interval, interval, "interval of ACK " << ack);
+  NS_TEST_ASSERT_MSG_EQ (rs.m_isAppLimited, appLimited, "app limited flag of ACK " << ack);
+  uint64_t rate = interval.IsZero () ? 0 : static_cast<uint64_t> (delivered * 8 / interval.GetSeconds ());
+  NS_TEST_ASSERT_MSG_EQ (rs.m_deliveryRate.GetBitRate (), rate, "delivery rate of ACK " << ack);
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Samples of a window sent at once, then of a segment sent later:
+ * the interval is the ACK phase, then the send phase.
+ */
+class TcpRateEstimatorBulkTest : public TcpRateEstimatorTestCase
+{
+public:
+  TcpRateEstimatorBulkTest ()
+    : TcpRateEstimatorTestCase ("Rate samples of a window")
+  {
+  }
+
+private:
+  virtual void DoRun (void);
+};
+
+void
+TcpRateEstimatorBulkTest::DoRun ()
+{
+  for (uint32_t i = 0; i < 10; ++i)
+    {
+      Simulator::Schedule (Seconds (0), &TcpRateEstimatorBulkTest::Send, this, 1 + i * 1000);
+    }
+  Simulator::Schedule (MilliSeconds (100), &TcpRateEstimatorBulkTest::Ack, this,
+                       1001, 1000, 1000, MilliSeconds (100), false);
+  Simulator::Schedule (MilliSeconds (110), &TcpRateEstimatorBulkTest::Ack, this,
+                       2001, 1000, 2000, MilliSeconds (110), false);
+  Simulator::Schedule (MilliSeconds (120), &TcpRateEstimatorBulkTest::Ack, this,
+                       4001, 2000, 4000, MilliSeconds (120), false);
+  Simulator::Schedule (MilliSeconds (120), &TcpRateEstimatorBulkTest::Send, this, 10001);
+  // The segment sent at 120 ms is the sample: 7000 bytes sent over 120 ms
+  // since the start of the interval, acknowledged in 100 ms
+  Simulator::Schedule (MilliSeconds (220), &TcpRateEstimatorBulkTest::Ack, this,
+                       11001, 7000, 7000, MilliSeconds (120), false);
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_estimator.GetDelivered (), 11000, "total delivered bytes");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief SACKed segments are delivered once
+ */
+class TcpRateEstimatorSackTest : public TcpRateEstimatorTestCase
+{
+public:
+  TcpRateEstimatorSackTest ()
+    : TcpRateEstimatorTestCase ("Rate samples with SACK")
+  {
+  }
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \brief Receive a SACK block
+   * \param start first sequence number of the block
+   * \param end sequence number following the block
+   */
+  void Sack (uint32_t start, uint32_t end);
+};
+
+void
+TcpRateEstimatorSackTest::Sack (uint32_t start, uint32_t end)
+{
+  TcpOptionSack::SackList list;
+  list.push_back (TcpOptionSack::SackBlock (SequenceNumber32 (start), SequenceNumber32 (end)));
+  m_scoreboard.Update (list, m_head, m_highTx);
+  m_sackList.insert (m_sackList.end (), list.begin (), list.end ());
+}
+
+void
+TcpRateEstimatorSackTest::DoRun ()
+{
+  for (uint32_t i = 0; i < 5; ++i)
+    {
+      Simulator::Schedule (Seconds (0), &TcpRateEstimatorSackTest::Send, this, 1 + i * 1000);
+    }
+  // Half a segment SACKed: nothing delivered
+  Simulator::Schedule (MilliSeconds (100), &TcpRateEstimatorSackTest::Sack, this, 2001, 2501);
+  Simulator::Schedule (MilliSeconds (100), &TcpRateEstimatorSackTest::Ack, this,
+                       1, 0, 0, Seconds (0), false);
+  // The block completes the segment half SACKed before
+  Simulator::Schedule (MilliSeconds (110), &TcpRateEstimatorSackTest::Sack, this, 2501, 4001);
+  Simulator::Schedule (MilliSeconds (110), &TcpRateEstimatorSackTest::Ack, this,
+                       1, 2000, 2000, MilliSeconds (110), false);
+  // The cumulative ACK does not count the SACKed segments again
+  Simulator::Schedule (MilliSeconds (120), &TcpRateEstimatorSackTest::Ack, this,
+                       5001, 3000, 5000, MilliSeconds (120), false);
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_estimator.GetDelivered (), 5000, "total delivered bytes");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Application limited samples, and the invalid sample of a
+ * retransmission acknowledged in less than the minimum RTT
+ */
+class TcpRateEstimatorAppLimitedTest : public TcpRateEstimatorTestCase
+{
+public:
+  TcpRateEstimatorAppLimitedTest ()
+    : TcpRateEstimatorTestCase ("Application limited and invalid rate samples")
+  {
+  }
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \brief The application has no data to send
+   */
+  void AppLimited (void);
+
+  /**
+   * \brief Check the application limited state of the estimator
+   * \param appLimited the expected state
+   */
+  void CheckAppLimited (bool appLimited);
+};
+
+void
+TcpRateEstimatorAppLimitedTest::AppLimited ()
+{
+  m_estimator.OnAppLimited (m_highTx - m_head);
+}
+
+void
+TcpRateEstimatorAppLimitedTest::CheckAppLimited (bool appLimited)
+{
+  NS_TEST_ASSERT_MSG_EQ (m_estimator.IsAppLimited (), appLimited,
+                         "app limited state at " << Simulator::Now ().GetSeconds ());
+}
+
+void
+TcpRateEstimatorAppLimitedTest::DoRun ()
+{
+  Simulator::Schedule (Seconds (0), &TcpRateEstimatorAppLimitedTest::AppLimited, this);
+  Simulator::Schedule (Seconds (0), &TcpRateEstimatorAppLimitedTest::Send, this, 1);
+  Simulator::Schedule (MilliSeconds (100), &TcpRateEstimatorAppLimitedTest::Ack, this,
+                       1001, 1000, 1000, MilliSeconds (100), true);
+  Simulator::Schedule (MilliSeconds (100), &TcpRateEstimatorAppLimitedTest::CheckAppLimited, this,
+                       false);
+
+  // Sent after the idle period, retransmitted 50 ms later, and acknowledged
+  // 90 ms after the first transmission: shorter than the minimum RTT
+  Simulator::Schedule (MilliSeconds (200), &TcpRateEstimatorAppLimitedTest::Send, this, 1001);
+  Simulator::Schedule (MilliSeconds (250), &TcpRateEstimatorAppLimitedTest::Send, this, 1001);
+  Simulator::Schedule (MilliSeconds (290), &TcpRateEstimatorAppLimitedTest::Ack, this,
+                       2001, 1000, 1000, Seconds (0), false);
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check the "RateSample" trace source of the sender socket
+ *
+ * With a congestion control using rate samples, the samples deliver every
+ * byte sent once, and the ones which are valid take at least the RTT. The
+ * other congestion controls do not run the estimator, and get no sample.
+ */
+class TcpRateSampleTraceTest : public TcpGeneralTest
+{
+public:
+  /**
+   * \brief Constructor
+   * \param congControl congestion control of the sender
+   */
+  TcpRateSampleTraceTest (TypeId congControl)
+    : TcpGeneralTest ("RateSample trace of the socket with " + congControl.GetName ()),
+      m_congControl (congControl),
+      m_ackedSacked (0),
+      m_validSamples (0)
+  {
+  }
+
+protected:
+  virtual void ConfigureEnvironment ();
+  virtual Ptr<TcpSocketMsgBase> CreateSenderSocket (Ptr<Node> node);
+  virtual void FinalChecks ();
+
+  /**
+   * \brief Trace the rate samples of the sender
+   * \param rs the rate sample
+   */
+  void RateSampleTrace (const TcpRateSample &rs);
+
+  TypeId m_congControl;     //!< Congestion control of the sender
+  uint32_t m_ackedSacked;   //!< Bytes delivered by the samples
+  uint32_t m_validSamples;  //!< Number of valid samples
+};
+
+void
+TcpRateSampleTraceTest::ConfigureEnvironment ()
+{
+  TcpGeneralTest::ConfigureEnvironment ();
+  SetCongestionControl (m_congControl);
+}
+
+Ptr<TcpSocketMsgBase>
+TcpRateSampleTraceTest::CreateSenderSocket (Ptr<Node> node)
+{
+  Ptr<TcpSocketMsgBase> socket = TcpGeneralTest::CreateSenderSocket (node);
+  socket->TraceConnectWithoutContext ("RateSample",
+                                      MakeCallback (&TcpRateSampleTraceTest::RateSampleTrace, this));
+  return socket;
+}
+
+void
+TcpRateSampleTraceTest::RateSampleTrace (const TcpRateSample &rs)
+{
+  m_ackedSacked += rs.m_ackedSacked;
+  if (rs.m_interval.IsStrictlyPositive ())
+    {
+      m_validSamples++;
+      NS_TEST_ASSERT_MSG_GT_OR_EQ (rs.m_interval, GetRttEstimator (SENDER)->GetEstimate () / 2,
+                                   "interval shorter than the RTT");
+      NS_TEST_ASSERT_MSG_GT (rs.m_deliveryRate.GetBitRate (), 0, "valid sample without rate");
+    }
+}
+
+void
+TcpRateSampleTraceTest::FinalChecks ()
+{
+  ObjectFactory congControlFactory;
+  congControlFactory.SetTypeId (m_congControl);
+  Ptr<TcpCongestionOps> congControl = congControlFactory.Create<TcpCongestionOps> ();
+  if (!congControl->HasCongControl ())
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_ackedSacked, 0, "samples without a congestion control using them");
+      return;
+    }
+  // 10 packets of 500 bytes
+  NS_TEST_ASSERT_MSG_EQ (m_ackedSacked, 5000, "bytes delivered by the samples");
+  NS_TEST_ASSERT_MSG_GT (m_validSamples, 0, "no valid sample");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief TcpRateEstimator TestSuite
+ */
+class TcpRateEstimatorTestSuite : public TestSuite
+{
+public:
+  TcpRateEstimatorTestSuite ()
+    : TestSuite ("tcp-rate-estimator", UNIT)
+  {
+    AddTestCase (new TcpRateEstimatorBulkTest, TestCase::QUICK);
+    AddTestCase (new TcpRateEstimatorSackTest, TestCase::QUICK);
+    AddTestCase (new TcpRateEstimatorAppLimitedTest, TestCase::QUICK);
+    AddTestCase (new TcpRateSampleTraceTest (TcpBbr::GetTypeId ()), TestCase::QUICK);
+    AddTestCase (new TcpRateSampleTraceTest (TcpNewReno::GetTypeId ()), TestCase::QUICK);
+  }
+};
+
+static TcpRateEstimatorTestSuite g_tcpRateEstimatorTestSuite; //!< Static variable for test initialization
+
+} // namespace ns3
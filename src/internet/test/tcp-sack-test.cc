@@ -0,0 +1,335 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/test.h"
+#include "ns3/node.h"
+#include "ns3/log.h"
+#include "tcp-general-test.h"
+#include "tcp-error-model.h"
+
+#include <map>
+#include <set>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TcpSackTestSuite");
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check the negotiation of SACK: the SACK-permitted option is in the
+ * SYN of the ends that enable SACK, and the SACK option is sent only if both
+ * did. A segment is dropped so that the receiver has out of order data.
+ */
+class TcpSackNegotiationTestCase : public TcpGeneralTest
+{
+public:
+  /// Ends that enable SACK
+  enum Configuration
+  {
+    DISABLED,
+    ENABLED_SENDER,
+    ENABLED_RECEIVER,
+    ENABLED
+  };
+
+  /**
+   * \brief Constructor
+   * \param conf the ends that enable SACK
+   * \param name the name of the test
+   */
+  TcpSackNegotiationTestCase (Configuration conf, const std::string &name);
+
+protected:
+  virtual Ptr<TcpSocketMsgBase> CreateReceiverSocket (Ptr<Node> node);
+  virtual Ptr<TcpSocketMsgBase> CreateSenderSocket (Ptr<Node> node);
+  virtual Ptr<ErrorModel> CreateReceiverErrorModel ();
+
+  virtual void Tx (const Ptr<const Packet> p, const TcpHeader&h, SocketWho who);
+  virtual void FinalChecks ();
+
+  Configuration m_configuration;  //!< Ends that enable SACK
+  uint32_t m_sackSent;            //!< Number of SACK options sent by the receiver
+};
+
+TcpSackNegotiationTestCase::TcpSackNegotiationTestCase (Configuration conf,
+                                                        const std::string &name)
+  : TcpGeneralTest (name),
+    m_configuration (conf),
+    m_sackSent (0)
+{
+}
+
+Ptr<TcpSocketMsgBase>
+TcpSackNegotiationTestCase::CreateReceiverSocket (Ptr<Node> node)
+{
+  Ptr<TcpSocketMsgBase> socket = TcpGeneralTest::CreateReceiverSocket (node);
+  socket->SetAttribute ("Sack", BooleanValue (m_configuration == ENABLED_RECEIVER
+                                              || m_configuration == ENABLED));
+  return socket;
+}
+
+Ptr<TcpSocketMsgBase>
+TcpSackNegotiationTestCase::CreateSenderSocket (Ptr<Node> node)
+{
+  Ptr<TcpSocketMsgBase> socket = TcpGeneralTest::CreateSenderSocket (node);
+  socket->SetAttribute ("Sack", BooleanValue (m_configuration == ENABLED_SENDER
+                                              || m_configuration == ENABLED));
+  return socket;
+}
+
+Ptr<ErrorModel>
+TcpSackNegotiationTestCase::CreateReceiverErrorModel ()
+{
+  Ptr<TcpSeqErrorModel> errorModel = CreateObject<TcpSeqErrorModel> ();
+  errorModel->AddSeqToKill (SequenceNumber32 (2001));
+  return errorModel;
+}
+
+void
+TcpSackNegotiationTestCase::Tx (const Ptr<const Packet> p, const TcpHeader &h, SocketWho who)
+{
+  NS_LOG_INFO (h);
+
+  if (h.GetFlags () & TcpHeader::SYN)
+    {
+      bool expected;
+      if (who == SENDER)
+        {
+          expected = (m_configuration == ENABLED_SENDER || m_configuration == ENABLED);
+        }
+      else
+        {
+          expected = (m_configuration == ENABLED);
+        }
+      NS_TEST_ASSERT_MSG_EQ (h.HasOption (TcpOption::SACKPERMITTED), expected,
+                             "wrong SACK-permitted option in the SYN");
+      NS_TEST_ASSERT_MSG_EQ (h.HasOption (TcpOption::SACK), false,
+                             "SACK option in a SYN");
+      return;
+    }
+
+  NS_TEST_ASSERT_MSG_EQ (h.HasOption (TcpOption::SACKPERMITTED), false,
+                         "SACK-permitted option in a non-SYN segment");
+
+  if (h.HasOption (TcpOption::SACK))
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_configuration, ENABLED,
+                             "SACK option sent but SACK not negotiated");
+      NS_TEST_ASSERT_MSG_EQ (who, RECEIVER, "SACK option sent by the sender");
+      m_sackSent++;
+    }
+}
+
+void
+TcpSackNegotiationTestCase::FinalChecks ()
+{
+  if (m_configuration == ENABLED)
+    {
+      NS_TEST_ASSERT_MSG_GT (m_sackSent, 0, "no SACK option for the out of order data");
+    }
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check the recovery from several losses in one window
+ *
+ * Three segments of the same window are dropped. With SACK, the sender
+ * retransmits each of them once, without an RTO and without waiting for a
+ * partial ACK for the next hole. Without SACK, NewReno recovers without an
+ * RTO too, but one hole per round trip.
+ */
+class TcpSackRecoveryTestCase : public TcpGeneralTest
+{
+public:
+  /**
+   * \brief Constructor
+   * \param sack true if both ends enable SACK
+   * \param name the name of the test
+   */
+  TcpSackRecoveryTestCase (bool sack, const std::string &name);
+
+protected:
+  virtual void ConfigureEnvironment ();
+  virtual void ConfigureProperties ();
+  virtual Ptr<TcpSocketMsgBase> CreateReceiverSocket (Ptr<Node> node);
+  virtual Ptr<TcpSocketMsgBase> CreateSenderSocket (Ptr<Node> node);
+  virtual Ptr<ErrorModel> CreateReceiverErrorModel ();
+
+  virtual void Tx (const Ptr<const Packet> p, const TcpHeader&h, SocketWho who);
+  virtual void Rx (const Ptr<const Packet> p, const TcpHeader&h, SocketWho who);
+  virtual void RTOExpired (const Ptr<const TcpSocketState> tcb, SocketWho who);
+  virtual void FinalChecks ();
+
+  bool m_sack;                                    //!< SACK enabled
+  std::set<SequenceNumber32> m_toKill;            //!< Segments dropped
+  std::set<SequenceNumber32> m_sent;              //!< Segments sent at least once
+  std::map<SequenceNumber32, uint32_t> m_retx;    //!< Retransmissions of the dropped segments
+  SequenceNumber32 m_highAck;                     //!< Highest ACK received by the sender
+  uint32_t m_retxBeforeFirstAck;                  //!< Holes retransmitted before the first hole was ACKed
+  bool m_rtoExpired;                              //!< An RTO expired
+};
+
+TcpSackRecoveryTestCase::TcpSackRecoveryTestCase (bool sack, const std::string &name)
+  : TcpGeneralTest (name),
+    m_sack (sack),
+    m_highAck (0),
+    m_retxBeforeFirstAck (0),
+    m_rtoExpired (false)
+{
+  // segments 41, 43 and 45, sent in the same round of slow start
+  m_toKill.insert (SequenceNumber32 (20001));
+  m_toKill.insert (SequenceNumber32 (21001));
+  m_toKill.insert (SequenceNumber32 (22001));
+}
+
+void
+TcpSackRecoveryTestCase::ConfigureEnvironment ()
+{
+  TcpGeneralTest::ConfigureEnvironment ();
+  SetAppPktCount (100);
+}
+
+void
+TcpSackRecoveryTestCase::ConfigureProperties ()
+{
+  TcpGeneralTest::ConfigureProperties ();
+  SetInitialSsThresh (SENDER, UINT32_MAX);
+}
+
+Ptr<TcpSocketMsgBase>
+TcpSackRecoveryTestCase::CreateReceiverSocket (Ptr<Node> node)
+{
+  Ptr<TcpSocketMsgBase> socket = TcpGeneralTest::CreateReceiverSocket (node);
+  socket->SetAttribute ("Sack", BooleanValue (m_sack));
+  return socket;
+}
+
+Ptr<TcpSocketMsgBase>
+TcpSackRecoveryTestCase::CreateSenderSocket (Ptr<Node> node)
+{
+  Ptr<TcpSocketMsgBase> socket = TcpGeneralTest::CreateSenderSocket (node);
+  socket->SetAttribute ("Sack", BooleanValue (m_sack));
+  socket->SetAttribute ("MinRto", TimeValue (Seconds (10.0)));
+  return socket;
+}
+
+Ptr<ErrorModel>
+TcpSackRecoveryTestCase::CreateReceiverErrorModel ()
+{
+  Ptr<TcpSeqErrorModel> errorModel = CreateObject<TcpSeqErrorModel> ();
+  for (std::set<SequenceNumber32>::iterator it = m_toKill.begin (); it != m_toKill.end (); ++it)
+    {
+      errorModel->AddSeqToKill (*it);
+    }
+  return errorModel;
+}
+
+void
+TcpSackRecoveryTestCase::Tx (const Ptr<const Packet> p, const TcpHeader &h, SocketWho who)
+{
+  if (who != SENDER || p->GetSize () == 0)
+    {
+      return;
+    }
+
+  SequenceNumber32 seq = h.GetSequenceNumber ();
+  NS_LOG_INFO ("\tSENDER Tx " << seq << " highest ACK " << m_highAck);
+
+  if (m_sent.insert (seq).second)
+    {
+      return;
+    }
+
+  NS_TEST_ASSERT_MSG_EQ (m_toKill.count (seq), 1, "retransmission of a segment not dropped: " << seq);
+  m_retx[seq]++;
+  if (seq != *m_toKill.begin () && m_highAck <= *m_toKill.begin ())
+    {
+      m_retxBeforeFirstAck++;
+    }
+}
+
+void
+TcpSackRecoveryTestCase::Rx (const Ptr<const Packet> p, const TcpHeader &h, SocketWho who)
+{
+  if (who == SENDER && (h.GetFlags () & TcpHeader::ACK))
+    {
+      m_highAck = std::max (m_highAck, h.GetAckNumber ());
+    }
+}
+
+void
+TcpSackRecoveryTestCase::RTOExpired (const Ptr<const TcpSocketState> tcb, SocketWho who)
+{
+  m_rtoExpired = true;
+}
+
+void
+TcpSackRecoveryTestCase::FinalChecks ()
+{
+  NS_TEST_ASSERT_MSG_EQ (m_rtoExpired, false, "recovery needed an RTO");
+
+  for (std::set<SequenceNumber32>::iterator it = m_toKill.begin (); it != m_toKill.end (); ++it)
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_retx[*it], 1, "segment " << *it << " not retransmitted once");
+    }
+
+  if (m_sack)
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_retxBeforeFirstAck, m_toKill.size () - 1,
+                             "SACK recovery waited for a partial ACK");
+    }
+  else
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_retxBeforeFirstAck, 0,
+                             "NewReno retransmitted a hole before a partial ACK");
+    }
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief TCP SACK TestSuite
+ */
+class TcpSackTestSuite : public TestSuite
+{
+public:
+  TcpSackTestSuite ()
+    : TestSuite ("tcp-sack", UNIT)
+  {
+    AddTestCase (new TcpSackNegotiationTestCase (TcpSackNegotiationTestCase::DISABLED,
+                                                 "SACK disabled"), TestCase::QUICK);
+    AddTestCase (new TcpSackNegotiationTestCase (TcpSackNegotiationTestCase::ENABLED_SENDER,
+                                                 "SACK enabled only by the sender"), TestCase::QUICK);
+    AddTestCase (new TcpSackNegotiationTestCase (TcpSackNegotiationTestCase::ENABLED_RECEIVER,
+                                                 "SACK enabled only by the receiver"), TestCase::QUICK);
+    AddTestCase (new TcpSackNegotiationTestCase (TcpSackNegotiationTestCase::ENABLED,
+                                                 "SACK enabled by both ends"), TestCase::QUICK);
+    AddTestCase (new TcpSackRecoveryTestCase (true, "Three losses in a window, SACK"),
+                 TestCase::QUICK);
+    AddTestCase (new TcpSackRecoveryTestCase (false, "Three losses in a window, NewReno"),
+                 TestCase::QUICK);
+  }
+};
+
+static TcpSackTestSuite g_tcpSackTestSuite; //!< Static variable for test initialization
+
+} // namespace ns3
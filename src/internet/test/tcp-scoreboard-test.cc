@@ -0,0 +1,168 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/test.h"
+#include "ns3/tcp-scoreboard.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check the ranges kept by the TcpScoreboard: merge of the SACK
+ * blocks, lost holes, pipe, retransmissions and cumulative ACKs.
+ *
+ * The segment size is 100 bytes and DupThresh is 3, so the unSACKed data
+ * is lost when more than 200 bytes, or 3 ranges, are SACKed above it.
+ */
+class TcpScoreboardTestCase : public TestCase
+{
+public:
+  TcpScoreboardTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \brief Build a SACK list of one block
+   * \param start first sequence number of the block
+   * \param end sequence number following the block
+   * \returns the list
+   */
+  static TcpOptionSack::SackList Block (uint32_t start, uint32_t end);
+};
+
+TcpScoreboardTestCase::TcpScoreboardTestCase ()
+  : TestCase ("Ranges of the TcpScoreboard")
+{
+}
+
+TcpOptionSack::SackList
+TcpScoreboardTestCase::Block (uint32_t start, uint32_t end)
+{
+  TcpOptionSack::SackList list;
+  list.push_back (TcpOptionSack::SackBlock (SequenceNumber32 (start), SequenceNumber32 (end)));
+  return list;
+}
+
+void
+TcpScoreboardTestCase::DoRun ()
+{
+  const SequenceNumber32 head (1000);
+  const SequenceNumber32 high (3000);
+  TcpScoreboard sb;
+
+  NS_TEST_ASSERT_MSG_EQ (sb.IsLost (head, 3, 100), false, "nothing lost without SACK");
+  NS_TEST_ASSERT_MSG_EQ (sb.GetPipe (head, high, 3, 100), 2000, "pipe without SACK");
+
+  // overlapping and touching blocks are merged
+  NS_TEST_ASSERT_MSG_EQ (sb.Update (Block (1500, 1600), head, high), 100, "first block");
+  NS_TEST_ASSERT_MSG_EQ (sb.Update (Block (1550, 1700), head, high), 100, "overlapping block");
+  NS_TEST_ASSERT_MSG_EQ (sb.Update (Block (1500, 1700), head, high), 0, "duplicate block");
+  NS_TEST_ASSERT_MSG_EQ (sb.Update (Block (1700, 1800), head, high), 100, "touching block");
+  NS_TEST_ASSERT_MSG_EQ (sb.GetSackedBytes (), 300, "SACKed bytes");
+  NS_TEST_ASSERT_MSG_EQ (sb.IsSacked (SequenceNumber32 (1499)), false, "below the range");
+  NS_TEST_ASSERT_MSG_EQ (sb.IsSacked (SequenceNumber32 (1500)), true, "first byte of the range");
+  NS_TEST_ASSERT_MSG_EQ (sb.IsSacked (SequenceNumber32 (1799)), true, "last byte of the range");
+  NS_TEST_ASSERT_MSG_EQ (sb.IsSacked (SequenceNumber32 (1800)), false, "above the range");
+  NS_TEST_ASSERT_MSG_EQ (sb.IsSacked (SequenceNumber32 (1500), SequenceNumber32 (1800)), true,
+                         "whole range");
+  NS_TEST_ASSERT_MSG_EQ (sb.IsSacked (SequenceNumber32 (1600), SequenceNumber32 (1700)), true,
+                         "inner range");
+  NS_TEST_ASSERT_MSG_EQ (sb.IsSacked (SequenceNumber32 (1700), SequenceNumber32 (1900)), false,
+                         "range across the end");
+  NS_TEST_ASSERT_MSG_EQ (sb.IsSacked (SequenceNumber32 (1400), SequenceNumber32 (1600)), false,
+                         "range across the start");
+
+  // the parts of a block outside [head, highTxMark) are ignored
+  NS_TEST_ASSERT_MSG_EQ (sb.Update (Block (500, 900), head, high), 0, "block below head");
+  NS_TEST_ASSERT_MSG_EQ (sb.Update (Block (2900, 3500), head, high), 100, "block above highTxMark");
+  NS_TEST_ASSERT_MSG_EQ (sb.IsSacked (SequenceNumber32 (3000)), false, "SACKed beyond highTxMark");
+
+  // 400 bytes SACKed above [1000, 1500): lost. [1800, 2900) has 100 bytes
+  // SACKed above it only: not lost
+  NS_TEST_ASSERT_MSG_EQ (sb.IsLost (head, 3, 100), true, "head not lost");
+  NS_TEST_ASSERT_MSG_EQ (sb.IsLost (SequenceNumber32 (1600), 3, 100), false, "SACKed byte lost");
+  NS_TEST_ASSERT_MSG_EQ (sb.IsLost (SequenceNumber32 (1800), 3, 100), false, "hole not lost yet");
+  NS_TEST_ASSERT_MSG_EQ (sb.GetLostBytes (head, 3, 100), 500, "lost bytes");
+  NS_TEST_ASSERT_MSG_EQ (sb.GetPipe (head, high, 3, 100), 2000 - 400 - 500, "pipe");
+
+  SequenceNumber32 seq;
+  uint32_t length;
+  NS_TEST_ASSERT_MSG_EQ (sb.NextLostHole (head, 3, 100, seq, length), true, "no hole at head");
+  NS_TEST_ASSERT_MSG_EQ (seq, head, "start of the first hole");
+  NS_TEST_ASSERT_MSG_EQ (length, 500, "length of the first hole");
+  NS_TEST_ASSERT_MSG_EQ (sb.NextLostHole (SequenceNumber32 (1200), 3, 100, seq, length), true,
+                         "no hole in the middle");
+  NS_TEST_ASSERT_MSG_EQ (seq, SequenceNumber32 (1200), "start of the partial hole");
+  NS_TEST_ASSERT_MSG_EQ (length, 300, "length of the partial hole");
+  NS_TEST_ASSERT_MSG_EQ (sb.NextLostHole (SequenceNumber32 (1500), 3, 100, seq, length), false,
+                         "hole above the lost bound");
+
+  // two more ranges above [1800, 2900) make it lost, though they hold
+  // 200 bytes only: the bound is now 2500
+  NS_TEST_ASSERT_MSG_EQ (sb.Update (Block (2500, 2550), head, high), 50, "second range");
+  NS_TEST_ASSERT_MSG_EQ (sb.IsLost (SequenceNumber32 (1800), 3, 100), false, "hole lost too early");
+  NS_TEST_ASSERT_MSG_EQ (sb.Update (Block (2700, 2750), head, high), 50, "third range");
+  NS_TEST_ASSERT_MSG_EQ (sb.IsLost (SequenceNumber32 (1800), 3, 100), true, "hole not lost");
+  NS_TEST_ASSERT_MSG_EQ (sb.NextLostHole (SequenceNumber32 (1500), 3, 100, seq, length), true,
+                         "no hole after the SACKed range");
+  NS_TEST_ASSERT_MSG_EQ (seq, SequenceNumber32 (1800), "start of the second hole");
+  NS_TEST_ASSERT_MSG_EQ (length, 700, "length of the second hole");
+
+  // retransmissions count in the pipe until SACKed or acknowledged
+  uint32_t pipe = sb.GetPipe (head, high, 3, 100);
+  sb.MarkRetransmitted (head, 100);
+  sb.MarkRetransmitted (SequenceNumber32 (1800), 100);
+  NS_TEST_ASSERT_MSG_EQ (sb.GetRetransmittedBytes (), 200, "retransmitted bytes");
+  NS_TEST_ASSERT_MSG_EQ (sb.GetPipe (head, high, 3, 100), pipe + 200, "pipe with retransmissions");
+  sb.Update (Block (1800, 1850), head, high);
+  NS_TEST_ASSERT_MSG_EQ (sb.GetRetransmittedBytes (), 150, "SACKed retransmission");
+
+  // a cumulative ACK in the middle of a range splits it
+  sb.DiscardUpTo (SequenceNumber32 (1600));
+  NS_TEST_ASSERT_MSG_EQ (sb.GetRetransmittedBytes (), 50, "acknowledged retransmission");
+  NS_TEST_ASSERT_MSG_EQ (sb.IsSacked (SequenceNumber32 (1599)), false, "acknowledged range");
+  NS_TEST_ASSERT_MSG_EQ (sb.IsSacked (SequenceNumber32 (1600)), true, "tail of the range");
+  NS_TEST_ASSERT_MSG_EQ (sb.GetSackedBytes (), 250 + 50 + 50 + 100, "SACKed bytes after the ACK");
+
+  sb.Clear ();
+  NS_TEST_ASSERT_MSG_EQ (sb.GetSackedBytes (), 0, "SACKed bytes after Clear");
+  NS_TEST_ASSERT_MSG_EQ (sb.GetRetransmittedBytes (), 0, "retransmitted bytes after Clear");
+  NS_TEST_ASSERT_MSG_EQ (sb.IsLost (SequenceNumber32 (1600), 3, 100), false, "lost after Clear");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief TcpScoreboard TestSuite
+ */
+class TcpScoreboardTestSuite : public TestSuite
+{
+public:
+  TcpScoreboardTestSuite ()
+    : TestSuite ("tcp-scoreboard", UNIT)
+  {
+    AddTestCase (new TcpScoreboardTestCase, TestCase::QUICK);
+  }
+};
+
+static TcpScoreboardTestSuite g_tcpScoreboardTestSuite; //!< Static variable for test initialization
+
+} // namespace ns3
@@ -0,0 +1,141 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/test.h"
+#include "ns3/packet.h"
+#include "ns3/tcp-tx-buffer.h"
+
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check that the segments copied from the Tx buffer hold the bytes
+ * written by the application, for segments that start and end anywhere in
+ * the written packets, before and after discarding acknowledged data.
+ */
+class TcpTxBufferTestCase : public TestCase
+{
+public:
+  TcpTxBufferTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \brief Copy a segment from the buffer and check its bytes
+   * \param buffer the Tx buffer
+   * \param numBytes the size of the segment
+   * \param seq the sequence number of its first byte
+   */
+  void CheckSegment (Ptr<TcpTxBuffer> buffer, uint32_t numBytes, SequenceNumber32 seq);
+
+  std::vector<uint8_t> m_written; //!< Bytes written in the buffer, from sequence number 1000
+};
+
+TcpTxBufferTestCase::TcpTxBufferTestCase ()
+  : TestCase ("Segments copied from the TcpTxBuffer")
+{
+}
+
+void
+TcpTxBufferTestCase::CheckSegment (Ptr<TcpTxBuffer> buffer, uint32_t numBytes, SequenceNumber32 seq)
+{
+  uint32_t expected = std::min (numBytes, buffer->SizeFromSequence (seq));
+  Ptr<Packet> segment = buffer->CopyFromSequence (numBytes, seq);
+  NS_TEST_ASSERT_MSG_EQ (segment->GetSize (), expected, "wrong size of the segment at " << seq);
+
+  std::vector<uint8_t> bytes (expected);
+  segment->CopyData (bytes.data (), expected);
+  uint32_t start = seq - SequenceNumber32 (1000);
+  for (uint32_t i = 0; i < expected; i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ ((uint32_t) bytes[i], (uint32_t) m_written[start + i],
+                             "wrong byte " << i << " of the segment at " << seq);
+    }
+}
+
+void
+TcpTxBufferTestCase::DoRun ()
+{
+  Ptr<TcpTxBuffer> buffer = CreateObject<TcpTxBuffer> ();
+  buffer->SetMaxBufferSize (100000);
+  buffer->SetHeadSequence (SequenceNumber32 (1000));
+
+  // application writes of varying sizes, so that the segments straddle them
+  uint32_t sizes[] = { 100, 1500, 7, 536, 3000, 1, 999, 2048 };
+  for (uint32_t n = 0; n < 20; n++)
+    {
+      uint32_t size = sizes[n % 8];
+      std::vector<uint8_t> data (size);
+      for (uint32_t i = 0; i < size; i++)
+        {
+          data[i] = (m_written.size () * 7 + n) % 251;
+          m_written.push_back (data[i]);
+        }
+      NS_TEST_ASSERT_MSG_EQ (buffer->Add (Create<Packet> (data.data (), size)), true, "packet rejected");
+    }
+  NS_TEST_ASSERT_MSG_EQ (buffer->Size (), m_written.size (), "wrong size of the buffer");
+
+  for (uint32_t seq = 1000; seq < 1000 + m_written.size (); seq += 331)
+    {
+      CheckSegment (buffer, 536, SequenceNumber32 (seq));
+      CheckSegment (buffer, 4000, SequenceNumber32 (seq));
+    }
+  // a segment past the end of the data is truncated
+  CheckSegment (buffer, 536, buffer->TailSequence () - 100);
+
+  // discard whole packets, then part of a packet
+  buffer->DiscardUpTo (SequenceNumber32 (1000 + 1607));
+  NS_TEST_ASSERT_MSG_EQ (buffer->HeadSequence (), SequenceNumber32 (1000 + 1607), "wrong head after discarding whole packets");
+  buffer->DiscardUpTo (SequenceNumber32 (1000 + 2000));
+  NS_TEST_ASSERT_MSG_EQ (buffer->HeadSequence (), SequenceNumber32 (1000 + 2000), "wrong head after discarding part of a packet");
+  NS_TEST_ASSERT_MSG_EQ (buffer->Size (), m_written.size () - 2000, "wrong size after discarding");
+  for (uint32_t seq = 1000 + 2000; seq < 1000 + m_written.size (); seq += 613)
+    {
+      CheckSegment (buffer, 1448, SequenceNumber32 (seq));
+    }
+
+  // acknowledging the FIN goes one past the end of the data
+  SequenceNumber32 fin = buffer->TailSequence () + 1;
+  buffer->DiscardUpTo (fin);
+  NS_TEST_ASSERT_MSG_EQ (buffer->Size (), 0, "data left after the FIN is acknowledged");
+  NS_TEST_ASSERT_MSG_EQ (buffer->HeadSequence (), fin, "wrong head after the FIN is acknowledged");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief TcpTxBuffer TestSuite
+ */
+class TcpTxBufferTestSuite : public TestSuite
+{
+public:
+  TcpTxBufferTestSuite ()
+    : TestSuite ("tcp-tx-buffer", UNIT)
+  {
+    AddTestCase (new TcpTxBufferTestCase (), TestCase::QUICK);
+  }
+};
+
+static TcpTxBufferTestSuite g_tcpTxBufferTestSuite; //!< Static variable for test initialization
+
+} // namespace ns3
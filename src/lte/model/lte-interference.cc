@@ -188,9 +188,13 @@ LteInterference::ConditionallyEvaluateChunk ()
     {
       NS_LOG_LOGIC (this << " signal = " << *m_rxSignal << " allSignals = " << *m_allSignals << " noise = " << *m_noise);
 
-      SpectrumValue interf =  (*m_allSignals) - (*m_rxSignal) + (*m_noise);
+      // interf = allSignals - rxSignal + noise, in the buffers of the previous chunk
+      m_interf = *m_allSignals;
+      m_interf -= *m_rxSignal;
+      m_interf += *m_noise;
+      const SpectrumValue& interf = m_interf;
 
-      SpectrumValue sinr = (*m_rxSignal) / interf;
+      const SpectrumValue& sinr = m_sinr.SetQuotient (*m_rxSignal, m_interf);
       Time duration = Now () - m_lastChangeTime;
       for (std::list<Ptr<LteChunkProcessor> >::const_iterator it = m_sinrChunkProcessorList.begin (); it != m_sinrChunkProcessorList.end (); ++it)
         {
@@ -217,6 +221,8 @@ LteInterference::SetNoisePowerSpectralDensity (Ptr<const SpectrumValue> noisePsd
   // reset m_allSignals (will reset if already set previously)
   // this is needed since this method can potentially change the SpectrumModel
   m_allSignals = Create<SpectrumValue> (noisePsd->GetSpectrumModel ());
+  m_interf = SpectrumValue (noisePsd->GetSpectrumModel ());
+  m_sinr = SpectrumValue (noisePsd->GetSpectrumModel ());
   if (m_receiving == true)
     {
       // abort rx
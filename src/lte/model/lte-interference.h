@@ -135,6 +135,9 @@ private:
 
   Ptr<const SpectrumValue> m_noise;
 
+  SpectrumValue m_interf; ///< interference of the last chunk, reused across chunks
+  SpectrumValue m_sinr;   ///< SINR of the last chunk, reused across chunks
+
   Time m_lastChangeTime;     /**< the time of the last change in
                                 m_TotalPower */
 
@@ -28,8 +28,95 @@ NS_LOG_COMPONENT_DEFINE ("LteRlcAmHeader");
 
 NS_OBJECT_ENSURE_REGISTERED (LteRlcAmHeader);
 
+namespace {
+
+/// Writes fields of any length to a buffer, most significant bit first
+class BitWriter
+{
+public:
+  BitWriter (Buffer::Iterator &i)
+    : m_i (i),
+      m_byte (0),
+      m_bits (0)
+  {}
+
+  void Write (uint32_t value, uint8_t length)
+  {
+    for (int b = length - 1; b >= 0; b--)
+      {
+        m_byte = (m_byte << 1) | ((value >> b) & 0x01);
+        if (++m_bits == 8)
+          {
+            m_i.WriteU8 (m_byte);
+            m_byte = 0;
+            m_bits = 0;
+          }
+      }
+  }
+
+  /// Write the last byte, padded with zeros
+  void Flush (void)
+  {
+    if (m_bits > 0)
+      {
+        m_i.WriteU8 (m_byte << (8 - m_bits));
+        m_byte = 0;
+        m_bits = 0;
+      }
+  }
+
+private:
+  Buffer::Iterator &m_i;
+  uint8_t m_byte;
+  uint8_t m_bits;
+};
+
+/// Reads fields of any length from a buffer, most significant bit first
+class BitReader
+{
+public:
+  BitReader (Buffer::Iterator &i)
+    : m_i (i),
+      m_byte (0),
+      m_bits (0),
+      m_bytesRead (0)
+  {}
+
+  uint32_t Read (uint8_t length)
+  {
+    uint32_t value = 0;
+    for (uint8_t b = 0; b < length; b++)
+      {
+        if (m_bits == 0)
+          {
+            m_byte = m_i.ReadU8 ();
+            m_bits = 8;
+            m_bytesRead++;
+          }
+        m_bits--;
+        value = (value << 1) | ((m_byte >> m_bits) & 0x01);
+      }
+    return value;
+  }
+
+  /// \return the number of bytes read, including the partially read one
+  uint16_t GetBytesRead (void) const
+  {
+    return m_bytesRead;
+  }
+
+private:
+  Buffer::Iterator &m_i;
+  uint8_t m_byte;
+  uint8_t m_bits;
+  uint16_t m_bytesRead;
+};
+
+} // anonymous namespace
+
 LteRlcAmHeader::LteRlcAmHeader ()
   : m_headerLength (0),
+    m_snLength (10),
     m_dataControlBit (0xff),
     m_resegmentationFlag (0xff),
     m_pollingBit (0xff),
@@ -56,18 +143,42 @@ LteRlcAmHeader::~LteRlcAmHeader ()
     m_ackSn = 0xffff;
 }
 
+void
+LteRlcAmHeader::SetSnLength (uint8_t snLength)
+{
+  NS_ASSERT_MSG (snLength == 10 || snLength == 16, "unsupported SN length " << (uint16_t) snLength);
+  NS_ASSERT_MSG (m_headerLength == 0, "the SN length must be set before the PDU type");
+  m_snLength = snLength;
+  m_sequenceNumber.SetLength (snLength);
+  m_ackSn.SetLength (snLength);
+}
+
+uint8_t
+LteRlcAmHeader::GetSnLength (void) const
+{
+  return m_snLength;
+}
+
 void
 LteRlcAmHeader::SetDataPdu (void)
 {
-  m_headerLength = 4;
+  m_headerLength = (m_snLength == 16) ? 5 : 4;
   m_dataControlBit = DATA_PDU;
 }
 void
 LteRlcAmHeader::SetControlPdu (uint8_t controlPduType)
 {
-  m_headerLength = 2;
   m_dataControlBit = CONTROL_PDU;
   m_controlPduType = controlPduType;
+  m_headerLength = GetStatusPduLength (0);
+}
+
+uint16_t
+LteRlcAmHeader::GetStatusPduLength (uint32_t nacks) const
+{
+  // D/C, CPT, ACK_SN and E1, then NACK_SN, E1 and E2 for each NACK
+  uint32_t bits = 1 + 3 + m_snLength + 1 + nacks * (m_snLength + 2);
+  return (bits + 7) / 8;
 }
 bool
 LteRlcAmHeader::IsDataPdu (void) const
@@ -226,6 +337,11 @@ LteRlcAmHeader::OneMoreNackWouldFitIn (uint16_t bytes)
   NS_LOG_FUNCTION (this << bytes);
   NS_ASSERT_MSG (m_dataControlBit == CONTROL_PDU && m_controlPduType == LteRlcAmHeader::STATUS_PDU,
                  "method allowed only for STATUS PDUs");
+  if (m_snLength == 16)
+    {
+      return (GetStatusPduLength (m_nackSnList.size () + 1) <= bytes);
+    }
+  // 10-bit SNs keep the historical estimate
   if (m_nackSnList.size () % 2 == 0)
     {
       return (m_headerLength < bytes);
@@ -243,15 +359,7 @@ LteRlcAmHeader::PushNack (int nack)
   NS_ASSERT_MSG (m_dataControlBit == CONTROL_PDU && m_controlPduType == LteRlcAmHeader::STATUS_PDU,
                  "method allowed only for STATUS PDUs");
   m_nackSnList.push_back (nack);
-
-  if (m_nackSnList.size () % 2 == 0)
-    {
-      m_headerLength++;
-    }
-  else
-    {
-      m_headerLength+=2;
-    }
+  m_headerLength = GetStatusPduLength (m_nackSnList.size ());
 }
 
 bool
@@ -382,7 +490,17 @@ void LteRlcAmHeader::Serialize (Buffer::Iterator start) const
   std::list <uint16_t>::const_iterator it2 = m_lengthIndicators.begin ();
   std::list <int>::const_iterator it3 = m_nackSnList.begin ();
 
-  if ( m_dataControlBit == DATA_PDU )
+  if ( m_dataControlBit == DATA_PDU && m_snLength == 16 )
+    {
+      // the two reserved bits are followed by the whole SN
+      i.WriteU8 ( ((DATA_PDU << 7) & 0x80) |
+                  ((m_resegmentationFlag << 6) & 0x40) |
+                  ((m_pollingBit << 5) & 0x20) |
+                  ((m_framingInfo << 3) & 0x18) |
+                  (((*it1) << 2) & 0x04) );
+      i.WriteHtonU16 ( m_sequenceNumber.GetValue () );
+    }
+  else if ( m_dataControlBit == DATA_PDU )
     {
       i.WriteU8 ( ((DATA_PDU << 7) & 0x80) |
                   ((m_resegmentationFlag << 6) & 0x40) |
@@ -391,6 +509,10 @@ void LteRlcAmHeader::Serialize (Buffer::Iterator start) const
                   (((*it1) << 2) & 0x04) |
                   ((m_sequenceNumber.GetValue () >> 8) & 0x0003) );
       i.WriteU8 ( m_sequenceNumber.GetValue () & 0x00FF );
+    }
+
+  if ( m_dataControlBit == DATA_PDU )
+    {
       i.WriteU8 ( ((m_lastSegmentFlag << 7) & 0x80) |
                   ((m_segmentOffset >> 8) & 0x007F) );
       i.WriteU8 ( m_segmentOffset & 0x00FF );
@@ -430,80 +552,21 @@ void LteRlcAmHeader::Serialize (Buffer::Iterator start) const
     }
   else // if ( m_dataControlBit == CONTROL_PDU )
     {
-      i.WriteU8 ( ((CONTROL_PDU << 7) & 0x80) |
-                  ((m_controlPduType << 4) & 0x70) |
-                  ((m_ackSn.GetValue () >> 6) & 0x0F) );
-      // note: second part of ackSn will be written later
-
-      // serialize the NACKs
-      if ( it3 == m_nackSnList.end () ) 
-        {
-          NS_LOG_LOGIC (this << " no NACKs");
-           // If there are no NACKs then this line adds the rest of the ACK
-           // along with 0x00, indicating an E1 value of 0 or no NACKs follow.
-           i.WriteU8 ( ((m_ackSn.GetValue () << 2) & 0xFC) );
-        }
-      else
+      // The fields are not byte aligned. Since SO start/end are not
+      // supported, E2 is always 0
+      BitWriter w (i);
+      w.Write (CONTROL_PDU, 1);
+      w.Write (m_controlPduType, 3);
+      w.Write (m_ackSn.GetValue (), m_snLength);
+      w.Write (it3 != m_nackSnList.end (), 1);
+      while ( it3 != m_nackSnList.end () )
         {
-          int oddNack = *it3;
-          int evenNack = -1;
-          // Else write out a series of E1 = 1 and NACK values. Note since we
-          // are not supporting SO start/end the value of E2 will always be 0.
-
-
-          // First write out the ACK along with the very first NACK
-          // And the remaining NACK with 0x02 or 10 in binary to set
-          // E1 to 1, then Or in the first bit of the NACK
-          i.WriteU8 ( ((m_ackSn.GetValue () << 2) & 0xFC)
-            | (0x02)
-            | ((*it3 >> 9) & 0x01));
-
-          while ( it3 != m_nackSnList.end () )
-            {
-              // The variable oddNack has the current NACK value to write, also
-              // either the setup to enter this loop or the previous loop would
-              // have written the highest order bit to the previouse octet.
-              // Write the next set of bits (2 - 9) into the next octet
-              i.WriteU8( ((oddNack >> 1) & 0xFF) );
-
-              // Next check to see if there is going to be another NACK after
-              // this
-              it3++;
-              if ( it3 != m_nackSnList.end () )
-                {
-                  // Yes there will be another NACK after this, so E1 will be 1
-                  evenNack = *it3;
-                  i.WriteU8( ((oddNack << 7) & 0x80)
-                   | (0x40)  // E1 = 1 E2 = 0, more NACKs
-                   | ( (evenNack >> 5) & 0x1F) );
-
-                  // The final octet of this loop will have the rest of the
-                  // NACK and another E1, E2. Check to see if there will be
-                  // one more NACK after this.
-                  it3++;
-                  if ( it3 != m_nackSnList.end () )
-                    {
-                      // Yes there is at least one more NACK. Finish writing
-                      // this octet and the next iteration will do the rest.
-                      oddNack = *it3;
-                      i.WriteU8 ( ((evenNack << 3) & 0xF8)
-                        | (0x04)
-                        | ((oddNack >> 9) & 0x01));
-                    }
-                  else
-                    {
-                      // No, there are no more NACKs
-                      i.WriteU8 ( ((evenNack << 3) & 0xF8) );
-                    }
-                }
-              else
-                {
-                  // No, this is the last NACK so E1 will be 0
-                  i.WriteU8 ( ((oddNack << 7) & 0x80) );
-                }
-            }
+          w.Write (*it3, m_snLength);
+          it3++;
+          w.Write (it3 != m_nackSnList.end (), 1);
+          w.Write (0, 1);
         }
-
+      w.Flush ();
     }
 }
 
@@ -522,15 +585,24 @@ uint32_t LteRlcAmHeader::Deserialize (Buffer::Iterator start)
 
   if ( m_dataControlBit == DATA_PDU )
     {
-      byte_2 = i.ReadU8 ();
+      if (m_snLength == 16)
+        {
+          m_sequenceNumber = i.ReadNtohU16 ();
+          m_headerLength += 2;
+        }
+      else
+        {
+          byte_2 = i.ReadU8 ();
+          m_sequenceNumber = ((byte_1 & 0x03) << 8) | byte_2;
+          m_headerLength += 1;
+        }
       byte_3 = i.ReadU8 ();
       byte_4 = i.ReadU8 ();
-      m_headerLength += 3;
+      m_headerLength += 2;
 
       m_resegmentationFlag = (byte_1 & 0x40) >> 6;
       m_pollingBit         = (byte_1 & 0x20) >> 5;
       m_framingInfo        = (byte_1 & 0x18) >> 3;
-      m_sequenceNumber     = ((byte_1 & 0x03) << 8) | byte_2;
 
       m_lastSegmentFlag    = (byte_3 & 0x80) >> 7;
       m_segmentOffset      = ((byte_3 & 0x7F) << 8) | byte_4;
@@ -582,70 +654,22 @@ uint32_t LteRlcAmHeader::Deserialize (Buffer::Iterator start)
     }
   else // if ( m_dataControlBit == CONTROL_PDU )
     {
-      byte_2 = i.ReadU8 ();
-
-      m_controlPduType = (byte_1 & 0x70) >> 4;
-      m_ackSn = ((byte_1 & 0x0F) << 6 ) | ((byte_2 & 0xFC) >> 2);
-
-      int moreNacks = (byte_2 & 0x02) >> 1;
-      // Get the first NACK outside the loop as it is not preceded by an E2
-      // field but all following NACKs will.
-      if ( moreNacks == 1 )
-        {
-          byte_3 = i.ReadU8 ();
-          byte_4 = i.ReadU8 ();
-          m_headerLength = 4;
-
-          m_nackSnList.push_back (
-            ((byte_2 & 0x01) << 9)
-            | (byte_3 << 1)
-            | ((byte_4 & 0x80) >> 7)
-          );
-
-         // Loop until all NACKs are found
-         moreNacks = ((byte_4 & 0x40) >> 6);
-         uint8_t byte = byte_4;
-         uint8_t nextByte;
-         uint8_t finalByte;
-         while (moreNacks == 1)
-           {
-             // Ignore E2, read next NACK
-             nextByte = i.ReadU8 ();
-             m_nackSnList.push_back (
-              ((byte & 0x1F) << 5)
-              | ((nextByte & 0xF8) >> 3)
-            );
-
-            // Check for another NACK, after this any following NACKs will
-            // be aligned properly for the next iteration of this loop.
-            moreNacks = (nextByte & 0x04) >> 2;
-            byte = nextByte;
-            if (moreNacks == 1)
-              {
-                nextByte = i.ReadU8 ();
-                finalByte = i.ReadU8 ();
-
-                 m_nackSnList.push_back (
-                   ((byte & 0x01) << 9)
-                   | (nextByte << 1)
-                   | ((finalByte & 0x80) >> 7)
-                 );
-
-                moreNacks = ((finalByte & 0x40) >> 6);
-                byte = finalByte;
-                m_headerLength+=3;
-              }
-            else
-              {
-                m_headerLength++;
-              }
-
-           }
-        }
-      else
+      // Read again from the start, since the fields are not byte aligned
+      i = start;
+      BitReader r (i);
+      r.Read (1);
+      m_controlPduType = r.Read (3);
+      m_ackSn = r.Read (m_snLength);
+
+      // Ignore E2, since SO start/end are not supported
+      bool moreNacks = r.Read (1);
+      while (moreNacks)
         {
-          m_headerLength++;
+          m_nackSnList.push_back (r.Read (m_snLength));
+          moreNacks = r.Read (1);
+          r.Read (1);
         }
+      m_headerLength = r.GetBytesRead ();
     }
 
   return GetSerializedSize ();
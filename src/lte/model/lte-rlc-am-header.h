@@ -48,6 +48,18 @@ public:
   LteRlcAmHeader ();
   ~LteRlcAmHeader ();
 
+  /**
+   * Set the length of the SNs, 10 bits by default. It must be set before
+   * the type of PDU, and before deserializing. With 16-bit SNs, the fixed
+   * part of the DATA PDU header is one byte longer, and the ACK_SN and
+   * NACK_SN fields of the STATUS PDU are 16 bits long.
+   *
+   * \param snLength the SN length in bits, 10 or 16
+   */
+  void SetSnLength (uint8_t snLength);
+  /// \return the SN length in bits
+  uint8_t GetSnLength (void) const;
+
   void SetDataPdu (void);
   void SetControlPdu (uint8_t controlPduType);
   bool IsDataPdu (void) const;
@@ -137,7 +149,9 @@ public:
   virtual uint32_t Deserialize (Buffer::Iterator start);
 
   /** 
-   * 
+   * With 16-bit SNs the exact STATUS PDU length is checked. With 10-bit
+   * SNs the historical estimate is kept, which may accept a STATUS PDU
+   * one byte larger than \p bytes.
    * 
    * \param bytes max allowed CONTROL PDU size
    * 
@@ -172,7 +186,14 @@ public:
 
 
 private:
+  /**
+   * \param nacks number of NACK_SN fields
+   * \return the length of a STATUS PDU with nacks NACK_SN fields
+   */
+  uint16_t GetStatusPduLength (uint32_t nacks) const;
+
   uint16_t m_headerLength;
+  uint8_t  m_snLength;
   uint8_t  m_dataControlBit;
 
   // Data PDU fields
@@ -21,6 +21,7 @@
 
 #include "ns3/simulator.h"
 #include "ns3/log.h"
+#include "ns3/abort.h"
 
 #include "ns3/lte-rlc-am-header.h"
 #include "ns3/lte-rlc-am.h"
@@ -41,17 +42,14 @@ LteRlcAm::LteRlcAm ()
   NS_LOG_FUNCTION (this);
 
   // Buffers
-  m_txonBufferSize = 0;
-  m_retxSegBuffer.resize (1024);
-  m_retxBuffer.resize (1024);
   m_retxBufferSize = 0;
-  m_txedBuffer.resize (1024);
   m_txedBufferSize = 0;
 
   m_statusPduRequested = false;
   m_statusPduBufferSize = 0;
 
   // State variables: transmitting side
+  m_snLength = 10;
   m_windowSize = 512;
   m_vtA  = 0;
   m_vtMs = m_vtA + m_windowSize;
@@ -118,6 +116,22 @@ LteRlcAm::GetTypeId (void)
                    TimeValue (MilliSeconds (20)),
                    MakeTimeAccessor (&LteRlcAm::m_rbsTimerValue),
                    MakeTimeChecker ())
+    .AddAttribute ("SnLength",
+                   "Length in bits of the SNs, 10 or 16 (See section 6.2.3.3 of 3GPP TS 36.322). "
+                   "The WindowSize is at most half the SN space. It can only be changed "
+                   "when no PDU is outstanding.",
+                   UintegerValue (10),
+                   MakeUintegerAccessor (&LteRlcAm::SetSnLength,
+                                         &LteRlcAm::GetSnLength),
+                   MakeUintegerChecker<uint8_t> (10, 16))
+    .AddAttribute ("WindowSize",
+                   "AM_Window_Size (See section 7.2 of 3GPP TS 36.322). The buffers of "
+                   "the PDUs waiting for an ACK and of the PDUs being received are sized "
+                   "after it. It can only be changed when no PDU is outstanding.",
+                   UintegerValue (512),
+                   MakeUintegerAccessor (&LteRlcAm::SetWindowSize,
+                                         &LteRlcAm::GetWindowSize),
+                   MakeUintegerChecker<uint16_t> (1, 32768))
     .AddAttribute ("TxOpportunityForRetxAlwaysBigEnough",
                    "If true, always pretend that the size of a TxOpportunity is big enough "
                    "for retransmission. If false (default and realistic behavior), no retx "
@@ -149,13 +163,12 @@ LteRlcAm::DoDispose ()
   m_statusProhibitTimer.Cancel ();
   m_rbsTimer.Cancel ();
 
-  m_txonBuffer.clear ();
-  m_txonBufferSize = 0;
-  m_txedBuffer.clear ();
+  m_txonBuffer.Clear ();
+  m_txedBuffer.Clear ();
   m_txedBufferSize = 0;
-  m_retxBuffer.clear ();
+  m_retxBuffer.Clear ();
   m_retxBufferSize = 0;
-  m_rxonBuffer.clear ();
+  m_rxonBuffer.Clear ();
   m_sdusBuffer.clear ();
   m_keepS0 = 0;
   m_controlPduBuffer = 0;
@@ -175,7 +188,7 @@ LteRlcAm::DoTransmitPdcpPdu (Ptr<Packet> p)
 
   if(m_enableAqm == false)
   {
-	  if (m_txonBufferSize + p->GetSize () <= m_maxTxBufferSize)
+	  if (m_txonBuffer.GetNBytes () + p->GetSize () <= m_maxTxBufferSize)
 	  {
 	  	 //Store arrival time
 	  	Time now = Simulator::Now ();
@@ -189,17 +202,16 @@ LteRlcAm::DoTransmitPdcpPdu (Ptr<Packet> p)
 	  	p->AddPacketTag (tag);
 
 	  	NS_LOG_LOGIC ("Txon Buffer: New packet added");
-	  	m_txonBuffer.push_back (p);
-	  	m_txonBufferSize += p->GetSize ();
-	  	NS_LOG_LOGIC ("NumOfBuffers = " << m_txonBuffer.size() );
-	  	NS_LOG_LOGIC ("txonBufferSize = " << m_txonBufferSize);
+	  	m_txonBuffer.PushBack (p);
+	  	NS_LOG_LOGIC ("NumOfBuffers = " << m_txonBuffer.GetNPackets () );
+	  	NS_LOG_LOGIC ("txonBufferSize = " << m_txonBuffer.GetNBytes ());
 	  }
 	  else
 	  {
 	  	// Discard full RLC SDU
 	  	NS_LOG_LOGIC ("TxBuffer is full. RLC SDU discarded");
 	  	NS_LOG_LOGIC ("MaxTxBufferSize = " << m_maxTxBufferSize);
-	  	NS_LOG_LOGIC ("txonBufferSize    = " << m_txonBufferSize);
+	  	NS_LOG_LOGIC ("txonBufferSize    = " << m_txonBuffer.GetNBytes ());
 	  	NS_LOG_LOGIC ("packet size     = " << p->GetSize ());
 	  }
   }
@@ -264,40 +276,40 @@ LteRlcAm::DoNotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId)
 
       Ptr<Packet> packet = Create<Packet> ();
       LteRlcAmHeader rlcAmHeader;
+      rlcAmHeader.SetSnLength (m_snLength);
       rlcAmHeader.SetControlPdu (LteRlcAmHeader::STATUS_PDU);
      
       NS_LOG_LOGIC ("Check for SNs to NACK from " << m_vrR.GetValue() << " to " << m_vrMs.GetValue());
       SequenceNumber10 sn;
       sn.SetModulusBase (m_vrR);
-      std::map<uint16_t, PduBuffer>::iterator pduIt;
-      for (sn = m_vrR; sn < m_vrMs; sn++) 
+      sn = m_vrR;
+      uint16_t remaining = (m_vrMs - m_vrR);
+      while (remaining > 0)
         {
-          NS_LOG_LOGIC ("SN = " << sn);          
+          // skip the PDUs whose byte segments have all been received
+          uint16_t complete = m_rxonBuffer.FindFirstUnset (sn.GetValue (), remaining);
+          sn = sn + complete;
+          remaining -= complete;
+          if (remaining == 0)
+            {
+              break;
+            }
+          NS_LOG_LOGIC ("SN = " << sn);
           if (!rlcAmHeader.OneMoreNackWouldFitIn (bytes))
             {
               NS_LOG_LOGIC ("Can't fit more NACKs in STATUS PDU");
               break;
-            }          
-          pduIt = m_rxonBuffer.find (sn.GetValue ());
-          if (pduIt == m_rxonBuffer.end () || (!(pduIt->second.m_pduComplete)))
-            {
-              NS_LOG_LOGIC ("adding NACK_SN " << sn.GetValue ());
-              rlcAmHeader.PushNack (sn.GetValue ());              
-            }          
-        }
-      NS_LOG_LOGIC ("SN at end of NACK loop = " << sn);
-      // 3GPP TS 36.322 section 6.2.2.1.4 ACK SN
-      // find the  SN of the next not received RLC Data PDU 
-      // which is not reported as missing in the STATUS PDU. 
-      pduIt = m_rxonBuffer.find (sn.GetValue ());
-      while ((sn < m_vrMs) && (pduIt != m_rxonBuffer.end ()) && (pduIt->second.m_pduComplete))            
-        {
-          NS_LOG_LOGIC ("SN = " << sn << " < " << m_vrMs << " = " << (sn < m_vrMs));
+            }
+          NS_LOG_LOGIC ("adding NACK_SN " << sn.GetValue ());
+          rlcAmHeader.PushNack (sn.GetValue ());
           sn++;
-          NS_LOG_LOGIC ("SN = " << sn);
-          pduIt = m_rxonBuffer.find (sn.GetValue ());
+          remaining--;
         }
-      
+      // 3GPP TS 36.322 section 6.2.2.1.4 ACK SN
+      // The SN of the next not received RLC Data PDU which is not reported
+      // as missing in the STATUS PDU: either VR(MS), or the first missing
+      // PDU which did not fit in the STATUS PDU
+      NS_LOG_LOGIC ("SN at end of NACK loop = " << sn);
       NS_ASSERT_MSG (sn <= m_vrMs, "first SN not reported as missing = " << sn << ", VR(MS) = " << m_vrMs);      
       rlcAmHeader.SetAckSn (sn); 
 
@@ -336,27 +348,29 @@ LteRlcAm::DoNotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId)
       SequenceNumber10 sn;
       sn.SetModulusBase (m_vtA);
       bool found = false;
-      for (sn = m_vtA; sn < m_vtS; sn++) 
+      // first PDU considered for retransmission
+      sn = m_vtA + m_retxBuffer.FindFirstSet (m_vtA.GetValue (), (m_vtS - m_vtA));
+      if (sn < m_vtS)
         {
           uint16_t seqNumberValue = sn.GetValue ();
-          NS_LOG_LOGIC ("SN = " << seqNumberValue << " m_pdu " << m_retxBuffer.at (seqNumberValue).m_pdu);
+          NS_LOG_LOGIC ("SN = " << seqNumberValue << " m_pdu " << m_retxBuffer.Get (seqNumberValue).m_pdu);
 
-          if (m_retxSegBuffer.at (seqNumberValue).m_lastSegSent)
+          if (m_retxBuffer.Get (seqNumberValue).m_lastSegSent)
           {
           	return; // all segments sent, need to wait for ACK or reorder timer to expire
           }
 
           Ptr<Packet> packet;
           bool segment = false;
-          if (m_retxSegBuffer.at (seqNumberValue).m_pdu != 0)
+          if (m_retxBuffer.Get (seqNumberValue).m_segment != 0)
           {
-          	packet = m_retxSegBuffer.at (seqNumberValue).m_pdu->Copy ();
+          	packet = m_retxBuffer.Get (seqNumberValue).m_segment->Copy ();
           	found = true;
           	segment = true;
           }
-          else if (m_retxBuffer.at (seqNumberValue).m_pdu != 0)
+          else
           {
-          	packet = m_retxBuffer.at (seqNumberValue).m_pdu->Copy ();
+          	packet = m_retxBuffer.Get (seqNumberValue).m_pdu->Copy ();
           	found = true;
           }
           if (found == true)
@@ -366,6 +380,7 @@ LteRlcAm::DoNotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId)
                 {
                   // According to 5.2.1, the data field is left as is, but we rebuild the header
                   LteRlcAmHeader rlcAmHeader;
+                  rlcAmHeader.SetSnLength (m_snLength);
                   packet->RemoveHeader (rlcAmHeader);
                   NS_LOG_LOGIC ("old AM RLC header: " << rlcAmHeader);
 
@@ -374,19 +389,19 @@ LteRlcAm::DoNotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId)
               			NS_LOG_INFO ("Sending last RLC PDU segment, sn= " << seqNumberValue << " offset= " << rlcAmHeader.GetSegmentOffset()
               																			 << " size= " << rlcAmHeader.GetLastOffset()-rlcAmHeader.GetSegmentOffset());
               			// opportunity is large enough to transmit remaining segment, so clear segment buffer
-              			m_retxSegBuffer.at(seqNumberValue).m_pdu = 0;
-              			m_retxSegBuffer.at(seqNumberValue).m_lastSegSent = true;
+              			m_retxBuffer.Get (seqNumberValue).m_segment = 0;
+              			m_retxBuffer.Get (seqNumberValue).m_lastSegSent = true;
               			rlcAmHeader.SetLastSegmentFlag (LteRlcAmHeader::LAST_PDU_SEGMENT);
               		}
 
                   // Calculate the Polling Bit (5.2.2.1)
                   rlcAmHeader.SetPollingBit (LteRlcAmHeader::STATUS_REPORT_NOT_REQUESTED);
 
-                  NS_LOG_LOGIC ("polling conditions: m_txonBuffer.empty=" << m_txonBuffer.empty ()
+                  NS_LOG_LOGIC ("polling conditions: m_txonBuffer.empty=" << m_txonBuffer.IsEmpty ()
                                 << " retxBufferSize="  << m_retxBufferSize
                                 << " packet->GetSize ()=" << packet->GetSize ());
                   //if (((m_txonBuffer.empty ()) && (m_retxBufferSize == packet->GetSize () + rlcAmHeader.GetSerializedSize ()))
-                  if (((m_txonBuffer.empty ()) && (m_txonQueue->GetNPackets ()==0) && (m_retxBufferSize == packet->GetSize () + rlcAmHeader.GetSerializedSize ()))
+                  if (((m_txonBuffer.IsEmpty ()) && (m_txonQueue->GetNPackets ()==0) && (m_retxBufferSize == packet->GetSize () + rlcAmHeader.GetSerializedSize ()))
                       || (m_vtS >= m_vtMs)
                       || m_pollRetransmitTimerJustExpired)
                     {
@@ -429,26 +444,23 @@ LteRlcAm::DoNotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId)
                   
                   m_macSapProvider->TransmitPdu (params);
 
-                  m_retxBuffer.at (seqNumberValue).m_retxCount++;
+                  RetxPdu& retx = m_retxBuffer.Get (seqNumberValue);
+                  retx.m_retxCount++;
                   NS_LOG_INFO ("Incr RETX_COUNT for SN = " << seqNumberValue);
-                  if (m_retxBuffer.at (seqNumberValue).m_retxCount >= m_maxRetxThreshold)
+                  if (retx.m_retxCount >= m_maxRetxThreshold)
                     {
                       NS_LOG_INFO ("Max RETX_COUNT for SN = " << seqNumberValue);
                     }
 
                   NS_LOG_INFO ("Move SN = " << seqNumberValue << " back to txedBuffer");
-                  m_txedBuffer.at (seqNumberValue).m_pdu = m_retxBuffer.at (seqNumberValue).m_pdu->Copy ();
-                  m_txedBuffer.at (seqNumberValue).m_retxCount = m_retxBuffer.at (seqNumberValue).m_retxCount;
-                  m_txedBufferSize += m_txedBuffer.at (seqNumberValue).m_pdu->GetSize ();
+                  m_txedBuffer.Get (seqNumberValue).m_pdu = retx.m_pdu;
+                  m_txedBuffer.Get (seqNumberValue).m_retxCount = retx.m_retxCount;
+                  m_txedBuffer.Set (seqNumberValue);
+                  m_txedBufferSize += retx.m_pdu->GetSize ();
 
-                  m_retxBufferSize -= m_retxBuffer.at (seqNumberValue).m_pdu->GetSize ();
-                  m_retxBuffer.at (seqNumberValue).m_pdu = 0;
-                  m_retxBuffer.at (seqNumberValue).m_retxCount = 0;
-                  
-                  // reset segment buffer
-                  m_retxSegBuffer.at (seqNumberValue).m_pdu = 0;
-                  m_retxSegBuffer.at (seqNumberValue).m_retxCount = 0;
-                  m_retxSegBuffer.at (seqNumberValue).m_lastSegSent = 0;
+                  // also resets the segment of the PDU
+                  m_retxBufferSize -= retx.m_pdu->GetSize ();
+                  m_retxBuffer.Reset (seqNumberValue);
 
                   NS_LOG_LOGIC ("retxBufferSize = " << m_retxBufferSize);
 
@@ -461,17 +473,18 @@ LteRlcAm::DoNotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId)
 //              		return;
 									// According to 5.2.1, the data field is left as is, but we rebuild the header
 									LteRlcAmHeader firstSegHdr;
+									firstSegHdr.SetSnLength (m_snLength);
 									packet->RemoveHeader (firstSegHdr);
 									NS_LOG_LOGIC ("old AM RLC header: " << firstSegHdr);
 
 									// Calculate the Polling Bit (5.2.2.1)
 									firstSegHdr.SetPollingBit (LteRlcAmHeader::STATUS_REPORT_NOT_REQUESTED);
 
-									NS_LOG_LOGIC ("polling conditions: m_txonBuffer.empty=" << m_txonBuffer.empty ()
+									NS_LOG_LOGIC ("polling conditions: m_txonBuffer.empty=" << m_txonBuffer.IsEmpty ()
 																<< " retxBufferSize="  << m_retxBufferSize
 																<< " packet->GetSize ()=" << packet->GetSize ());
 									//if (((m_txonBuffer.empty ()) && (m_retxBufferSize == packet->GetSize () + firstSegHdr.GetSerializedSize ()))
-									if (((m_txonBuffer.empty ()) && (m_txonQueue->GetNPackets () == 0) && (m_retxBufferSize == packet->GetSize () + firstSegHdr.GetSerializedSize ()))
+									if (((m_txonBuffer.IsEmpty ()) && (m_txonQueue->GetNPackets () == 0) && (m_retxBufferSize == packet->GetSize () + firstSegHdr.GetSerializedSize ()))
 											|| (m_vtS >= m_vtMs)
 											|| m_pollRetransmitTimerJustExpired)
 									{
@@ -535,7 +548,7 @@ LteRlcAm::DoNotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId)
 								  nextSeg->AddHeader (nextSegHdr);
 
 								  // add next segment to reTX segment buffer
-								  m_retxSegBuffer.at (seqNumberValue).m_pdu = nextSeg;
+								  m_retxBuffer.Get (seqNumberValue).m_segment = nextSeg;
 
 									NS_LOG_LOGIC ("new AM RLC header: " << firstSegHdr);
 
@@ -557,24 +570,6 @@ LteRlcAm::DoNotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId)
 
 									m_macSapProvider->TransmitPdu (params);
 
-									//m_retxSegBuffer.at (seqNumberValue).m_pdu
-
-//									m_retxBuffer.at (seqNumberValue).m_retxCount++;
-//									NS_LOG_INFO ("Incr RETX_COUNT for SN = " << seqNumberValue);
-//									if (m_retxBuffer.at (seqNumberValue).m_retxCount >= m_maxRetxThreshold)
-//									{
-//										NS_LOG_INFO ("Max RETX_COUNT for SN = " << seqNumberValue);
-//									}
-//
-//									NS_LOG_INFO ("Move SN = " << seqNumberValue << " back to txedBuffer");
-//									m_txedBuffer.at (seqNumberValue).m_pdu = m_retxBuffer.at (seqNumberValue).m_pdu->Copy ();
-//									m_txedBuffer.at (seqNumberValue).m_retxCount = m_retxBuffer.at (seqNumberValue).m_retxCount;
-//									m_txedBufferSize += m_txedBuffer.at (seqNumberValue).m_pdu->GetSize ();
-//
-//									m_retxBufferSize -= m_retxBuffer.at (seqNumberValue).m_pdu->GetSize ();
-//									m_retxBuffer.at (seqNumberValue).m_pdu = 0;
-//									m_retxBuffer.at (seqNumberValue).m_retxCount = 0;
-
 									NS_LOG_LOGIC ("retxBufferSize = " << m_retxBufferSize);
 
 									return;
@@ -584,7 +579,7 @@ LteRlcAm::DoNotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId)
       NS_ASSERT_MSG (found, "m_retxBufferSize > 0, but no PDU considered for retx found");
     }
   //else if ( m_txonBufferSize > 0 )
-  else if ( m_txonBufferSize + m_txonQueue->GetNBytes () > 0 )
+  else if ( m_txonBuffer.GetNBytes () + m_txonQueue->GetNBytes () > 0 )
     {
       if (bytes < 7)
       {
@@ -618,10 +613,11 @@ LteRlcAm::DoNotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId)
 
   Ptr<Packet> packet = Create<Packet> ();
   LteRlcAmHeader rlcAmHeader;
+  rlcAmHeader.SetSnLength (m_snLength);
   rlcAmHeader.SetDataPdu ();
 
   // Build Data field
-  uint32_t nextSegmentSize = bytes - 4;
+  uint32_t nextSegmentSize = bytes - rlcAmHeader.GetSerializedSize ();
   uint32_t nextSegmentId = 1;
   uint32_t dataFieldTotalSize = 0;
   uint32_t dataFieldAddedSize = 0;
@@ -630,31 +626,27 @@ LteRlcAm::DoNotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId)
   // Remove the first packet from the transmission buffer.
   // If only a segment of the packet is taken, then the remaining is given back later
   //if ( m_txonBuffer.size () == 0 )
-  if ( m_txonBuffer.size () + m_txonQueue->GetNPackets() == 0 )
+  if ( m_txonBuffer.GetNPackets () + m_txonQueue->GetNPackets() == 0 )
 
     {
       NS_LOG_LOGIC ("No data pending");
       return;
     }
 
-  NS_LOG_LOGIC ("SDUs in TxonBuffer  = " << m_txonBuffer.size ());
-  NS_LOG_LOGIC ("First SDU buffer  = " << *(m_txonBuffer.begin()));
-  NS_LOG_LOGIC ("First SDU size    = " << (*(m_txonBuffer.begin()))->GetSize ());
-  NS_LOG_LOGIC ("Next segment size = " << nextSegmentSize);
-  NS_LOG_LOGIC ("Remove SDU from TxBuffer");
-
-  if (m_txonBuffer.empty())
+  if (m_txonBuffer.IsEmpty ())
   {
 	  Ptr<Packet> tempP = m_txonQueue->Dequeue()->GetPacket();
-	  m_txonBuffer.push_back (tempP);
-	  m_txonBufferSize += tempP->GetSize ();
-
+	  m_txonBuffer.PushBack (tempP);
   }
 
-  Ptr<Packet> firstSegment = (*(m_txonBuffer.begin ()))->Copy ();
-  m_txonBufferSize -= (*(m_txonBuffer.begin()))->GetSize ();
-  NS_LOG_LOGIC ("txBufferSize      = " << m_txonBufferSize );
-  m_txonBuffer.erase (m_txonBuffer.begin ());
+  NS_LOG_LOGIC ("SDUs in TxonBuffer  = " << m_txonBuffer.GetNPackets ());
+  NS_LOG_LOGIC ("First SDU buffer  = " << m_txonBuffer.Front ());
+  NS_LOG_LOGIC ("First SDU size    = " << m_txonBuffer.Front ()->GetSize ());
+  NS_LOG_LOGIC ("Next segment size = " << nextSegmentSize);
+  NS_LOG_LOGIC ("Remove SDU from TxBuffer");
+
+  Ptr<Packet> firstSegment = m_txonBuffer.PopFront ()->Copy ();
+  NS_LOG_LOGIC ("txBufferSize      = " << m_txonBuffer.GetNBytes () );
 
   while ( firstSegment && (firstSegment->GetSize () > 0) && (nextSegmentSize > 0) )
     {
@@ -702,20 +694,12 @@ LteRlcAm::DoNotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId)
             {
               firstSegment->AddPacketTag (oldTag);
 
-              if(m_txonBuffer.empty())
-              {
-            	  m_txonBuffer.push_back(firstSegment);
-              }
-              else
-              {
-                  m_txonBuffer.insert (m_txonBuffer.begin (), firstSegment);
-              }
-              m_txonBufferSize += (*(m_txonBuffer.begin()))->GetSize ();
+              m_txonBuffer.PushFront (firstSegment);
 
               NS_LOG_LOGIC ("    Txon buffer: Give back the remaining segment");
-              NS_LOG_LOGIC ("    Txon buffers = " << m_txonBuffer.size ());
-              NS_LOG_LOGIC ("    Front buffer size = " << (*(m_txonBuffer.begin()))->GetSize ());
-              NS_LOG_LOGIC ("    txonBufferSize = " << m_txonBufferSize );
+              NS_LOG_LOGIC ("    Txon buffers = " << m_txonBuffer.GetNPackets ());
+              NS_LOG_LOGIC ("    Front buffer size = " << m_txonBuffer.Front ()->GetSize ());
+              NS_LOG_LOGIC ("    txonBufferSize = " << m_txonBuffer.GetNBytes () );
             }
           else
             {
@@ -756,7 +740,7 @@ LteRlcAm::DoNotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId)
           // break;
         }
       //else if ( (nextSegmentSize - firstSegment->GetSize () <= 2) || (m_txonBuffer.size () == 0) )
-      else if ( (nextSegmentSize - firstSegment->GetSize () <= 2) || (m_txonBuffer.size () + m_txonQueue->GetNPackets () == 0) )
+      else if ( (nextSegmentSize - firstSegment->GetSize () <= 2) || (m_txonBuffer.GetNPackets () + m_txonQueue->GetNPackets () == 0) )
 
         {
           NS_LOG_LOGIC ("    IF nextSegmentSize - firstSegment->GetSize () <= 2 || txonBuffer.size == 0");
@@ -775,12 +759,12 @@ LteRlcAm::DoNotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId)
           nextSegmentSize -= dataFieldAddedSize;
           nextSegmentId++;
 
-          NS_LOG_LOGIC ("        SDUs in TxBuffer  = " << m_txonBuffer.size ());
+          NS_LOG_LOGIC ("        SDUs in TxBuffer  = " << m_txonBuffer.GetNPackets ());
           //if (m_txonBuffer.size () > 0)
-          if (m_txonBuffer.size () + m_txonQueue->GetNPackets () > 0)
+          if (! m_txonBuffer.IsEmpty ())
             {
-              NS_LOG_LOGIC ("        First SDU buffer  = " << *(m_txonBuffer.begin()));
-              NS_LOG_LOGIC ("        First SDU size    = " << (*(m_txonBuffer.begin()))->GetSize ());
+              NS_LOG_LOGIC ("        First SDU buffer  = " << m_txonBuffer.Front ());
+              NS_LOG_LOGIC ("        First SDU size    = " << m_txonBuffer.Front ()->GetSize ());
             }
           NS_LOG_LOGIC ("        Next segment size = " << nextSegmentSize);
 
@@ -806,29 +790,26 @@ LteRlcAm::DoNotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId)
           nextSegmentSize -= ((nextSegmentId % 2) ? (2) : (1)) + dataFieldAddedSize;
           nextSegmentId++;
 
-          NS_LOG_LOGIC ("        SDUs in TxBuffer  = " << m_txonBuffer.size ());
+          NS_LOG_LOGIC ("        SDUs in TxBuffer  = " << m_txonBuffer.GetNPackets ());
           //if (m_txonBuffer.size () > 0)
-          if (m_txonBuffer.size () + m_txonQueue->GetNPackets () > 0)
+          if (! m_txonBuffer.IsEmpty ())
             {
-              NS_LOG_LOGIC ("        First SDU buffer  = " << *(m_txonBuffer.begin()));
-              NS_LOG_LOGIC ("        First SDU size    = " << (*(m_txonBuffer.begin()))->GetSize ());
+              NS_LOG_LOGIC ("        First SDU buffer  = " << m_txonBuffer.Front ());
+              NS_LOG_LOGIC ("        First SDU size    = " << m_txonBuffer.Front ()->GetSize ());
             }
           NS_LOG_LOGIC ("        Next segment size = " << nextSegmentSize);
           NS_LOG_LOGIC ("        Remove SDU from TxBuffer");
 
           // (more segments)
 
-          if(m_txonBuffer.empty())
+          if(m_txonBuffer.IsEmpty ())
           {
         	  Ptr<Packet> tempP = m_txonQueue->Dequeue()->GetPacket();
-        	  m_txonBuffer.push_back (tempP);
-        	  m_txonBufferSize += tempP->GetSize ();
+        	  m_txonBuffer.PushBack (tempP);
           }
 
-          firstSegment = (*(m_txonBuffer.begin ()))->Copy ();
-          m_txonBufferSize -= (*(m_txonBuffer.begin()))->GetSize ();
-          m_txonBuffer.erase (m_txonBuffer.begin ());
-          NS_LOG_LOGIC ("        txBufferSize = " << m_txonBufferSize );
+          firstSegment = m_txonBuffer.PopFront ()->Copy ();
+          NS_LOG_LOGIC ("        txBufferSize = " << m_txonBuffer.GetNBytes () );
         }
 
     }
@@ -901,12 +882,12 @@ LteRlcAm::DoNotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId)
   NS_LOG_LOGIC ("BYTE_WITHOUT_POLL = " << m_byteWithoutPoll);
 
   /*if ( (m_pduWithoutPoll >= m_pollPdu) || (m_byteWithoutPoll >= m_pollByte) ||
-       ( (m_txonBuffer.empty ()) && (m_retxBufferSize == 0) ) ||
+       ( (m_txonBuffer.IsEmpty ()) && (m_retxBufferSize == 0) ) ||
        (m_vtS >= m_vtMs)
        || m_pollRetransmitTimerJustExpired
      )*/
   if ( (m_pduWithoutPoll >= m_pollPdu) || (m_byteWithoutPoll >= m_pollByte) ||
-       ( (m_txonBuffer.empty ()) && (m_txonQueue->GetNPackets () == 0) && (m_retxBufferSize == 0) ) ||
+       ( (m_txonBuffer.IsEmpty ()) && (m_txonQueue->GetNPackets () == 0) && (m_retxBufferSize == 0) ) ||
        (m_vtS >= m_vtMs)
        || m_pollRetransmitTimerJustExpired
      )
@@ -944,8 +925,9 @@ LteRlcAm::DoNotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId)
   // Store new PDU into the Transmitted PDU Buffer
   NS_LOG_LOGIC ("Put transmitted PDU in the txedBuffer");
   m_txedBufferSize += packet->GetSize ();
-  m_txedBuffer.at ( rlcAmHeader.GetSequenceNumber ().GetValue () ).m_pdu = packet->Copy ();
-  m_txedBuffer.at ( rlcAmHeader.GetSequenceNumber ().GetValue () ).m_retxCount = 0;
+  m_txedBuffer.Get ( rlcAmHeader.GetSequenceNumber ().GetValue () ).m_pdu = packet->Copy ();
+  m_txedBuffer.Get ( rlcAmHeader.GetSequenceNumber ().GetValue () ).m_retxCount = 0;
+  m_txedBuffer.Set ( rlcAmHeader.GetSequenceNumber ().GetValue () );
 
   // Sender timestamp
   RlcTag rlcTag (Simulator::Now ());
@@ -963,6 +945,80 @@ LteRlcAm::DoNotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId)
   m_macSapProvider->TransmitPdu (params);
 }
 
+void
+LteRlcAm::MoveTxedToRetx (uint16_t sn)
+{
+  NS_LOG_INFO ("Move SN = " << sn << " to retxBuffer");
+  NS_ASSERT (m_txedBuffer.IsSet (sn));
+  RetxPdu& txed = m_txedBuffer.Get (sn);
+  RetxPdu& retx = m_retxBuffer.Get (sn);
+  // the PDU is never modified in place: a copy is made before each (re)transmission
+  retx.m_pdu = txed.m_pdu;
+  retx.m_retxCount = txed.m_retxCount;
+  m_retxBuffer.Set (sn);
+  m_retxBufferSize += retx.m_pdu->GetSize ();
+
+  m_txedBufferSize -= txed.m_pdu->GetSize ();
+  m_txedBuffer.Reset (sn);
+}
+
+void
+LteRlcAm::SetSnLength (uint8_t snLength)
+{
+  NS_LOG_FUNCTION (this << (uint16_t) snLength);
+  NS_ABORT_MSG_IF (snLength != 10 && snLength != 16, "the SN length must be 10 or 16 bits");
+  NS_ABORT_MSG_IF (m_vtS != m_vtA || m_vrH != m_vrR,
+                   "the SN length cannot change while PDUs are outstanding");
+  m_snLength = snLength;
+  m_vtA.SetLength (snLength);
+  m_vtMs.SetLength (snLength);
+  m_vtS.SetLength (snLength);
+  m_pollSn.SetLength (snLength);
+  m_vrR.SetLength (snLength);
+  m_vrMr.SetLength (snLength);
+  m_vrX.SetLength (snLength);
+  m_vrMs.SetLength (snLength);
+  m_vrH.SetLength (snLength);
+  m_expectedSeqNumber.SetLength (snLength);
+  // a window larger than half the SN space is reduced
+  SetWindowSize (std::min<uint32_t> (m_windowSize, 1u << (snLength - 1)));
+}
+
+uint8_t
+LteRlcAm::GetSnLength (void) const
+{
+  return m_snLength;
+}
+
+void
+LteRlcAm::SetWindowSize (uint16_t windowSize)
+{
+  NS_LOG_FUNCTION (this << windowSize);
+  NS_ABORT_MSG_IF (m_vtS != m_vtA || m_vrH != m_vrR,
+                   "the window size cannot change while PDUs are outstanding");
+  NS_ABORT_MSG_IF (windowSize > (1u << (m_snLength - 1)),
+                   "the window size is larger than half the SN space");
+  m_windowSize = windowSize;
+  m_vtMs = m_vtA + m_windowSize;
+  m_vrMr = m_vrR + m_windowSize;
+
+  // twice the window, so that the SNs of the window never share a slot
+  uint32_t size = 1;
+  while (size < 2 * static_cast<uint32_t> (windowSize))
+    {
+      size *= 2;
+    }
+  m_txedBuffer.SetSize (size);
+  m_retxBuffer.SetSize (size);
+  m_rxonBuffer.SetSize (size);
+}
+
+uint16_t
+LteRlcAm::GetWindowSize (void) const
+{
+  return m_windowSize;
+}
+
 void
 LteRlcAm::DoNotifyHarqDeliveryFailure ()
 {
@@ -979,18 +1035,11 @@ LteRlcAm::DoNotifyDlHarqDeliveryFailure (uint8_t harqId)
 	NS_ASSERT (it != m_harqIdToSnMap.end ());
 
 	uint16_t seqNumberValue = it->second;
-	if (m_txedBuffer.at (seqNumberValue).m_pdu != 0)
+	if (m_txedBuffer.IsSet (seqNumberValue))
 	{
-		NS_LOG_INFO ("Move SN = " << seqNumberValue << " to retxBuffer");
-		m_retxBuffer.at (seqNumberValue).m_pdu = m_txedBuffer.at (seqNumberValue).m_pdu->Copy ();
-		m_retxBuffer.at (seqNumberValue).m_retxCount = m_txedBuffer.at (seqNumberValue).m_retxCount;
-		m_retxBufferSize += m_retxBuffer.at (seqNumberValue).m_pdu->GetSize ();
-
-		m_txedBufferSize -= m_txedBuffer.at (seqNumberValue).m_pdu->GetSize ();
-		m_txedBuffer.at (seqNumberValue).m_pdu = 0;
-		m_txedBuffer.at (seqNumberValue).m_retxCount = 0;
+		MoveTxedToRetx (seqNumberValue);
 	}
-	NS_ASSERT (m_retxBuffer.at (seqNumberValue).m_pdu != 0);
+	NS_ASSERT (m_retxBuffer.IsSet (seqNumberValue));
 */
 }
 
@@ -1017,6 +1066,7 @@ LteRlcAm::DoReceivePdu (Ptr<Packet> p)
 
   // Get RLC header parameters
   LteRlcAmHeader rlcAmHeader;
+  rlcAmHeader.SetSnLength (m_snLength);
   p->PeekHeader (rlcAmHeader);
   NS_LOG_LOGIC ("RLC header: " << rlcAmHeader);
 
@@ -1133,10 +1183,9 @@ LteRlcAm::DoReceivePdu (Ptr<Packet> p)
           //         - discard the duplicate byte segments.
           // note: re-segmentation of AMD PDU is currently not supported, 
           // so we just check that the segment was not received before
-          std::map <uint16_t, PduBuffer>::iterator it = m_rxonBuffer.find (seqNumber.GetValue ());
-          if (it != m_rxonBuffer.end () )
+          PduBuffer& pduBuffer = m_rxonBuffer.Get (seqNumber.GetValue ());
+          if (!pduBuffer.m_byteSegments.empty ())
             {
-              NS_ASSERT (it->second.m_byteSegments.size () > 0);
               //NS_ASSERT_MSG (it->second.m_byteSegments.size () == 1, "re-segmentation not supported");
               NS_LOG_LOGIC ("Received duplicate SN");
 
@@ -1145,8 +1194,8 @@ LteRlcAm::DoReceivePdu (Ptr<Packet> p)
                 NS_LOG_LOGIC ("Received PDU segment");
               	//unsigned totalBytes = 0;
               	std::list < Ptr<Packet> >::iterator itSeg;
-//              	for (itSeg = it->second.m_byteSegments.begin ();
-//              			itSeg != it->second.m_byteSegments.end (); itSeg++)
+//              	for (itSeg = pduBuffer.m_byteSegments.begin ();
+//              			itSeg != pduBuffer.m_byteSegments.end (); itSeg++)
 //              	{
 //              		totalBytes += (*itSeg)->GetSize ();
 //              	}
@@ -1154,38 +1203,40 @@ LteRlcAm::DoReceivePdu (Ptr<Packet> p)
               	NS_LOG_INFO ("RLC AM PDU segment received, offset= " << rlcAmHeader.GetSegmentOffset() <<
 															 " size= " << rlcAmHeader.GetLastOffset()-rlcAmHeader.GetSegmentOffset());
               	LteRlcAmHeader lastSegHdr;
-              	it->second.m_byteSegments.back ()->PeekHeader (lastSegHdr);
+              	lastSegHdr.SetSnLength (m_snLength);
+              	pduBuffer.m_byteSegments.back ()->PeekHeader (lastSegHdr);
               	if(rlcAmHeader.GetSegmentOffset() == lastSegHdr.GetLastOffset () || rlcAmHeader.GetSegmentOffset() + 32768 == lastSegHdr.GetLastOffset ())
               	{
               		// segment is next in sequence
-              		it->second.m_byteSegments.push_back (p);
+              		pduBuffer.m_byteSegments.push_back (p);
               		if (rlcAmHeader.GetLastSegmentFlag () == LteRlcAmHeader::LAST_PDU_SEGMENT)
               		{
               			// got last segment, reassemble segments
-              			it->second.m_pduComplete = true;
-              			NS_ASSERT (it->second.m_byteSegments.size () > 1);
-              			itSeg = it->second.m_byteSegments.begin ();
+              			m_rxonBuffer.Set (seqNumber.GetValue ());
+              			NS_ASSERT (pduBuffer.m_byteSegments.size () > 1);
+              			itSeg = pduBuffer.m_byteSegments.begin ();
               			itSeg++;
-              			for (; itSeg != it->second.m_byteSegments.end (); itSeg++)
+              			for (; itSeg != pduBuffer.m_byteSegments.end (); itSeg++)
               			{
               				LteRlcAmHeader segHdr;
+              				segHdr.SetSnLength (m_snLength);
               				(*itSeg)->RemoveHeader (segHdr);
                     	//totalBytes = segHdr.PopLengthIndicator ();
-              				it->second.m_byteSegments.front ()->AddAtEnd (*itSeg);
+              				pduBuffer.m_byteSegments.front ()->AddAtEnd (*itSeg);
               			}
               			// now delete all fragments after the first whole data field
-              			itSeg = it->second.m_byteSegments.begin ();
+              			itSeg = pduBuffer.m_byteSegments.begin ();
               			itSeg++;
-            				it->second.m_byteSegments.erase (itSeg, it->second.m_byteSegments.end ());
+            				pduBuffer.m_byteSegments.erase (itSeg, pduBuffer.m_byteSegments.end ());
               		}
               	}
               	else
               	{
               		// out of order segment, discard both received packet and buffered
-              		//it->second.m_byteSegments.clear ();
-          			if(it->second.m_pduComplete == false)
+              		//pduBuffer.m_byteSegments.clear ();
+          			if (!m_rxonBuffer.IsSet (seqNumber.GetValue ()))
           			{
-                  		m_rxonBuffer.erase (it);
+                  		m_rxonBuffer.Reset (seqNumber.GetValue ());
                         NS_LOG_LOGIC ("PDU segment received out of order, discarding");
           		    }
               	}
@@ -1197,17 +1248,16 @@ LteRlcAm::DoReceivePdu (Ptr<Packet> p)
 				{
         		  NS_LOG_LOGIC ("Place PDU in the reception buffer ( SN = " << seqNumber << " )");
 
-				  m_rxonBuffer[ seqNumber.GetValue () ].m_byteSegments.push_back (p);
+				  pduBuffer.m_byteSegments.push_back (p);
 				  if(rlcAmHeader.GetResegmentationFlag () == LteRlcAmHeader::SEGMENT)
 				  {
 					NS_LOG_INFO ("RLC AM PDU segment received, offset= " << rlcAmHeader.GetSegmentOffset() <<
 																				 " size= " << rlcAmHeader.GetLastOffset()-rlcAmHeader.GetSegmentOffset());
 					// received segment
-					m_rxonBuffer[ seqNumber.GetValue () ].m_pduComplete = false;
 				  }
 				  else
 				  {
-					m_rxonBuffer[ seqNumber.GetValue () ].m_pduComplete = true;
+					m_rxonBuffer.Set (seqNumber.GetValue ());
 				  }
 				}
             }
@@ -1230,20 +1280,10 @@ LteRlcAm::DoReceivePdu (Ptr<Packet> p)
       //     - update VR(MS) to the SN of the first AMD PDU with SN > current VR(MS) for
       //       which not all byte segments have been received;
 
-      std::map <uint16_t, PduBuffer>::iterator it = m_rxonBuffer.find (m_vrMs.GetValue ());
-      if ( it != m_rxonBuffer.end () &&
-           it->second.m_pduComplete )
+      if ( m_rxonBuffer.IsSet (m_vrMs.GetValue ()) )
         {
-          int firstVrMs = m_vrMs.GetValue ();
-          while ( it != m_rxonBuffer.end () &&
-                  it->second.m_pduComplete )
-            {
-              m_vrMs++;
-              it = m_rxonBuffer.find (m_vrMs.GetValue ());
-              NS_LOG_LOGIC ("Incr VR(MS) = " << m_vrMs);
-
-              NS_ASSERT_MSG (firstVrMs != m_vrMs.GetValue (), "Infinite loop in RxonBuffer");
-            }
+          // VR(MS) < VR(MR), whose PDU is never complete
+          m_vrMs = m_vrMs + m_rxonBuffer.FindFirstUnset (m_vrMs.GetValue (), (m_vrMr - m_vrMs));
           NS_LOG_LOGIC ("New VR(MS) = " << m_vrMs);
         }
 
@@ -1255,27 +1295,23 @@ LteRlcAm::DoReceivePdu (Ptr<Packet> p)
 
       if ( seqNumber == m_vrR )
         {
-          std::map <uint16_t, PduBuffer>::iterator it = m_rxonBuffer.find (seqNumber.GetValue ());
-          if ( it != m_rxonBuffer.end () &&
-               it->second.m_pduComplete )
+          if ( m_rxonBuffer.IsSet (seqNumber.GetValue ()) )
             {
-              it = m_rxonBuffer.find (m_vrR.GetValue ());
               int firstVrR = m_vrR.GetValue ();
-              while ( it != m_rxonBuffer.end () &&
-                      it->second.m_pduComplete )
+              while ( m_rxonBuffer.IsSet (m_vrR.GetValue ()) )
                 {
                   NS_LOG_LOGIC ("Reassemble and Deliver ( SN = " << m_vrR << " )");
-                  NS_ASSERT_MSG (it->second.m_byteSegments.size () == 1,
+                  PduBuffer& pduBuffer = m_rxonBuffer.Get (m_vrR.GetValue ());
+                  NS_ASSERT_MSG (pduBuffer.m_byteSegments.size () == 1,
 																 "Too many segments. PDU Reassembly process didn't work");
-                  ReassembleAndDeliver (it->second.m_byteSegments.front ());
-                  m_rxonBuffer.erase (m_vrR.GetValue ());
+                  ReassembleAndDeliver (pduBuffer.m_byteSegments.front ());
+                  m_rxonBuffer.Reset (m_vrR.GetValue ());
 
                   m_vrR++;
                   m_vrR.SetModulusBase (m_vrR);
                   m_vrX.SetModulusBase (m_vrR);
                   m_vrMs.SetModulusBase (m_vrR);
                   m_vrH.SetModulusBase (m_vrR);
-                  it = m_rxonBuffer.find (m_vrR.GetValue ());
 
                   NS_ASSERT_MSG (firstVrR != m_vrR.GetValue (), "Infinite loop in RxonBuffer");
                 }
@@ -1362,44 +1398,32 @@ LteRlcAm::DoReceivePdu (Ptr<Packet> p)
 
               incrementVtA = false;
 
-              if (m_txedBuffer.at (seqNumberValue).m_pdu != 0)
+              if (m_txedBuffer.IsSet (seqNumberValue))
                 {
-                  NS_LOG_INFO ("Move SN = " << seqNumberValue << " to retxBuffer");
-                  m_retxBuffer.at (seqNumberValue).m_pdu = m_txedBuffer.at (seqNumberValue).m_pdu->Copy ();
-                  m_retxBuffer.at (seqNumberValue).m_retxCount = m_txedBuffer.at (seqNumberValue).m_retxCount;
-                  m_retxBufferSize += m_retxBuffer.at (seqNumberValue).m_pdu->GetSize ();
-
-                  m_txedBufferSize -= m_txedBuffer.at (seqNumberValue).m_pdu->GetSize ();
-                  m_txedBuffer.at (seqNumberValue).m_pdu = 0;
-                  m_txedBuffer.at (seqNumberValue).m_retxCount = 0;
+                  MoveTxedToRetx (seqNumberValue);
                 }
 
-              NS_ASSERT (m_retxBuffer.at (seqNumberValue).m_pdu != 0);
+              NS_ASSERT (m_retxBuffer.IsSet (seqNumberValue));
               
             }
           else
             {
               NS_LOG_LOGIC ("sn " << sn << " is ACKed");
 
-              if (m_txedBuffer.at (seqNumberValue).m_pdu)
+              if (m_txedBuffer.IsSet (seqNumberValue))
                 {
                   NS_LOG_INFO ("ACKed SN = " << seqNumberValue << " from txedBuffer");
-                  //               NS_LOG_INFO ("m_txedBuffer( " << m_vtA << " )->GetSize = " << m_txedBuffer.at (m_vtA.GetValue ())->GetSize ());
-                  m_txedBufferSize -= m_txedBuffer.at (seqNumberValue).m_pdu->GetSize ();
-                  m_txedBuffer.at (seqNumberValue).m_pdu = 0;
-                  NS_ASSERT (m_retxBuffer.at (seqNumberValue).m_pdu == 0);
+                  m_txedBufferSize -= m_txedBuffer.Get (seqNumberValue).m_pdu->GetSize ();
+                  m_txedBuffer.Reset (seqNumberValue);
+                  NS_ASSERT (!m_retxBuffer.IsSet (seqNumberValue));
                 }
 
-              if (m_retxBuffer.at (seqNumberValue).m_pdu)
+              if (m_retxBuffer.IsSet (seqNumberValue))
                 {
                   NS_LOG_INFO ("ACKed SN = " << seqNumberValue << " from retxBuffer");
-                  m_retxBufferSize -= m_retxBuffer.at (seqNumberValue).m_pdu->GetSize ();
-                  m_retxBuffer.at (seqNumberValue).m_pdu = 0;
-                  m_retxBuffer.at (seqNumberValue).m_retxCount = 0;
-                  // reset segment buffer
-                  m_retxSegBuffer.at (seqNumberValue).m_pdu = 0;
-                  m_retxSegBuffer.at (seqNumberValue).m_retxCount = 0;
-                  m_retxSegBuffer.at (seqNumberValue).m_lastSegSent = 0;
+                  // also resets the segment of the PDU
+                  m_retxBufferSize -= m_retxBuffer.Get (seqNumberValue).m_pdu->GetSize ();
+                  m_retxBuffer.Reset (seqNumberValue);
                 }
 
             }
@@ -1461,6 +1485,7 @@ void
 LteRlcAm::ReassembleAndDeliver (Ptr<Packet> packet)
 {
   LteRlcAmHeader rlcAmHeader;
+  rlcAmHeader.SetSnLength (m_snLength);
   packet->RemoveHeader (rlcAmHeader);
   uint8_t framingInfo = rlcAmHeader.GetFramingInfo ();
   SequenceNumber10 currSeqNumber = rlcAmHeader.GetSequenceNumber ();
@@ -1882,7 +1907,7 @@ LteRlcAm::DoReportBufferStatus (void)
 
   Time now = Simulator::Now ();
 
-  NS_LOG_LOGIC ("txonBufferSize = " << m_txonBufferSize);
+  NS_LOG_LOGIC ("txonBufferSize = " << m_txonBuffer.GetNBytes ());
   NS_LOG_LOGIC ("retxBufferSize = " << m_retxBufferSize);
   NS_LOG_LOGIC ("txedBufferSize = " << m_txedBufferSize);
   NS_LOG_LOGIC ("VT(A) = " << m_vtA);
@@ -1891,16 +1916,16 @@ LteRlcAm::DoReportBufferStatus (void)
   // Transmission Queue HOL time
   Time txonQueueHolDelay (0);
   //if ( m_txonBufferSize > 0 )
-  if ( m_txonBufferSize + m_txonQueue->GetNBytes() > 0 )
+  if ( m_txonBuffer.GetNBytes () + m_txonQueue->GetNBytes() > 0 )
     {
       RlcTag txonQueueHolTimeTag;
-      if (m_txonBuffer.empty())
+      if (m_txonBuffer.IsEmpty ())
       {
     	  m_txonQueue->Peek ()->GetPacket()->PeekPacketTag (txonQueueHolTimeTag);
       }
       else
       {
-          m_txonBuffer.front ()->PeekPacketTag (txonQueueHolTimeTag);
+          m_txonBuffer.Front ()->PeekPacketTag (txonQueueHolTimeTag);
       }
       txonQueueHolDelay = now - txonQueueHolTimeTag.GetSenderTimestamp ();
     }
@@ -1910,13 +1935,13 @@ LteRlcAm::DoReportBufferStatus (void)
   RlcTag retxQueueHolTimeTag;
   if ( m_retxBufferSize > 0 )
     {
-      if (m_retxBuffer.at (m_vtA.GetValue ()).m_pdu != 0)
+      if (m_retxBuffer.IsSet (m_vtA.GetValue ()))
         {
-          m_retxBuffer.at (m_vtA.GetValue ()).m_pdu->PeekPacketTag (retxQueueHolTimeTag);
+          m_retxBuffer.Get (m_vtA.GetValue ()).m_pdu->PeekPacketTag (retxQueueHolTimeTag);
         }
       else
         {
-          m_txedBuffer.at (m_vtA.GetValue ()).m_pdu->PeekPacketTag (retxQueueHolTimeTag);
+          m_txedBuffer.Get (m_vtA.GetValue ()).m_pdu->PeekPacketTag (retxQueueHolTimeTag);
         }      
       retxQueueHolDelay = now - retxQueueHolTimeTag.GetSenderTimestamp ();
     }
@@ -1929,7 +1954,7 @@ LteRlcAm::DoReportBufferStatus (void)
   r.rnti = m_rnti;
   r.lcid = m_lcid;
   //r.txQueueSize = m_txonBufferSize;
-  r.txQueueSize = m_txonBufferSize + m_txonQueue->GetNBytes();
+  r.txQueueSize = m_txonBuffer.GetNBytes () + m_txonQueue->GetNBytes();
   r.txQueueHolDelay = txonQueueHolDelay.GetMilliSeconds ();
   r.retxQueueSize = m_retxBufferSize;// + m_txedBufferSize;
   r.retxQueueHolDelay = retxQueueHolDelay.GetMilliSeconds ();
@@ -1963,13 +1988,6 @@ LteRlcAm::ExpireReorderingTimer (void)
   NS_LOG_FUNCTION (this);
   NS_LOG_LOGIC ("Reordering Timer has expired");
 
-  // clear the RLC segment buffer
-  //for (unsigned i = 0; i < m_retxSegBuffer.size(); i++)
-  //{
-  //	m_retxSegBuffer.at (i).m_pdu = 0;
-  //	m_retxSegBuffer.at (i).m_lastSegSent = false;
-  //}
-
   // 5.1.3.2.4 Actions when t-Reordering expires
   // When t-Reordering expires, the receiving side of an AM RLC entity shall:
   // - update VR(MS) to the SN of the first AMD PDU with SN >= VR(X) for which not all byte segments
@@ -1979,16 +1997,7 @@ LteRlcAm::ExpireReorderingTimer (void)
   //    - set VR(X) to VR(H).
 
   m_vrMs = m_vrX;
-  int firstVrMs = m_vrMs.GetValue ();
-  std::map <uint16_t, PduBuffer>::iterator it = m_rxonBuffer.find (m_vrMs.GetValue ());
-  while ( it != m_rxonBuffer.end () &&
-          it->second.m_pduComplete )
-    {
-      m_vrMs++;
-      it = m_rxonBuffer.find (m_vrMs.GetValue ());
-
-      NS_ASSERT_MSG (firstVrMs != m_vrMs.GetValue (), "Infinite loop in ExpireReorderingTimer");
-    }
+  m_vrMs = m_vrMs + m_rxonBuffer.FindFirstUnset (m_vrMs.GetValue (), (m_vrMr - m_vrMs));
   NS_LOG_LOGIC ("New VR(MS) = " << m_vrMs);
 
   if ( m_vrH > m_vrMs )
@@ -2012,7 +2021,7 @@ LteRlcAm::ExpirePollRetransmitTimer (void)
   NS_LOG_FUNCTION (this);
   NS_LOG_LOGIC ("PollRetransmit Timer has expired");
 
-  NS_LOG_LOGIC ("txonBufferSize = " << m_txonBufferSize);
+  NS_LOG_LOGIC ("txonBufferSize = " << m_txonBuffer.GetNBytes ());
   NS_LOG_LOGIC ("retxBufferSize = " << m_retxBufferSize);
   NS_LOG_LOGIC ("txedBufferSize = " << m_txedBufferSize);
   NS_LOG_LOGIC ("statusPduRequested = " << m_statusPduRequested);
@@ -2023,67 +2032,23 @@ LteRlcAm::ExpirePollRetransmitTimer (void)
   // note the difference between Rel 8 and Rel 11 specs; we follow Rel 11 here
   NS_ASSERT (m_vtS <= m_vtMs);
   //if ((m_txonBufferSize == 0 && m_retxBufferSize == 0)
-  if ((m_txonBufferSize + m_txonQueue->GetNBytes() == 0 && m_retxBufferSize == 0)
+  if ((m_txonBuffer.GetNBytes () + m_txonQueue->GetNBytes() == 0 && m_retxBufferSize == 0)
       || (m_vtS == m_vtMs))
     {
       NS_LOG_INFO ("txonBuffer and retxBuffer empty. Move PDUs up to = " << m_vtS.GetValue () - 1 << " to retxBuffer");
-      uint16_t sn = 0;
-      uint16_t acked =  m_vtA.GetValue();
-      uint16_t sent = m_vtS.GetValue ();
-      if(acked <= sent) //If no overflow, no change.
+      SequenceNumber10 sn = m_vtA;
+      uint16_t remaining = (m_vtS - m_vtA);
+      while (remaining > 0)
         {
- 		  for ( sn = m_vtA.GetValue(); sn < m_vtS.GetValue (); sn++ )
- 			{
- 			  bool pduAvailable = m_txedBuffer.at (sn).m_pdu != 0;
-
- 			   if ( pduAvailable )
- 				 {
- 				   NS_LOG_INFO ("Move PDU " << sn << " from txedBuffer to retxBuffer");
- 				   m_retxBuffer.at (sn).m_pdu = m_txedBuffer.at (sn).m_pdu->Copy ();
- 				   m_retxBuffer.at (sn).m_retxCount = m_txedBuffer.at (sn).m_retxCount;
- 				   m_retxBufferSize += m_retxBuffer.at (sn).m_pdu->GetSize ();
-
- 				   m_txedBufferSize -= m_txedBuffer.at (sn).m_pdu->GetSize ();
- 				   m_txedBuffer.at (sn).m_pdu = 0;
- 				   m_txedBuffer.at (sn).m_retxCount = 0;
- 				 }
- 			 }
-         }
-       else//If overflow happened, we retransmit from acked sequence to 1023, then from 0 to sent sequence.
-         {
- 		   for ( sn = m_vtA.GetValue(); sn < 1024; sn++ )
- 		     {
- 			   bool pduAvailable = m_txedBuffer.at (sn).m_pdu != 0;
-
- 			   if ( pduAvailable )
- 				 {
- 				   NS_LOG_INFO ("Move PDU " << sn << " from txedBuffer to retxBuffer");
- 				   m_retxBuffer.at (sn).m_pdu = m_txedBuffer.at (sn).m_pdu->Copy ();
- 				   m_retxBuffer.at (sn).m_retxCount = m_txedBuffer.at (sn).m_retxCount;
- 				   m_retxBufferSize += m_retxBuffer.at (sn).m_pdu->GetSize ();
-
- 				   m_txedBufferSize -= m_txedBuffer.at (sn).m_pdu->GetSize ();
- 				   m_txedBuffer.at (sn).m_pdu = 0;
- 				   m_txedBuffer.at (sn).m_retxCount = 0;
- 				 }
- 			}
-
- 		  for ( sn = 0; sn < m_vtS.GetValue (); sn++ )
- 			{
- 			  bool pduAvailable = m_txedBuffer.at (sn).m_pdu != 0;
-
- 			   if ( pduAvailable )
- 				 {
- 				   NS_LOG_INFO ("Move PDU " << sn << " from txedBuffer to retxBuffer");
- 				   m_retxBuffer.at (sn).m_pdu = m_txedBuffer.at (sn).m_pdu->Copy ();
- 				   m_retxBuffer.at (sn).m_retxCount = m_txedBuffer.at (sn).m_retxCount;
- 				   m_retxBufferSize += m_retxBuffer.at (sn).m_pdu->GetSize ();
-
- 				   m_txedBufferSize -= m_txedBuffer.at (sn).m_pdu->GetSize ();
- 				   m_txedBuffer.at (sn).m_pdu = 0;
- 				   m_txedBuffer.at (sn).m_retxCount = 0;
- 				 }
- 			}
+          uint16_t skip = m_txedBuffer.FindFirstSet (sn.GetValue (), remaining);
+          if (skip == remaining)
+            {
+              break;
+            }
+          sn = sn + skip;
+          MoveTxedToRetx (sn.GetValue ());
+          sn++;
+          remaining -= skip + 1;
         }
     }
 
@@ -2103,7 +2068,7 @@ LteRlcAm::ExpireRbsTimer (void)
   NS_LOG_LOGIC ("RBS Timer expires");
 
   //if (m_txonBufferSize + m_txedBufferSize + m_retxBufferSize > 0)
-  if (m_txonBufferSize + m_txonQueue->GetNBytes() + m_txedBufferSize + m_retxBufferSize > 0)
+  if (m_txonBuffer.GetNBytes () + m_txonQueue->GetNBytes() + m_txedBufferSize + m_retxBufferSize > 0)
     {
       DoReportBufferStatus ();
       m_rbsTimer = Simulator::Schedule (m_rbsTimerValue, &LteRlcAm::ExpireRbsTimer, this);
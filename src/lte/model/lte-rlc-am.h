@@ -24,6 +24,8 @@
 #include <ns3/event-id.h>
 #include <ns3/lte-rlc-sequence-number.h>
 #include <ns3/lte-rlc.h>
+#include <ns3/lte-rlc-sdu-buffer.h>
+#include <ns3/lte-rlc-sn-window.h>
 #include "ns3/codel-queue-disc.h"
 
 #include <vector>
@@ -82,29 +84,54 @@ private:
   void DoReportBufferStatus ();
 
 private:
-    std::vector < Ptr<Packet> > m_txonBuffer;       // Transmission buffer
+    LteRlcSduBuffer m_txonBuffer;       // Transmission buffer
     Ptr<CoDelQueueDisc> m_txonQueue; //the packets comming from PDCP first stored in this queue and move to m_txonBuffer during transmission.
 
     struct RetxPdu
     {
       Ptr<Packet> m_pdu;
       uint16_t    m_retxCount;
+      Ptr<Packet> m_segment;      ///< remaining segment of a re-segmented retransmission
+      bool        m_lastSegSent;  ///< all segments sent, waiting for ACK
+
+      RetxPdu ()
+        : m_retxCount (0),
+          m_lastSegSent (false)
+      {
+      }
     };
 
-    struct RetxSegPdu
-		{
-			Ptr<Packet> m_pdu;
-			uint16_t    m_retxCount;
-			bool			m_lastSegSent;		// all segments sent, waiting for ACK
-		};
+  /**
+   * Move a PDU from the txed buffer to the retx buffer. The PDU is
+   * shared, not copied.
+   * \param sn the SN of the PDU
+   */
+  void MoveTxedToRetx (uint16_t sn);
 
-  std::vector <RetxPdu> m_txedBuffer;  ///< Buffer for transmitted and retransmitted PDUs 
-                                       ///< that have not been acked but are not considered 
-                                       ///< for retransmission 
-  std::vector <RetxPdu> m_retxBuffer;  ///< Buffer for PDUs considered for retransmission
-  std::vector <RetxSegPdu> m_retxSegBuffer;  // buffer for AM PDU segments
+  /**
+   * Set the length of the SNs, and reduce the window size to half the
+   * SN space if larger
+   * \param snLength the SN length in bits, 10 or 16
+   */
+  void SetSnLength (uint8_t snLength);
+  /// \return the SN length in bits
+  uint8_t GetSnLength (void) const;
+
+  /**
+   * Set the window size, AM_Window_Size in TS 36.322, and size the
+   * buffers indexed by SN accordingly
+   * \param windowSize the window size
+   */
+  void SetWindowSize (uint16_t windowSize);
+  /// \return the window size
+  uint16_t GetWindowSize (void) const;
+
+  LteRlcSnWindow<RetxPdu> m_txedBuffer;  ///< Buffer for transmitted and retransmitted PDUs 
+                                         ///< that have not been acked but are not considered 
+                                         ///< for retransmission; bit set if it holds the PDU
+  LteRlcSnWindow<RetxPdu> m_retxBuffer;  ///< Buffer for PDUs considered for retransmission;
+                                         ///< bit set if it holds the PDU
 
-    uint32_t m_txonBufferSize;
     uint32_t m_retxBufferSize;
     uint32_t m_txedBufferSize;
 
@@ -113,13 +140,11 @@ private:
 
     struct PduBuffer
     {
-      SequenceNumber10  m_seqNumber;
       std::list < Ptr<Packet> >  m_byteSegments;
-
-      bool      m_pduComplete;
     };
 
-    std::map <uint16_t, PduBuffer > m_rxonBuffer; // Reception buffer
+    /// Reception buffer; bit set if all the byte segments of the PDU have been received
+    LteRlcSnWindow<PduBuffer> m_rxonBuffer;
 
     Ptr<Packet> m_controlPduBuffer;               // Control PDU buffer (just one PDU)
 
@@ -154,6 +179,7 @@ private:
    * Constants. See section 7.2 in TS 36.322
    */
   uint16_t m_windowSize;
+  uint8_t  m_snLength;                      // SN field length in bits
 
   /**
    * Timers. See section 7.3 in TS 36.322
@@ -0,0 +1,120 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2011 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/lte-rlc-sdu-buffer.h"
+#include "ns3/assert.h"
+
+namespace ns3 {
+
+/// initial capacity of the ring, a power of two
+static const uint32_t INITIAL_SDU_BUFFER_CAPACITY = 16;
+
+LteRlcSduBuffer::LteRlcSduBuffer ()
+  : m_ring (INITIAL_SDU_BUFFER_CAPACITY),
+    m_head (0),
+    m_nPackets (0),
+    m_nBytes (0)
+{
+}
+
+void
+LteRlcSduBuffer::PushBack (Ptr<Packet> p)
+{
+  if (m_nPackets == m_ring.size ())
+    {
+      Grow ();
+    }
+  m_ring[(m_head + m_nPackets) & (m_ring.size () - 1)] = p;
+  m_nPackets++;
+  m_nBytes += p->GetSize ();
+}
+
+void
+LteRlcSduBuffer::PushFront (Ptr<Packet> p)
+{
+  if (m_nPackets == m_ring.size ())
+    {
+      Grow ();
+    }
+  m_head = (m_head - 1) & (m_ring.size () - 1);
+  m_ring[m_head] = p;
+  m_nPackets++;
+  m_nBytes += p->GetSize ();
+}
+
+Ptr<Packet>
+LteRlcSduBuffer::PopFront (void)
+{
+  NS_ASSERT_MSG (m_nPackets > 0, "the RLC SDU buffer is empty");
+  Ptr<Packet> p = m_ring[m_head];
+  // release the reference held by the ring
+  m_ring[m_head] = 0;
+  m_head = (m_head + 1) & (m_ring.size () - 1);
+  m_nPackets--;
+  m_nBytes -= p->GetSize ();
+  return p;
+}
+
+Ptr<Packet>
+LteRlcSduBuffer::Front (void) const
+{
+  NS_ASSERT_MSG (m_nPackets > 0, "the RLC SDU buffer is empty");
+  return m_ring[m_head];
+}
+
+bool
+LteRlcSduBuffer::IsEmpty (void) const
+{
+  return m_nPackets == 0;
+}
+
+uint32_t
+LteRlcSduBuffer::GetNPackets (void) const
+{
+  return m_nPackets;
+}
+
+uint32_t
+LteRlcSduBuffer::GetNBytes (void) const
+{
+  return m_nBytes;
+}
+
+void
+LteRlcSduBuffer::Clear (void)
+{
+  m_ring.assign (INITIAL_SDU_BUFFER_CAPACITY, 0);
+  m_head = 0;
+  m_nPackets = 0;
+  m_nBytes = 0;
+}
+
+void
+LteRlcSduBuffer::Grow (void)
+{
+  uint32_t capacity = m_ring.size ();
+  std::vector<Ptr<Packet> > ring (2 * capacity);
+  for (uint32_t i = 0; i < m_nPackets; i++)
+    {
+      ring[i] = m_ring[(m_head + i) & (capacity - 1)];
+    }
+  m_ring.swap (ring);
+  m_head = 0;
+}
+
+} // namespace ns3
@@ -0,0 +1,93 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2011 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LTE_RLC_SDU_BUFFER_H
+#define LTE_RLC_SDU_BUFFER_H
+
+#include "ns3/packet.h"
+#include "ns3/ptr.h"
+
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup lte
+ *
+ * Transmission buffer of the RLC SDUs (or SDU segments) waiting to be
+ * mapped to a PDU.
+ *
+ * The buffer is a ring of Ptr<Packet> whose capacity doubles when it is
+ * full, so that taking the head SDU and giving back the remaining segment
+ * of a segmented SDU are O(1), whatever the number of queued SDUs. The
+ * number of bytes of the queued packets is kept up to date by every
+ * operation.
+ */
+class LteRlcSduBuffer
+{
+public:
+  LteRlcSduBuffer ();
+
+  /**
+   * Enqueue an SDU at the tail of the buffer
+   * \param p the SDU
+   */
+  void PushBack (Ptr<Packet> p);
+
+  /**
+   * Give back a segment at the head of the buffer
+   * \param p the remaining segment of the SDU taken last
+   */
+  void PushFront (Ptr<Packet> p);
+
+  /**
+   * Remove the packet at the head of the buffer
+   * \return the packet
+   */
+  Ptr<Packet> PopFront (void);
+
+  /**
+   * \return the packet at the head of the buffer, which must not be empty
+   */
+  Ptr<Packet> Front (void) const;
+
+  /// \return true if the buffer holds no packet
+  bool IsEmpty (void) const;
+
+  /// \return the number of packets in the buffer
+  uint32_t GetNPackets (void) const;
+
+  /// \return the sum of the sizes of the packets in the buffer
+  uint32_t GetNBytes (void) const;
+
+  /// Remove all the packets
+  void Clear (void);
+
+private:
+  /// Double the capacity of the ring, moving the packets to its beginning
+  void Grow (void);
+
+  std::vector<Ptr<Packet> > m_ring; ///< the packets, from m_head, modulo the capacity
+  uint32_t m_head;                  ///< index of the head packet in m_ring
+  uint32_t m_nPackets;
+  uint32_t m_nBytes;
+};
+
+} // namespace ns3
+
+#endif // LTE_RLC_SDU_BUFFER_H
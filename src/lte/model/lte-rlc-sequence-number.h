@@ -30,27 +30,39 @@
 namespace ns3 {
 
 
+/**
+ * \ingroup lte
+ * \brief An RLC sequence number, 10 bits long unless set otherwise
+ *
+ * The arithmetic wraps around at 2^length. AM may use 16-bit SNs
+ * (3GPP TS 36.322, Rel-13), so that its window can exceed 512 PDUs.
+ * The class keeps its name for the UM and AM code using it, but after
+ * SetLength (16) it holds 16-bit values.
+ */
 class SequenceNumber10
 {
 public:
   SequenceNumber10 ()
     : m_value (0),
-      m_modulusBase (0)
+      m_modulusBase (0),
+      m_mask (0x3FF)
   {}
 
   explicit SequenceNumber10 (uint16_t value)
     : m_value (value % 1024),
-      m_modulusBase (0)
+      m_modulusBase (0),
+      m_mask (0x3FF)
   {}
 
   SequenceNumber10 (SequenceNumber10 const &value)
     : m_value (value.m_value),
-      m_modulusBase (value.m_modulusBase)
+      m_modulusBase (value.m_modulusBase),
+      m_mask (value.m_mask)
   {}
 
   SequenceNumber10& operator= (uint16_t value)
   {
-    m_value = value % 1024;
+    m_value = value & m_mask;
     return *this;
   }
 
@@ -74,40 +86,63 @@ public:
     m_modulusBase = modulusBase;
   }
 
+  /**
+   * \brief Set the length of the sequence number, and reduce its value
+   * \param length the length in bits, at most 16
+   */
+  void SetLength (uint8_t length)
+  {
+    m_mask = (1u << length) - 1;
+    m_value &= m_mask;
+    m_modulusBase &= m_mask;
+  }
+
+  /**
+   * \returns the length of the sequence number in bits
+   */
+  uint8_t GetLength () const
+  {
+    uint8_t length = 0;
+    while ((m_mask >> length) != 0)
+      {
+        length++;
+      }
+    return length;
+  }
+
    // postfix ++
   SequenceNumber10 operator++ (int)
   {
-    SequenceNumber10 retval (m_value);
-    m_value = ((uint32_t)m_value + 1) % 1024;
-    retval.SetModulusBase (m_modulusBase);
+    SequenceNumber10 retval (*this);
+    m_value = ((uint32_t)m_value + 1) & m_mask;
     return retval;
   }
 
   SequenceNumber10 operator + (uint16_t delta) const
   {
-    SequenceNumber10 ret ((m_value + delta) % 1024);
-    ret.SetModulusBase (m_modulusBase);
+    SequenceNumber10 ret (*this);
+    ret.m_value = (m_value + delta) & m_mask;
     return ret;
   }
 
   SequenceNumber10 operator - (uint16_t delta) const
   {
-    SequenceNumber10 ret ((m_value - delta) % 1024);
-    ret.SetModulusBase (m_modulusBase);
+    SequenceNumber10 ret (*this);
+    ret.m_value = (m_value - delta) & m_mask;
     return ret;
   }
 
   uint16_t operator - (const SequenceNumber10 &other) const
   {
-    uint16_t diff = m_value - other.m_value;
+    uint16_t diff = (m_value - other.m_value) & m_mask;
     return (diff);
   }
 
   bool operator > (const SequenceNumber10 &other) const
   {
-    SequenceNumber10 v1 ((m_value - m_modulusBase) % 1024);
-    SequenceNumber10 v2 ((other.m_value - other.m_modulusBase) % 1024);
-    return ( v1.GetValue () > v2.GetValue () );
+    uint16_t v1 = (m_value - m_modulusBase) & m_mask;
+    uint16_t v2 = (other.m_value - other.m_modulusBase) & other.m_mask;
+    return ( v1 > v2 );
   }
 
   bool operator == (const SequenceNumber10 &other) const
@@ -141,6 +176,7 @@ public:
 private:
   uint16_t m_value;
   uint16_t m_modulusBase;
+  uint16_t m_mask;        //!< 2^length - 1
 };
 
 
@@ -0,0 +1,201 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2011 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LTE_RLC_SN_WINDOW_H
+#define LTE_RLC_SN_WINDOW_H
+
+#include "ns3/assert.h"
+
+#include <stdint.h>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup lte
+ *
+ * Window of RLC PDUs indexed by sequence number.
+ *
+ * The window holds one slot of type T per SN, at the index SN modulo the
+ * size of the window, and one bit per slot. The meaning of the bit is up
+ * to the user (e.g. "the PDU is in the buffer" or "all the byte segments
+ * of the PDU have been received"); setting, testing and resetting a bit
+ * are O(1), and FindFirstSet and FindFirstUnset scan the bitmap one word
+ * at a time.
+ *
+ * The size is a power of two, which can be changed at run time, and must
+ * be at least the number of SNs the user needs at the same time: since
+ * the index is SN modulo the size, two SNs that differ by a multiple of
+ * the size share a slot. Any power of two up to the modulus of the SN
+ * keeps the mapping consistent when the SN wraps around.
+ */
+template <class T>
+class LteRlcSnWindow
+{
+public:
+  /**
+   * \param size the number of slots, a power of two
+   */
+  LteRlcSnWindow (uint32_t size = 1024)
+  {
+    SetSize (size);
+  }
+
+  /**
+   * Set the number of slots; all the slots are reset
+   * \param size the number of slots, a power of two
+   */
+  void SetSize (uint32_t size)
+  {
+    NS_ASSERT_MSG (size > 0 && (size & (size - 1)) == 0, "window size " << size << " is not a power of two");
+    m_slots.assign (size, T ());
+    m_bits.assign ((size + 63) / 64, 0);
+    m_mask = size - 1;
+  }
+
+  /// \return the number of slots
+  uint32_t GetSize (void) const
+  {
+    return m_mask + 1;
+  }
+
+  /**
+   * \param sn the sequence number
+   * \return the slot of the SN, whether its bit is set or not
+   */
+  T& Get (uint32_t sn)
+  {
+    return m_slots[sn & m_mask];
+  }
+
+  /**
+   * \param sn the sequence number
+   * \return the slot of the SN, whether its bit is set or not
+   */
+  const T& Get (uint32_t sn) const
+  {
+    return m_slots[sn & m_mask];
+  }
+
+  /**
+   * \param sn the sequence number
+   * \return true if the bit of the SN is set
+   */
+  bool IsSet (uint32_t sn) const
+  {
+    uint32_t i = sn & m_mask;
+    return (m_bits[i / 64] >> (i % 64)) & 1;
+  }
+
+  /**
+   * Set the bit of a SN, leaving its slot as it is
+   * \param sn the sequence number
+   */
+  void Set (uint32_t sn)
+  {
+    uint32_t i = sn & m_mask;
+    m_bits[i / 64] |= static_cast<uint64_t> (1) << (i % 64);
+  }
+
+  /**
+   * Clear the bit of a SN and reset its slot to T ()
+   * \param sn the sequence number
+   */
+  void Reset (uint32_t sn)
+  {
+    uint32_t i = sn & m_mask;
+    m_bits[i / 64] &= ~(static_cast<uint64_t> (1) << (i % 64));
+    m_slots[i] = T ();
+  }
+
+  /**
+   * \param from the first sequence number to check
+   * \param count the number of sequence numbers to check, at most the size
+   * \return the offset from 'from' of the first SN whose bit is set, or
+   * count if there is none in [from, from + count)
+   */
+  uint32_t FindFirstSet (uint32_t from, uint32_t count) const
+  {
+    return Find (from, count, 0);
+  }
+
+  /**
+   * \param from the first sequence number to check
+   * \param count the number of sequence numbers to check, at most the size
+   * \return the offset from 'from' of the first SN whose bit is clear, or
+   * count if there is none in [from, from + count)
+   */
+  uint32_t FindFirstUnset (uint32_t from, uint32_t count) const
+  {
+    return Find (from, count, ~static_cast<uint64_t> (0));
+  }
+
+  /// Clear all the bits and reset all the slots
+  void Clear (void)
+  {
+    SetSize (GetSize ());
+  }
+
+private:
+  /**
+   * Scan the bitmap for the first bit that differs from the bits of skip
+   * \param from the first sequence number to check
+   * \param count the number of sequence numbers to check
+   * \param skip 0 to look for a set bit, all ones to look for a clear bit
+   * \return the offset of the bit from 'from', or count
+   */
+  uint32_t Find (uint32_t from, uint32_t count, uint64_t skip) const
+  {
+    NS_ASSERT (count <= GetSize ());
+    uint32_t offset = 0;
+    while (offset < count)
+      {
+        uint32_t i = (from + offset) & m_mask;
+        uint32_t bit = i % 64;
+        uint64_t word = (m_bits[i / 64] ^ skip) >> bit;
+        // bits of this word that are still in the window, without wrapping
+        uint32_t n = 64 - bit;
+        if (m_mask + 1 - i < n)
+          {
+            n = m_mask + 1 - i;
+          }
+        if (word != 0)
+          {
+            uint32_t k = 0;
+            while (((word >> k) & 1) == 0)
+              {
+                k++;
+              }
+            if (k < n)
+              {
+                return offset + k < count ? offset + k : count;
+              }
+          }
+        offset += n;
+      }
+    return count;
+  }
+
+  std::vector<T> m_slots;        ///< one slot per SN modulo the size
+  std::vector<uint64_t> m_bits;  ///< one bit per slot
+  uint32_t m_mask;               ///< size - 1
+};
+
+} // namespace ns3
+
+#endif // LTE_RLC_SN_WINDOW_H
@@ -22,6 +22,7 @@
 #include "ns3/config.h"
 #include "ns3/simulator.h"
 #include "ns3/pointer.h"
+#include "ns3/uinteger.h"
 #include "ns3/log.h"
 #include "ns3/packet.h"
 #include "ns3/node-container.h"
@@ -94,15 +95,23 @@ LteRlcAmE2eTestSuite::LteRlcAmE2eTestSuite ()
             }
         }
     }
+
+  // 16-bit SNs, with a window holding all the SDUs of a bulk arrival
+  AddTestCase (new LteRlcAmE2eTestCase (" losses = 10%; run = 1111; bulk SDU arrival; 16-bit SN",
+                                        runs[0], 0.10, true, 16), TestCase::QUICK);
+  AddTestCase (new LteRlcAmE2eTestCase (" losses = 10%; run = 1111; continuous SDU arrival; 16-bit SN",
+                                        runs[0], 0.10, false, 16), TestCase::QUICK);
 }
 
 static LteRlcAmE2eTestSuite lteRlcAmE2eTestSuite;
 
-LteRlcAmE2eTestCase::LteRlcAmE2eTestCase (std::string name, uint32_t run, double losses, bool bulkSduArrival)
+LteRlcAmE2eTestCase::LteRlcAmE2eTestCase (std::string name, uint32_t run, double losses, bool bulkSduArrival,
+                                          uint8_t snLength)
    : TestCase (name),
      m_run (run),
      m_losses (losses),
      m_bulkSduArrival (bulkSduArrival),
+     m_snLength (snLength),
      m_dlDrops (0),
      m_ulDrops (0)
 {
@@ -150,6 +159,8 @@ LteRlcAmE2eTestCase::DoRun (void)
   Config::SetDefault ("ns3::LteRlcAm::PollRetransmitTimer", TimeValue (MilliSeconds (20)));
   Config::SetDefault ("ns3::LteRlcAm::ReorderingTimer", TimeValue (MilliSeconds (10)));
   Config::SetDefault ("ns3::LteRlcAm::StatusProhibitTimer", TimeValue (MilliSeconds (40)));
+  Config::SetDefault ("ns3::LteRlcAm::SnLength", UintegerValue (m_snLength));
+  Config::SetDefault ("ns3::LteRlcAm::WindowSize", UintegerValue (m_snLength == 16 ? 2048 : 512));
 
   Ptr<LteSimpleHelper> lteSimpleHelper = CreateObject<LteSimpleHelper> ();
   // lteSimpleHelper->EnableLogComponents ();
@@ -239,11 +250,13 @@ LteRlcAmE2eTestCase::DoRun (void)
   Simulator::Schedule (Seconds (sduStopTimeSeconds), &LteTestRrc::Stop, lteSimpleHelper->m_enbRrc);
 
   
-  double maxDlThroughput = (dlTxOppSizeBytes/(dlTxOppSizeBytes+4.0))*(dlTxOppSizeBytes/dlTxOpprTimeSeconds) * (1.0-m_losses);
+  // a DATA PDU header is 4 bytes with 10-bit SNs and 5 with 16-bit SNs
+  const double dataHeaderBytes = (m_snLength == 16) ? 5.0 : 4.0;
+  double maxDlThroughput = (dlTxOppSizeBytes/(dlTxOppSizeBytes+dataHeaderBytes))*(dlTxOppSizeBytes/dlTxOpprTimeSeconds) * (1.0-m_losses);
   const double statusProhibitSeconds = 0.020;
   double pollFrequency = (1.0/dlTxOpprTimeSeconds)*(1-m_losses);
   double statusFrequency = std::min (pollFrequency, 1.0/statusProhibitSeconds);
-  const uint32_t numNackSnPerStatusPdu = (ulTxOppSizeBytes*8 - 14)/10;
+  const uint32_t numNackSnPerStatusPdu = (ulTxOppSizeBytes*8 - (m_snLength + 4))/m_snLength;
   double maxRetxThroughput = ((double)numNackSnPerStatusPdu*(double)dlTxOppSizeBytes)*statusFrequency;
   double throughput = std::min (maxDlThroughput, maxRetxThroughput);
   double totBytes = ((sduSizeBytes) * (sduStopTimeSeconds - sduStartTimeSeconds) / sduArrivalTimeSeconds);
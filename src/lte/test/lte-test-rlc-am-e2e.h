@@ -46,7 +46,8 @@ public:
 class LteRlcAmE2eTestCase : public TestCase
 {
   public:
-  LteRlcAmE2eTestCase (std::string name, uint32_t seed, double losses, bool bulkSduArrival);
+  LteRlcAmE2eTestCase (std::string name, uint32_t seed, double losses, bool bulkSduArrival,
+                       uint8_t snLength = 10);
     LteRlcAmE2eTestCase ();
     virtual ~LteRlcAmE2eTestCase ();
 
@@ -59,6 +60,7 @@ class LteRlcAmE2eTestCase : public TestCase
     uint32_t m_run;
     double   m_losses;
     bool m_bulkSduArrival;
+    uint8_t m_snLength;
 
     uint32_t m_dlDrops;
     uint32_t m_ulDrops;
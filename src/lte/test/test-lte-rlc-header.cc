@@ -90,7 +90,8 @@ class RlcAmStatusPduTestCase : public TestCase
 public:
   RlcAmStatusPduTestCase (SequenceNumber10 ackSn, 
 			  std::list<SequenceNumber10> nackSnList,
-			  std::string hex);
+			  std::string hex,
+			  uint8_t snLength = 10);
 
 protected:  
   virtual void DoRun (void);
@@ -98,17 +99,20 @@ protected:
   SequenceNumber10 m_ackSn;  
   std::list<SequenceNumber10> m_nackSnList;
   std::string m_hex;
+  uint8_t m_snLength;
   
 };
 
 
 RlcAmStatusPduTestCase::RlcAmStatusPduTestCase (SequenceNumber10 ackSn, 
 						std::list<SequenceNumber10> nackSnList ,
-						std::string hex)
+						std::string hex,
+						uint8_t snLength)
   : TestCase (hex), 
     m_ackSn (ackSn),
     m_nackSnList (nackSnList),
-    m_hex (hex)
+    m_hex (hex),
+    m_snLength (snLength)
 {
   NS_LOG_FUNCTION (this << hex);
 }
@@ -121,6 +125,7 @@ RlcAmStatusPduTestCase::DoRun ()
   
   Ptr<Packet> p = Create<Packet> ();
   LteRlcAmHeader h;
+  h.SetSnLength (m_snLength);
   h.SetControlPdu (LteRlcAmHeader::STATUS_PDU);
   h.SetAckSn (m_ackSn);
   for (std::list<SequenceNumber10>::iterator it = m_nackSnList.begin ();
@@ -136,6 +141,7 @@ RlcAmStatusPduTestCase::DoRun ()
   NS_TEST_ASSERT_MSG_EQ (m_hex, hex, "serialized packet content " << hex << " differs from test vector " << m_hex);
   
   LteRlcAmHeader h2;
+  h2.SetSnLength (m_snLength);
   p->RemoveHeader (h2);
   SequenceNumber10 ackSn = h2.GetAckSn ();
   NS_TEST_ASSERT_MSG_EQ (ackSn, m_ackSn, "deserialized ACK SN differs from test vector");
@@ -153,6 +159,87 @@ RlcAmStatusPduTestCase::DoRun ()
 }
 
 
+class RlcAmDataPduTestCase : public TestCase
+{
+public:
+  RlcAmDataPduTestCase (uint16_t sn, std::list<uint16_t> lengthIndicators,
+                        std::string hex, uint8_t snLength);
+
+protected:
+  virtual void DoRun (void);
+
+  uint16_t m_sn;
+  std::list<uint16_t> m_lengthIndicators;
+  std::string m_hex;
+  uint8_t m_snLength;
+};
+
+
+RlcAmDataPduTestCase::RlcAmDataPduTestCase (uint16_t sn, std::list<uint16_t> lengthIndicators,
+                                            std::string hex, uint8_t snLength)
+  : TestCase (hex),
+    m_sn (sn),
+    m_lengthIndicators (lengthIndicators),
+    m_hex (hex),
+    m_snLength (snLength)
+{
+  NS_LOG_FUNCTION (this << hex);
+}
+
+void
+RlcAmDataPduTestCase::DoRun ()
+{
+  NS_LOG_FUNCTION (this);
+
+  Ptr<Packet> p = Create<Packet> ();
+  LteRlcAmHeader h;
+  h.SetSnLength (m_snLength);
+  h.SetDataPdu ();
+  SequenceNumber10 sn;
+  sn.SetLength (m_snLength);
+  sn = m_sn;
+  h.SetSequenceNumber (sn);
+  h.SetResegmentationFlag (LteRlcAmHeader::PDU);
+  h.SetPollingBit (LteRlcAmHeader::STATUS_REPORT_IS_REQUESTED);
+  h.SetFramingInfo (LteRlcAmHeader::FIRST_BYTE | LteRlcAmHeader::NO_LAST_BYTE);
+  h.SetLastSegmentFlag (LteRlcAmHeader::NO_LAST_PDU_SEGMENT);
+  h.SetSegmentOffset (0);
+  h.PushExtensionBit (m_lengthIndicators.empty () ? LteRlcAmHeader::DATA_FIELD_FOLLOWS
+                                                  : LteRlcAmHeader::E_LI_FIELDS_FOLLOWS);
+  for (std::list<uint16_t>::iterator it = m_lengthIndicators.begin ();
+       it != m_lengthIndicators.end ();
+       ++it)
+    {
+      std::list<uint16_t>::iterator next = it;
+      ++next;
+      h.PushExtensionBit (next == m_lengthIndicators.end () ? LteRlcAmHeader::DATA_FIELD_FOLLOWS
+                                                            : LteRlcAmHeader::E_LI_FIELDS_FOLLOWS);
+      h.PushLengthIndicator (*it);
+    }
+  p->AddHeader (h);
+
+  TestUtils::LogPacketContents (p);
+  std::string hex = TestUtils::sprintPacketContentsHex (p);
+  NS_TEST_ASSERT_MSG_EQ (m_hex, hex, "serialized packet content " << hex << " differs from test vector " << m_hex);
+
+  LteRlcAmHeader h2;
+  h2.SetSnLength (m_snLength);
+  p->RemoveHeader (h2);
+  NS_TEST_ASSERT_MSG_EQ (h2.GetSerializedSize (), h.GetSerializedSize (), "deserialized header length differs");
+  NS_TEST_ASSERT_MSG_EQ (h2.GetSequenceNumber ().GetValue (), m_sn, "deserialized SN differs from test vector");
+  NS_TEST_ASSERT_MSG_EQ ((uint16_t) h2.GetPollingBit (), (uint16_t) LteRlcAmHeader::STATUS_REPORT_IS_REQUESTED,
+                         "deserialized polling bit differs");
+  NS_TEST_ASSERT_MSG_EQ ((uint16_t) h2.GetFramingInfo (), 1, "deserialized framing info differs");
+  h2.PopExtensionBit ();
+  for (std::list<uint16_t>::iterator it = m_lengthIndicators.begin ();
+       it != m_lengthIndicators.end ();
+       ++it)
+    {
+      NS_TEST_ASSERT_MSG_EQ (h2.PopLengthIndicator (), *it, "deserialized LI differs from test vector");
+    }
+}
+
+
 class LteRlcHeaderTestSuite : public TestSuite
 {
 public:
@@ -219,6 +306,47 @@ LteRlcHeaderTestSuite::LteRlcHeaderTestSuite ()
     AddTestCase (new RlcAmStatusPduTestCase (ackSn, nackSnList, hex), TestCase::QUICK);
   }
 
+  // 16-bit SNs
+  {
+    SequenceNumber10 ackSn;
+    ackSn.SetLength (16);
+    ackSn = 40000;
+    std::list<SequenceNumber10> nackSnList;
+    std::string hex ("09c400");
+    AddTestCase (new RlcAmStatusPduTestCase (ackSn, nackSnList, hex, 16), TestCase::QUICK);
+  }
+
+  {
+    SequenceNumber10 ackSn;
+    ackSn.SetLength (16);
+    ackSn = 40000;
+    std::list<SequenceNumber10> nackSnList;
+    SequenceNumber10 nackSn = ackSn;
+    nackSnList.push_back (nackSn = 1021);
+    nackSnList.push_back (nackSn = 65000);
+    std::string hex ("09c4081fedfbd000");
+    AddTestCase (new RlcAmStatusPduTestCase (ackSn, nackSnList, hex, 16), TestCase::QUICK);
+  }
+
+  {
+    std::list<uint16_t> lengthIndicators;
+    std::string hex ("ab6a0000");
+    AddTestCase (new RlcAmDataPduTestCase (874, lengthIndicators, hex, 10), TestCase::QUICK);
+  }
+
+  {
+    std::list<uint16_t> lengthIndicators;
+    std::string hex ("a89c400000");
+    AddTestCase (new RlcAmDataPduTestCase (40000, lengthIndicators, hex, 16), TestCase::QUICK);
+  }
+
+  {
+    std::list<uint16_t> lengthIndicators;
+    lengthIndicators.push_back (300);
+    std::string hex ("ac9c40000012c0");
+    AddTestCase (new RlcAmDataPduTestCase (40000, lengthIndicators, hex, 16), TestCase::QUICK);
+  }
+
 }
 
 
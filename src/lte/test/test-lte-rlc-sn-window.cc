@@ -0,0 +1,131 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2011, 2012, 2013 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/test.h"
+
+#include "ns3/lte-rlc-sn-window.h"
+
+#include <set>
+
+NS_LOG_COMPONENT_DEFINE ("TestLteRlcSnWindow");
+
+namespace ns3 {
+
+/**
+ * Set the bits of some SNs of a window, then check the scans from every
+ * SN against a plain search, including the scans that wrap around.
+ */
+class LteRlcSnWindowTestCase : public TestCase
+{
+public:
+  LteRlcSnWindowTestCase (uint32_t size, std::set<uint32_t> sns);
+
+protected:
+  virtual void DoRun (void);
+
+  uint32_t m_size;
+  std::set<uint32_t> m_sns;
+};
+
+LteRlcSnWindowTestCase::LteRlcSnWindowTestCase (uint32_t size, std::set<uint32_t> sns)
+  : TestCase ("window of size " + std::to_string (size) + " with " + std::to_string (sns.size ()) + " SNs set"),
+    m_size (size),
+    m_sns (sns)
+{
+}
+
+void
+LteRlcSnWindowTestCase::DoRun ()
+{
+  LteRlcSnWindow<uint32_t> window (m_size);
+  for (std::set<uint32_t>::iterator it = m_sns.begin (); it != m_sns.end (); ++it)
+    {
+      window.Get (*it) = *it + 1;
+      window.Set (*it);
+    }
+
+  for (uint32_t from = 0; from < m_size; from++)
+    {
+      for (uint32_t count = 0; count <= m_size; count += 7)
+        {
+          uint32_t firstSet = count;
+          uint32_t firstUnset = count;
+          for (uint32_t i = count; i > 0; i--)
+            {
+              bool set = m_sns.count ((from + i - 1) % m_size) > 0;
+              (set ? firstSet : firstUnset) = i - 1;
+            }
+          NS_TEST_ASSERT_MSG_EQ (window.FindFirstSet (from, count), firstSet,
+                                 "first set SN from " << from << " over " << count);
+          NS_TEST_ASSERT_MSG_EQ (window.FindFirstUnset (from, count), firstUnset,
+                                 "first unset SN from " << from << " over " << count);
+        }
+    }
+
+  // SNs beyond the size share the slot of the SN modulo the size
+  for (std::set<uint32_t>::iterator it = m_sns.begin (); it != m_sns.end (); ++it)
+    {
+      NS_TEST_ASSERT_MSG_EQ (window.IsSet (*it + 1024), true, "SN " << *it + 1024 << " not set");
+      NS_TEST_ASSERT_MSG_EQ (window.Get (*it + 1024), *it + 1, "wrong slot for SN " << *it + 1024);
+      window.Reset (*it);
+      NS_TEST_ASSERT_MSG_EQ (window.IsSet (*it), false, "SN " << *it << " still set");
+      NS_TEST_ASSERT_MSG_EQ (window.Get (*it), 0u, "slot of SN " << *it << " not reset");
+    }
+  NS_TEST_ASSERT_MSG_EQ (window.FindFirstSet (0, m_size), m_size, "SNs left after Reset");
+}
+
+
+class LteRlcSnWindowTestSuite : public TestSuite
+{
+public:
+  LteRlcSnWindowTestSuite ();
+} staticLteRlcSnWindowTestSuiteInstance;
+
+LteRlcSnWindowTestSuite::LteRlcSnWindowTestSuite ()
+  : TestSuite ("lte-rlc-sn-window", UNIT)
+{
+  std::set<uint32_t> sns;
+  AddTestCase (new LteRlcSnWindowTestCase (1024, sns), TestCase::QUICK);
+
+  sns.insert (0);
+  sns.insert (63);
+  sns.insert (64);
+  sns.insert (500);
+  sns.insert (1023);
+  AddTestCase (new LteRlcSnWindowTestCase (1024, sns), TestCase::QUICK);
+
+  // a size smaller than a word of the bitmap
+  std::set<uint32_t> small;
+  small.insert (1);
+  small.insert (7);
+  AddTestCase (new LteRlcSnWindowTestCase (8, small), TestCase::QUICK);
+
+  // all the SNs of a window set but one
+  std::set<uint32_t> full;
+  for (uint32_t sn = 0; sn < 256; sn++)
+    {
+      if (sn != 130)
+        {
+          full.insert (sn);
+        }
+    }
+  AddTestCase (new LteRlcSnWindowTestCase (256, full), TestCase::QUICK);
+}
+
+} // namespace ns3
@@ -30,7 +30,6 @@
 #include <ns3/log.h>
 #include "mmwave-phy-rx-trace.h"
 #include <ns3/simulator.h>
-#include <stdio.h>
 
 namespace ns3 {
 
@@ -43,6 +42,7 @@ std::string MmWavePhyRxTrace::m_rxPacketTraceFilename;
 
 MmWavePhyRxTrace::MmWavePhyRxTrace()
 {
+	m_writer = CreateObject<MmWaveTraceWriter> ();
 }
 
 MmWavePhyRxTrace::~MmWavePhyRxTrace()
@@ -53,6 +53,14 @@ MmWavePhyRxTrace::~MmWavePhyRxTrace()
 	}
 }
 
+void
+MmWavePhyRxTrace::DoDispose (void)
+{
+	m_writer->Dispose ();
+	m_writer = 0;
+	Object::DoDispose ();
+}
+
 TypeId
 MmWavePhyRxTrace::GetTypeId (void)
 {
@@ -78,21 +86,7 @@ MmWavePhyRxTrace::UlSinrTraceCallback (Ptr<MmWavePhyRxTrace> phyStats, std::stri
 {
 	NS_LOG_INFO ("UE"<<imsi<<"->Generate UlSinrTrace");
 	uint64_t slot_count = Now().GetMicroSeconds ()/125;
-	uint32_t rb_count = 1;
-	FILE* log_file;
-	char fname[255];
-	sprintf(fname, "UE_%llu_UL_SINR_dB.txt", (long long unsigned ) imsi);
-	log_file = fopen(fname, "a");
-	Values::iterator it = sinr.ValuesBegin();
-	while(it!=sinr.ValuesEnd())
-	{
-		//fprintf(log_file, "%d\t%d\t%f\t \n", slot_count/2, rb_count, 10*log10(*it));
-		fprintf(log_file, "%llu\t%llu\t%d\t%f\t \n",(long long unsigned )slot_count/8+1, (long long unsigned )slot_count%8+1, rb_count, 10*log10(*it));
-		rb_count++;
-		it++;
-	}
-	fflush(log_file);
-	fclose(log_file);
+	phyStats->m_writer->WriteRbValues ("UE_%llu_UL_SINR_dB", imsi, slot_count, sinr);
 	//phyStats->ReportInterferenceTrace (imsi, sinr);
 	//phyStats->ReportPowerTrace (imsi, power);
 }
@@ -101,42 +95,14 @@ void
 MmWavePhyRxTrace::ReportInterferenceTrace (uint64_t imsi, SpectrumValue& sinr)
 {
 	uint64_t slot_count = Now().GetMicroSeconds ()/125;
-	uint32_t rb_count = 1;
-	FILE* log_file;
-	char fname[255];
-	sprintf(fname, "UE_%llu_SINR_dB.txt", (long long unsigned ) imsi);
-	log_file = fopen(fname, "a");
-	Values::iterator it = sinr.ValuesBegin();
-	while(it!=sinr.ValuesEnd())
-	{
-		//fprintf(log_file, "%d\t%d\t%f\t \n", slot_count/2, rb_count, 10*log10(*it));
-		fprintf(log_file, "%llu\t%llu\t%d\t%f\t \n",(long long unsigned) slot_count/8+1, (long long unsigned) slot_count%8+1, rb_count, 10*log10(*it));
-		rb_count++;
-		it++;
-	}
-	fflush(log_file);
-	fclose(log_file);
+	m_writer->WriteRbValues ("UE_%llu_SINR_dB", imsi, slot_count, sinr);
 }
 
 void
 MmWavePhyRxTrace::ReportPowerTrace (uint64_t imsi, SpectrumValue& power)
 {
-
-	uint32_t slot_count = Now().GetMicroSeconds ()/125;
-	uint32_t rb_count = 1;
-	FILE* log_file;
-	char fname[255];
-	printf (fname, "UE_%llu_ReceivedPower_dB.txt", (long long unsigned) imsi);
-	log_file = fopen(fname, "a");
-	Values::iterator it = power.ValuesBegin();
-	while(it!=power.ValuesEnd())
-	{
-		fprintf(log_file, "%llu\t%llu\t%d\t%f\t \n",(long long unsigned) slot_count/8+1,(long long unsigned) slot_count%8+1, rb_count, 10*log10(*it));
-		rb_count++;
-		it++;
-	}
-	fflush(log_file);
-	fclose(log_file);
+	uint64_t slot_count = Now().GetMicroSeconds ()/125;
+	m_writer->WriteRbValues ("UE_%llu_ReceivedPower_dB", imsi, slot_count, power);
 }
 
 void
@@ -164,56 +130,33 @@ MmWavePhyRxTrace::ReportDownLinkTBSize (Ptr<MmWavePhyRxTrace> phyStats, std::str
 void
 MmWavePhyRxTrace::ReportPacketCountUe (UePhyPacketCountParameter param)
 {
-	FILE* log_file;
-	char fname[255];
-	sprintf (fname,"UE_%llu_Packet_Trace.txt", (long long unsigned) param.m_imsi);
-	log_file = fopen (fname, "a");
 	if (param.m_isTx)
 	{
-		fprintf (log_file, "%d\t%d\t%d\n", param.m_subframeno, param.m_noBytes, 0);
+		m_writer->WritePacketCount ("UE_%llu_Packet_Trace", param.m_imsi, param.m_subframeno, param.m_noBytes, 0);
 	}
 	else
 	{
-		fprintf (log_file, "%d\t%d\t%d\n", param.m_subframeno, 0, param.m_noBytes);
+		m_writer->WritePacketCount ("UE_%llu_Packet_Trace", param.m_imsi, param.m_subframeno, 0, param.m_noBytes);
 	}
-
-	fflush(log_file);
-	fclose(log_file);
-
 }
 
 void
 MmWavePhyRxTrace::ReportPacketCountEnb (EnbPhyPacketCountParameter param)
 {
-	FILE* log_file;
-	char fname[255];
-	sprintf (fname,"BS_%llu_Packet_Trace.txt",(long long unsigned) param.m_cellId);
-	log_file = fopen (fname, "a");
 	if (param.m_isTx)
 	{
-		fprintf (log_file, "%d\t%d\t%d\n", param.m_subframeno, param.m_noBytes, 0);
+		m_writer->WritePacketCount ("BS_%llu_Packet_Trace", param.m_cellId, param.m_subframeno, param.m_noBytes, 0);
 	}
 	else
 	{
-		fprintf (log_file, "%d\t%d\t%d\n", param.m_subframeno, 0, param.m_noBytes);
+		m_writer->WritePacketCount ("BS_%llu_Packet_Trace", param.m_cellId, param.m_subframeno, 0, param.m_noBytes);
 	}
-
-	fflush(log_file);
-	fclose(log_file);
 }
 
 void
 MmWavePhyRxTrace::ReportDLTbSize (uint64_t imsi, uint64_t tbSize)
 {
-	FILE* log_file;
-	char fname[255];
-	sprintf (fname,"UE_%llu_Tb_Size.txt", (long long unsigned) imsi);
-	log_file = fopen (fname, "a");
-
-	fprintf (log_file, "%llu \t %llu\n", (long long unsigned )Now().GetMicroSeconds (), (long long unsigned )tbSize);
-	fprintf (log_file, "%lld \t %llu \n",(long long int) Now().GetMicroSeconds (), (long long unsigned) tbSize);
-	fflush(log_file);
-	fclose(log_file);
+	m_writer->WriteTbSize ("UE_%llu_Tb_Size", imsi, Now().GetMicroSeconds (), tbSize);
 }
 
 void
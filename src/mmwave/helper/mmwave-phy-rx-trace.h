@@ -31,6 +31,7 @@
 #include <ns3/object.h>
 #include <ns3/spectrum-value.h>
 #include <ns3/mmwave-phy-mac-common.h>
+#include <ns3/mmwave-trace-writer.h>
 #include <fstream>
 #include <iostream>
 
@@ -55,6 +56,9 @@ public:
 	static void RxPacketTraceUeCallback (Ptr<MmWavePhyRxTrace> phyStats, std::string path, RxPacketTraceParams param);
 	static void RxPacketTraceEnbCallback (Ptr<MmWavePhyRxTrace> phyStats, std::string path, RxPacketTraceParams param);
 
+protected:
+	virtual void DoDispose (void);
+
 private:
 	void ReportInterferenceTrace (uint64_t imsi, SpectrumValue& sinr);
 	void ReportPowerTrace (uint64_t imsi, SpectrumValue& power);
@@ -62,6 +66,8 @@ private:
 	void ReportPacketCountEnb (EnbPhyPacketCountParameter param);
 	void ReportDLTbSize (uint64_t imsi, uint64_t tbSize);
 
+	Ptr<MmWaveTraceWriter> m_writer;
+
 	static std::ofstream m_rxPacketTraceFile;
 	static std::string m_rxPacketTraceFilename;
 };
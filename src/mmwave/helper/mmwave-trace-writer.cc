@@ -0,0 +1,367 @@
+ /* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+ /*
+ *   Copyright (c) 2015, NYU WIRELESS, Tandon School of Engineering, New York University
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "mmwave-trace-writer.h"
+#include <ns3/log.h>
+#include <ns3/simulator.h>
+#include <ns3/enum.h>
+#include <ns3/uinteger.h>
+#include <cmath>
+#include <cstring>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MmWaveTraceWriter");
+
+NS_OBJECT_ENSURE_REGISTERED (MmWaveTraceWriter);
+
+namespace {
+
+const char g_binaryMagic[8] = {'M', 'M', 'W', 'T', 'R', 'A', 'C', 'E'};
+
+// the maximum length of a single text record
+const size_t MAX_TEXT_RECORD = 128;
+
+inline void
+EncodeU16 (char* p, uint16_t v)
+{
+  p[0] = v & 0xff;
+  p[1] = (v >> 8) & 0xff;
+}
+
+inline void
+EncodeU32 (char* p, uint32_t v)
+{
+  for (int i = 0; i < 4; i++)
+    {
+      p[i] = (v >> (8 * i)) & 0xff;
+    }
+}
+
+inline void
+EncodeU64 (char* p, uint64_t v)
+{
+  for (int i = 0; i < 8; i++)
+    {
+      p[i] = (v >> (8 * i)) & 0xff;
+    }
+}
+
+inline uint16_t
+DecodeU16 (const uint8_t* p)
+{
+  return p[0] | (p[1] << 8);
+}
+
+inline uint32_t
+DecodeU32 (const uint8_t* p)
+{
+  uint32_t v = 0;
+  for (int i = 3; i >= 0; i--)
+    {
+      v = (v << 8) | p[i];
+    }
+  return v;
+}
+
+inline uint64_t
+DecodeU64 (const uint8_t* p)
+{
+  uint64_t v = 0;
+  for (int i = 7; i >= 0; i--)
+    {
+      v = (v << 8) | p[i];
+    }
+  return v;
+}
+
+inline void
+EncodeFloat (char* p, float f)
+{
+  uint32_t v;
+  std::memcpy (&v, &f, sizeof (v));
+  EncodeU32 (p, v);
+}
+
+inline float
+DecodeFloat (const uint8_t* p)
+{
+  uint32_t v = DecodeU32 (p);
+  float f;
+  std::memcpy (&f, &v, sizeof (f));
+  return f;
+}
+
+int
+FormatRbValue (char* out, uint64_t slotCount, uint16_t rb, double valueDb)
+{
+  return snprintf (out, MAX_TEXT_RECORD, "%llu\t%llu\t%d\t%f\t \n",
+                   (long long unsigned) slotCount / 8 + 1, (long long unsigned) slotCount % 8 + 1, rb, valueDb);
+}
+
+int
+FormatPacketCount (char* out, uint32_t subframe, uint32_t txBytes, uint32_t rxBytes)
+{
+  return snprintf (out, MAX_TEXT_RECORD, "%d\t%d\t%d\n", subframe, txBytes, rxBytes);
+}
+
+int
+FormatTbSize (char* out, uint64_t timeUs, uint64_t tbSize)
+{
+  return snprintf (out, MAX_TEXT_RECORD, "%llu \t %llu\n", (long long unsigned) timeUs, (long long unsigned) tbSize);
+}
+
+} // anonymous namespace
+
+MmWaveTraceWriter::MmWaveTraceWriter ()
+  : m_format (TEXT_FORMAT),
+    m_bufferSize (65536)
+{
+  NS_LOG_FUNCTION (this);
+  // make sure nothing is lost if the object outlives the simulation
+  Simulator::ScheduleDestroy (&MmWaveTraceWriter::Flush, Ptr<MmWaveTraceWriter> (this));
+}
+
+MmWaveTraceWriter::~MmWaveTraceWriter ()
+{
+  CloseAll ();
+}
+
+TypeId
+MmWaveTraceWriter::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MmWaveTraceWriter")
+    .SetParent<Object> ()
+    .AddConstructor<MmWaveTraceWriter> ()
+    .AddAttribute ("Format",
+                   "Output format of the PHY trace files",
+                   EnumValue (MmWaveTraceWriter::TEXT_FORMAT),
+                   MakeEnumAccessor (&MmWaveTraceWriter::m_format),
+                   MakeEnumChecker (MmWaveTraceWriter::TEXT_FORMAT, "Text",
+                                    MmWaveTraceWriter::BINARY_FORMAT, "Binary"))
+    .AddAttribute ("BufferSize",
+                   "Number of bytes buffered for each trace file before writing to disk",
+                   UintegerValue (65536),
+                   MakeUintegerAccessor (&MmWaveTraceWriter::m_bufferSize),
+                   MakeUintegerChecker<uint32_t> (MAX_TEXT_RECORD))
+  ;
+  return tid;
+}
+
+void
+MmWaveTraceWriter::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  CloseAll ();
+  Object::DoDispose ();
+}
+
+uint16_t
+MmWaveTraceWriter::GetRecordSize (uint16_t type)
+{
+  switch (type)
+    {
+    case RB_VALUE_RECORD:
+      return 16;
+    case PACKET_COUNT_RECORD:
+      return 12;
+    case TB_SIZE_RECORD:
+      return 16;
+    default:
+      return 0;
+    }
+}
+
+MmWaveTraceWriter::Stream&
+MmWaveTraceWriter::GetStream (const char* prefix, uint64_t id, RecordType type)
+{
+  StreamKey_t key (prefix, id);
+  std::map<StreamKey_t, Stream>::iterator it = m_streams.find (key);
+  if (it != m_streams.end ())
+    {
+      return it->second;
+    }
+
+  char fname[255];
+  int len = snprintf (fname, sizeof (fname), prefix, (long long unsigned) id);
+  NS_ASSERT (len > 0 && len < (int) sizeof (fname) - 4);
+  std::strcat (fname, m_format == BINARY_FORMAT ? ".bin" : ".txt");
+
+  Stream& stream = m_streams[key];
+  stream.m_file = fopen (fname, m_format == BINARY_FORMAT ? "ab" : "a");
+  if (stream.m_file == 0)
+    {
+      NS_FATAL_ERROR ("Could not open trace file " << fname);
+    }
+  stream.m_buffer.resize (m_bufferSize);
+  stream.m_used = 0;
+  NS_LOG_LOGIC ("Opened trace file " << fname);
+
+  if (m_format == BINARY_FORMAT && ftell (stream.m_file) == 0)
+    {
+      char header[BINARY_HEADER_SIZE];
+      std::memcpy (header, g_binaryMagic, sizeof (g_binaryMagic));
+      EncodeU16 (header + 8, BINARY_VERSION);
+      EncodeU16 (header + 10, type);
+      EncodeU16 (header + 12, GetRecordSize (type));
+      EncodeU16 (header + 14, 0);
+      Append (stream, header, BINARY_HEADER_SIZE);
+    }
+  return stream;
+}
+
+void
+MmWaveTraceWriter::Append (Stream& stream, const char* data, size_t size)
+{
+  if (stream.m_used + size > stream.m_buffer.size ())
+    {
+      FlushStream (stream);
+    }
+  std::memcpy (&stream.m_buffer[stream.m_used], data, size);
+  stream.m_used += size;
+}
+
+void
+MmWaveTraceWriter::FlushStream (Stream& stream)
+{
+  if (stream.m_used > 0)
+    {
+      size_t written = fwrite (&stream.m_buffer[0], 1, stream.m_used, stream.m_file);
+      NS_ABORT_MSG_IF (written != stream.m_used, "Error writing trace file");
+      stream.m_used = 0;
+    }
+  fflush (stream.m_file);
+}
+
+void
+MmWaveTraceWriter::Flush (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (std::map<StreamKey_t, Stream>::iterator it = m_streams.begin (); it != m_streams.end (); ++it)
+    {
+      FlushStream (it->second);
+    }
+}
+
+void
+MmWaveTraceWriter::CloseAll (void)
+{
+  for (std::map<StreamKey_t, Stream>::iterator it = m_streams.begin (); it != m_streams.end (); ++it)
+    {
+      FlushStream (it->second);
+      fclose (it->second.m_file);
+    }
+  m_streams.clear ();
+}
+
+void
+MmWaveTraceWriter::WriteRbValues (const char* prefix, uint64_t id, uint64_t slotCount, const SpectrumValue& values)
+{
+  Stream& stream = GetStream (prefix, id, RB_VALUE_RECORD);
+  uint16_t rb = 1;
+  char record[MAX_TEXT_RECORD];
+  for (Values::const_iterator it = values.ConstValuesBegin (); it != values.ConstValuesEnd (); ++it, ++rb)
+    {
+      double valueDb = 10 * std::log10 (*it);
+      if (m_format == BINARY_FORMAT)
+        {
+          EncodeU64 (record, slotCount);
+          EncodeU16 (record + 8, rb);
+          EncodeU16 (record + 10, 0);
+          EncodeFloat (record + 12, valueDb);
+          Append (stream, record, 16);
+        }
+      else
+        {
+          Append (stream, record, FormatRbValue (record, slotCount, rb, valueDb));
+        }
+    }
+}
+
+void
+MmWaveTraceWriter::WritePacketCount (const char* prefix, uint64_t id, uint32_t subframe, uint32_t txBytes, uint32_t rxBytes)
+{
+  Stream& stream = GetStream (prefix, id, PACKET_COUNT_RECORD);
+  char record[MAX_TEXT_RECORD];
+  if (m_format == BINARY_FORMAT)
+    {
+      EncodeU32 (record, subframe);
+      EncodeU32 (record + 4, txBytes);
+      EncodeU32 (record + 8, rxBytes);
+      Append (stream, record, 12);
+    }
+  else
+    {
+      Append (stream, record, FormatPacketCount (record, subframe, txBytes, rxBytes));
+    }
+}
+
+void
+MmWaveTraceWriter::WriteTbSize (const char* prefix, uint64_t id, uint64_t timeUs, uint64_t tbSize)
+{
+  Stream& stream = GetStream (prefix, id, TB_SIZE_RECORD);
+  char record[MAX_TEXT_RECORD];
+  if (m_format == BINARY_FORMAT)
+    {
+      EncodeU64 (record, timeUs);
+      EncodeU64 (record + 8, tbSize);
+      Append (stream, record, 16);
+    }
+  else
+    {
+      Append (stream, record, FormatTbSize (record, timeUs, tbSize));
+    }
+}
+
+bool
+MmWaveTraceWriter::DecodeHeader (const uint8_t* data, BinaryHeader& header)
+{
+  std::memcpy (header.m_magic, data, sizeof (header.m_magic));
+  header.m_version = DecodeU16 (data + 8);
+  header.m_recordType = DecodeU16 (data + 10);
+  header.m_recordSize = DecodeU16 (data + 12);
+  header.m_reserved = DecodeU16 (data + 14);
+  return std::memcmp (header.m_magic, g_binaryMagic, sizeof (g_binaryMagic)) == 0
+         && header.m_version == BINARY_VERSION
+         && header.m_recordSize == GetRecordSize (header.m_recordType);
+}
+
+std::string
+MmWaveTraceWriter::DecodeRecordToText (uint16_t type, const uint8_t* data)
+{
+  char line[MAX_TEXT_RECORD];
+  int len = 0;
+  switch (type)
+    {
+    case RB_VALUE_RECORD:
+      len = FormatRbValue (line, DecodeU64 (data), DecodeU16 (data + 8), DecodeFloat (data + 12));
+      break;
+    case PACKET_COUNT_RECORD:
+      len = FormatPacketCount (line, DecodeU32 (data), DecodeU32 (data + 4), DecodeU32 (data + 8));
+      break;
+    case TB_SIZE_RECORD:
+      len = FormatTbSize (line, DecodeU64 (data), DecodeU64 (data + 8));
+      break;
+    default:
+      NS_FATAL_ERROR ("Unknown trace record type " << type);
+    }
+  return std::string (line, len);
+}
+
+} /* namespace ns3 */
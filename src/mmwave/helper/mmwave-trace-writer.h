@@ -0,0 +1,153 @@
+ /* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+ /*
+ *   Copyright (c) 2015, NYU WIRELESS, Tandon School of Engineering, New York University
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef SRC_MMWAVE_HELPER_MMWAVE_TRACE_WRITER_H_
+#define SRC_MMWAVE_HELPER_MMWAVE_TRACE_WRITER_H_
+
+#include <ns3/object.h>
+#include <ns3/spectrum-value.h>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup mmwave
+ *
+ * Buffered sink for the per-UE PHY trace files written by MmWavePhyRxTrace.
+ *
+ * Each trace file is opened once (in append mode) and kept open for the
+ * whole run. Records are batched in a per-file buffer of BufferSize bytes
+ * and written out with a single fwrite when the buffer fills up, when
+ * Flush () is called, or at Simulator::Destroy ().
+ *
+ * Two output formats are supported. The text format is byte-for-byte the
+ * format historically produced by MmWavePhyRxTrace (files ending in .txt).
+ * The binary format (files ending in .bin) starts with a 16-byte
+ * BinaryHeader followed by fixed-width little-endian records whose layout
+ * depends on the record type:
+ *
+ * - RB_VALUE_RECORD (16 bytes): uint64 slot count, uint16 RB index,
+ *   uint16 reserved, float32 value in dB
+ * - PACKET_COUNT_RECORD (12 bytes): uint32 subframe, uint32 tx bytes,
+ *   uint32 rx bytes
+ * - TB_SIZE_RECORD (16 bytes): uint64 time in microseconds, uint64 TB size
+ *
+ * utils/mmwave-trace-reader converts binary files back to the text format.
+ */
+class MmWaveTraceWriter : public Object
+{
+public:
+  enum Format
+  {
+    TEXT_FORMAT,
+    BINARY_FORMAT
+  };
+
+  enum RecordType
+  {
+    RB_VALUE_RECORD = 1,
+    PACKET_COUNT_RECORD = 2,
+    TB_SIZE_RECORD = 3
+  };
+
+  /// Header written at the beginning of each binary trace file
+  struct BinaryHeader
+  {
+    char m_magic[8];       ///< "MMWTRACE"
+    uint16_t m_version;    ///< format version, currently 1
+    uint16_t m_recordType; ///< one of RecordType
+    uint16_t m_recordSize; ///< size in bytes of each record
+    uint16_t m_reserved;
+  };
+
+  static const uint16_t BINARY_VERSION = 1;
+  static const uint32_t BINARY_HEADER_SIZE = 16;
+
+  MmWaveTraceWriter ();
+  virtual ~MmWaveTraceWriter ();
+  static TypeId GetTypeId (void);
+
+  /**
+   * Append one record per RB holding 10*log10 of the corresponding
+   * entry of \p values.
+   *
+   * \param prefix file name prefix, e.g. "UE_%llu_SINR_dB"
+   * \param id the identifier substituted in the prefix (usually the IMSI)
+   * \param slotCount number of 125 us slots elapsed since the beginning
+   * \param values the per-RB linear values
+   */
+  void WriteRbValues (const char* prefix, uint64_t id, uint64_t slotCount, const SpectrumValue& values);
+  void WritePacketCount (const char* prefix, uint64_t id, uint32_t subframe, uint32_t txBytes, uint32_t rxBytes);
+  void WriteTbSize (const char* prefix, uint64_t id, uint64_t timeUs, uint64_t tbSize);
+
+  /// Write all pending records to their files
+  void Flush (void);
+
+  /**
+   * Size of a binary record of the given type
+   * \param type one of RecordType
+   * \return the record size in bytes, or 0 for an unknown type
+   */
+  static uint16_t GetRecordSize (uint16_t type);
+
+  /**
+   * Parse a binary header
+   * \param data pointer to BINARY_HEADER_SIZE bytes
+   * \param header the decoded header
+   * \return true if the magic and version are valid
+   */
+  static bool DecodeHeader (const uint8_t* data, BinaryHeader& header);
+
+  /**
+   * Convert one binary record to the text trace format
+   * \param type the record type from the file header
+   * \param data pointer to GetRecordSize (type) bytes
+   * \return the text line(s), including the trailing newline
+   */
+  static std::string DecodeRecordToText (uint16_t type, const uint8_t* data);
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  struct Stream
+  {
+    FILE* m_file;
+    std::vector<char> m_buffer;
+    size_t m_used;
+  };
+
+  typedef std::pair<std::string, uint64_t> StreamKey_t;
+
+  Stream& GetStream (const char* prefix, uint64_t id, RecordType type);
+  void Append (Stream& stream, const char* data, size_t size);
+  void FlushStream (Stream& stream);
+  void CloseAll (void);
+
+  std::map<StreamKey_t, Stream> m_streams;
+  Format m_format;
+  uint32_t m_bufferSize;
+};
+
+} /* namespace ns3 */
+
+#endif /* SRC_MMWAVE_HELPER_MMWAVE_TRACE_WRITER_H_ */
@@ -394,11 +394,27 @@ AntennaArrayModel::GetAntennaLocation(uint8_t index, uint8_t* antennaNum)
 void
 AntennaArrayModel::SetSector (uint8_t sector, uint8_t *antennaNum, double elevation)
 {
-	complexVector_t tempVector;
+	m_beamformingVector = GetSectorVector (sector, antennaNum, elevation);
+}
+
+const complexVector_t&
+AntennaArrayModel::GetSectorVector (uint8_t sector, uint8_t *antennaNum, double elevation)
+{
+	// the steering vectors only depend on the geometry of the array, so they are
+	// computed once per array; the map nodes are stable, so the reference stays valid
+	CodebookKey_t key (antennaNum[0], antennaNum[1], m_disV, m_disH, elevation, sector);
+	std::map<CodebookKey_t, complexVector_t>::iterator it = m_codebook.find (key);
+	if (it != m_codebook.end ())
+	{
+		return it->second;
+	}
+
+	complexVector_t& tempVector = m_codebook[key];
 	double hAngle_radian = M_PI*(double)sector/(double)antennaNum[1]-0.5*M_PI;
 	double vAngle_radian = elevation*M_PI/180;
 	uint16_t size = antennaNum[0]*antennaNum[1];
 	double power = 1/sqrt(size);
+	tempVector.reserve (size);
 	for(int ind=0; ind<size; ind++)
 	{
 		Vector loc = GetAntennaLocation(ind, antennaNum);
@@ -407,7 +423,7 @@ AntennaArrayModel::SetSector (uint8_t sector, uint8_t *antennaNum, double elevat
 							+ cos(vAngle_radian)*loc.z);
 		tempVector.push_back(exp(std::complex<double>(0, phase))*power);
 	}
-	m_beamformingVector = tempVector;
+	return tempVector;
 }
 
 
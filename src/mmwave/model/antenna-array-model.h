@@ -28,6 +28,7 @@
 #include <complex>
 #include <ns3/net-device.h>
 #include <map>
+#include <tuple>
 
 namespace ns3 {
 
@@ -51,6 +52,12 @@ public:
 	double GetRadiationPattern (double vangle, double hangle = 0);
 	Vector GetAntennaLocation (uint8_t index, uint8_t* antennaNum) ;
 	void SetSector (uint8_t sector, uint8_t *antennaNum, double elevation = 90);
+	/*
+	 * Get the steering vector that SetSector would set, without changing the current
+	 * beamforming vector. The vectors are cached by the array, so that
+	 * arrays used by different threads share no state.
+	 */
+	const complexVector_t& GetSectorVector (uint8_t sector, uint8_t *antennaNum, double elevation = 90);
 
 private:
 	bool m_omniTx;
@@ -62,6 +69,10 @@ private:
 	double m_disV; //antenna spacing in the vertical direction in terms of wave length.
 	double m_disH; //antenna spacing in the horizontal direction in terms of wave length.
 
+	// steering vectors of the sectors, by array size, spacing, elevation and sector
+	typedef std::tuple<uint8_t, uint8_t, double, double, double, uint8_t> CodebookKey_t;
+	std::map<CodebookKey_t, complexVector_t> m_codebook;
+
 };
 
 } /* namespace ns3 */
@@ -25,6 +25,7 @@
 
 #include "mmwave-3gpp-channel.h"
 #include <ns3/log.h>
+#include <ns3/unused.h>
 #include <ns3/math.h>
 #include <ns3/simulator.h>
 #include <ns3/mmwave-phy.h>
@@ -39,6 +40,8 @@
 #include <random>       // std::default_random_engine
 #include <ns3/boolean.h>
 #include <ns3/integer.h>
+#include <ns3/enum.h>
+#include <ns3/uinteger.h>
 #include "mmwave-spectrum-value-helper.h"
 
 
@@ -157,9 +160,28 @@ static const double sqrtC_office_NLOS[6][6] = {
 		{-0.1, -0.173205, 0.315691, -0.134243, 0.283816, 0.872792},
 };
 
+/*
+ * Copy a square-root correlation matrix into the 7x7 m_sqrtC of a ParamsTable
+ */
+template <uint8_t N>
+static void
+CopySqrtC (double (&sqrtC)[7][7], const double (&table)[N][N])
+{
+	for (uint8_t row = 0; row < N; row++)
+	{
+		for (uint8_t column = 0; column < N; column++)
+		{
+			sqrtC[row][column] = table[row][column];
+		}
+	}
+}
+
 
 
 MmWave3gppChannel::MmWave3gppChannel ()
+	: m_3gppTablesFc (0),
+	  m_numChannelUpdates (0),
+	  m_numChannelReuses (0)
 {
 	m_uniformRv = CreateObject<UniformRandomVariable> ();
 	m_uniformRvBlockage = CreateObject<UniformRandomVariable> ();
@@ -178,10 +200,40 @@ MmWave3gppChannel::GetTypeId (void)
 	static TypeId tid = TypeId ("ns3::MmWave3gppChannel")
 	.SetParent<Object> ()
 	.AddAttribute ("UpdatePeriod",
-				"Enable spatially-consistent UT mobility modeling procedure A, the update period unit is in ms, set to 0 ms to disable update",
+				"Enable spatially-consistent UT mobility modeling procedure A: the channel of a link is updated "
+				"at the first signal received when it is older than this period, set to 0 ms to disable update by age",
 				TimeValue (MilliSeconds (0)),
 				MakeTimeAccessor (&MmWave3gppChannel::m_updatePeriod),
 				MakeTimeChecker ())
+	.AddAttribute ("UpdateDistance",
+				"Enable spatially-consistent UT mobility modeling procedure A: the channel of a link is updated "
+				"at the first signal received after the UT moved more than this distance in meters, set to 0 to disable update by distance",
+				DoubleValue (0),
+				MakeDoubleAccessor (&MmWave3gppChannel::m_updateDistance),
+				MakeDoubleChecker<double> (0))
+	.AddAttribute ("UpdateStaticLinks",
+				"Update by age the channel of a link whose UT did not move and is not moving. The update "
+				"redraws the per-cluster shadowing, so that disabling it keeps the channel of a static link "
+				"frozen, unless the blockage model is enabled",
+				BooleanValue (true),
+				MakeBooleanAccessor (&MmWave3gppChannel::m_updateStaticLinks),
+				MakeBooleanChecker ())
+	.AddAttribute ("NumChannelUpdates",
+				"Number of spatially-consistent channel updates over all the links",
+				TypeId::ATTR_GET,
+				UintegerValue (0),
+				MakeUintegerAccessor (&MmWave3gppChannel::m_numChannelUpdates),
+				MakeUintegerChecker<uint64_t> ())
+	.AddAttribute ("NumChannelReuses",
+				"Number of signals that reused the channel of their link without updating it",
+				TypeId::ATTR_GET,
+				UintegerValue (0),
+				MakeUintegerAccessor (&MmWave3gppChannel::m_numChannelReuses),
+				MakeUintegerChecker<uint64_t> ())
+	.AddTraceSource ("ChannelUpdate",
+				"The channel of a link is updated or reused by a received signal",
+				MakeTraceSourceAccessor (&MmWave3gppChannel::m_channelUpdateTrace),
+				"ns3::MmWave3gppChannel::ChannelUpdateTracedCallback")
 	.AddAttribute ("CellScan",
 				"Use beam search method to determine beamforming vector, the default is long-term covariance matrix method",
 				BooleanValue (false),
@@ -207,6 +259,13 @@ MmWave3gppChannel::GetTypeId (void)
 				BooleanValue (true),
 				MakeBooleanAccessor (&MmWave3gppChannel::m_portraitMode),
 				MakeBooleanChecker ())
+	.AddAttribute ("BeamSearchMethod",
+				"Codebook scan used when CellScan is enabled: Exhaustive tests all the beam pairs, "
+				"Hierarchical tests every other beam and then refines around the best coarse pair",
+				EnumValue (MmWave3gppChannel::EXHAUSTIVE_BEAM_SEARCH),
+				MakeEnumAccessor (&MmWave3gppChannel::m_beamSearchMethod),
+				MakeEnumChecker (MmWave3gppChannel::EXHAUSTIVE_BEAM_SEARCH, "Exhaustive",
+								MmWave3gppChannel::HIERARCHICAL_BEAM_SEARCH, "Hierarchical"))
 	;
 	return tid;
 }
@@ -220,12 +279,21 @@ void
 MmWave3gppChannel::DoDispose ()
 {
 	NS_LOG_FUNCTION (this);
+	m_devices.clear ();
+	m_deviceIds.clear ();
+	m_mobilityIds.clear ();
+	m_3gppLoss = 0;
+	m_3gppBuildingsLoss = 0;
 }
 
 void
 MmWave3gppChannel::SetConfigurationParameters (Ptr<MmWavePhyMacCommon> ptrConfig)
 {
 	m_phyMacConfig = ptrConfig;
+	if (!m_scenario.empty ())
+	{
+		Build3gppTables ();
+	}
 }
 
 Ptr<MmWavePhyMacCommon>
@@ -238,14 +306,88 @@ MmWave3gppChannel::GetConfigurationParameters (void) const
 void
 MmWave3gppChannel::ConnectDevices (Ptr<NetDevice> dev1, Ptr<NetDevice> dev2)
 {
-	key_t key = std::make_pair(dev1,dev2);
+	uint32_t id1 = GetDeviceId (dev1);
+	uint32_t id2 = GetDeviceId (dev2);
+	m_devices[id1].m_links[id2].m_connected = true;
+}
+
+uint32_t
+MmWave3gppChannel::GetDeviceId (Ptr<NetDevice> device) const
+{
+	std::map<Ptr<NetDevice>, uint32_t>::const_iterator it = m_deviceIds.find (device);
+	if (it != m_deviceIds.end ())
+	{
+		return it->second;
+	}
 
-	std::map< key_t, int >::iterator iter = m_connectedPair.find(key);
-	if (iter != m_connectedPair.end ())
+	uint32_t id = m_devices.size ();
+	NS_LOG_INFO ("Register device " << device << " with id " << id);
+	DeviceInfo info;
+	info.m_device = device;
+	info.m_mobility = device->GetNode ()->GetObject<MobilityModel> ();
+	info.m_antennaNum[0] = 0;
+	info.m_antennaNum[1] = 0;
+	Ptr<MmWaveEnbNetDevice> enbDev = DynamicCast<MmWaveEnbNetDevice> (device);
+	Ptr<MmWaveUeNetDevice> ueDev = DynamicCast<MmWaveUeNetDevice> (device);
+	info.m_isEnb = (enbDev != 0);
+	info.m_isUe = (ueDev != 0);
+	if (enbDev != 0)
+	{
+		info.m_antennaNum[0] = sqrt (enbDev->GetAntennaNum ());
+		info.m_antennaNum[1] = sqrt (enbDev->GetAntennaNum ());
+		info.m_antennaArray = DynamicCast<AntennaArrayModel> (
+					enbDev->GetPhy ()->GetDlSpectrumPhy ()->GetRxAntenna ());
+	}
+	else if (ueDev != 0)
+	{
+		info.m_antennaNum[0] = sqrt (ueDev->GetAntennaNum ());
+		info.m_antennaNum[1] = sqrt (ueDev->GetAntennaNum ());
+		info.m_antennaArray = DynamicCast<AntennaArrayModel> (
+					ueDev->GetPhy ()->GetDlSpectrumPhy ()->GetRxAntenna ());
+	}
+	m_devices.push_back (info);
+	m_deviceIds[device] = id;
+	if (info.m_mobility != 0)
+	{
+		m_mobilityIds[PeekPointer (info.m_mobility)] = id;
+	}
+	//every device keeps one link towards each registered device
+	for (std::vector<DeviceInfo>::iterator devIt = m_devices.begin (); devIt != m_devices.end (); ++devIt)
+	{
+		devIt->m_links.resize (m_devices.size ());
+	}
+	return id;
+}
+
+uint32_t
+MmWave3gppChannel::GetDeviceId (Ptr<const MobilityModel> mobility) const
+{
+	std::map<const MobilityModel*, uint32_t>::const_iterator it = m_mobilityIds.find (PeekPointer (mobility));
+	if (it != m_mobilityIds.end ())
+	{
+		return it->second;
+	}
+	uint32_t id = GetDeviceId (mobility->GetObject<Node> ()->GetDevice (0));
+	m_mobilityIds[PeekPointer (mobility)] = id;
+	return id;
+}
+
+char
+MmWave3gppChannel::GetChannelCondition (uint32_t txId, uint32_t rxId) const
+{
+	// the mobility models cached in m_devices are not const, as required by the pathloss models
+	Ptr<MobilityModel> a = m_devices[txId].m_mobility;
+	Ptr<MobilityModel> b = m_devices[rxId].m_mobility;
+	if (m_3gppLoss != 0)
+	{
+		return m_3gppLoss->GetChannelCondition (a, b);
+	}
+	else if (m_3gppBuildingsLoss != 0)
 	{
-		m_connectedPair.erase (iter);
+		return m_3gppBuildingsLoss->GetChannelCondition (a, b);
 	}
-	m_connectedPair.insert(std::make_pair(key,1));
+	NS_FATAL_ERROR("unkonw pathloss model");
+	return 'n';
 }
 
 void
@@ -290,15 +432,13 @@ MmWave3gppChannel::Initial(NetDeviceContainer ueDevices, NetDeviceContainer enbD
 			NS_LOG_INFO("a " << a << " b " << b);
 
 			// initialize the pathloss and channel condition
-			if (DynamicCast<MmWave3gppPropagationLossModel> (m_3gppPathloss)!=0)
+			if (m_3gppLoss!=0)
 			{
-				m_3gppPathloss->GetObject<MmWave3gppPropagationLossModel> ()
-						->GetLoss(a->GetObject<MobilityModel>(),b->GetObject<MobilityModel>());
+				m_3gppLoss->GetLoss(a->GetObject<MobilityModel>(),b->GetObject<MobilityModel>());
 			}			// the GetObject trick is a trick against the const keyword
-			else if (DynamicCast<MmWave3gppBuildingsPropagationLossModel> (m_3gppPathloss)!=0)
+			else if (m_3gppBuildingsLoss!=0)
 			{
-				m_3gppPathloss->GetObject<MmWave3gppBuildingsPropagationLossModel> ()
-						->GetLoss(a->GetObject<MobilityModel>(),b->GetObject<MobilityModel>());
+				m_3gppBuildingsLoss->GetLoss(a->GetObject<MobilityModel>(),b->GetObject<MobilityModel>());
 			}
 			else
 			{
@@ -329,55 +469,31 @@ MmWave3gppChannel::DoCalcRxPowerSpectralDensity (Ptr<const SpectrumValue> txPsd,
 	NS_LOG_FUNCTION (this);
 	Ptr<SpectrumValue> rxPsd = Copy (txPsd);
 
-	Ptr<NetDevice> txDevice = a->GetObject<Node> ()->GetDevice (0);
-	Ptr<NetDevice> rxDevice = b->GetObject<Node> ()->GetDevice (0);
-	Ptr<MmWaveEnbNetDevice> txEnb =
-					DynamicCast<MmWaveEnbNetDevice> (txDevice);
-	Ptr<MmWaveUeNetDevice> rxUe =
-					DynamicCast<MmWaveUeNetDevice> (rxDevice);
+	//both ids are resolved before taking references, registering a device may grow m_devices
+	uint32_t txId = GetDeviceId (a);
+	uint32_t rxId = GetDeviceId (b);
+	const DeviceInfo& txInfo = m_devices[txId];
+	const DeviceInfo& rxInfo = m_devices[rxId];
+	Ptr<NetDevice> txDevice = txInfo.m_device;
+	Ptr<NetDevice> rxDevice = rxInfo.m_device;
 
 	/* txAntennaNum[0]-number of vertical antenna elements
 	 * txAntennaNum[1]-number of horizontal antenna elements*/
-	uint8_t txAntennaNum[2];
-	uint8_t rxAntennaNum[2];
-	Ptr<AntennaArrayModel> txAntennaArray, rxAntennaArray;
+	uint8_t txAntennaNum[2] = {txInfo.m_antennaNum[0], txInfo.m_antennaNum[1]};
+	uint8_t rxAntennaNum[2] = {rxInfo.m_antennaNum[0], rxInfo.m_antennaNum[1]};
+	Ptr<AntennaArrayModel> txAntennaArray = txInfo.m_antennaArray;
+	Ptr<AntennaArrayModel> rxAntennaArray = rxInfo.m_antennaArray;
 
 	Vector locUT;
-	if(txEnb!=0 && rxUe!=0)
+	if(txInfo.m_isEnb && rxInfo.m_isUe)
 	{
 		NS_LOG_INFO ("this is downlink case, a tx " << a->GetPosition() << " b rx " << b->GetPosition());
-		txAntennaNum[0] = sqrt (txEnb->GetAntennaNum ());
-		txAntennaNum[1] = sqrt (txEnb->GetAntennaNum ());
-		rxAntennaNum[0] = sqrt (rxUe->GetAntennaNum ());
-		rxAntennaNum[1] = sqrt (rxUe->GetAntennaNum ());
-
-		txAntennaArray = DynamicCast<AntennaArrayModel> (
-					txEnb->GetPhy ()->GetDlSpectrumPhy ()->GetRxAntenna ());
-		rxAntennaArray = DynamicCast<AntennaArrayModel> (
-					rxUe->GetPhy ()->GetDlSpectrumPhy ()->GetRxAntenna ());
 		locUT = b->GetPosition();
-
 	}
-	else if (txEnb==0 && rxUe==0 )
+	else if (txInfo.m_isUe && rxInfo.m_isEnb)
 	{
 		NS_LOG_INFO ("this is uplink case, a tx " << a->GetPosition() << " b rx " << b->GetPosition());
-
-		Ptr<MmWaveUeNetDevice> txUe =
-						DynamicCast<MmWaveUeNetDevice> (txDevice);
-		Ptr<MmWaveEnbNetDevice> rxEnb =
-						DynamicCast<MmWaveEnbNetDevice> (rxDevice);
-
-		txAntennaNum[0] = sqrt (txUe->GetAntennaNum ());
-		txAntennaNum[1] = sqrt (txUe->GetAntennaNum ());
-		rxAntennaNum[0] = sqrt (rxEnb->GetAntennaNum ());
-		rxAntennaNum[1] = sqrt (rxEnb->GetAntennaNum ());
-
-		txAntennaArray = DynamicCast<AntennaArrayModel> (
-					txUe->GetPhy ()->GetDlSpectrumPhy ()->GetRxAntenna ());
-		rxAntennaArray = DynamicCast<AntennaArrayModel> (
-					rxEnb->GetPhy ()->GetDlSpectrumPhy ()->GetRxAntenna ());
 		locUT = a->GetPosition();
-
 	}
 	else
 	{
@@ -402,11 +518,8 @@ MmWave3gppChannel::DoCalcRxPowerSpectralDensity (Ptr<const SpectrumValue> txPsd,
 	Vector txSpeed = a->GetVelocity();
 	Vector relativeSpeed (rxSpeed.x-txSpeed.x,rxSpeed.y-txSpeed.y,rxSpeed.z-txSpeed.z);
 
-	key_t key = std::make_pair(txDevice,rxDevice);
-	key_t keyReverse = std::make_pair(rxDevice,txDevice);
-
-	std::map< key_t, Ptr<Params3gpp> >::iterator it = m_channelMap.find (key);
-	std::map< key_t, Ptr<Params3gpp> >::iterator itReverse = m_channelMap.find (keyReverse);
+	LinkState& link = m_devices[txId].m_links[rxId];
+	LinkState& reverseLinkState = m_devices[rxId].m_links[txId];
 
 	Ptr<Params3gpp> channelParams;
 
@@ -414,21 +527,7 @@ MmWave3gppChannel::DoCalcRxPowerSpectralDensity (Ptr<const SpectrumValue> txPsd,
 
 	//Step 2: Assign propagation condition (LOS/NLOS).
 
-	char condition;
-	if (DynamicCast<MmWave3gppPropagationLossModel> (m_3gppPathloss)!=0)
-	{
-		condition = m_3gppPathloss->GetObject<MmWave3gppPropagationLossModel> ()
-				->GetChannelCondition(a->GetObject<MobilityModel>(),b->GetObject<MobilityModel>());
-	}
-	else if (DynamicCast<MmWave3gppBuildingsPropagationLossModel> (m_3gppPathloss)!=0)
-	{
-		condition = m_3gppPathloss->GetObject<MmWave3gppBuildingsPropagationLossModel> ()
-				->GetChannelCondition(a->GetObject<MobilityModel>(),b->GetObject<MobilityModel>());
-	}
-	else
-	{
-		NS_FATAL_ERROR("unkonw pathloss model");
-	}
+	char condition = GetChannelCondition (txId, rxId);
 	bool los = false;
 	bool o2i = false;
 	if(condition == 'l')
@@ -446,20 +545,25 @@ MmWave3gppChannel::DoCalcRxPowerSpectralDensity (Ptr<const SpectrumValue> txPsd,
 		o2i = true;
 	}
 
-	//Every m_updatedPeriod, the channel matrix is deleted and a consistent channel update is triggered.
+	//When a signal is received after the UT moved more than m_updateDistance, or more than m_updatePeriod
+	//after the channel was generated, the channel matrix is deleted and a consistent channel update is triggered.
 	//When there is a LOS/NLOS switch, a new uncorrelated channel is created.
 	//Therefore, LOS/NLOS condition of updating is always consistent with the previous channel.
+	if (link.m_channel != 0 && link.m_channel->m_channel.size() != 0 && link.m_channel->m_los == los
+			&& IsChannelUpdateDue (link.m_channel, locUT, relativeSpeed))
+	{
+		NS_LOG_INFO("Time " << Simulator::Now().GetSeconds() << " update due for a " << a->GetPosition() << " b " << b->GetPosition());
+		link.m_channel->m_channel.clear();
+	}
 
 	//I only update the fowrad channel.
-	if ((it == m_channelMap.end () && itReverse == m_channelMap.end ()) ||
-			(it != m_channelMap.end () && it->second->m_channel.size() == 0)||
-			(it != m_channelMap.end () && it->second->m_los != los))
+	if ((link.m_channel == 0 && reverseLinkState.m_channel == 0) ||
+			(link.m_channel != 0 && link.m_channel->m_channel.size() == 0)||
+			(link.m_channel != 0 && link.m_channel->m_los != los))
 	{
 		NS_LOG_INFO("Update or create the forward channel");
-		NS_LOG_LOGIC("it == m_channelMap.end () " << (it == m_channelMap.end ()));
-		NS_LOG_LOGIC("itReverse == m_channelMap.end () " << (itReverse == m_channelMap.end ()));
-		NS_LOG_LOGIC("it->second->m_channel.size() == 0 " << (it->second->m_channel.size() == 0));
-		NS_LOG_LOGIC("it->second->m_los != los" << (it->second->m_los != los));
+		NS_LOG_LOGIC("link.m_channel == 0 " << (link.m_channel == 0));
+		NS_LOG_LOGIC("reverseLinkState.m_channel == 0 " << (reverseLinkState.m_channel == 0));
 		
 		//Step 1: The parameters are configured in the example code.
 		/*make sure txAngle rxAngle exist, i.e., the position of tx and rx cannot be the same*/
@@ -476,7 +580,7 @@ MmWave3gppChannel::DoCalcRxPowerSpectralDensity (Ptr<const SpectrumValue> txPsd,
 		double y = a->GetPosition().y-b->GetPosition().y;
 		double distance2D = sqrt (x*x +y*y);
 		double hUT, hBS;
-		if(rxUe != 0)
+		if(rxInfo.m_isUe)
 		{
 			hUT = b->GetPosition().z;
 			hBS = a->GetPosition().z;
@@ -490,34 +594,26 @@ MmWave3gppChannel::DoCalcRxPowerSpectralDensity (Ptr<const SpectrumValue> txPsd,
 		Ptr<ParamsTable> table3gpp = Get3gppTable(los, o2i, hBS, hUT, distance2D);
 
 		// Step 4-11 are performed in function GetNewChannel()
-		if((it == m_channelMap.end () && itReverse == m_channelMap.end ()) ||
-				(it != m_channelMap.end () && it->second->m_channel.size() == 0))
-		{
-			//delete the channel parameter to cause the channel to be updated again.
-			//The m_updatePeriod can be configured to be relatively large in order to disable updates.
-			if(m_updatePeriod.GetMilliSeconds() > 0)
-			{
-				NS_LOG_INFO("Time " << Simulator::Now().GetSeconds() << " schedule delete for a " << a->GetPosition() << " b " << b->GetPosition());
-				Simulator::Schedule (m_updatePeriod, &MmWave3gppChannel::DeleteChannel,this,a,b);
-			}
-		}
 
 		double distance3D = a->GetDistanceFrom(b);
 
-		if(it != m_channelMap.end () && it->second->m_channel.size() == 0)
+		if(link.m_channel != 0 && link.m_channel->m_channel.size() == 0)
 		{
 			//if the channel map is not empty, we only update the channel.
 			NS_LOG_DEBUG ("Update forward channel consistently");
-			it->second->m_locUT = locUT;
-			it->second->m_los = los;
-			it->second->m_o2i = o2i;
-			channelParams = UpdateChannel(it->second, table3gpp, txAntennaArray, rxAntennaArray,
+			link.m_channel->m_locUT = locUT;
+			link.m_channel->m_los = los;
+			link.m_channel->m_o2i = o2i;
+			channelParams = UpdateChannel(link.m_channel, table3gpp, txAntennaArray, rxAntennaArray,
 					txAntennaNum, rxAntennaNum, rxAngle, txAngle);
-			it->second->m_dis3D = distance3D;
-			it->second->m_dis2D = distance2D;
-			it->second->m_speed = relativeSpeed;
-			it->second->m_generatedTime = Now();
-			it->second->m_preLocUT = locUT;
+			link.m_channel->m_dis3D = distance3D;
+			link.m_channel->m_dis2D = distance2D;
+			link.m_channel->m_speed = relativeSpeed;
+			link.m_channel->m_generatedTime = Now();
+			link.m_channel->m_preLocUT = locUT;
+			link.m_numUpdates++;
+			m_numChannelUpdates++;
+			m_channelUpdateTrace (txDevice, rxDevice, true);
 
 		}
 		else
@@ -527,8 +623,7 @@ MmWave3gppChannel::DoCalcRxPowerSpectralDensity (Ptr<const SpectrumValue> txPsd,
 			channelParams = GetNewChannel(table3gpp, locUT, los, o2i, txAntennaArray, rxAntennaArray,
 					txAntennaNum, rxAntennaNum, rxAngle, txAngle, relativeSpeed, distance2D, distance3D);
 		}
-		std::map< key_t, int >::iterator it1 = m_connectedPair.find (key);
-		if(it1 != m_connectedPair.end ())
+		if(link.m_connected)
 		{
 			if(m_cellScan)
 			{
@@ -550,37 +645,45 @@ MmWave3gppChannel::DoCalcRxPowerSpectralDensity (Ptr<const SpectrumValue> txPsd,
 			{
 				NS_LOG_INFO("channelParams->m_txW.size() == 0 " << (channelParams->m_txW.size() == 0));
 				NS_LOG_INFO("channelParams->m_rxW.size() == 0 " << (channelParams->m_rxW.size() == 0));
-				m_channelMap[key] = channelParams;
+				link.m_channel = channelParams;
 				return rxPsd;
 			}
 		}
 
 		CalLongTerm (channelParams);
-		m_channelMap[key] = channelParams;
+		link.m_channel = channelParams;
 	}
-	else if (itReverse == m_channelMap.end ()) //Find channel matrix in the forward link
+	else if (reverseLinkState.m_channel == 0) //Find channel matrix in the forward link
 	{
-		channelParams = (*it).second;
+		channelParams = link.m_channel;
+		link.m_numReuses++;
+		m_numChannelReuses++;
+		m_channelUpdateTrace (txDevice, rxDevice, false);
 	}
 	else //Find channel matrix in the Reverse link
 	{
 		reverseLink = true;
-		channelParams = (*itReverse).second;
+		channelParams = reverseLinkState.m_channel;
+		reverseLinkState.m_numReuses++;
+		m_numChannelReuses++;
+		m_channelUpdateTrace (rxDevice, txDevice, false);
 	}
 
-	Ptr<SpectrumValue> bfPsd = CalBeamformingGain(rxPsd, channelParams, relativeSpeed);
-
-	SpectrumValue bfGain = (*bfPsd)/(*rxPsd);
-	uint8_t nbands = bfGain.GetSpectrumModel ()->GetNumBands ();
+	//the BF gain is applied in place, rxPsd still holds the tx PSD at this point
+	uint8_t nbands = rxPsd->GetSpectrumModel ()->GetNumBands ();
+	double rxPsdAvg = Sum(*rxPsd)/nbands;
+	double bfGain = CalBeamformingGain(*rxPsd, PeekPointer (rxPsd), channelParams, relativeSpeed);
 	if (reverseLink == false)
 	{
-		NS_LOG_DEBUG ("****** DL BF gain == " << Sum (bfGain)/nbands << " RX PSD " << Sum(*rxPsd)/nbands); // print avg bf gain
+		NS_LOG_DEBUG ("****** DL BF gain == " << bfGain << " RX PSD " << rxPsdAvg); // print avg bf gain
 	}
 	else
 	{
-		NS_LOG_DEBUG ("****** UL BF gain == " << Sum (bfGain)/nbands << " RX PSD " << Sum(*rxPsd)/nbands);
+		NS_LOG_DEBUG ("****** UL BF gain == " << bfGain << " RX PSD " << rxPsdAvg);
 	}
-	return bfPsd;
+	NS_UNUSED (rxPsdAvg);
+	NS_UNUSED (bfGain);
+	return rxPsd;
 }
 
 void
@@ -736,56 +839,73 @@ MmWave3gppChannel::LongTermCovMatrixBeamforming(Ptr<Params3gpp> params) const
 	params->m_rxW = antennaWeights;
 }
 
-Ptr<SpectrumValue>
-MmWave3gppChannel::CalBeamformingGain (Ptr<const SpectrumValue> txPsd, Ptr<Params3gpp> params, Vector speed) const
+double
+MmWave3gppChannel::CalBeamformingGain (const SpectrumValue& txPsd, SpectrumValue* rxPsd, Ptr<Params3gpp> params, Vector speed) const
 {
 	NS_LOG_FUNCTION (this);
 
-	Ptr<SpectrumValue> tempPsd = Copy<SpectrumValue> (txPsd);
-
-	//NS_ASSERT_MSG (params->m_delay.size()==params->m_channel.at(0).at(0).size(), "the cluster number of channel and delay spread should be the same");
-	//NS_ASSERT_MSG (params->m_txW.size()==params->m_channel.at(0).size(), "the tx antenna size of channel and antenna weights should be the same");
-	//NS_ASSERT_MSG (params->m_rxW.size()==params->m_channel.size(), "the rx antenna size of channel and antenna weights should be the same");
-	//NS_ASSERT_MSG (params->m_angle.at(0).size()==params->m_channel.at(0).at(0).size(), "the cluster number of channel and AOA should be the same");
-	//NS_ASSERT_MSG (params->m_angle.at(1).size()==params->m_channel.at(0).at(0).size(), "the cluster number of channel and ZOA should be the same");
-
-	//channel[rx][tx][cluster]
 	uint8_t numCluster = params->m_delay.size();
-	//uint8_t txAntenna = params->m_txW.size();
-	//uint8_t rxAntenna = params->m_rxW.size();
+	NS_ASSERT_MSG (params->m_bfStartRe.size() == numCluster, "CalLongTerm must be called before CalBeamformingGain");
+
 	//the update of Doppler is simplified by only taking the center angle of each cluster in to consideration.
-	Values::iterator vit = tempPsd->ValuesBegin ();
-	uint16_t iSubband = 0;
+	//the initial phase of each cluster includes the long term component, the doppler and the delay at the lowest subband.
 	double slotTime = Simulator::Now ().GetSeconds ();
-	complexVector_t doppler;
+	m_bfPhaseRe.resize (numCluster);
+	m_bfPhaseIm.resize (numCluster);
+	double* phaseRe = m_bfPhaseRe.data ();
+	double* phaseIm = m_bfPhaseIm.data ();
+	const double* stepRe = params->m_bfStepRe.data ();
+	const double* stepIm = params->m_bfStepIm.data ();
 	for (uint8_t cIndex = 0; cIndex < numCluster; cIndex++)
 	{
-		//cluster angle angle[direction][n],where, direction = 0(aoa), 1(zoa).
-		double temp_doppler = 2*M_PI*(sin(params->m_angle.at(ZOA_INDEX).at(cIndex)*M_PI/180)*cos(params->m_angle.at(AOA_INDEX).at(cIndex)*M_PI/180)*speed.x
-				+ sin(params->m_angle.at(ZOA_INDEX).at(cIndex)*M_PI/180)*sin(params->m_angle.at(AOA_INDEX).at(cIndex)*M_PI/180)*speed.y
-				+ cos(params->m_angle.at(ZOA_INDEX).at(cIndex)*M_PI/180)*speed.z)*slotTime*m_phyMacConfig->GetCentreFrequency ()/3e8;
-		doppler.push_back(exp(std::complex<double> (0, temp_doppler)));
-
+		double dopplerPhase = (params->m_dopplerX[cIndex]*speed.x + params->m_dopplerY[cIndex]*speed.y
+				+ params->m_dopplerZ[cIndex]*speed.z)*slotTime;
+		double dopplerRe = cos (dopplerPhase);
+		double dopplerIm = sin (dopplerPhase);
+		phaseRe[cIndex] = params->m_bfStartRe[cIndex]*dopplerRe - params->m_bfStartIm[cIndex]*dopplerIm;
+		phaseIm[cIndex] = params->m_bfStartRe[cIndex]*dopplerIm + params->m_bfStartIm[cIndex]*dopplerRe;
 	}
 
-	while (vit != tempPsd->ValuesEnd ())
+	double gainSum = 0;
+	uint32_t numActive = 0;
+	Values::const_iterator vit = txPsd.ConstValuesBegin ();
+	Values::iterator rit;
+	if (rxPsd != 0)
+	{
+		rit = rxPsd->ValuesBegin ();
+	}
+	while (vit != txPsd.ConstValuesEnd ())
 	{
-		std::complex<double> subsbandGain (0.0,0.0);
-		if ((*vit) != 0.00)
+		double value = *vit;
+		if (value != 0.00)
 		{
-			double fsb = m_phyMacConfig->GetCentreFrequency () - GetSystemBandwidth ()/2 + m_phyMacConfig->GetChunkWidth ()*iSubband ;
+			double sumRe = 0;
+			double sumIm = 0;
 			for (uint8_t cIndex = 0; cIndex < numCluster; cIndex++)
 			{
-				double delay = -2*M_PI*fsb*(params->m_delay.at (cIndex));
-				std::complex<double> txSum(0,0);
-				subsbandGain = subsbandGain + params->m_longTerm.at(cIndex)*doppler.at(cIndex)*exp(std::complex<double>(0, delay));
+				sumRe += phaseRe[cIndex];
+				sumIm += phaseIm[cIndex];
 			}
-			*vit = (*vit)*(norm (subsbandGain));
+			double gain = sumRe*sumRe + sumIm*sumIm;
+			gainSum += gain;
+			numActive++;
+			value *= gain;
+		}
+		if (rxPsd != 0)
+		{
+			*rit = value;
+			rit++;
+		}
+		//move to the next subband
+		for (uint8_t cIndex = 0; cIndex < numCluster; cIndex++)
+		{
+			double re = phaseRe[cIndex]*stepRe[cIndex] - phaseIm[cIndex]*stepIm[cIndex];
+			phaseIm[cIndex] = phaseRe[cIndex]*stepIm[cIndex] + phaseIm[cIndex]*stepRe[cIndex];
+			phaseRe[cIndex] = re;
 		}
 		vit++;
-		iSubband++;
 	}
-	return tempPsd;
+	return numActive > 0 ? gainSum/numActive : 0;
 }
 
 double
@@ -800,18 +920,24 @@ void
 MmWave3gppChannel::SetPathlossModel (Ptr<PropagationLossModel> pathloss)
 {
 	m_3gppPathloss = pathloss;
-	if (DynamicCast<MmWave3gppPropagationLossModel> (m_3gppPathloss)!=0)
+	m_3gppLoss = DynamicCast<MmWave3gppPropagationLossModel> (m_3gppPathloss);
+	m_3gppBuildingsLoss = DynamicCast<MmWave3gppBuildingsPropagationLossModel> (m_3gppPathloss);
+	if (m_3gppLoss!=0)
 	{
-		m_scenario = m_3gppPathloss->GetObject<MmWave3gppPropagationLossModel> ()->GetScenario();
+		m_scenario = m_3gppLoss->GetScenario();
 	}
-	else if (DynamicCast<MmWave3gppBuildingsPropagationLossModel> (m_3gppPathloss)!=0)
+	else if (m_3gppBuildingsLoss!=0)
 	{
-		m_scenario = m_3gppPathloss->GetObject<MmWave3gppBuildingsPropagationLossModel> ()->GetScenario();
+		m_scenario = m_3gppBuildingsLoss->GetScenario();
 	}
 	else
 	{
 		NS_FATAL_ERROR("unkonw pathloss model");
 	}
+	if (m_phyMacConfig != 0)
+	{
+		Build3gppTables ();
+	}
 }
 
 
@@ -842,208 +968,229 @@ MmWave3gppChannel::CalLongTerm (Ptr<Params3gpp> params) const
 	}
 	params->m_longTerm = longTerm;
 
+	//precompute the per-cluster terms of CalBeamformingGain, the phase of cluster n at subband k is
+	//longTerm[n]*doppler[n]*exp(-j*2*pi*(f0+k*chunkWidth)*delay[n]).
+	double f0 = m_phyMacConfig->GetCentreFrequency () - GetSystemBandwidth ()/2;
+	double chunkWidth = m_phyMacConfig->GetChunkWidth ();
+	double dopplerFactor = 2*M_PI*m_phyMacConfig->GetCentreFrequency ()/3e8;
+	params->m_bfStartRe.resize (numCluster);
+	params->m_bfStartIm.resize (numCluster);
+	params->m_bfStepRe.resize (numCluster);
+	params->m_bfStepIm.resize (numCluster);
+	params->m_dopplerX.resize (numCluster);
+	params->m_dopplerY.resize (numCluster);
+	params->m_dopplerZ.resize (numCluster);
+	for (uint8_t cIndex = 0; cIndex < numCluster; cIndex++)
+	{
+		std::complex<double> start = longTerm[cIndex]*exp(std::complex<double>(0, -2*M_PI*f0*params->m_delay[cIndex]));
+		params->m_bfStartRe[cIndex] = start.real ();
+		params->m_bfStartIm[cIndex] = start.imag ();
+		double step = -2*M_PI*chunkWidth*params->m_delay[cIndex];
+		params->m_bfStepRe[cIndex] = cos (step);
+		params->m_bfStepIm[cIndex] = sin (step);
+
+		//cluster angle angle[direction][n],where, direction = 0(aoa), 1(zoa).
+		double zoa = params->m_angle.at(ZOA_INDEX).at(cIndex)*M_PI/180;
+		double aoa = params->m_angle.at(AOA_INDEX).at(cIndex)*M_PI/180;
+		params->m_dopplerX[cIndex] = dopplerFactor*sin(zoa)*cos(aoa);
+		params->m_dopplerY[cIndex] = dopplerFactor*sin(zoa)*sin(aoa);
+		params->m_dopplerZ[cIndex] = dopplerFactor*cos(zoa);
+	}
+
 }
 
-Ptr<ParamsTable>
-MmWave3gppChannel::Get3gppTable (bool los, bool o2i, double hBS, double hUT, double distance2D) const
+void
+MmWave3gppChannel::Build3gppTables () const
 {
 	double fcGHz = m_phyMacConfig->GetCentreFrequency ()/1e9;
-	Ptr<ParamsTable> table3gpp = CreateObject<ParamsTable> ();
-	// table3gpp includes the following parameters:
+	NS_LOG_FUNCTION (this << m_scenario << fcGHz);
+	for (uint8_t i = 0; i < NUM_3GPP_TABLES; i++)
+	{
+		m_3gppTables[i] = CreateObject<ParamsTable> ();
+	}
+	Ptr<ParamsTable> losTable = m_3gppTables[LOS_3GPP_TABLE];
+	Ptr<ParamsTable> nlosTable = m_3gppTables[NLOS_3GPP_TABLE];
+	Ptr<ParamsTable> o2iTable = m_3gppTables[O2I_3GPP_TABLE];
+	// the tables include the following parameters:
 	// numOfCluster, raysPerCluster, uLgDS, sigLgDS, uLgASD, sigLgASD,
 	// uLgASA, sigLgASA, uLgZSA, sigLgZSA, uLgZSD, sigLgZSD, offsetZOD,
 	// cDS, cASD, cASA, cZSA, uK, sigK, rTau, shadowingStd
+	// uLgZSD and offsetZOD depend on the distance and on the heights, and are set by Get3gppTable.
 
 	//In NLOS case, parameter uK and sigK are not used and 0 is passed into the SetParams() function.
 	if (m_scenario == "RMa")
+	{
+		//For RMa, the outdoor LOS/NLOS and o2i LOS/NLOS is the same.
+		//3GPP mentioned that 3.91 ns should be used when the Cluster DS (cDS) entry is N/A.
+		losTable->SetParams(11, 20, -7.49, 0.55, 0.90, 0.38, 1.52, 0.24, 0.60, 0.16,
+				0.3, 0.4, 0, 3.91e-9, 2, 3, 3, 7, 4, 3.8, 3);
+		CopySqrtC (losTable->m_sqrtC, sqrtC_RMa_LOS);
+		nlosTable->SetParams(10, 20, -7.43, 0.48, 0.95, 0.45, 1.52, 0.13, 0.88, 0.16,
+				0.3, 0.49, 0, 3.91e-9, 2, 3, 3, 0, 0, 1.7 ,3);
+		CopySqrtC (nlosTable->m_sqrtC, sqrtC_RMa_NLOS);
+	}
+	else if (m_scenario == "UMa")
+	{
+		double cDs = std::max(0.25, -3.4084*log10(fcGHz)+6.5622)*1e-9;
+		losTable->SetParams(12, 20, -6.955-0.0963*log10(fcGHz), 0.66, 1.06+0.1114*log10(fcGHz),
+				0.28, 1.81, 0.20, 0.95, 0.16, 0, 0.40, 0, cDs, 5, 11, 7, 9, 3.5, 2.5, 3);
+		CopySqrtC (losTable->m_sqrtC, sqrtC_UMa_LOS);
+		nlosTable->SetParams(20, 20, -6.28-0.204*log10(fcGHz), 0.39, 1.5-0.1144*log10(fcGHz),
+				0.28, 2.08-0.27*log10(fcGHz), 0.11, -0.3236*log10(fcGHz)+1.512, 0.16, 0,
+				0.49, 0, cDs, 2, 15, 7, 0, 0, 2.3, 3);
+		CopySqrtC (nlosTable->m_sqrtC, sqrtC_UMa_NLOS);
+		o2iTable->SetParams(12, 20, -6.62, 0.32, 1.25, 0.42, 1.76, 0.16, 1.01, 0.43,
+				0, 0.49, 0, 11e-9, 5, 20, 6, 0, 0, 2.2, 4);
+		CopySqrtC (o2iTable->m_sqrtC, sqrtC_UMa_O2I);
+	}
+	else if (m_scenario == "UMi-StreetCanyon")
+	{
+		losTable->SetParams(12, 20, -0.24*log10(1+fcGHz)-7.14, 0.38, -0.05*log10(1+fcGHz)+1.21, 0.41,
+				-0.08*log10(1+fcGHz)+1.73, 0.014*log10(1+fcGHz)+0.28, -0.1*log10(1+fcGHz)+0.73, -0.04*log10(1+fcGHz)+0.34,
+				0, 0.35, 0, 5e-9, 3, 17, 7, 9, 5, 3, 3);
+		CopySqrtC (losTable->m_sqrtC, sqrtC_UMi_LOS);
+		nlosTable->SetParams(19, 20, -0.24*log10(1+fcGHz)-6.83, 0.16*log10(1+fcGHz)+0.28, -0.23*log10(1+fcGHz)+1.53,
+				0.11*log10(1+fcGHz)+0.33, -0.08*log10(1+fcGHz)+1.81, 0.05*log10(1+fcGHz)+0.3,
+				-0.04*log10(1+fcGHz)+0.92, -0.07*log10(1+fcGHz)+0.41, 0, 0.35, 0,
+				11e-9, 10, 22, 7, 0, 0, 2.1, 3);
+		CopySqrtC (nlosTable->m_sqrtC, sqrtC_UMi_NLOS);
+		o2iTable->SetParams(12, 20, -6.62, 0.32, 1.25, 0.42, 1.76, 0.16, 1.01, 0.43,
+				0, 0.35, 0, 11e-9, 5, 20, 6, 0, 0, 2.2, 4);
+		CopySqrtC (o2iTable->m_sqrtC, sqrtC_UMi_O2I);
+	}
+	else if (m_scenario == "InH-OfficeMixed"||m_scenario == "InH-OfficeOpen")
+	{
+		losTable->SetParams(8, 20, -0.01*log10(1+fcGHz)-7.79, -0.16*log10(1+fcGHz)+0.50, 1.60, 0.18,
+				-0.19*log10(1+fcGHz)+1.86, 0.12*log10(1+fcGHz), -0.26*log10(1+fcGHz)+1.21, -0.04*log10(1+fcGHz)+0.17,
+				-1.43*log10(1+fcGHz)+2.25, 0.13*log10(1+fcGHz)+0.15, 0, 3.91e-9, 7, -6.2*log10(1+fcGHz)+16.72,
+				-3.85*log10(1+fcGHz)+10.28, 0.84*log10(1+fcGHz)+2.12, -0.58*log10(1+fcGHz)+6.19, 2.15, 6);
+		CopySqrtC (losTable->m_sqrtC, sqrtC_office_LOS);
+		nlosTable->SetParams(10, 20, -0.28*log10(1+fcGHz)-7.29, 0.1*log10(1+fcGHz)+0.11, 1.49, 0.17,
+				-0.11*log10(1+fcGHz)+1.8, 0.12*log10(1+fcGHz), -0.15*log10(1+fcGHz)+1.04, -0.09*log10(1+fcGHz)+0.24,
+				1.37, 0.38, 0, 3.91e-9, 3, -13.0*log10(1+fcGHz)+30.53, -3.72*log10(1+fcGHz)+10.25, 0, 0, 1.84, 3);
+		CopySqrtC (nlosTable->m_sqrtC, sqrtC_office_NLOS);
+	}
+	else
+	{
+		//Note that the InH-ShoppingMall scenario is not given in the table 7.5-6
+		NS_FATAL_ERROR("unkonw scenarios");
+	}
+	m_3gppTablesFc = m_phyMacConfig->GetCentreFrequency ();
+	m_3gppTablesScenario = m_scenario;
+}
+
+Ptr<ParamsTable>
+MmWave3gppChannel::Get3gppTable (bool los, bool o2i, double hBS, double hUT, double distance2D) const
+{
+	if (m_3gppTables[LOS_3GPP_TABLE] == 0 || m_3gppTablesFc != m_phyMacConfig->GetCentreFrequency ()
+			|| m_3gppTablesScenario != m_scenario)
+	{
+		Build3gppTables ();
+	}
+	double fcGHz = m_phyMacConfig->GetCentreFrequency ()/1e9;
+	// only uLgZSD and offsetZOD depend on the position of the devices, they are written
+	// in the precomputed table of the condition, which is used before the next call.
+	Ptr<ParamsTable> table3gpp;
+	if (m_scenario == "RMa")
 	{
 		//For RMa, the outdoor LOS/NLOS and o2i LOS/NLOS is the same.
 		if(los)
 		{
-			//3GPP mentioned that 3.91 ns should be used when the Cluster DS (cDS) entry is N/A.
-			table3gpp->SetParams(11, 20, -7.49, 0.55, 0.90, 0.38, 1.52, 0.24, 0.60, 0.16,
-					0.3, 0.4, 0, 3.91e-9, 2, 3, 3, 7, 4, 3.8, 3);
-			for (uint8_t row = 0; row < 7; row++)
-			{
-				for (uint8_t column = 0; column < 7; column++)
-				{
-					table3gpp->m_sqrtC[row][column] = sqrtC_RMa_LOS[row][column];
-				}
-			}
+			table3gpp = m_3gppTables[LOS_3GPP_TABLE];
 		}
 		else
 		{
-			double offsetZod = atan((35-5)/distance2D)-atan((35-1.5)/distance2D);
-			table3gpp->SetParams(10, 20, -7.43, 0.48, 0.95, 0.45, 1.52, 0.13, 0.88, 0.16,
-					0.3, 0.49, offsetZod, 3.91e-9, 2, 3, 3, 0, 0, 1.7 ,3);
-			for (uint8_t row = 0; row < 6; row++)
-			{
-				for (uint8_t column = 0; column < 6; column++)
-				{
-					table3gpp->m_sqrtC[row][column] = sqrtC_RMa_NLOS[row][column];
-				}
-			}
+			table3gpp = m_3gppTables[NLOS_3GPP_TABLE];
+			table3gpp->m_offsetZOD = atan((35-5)/distance2D)-atan((35-1.5)/distance2D);
 		}
 	}
 	else if (m_scenario == "UMa")
 	{
 		if(los && !o2i)
 		{
-			double uLgZSD = std::max(-0.5, -2.1*distance2D/1000-0.01*(hUT-1.5)+0.75);
-			double cDs = std::max(0.25, -3.4084*log10(fcGHz)+6.5622)*1e-9;
-			table3gpp->SetParams(12, 20, -6.955-0.0963*log10(fcGHz), 0.66, 1.06+0.1114*log10(fcGHz),
-					0.28, 1.81, 0.20, 0.95, 0.16, uLgZSD, 0.40, 0, cDs, 5, 11, 7, 9, 3.5, 2.5, 3);
-			for (uint8_t row = 0; row < 7; row++)
-			{
-				for (uint8_t column = 0; column < 7; column++)
-				{
-					table3gpp->m_sqrtC[row][column] = sqrtC_UMa_LOS[row][column];
-				}
-			}
+			table3gpp = m_3gppTables[LOS_3GPP_TABLE];
+			table3gpp->m_uLgZSD = std::max(-0.5, -2.1*distance2D/1000-0.01*(hUT-1.5)+0.75);
 		}
 		else
 		{
-			double uLgZSD = std::max(-0.5, -2.1*distance2D/1000-0.01*(hUT-1.5)+0.9);
-
 			double afc = 0.208*log10(fcGHz)-0.782;
 			double bfc = 25;
 			double cfc = -0.13*log10(fcGHz)+2.03;
 			double efc = 7.66*log10(fcGHz)-5.96;
 
-			double offsetZOD = efc-std::pow(10, afc*log10(std::max(bfc,distance2D))+cfc);
-			double cDS = std::max(0.25, -3.4084*log10(fcGHz)+6.5622)*1e-9;
-
-			if (!los && !o2i)
-			{
-				table3gpp->SetParams(20, 20, -6.28-0.204*log10(fcGHz), 0.39, 1.5-0.1144*log10(fcGHz),
-						0.28, 2.08-0.27*log10(fcGHz), 0.11, -0.3236*log10(fcGHz)+1.512, 0.16, uLgZSD,
-						0.49, offsetZOD, cDS, 2, 15, 7, 0, 0, 2.3, 3);
-				for (uint8_t row = 0; row < 6; row++)
-				{
-					for (uint8_t column = 0; column < 6; column++)
-					{
-						table3gpp->m_sqrtC[row][column] = sqrtC_UMa_NLOS[row][column];
-					}
-				}
-			}
-			else//(o2i)
-			{
-				table3gpp->SetParams(12, 20, -6.62, 0.32, 1.25, 0.42, 1.76, 0.16, 1.01, 0.43,
-						uLgZSD, 0.49, offsetZOD, 11e-9, 5, 20, 6, 0, 0, 2.2, 4);
-				for (uint8_t row = 0; row < 6; row++)
-				{
-					for (uint8_t column = 0; column < 6; column++)
-					{
-						table3gpp->m_sqrtC[row][column] = sqrtC_UMa_O2I[row][column];
-					}
-				}
-
-			}
-
+			table3gpp = m_3gppTables[(!los && !o2i) ? NLOS_3GPP_TABLE : O2I_3GPP_TABLE];
+			table3gpp->m_uLgZSD = std::max(-0.5, -2.1*distance2D/1000-0.01*(hUT-1.5)+0.9);
+			table3gpp->m_offsetZOD = efc-std::pow(10, afc*log10(std::max(bfc,distance2D))+cfc);
 		}
-
 	}
 	else if (m_scenario == "UMi-StreetCanyon")
 	{
 		if(los && !o2i)
 		{
-			double uLgZSD = std::max(-0.21, -14.8*distance2D/1000+0.01*std::abs(hUT-hBS)+0.83);
-			table3gpp->SetParams(12, 20, -0.24*log10(1+fcGHz)-7.14, 0.38, -0.05*log10(1+fcGHz)+1.21, 0.41,
-					-0.08*log10(1+fcGHz)+1.73, 0.014*log10(1+fcGHz)+0.28, -0.1*log10(1+fcGHz)+0.73, -0.04*log10(1+fcGHz)+0.34,
-					uLgZSD, 0.35, 0, 5e-9, 3, 17, 7, 9, 5, 3, 3);
-			for (uint8_t row = 0; row < 7; row++)
-			{
-				for (uint8_t column = 0; column < 7; column++)
-				{
-					table3gpp->m_sqrtC[row][column] = sqrtC_UMi_LOS[row][column];
-				}
-			}
+			table3gpp = m_3gppTables[LOS_3GPP_TABLE];
+			table3gpp->m_uLgZSD = std::max(-0.21, -14.8*distance2D/1000+0.01*std::abs(hUT-hBS)+0.83);
 		}
 		else
 		{
-			double uLgZSD = std::max(-0.5, -3.1*distance2D/1000+0.01*std::max(hUT-hBS,0.0)+0.2);
-			double offsetZOD = -1*std::pow(10, -1.5*log10(std::max(10.0, distance2D))+3.3);
-			if (!los && !o2i)
-			{
-				table3gpp->SetParams(19, 20, -0.24*log10(1+fcGHz)-6.83, 0.16*log10(1+fcGHz)+0.28, -0.23*log10(1+fcGHz)+1.53,
-						0.11*log10(1+fcGHz)+0.33, -0.08*log10(1+fcGHz)+1.81, 0.05*log10(1+fcGHz)+0.3,
-						-0.04*log10(1+fcGHz)+0.92, -0.07*log10(1+fcGHz)+0.41, uLgZSD, 0.35, offsetZOD,
-						11e-9, 10, 22, 7, 0, 0, 2.1, 3);
-				for (uint8_t row = 0; row < 6; row++)
-				{
-					for (uint8_t column = 0; column < 6; column++)
-					{
-						table3gpp->m_sqrtC[row][column] = sqrtC_UMi_NLOS[row][column];
-					}
-				}
-			}
-			else//(o2i)
-			{
-				table3gpp->SetParams(12, 20, -6.62, 0.32, 1.25, 0.42, 1.76, 0.16, 1.01, 0.43,
-						uLgZSD, 0.35, offsetZOD, 11e-9, 5, 20, 6, 0, 0, 2.2, 4);
-				for (uint8_t row = 0; row < 6; row++)
-				{
-					for (uint8_t column = 0; column < 6; column++)
-					{
-						table3gpp->m_sqrtC[row][column] = sqrtC_UMi_O2I[row][column];
-					}
-				}
-			}
+			table3gpp = m_3gppTables[(!los && !o2i) ? NLOS_3GPP_TABLE : O2I_3GPP_TABLE];
+			table3gpp->m_uLgZSD = std::max(-0.5, -3.1*distance2D/1000+0.01*std::max(hUT-hBS,0.0)+0.2);
+			table3gpp->m_offsetZOD = -1*std::pow(10, -1.5*log10(std::max(10.0, distance2D))+3.3);
 		}
 	}
-	else if (m_scenario == "InH-OfficeMixed"||m_scenario == "InH-OfficeOpen")
+	else
 	{
+		//InH-OfficeMixed and InH-OfficeOpen, the other scenarios are rejected by Build3gppTables
 		NS_ASSERT_MSG (!o2i, "The indoor scenario does out support outdoor to indoor");
-		if(los)
+		table3gpp = m_3gppTables[los ? LOS_3GPP_TABLE : NLOS_3GPP_TABLE];
+	}
+
+	return table3gpp;
+
+}
+
+bool
+MmWave3gppChannel::IsChannelUpdateDue (Ptr<const Params3gpp> params, const Vector &locUT, const Vector &relativeSpeed) const
+{
+	double deltaX = sqrt(pow(params->m_preLocUT.x-locUT.x, 2)+pow(params->m_preLocUT.y-locUT.y, 2));
+	if (m_updateDistance > 0 && deltaX >= m_updateDistance)
+	{
+		return true;
+	}
+	if (m_updatePeriod.IsStrictlyPositive () && Now() - params->m_generatedTime >= m_updatePeriod)
+	{
+		//the update of a static link keeps its clusters but redraws their shadowing;
+		//it can be skipped to save the update, unless the moving blockers make the channel vary in time
+		if (m_updateStaticLinks || m_blockage)
 		{
-			table3gpp->SetParams(8, 20, -0.01*log10(1+fcGHz)-7.79, -0.16*log10(1+fcGHz)+0.50, 1.60, 0.18,
-					-0.19*log10(1+fcGHz)+1.86, 0.12*log10(1+fcGHz), -0.26*log10(1+fcGHz)+1.21, -0.04*log10(1+fcGHz)+0.17,
-					-1.43*log10(1+fcGHz)+2.25, 0.13*log10(1+fcGHz)+0.15, 0, 3.91e-9, 7, -6.2*log10(1+fcGHz)+16.72,
-					-3.85*log10(1+fcGHz)+10.28, 0.84*log10(1+fcGHz)+2.12, -0.58*log10(1+fcGHz)+6.19, 2.15, 6);
-			for (uint8_t row = 0; row < 7; row++)
-			{
-				for (uint8_t column = 0; column < 7; column++)
-				{
-					table3gpp->m_sqrtC[row][column] = sqrtC_office_LOS[row][column];
-				}
-			}
-		}
-		else
-		{
-			table3gpp->SetParams(10, 20, -0.28*log10(1+fcGHz)-7.29, 0.1*log10(1+fcGHz)+0.11, 1.49, 0.17,
-					-0.11*log10(1+fcGHz)+1.8, 0.12*log10(1+fcGHz), -0.15*log10(1+fcGHz)+1.04, -0.09*log10(1+fcGHz)+0.24,
-					1.37, 0.38, 0, 3.91e-9, 3, -13.0*log10(1+fcGHz)+30.53, -3.72*log10(1+fcGHz)+10.25, 0, 0, 1.84, 3);
-			for (uint8_t row = 0; row < 6; row++)
-			{
-				for (uint8_t column = 0; column < 6; column++)
-				{
-					table3gpp->m_sqrtC[row][column] = sqrtC_office_NLOS[row][column];
-				}
-			}
+			return true;
 		}
+		return deltaX != 0 || relativeSpeed.x != 0 || relativeSpeed.y != 0 || relativeSpeed.z != 0;
 	}
-	else
+	return false;
+}
+
+uint64_t
+MmWave3gppChannel::GetNumChannelUpdates (Ptr<NetDevice> txDevice, Ptr<NetDevice> rxDevice) const
+{
+	std::map<Ptr<NetDevice>, uint32_t>::const_iterator txIt = m_deviceIds.find (txDevice);
+	std::map<Ptr<NetDevice>, uint32_t>::const_iterator rxIt = m_deviceIds.find (rxDevice);
+	if (txIt == m_deviceIds.end () || rxIt == m_deviceIds.end ())
 	{
-		//Note that the InH-ShoppingMall scenario is not given in the table 7.5-6
-		NS_FATAL_ERROR("unkonw scenarios");
+		return 0;
 	}
-
-	return table3gpp;
-
+	return m_devices[txIt->second].m_links[rxIt->second].m_numUpdates;
 }
 
-void
-MmWave3gppChannel::DeleteChannel(Ptr<const MobilityModel> a, Ptr<const MobilityModel> b) const
+uint64_t
+MmWave3gppChannel::GetNumChannelReuses (Ptr<NetDevice> txDevice, Ptr<NetDevice> rxDevice) const
 {
-	Ptr<NetDevice> dev1 = a->GetObject<Node> ()->GetDevice (0);
-	Ptr<NetDevice> dev2 = b->GetObject<Node> ()->GetDevice (0);
-	NS_LOG_INFO("a position " << a->GetPosition() << " b " << b->GetPosition());
-	Ptr<Params3gpp> params = m_channelMap.find(std::make_pair(dev1,dev2))->second;
-	NS_LOG_INFO("params " << params);
-	NS_LOG_INFO("params m_channel size" << params->m_channel.size());
-	NS_ASSERT_MSG(m_channelMap.find(std::make_pair(dev1,dev2)) != m_channelMap.end(), "Channel not found");
-	params->m_channel.clear();
-	m_channelMap[std::make_pair(dev1,dev2)] = params;
+	std::map<Ptr<NetDevice>, uint32_t>::const_iterator txIt = m_deviceIds.find (txDevice);
+	std::map<Ptr<NetDevice>, uint32_t>::const_iterator rxIt = m_deviceIds.find (rxDevice);
+	if (txIt == m_deviceIds.end () || rxIt == m_deviceIds.end ())
+	{
+		return 0;
+	}
+	return m_devices[txIt->second].m_links[rxIt->second].m_numReuses;
 }
 
 Ptr<Params3gpp>
@@ -1889,7 +2036,7 @@ MmWave3gppChannel::UpdateChannel(Ptr<Params3gpp> params3gpp, Ptr<ParamsTable>  t
 	for (uint8_t cIndex = 0; cIndex < params->m_numCluster; cIndex++)
 	{
 		clusterDelay.at(cIndex) -= (sin(params->m_angle.at(ZOA_INDEX).at(cIndex)*M_PI/180)*cos(params->m_angle.at(AOA_INDEX).at(cIndex)*M_PI/180)*params->m_speed.x
-				+ sin(params->m_angle.at(ZOA_INDEX).at(cIndex)*M_PI/180)*sin(params->m_angle.at(AOA_INDEX).at(cIndex)*M_PI/180)*params->m_speed.y)*m_updatePeriod.GetSeconds()/3e8;     //(7.6-9)
+				+ sin(params->m_angle.at(ZOA_INDEX).at(cIndex)*M_PI/180)*sin(params->m_angle.at(AOA_INDEX).at(cIndex)*M_PI/180)*params->m_speed.y)*(Now().GetSeconds()-params->m_generatedTime.GetSeconds())/3e8;     //(7.6-9)
 	}
 
 	/* since the scaled Los delays are not to be used in cluster power generation,
@@ -2479,52 +2626,245 @@ MmWave3gppChannel::UpdateChannel(Ptr<Params3gpp> params3gpp, Ptr<ParamsTable>  t
 
 }
 
-void
-MmWave3gppChannel::BeamSearchBeamforming (Ptr<const SpectrumValue> txPsd, Ptr<Params3gpp> params, Ptr<AntennaArrayModel> txAntenna,
-		Ptr<AntennaArrayModel> rxAntenna, uint8_t *txAntennaNum, uint8_t *rxAntennaNum) const
+namespace {
+
+/*
+ * Wideband gain of the beam pairs tested by BeamSearchBeamforming, computed from the channel
+ * matrix without touching the PSD. The gain averaged over the active subbands,
+ * mean_k |sum_n a[n]*exp(-j*2*pi*f_k*delay[n])|^2 with a[n] = rxW^H*H[n]*txW, is a^H*G*a, where
+ * G[n][m] = mean_k exp(-j*2*pi*f_k*(delay[n]-delay[m])) only depends on the channel realization
+ * and is computed once per search. The projection of the channel on the last tx beam is kept,
+ * so each rx beam tested with the same tx beam costs numRx*numCluster operations.
+ */
+class BeamSearchMetric
 {
-	double max = 0, maxTx = 0, maxRx =0, maxTxTheta=0, maxRxTheta=0;
-	NS_LOG_LOGIC("BeamSearchBeamforming method at time " << Simulator::Now().GetSeconds());
-	for (uint16_t txTheta = 60; txTheta < 121; txTheta=txTheta+10)
+public:
+	BeamSearchMetric (const SpectrumValue& txPsd, Ptr<Params3gpp> params, double f0, double chunkWidth)
+		: m_channel (params->m_channel),
+		  m_numCluster (params->m_delay.size()),
+		  m_lastTxW (0)
+	{
+		m_gram.assign (m_numCluster*m_numCluster, std::complex<double> (0,0));
+		complexVector_t phase (m_numCluster);
+		complexVector_t step (m_numCluster);
+		for (uint8_t cIndex = 0; cIndex < m_numCluster; cIndex++)
+		{
+			phase[cIndex] = exp(std::complex<double>(0, -2*M_PI*f0*params->m_delay[cIndex]));
+			step[cIndex] = exp(std::complex<double>(0, -2*M_PI*chunkWidth*params->m_delay[cIndex]));
+		}
+		uint32_t numActive = 0;
+		for (Values::const_iterator vit = txPsd.ConstValuesBegin (); vit != txPsd.ConstValuesEnd (); vit++)
+		{
+			if (*vit != 0.00)
+			{
+				for (uint8_t n = 0; n < m_numCluster; n++)
+				{
+					for (uint8_t m = n; m < m_numCluster; m++)
+					{
+						m_gram[n*m_numCluster+m] += phase[n]*std::conj(phase[m]);
+					}
+				}
+				numActive++;
+			}
+			for (uint8_t cIndex = 0; cIndex < m_numCluster; cIndex++)
+			{
+				phase[cIndex] *= step[cIndex];
+			}
+		}
+		for (uint8_t n = 0; numActive > 0 && n < m_numCluster; n++)
+		{
+			for (uint8_t m = n; m < m_numCluster; m++)
+			{
+				m_gram[n*m_numCluster+m] /= (double)numActive;
+			}
+		}
+		m_a.resize (m_numCluster);
+	}
+
+	/*
+	 * @params the tx beam, which has to stay valid while it is the last tx beam tested
+	 * @params the rx beam
+	 * @returns the BF gain averaged over the active subbands
+	 */
+	double GetGain (const complexVector_t& txW, const complexVector_t& rxW)
 	{
-		for(uint16_t tx=0; tx<=txAntennaNum[1]; tx++)
+		uint8_t numRx = rxW.size();
+		if (&txW != m_lastTxW)
 		{
-			for (uint16_t rxTheta = 60; rxTheta < 121; rxTheta=rxTheta+10)
+			uint8_t numTx = txW.size();
+			m_txProjection.assign (numRx*m_numCluster, std::complex<double> (0,0));
+			for (uint8_t rxIndex = 0; rxIndex < numRx; rxIndex++)
 			{
-				for(uint16_t rx=0; rx<=rxAntennaNum[1]; rx++)
+				std::complex<double>* proj = &m_txProjection[rxIndex*m_numCluster];
+				for (uint8_t txIndex = 0; txIndex < numTx; txIndex++)
 				{
-					NS_LOG_LOGIC("txTheta " << txTheta << " rxTheta " << rxTheta << " tx sector " << 
-						(M_PI*(double)tx/(double)txAntennaNum[1]-0.5*M_PI)/(M_PI)*180 << " rx sector " << 
-						(M_PI*(double)rx/(double)rxAntennaNum[1]-0.5*M_PI)/(M_PI)*180);
-
-					txAntenna->SetSector(tx, txAntennaNum, txTheta);
-					rxAntenna->SetSector(rx, rxAntennaNum, rxTheta);
-					params->m_txW = txAntenna->GetBeamformingVector();
-					params->m_rxW = rxAntenna->GetBeamformingVector();
-					CalLongTerm(params);
-					Ptr<SpectrumValue> bfPsd = CalBeamformingGain(txPsd, params, Vector(0,0,0));
-
-					SpectrumValue bfGain = (*bfPsd)/(*txPsd);
-					uint8_t nbands = bfGain.GetSpectrumModel ()->GetNumBands ();
-					double power = Sum (bfGain)/nbands;
-
-					NS_LOG_LOGIC("gain " << power);
-					if (max < power)
+					const complexVector_t& h = m_channel[rxIndex][txIndex];
+					for (uint8_t cIndex = 0; cIndex < m_numCluster; cIndex++)
 					{
-						max = power;
-						maxTx = tx;
-						maxRx = rx;
-						maxTxTheta = txTheta;
-						maxRxTheta = rxTheta;
+						proj[cIndex] += txW[txIndex]*h[cIndex];
 					}
 				}
 			}
+			m_lastTxW = &txW;
 		}
+		std::fill (m_a.begin (), m_a.end (), std::complex<double> (0,0));
+		for (uint8_t rxIndex = 0; rxIndex < numRx; rxIndex++)
+		{
+			std::complex<double> w = std::conj(rxW[rxIndex]);
+			const std::complex<double>* proj = &m_txProjection[rxIndex*m_numCluster];
+			for (uint8_t cIndex = 0; cIndex < m_numCluster; cIndex++)
+			{
+				m_a[cIndex] += w*proj[cIndex];
+			}
+		}
+		double gain = 0;
+		for (uint8_t n = 0; n < m_numCluster; n++)
+		{
+			gain += std::norm(m_a[n])*m_gram[n*m_numCluster+n].real();
+			for (uint8_t m = n+1; m < m_numCluster; m++)
+			{
+				gain += 2*(m_a[n]*std::conj(m_a[m])*m_gram[n*m_numCluster+m]).real();
+			}
+		}
+		return gain;
 	}
-	NS_LOG_LOGIC("maxTx " << maxTx << " txAntennaNum[1] " << (uint16_t)txAntennaNum[1]);
-	NS_LOG_LOGIC("max gain " << max << " maxTx " << (M_PI*(double)maxTx/(double)txAntennaNum[1]-0.5*M_PI)/(M_PI)*180 << " maxRx " << (M_PI*(double)maxRx/(double)rxAntennaNum[1]-0.5*M_PI)/(M_PI)*180 << " maxTxTheta " << maxTxTheta << " maxRxTheta " << maxRxTheta);
-	txAntenna->SetSector(maxTx, txAntennaNum, maxTxTheta);
-	rxAntenna->SetSector(maxRx, rxAntennaNum, maxRxTheta);
+
+private:
+	const complex3DVector_t& m_channel;
+	uint8_t m_numCluster;
+	complexVector_t m_gram; //upper triangle of G, row-major.
+	const complexVector_t* m_lastTxW;
+	complexVector_t m_txProjection; //H[u][.][n]*txW, row-major.
+	complexVector_t m_a;
+};
+
+/*
+ * Best beam pair found by SearchBeams
+ */
+struct BeamPair
+{
+	double m_gain;
+	uint16_t m_txTheta;
+	uint16_t m_tx;
+	uint16_t m_rxTheta;
+	uint16_t m_rx;
+};
+
+} // anonymous namespace
+
+/*
+ * Test all the combinations of the given elevations and sectors, in the same order as
+ * the original exhaustive search, and update best if a pair with a larger gain is found.
+ * Gains within the numerical error of the best one are considered equal, so that the
+ * first pair tested wins as in the exhaustive search.
+ */
+static void
+SearchBeams (BeamSearchMetric& metric, Ptr<AntennaArrayModel> txAntenna, Ptr<AntennaArrayModel> rxAntenna,
+		uint8_t *txAntennaNum, uint8_t *rxAntennaNum,
+		const std::vector<uint16_t>& txThetas, const std::vector<uint16_t>& txSectors,
+		const std::vector<uint16_t>& rxThetas, const std::vector<uint16_t>& rxSectors, BeamPair& best)
+{
+	for (std::vector<uint16_t>::const_iterator txTheta = txThetas.begin (); txTheta != txThetas.end (); txTheta++)
+	{
+		for (std::vector<uint16_t>::const_iterator tx = txSectors.begin (); tx != txSectors.end (); tx++)
+		{
+			const complexVector_t& txW = txAntenna->GetSectorVector (*tx, txAntennaNum, *txTheta);
+			for (std::vector<uint16_t>::const_iterator rxTheta = rxThetas.begin (); rxTheta != rxThetas.end (); rxTheta++)
+			{
+				for (std::vector<uint16_t>::const_iterator rx = rxSectors.begin (); rx != rxSectors.end (); rx++)
+				{
+					const complexVector_t& rxW = rxAntenna->GetSectorVector (*rx, rxAntennaNum, *rxTheta);
+					double power = metric.GetGain (txW, rxW);
+					NS_LOG_LOGIC("txTheta " << *txTheta << " rxTheta " << *rxTheta << " tx sector " << *tx
+							<< " rx sector " << *rx << " gain " << power);
+					if (power > best.m_gain*(1+1e-12))
+					{
+						best.m_gain = power;
+						best.m_txTheta = *txTheta;
+						best.m_tx = *tx;
+						best.m_rxTheta = *rxTheta;
+						best.m_rx = *rx;
+					}
+				}
+			}
+		}
+	}
+}
+
+/*
+ * Returns the values from first to last with the given step, last included
+ */
+static std::vector<uint16_t>
+GetBeamRange (uint16_t first, uint16_t last, uint16_t step)
+{
+	std::vector<uint16_t> range;
+	for (uint16_t value = first; value <= last; value += step)
+	{
+		range.push_back (value);
+	}
+	if (range.back () != last)
+	{
+		range.push_back (last);
+	}
+	return range;
+}
+
+/*
+ * Returns the values of the exhaustive search within one step of value
+ */
+static std::vector<uint16_t>
+GetBeamNeighbors (uint16_t value, uint16_t first, uint16_t last, uint16_t step)
+{
+	std::vector<uint16_t> range;
+	if (value >= first + step)
+	{
+		range.push_back (value - step);
+	}
+	range.push_back (value);
+	if (value + step <= last)
+	{
+		range.push_back (value + step);
+	}
+	return range;
+}
+
+void
+MmWave3gppChannel::BeamSearchBeamforming (Ptr<const SpectrumValue> txPsd, Ptr<Params3gpp> params, Ptr<AntennaArrayModel> txAntenna,
+		Ptr<AntennaArrayModel> rxAntenna, uint8_t *txAntennaNum, uint8_t *rxAntennaNum) const
+{
+	NS_LOG_LOGIC("BeamSearchBeamforming method at time " << Simulator::Now().GetSeconds());
+	double f0 = m_phyMacConfig->GetCentreFrequency () - GetSystemBandwidth ()/2;
+	BeamSearchMetric metric (*txPsd, params, f0, m_phyMacConfig->GetChunkWidth ());
+	BeamPair best = {0, 0, 0, 0, 0};
+
+	//the codebook scans the elevations from 60 to 120 degrees with a step of 10 degrees,
+	//and the sectors 0 to antennaNum[1].
+	if (m_beamSearchMethod == HIERARCHICAL_BEAM_SEARCH)
+	{
+		//coarse search on every other codeword, then refine around the best coarse pair
+		SearchBeams (metric, txAntenna, rxAntenna, txAntennaNum, rxAntennaNum,
+				GetBeamRange (60, 120, 20), GetBeamRange (0, txAntennaNum[1], 2),
+				GetBeamRange (60, 120, 20), GetBeamRange (0, rxAntennaNum[1], 2), best);
+		NS_LOG_LOGIC("coarse gain " << best.m_gain << " tx " << best.m_tx << " rx " << best.m_rx
+				<< " txTheta " << best.m_txTheta << " rxTheta " << best.m_rxTheta);
+		BeamPair coarse = best;
+		SearchBeams (metric, txAntenna, rxAntenna, txAntennaNum, rxAntennaNum,
+				GetBeamNeighbors (coarse.m_txTheta, 60, 120, 10), GetBeamNeighbors (coarse.m_tx, 0, txAntennaNum[1], 1),
+				GetBeamNeighbors (coarse.m_rxTheta, 60, 120, 10), GetBeamNeighbors (coarse.m_rx, 0, rxAntennaNum[1], 1), best);
+	}
+	else
+	{
+		SearchBeams (metric, txAntenna, rxAntenna, txAntennaNum, rxAntennaNum,
+				GetBeamRange (60, 120, 10), GetBeamRange (0, txAntennaNum[1], 1),
+				GetBeamRange (60, 120, 10), GetBeamRange (0, rxAntennaNum[1], 1), best);
+	}
+
+	NS_LOG_LOGIC("maxTx " << best.m_tx << " txAntennaNum[1] " << (uint16_t)txAntennaNum[1]);
+	NS_LOG_LOGIC("max gain " << best.m_gain << " maxTx " << (M_PI*(double)best.m_tx/(double)txAntennaNum[1]-0.5*M_PI)/(M_PI)*180
+			<< " maxRx " << (M_PI*(double)best.m_rx/(double)rxAntennaNum[1]-0.5*M_PI)/(M_PI)*180
+			<< " maxTxTheta " << best.m_txTheta << " maxRxTheta " << best.m_rxTheta);
+	txAntenna->SetSector(best.m_tx, txAntennaNum, best.m_txTheta);
+	rxAntenna->SetSector(best.m_rx, rxAntennaNum, best.m_rxTheta);
 	params->m_txW = txAntenna->GetBeamformingVector();
 	params->m_rxW = rxAntenna->GetBeamformingVector();
 }
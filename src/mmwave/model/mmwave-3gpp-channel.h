@@ -41,6 +41,7 @@
 #include "mmwave-3gpp-propagation-loss-model.h"
 #include "mmwave-3gpp-buildings-propagation-loss-model.h"
 #include <ns3/antenna-array-model.h>
+#include <ns3/traced-callback.h>
 
 #define AOA_INDEX 0
 #define ZOA_INDEX 1
@@ -53,6 +54,9 @@
 #define Y_INDEX 3
 #define R_INDEX 4
 
+class MmwaveBeamSearchTestCase;
+class Mmwave3gppTableTestCase;
+
 namespace ns3{
 
 
@@ -77,6 +81,15 @@ struct Params3gpp : public SimpleRefCount<Params3gpp>
 	double2DVector_t		m_angle; //cluster angle angle[direction][n], where direction = 0(aoa), 1(zoa), 2(aod), 3(zod) in degree.
 	complexVector_t 		m_longTerm; // long term conponet.
 
+	/*The following structure of arrays is computed by CalLongTerm for the CalBeamformingGain kernel*/
+	doubleVector_t m_bfStartRe; // real part of m_longTerm[n]*exp(-j*2*pi*f0*delay[n]), f0 being the lowest subband frequency
+	doubleVector_t m_bfStartIm; // imaginary part of the above
+	doubleVector_t m_bfStepRe; // real part of exp(-j*2*pi*chunkWidth*delay[n]), the phase rotation between adjacent subbands
+	doubleVector_t m_bfStepIm; // imaginary part of the above
+	doubleVector_t m_dopplerX; // 2*pi*fc/c*sin(zoa[n])*cos(aoa[n]), multiplied by speed.x*t to get the doppler phase
+	doubleVector_t m_dopplerY; // 2*pi*fc/c*sin(zoa[n])*sin(aoa[n])
+	doubleVector_t m_dopplerZ; // 2*pi*fc/c*cos(zoa[n])
+
 	double2DVector_t		m_nonSelfBlocking; // store the blockages
 
 	/*The following parameters are stored for spatial consistent updating*/
@@ -169,6 +182,16 @@ public:
     * Constructor
     */
 	MmWave3gppChannel ();
+
+	/*
+	 * Codebook scan of BeamSearchBeamforming
+	 */
+	enum BeamSearchMethod_t
+	{
+		EXHAUSTIVE_BEAM_SEARCH,
+		HIERARCHICAL_BEAM_SEARCH
+	};
+
 	/** 
    	* Destructor
    	*/
@@ -218,7 +241,34 @@ public:
 	 */
 	void SetPathlossModel (Ptr<PropagationLossModel> pathloss);
 
+	/**
+	 * Get the number of spatially-consistent updates of the channel of a link
+	 * @param a pointer to the transmitting NetDevice
+	 * @param a pointer to the receiving NetDevice
+	 * @returns the number of updates, 0 if the link has no channel
+	 */
+	uint64_t GetNumChannelUpdates (Ptr<NetDevice> txDevice, Ptr<NetDevice> rxDevice) const;
+
+	/**
+	 * Get the number of signals that reused the channel of a link without updating it
+	 * @param a pointer to the transmitting NetDevice
+	 * @param a pointer to the receiving NetDevice
+	 * @returns the number of reuses, 0 if the link has no channel
+	 */
+	uint64_t GetNumChannelReuses (Ptr<NetDevice> txDevice, Ptr<NetDevice> rxDevice) const;
+
+	/**
+	 * TracedCallback signature for the update or reuse of the channel of a link
+	 * @param [in] txDevice the transmitter of the link holding the channel
+	 * @param [in] rxDevice the receiver of the link holding the channel
+	 * @param [in] updated true if the channel was updated, false if it was reused
+	 */
+	typedef void (* ChannelUpdateTracedCallback)
+		(Ptr<NetDevice> txDevice, Ptr<NetDevice> rxDevice, bool updated);
+
 private:
+	friend class ::MmwaveBeamSearchTestCase;
+	friend class ::Mmwave3gppTableTestCase;
 
 	/**
 	 * Inherited from SpectrumPropagationLossModel, it returns the PSD at the receiver
@@ -278,29 +328,42 @@ private:
 	void LongTermCovMatrixBeamforming (Ptr<Params3gpp> params) const;
 	
 	/**
-	 * Scan all sectors with predefined code book and select the one returns maximum gain.
+	 * Scan the sectors of the predefined code book and select the pair that returns the maximum
+	 * gain averaged over the subbands used by the tx PSD. The gain of each pair is computed
+	 * directly from the channel matrix and the cached steering vectors of the antenna arrays.
+	 * Depending on the BeamSearchMethod attribute all the pairs are tested, or a coarse scan is
+	 * refined around its best pair.
 	 * The BF vector is stored in the Params3gpp object passed as parameter
+	 * @params the tx PSD
 	 * @params the channel realizationin as a Params3gpp object
+	 * @params the ArrayAntennaModel for the txAntenna
+	 * @params the ArrayAntennaModel for the rxAntenna
+	 * @params the number of txAntenna per row
+	 * @params the number of rxAntenna per row
 	 */
 	void BeamSearchBeamforming (Ptr<const SpectrumValue> txPsd, Ptr<Params3gpp> params, Ptr<AntennaArrayModel> txAntenna,
 			Ptr<AntennaArrayModel> rxAntenna, uint8_t *txAntennaNum, uint8_t *rxAntennaNum) const;
 
 
 	/**
-	 * Compute and store the long term fading params in order to decrease the computational load
+	 * Compute and store the long term fading params in order to decrease the computational load.
+	 * The per-cluster terms used by CalBeamformingGain are stored as well.
 	 * @params the channel realizationin as a Params3gpp object
 	 */
 	void CalLongTerm (Ptr<Params3gpp> params) const;
 
 	/**
 	 * Compute the BF gain, apply frequency selectivity by phase-shifting with the cluster delays
-	 * and scale the txPsd to get the rxPsd
+	 * and scale the txPsd to get the rxPsd.
+	 * The phase shift of each cluster is obtained by rotating the phase of the previous subband,
+	 * with the terms precomputed by CalLongTerm, so no complex exponential is evaluated per subband.
 	 * @params the tx PSD
+	 * @params the rx PSD to write, which can be the tx PSD itself, or 0 to only compute the gain
 	 * @params the channel realizationin as a Params3gpp object
 	 * @params the relative speed between UE and eNB
-	 * @returns the rx PSD
+	 * @returns the BF gain averaged over the subbands with non-zero tx PSD
 	 */
-	Ptr<SpectrumValue> CalBeamformingGain (Ptr<const SpectrumValue> txPsd,
+	double CalBeamformingGain (const SpectrumValue& txPsd, SpectrumValue* rxPsd,
 												Ptr<Params3gpp> params, Vector speed) const;
 	
 	/**
@@ -309,6 +372,12 @@ private:
 	 */
 	double GetSystemBandwidth () const;
 
+	/*
+	 * Build the ParamsTable of each channel condition of the scenario at the centre
+	 * frequency of the configuration, i.e., all the parameters of TR 38.900 Table 7.5-6
+	 * except the ones that depend on the distance and the heights of the devices
+	 */
+	void Build3gppTables () const;
 	/**
 	 * Returns the ParamsTable with the parameters of TR 38.900 Table 7.5-6
 	 * that apply to a certain scenario
@@ -322,14 +391,6 @@ private:
 	Ptr<ParamsTable> Get3gppTable (bool los, bool o2i,
 										double hBS, double hUT, double distance2D) const;
 
-	/**
-	 * Delete the m_channel entry associated to the Params3gpp object of pair (a,b)
-	 * but keep the other parameters, so that the spatial consistency procedure can be used
-	 * @params the mobility model of the transmitter
-	 * @params the mobility model of the receiver
-	 */
-	void DeleteChannel(Ptr<const MobilityModel> a,
-			Ptr<const MobilityModel> b) const;
 	/*
 	 * Returns the attenuation of each cluster in dB after applying blockage model
 	 * @params the channel realizationin as a Params3gpp object
@@ -339,8 +400,67 @@ private:
 	doubleVector_t CalAttenuationOfBlockage(Ptr<Params3gpp> params,
 			doubleVector_t clusterAOA, doubleVector_t clusterZOA) const;
 
-	mutable std::map< key_t, int > m_connectedPair;
-	mutable std::map< key_t, Ptr<Params3gpp> > m_channelMap;
+	/*
+	 * State of the link from a transmitter to a receiver
+	 */
+	struct LinkState
+	{
+		LinkState () : m_connected (false), m_numUpdates (0), m_numReuses (0)
+		{
+		}
+		Ptr<Params3gpp> m_channel; //0 until the channel of the link is generated
+		bool m_connected; //true if the devices were connected with ConnectDevices
+		uint64_t m_numUpdates; //number of updates of m_channel
+		uint64_t m_numReuses; //number of signals that used m_channel as it was
+	};
+	/*
+	 * What DoCalcRxPowerSpectralDensity needs to know about a device, cached when the
+	 * device is registered so that a signal does not have to query the node
+	 */
+	struct DeviceInfo
+	{
+		Ptr<NetDevice> m_device;
+		Ptr<MobilityModel> m_mobility;
+		bool m_isEnb;
+		bool m_isUe;
+		uint8_t m_antennaNum[2]; //number of vertical and horizontal antenna elements
+		Ptr<AntennaArrayModel> m_antennaArray;
+		std::vector<LinkState> m_links; //links towards each receiver, indexed by device id
+	};
+	/*
+	 * Returns the dense id of a device, registering it if it was never seen before
+	 * @params the device
+	 * @returns the index of the device in m_devices
+	 */
+	uint32_t GetDeviceId (Ptr<NetDevice> device) const;
+	/*
+	 * Returns the dense id of the first device of the node of a mobility model
+	 * @params the mobility model
+	 * @returns the index of the device in m_devices
+	 */
+	uint32_t GetDeviceId (Ptr<const MobilityModel> mobility) const;
+	/*
+	 * Returns the LOS condition of a link from the 3GPP pathloss model
+	 * @params the id of the transmitter
+	 * @params the id of the receiver
+	 * @returns the condition: 'l' LOS, 'n' NLOS, 'i' NLOS + o2i, 's' LOS + o2i
+	 */
+	char GetChannelCondition (uint32_t txId, uint32_t rxId) const;
+	/*
+	 * Check whether the channel of a link has to be updated with the spatial consistency
+	 * procedure, i.e., whether the UT moved more than m_updateDistance or the channel is older
+	 * than m_updatePeriod. A link whose UT did not move and is not moving is updated by age
+	 * only if m_updateStaticLinks or the blockage model is enabled.
+	 * @params the channel of the link
+	 * @params the current location of the UT
+	 * @params the relative speed of the devices
+	 * @returns true if the channel has to be updated
+	 */
+	bool IsChannelUpdateDue (Ptr<const Params3gpp> params, const Vector &locUT, const Vector &relativeSpeed) const;
+
+	mutable std::vector<DeviceInfo> m_devices;
+	mutable std::map<Ptr<NetDevice>, uint32_t> m_deviceIds;
+	mutable std::map<const MobilityModel*, uint32_t> m_mobilityIds;
 
 	Ptr<UniformRandomVariable> m_uniformRv;
 	Ptr<UniformRandomVariable> m_uniformRvBlockage;
@@ -352,14 +472,37 @@ private:
 	Ptr<ExponentialRandomVariable> m_expRv;
 	Ptr<MmWavePhyMacCommon> m_phyMacConfig;
 	Ptr<PropagationLossModel> m_3gppPathloss;
-	Ptr<ParamsTable> m_table3gpp;
+	/*The pathloss model that provides the channel condition, only one of them is set*/
+	Ptr<MmWave3gppPropagationLossModel> m_3gppLoss;
+	Ptr<MmWave3gppBuildingsPropagationLossModel> m_3gppBuildingsLoss;
+	/*The precomputed ParamsTable of each channel condition, built by Build3gppTables*/
+	enum
+	{
+		LOS_3GPP_TABLE = 0,
+		NLOS_3GPP_TABLE,
+		O2I_3GPP_TABLE,
+		NUM_3GPP_TABLES
+	};
+	mutable Ptr<ParamsTable> m_3gppTables[NUM_3GPP_TABLES];
+	mutable double m_3gppTablesFc;
+	mutable std::string m_3gppTablesScenario;
 	Time m_updatePeriod;
+	double m_updateDistance;
+	bool m_updateStaticLinks;
+	mutable uint64_t m_numChannelUpdates;
+	mutable uint64_t m_numChannelReuses;
+	TracedCallback<Ptr<NetDevice>, Ptr<NetDevice>, bool> m_channelUpdateTrace;
 	bool m_cellScan;
 	bool m_blockage;
 	uint16_t m_numNonSelfBloking; //number of non-self-blocking regions.
 	bool m_portraitMode; //true (portrait mode); false (landscape mode).
 	std::string m_scenario;
 	double m_blockerSpeed;
+	BeamSearchMethod_t m_beamSearchMethod;
+
+	/*Scratch space of CalBeamformingGain, holding the current phase of each cluster*/
+	mutable doubleVector_t m_bfPhaseRe;
+	mutable doubleVector_t m_bfPhaseIm;
 };
 
 
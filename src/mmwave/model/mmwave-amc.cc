@@ -32,6 +32,7 @@
 #include <ns3/double.h>
 #include <ns3/math.h>
 #include "ns3/enum.h"
+#include "ns3/boolean.h"
 #include "mmwave-mi-error-model.h"
 
 NS_LOG_COMPONENT_DEFINE ("MmWaveAmc");
@@ -102,6 +103,23 @@ static const int ModulationSchemeForMcs[32] = {
   6,  // reserved
 };
 
+/*
+ * Compute the MIB of the TB for each modulation, since it does not depend on the coding rate
+ */
+static void
+GetMibPerModulation (const SpectrumValue& sinr, const std::vector<int>& map, double* mib)
+{
+	mib[0] = MmWaveMiErrorModel::Mib (sinr, map, 0);
+	mib[1] = MmWaveMiErrorModel::Mib (sinr, map, MI_QPSK_MAX_ID + 1);
+	mib[2] = MmWaveMiErrorModel::Mib (sinr, map, MI_16QAM_MAX_ID + 1);
+}
+
+static inline uint8_t
+GetModulationIndex (uint8_t mcs)
+{
+	return mcs <= MI_QPSK_MAX_ID ? 0 : (mcs <= MI_16QAM_MAX_ID ? 1 : 2);
+}
+
 MmWaveAmc::MmWaveAmc ()
 {
 	NS_LOG_ERROR ("This construcor should not be invoked");
@@ -135,6 +153,12 @@ MmWaveAmc::GetTypeId (void)
 				 MakeEnumAccessor (&MmWaveAmc::m_amcModel),
 				 MakeEnumChecker (MmWaveAmc::MiErrorModel, "Vienna",
 								  MmWaveAmc::PiroEW2010, "PiroEW2010"))
+	.AddAttribute ("UseMcsTable",
+				"With the MiErrorModel, select the MCS by comparing the MIB with precomputed per-MCS "
+				"thresholds for each TB size instead of evaluating the BLER curves",
+				 BooleanValue (false),
+				 MakeBooleanAccessor (&MmWaveAmc::m_useMcsTable),
+				 MakeBooleanChecker ())
 	;
 	return tid;
 }
@@ -262,31 +286,23 @@ MmWaveAmc::CreateCqiFeedbacks (const SpectrumValue& sinr, uint8_t rbgSize)
 	{
 		std::vector <int> rbgMap;
 		int rbId = 0;
+		std::vector<uint32_t> tbSizes (29);
+		for (uint8_t mcs = 0; mcs <= 28; mcs++)
+		{
+			tbSizes[mcs] = GetTbSizeFromMcs (mcs, rbgSize/18) / 8;
+		}
 		for (it = sinr.ConstValuesBegin (); it != sinr.ConstValuesEnd (); it++)
 		{
 			rbgMap.push_back (rbId++);
 			if ((rbId % rbgSize == 0)||((it+1)==sinr.ConstValuesEnd ()))
 			{
-				uint8_t mcs = 0;
-				TbStats_t tbStats;
-				while (mcs <= 28)
-				{
-					MmWaveHarqProcessInfoList_t harqInfoList;
-					tbStats = MmWaveMiErrorModel::GetTbDecodificationStats (sinr, rbgMap, GetTbSizeFromMcs (mcs, rbgSize/18) / 8, mcs, harqInfoList);
-					if (tbStats.tbler > 0.1)
-					{
-						break;
-					}
-					mcs++;
-
-				}
-				if (mcs > 0)
-				{
-					mcs--;
-				}
-				NS_LOG_DEBUG (this << "\t RBG " << rbId << " MCS " << (uint16_t)mcs << " TBLER " << tbStats.tbler);
+				double mib[3];
+				GetMibPerModulation (sinr, rbgMap, mib);
+				double tbler;
+				uint8_t mcs = GetMcsFromMib (mib, tbSizes, tbler);
+				NS_LOG_DEBUG (this << "\t RBG " << rbId << " MCS " << (uint16_t)mcs << " TBLER " << tbler);
 				int rbgCqi = 0;
-				if ((tbStats.tbler > 0.1)&&(mcs==0))
+				if ((tbler > 0.1)&&(mcs==0))
 				{
 					rbgCqi = 0;
 				}
@@ -361,30 +377,22 @@ MmWaveAmc::CreateCqiFeedbacksTdma (const SpectrumValue& sinr, uint8_t numSym)
 	else if (m_amcModel == MiErrorModel)
 	{
 		int chunkId = 0;
+		std::vector<uint32_t> tbSizes (29);
+		for (uint8_t mcs = 0; mcs <= 28; mcs++)
+		{
+			tbSizes[mcs] = GetTbSizeFromMcsSymbols (mcs, numSym) / 8;
+		}
+		std::vector <int> chunkMap (1);
 		for (it = sinr.ConstValuesBegin (); it != sinr.ConstValuesEnd (); it++)
 		{
-			uint8_t mcs = 0;
-			TbStats_t tbStats;
-			std::vector <int> chunkMap;
-			chunkMap.push_back (chunkId++);
-			while (mcs <= 28)
-			{
-				MmWaveHarqProcessInfoList_t harqInfoList;
-				tbStats = MmWaveMiErrorModel::GetTbDecodificationStats (sinr, chunkMap, GetTbSizeFromMcsSymbols (mcs, numSym) / 8, mcs, harqInfoList);
-				if (tbStats.tbler > 0.1)
-				{
-					break;
-				}
-				mcs++;
-
-			}
-			if (mcs > 0)
-			{
-				mcs--;
-			}
-			NS_LOG_DEBUG (this << "\t MCS " << (uint16_t)mcs << " TBLER " << tbStats.tbler);
+			chunkMap[0] = chunkId++;
+			double mib[3];
+			GetMibPerModulation (sinr, chunkMap, mib);
+			double tbler;
+			uint8_t mcs = GetMcsFromMib (mib, tbSizes, tbler);
+			NS_LOG_DEBUG (this << "\t MCS " << (uint16_t)mcs << " TBLER " << tbler);
 			int chunkCqi = 0;
-			if ((tbStats.tbler > 0.1)&&(mcs==0))
+			if ((tbler > 0.1)&&(mcs==0))
 			{
 				chunkCqi = 0;
 			}
@@ -475,28 +483,16 @@ MmWaveAmc::CreateCqiFeedbackWbTdma (const SpectrumValue& sinr, uint8_t numSym, u
 		}
 		sinrAvg /= chunkId;
 
-		mcs = 0;
-		TbStats_t tbStats;
-		while (mcs <= 28)
-		{
-			MmWaveHarqProcessInfoList_t harqInfoList;
-			tbStats = MmWaveMiErrorModel::GetTbDecodificationStats (sinr, chunkMap, tbSize, mcs, harqInfoList);
-			if (tbStats.tbler > 0.1)
-			{
-				break;
-			}
-			mcs++;
-		}
-		if (mcs > 0)
-		{
-			mcs--;
-		}
+		double mib[3];
+		GetMibPerModulation (sinr, chunkMap, mib);
+		double tbler;
+		mcs = GetMcsFromMib (mib, std::vector<uint32_t> (29, tbSize), tbler);
 //		MmWaveHarqProcessInfoList_t harqInfoList;
 //		TbStats_t tbStatsFinal = MmWaveMiErrorModel::GetTbDecodificationStats (sinr, chunkMap, tbSize, mcs, harqInfoList);
 //		NS_LOG_UNCOND ("TBLER " << tbStatsFinal.tbler << " for chunks " << chunkMap.size () << " numSym "
 //		               << (unsigned)numSym << " tbSize " << tbSize << " mcs " << (unsigned)mcs << " sinr " << sinrAvg);
 //		NS_LOG_UNCOND (sinr);
-		if ((tbStats.tbler > 0.1)&&(mcs==0))
+		if ((tbler > 0.1)&&(mcs==0))
 		{
 			cqi = 0;
 		}
@@ -518,6 +514,94 @@ MmWaveAmc::CreateCqiFeedbackWbTdma (const SpectrumValue& sinr, uint8_t numSym, u
 	return cqi;
 }
 
+uint8_t
+MmWaveAmc::GetMcsFromMib (const double* mib, const std::vector<uint32_t>& tbSizes, double& tbler)
+{
+	NS_ASSERT (tbSizes.size () == 29);
+	// look for the first MCS that cannot be decoded, 29 if all of them can
+	uint8_t first = 0;
+	if (m_useMcsTable)
+	{
+		const std::vector<double>& thresholds = GetMibThresholds (tbSizes);
+		while (first <= 28 && mib[GetModulationIndex (first)] >= thresholds[first])
+		{
+			first++;
+		}
+		tbler = first <= 28 ? 1.0 : 0.0;
+	}
+	else
+	{
+		// the TBLER grows with the MCS, so a binary search finds the same MCS as a linear scan
+		MmWaveHarqProcessInfoList_t harqInfoList;
+		uint8_t last = 29;
+		tbler = 0.0;
+		while (first < last)
+		{
+			uint8_t mcs = (first + last) / 2;
+			TbStats_t tbStats = MmWaveMiErrorModel::GetTbDecodificationStats (mib[GetModulationIndex (mcs)], tbSizes[mcs], mcs, harqInfoList);
+			if (tbStats.tbler > 0.1)
+			{
+				last = mcs;
+				tbler = tbStats.tbler;
+			}
+			else
+			{
+				first = mcs + 1;
+			}
+		}
+	}
+	return first > 0 ? first - 1 : 0;
+}
+
+const std::vector<double>&
+MmWaveAmc::GetMibThresholds (const std::vector<uint32_t>& tbSizes)
+{
+	std::map<std::vector<uint32_t>, std::vector<double> >::iterator it = m_mibThresholds.find (tbSizes);
+	if (it != m_mibThresholds.end ())
+	{
+		return it->second;
+	}
+
+	std::vector<double>& thresholds = m_mibThresholds[tbSizes];
+	thresholds.resize (29);
+	MmWaveHarqProcessInfoList_t harqInfoList;
+	for (uint8_t mcs = 0; mcs <= 28; mcs++)
+	{
+		// the TBLER decreases with the MIB, which is in [0, 1]
+		if (MmWaveMiErrorModel::GetTbDecodificationStats (1.0, tbSizes[mcs], mcs, harqInfoList).tbler > 0.1)
+		{
+			thresholds[mcs] = 2.0; // never decoded
+			continue;
+		}
+		if (MmWaveMiErrorModel::GetTbDecodificationStats (0.0, tbSizes[mcs], mcs, harqInfoList).tbler <= 0.1)
+		{
+			thresholds[mcs] = 0.0;
+			continue;
+		}
+		double low = 0.0;
+		double high = 1.0;
+		for (int i = 0; i < 64; i++)
+		{
+			double mid = (low + high) / 2;
+			if (mid <= low || mid >= high)
+			{
+				break;
+			}
+			if (MmWaveMiErrorModel::GetTbDecodificationStats (mid, tbSizes[mcs], mcs, harqInfoList).tbler > 0.1)
+			{
+				low = mid;
+			}
+			else
+			{
+				high = mid;
+			}
+		}
+		thresholds[mcs] = high;
+		NS_LOG_LOGIC ("MCS " << (uint16_t)mcs << " TB size " << tbSizes[mcs] << " minimum MIB " << high);
+	}
+	return thresholds;
+}
+
 int
 MmWaveAmc::GetCqiFromSpectralEfficiency (double s)
 {
@@ -32,6 +32,8 @@
 #include <ns3/object.h>
 #include <ns3/spectrum-value.h>
 #include <ns3/mmwave-phy-mac-common.h>
+#include <map>
+#include <vector>
 
 namespace ns3 {
 
@@ -61,8 +63,27 @@ public:
 	static const unsigned int m_crcLen=24;
 
 private:
+	/*
+	 * Find the highest MCS that can be decoded with a TBLER of at most 10 %, with the MiErrorModel
+	 * @params the MIB of the TB for QPSK, 16-QAM and 64-QAM
+	 * @params the TB size in bytes for each MCS in [0, 28]
+	 * @params set to the TBLER of the first MCS that cannot be decoded (1.0 when the MCS table is
+	 * used, as it only stores the MIB thresholds), or to 0.0 if all the MCSs can be decoded
+	 * @returns the MCS
+	 */
+	uint8_t GetMcsFromMib (const double* mib, const std::vector<uint32_t>& tbSizes, double& tbler);
+
+	/*
+	 * Returns the minimum MIB that decodes each MCS with a TBLER of at most 10 %, for the given
+	 * TB sizes. The thresholds are computed once per set of TB sizes.
+	 * @params the TB size in bytes for each MCS in [0, 28]
+	 */
+	const std::vector<double>& GetMibThresholds (const std::vector<uint32_t>& tbSizes);
+
 	  double m_ber;
 	  AmcModel m_amcModel;
+	  bool m_useMcsTable;
+	  std::map<std::vector<uint32_t>, std::vector<double> > m_mibThresholds;
 
 	  Ptr<MmWavePhyMacCommon> m_phyMacConfig;
 		Ptr<SpectrumModel> m_lteRbModel;
@@ -36,6 +36,8 @@
 #include <ns3/mmwave-ue-phy.h>
 #include <ns3/mmwave-enb-phy.h>
 #include <ns3/double.h>
+#include <ns3/uinteger.h>
+#include <ns3/string.h>
 #include <algorithm>
 #include <fstream>
 
@@ -47,21 +49,10 @@ NS_LOG_COMPONENT_DEFINE ("MmWaveChannelRaytracing");
 NS_OBJECT_ENSURE_REGISTERED (MmWaveChannelRaytracing);
 
 
-doubleVector_t g_path; //number of multipath
-double2DVector_t g_delay; //delay spread in ns
-double2DVector_t g_pathloss;	//pathloss in DB
-double2DVector_t g_phase;	//???what is this
-double2DVector_t g_aodElevation;	//degree
-double2DVector_t g_aodAzimuth;	//degree
-double2DVector_t g_aoaElevation;	//degree
-double2DVector_t g_aoaAzimuth;	//degree
-
-
 MmWaveChannelRaytracing::MmWaveChannelRaytracing ()
 	:m_antennaSeparation(0.5)
 {
 	m_uniformRv = CreateObject<UniformRandomVariable> ();
-	LoadTraces();
 
 }
 
@@ -80,6 +71,12 @@ MmWaveChannelRaytracing::GetTypeId (void)
 			   DoubleValue (1.0),
 			   MakeDoubleAccessor (&MmWaveChannelRaytracing::m_speed),
 			   MakeDoubleChecker<double> ())
+	.AddAttribute ("TraceFile",
+			   "The raytracing traces, in the text format exported by Quadriga or in the binary format "
+			   "produced by utils/mmwave-raytracing-convert, which is mapped in memory",
+			   StringValue ("src/mmwave/model/Raytracing/Quadriga.txt"),
+			   MakeStringAccessor (&MmWaveChannelRaytracing::m_traceFile),
+			   MakeStringChecker ())
 	;
 	return tid;
 }
@@ -110,76 +107,18 @@ MmWaveChannelRaytracing::GetConfigurationParameters (void) const
 void
 MmWaveChannelRaytracing::LoadTraces()
 {
-	std::string filename = "src/mmwave/model/Raytracing/Quadriga.txt";
-	NS_LOG_FUNCTION (this << "Loading Raytracing file " << filename);
-	std::ifstream singlefile;
-	singlefile.open (filename.c_str (), std::ifstream::in);
-
-	NS_LOG_INFO (this << " File: " << filename);
-	NS_ASSERT_MSG(singlefile.good (), " Raytracing file not found");
-    std::string line;
-    std::string token;
-    uint16_t counter = 0;
-    while( std::getline(singlefile, line) ) //Parse each line of the file
-    {
-    	if(counter == 8)
-    	{
-    		counter = 0;
-    	}
-    	doubleVector_t path;
-        std::istringstream stream(line);
-        while( getline(stream,token,',') ) //Parse each comma separated string in a line
-        {
-            double sigma = 0.00;
-            std::stringstream stream( token );
-            stream>>sigma;
-        	path.push_back(sigma);
-		}
+	NS_LOG_FUNCTION (this << "Loading Raytracing file " << m_traceFile);
+	m_traces = MmWaveRaytracingTraces::Load (m_traceFile);
+}
 
-		switch (counter)
-		{
-		case 0:
-			g_path.push_back (path.at (0));
-			break;
-		case 1:
-			g_delay.push_back (path);
-			break;
-		case 2:
-			g_pathloss.push_back (path);
-			break;
-		case 3:
-			g_phase.push_back (path);
-			break;
-		case 4:
-			g_aodElevation.push_back (path);
-			break;
-		case 5:
-			g_aodAzimuth.push_back (path);
-			break;
-		case 6:
-			g_aoaElevation.push_back (path);
-			break;
-		case 7:
-			g_aoaAzimuth.push_back (path);
-			break;
-		default:
-			NS_FATAL_ERROR("Never call this");
-			break;
-		}
-		counter++;
+Ptr<const MmWaveRaytracingTraces>
+MmWaveChannelRaytracing::GetTraces () const
+{
+	if (m_traces == 0)
+	{
+		m_traces = MmWaveRaytracingTraces::Load (m_traceFile);
 	}
-
-	/*NS_LOG_UNCOND(g_path.size());
-	NS_LOG_UNCOND(g_delay.size());
-	NS_LOG_UNCOND(g_pathloss.size());
-	NS_LOG_UNCOND(g_phase.size());
-	NS_LOG_UNCOND(g_aodElevation.size());
-	NS_LOG_UNCOND(g_aodAzimuth.size());
-	NS_LOG_UNCOND(g_aoaElevation.size());
-	NS_LOG_UNCOND(g_aoaAzimuth.size());*/
-
-
-
+	return m_traces;
 }
 
 
@@ -291,7 +230,8 @@ MmWaveChannelRaytracing::DoCalcRxPowerSpectralDensity (Ptr<const SpectrumValue>
 	}*/
 	uint16_t traceIndex = (m_startDistance+time*m_speed)*6;
 	static uint16_t currentIndex = m_startDistance;
-	if(traceIndex > g_path.size())
+	Ptr<const MmWaveRaytracingTraces> traces = GetTraces ();
+	if(traceIndex >= traces->GetNTraces ())
 	{
 		NS_FATAL_ERROR ("The maximum trace index is reached");
 	}
@@ -319,7 +259,7 @@ MmWaveChannelRaytracing::DoCalcRxPowerSpectralDensity (Ptr<const SpectrumValue>
 			rxSpatialMatrix = GenSpatialMatrix (traceIndex,rxAntennaNum, true);
 		}
 		doubleVector_t dopplerShift;
-		for (unsigned int i = 0; i < g_path.at(traceIndex); i++)
+		for (unsigned int i = 0; i < traces->GetNPaths (traceIndex); i++)
 		{
 			dopplerShift.push_back(m_uniformRv->GetValue (0,1));
 		}
@@ -328,8 +268,8 @@ MmWaveChannelRaytracing::DoCalcRxPowerSpectralDensity (Ptr<const SpectrumValue>
 
 		channel->m_txSpatialMatrix = txSpatialMatrix;
 		channel->m_rxSpatialMatrix = rxSpatialMatrix;
-		channel->m_powerFraction = g_pathloss.at (traceIndex);
-		channel->m_delaySpread = g_delay.at (traceIndex);
+		channel->m_powerFraction = traces->Get (traceIndex, MmWaveRaytracingTraces::PATHLOSS).ToVector ();
+		channel->m_delaySpread = traces->Get (traceIndex, MmWaveRaytracingTraces::DELAY).ToVector ();
 		channel->m_doppler = dopplerShift;
 
 
@@ -339,8 +279,8 @@ MmWaveChannelRaytracing::DoCalcRxPowerSpectralDensity (Ptr<const SpectrumValue>
 		Ptr<TraceParams> reverseChannel = Create<TraceParams> ();
 		reverseChannel->m_txSpatialMatrix = rxSpatialMatrix;
 		reverseChannel->m_rxSpatialMatrix = txSpatialMatrix;
-		reverseChannel->m_powerFraction = g_pathloss.at (traceIndex);;
-		reverseChannel->m_delaySpread = g_delay.at (traceIndex);
+		reverseChannel->m_powerFraction = channel->m_powerFraction;
+		reverseChannel->m_delaySpread = channel->m_delaySpread;
 		reverseChannel->m_doppler = dopplerShift;
 
 		m_channelMatrixMap.insert(std::make_pair(reverseKey,reverseChannel));
@@ -456,21 +396,16 @@ complex2DVector_t
 MmWaveChannelRaytracing::GenSpatialMatrix (uint64_t traceIndex, uint8_t* antennaNum, bool bs) const
 {
 	complex2DVector_t spatialMatrix;
-	uint16_t pathNum = g_path.at (traceIndex);
+	Ptr<const MmWaveRaytracingTraces> traces = GetTraces ();
+	uint16_t pathNum = traces->GetNPaths (traceIndex);
+	MmWaveRaytracingTraces::Span azimuth = traces->Get (traceIndex,
+			bs ? MmWaveRaytracingTraces::AOD_AZIMUTH : MmWaveRaytracingTraces::AOA_AZIMUTH);
+	MmWaveRaytracingTraces::Span elevation = traces->Get (traceIndex,
+			bs ? MmWaveRaytracingTraces::AOD_ELEVATION : MmWaveRaytracingTraces::AOA_ELEVATION);
 	for(unsigned int pathIndex = 0; pathIndex < pathNum; pathIndex++)
 	{
-		double azimuthAngle;
-		double verticalAngle;
-		if(bs)
-		{
-			azimuthAngle = g_aodAzimuth.at (traceIndex).at (pathIndex);
-			verticalAngle = g_aodElevation.at (traceIndex).at (pathIndex);
-		}
-		else
-		{
-			azimuthAngle = g_aoaAzimuth.at (traceIndex).at (pathIndex);
-			verticalAngle = g_aoaElevation.at (traceIndex).at (pathIndex);
-		}
+		double azimuthAngle = azimuth.at (pathIndex);
+		double verticalAngle = elevation.at (pathIndex);
 		complexVector_t singlePath;
 		singlePath = GenSinglePath (azimuthAngle*M_PI/180, verticalAngle*M_PI/180, antennaNum);
 		spatialMatrix.push_back(singlePath);
@@ -38,6 +38,7 @@
 #include <ns3/net-device-container.h>
 #include <ns3/random-variable-stream.h>
 #include "mmwave-phy-mac-common.h"
+#include "mmwave-raytracing-traces.h"
 
 
 
@@ -80,6 +81,9 @@ public:
 
 	static TypeId GetTypeId (void);
 	void DoDispose ();
+	/**
+	 * Load the traces of the TraceFile attribute, otherwise they are loaded at the first signal
+	 */
 	void LoadTraces();
 	void ConnectDevices (Ptr<NetDevice> dev1, Ptr<NetDevice> dev2);
 	void Initial(NetDeviceContainer ueDevices, NetDeviceContainer enbDevices);
@@ -99,6 +103,7 @@ private:
 	complexVector_t CalcBeamformingVector (complex2DVector_t SpatialMatrix, doubleVector_t powerFraction) const;
 	Ptr<SpectrumValue> GetChannelGain (Ptr<const SpectrumValue> txPsd, Ptr<mmWaveBeamFormingTraces> bfParams, double speed) const;
 	double GetSystemBandwidth () const;
+	Ptr<const MmWaveRaytracingTraces> GetTraces () const;
 
 	mutable std::map< key_t, int > m_connectedPair;
 	mutable std::map< key_t, Ptr<TraceParams> > m_channelMatrixMap;
@@ -107,6 +112,8 @@ private:
 	Ptr<MmWavePhyMacCommon> m_phyMacConfig;
 	uint16_t m_startDistance;
 	double m_speed;
+	std::string m_traceFile;
+	mutable Ptr<MmWaveRaytracingTraces> m_traces;
 };
 
 
@@ -37,6 +37,7 @@
 #include "mmwave-mac-pdu-tag.h"
 #include "mmwave-spectrum-value-helper.h"
 #include <cmath>
+#include <algorithm>
 
 namespace ns3 {
 
@@ -189,15 +190,12 @@ void
 MmWaveFlexTtiMacScheduler::DoDispose (void)
 {
 	NS_LOG_FUNCTION (this);
-	m_wbCqiRxed.clear();
-  m_dlHarqProcessesDciInfoMap.clear ();
-  m_dlHarqProcessesTimer.clear ();
-  m_dlHarqProcessesRlcPduMap.clear ();
+	m_ueInfo.clear ();
+	m_ueIndexMap.clear ();
+	m_freeUeIndices.clear ();
+	m_ueAllocList.clear ();
   m_dlHarqInfoList.clear ();
-  m_ulHarqCurrentProcessId.clear ();
-  m_ulHarqProcessesStatus.clear ();
-  m_ulHarqProcessesTimer.clear ();
-  m_ulHarqProcessesDciInfoMap.clear ();
+  m_ulHarqInfoList.clear ();
   delete m_macCschedSapProvider;
   delete m_macSchedSapProvider;
 }
@@ -307,19 +305,61 @@ MmWaveFlexTtiMacScheduler::ConfigureCommonParameters (Ptr<MmWavePhyMacCommon> co
 	}
 }
 
+uint32_t
+MmWaveFlexTtiMacScheduler::GetUeIndex (uint16_t rnti) const
+{
+	std::map <uint16_t, uint32_t>::const_iterator it = m_ueIndexMap.find (rnti);
+	if (it == m_ueIndexMap.end ())
+	{
+		return m_ueInfo.size ();
+	}
+	return it->second;
+}
+
+MmWaveFlexTtiMacScheduler::UeSchedInfo&
+MmWaveFlexTtiMacScheduler::AddToAllocList (uint32_t ueIndex)
+{
+	UeInfo& ueInfo = m_ueInfo[ueIndex];
+	if (!ueInfo.m_allocated)
+	{
+		ueInfo.m_allocated = true;
+		m_ueAllocList.push_back (ueIndex);
+	}
+	return ueInfo.m_sched;
+}
+
+void
+MmWaveFlexTtiMacScheduler::ResetAllocList (void)
+{
+	for (unsigned i = 0; i < m_ueAllocList.size (); i++)
+	{
+		UeInfo& ueInfo = m_ueInfo[m_ueAllocList[i]];
+		ueInfo.m_sched = UeSchedInfo ();
+		ueInfo.m_allocated = false;
+	}
+	m_ueAllocList.clear ();
+}
+
 void
 MmWaveFlexTtiMacScheduler::DoSchedDlRlcBufferReq (const struct MmWaveMacSchedSapProvider::SchedDlRlcBufferReqParameters& params)
 {
   NS_LOG_FUNCTION (this << params.m_rnti << (uint32_t) params.m_logicalChannelIdentity);
   // API generated by RLC for updating RLC parameters on a LC (tx and retx queues)
-  std::list<MmWaveMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator it = m_rlcBufferReq.begin ();
+  uint32_t ueIndex = GetUeIndex (params.m_rnti);
+  if (ueIndex == m_ueInfo.size ())
+  {
+  	NS_LOG_ERROR ("RLC buffer report for unknown RNTI " << params.m_rnti);
+  	return;
+  }
+  UeInfo& ueInfo = m_ueInfo[ueIndex];
+  std::vector<MmWaveMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator it = ueInfo.m_rlcBufferReq.begin ();
   bool newLc = true;
-  while (it != m_rlcBufferReq.end ())
+  while (it != ueInfo.m_rlcBufferReq.end ())
     {
       // remove old entries of this UE-LC
-      if (((*it).m_rnti == params.m_rnti)&&((*it).m_logicalChannelIdentity == params.m_logicalChannelIdentity))
+      if ((*it).m_logicalChannelIdentity == params.m_logicalChannelIdentity)
         {
-          it = m_rlcBufferReq.erase (it);
+          it = ueInfo.m_rlcBufferReq.erase (it);
           newLc = false;
         }
       else
@@ -328,14 +368,15 @@ MmWaveFlexTtiMacScheduler::DoSchedDlRlcBufferReq (const struct MmWaveMacSchedSap
         }
     }
   // add the new parameters
-  m_rlcBufferReq.insert (it, params);
+  ueInfo.m_rlcBufferReq.push_back (params);
   NS_LOG_INFO ("BSR for RNTI " << params.m_rnti << " LC " << (uint16_t)params.m_logicalChannelIdentity << " RLC tx size " << params.m_rlcTransmissionQueueSize << " RLC retx size " << params.m_rlcRetransmissionQueueSize << " RLC stat size " <<  params.m_rlcStatusPduSize);
   // initialize statistics of the flow in case of new flows
-  if (newLc == true)
+  if (newLc == true && !ueInfo.m_wbCqiRxed)
   {
-  	m_wbCqiRxed.insert ( std::pair<uint16_t, uint8_t > (params.m_rnti, 1)); // only codeword 0 at this stage (SISO)
+  	ueInfo.m_wbCqiRxed = true;
   	// initialized to 1 (i.e., the lowest value for transmitting a signal)
-  	m_wbCqiTimers.insert ( std::pair<uint16_t, uint32_t > (params.m_rnti, m_cqiTimersThreshold));
+  	ueInfo.m_wbCqi = 1;
+  	ueInfo.m_wbCqiTimer = m_cqiTimersThreshold;
   }
 }
 
@@ -344,31 +385,23 @@ MmWaveFlexTtiMacScheduler::DoSchedDlCqiInfoReq (const struct MmWaveMacSchedSapPr
 {
   NS_LOG_FUNCTION (this);
 
-  std::map <uint16_t,uint8_t>::iterator it;
   for (unsigned int i = 0; i < params.m_cqiList.size (); i++)
     {
       if ( params.m_cqiList.at (i).m_cqiType == DlCqiInfo::WB )
         {
           // wideband CQI reporting
-          std::map <uint16_t,uint8_t>::iterator it;
           uint16_t rnti = params.m_cqiList.at (i).m_rnti;
-          it = m_wbCqiRxed.find (rnti);
-          if (it == m_wbCqiRxed.end ())
+          uint32_t ueIndex = GetUeIndex (rnti);
+          if (ueIndex == m_ueInfo.size ())
             {
-              // create the new entry
-              m_wbCqiRxed.insert ( std::pair<uint16_t, uint8_t > (rnti, params.m_cqiList.at (i).m_wbCqi) ); // only codeword 0 at this stage (SISO)
-              // generate correspondent timer
-              m_wbCqiTimers.insert ( std::pair<uint16_t, uint32_t > (rnti, m_cqiTimersThreshold));
-            }
-          else
-            {
-              // update the CQI value
-              (*it).second = params.m_cqiList.at (i).m_wbCqi;
-              // update correspondent timer
-              std::map <uint16_t,uint32_t>::iterator itTimers;
-              itTimers = m_wbCqiTimers.find (rnti);
-              (*itTimers).second = m_cqiTimersThreshold;
+              NS_LOG_ERROR ("DL CQI report for unknown RNTI " << rnti);
+              continue;
             }
+          // update the CQI value (only codeword 0 at this stage (SISO)) and the correspondent timer
+          UeInfo& ueInfo = m_ueInfo[ueIndex];
+          ueInfo.m_wbCqiRxed = true;
+          ueInfo.m_wbCqi = params.m_cqiList.at (i).m_wbCqi;
+          ueInfo.m_wbCqiTimer = m_cqiTimersThreshold;
         }
       else if ( params.m_cqiList.at (i).m_cqiType == DlCqiInfo::SB )
         {
@@ -397,7 +430,6 @@ MmWaveFlexTtiMacScheduler::DoSchedUlCqiInfoReq (const struct MmWaveMacSchedSapPr
 		case UlCqiInfo::PUSCH:
 		{
 			std::map <uint32_t, struct AllocMapElem>::iterator itMap;
-			std::map <uint16_t, struct UlCqiMapElem>::iterator itCqi;
 			itMap = m_ulAllocationMap.find (params.m_sfnSf.Encode ());
 			if (itMap == m_ulAllocationMap.end ())
 			{
@@ -407,49 +439,27 @@ MmWaveFlexTtiMacScheduler::DoSchedUlCqiInfoReq (const struct MmWaveMacSchedSapPr
 			NS_ASSERT_MSG (itMap->second.m_rntiPerChunk.size () == m_phyMacConfig->GetTotalNumChunk (), "SINR chunk map must cover full BW in TDMA mode");
 			for (unsigned i = 0; i < itMap->second.m_rntiPerChunk.size (); i++)
 			{
-				// convert from fixed point notation Sxxxxxxxxxxx.xxx to double
-				//double sinr = LteFfConverter::fpS11dot3toDouble (params.m_ulCqi.m_sinr.at (i));
-				itCqi = m_ueUlCqi.find (itMap->second.m_rntiPerChunk.at (i));
-				if (itCqi == m_ueUlCqi.end ())
+				uint32_t ueIndex = GetUeIndex (itMap->second.m_rntiPerChunk.at (i));
+				if (ueIndex == m_ueInfo.size ())
 				{
-					// create a new entry
-					std::vector <double> newCqi;
-					for (unsigned j = 0; j < m_phyMacConfig->GetTotalNumChunk (); j++)
-					{
-						unsigned chunkInd = i;
-						if (chunkInd == j)
-						{
-							newCqi.push_back (params.m_ulCqi.m_sinr.at (i));
-							NS_LOG_INFO ("UL CQI report for RNTI " << itMap->second.m_rntiPerChunk.at (i) << " chunk " << i << " SINR " << params.m_ulCqi.m_sinr.at (i) << \
-							             " frame " << frameNum << " subframe " << subframeNum << " startSym " << startSymIdx);
-						}
-						else
-						{
-							// initialize with NO_SINR value.
-							newCqi.push_back (30.0);
-						}
-					}
-					m_ueUlCqi.insert (std::pair <uint16_t, struct UlCqiMapElem> (itMap->second.m_rntiPerChunk.at (i),
-					                                                             UlCqiMapElem (newCqi, itMap->second.m_numSym, itMap->second.m_tbSize)) );
-					// generate correspondent timer
-					m_ueCqiTimers.insert (std::pair <uint16_t, uint32_t > (itMap->second.m_rntiPerChunk.at (i), m_cqiTimersThreshold));
+					NS_LOG_ERROR ("UL CQI report for unknown RNTI " << itMap->second.m_rntiPerChunk.at (i));
+					continue;
 				}
-				else
+				UeInfo& ueInfo = m_ueInfo[ueIndex];
+				if (!ueInfo.m_ulCqiRxed)
 				{
-					// update the value
-					(*itCqi).second.m_ueUlCqi.at (i) = params.m_ulCqi.m_sinr.at (i);
-					(*itCqi).second.m_numSym = itMap->second.m_numSym;
-					(*itCqi).second.m_tbSize = itMap->second.m_tbSize;
-					// update correspondent timer
-					std::map <uint16_t, uint32_t>::iterator itTimers;
-					itTimers = m_ueCqiTimers.find (itMap->second.m_rntiPerChunk.at (i));
-					(*itTimers).second = m_cqiTimersThreshold;
-
-					NS_LOG_INFO ("UL CQI report for RNTI " << itMap->second.m_rntiPerChunk.at (i) << " chunk " << i << " SINR " << params.m_ulCqi.m_sinr.at (i) << \
-					             " frame " << frameNum << " subframe " << subframeNum << " startSym " << startSymIdx);
-
+					// initialize with NO_SINR value.
+					ueInfo.m_ulCqiRxed = true;
+					ueInfo.m_ulCqi.m_ueUlCqi.assign (m_phyMacConfig->GetTotalNumChunk (), 30.0);
 				}
-
+				// update the value and the correspondent timer
+				ueInfo.m_ulCqi.m_ueUlCqi.at (i) = params.m_ulCqi.m_sinr.at (i);
+				ueInfo.m_ulCqi.m_numSym = itMap->second.m_numSym;
+				ueInfo.m_ulCqi.m_tbSize = itMap->second.m_tbSize;
+				ueInfo.m_ulCqiTimer = m_cqiTimersThreshold;
+
+				NS_LOG_INFO ("UL CQI report for RNTI " << itMap->second.m_rntiPerChunk.at (i) << " chunk " << i << " SINR " << params.m_ulCqi.m_sinr.at (i) << \
+				             " frame " << frameNum << " subframe " << subframeNum << " startSym " << startSymIdx);
 			}
 			// remove obsolete info on allocation
 			m_ulAllocationMap.erase (itMap);
@@ -467,59 +477,43 @@ MmWaveFlexTtiMacScheduler::RefreshHarqProcesses ()
 {
 	NS_LOG_FUNCTION (this);
 
-	std::map <uint16_t, DlHarqProcessesTimer_t>::iterator itTimers;
-	for (itTimers = m_dlHarqProcessesTimer.begin (); itTimers != m_dlHarqProcessesTimer.end (); itTimers++)
+	for (unsigned ueIndex = 0; ueIndex < m_ueInfo.size (); ueIndex++)
 	{
+		UeInfo& ueInfo = m_ueInfo[ueIndex];
+		if (ueInfo.m_rnti == 0)
+		{
+			continue;
+		}
 		for (uint16_t i = 0; i < m_phyMacConfig->GetNumHarqProcess (); i++)
 		{
-			if ((*itTimers).second.at (i) == m_phyMacConfig->GetHarqTimeout ())
+			if (ueInfo.m_dlHarqProcessesTimer.at (i) == m_phyMacConfig->GetHarqTimeout ())
 			{ // reset HARQ process
-				NS_LOG_INFO (this << " Reset HARQ proc " << i << " for RNTI " << (*itTimers).first);
-				std::map <uint16_t, DlHarqProcessesStatus_t>::iterator itStat = m_dlHarqProcessesStatus.find ((*itTimers).first);
-				if (itStat == m_dlHarqProcessesStatus.end ())
-				{
-					NS_FATAL_ERROR ("No Process Id Status found for this RNTI " << (*itTimers).first);
-				}
-				(*itStat).second.at (i) = 0;
-				(*itTimers).second.at (i) = 0;
+				NS_LOG_INFO (this << " Reset HARQ proc " << i << " for RNTI " << ueInfo.m_rnti);
+				ueInfo.m_dlHarqProcessesStatus.at (i) = 0;
+				ueInfo.m_dlHarqProcessesTimer.at (i) = 0;
 			}
 			else
 			{
-				(*itTimers).second.at (i)++;
+				ueInfo.m_dlHarqProcessesTimer.at (i)++;
 			}
-		}
-	}
-
-	std::map <uint16_t, UlHarqProcessesTimer_t>::iterator itTimers2;
-	for (itTimers2 = m_ulHarqProcessesTimer.begin (); itTimers2 != m_ulHarqProcessesTimer.end (); itTimers2++)
-	{
-		for (uint16_t i = 0; i < m_phyMacConfig->GetNumHarqProcess (); i++)
-		{
-			if ((*itTimers2).second.at (i) == m_phyMacConfig->GetHarqTimeout ())
+			if (ueInfo.m_ulHarqProcessesTimer.at (i) == m_phyMacConfig->GetHarqTimeout ())
 			{ // reset HARQ process
-				NS_LOG_INFO (this << " Reset HARQ proc " << i << " for RNTI " << (*itTimers2).first);
-				std::map <uint16_t, UlHarqProcessesStatus_t>::iterator itStat = m_ulHarqProcessesStatus.find ((*itTimers2).first);
-				if (itStat == m_ulHarqProcessesStatus.end ())
-				{
-					NS_FATAL_ERROR ("No Process Id Status found for this RNTI " << (*itTimers2).first);
-				}
-				(*itStat).second.at (i) = 0;
-				(*itTimers2).second.at (i) = 0;
+				NS_LOG_INFO (this << " Reset HARQ proc " << i << " for RNTI " << ueInfo.m_rnti);
+				ueInfo.m_ulHarqProcessesStatus.at (i) = 0;
+				ueInfo.m_ulHarqProcessesTimer.at (i) = 0;
 			}
 			else
 			{
-				(*itTimers2).second.at (i)++;
+				ueInfo.m_ulHarqProcessesTimer.at (i)++;
 			}
 		}
 	}
-
 }
 
 uint8_t
-MmWaveFlexTtiMacScheduler::UpdateDlHarqProcessId (uint16_t rnti)
+MmWaveFlexTtiMacScheduler::UpdateDlHarqProcessId (UeInfo& ueInfo)
 {
-	NS_LOG_FUNCTION (this << rnti);
-
+	NS_LOG_FUNCTION (this << ueInfo.m_rnti);
 
 	if (m_harqOn == false)
 	{
@@ -528,53 +522,24 @@ MmWaveFlexTtiMacScheduler::UpdateDlHarqProcessId (uint16_t rnti)
 		return tbUid;
 	}
 
-//	std::map <uint16_t, uint8_t>::iterator it = m_dlHarqCurrentProcessId.find (rnti);
-//	if (it == m_dlHarqCurrentProcessId.end ())
-//	{
-//		NS_FATAL_ERROR ("No Process Id found for this RNTI " << rnti);
-//	}
-	std::map <uint16_t, DlHarqProcessesStatus_t>::iterator itStat = m_dlHarqProcessesStatus.find (rnti);
-	if (itStat == m_dlHarqProcessesStatus.end ())
-	{
-		NS_FATAL_ERROR ("No Process Id Statusfound for this RNTI " << rnti);
-	}
-
 	// search for available process ID, if none available return numHarqProcess
 	uint8_t harqId = m_phyMacConfig->GetNumHarqProcess ();
 	for (unsigned i = 0; i < m_phyMacConfig->GetNumHarqProcess (); i++)
 	{
-		if(itStat->second[i] == 0)
+		if(ueInfo.m_dlHarqProcessesStatus[i] == 0)
 		{
-			itStat->second[i] = 1;
+			ueInfo.m_dlHarqProcessesStatus[i] = 1;
 			harqId = i;
 			break;
 		}
 	}
 	return harqId;
-
-//	uint8_t i = (*it).second;
-//	do
-//	{
-//		i = (i + 1) % m_phyMacConfig->GetNumHarqProcess ();
-//	}
-//	while ( ((*itStat).second.at (i) != 0)&&(i != (*it).second));
-//	if ((*itStat).second.at (i) == 0)
-//	{
-//		(*it).second = i;
-//		(*itStat).second.at (i) = 1;
-//	}
-//	else
-//	{
-//		return (m_phyMacConfig->GetNumHarqProcess () + 1); // return a not valid harq proc id
-//	}
-//
-//	return ((*it).second);
 }
 
 uint8_t
-MmWaveFlexTtiMacScheduler::UpdateUlHarqProcessId (uint16_t rnti)
+MmWaveFlexTtiMacScheduler::UpdateUlHarqProcessId (UeInfo& ueInfo)
 {
-	NS_LOG_FUNCTION (this << rnti);
+	NS_LOG_FUNCTION (this << ueInfo.m_rnti);
 
 	if (m_harqOn == false)
 	{
@@ -583,24 +548,13 @@ MmWaveFlexTtiMacScheduler::UpdateUlHarqProcessId (uint16_t rnti)
 		return tbUid;
 	}
 
-//	std::map <uint16_t, uint8_t>::iterator it = m_ulHarqCurrentProcessId.find (rnti);
-//	if (it == m_ulHarqCurrentProcessId.end ())
-//	{
-//		NS_FATAL_ERROR ("No Process Id found for this RNTI " << rnti);
-//	}
-	std::map <uint16_t, UlHarqProcessesStatus_t>::iterator itStat = m_ulHarqProcessesStatus.find (rnti);
-	if (itStat == m_ulHarqProcessesStatus.end ())
-	{
-		NS_FATAL_ERROR ("No Process Id Statusfound for this RNTI " << rnti);
-	}
-
-	// search for available process ID, if none available return numHarqProcess+1
+	// search for available process ID, if none available return numHarqProcess
 	uint8_t harqId = m_phyMacConfig->GetNumHarqProcess ();
 	for (unsigned i = 0; i < m_phyMacConfig->GetNumHarqProcess (); i++)
 	{
-		if(itStat->second[i] == 0)
+		if(ueInfo.m_ulHarqProcessesStatus[i] == 0)
 		{
-			itStat->second[i] = 1;
+			ueInfo.m_ulHarqProcessesStatus[i] = 1;
 			harqId = i;
 			break;
 		}
@@ -688,13 +642,9 @@ MmWaveFlexTtiMacScheduler::DoSchedTriggerReq (const struct MmWaveMacSchedSapProv
 	// Process DL HARQ feedback
 	RefreshHarqProcesses ();
 
-	//m_rlcBufferReq.sort (SortRlcBufferReq); 	// sort list by RNTI
 	// number of DL/UL flows for new transmissions (not HARQ RETX)
 	int nFlowsDl = 0;
 	int nFlowsUl = 0;
-	std::map <uint16_t, struct UeSchedInfo> ueInfo;
-	std::map <uint16_t, struct UeSchedInfo>::iterator itUeInfo;
-	std::list<MmWaveMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator itRlcBuf;
 
 	// retrieve past HARQ retx buffered
 	if (m_dlHarqInfoList.size () > 0 && params.m_dlHarqInfoList.size () > 0)
@@ -732,108 +682,31 @@ MmWaveFlexTtiMacScheduler::DoSchedTriggerReq (const struct MmWaveMacSchedSapProv
 			}
 			uint8_t harqId = m_dlHarqInfoList.at (i).m_harqProcessId;
 			uint16_t rnti = m_dlHarqInfoList.at (i).m_rnti;
-			itUeInfo = ueInfo.find (rnti);
-			std::map <uint16_t, UlHarqProcessesStatus_t>::iterator itStat = m_dlHarqProcessesStatus.find (rnti);
-			if (itStat == m_dlHarqProcessesStatus.end ())
+			uint32_t ueIndex = GetUeIndex (rnti);
+			if (ueIndex == m_ueInfo.size ())
 			{
 				NS_FATAL_ERROR ("No HARQ status info found for UE " << rnti);
 			}
-			std::map <uint16_t, DlHarqRlcPduList_t>::iterator itRlcPdu =  m_dlHarqProcessesRlcPduMap.find (rnti);
-			if (itRlcPdu == m_dlHarqProcessesRlcPduMap.end ())
-			{
-				NS_FATAL_ERROR ("Unable to find RlcPdcList in HARQ buffer for RNTI " << m_dlHarqInfoList.at (i).m_rnti);
-			}
-			if(m_dlHarqInfoList.at (i).m_harqStatus == DlHarqInfo::ACK || itStat->second.at (harqId) == 0)
+			UeInfo& ueInfo = m_ueInfo[ueIndex];
+			if(m_dlHarqInfoList.at (i).m_harqStatus == DlHarqInfo::ACK || ueInfo.m_dlHarqProcessesStatus.at (harqId) == 0)
 			{ // acknowledgment or process timeout, reset process
-				//NS_LOG_DEBUG ("UE" << rnti << " DL harqId " << (unsigned)harqId << " HARQ-ACK received");
-				itStat->second.at (harqId) = 0;    // release process ID
-				for (uint16_t k = 0; k < itRlcPdu->second.size (); k++)		// clear RLC buffers
-				{
-					itRlcPdu->second.at (harqId).clear ();
-				}
+				ueInfo.m_dlHarqProcessesStatus.at (harqId) = 0;    // release process ID
+				ueInfo.m_dlHarqProcessesRlcPdu.at (harqId).clear ();		// clear RLC buffers
 				continue;
 			}
 			else if(m_dlHarqInfoList.at (i).m_harqStatus == DlHarqInfo::NACK)
 			{
-				std::map <uint16_t, DlHarqProcessesDciInfoList_t>::iterator itHarq = m_dlHarqProcessesDciInfoMap.find (rnti);
-				if (itHarq == m_dlHarqProcessesDciInfoMap.end ())
-				{
-					NS_FATAL_ERROR ("No DCI/HARQ buffer entry found for UE " << rnti);
-				}
-				DciInfoElementTdma dciInfoReTx = itHarq->second.at (harqId);
-				//NS_LOG_DEBUG ("UE" << rnti << " DL harqId " << (unsigned)harqId << " HARQ-NACK received, rv " << (unsigned)dciInfoReTx.m_rv);
+				DciInfoElementTdma dciInfoReTx = ueInfo.m_dlHarqProcessesDciInfo.at (harqId);
 				NS_ASSERT (harqId == dciInfoReTx.m_harqProcess);
-				//NS_ASSERT(itStat->second.at (harqId) > 0);
-				NS_ASSERT(itStat->second.at (harqId)-1 == dciInfoReTx.m_rv);
+				NS_ASSERT(ueInfo.m_dlHarqProcessesStatus.at (harqId)-1 == dciInfoReTx.m_rv);
 				if (dciInfoReTx.m_rv == 3) // maximum number of retx reached -> drop process
 				{
 					NS_LOG_INFO ("Max number of retransmissions reached -> drop process");
-					itStat->second.at (harqId) = 0;
-					for (uint16_t k = 0; k < (*itRlcPdu).second.size (); k++)
-					{
-						itRlcPdu->second.at (harqId).clear ();
-					}
+					ueInfo.m_dlHarqProcessesStatus.at (harqId) = 0;
+					ueInfo.m_dlHarqProcessesRlcPdu.at (harqId).clear ();
 					continue;
 				}
 
-				// (1) Check if the CQI has decreased. If no updated value available, use the same MCS minus 1.
-				// 			If CQI is below min threshold, drop process.
-				// (2) Calculate new number of symbols it will take to encode at lower MCS.
-				//			If this exceeds the total number of symbols, reTX with original parameters.
-				// 			If exceeds remaining symbols available in this subframe (but not total symbols in SF),
-				//			update DCI info and try scheduling in next SF.
-
-				/*std::map <uint16_t,uint8_t>::iterator itCqi = m_wbCqiRxed.find (itRlcBuf->m_rnti);
-				int cqi;
-				int mcsNew;
-				if (itCqi != m_wbCqiRxed.end ())
-				{
-					cqi = itCqi->second;
-					if (cqi == 0)
-					{
-						NS_LOG_INFO ("CQI for reTX is below threshhold. Drop process");
-						itStat->second.at (harqId) = 0;
-						for (uint16_t k = 0; k < (*itRlcPdu).second.size (); k++)
-						{
-							itRlcPdu->second.at (harqId).clear ();
-						}
-						continue;
-					}
-					else
-					{
-						mcsNew = m_amc->GetMcsFromCqi (cqi);  // get MCS
-					}
-				}
-				else
-				{
-					if(dciInfoReTx.m_mcs > 0)
-					{
-						mcsNew = dciInfoReTx.m_mcs - 1;
-					}
-					else
-					{
-						mcsNew = dciInfoReTx.m_mcs;
-					}
-				}
-				// compute number of symbols required
-				unsigned numSymReq;
-				if (mcsNew < dciInfoReTx.m_mcs)
-				{
-					numSymReq = m_amc->GetNumSymbolsFromTbsMcs (dciInfoReTx.m_tbSize, mcsNew);
-					while (numSymReq < symAvail && mcsNew < dciInfoReTx.m_mcs);
-					{
-						mcsNew++;
-						numSymReq = m_amc->GetNumSymbolsFromTbsMcs (dciInfoReTx.m_tbSize, mcsNew);
-					}
-					mcsNew--;
-					numSymReq = m_amc->GetNumSymbolsFromTbsMcs (dciInfoReTx.m_tbSize, mcsNew);
-				}
-				if (numSymReq <= (m_phyMacConfig->GetSymbolsPerSubframe () - resvCtrl))
-				{	// not enough symbols to encode TB at required MCS, attempt in later SF
-					dlInfoListUntxed.push_back (m_dlHarqInfoList.at (i));
-					continue;
-				}*/
-
 				// allocate retx if enough symbols are available
 				if (symAvail >= dciInfoReTx.m_numSym)
 				{
@@ -843,29 +716,18 @@ MmWaveFlexTtiMacScheduler::DoSchedTriggerReq (const struct MmWaveMacSchedSapProv
 					NS_ASSERT (symIdx <= m_phyMacConfig->GetSymbolsPerSubframe () - m_phyMacConfig->GetUlCtrlSymbols ());
 					dciInfoReTx.m_rv++;
 					dciInfoReTx.m_ndi = 0;
-					itHarq->second.at (harqId) = dciInfoReTx;
-					itStat->second.at (harqId) = itStat->second.at (harqId) + 1;
-					SlotAllocInfo slotInfo (slotIdx++, SlotAllocInfo::DL, SlotAllocInfo::CTRL_DATA, SlotAllocInfo::DIGITAL, itUeInfo->first);
+					ueInfo.m_dlHarqProcessesDciInfo.at (harqId) = dciInfoReTx;
+					ueInfo.m_dlHarqProcessesStatus.at (harqId) = ueInfo.m_dlHarqProcessesStatus.at (harqId) + 1;
+					SlotAllocInfo slotInfo (slotIdx++, SlotAllocInfo::DL, SlotAllocInfo::CTRL_DATA, SlotAllocInfo::DIGITAL, rnti);
 					slotInfo.m_dci = dciInfoReTx;
 					NS_LOG_DEBUG ("UE" << dciInfoReTx.m_rnti << " gets DL slots " << (unsigned)dciInfoReTx.m_symStart << "-" << (unsigned)(dciInfoReTx.m_symStart+dciInfoReTx.m_numSym-1) <<
 							             " tbs " << dciInfoReTx.m_tbSize << " harqId " << (unsigned)dciInfoReTx.m_harqProcess << " harqId " << (unsigned)dciInfoReTx.m_harqProcess <<
 							             " rv " << (unsigned)dciInfoReTx.m_rv << " in frame " << ret.m_sfnSf.m_frameNum << " subframe " << (unsigned)ret.m_sfnSf.m_sfNum << " RETX");
-					std::map <uint16_t, DlHarqRlcPduList_t>::iterator itRlcList =  m_dlHarqProcessesRlcPduMap.find (rnti);
-					if (itRlcList == m_dlHarqProcessesRlcPduMap.end ())
-					{
-						NS_FATAL_ERROR ("Unable to find RlcPdcList in HARQ buffer for RNTI " << rnti);
-					}
-					for (uint16_t k = 0; k < (*itRlcList).second.at(dciInfoReTx.m_harqProcess).size (); k++)
-					{
-						slotInfo.m_rlcPduInfo.push_back ((*itRlcList).second.at (dciInfoReTx.m_harqProcess).at (k));
-					}
+					const std::vector<struct RlcPduInfo>& rlcPduList = ueInfo.m_dlHarqProcessesRlcPdu.at (dciInfoReTx.m_harqProcess);
+					slotInfo.m_rlcPduInfo.insert (slotInfo.m_rlcPduInfo.end (), rlcPduList.begin (), rlcPduList.end ());
 					ret.m_sfAllocInfo.m_slotAllocInfo.push_back (slotInfo);
 					ret.m_sfAllocInfo.m_numSymAlloc += dciInfoReTx.m_numSym;
-					if (itUeInfo == ueInfo.end())
-					{
-						itUeInfo = ueInfo.insert (std::pair<uint16_t, struct UeSchedInfo> (rnti, UeSchedInfo () )).first;
-					}
-					itUeInfo->second.m_dlSymbolsRetx = dciInfoReTx.m_numSym;
+					AddToAllocList (ueIndex).m_dlSymbolsRetx = dciInfoReTx.m_numSym;
 				}
 				else
 				{
@@ -888,37 +750,28 @@ MmWaveFlexTtiMacScheduler::DoSchedTriggerReq (const struct MmWaveMacSchedSapProv
 			UlHarqInfo harqInfo = m_ulHarqInfoList.at (i);
 			uint8_t harqId = harqInfo.m_harqProcessId;
 			uint16_t rnti = harqInfo.m_rnti;
-			itUeInfo = ueInfo.find (rnti);
-			std::map <uint16_t, UlHarqProcessesStatus_t>::iterator itStat = m_ulHarqProcessesStatus.find (rnti);
-			if (itStat == m_ulHarqProcessesStatus.end ())
+			uint32_t ueIndex = GetUeIndex (rnti);
+			if (ueIndex == m_ueInfo.size ())
 			{
 				NS_LOG_ERROR ("No info found in HARQ buffer for UE (might have changed eNB) " << rnti);
+				continue;
 			}
-			if (harqInfo.m_receptionStatus == UlHarqInfo::Ok || itStat->second.at (harqId) == 0)
+			UeInfo& ueInfo = m_ueInfo[ueIndex];
+			if (harqInfo.m_receptionStatus == UlHarqInfo::Ok || ueInfo.m_ulHarqProcessesStatus.at (harqId) == 0)
 			{
-				//NS_LOG_DEBUG ("UE" << rnti << " UL harqId " << (unsigned)harqInfo.m_harqProcessId << " HARQ-ACK received");
-				if (itStat != m_ulHarqProcessesStatus.end ())
-				{
-					itStat->second.at (harqId) = 0;  // release process ID
-				}
+				ueInfo.m_ulHarqProcessesStatus.at (harqId) = 0;  // release process ID
 			}
 			else if (harqInfo.m_receptionStatus == UlHarqInfo::NotOk)
 			{
-				std::map <uint16_t, UlHarqProcessesDciInfoList_t>::iterator itHarq = m_ulHarqProcessesDciInfoMap.find (rnti);
-				if (itHarq == m_ulHarqProcessesDciInfoMap.end ())
-				{
-					NS_LOG_ERROR ("No info found in UL-HARQ buffer for UE (might have changed eNB) " << rnti);
-				}
 				// retx correspondent block: retrieve the UL-DCI
-				DciInfoElementTdma dciInfoReTx = itHarq->second.at (harqId);
-				//NS_LOG_DEBUG ("UE" << rnti << " UL harqId " << (unsigned)harqInfo.m_harqProcessId << " HARQ-NACK received, rv " << (unsigned)dciInfoReTx.m_rv);
+				DciInfoElementTdma dciInfoReTx = ueInfo.m_ulHarqProcessesDciInfo.at (harqId);
 				NS_ASSERT (harqId == dciInfoReTx.m_harqProcess);
-				NS_ASSERT(itStat->second.at (harqId) > 0);
-				NS_ASSERT(itStat->second.at (harqId)-1 == dciInfoReTx.m_rv);
+				NS_ASSERT(ueInfo.m_ulHarqProcessesStatus.at (harqId) > 0);
+				NS_ASSERT(ueInfo.m_ulHarqProcessesStatus.at (harqId)-1 == dciInfoReTx.m_rv);
 				if (dciInfoReTx.m_rv == 3)
 				{
 					NS_LOG_INFO ("Max number of retransmissions reached (UL)-> drop process");
-					itStat->second.at (harqId) = 0;
+					ueInfo.m_ulHarqProcessesStatus.at (harqId) = 0;
 					continue;
 				}
 
@@ -930,8 +783,8 @@ MmWaveFlexTtiMacScheduler::DoSchedTriggerReq (const struct MmWaveMacSchedSapProv
 					NS_ASSERT (symIdx <= m_phyMacConfig->GetSymbolsPerSubframe () - m_phyMacConfig->GetUlCtrlSymbols ());
 					dciInfoReTx.m_rv++;
 					dciInfoReTx.m_ndi = 0;
-					itStat->second.at (harqId) = itStat->second.at (harqId) + 1;
-					itHarq->second.at (harqId) = dciInfoReTx;
+					ueInfo.m_ulHarqProcessesStatus.at (harqId) = ueInfo.m_ulHarqProcessesStatus.at (harqId) + 1;
+					ueInfo.m_ulHarqProcessesDciInfo.at (harqId) = dciInfoReTx;
 					SlotAllocInfo slotInfo (slotIdx++, SlotAllocInfo::UL, SlotAllocInfo::CTRL_DATA, SlotAllocInfo::DIGITAL, rnti);
 					slotInfo.m_dci = dciInfoReTx;
 					NS_LOG_DEBUG ("UE" << dciInfoReTx.m_rnti << " gets UL slots " << (unsigned)dciInfoReTx.m_symStart << "-" << (unsigned)(dciInfoReTx.m_symStart+dciInfoReTx.m_numSym-1) <<
@@ -939,11 +792,7 @@ MmWaveFlexTtiMacScheduler::DoSchedTriggerReq (const struct MmWaveMacSchedSapProv
 											 " RETX");
 					ret.m_sfAllocInfo.m_slotAllocInfo.push_back (slotInfo);
 					ret.m_sfAllocInfo.m_numSymAlloc += dciInfoReTx.m_numSym;
-					if (itUeInfo == ueInfo.end())
-					{
-						itUeInfo = ueInfo.insert (std::pair<uint16_t, struct UeSchedInfo> (rnti, UeSchedInfo () )).first;
-					}
-					itUeInfo->second.m_ulSymbolsRetx = dciInfoReTx.m_numSym;
+					AddToAllocList (ueIndex).m_ulSymbolsRetx = dciInfoReTx.m_numSym;
 				}
 				else
 				{
@@ -961,86 +810,85 @@ MmWaveFlexTtiMacScheduler::DoSchedTriggerReq (const struct MmWaveMacSchedSapProv
 	// get info on active DL flows
 	if (symAvail > 0 && !m_ulOnly)  // remaining symbols in current subframe after HARQ retx sched
 	{
-		for (itRlcBuf = m_rlcBufferReq.begin (); itRlcBuf != m_rlcBufferReq.end (); itRlcBuf++)
+		for (unsigned ueIndex = 0; ueIndex < m_ueInfo.size (); ueIndex++)
 		{
-			itUeInfo = ueInfo.find (itRlcBuf->m_rnti);
-			//		if (itUeInfo != ueInfo.end () && itUeInfo->second.m_dlSymbols > 0)
-			//		{
-			//			continue;
-			//		}
-
-			if ( (((*itRlcBuf).m_rlcTransmissionQueueSize > 0)
-					|| ((*itRlcBuf).m_rlcRetransmissionQueueSize > 0)
-					|| ((*itRlcBuf).m_rlcStatusPduSize > 0)) )
+			UeInfo& ueInfo = m_ueInfo[ueIndex];
+			std::vector<MmWaveMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator itRlcBuf;
+			for (itRlcBuf = ueInfo.m_rlcBufferReq.begin (); itRlcBuf != ueInfo.m_rlcBufferReq.end (); itRlcBuf++)
 			{
-				NS_LOG_INFO (this << " User " << itRlcBuf->m_rnti << " LC " << (uint16_t)itRlcBuf->m_logicalChannelIdentity << " is active, status  " << (*itRlcBuf).m_rlcStatusPduSize << " retx " << (*itRlcBuf).m_rlcRetransmissionQueueSize << " tx " << (*itRlcBuf).m_rlcTransmissionQueueSize);
-				std::map <uint16_t,uint8_t>::iterator itCqi = m_wbCqiRxed.find (itRlcBuf->m_rnti);
-				uint8_t cqi = 0;
-				if (itCqi != m_wbCqiRxed.end ())
-				{
-					cqi = itCqi->second;
-				}
-				else // no CQI available
-				{
-					NS_LOG_INFO (this << " UE " << itRlcBuf->m_rnti << " does not have DL-CQI");
-					cqi = 1; // lowest value for trying a transmission
-				}
-				if (cqi != 0 || m_fixedMcsDl) 	// CQI == 0 means "out of range" (see table 7.2.3-1 of 36.213)
+				if ( (((*itRlcBuf).m_rlcTransmissionQueueSize > 0)
+						|| ((*itRlcBuf).m_rlcRetransmissionQueueSize > 0)
+						|| ((*itRlcBuf).m_rlcStatusPduSize > 0)) )
 				{
-					if (itUeInfo == ueInfo.end ())
+					NS_LOG_INFO (this << " User " << itRlcBuf->m_rnti << " LC " << (uint16_t)itRlcBuf->m_logicalChannelIdentity << " is active, status  " << (*itRlcBuf).m_rlcStatusPduSize << " retx " << (*itRlcBuf).m_rlcRetransmissionQueueSize << " tx " << (*itRlcBuf).m_rlcTransmissionQueueSize);
+					uint8_t cqi = 0;
+					if (ueInfo.m_wbCqiRxed)
 					{
-						nFlowsDl++;  // for simplicity, all RLC LCs are considered as a single flow
-						itUeInfo = ueInfo.insert (std::pair<uint16_t, struct UeSchedInfo> (itRlcBuf->m_rnti, UeSchedInfo () )).first;
+						cqi = ueInfo.m_wbCqi;
 					}
-					else if (itUeInfo->second.m_maxDlBufSize == 0)
+					else // no CQI available
 					{
-						nFlowsDl++;
+						NS_LOG_INFO (this << " UE " << itRlcBuf->m_rnti << " does not have DL-CQI");
+						cqi = 1; // lowest value for trying a transmission
 					}
-
-					if (m_fixedMcsDl)
-					{
-						itUeInfo->second.m_dlMcs = m_mcsDefaultDl;
-					}
-					else
+					if (cqi != 0 || m_fixedMcsDl) 	// CQI == 0 means "out of range" (see table 7.2.3-1 of 36.213)
 					{
-						itUeInfo->second.m_dlMcs = m_amc->GetMcsFromCqi (cqi);  // get MCS
-					}
+						if (!ueInfo.m_allocated)
+						{
+							nFlowsDl++;  // for simplicity, all RLC LCs are considered as a single flow
+							AddToAllocList (ueIndex);
+						}
+						else if (ueInfo.m_sched.m_maxDlBufSize == 0)
+						{
+							nFlowsDl++;
+						}
+						UeSchedInfo& ueSchedInfo = ueInfo.m_sched;
 
-					// temporarily store the TX queue size
-					if(itRlcBuf->m_rlcStatusPduSize > 0)
-					{
-						RlcPduInfo newRlcStatusPdu;
-						newRlcStatusPdu.m_lcid = itRlcBuf->m_logicalChannelIdentity;
-						newRlcStatusPdu.m_size += itRlcBuf->m_rlcStatusPduSize + m_subHdrSize;
-						itUeInfo->second.m_rlcPduInfo.push_back (newRlcStatusPdu);
-						itUeInfo->second.m_maxDlBufSize += newRlcStatusPdu.m_size;  // add to total DL buffer size
-					}
+						if (m_fixedMcsDl)
+						{
+							ueSchedInfo.m_dlMcs = m_mcsDefaultDl;
+						}
+						else
+						{
+							ueSchedInfo.m_dlMcs = m_amc->GetMcsFromCqi (cqi);  // get MCS
+						}
 
-					RlcPduInfo newRlcEl;
-					newRlcEl.m_lcid = itRlcBuf->m_logicalChannelIdentity;
-					if (itRlcBuf->m_rlcRetransmissionQueueSize > 0)
-					{
-						newRlcEl.m_size = itRlcBuf->m_rlcRetransmissionQueueSize;
-					}
-					else if (itRlcBuf->m_rlcTransmissionQueueSize > 0)
-					{
-						newRlcEl.m_size = itRlcBuf->m_rlcTransmissionQueueSize;
-					}
+						// temporarily store the TX queue size
+						if(itRlcBuf->m_rlcStatusPduSize > 0)
+						{
+							RlcPduInfo newRlcStatusPdu;
+							newRlcStatusPdu.m_lcid = itRlcBuf->m_logicalChannelIdentity;
+							newRlcStatusPdu.m_size += itRlcBuf->m_rlcStatusPduSize + m_subHdrSize;
+							ueSchedInfo.m_rlcPduInfo.push_back (newRlcStatusPdu);
+							ueSchedInfo.m_maxDlBufSize += newRlcStatusPdu.m_size;  // add to total DL buffer size
+						}
 
-					if (newRlcEl.m_size > 0)
-					{
-						if (newRlcEl.m_size < 8)
+						RlcPduInfo newRlcEl;
+						newRlcEl.m_lcid = itRlcBuf->m_logicalChannelIdentity;
+						if (itRlcBuf->m_rlcRetransmissionQueueSize > 0)
 						{
-							newRlcEl.m_size = 8;
+							newRlcEl.m_size = itRlcBuf->m_rlcRetransmissionQueueSize;
+						}
+						else if (itRlcBuf->m_rlcTransmissionQueueSize > 0)
+						{
+							newRlcEl.m_size = itRlcBuf->m_rlcTransmissionQueueSize;
+						}
+
+						if (newRlcEl.m_size > 0)
+						{
+							if (newRlcEl.m_size < 8)
+							{
+								newRlcEl.m_size = 8;
+							}
+							newRlcEl.m_size += m_rlcHdrSize + m_subHdrSize + 10;
+							ueSchedInfo.m_rlcPduInfo.push_back (newRlcEl);
+							ueSchedInfo.m_maxDlBufSize += newRlcEl.m_size;  // add to total DL buffer size
 						}
-						newRlcEl.m_size += m_rlcHdrSize + m_subHdrSize + 10;
-						itUeInfo->second.m_rlcPduInfo.push_back (newRlcEl);
-						itUeInfo->second.m_maxDlBufSize += newRlcEl.m_size;  // add to total DL buffer size
 					}
-				}
-				else
-				{ // SINR out of range, don't schedule for DL
-					NS_LOG_INFO ("*** RNTI " << itRlcBuf->m_rnti << " DL-CQI out of range, skipping allocation");
+					else
+					{ // SINR out of range, don't schedule for DL
+						NS_LOG_INFO ("*** RNTI " << itRlcBuf->m_rnti << " DL-CQI out of range, skipping allocation");
+					}
 				}
 			}
 		}
@@ -1049,17 +897,16 @@ MmWaveFlexTtiMacScheduler::DoSchedTriggerReq (const struct MmWaveMacSchedSapProv
 	// get info on active UL flows
 	if (symAvail > 0 && !m_dlOnly)  // remaining symbols in future UL subframe after HARQ retx sched
 	{
-		std::map <uint16_t,uint32_t>::iterator ceBsrIt;
-		for (ceBsrIt = m_ceBsrRxed.begin (); ceBsrIt != m_ceBsrRxed.end (); ceBsrIt++)
+		for (unsigned ueIndex = 0; ueIndex < m_ueInfo.size (); ueIndex++)
 		{
-			if (ceBsrIt->second > 0)  // UL buffer size > 0
+			UeInfo& ueInfo = m_ueInfo[ueIndex];
+			if (ueInfo.m_ceBsr > 0)  // UL buffer size > 0
 			{
-				std::map <uint16_t, struct UlCqiMapElem>::iterator itCqi = m_ueUlCqi.find (ceBsrIt->first);
 				int cqi = 0;
 				int mcs = 0;
-				if (itCqi == m_ueUlCqi.end ()) // no cqi info for this UE
+				if (!ueInfo.m_ulCqiRxed) // no cqi info for this UE
 				{
-					NS_LOG_INFO (this << " UE " << ceBsrIt->first << " does not have UL-CQI");
+					NS_LOG_INFO (this << " UE " << ueInfo.m_rnti << " does not have UL-CQI");
 					cqi = 1;
 					mcs = 0;
 				}
@@ -1070,70 +917,42 @@ MmWaveFlexTtiMacScheduler::DoSchedTriggerReq (const struct MmWaveMacSchedSapProv
 					Values::iterator specIt = specVals.ValuesBegin();
 					for (unsigned ichunk = 0; ichunk < m_phyMacConfig->GetTotalNumChunk (); ichunk++)
 					{
-						//double sinrLin = std::pow (10, itCqi->second.m_ueUlCqi.at (ichunk) / 10);
-//						double se1 = log2 ( 1 + (std::pow (10, sinrLin / 10 )  /
-//								( (-std::log (5.0 * m_berDl )) / 1.5) ));
-//						cqi += m_amc->GetCqiFromSpectralEfficiency (se1);
 						NS_ASSERT (specIt != specVals.ValuesEnd());
-						*specIt = itCqi->second.m_ueUlCqi.at (ichunk); //sinrLin;
+						*specIt = ueInfo.m_ulCqi.m_ueUlCqi.at (ichunk); //sinrLin;
 						specIt++;
 					}
 
-					cqi = m_amc->CreateCqiFeedbackWbTdma (specVals, itCqi->second.m_numSym, itCqi->second.m_tbSize, mcs);
-//					for (unsigned i = 0; i < chunkCqi.size(); i++)
-//					{
-//						cqi += chunkCqi[i];
-//					}
-//					cqi = cqi / m_phyMacConfig->GetTotalNumChunk ();
-
-					// take the lowest CQI value (worst chunk)
-					//				double minSinr = itCqi->second.at (0);
-					//				double sinrLinAvg = std::pow (10, itCqi->second.at (0) / 10);
-					//				for (unsigned ichunk = 1; ichunk < m_phyMacConfig->GetTotalNumChunk (); ichunk++)
-					//				{
-					//					if (itCqi->second.at (ichunk) < minSinr)
-					//					{
-					//						minSinr = itCqi->second.at (ichunk);
-					//					}
-					//					sinrLinAvg += std::pow (10, itCqi->second.at (ichunk) / 10);
-					//				}
-					//				// TODO: verify SE calculation
-					//				sinrLinAvg /= m_phyMacConfig->GetTotalNumChunk ();
-					////				double se = log2 ( 1 + sinrLinAvg );
-					//				double se = log2 ( 1 + (std::pow (10, minSinr / 10 )  /
-					//						( (-std::log (5.0 * 0.00005 )) / 1.5) ));
-					//				cqi = m_amc->GetCqiFromSpectralEfficiency (se);
+					cqi = m_amc->CreateCqiFeedbackWbTdma (specVals, ueInfo.m_ulCqi.m_numSym, ueInfo.m_ulCqi.m_tbSize, mcs);
 					if (cqi == 0 && !m_fixedMcsUl) // out of range (SINR too low)
 					{
-						NS_LOG_INFO ("*** RNTI " << ceBsrIt->first << " UL-CQI out of range, skipping allocation in UL");
-						break;  // do not allocate UE in uplink
+						NS_LOG_INFO ("*** RNTI " << ueInfo.m_rnti << " UL-CQI out of range, skipping allocation in UL");
+						continue;  // do not allocate UE in uplink
 					}
 				}
-				itUeInfo = ueInfo.find (ceBsrIt->first);
-				if (itUeInfo == ueInfo.end ())
+				if (!ueInfo.m_allocated)
 				{
-					itUeInfo = ueInfo.insert (std::pair<uint16_t, struct UeSchedInfo> (ceBsrIt->first, UeSchedInfo () )).first;
+					AddToAllocList (ueIndex);
 					nFlowsUl++;
 				}
-				else if (itUeInfo->second.m_maxUlBufSize == 0)
+				else if (ueInfo.m_sched.m_maxUlBufSize == 0)
 				{
 					nFlowsUl++;
 				}
 				if (m_fixedMcsUl)
 				{
-					itUeInfo->second.m_ulMcs = m_mcsDefaultUl;
+					ueInfo.m_sched.m_ulMcs = m_mcsDefaultUl;
 				}
 				else
 				{
-					itUeInfo->second.m_ulMcs = mcs;//m_amc->GetMcsFromCqi (cqi);  // get MCS
+					ueInfo.m_sched.m_ulMcs = mcs;//m_amc->GetMcsFromCqi (cqi);  // get MCS
 				}
-				itUeInfo->second.m_maxUlBufSize = ceBsrIt->second + m_rlcHdrSize + m_macHdrSize + 8;
+				ueInfo.m_sched.m_maxUlBufSize = ueInfo.m_ceBsr + m_rlcHdrSize + m_macHdrSize + 8;
 			}
 		}
 	}
 
 	int nFlowsTot = nFlowsDl + nFlowsUl;
-	if (ueInfo.size () == 0)
+	if (m_ueAllocList.empty ())
 	{
 		// add slot for UL control
 		SlotAllocInfo ulCtrlSlot (0xFF, SlotAllocInfo::UL, SlotAllocInfo::CTRL, SlotAllocInfo::DIGITAL, 0);
@@ -1148,46 +967,48 @@ MmWaveFlexTtiMacScheduler::DoSchedTriggerReq (const struct MmWaveMacSchedSapProv
 	// final allocated slots may be less
 	int totDlSymReq = 0;
 	int totUlSymReq = 0;
-	for (itUeInfo = ueInfo.begin (); itUeInfo != ueInfo.end (); itUeInfo++)
+	for (unsigned i = 0; i < m_ueAllocList.size (); i++)
 	{
+		UeSchedInfo& ueSchedInfo = m_ueInfo[m_ueAllocList[i]].m_sched;
 		unsigned dlTbSize = 0;
 		unsigned ulTbSize = 0;
-		if (itUeInfo->second.m_maxDlBufSize > 0)
+		if (ueSchedInfo.m_maxDlBufSize > 0)
 		{
-			itUeInfo->second.m_maxDlSymbols = CalcMinTbSizeNumSym (itUeInfo->second.m_dlMcs, itUeInfo->second.m_maxDlBufSize, dlTbSize);
-			itUeInfo->second.m_maxDlBufSize = dlTbSize;
+			ueSchedInfo.m_maxDlSymbols = CalcMinTbSizeNumSym (ueSchedInfo.m_dlMcs, ueSchedInfo.m_maxDlBufSize, dlTbSize);
+			ueSchedInfo.m_maxDlBufSize = dlTbSize;
 			if (m_fixedTti)
 			{
-				itUeInfo->second.m_maxDlSymbols = ceil((double)itUeInfo->second.m_maxDlSymbols/(double)m_symPerSlot) * m_symPerSlot; // round up to nearest sym per TTI
+				ueSchedInfo.m_maxDlSymbols = ceil((double)ueSchedInfo.m_maxDlSymbols/(double)m_symPerSlot) * m_symPerSlot; // round up to nearest sym per TTI
 			}
-			totDlSymReq += itUeInfo->second.m_maxDlSymbols;
+			totDlSymReq += ueSchedInfo.m_maxDlSymbols;
 		}
-		if (itUeInfo->second.m_maxUlBufSize > 0)
+		if (ueSchedInfo.m_maxUlBufSize > 0)
 		{
-			itUeInfo->second.m_maxUlSymbols = CalcMinTbSizeNumSym (itUeInfo->second.m_ulMcs, itUeInfo->second.m_maxUlBufSize+10, ulTbSize);
-			itUeInfo->second.m_maxUlBufSize = ulTbSize;
+			ueSchedInfo.m_maxUlSymbols = CalcMinTbSizeNumSym (ueSchedInfo.m_ulMcs, ueSchedInfo.m_maxUlBufSize+10, ulTbSize);
+			ueSchedInfo.m_maxUlBufSize = ulTbSize;
 			if (m_fixedTti)
 			{
-				itUeInfo->second.m_maxUlSymbols = ceil((double)itUeInfo->second.m_maxUlSymbols/(double)m_symPerSlot) * m_symPerSlot; // round up to nearest sym per TTI
+				ueSchedInfo.m_maxUlSymbols = ceil((double)ueSchedInfo.m_maxUlSymbols/(double)m_symPerSlot) * m_symPerSlot; // round up to nearest sym per TTI
 			}
-			totUlSymReq += itUeInfo->second.m_maxUlSymbols;
+			totUlSymReq += ueSchedInfo.m_maxUlSymbols;
 		}
 	}
 
-	std::map <uint16_t, struct UeSchedInfo>::iterator itUeInfoStart;
-	if (m_nextRnti != 0) 	// start with RNTI at which the scheduler left off
+	// visit the UEs in RNTI order, starting with the RNTI at which the scheduler left off
+	std::sort (m_ueAllocList.begin (), m_ueAllocList.end (), CompareUeRnti (m_ueInfo));
+	unsigned allocStart = 0;
+	if (m_nextRnti != 0)
 	{
-		itUeInfoStart = ueInfo.find (m_nextRnti);
-		if (itUeInfoStart == ueInfo.end ())
+		for (unsigned i = 0; i < m_ueAllocList.size (); i++)
 		{
-			itUeInfoStart = ueInfo.begin ();
+			if (m_ueInfo[m_ueAllocList[i]].m_rnti == m_nextRnti)
+			{
+				allocStart = i;
+				break;
+			}
 		}
 	}
-	else	// start with first active RNTI
-	{
-		itUeInfoStart = ueInfo.begin ();
-	}
-	itUeInfo = itUeInfoStart;
+	unsigned allocPos = allocStart;
 
 	// divide OFDM symbols evenly between active UEs, which are then evenly divided between DL and UL flows
 	if (nFlowsTot > 0)
@@ -1222,15 +1043,16 @@ MmWaveFlexTtiMacScheduler::DoSchedTriggerReq (const struct MmWaveMacSchedSapProv
 			}
 			while (remSym > 0)
 			{
+				UeSchedInfo& ueSchedInfo = m_ueInfo[m_ueAllocList[allocPos]].m_sched;
 				int addSym = 0;
 				// deficit = difference between requested and allocated symbols
-				int deficit = itUeInfo->second.m_maxDlSymbols - itUeInfo->second.m_dlSymbols;
+				int deficit = ueSchedInfo.m_maxDlSymbols - ueSchedInfo.m_dlSymbols;
 				NS_ASSERT (deficit >= 0);
 				if (m_fixedTti)
 				{
 					deficit = ceil((double)deficit/(double)m_symPerSlot) * m_symPerSlot; // round up to nearest sym per TTI
 				}
-				if (deficit > 0 && ((itUeInfo->second.m_dlSymbols+itUeInfo->second.m_dlSymbolsRetx) <= nSymPerFlow0))
+				if (deficit > 0 && ((ueSchedInfo.m_dlSymbols+ueSchedInfo.m_dlSymbolsRetx) <= nSymPerFlow0))
 				{
 					if (deficit < nRemSymPerFlow)
 					{
@@ -1261,13 +1083,13 @@ MmWaveFlexTtiMacScheduler::DoSchedTriggerReq (const struct MmWaveMacSchedSapProv
 					}
 					allocated = true;
 				}
-				itUeInfo->second.m_dlSymbols += addSym;
+				ueSchedInfo.m_dlSymbols += addSym;
 				remSym -= addSym;
 				NS_ASSERT (remSym >= 0);
 
 				addSym = 0;
 				// deficit = difference between requested and allocated symbols
-				deficit = itUeInfo->second.m_maxUlSymbols - itUeInfo->second.m_ulSymbols;
+				deficit = ueSchedInfo.m_maxUlSymbols - ueSchedInfo.m_ulSymbols;
 				NS_ASSERT (deficit >= 0);
 				if (m_fixedTti)
 				{
@@ -1277,7 +1099,7 @@ MmWaveFlexTtiMacScheduler::DoSchedTriggerReq (const struct MmWaveMacSchedSapProv
 				{
 					nRemSymPerFlow = ceil((double)nRemSymPerFlow/(double)m_symPerSlot) * m_symPerSlot; // round up to nearest sym per TTI
 				}
-				if (remSym > 0 && deficit > 0 && ((itUeInfo->second.m_ulSymbols+itUeInfo->second.m_ulSymbolsRetx) <= nSymPerFlow0))
+				if (remSym > 0 && deficit > 0 && ((ueSchedInfo.m_ulSymbols+ueSchedInfo.m_ulSymbolsRetx) <= nSymPerFlow0))
 				{
 					if (deficit < nRemSymPerFlow)
 					{
@@ -1309,16 +1131,12 @@ MmWaveFlexTtiMacScheduler::DoSchedTriggerReq (const struct MmWaveMacSchedSapProv
 						allocated = true;
 					}
 				}
-				itUeInfo->second.m_ulSymbols += addSym;
+				ueSchedInfo.m_ulSymbols += addSym;
 				remSym -= addSym;
 				NS_ASSERT (remSym >= 0);
 
-				itUeInfo++;
-				if (itUeInfo == ueInfo.end ())
-				{ // loop around to first RNTI in map
-					itUeInfo = ueInfo.begin ();
-				}
-				if (itUeInfo == itUeInfoStart)
+				allocPos = (allocPos + 1) % m_ueAllocList.size ();  // loop around to first RNTI
+				if (allocPos == allocStart)
 				{ // break when looped back to initial RNTI or no symbols remain
 					break;
 				}
@@ -1326,22 +1144,23 @@ MmWaveFlexTtiMacScheduler::DoSchedTriggerReq (const struct MmWaveMacSchedSapProv
 		}
 	}
 
-	m_nextRnti = itUeInfo->first;
+	m_nextRnti = m_ueInfo[m_ueAllocList[allocPos]].m_rnti;
 
 	// create DCI elements and assign symbol indices
 	// such that all DL slots are contiguous (at beginning of subframe)
 	// and all UL slots are contiguous (at end of subframe)
-	itUeInfo = itUeInfoStart;
+	allocPos = allocStart;
 
 	//ulSymIdx -= totUlSymActual; // symbols reserved for control at end of subframe before UL ctrl
 	NS_ASSERT (symIdx > 0);
 	do
 	{
-		UeSchedInfo &ueSchedInfo = itUeInfo->second;
+		UeInfo &ueInfo = m_ueInfo[m_ueAllocList[allocPos]];
+		UeSchedInfo &ueSchedInfo = ueInfo.m_sched;
 		if (ueSchedInfo.m_dlSymbols > 0)
 		{
 			DciInfoElementTdma dci;
-			dci.m_rnti = itUeInfo->first;
+			dci.m_rnti = ueInfo.m_rnti;
 			dci.m_format = 0;
 			dci.m_symStart = symIdx;
 			dci.m_numSym = ueSchedInfo.m_dlSymbols;
@@ -1356,29 +1175,19 @@ MmWaveFlexTtiMacScheduler::DoSchedTriggerReq (const struct MmWaveMacSchedSapProv
 			}*/
 			NS_ASSERT (symIdx <= m_phyMacConfig->GetSymbolsPerSubframe () - m_phyMacConfig->GetUlCtrlSymbols ());
 			dci.m_rv = 0;
-			dci.m_harqProcess = UpdateDlHarqProcessId (itUeInfo->first);
+			dci.m_harqProcess = UpdateDlHarqProcessId (ueInfo);
 			NS_ASSERT (dci.m_harqProcess < m_phyMacConfig->GetNumHarqProcess ());
-			NS_LOG_DEBUG ("UE" << itUeInfo->first << " DL harqId " << (unsigned)dci.m_harqProcess << " HARQ process assigned");
-			SlotAllocInfo slotInfo (slotIdx++, SlotAllocInfo::DL, SlotAllocInfo::CTRL_DATA, SlotAllocInfo::DIGITAL, itUeInfo->first);
+			NS_LOG_DEBUG ("UE" << ueInfo.m_rnti << " DL harqId " << (unsigned)dci.m_harqProcess << " HARQ process assigned");
+			SlotAllocInfo slotInfo (slotIdx++, SlotAllocInfo::DL, SlotAllocInfo::CTRL_DATA, SlotAllocInfo::DIGITAL, ueInfo.m_rnti);
 			slotInfo.m_dci = dci;
 			NS_LOG_DEBUG ("UE" << dci.m_rnti << " gets DL slots " << (unsigned)dci.m_symStart << "-" << (unsigned)(dci.m_symStart+dci.m_numSym-1) <<
 			             " tbs " << dci.m_tbSize << " mcs " << (unsigned)dci.m_mcs << " harqId " << (unsigned)dci.m_harqProcess << " rv " << (unsigned)dci.m_rv << " in frame " << ret.m_sfnSf.m_frameNum << " subframe " << (unsigned)ret.m_sfnSf.m_sfNum);
 
 			if (m_harqOn == true)
 			{	// store DCI for HARQ buffer
-				std::map <uint16_t, DlHarqProcessesDciInfoList_t>::iterator itDciInfo = m_dlHarqProcessesDciInfoMap.find (dci.m_rnti);
-				if (itDciInfo == m_dlHarqProcessesDciInfoMap.end ())
-				{
-					NS_FATAL_ERROR ("Unable to find RNTI entry in DCI HARQ buffer for RNTI " << dci.m_rnti);
-				}
-				(*itDciInfo).second.at (dci.m_harqProcess) = dci;
+				ueInfo.m_dlHarqProcessesDciInfo.at (dci.m_harqProcess) = dci;
 				// refresh timer
-				std::map <uint16_t, DlHarqProcessesTimer_t>::iterator itHarqTimer =  m_dlHarqProcessesTimer.find (dci.m_rnti);
-				if (itHarqTimer== m_dlHarqProcessesTimer.end ())
-				{
-					NS_FATAL_ERROR ("Unable to find HARQ timer for RNTI " << (uint16_t)dci.m_rnti);
-				}
-				(*itHarqTimer).second.at (dci.m_harqProcess) = 0;
+				ueInfo.m_dlHarqProcessesTimer.at (dci.m_harqProcess) = 0;
 			}
 
 			// distribute bytes between active RLC queues
@@ -1409,29 +1218,14 @@ MmWaveFlexTtiMacScheduler::DoSchedTriggerReq (const struct MmWaveMacSchedSapProv
 				}
 				// else tbSize equals RLC queue size
 				NS_ASSERT(ueSchedInfo.m_rlcPduInfo[i].m_size > 0);
-				/*for (itRlcBuf = m_rlcBufferReq.begin (); itRlcBuf != m_rlcBufferReq.end (); itRlcBuf++)
-				{
-					if(itRlcBuf->m_rnti == itUeInfo->first)
-					{
-						if(itRlcBuf->m_rlcTransmissionQueueSize == 0)
-						{
-							NS_FATAL_ERROR ("LC is scheduled but RLC buffer == 0");
-						}
-					}
-				}*/
 				// update RLC buffer info with expected queue size after scheduling
-				UpdateDlRlcBufferInfo (itUeInfo->first, ueSchedInfo.m_rlcPduInfo[i].m_lcid, ueSchedInfo.m_rlcPduInfo[i].m_size-m_subHdrSize);
+				UpdateDlRlcBufferInfo (ueInfo, ueSchedInfo.m_rlcPduInfo[i].m_lcid, ueSchedInfo.m_rlcPduInfo[i].m_size-m_subHdrSize);
 				//schedInfo.m_rlcPduList[schedInfo.m_rlcPduList.size ()-1].push_back (itRlcInfo->second[i]);
 				slotInfo.m_rlcPduInfo.push_back (ueSchedInfo.m_rlcPduInfo[i]);
 				if (m_harqOn == true)
 				{
 					// store RLC PDU list for HARQ
-					std::map <uint16_t, DlHarqRlcPduList_t>::iterator itRlcPdu =  m_dlHarqProcessesRlcPduMap.find (dci.m_rnti);
-					if (itRlcPdu == m_dlHarqProcessesRlcPduMap.end ())
-					{
-						NS_FATAL_ERROR ("Unable to find RlcPdcList in HARQ buffer for RNTI " << dci.m_rnti);
-					}
-					(*itRlcPdu).second.at (dci.m_harqProcess).push_back (ueSchedInfo.m_rlcPduInfo[i]);
+					ueInfo.m_dlHarqProcessesRlcPdu.at (dci.m_harqProcess).push_back (ueSchedInfo.m_rlcPduInfo[i]);
 				}
 			}
 			// reorder/reindex slots to maintain DL before UL slot order
@@ -1467,7 +1261,7 @@ MmWaveFlexTtiMacScheduler::DoSchedTriggerReq (const struct MmWaveMacSchedSapProv
 		if (ueSchedInfo.m_ulSymbols > 0)
 		{
 			DciInfoElementTdma dci;
-			dci.m_rnti = itUeInfo->first;
+			dci.m_rnti = ueInfo.m_rnti;
 			dci.m_format = 1;
 			NS_ASSERT (symIdx <= m_phyMacConfig->GetSymbolsPerSubframe () - m_phyMacConfig->GetUlCtrlSymbols ());
 			dci.m_numSym = ueSchedInfo.m_ulSymbols;
@@ -1481,14 +1275,14 @@ MmWaveFlexTtiMacScheduler::DoSchedTriggerReq (const struct MmWaveMacSchedSapProv
 				dci.m_mcs--;
 				dci.m_tbSize = m_amc->GetTbSizeFromMcsSymbols (dci.m_mcs, dci.m_numSym) / 8;
 			}*/
-			dci.m_harqProcess = UpdateUlHarqProcessId (itUeInfo->first);
-			NS_LOG_DEBUG ("UE" << itUeInfo->first << " UL harqId " << (unsigned)dci.m_harqProcess << " HARQ process assigned");
+			dci.m_harqProcess = UpdateUlHarqProcessId (ueInfo);
+			NS_LOG_DEBUG ("UE" << ueInfo.m_rnti << " UL harqId " << (unsigned)dci.m_harqProcess << " HARQ process assigned");
 			NS_ASSERT (dci.m_harqProcess < m_phyMacConfig->GetNumHarqProcess ());
-			SlotAllocInfo slotInfo (slotIdx++, SlotAllocInfo::UL, SlotAllocInfo::CTRL_DATA, SlotAllocInfo::DIGITAL, itUeInfo->first);
+			SlotAllocInfo slotInfo (slotIdx++, SlotAllocInfo::UL, SlotAllocInfo::CTRL_DATA, SlotAllocInfo::DIGITAL, ueInfo.m_rnti);
 			slotInfo.m_dci = dci;
 			NS_LOG_DEBUG ("UE" << dci.m_rnti << " gets UL slots " << (unsigned)dci.m_symStart << "-" << (unsigned)(dci.m_symStart+dci.m_numSym-1) <<
 						             " tbs " << dci.m_tbSize << " mcs " << (unsigned)dci.m_mcs << " harqId " << (unsigned)dci.m_harqProcess << " rv " << (unsigned)dci.m_rv << " in frame " << ulSfn.m_frameNum << " subframe " << (unsigned)ulSfn.m_sfNum);
-			UpdateUlRlcBufferInfo (itUeInfo->first, dci.m_tbSize - m_subHdrSize);
+			UpdateUlRlcBufferInfo (ueInfo, dci.m_tbSize - m_subHdrSize);
 			ret.m_sfAllocInfo.m_slotAllocInfo.push_back (slotInfo);  // add to front
 			ret.m_sfAllocInfo.m_numSymAlloc += dci.m_numSym;
 			std::vector<uint16_t> ueChunkMap;
@@ -1504,31 +1298,17 @@ MmWaveFlexTtiMacScheduler::DoSchedTriggerReq (const struct MmWaveMacSchedSapProv
 			if (m_harqOn == true)
 			{
 				uint8_t harqId = dci.m_harqProcess;
-				std::map <uint16_t, UlHarqProcessesDciInfoList_t>::iterator itHarqTbInfo = m_ulHarqProcessesDciInfoMap.find (dci.m_rnti);
-				if (itHarqTbInfo == m_ulHarqProcessesDciInfoMap.end ())
-				{
-					NS_FATAL_ERROR ("Unable to find RNTI entry in UL DCI HARQ buffer for RNTI " << dci.m_rnti);
-				}
-				(*itHarqTbInfo).second.at (harqId) = dci;
+				ueInfo.m_ulHarqProcessesDciInfo.at (harqId) = dci;
 				// Update HARQ process status (RV 0)
-				std::map <uint16_t, UlHarqProcessesStatus_t>::iterator itStat = m_ulHarqProcessesStatus.find (dci.m_rnti);
-				NS_ASSERT (itStat->second[dci.m_harqProcess] > 0);
+				NS_ASSERT (ueInfo.m_ulHarqProcessesStatus[dci.m_harqProcess] > 0);
 				// refresh timer
-				std::map <uint16_t, UlHarqProcessesTimer_t>::iterator itHarqTimer =  m_ulHarqProcessesTimer.find (dci.m_rnti);
-				if (itHarqTimer== m_ulHarqProcessesTimer.end ())
-				{
-					NS_FATAL_ERROR ("Unable to find HARQ timer for RNTI " << (uint16_t)dci.m_rnti);
-				}
-				(*itHarqTimer).second.at (dci.m_harqProcess) = 0;
+				ueInfo.m_ulHarqProcessesTimer.at (dci.m_harqProcess) = 0;
 			}
 		}
-		itUeInfo++;
-		if (itUeInfo == ueInfo.end ())
-		{ // loop around to first RNTI in map
-			itUeInfo = ueInfo.begin ();
-		}
+		allocPos = (allocPos + 1) % m_ueAllocList.size ();  // loop around to first RNTI
 	}
-	while (itUeInfo != itUeInfoStart); // break when looped back to initial RNTI
+	while (allocPos != allocStart); // break when looped back to initial RNTI
+	ResetAllocList ();
 
 	// add slot for UL control
 	SlotAllocInfo ulCtrlSlot (0xFF, SlotAllocInfo::UL, SlotAllocInfo::CTRL, SlotAllocInfo::DIGITAL, 0);
@@ -1545,8 +1325,6 @@ MmWaveFlexTtiMacScheduler::DoSchedUlMacCtrlInfoReq (const struct MmWaveMacSchedS
 {
 	NS_LOG_FUNCTION (this);
 
-	std::map <uint16_t,uint32_t>::iterator it;
-
 	for (unsigned int i = 0; i < params.m_macCeList.size (); i++)
 	{
 		if ( params.m_macCeList.at (i).m_macCeType == MacCeElement::BSR )
@@ -1566,19 +1344,15 @@ MmWaveFlexTtiMacScheduler::DoSchedUlMacCtrlInfoReq (const struct MmWaveMacSchedS
 			}
 
 			uint16_t rnti = params.m_macCeList.at (i).m_rnti;
-			it = m_ceBsrRxed.find (rnti);
-			if (it == m_ceBsrRxed.end ())
-			{
-				// create the new entry
-				m_ceBsrRxed.insert ( std::pair<uint16_t, uint32_t > (rnti, buffer));
-				NS_LOG_INFO (this << " Insert RNTI " << rnti << " queue " << buffer);
-			}
-			else
+			uint32_t ueIndex = GetUeIndex (rnti);
+			if (ueIndex == m_ueInfo.size ())
 			{
-				// update the buffer size value
-				(*it).second = buffer;
-				NS_LOG_INFO (this << " Update RNTI " << rnti << " queue " << buffer);
+				NS_LOG_ERROR (this << " BSR for unknown RNTI " << rnti);
+				continue;
 			}
+			// update the buffer size value
+			m_ueInfo[ueIndex].m_ceBsr = buffer;
+			NS_LOG_INFO (this << " Update RNTI " << rnti << " queue " << buffer);
 		}
 	}
 
@@ -1605,27 +1379,25 @@ MmWaveFlexTtiMacScheduler::SortRlcBufferReq (MmWaveMacSchedSapProvider::SchedDlR
 void
 MmWaveFlexTtiMacScheduler::RefreshDlCqiMaps (void)
 {
-  NS_LOG_FUNCTION (this << m_wbCqiTimers.size ());
+  NS_LOG_FUNCTION (this);
   // refresh DL CQI P01 Map
-  std::map <uint16_t,uint32_t>::iterator itP10 = m_wbCqiTimers.begin ();
-  while (itP10 != m_wbCqiTimers.end ())
+  for (unsigned ueIndex = 0; ueIndex < m_ueInfo.size (); ueIndex++)
     {
-      NS_LOG_INFO (this << " P10-CQI for user " << (*itP10).first << " is " << (uint32_t)(*itP10).second << " thr " << (uint32_t)m_cqiTimersThreshold);
-      if ((*itP10).second == 0)
+      UeInfo& ueInfo = m_ueInfo[ueIndex];
+      if (!ueInfo.m_wbCqiRxed)
+        {
+          continue;
+        }
+      NS_LOG_INFO (this << " P10-CQI for user " << ueInfo.m_rnti << " is " << (uint32_t)ueInfo.m_wbCqiTimer << " thr " << (uint32_t)m_cqiTimersThreshold);
+      if (ueInfo.m_wbCqiTimer == 0)
         {
           // delete correspondent entries
-          std::map <uint16_t,uint8_t>::iterator itMap = m_wbCqiRxed.find ((*itP10).first);
-          NS_ASSERT_MSG (itMap != m_wbCqiRxed.end (), " Does not find CQI report for user " << (*itP10).first);
-          NS_LOG_INFO (this << " P10-CQI exired for user " << (*itP10).first);
-          m_wbCqiRxed.erase (itMap);
-          std::map <uint16_t,uint32_t>::iterator temp = itP10;
-          itP10++;
-          m_wbCqiTimers.erase (temp);
+          NS_LOG_INFO (this << " P10-CQI exired for user " << ueInfo.m_rnti);
+          ueInfo.m_wbCqiRxed = false;
         }
       else
         {
-          (*itP10).second--;
-          itP10++;
+          ueInfo.m_wbCqiTimer--;
         }
     }
 
@@ -1637,26 +1409,24 @@ void
 MmWaveFlexTtiMacScheduler::RefreshUlCqiMaps (void)
 {
   // refresh UL CQI  Map
-  std::map <uint16_t,uint32_t>::iterator itUl = m_ueCqiTimers.begin ();
-  while (itUl != m_ueCqiTimers.end ())
+  for (unsigned ueIndex = 0; ueIndex < m_ueInfo.size (); ueIndex++)
     {
-      NS_LOG_INFO (this << " UL-CQI for user " << (*itUl).first << " is " << (uint32_t)(*itUl).second << " thr " << (uint32_t)m_cqiTimersThreshold);
-      if ((*itUl).second == 0)
+      UeInfo& ueInfo = m_ueInfo[ueIndex];
+      if (!ueInfo.m_ulCqiRxed)
+        {
+          continue;
+        }
+      NS_LOG_INFO (this << " UL-CQI for user " << ueInfo.m_rnti << " is " << (uint32_t)ueInfo.m_ulCqiTimer << " thr " << (uint32_t)m_cqiTimersThreshold);
+      if (ueInfo.m_ulCqiTimer == 0)
         {
           // delete correspondent entries
-          std::map <uint16_t, struct UlCqiMapElem>::iterator itMap = m_ueUlCqi.find ((*itUl).first);
-          NS_ASSERT_MSG (itMap != m_ueUlCqi.end (), " Does not find CQI report for user " << (*itUl).first);
-          NS_LOG_INFO (this << " UL-CQI expired for user " << (*itUl).first);
-          itMap->second.m_ueUlCqi.clear ();
-          m_ueUlCqi.erase (itMap);
-          std::map <uint16_t,uint32_t>::iterator temp = itUl;
-          itUl++;
-          m_ueCqiTimers.erase (temp);
+          NS_LOG_INFO (this << " UL-CQI expired for user " << ueInfo.m_rnti);
+          ueInfo.m_ulCqiRxed = false;
+          ueInfo.m_ulCqi.m_ueUlCqi.clear ();
         }
       else
         {
-          (*itUl).second--;
-          itUl++;
+          ueInfo.m_ulCqiTimer--;
         }
     }
 
@@ -1664,15 +1434,15 @@ MmWaveFlexTtiMacScheduler::RefreshUlCqiMaps (void)
 }
 
 void
-MmWaveFlexTtiMacScheduler::UpdateDlRlcBufferInfo (uint16_t rnti, uint8_t lcid, uint16_t size)
+MmWaveFlexTtiMacScheduler::UpdateDlRlcBufferInfo (UeInfo& ueInfo, uint8_t lcid, uint16_t size)
 {
   NS_LOG_FUNCTION (this);
-  std::list<MmWaveMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator it;
-  for (it = m_rlcBufferReq.begin (); it != m_rlcBufferReq.end (); it++)
+  std::vector<MmWaveMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator it;
+  for (it = ueInfo.m_rlcBufferReq.begin (); it != ueInfo.m_rlcBufferReq.end (); it++)
   {
-  	if (((*it).m_rnti == rnti) && ((*it).m_logicalChannelIdentity == lcid))
+  	if ((*it).m_logicalChannelIdentity == lcid)
   	{
-  		NS_LOG_INFO (this << " UE " << rnti << " LC " << (uint16_t)lcid << " txqueue " << (*it).m_rlcTransmissionQueueSize << " retxqueue " << (*it).m_rlcRetransmissionQueueSize << " status " << (*it).m_rlcStatusPduSize << " decrease " << size);
+  		NS_LOG_INFO (this << " UE " << ueInfo.m_rnti << " LC " << (uint16_t)lcid << " txqueue " << (*it).m_rlcTransmissionQueueSize << " retxqueue " << (*it).m_rlcRetransmissionQueueSize << " status " << (*it).m_rlcStatusPduSize << " decrease " << size);
   		// Update queues: RLC tx order Status, ReTx, Tx
   		// Update status queue
   		if (((*it).m_rlcStatusPduSize > 0) && (size >= (*it).m_rlcStatusPduSize))
@@ -1723,28 +1493,19 @@ MmWaveFlexTtiMacScheduler::UpdateDlRlcBufferInfo (uint16_t rnti, uint8_t lcid, u
 }
 
 void
-MmWaveFlexTtiMacScheduler::UpdateUlRlcBufferInfo (uint16_t rnti, uint16_t size)
+MmWaveFlexTtiMacScheduler::UpdateUlRlcBufferInfo (UeInfo& ueInfo, uint16_t size)
 {
 
   size = size - 2; // remove the minimum RLC overhead
-  std::map <uint16_t,uint32_t>::iterator it = m_ceBsrRxed.find (rnti);
-  if (it != m_ceBsrRxed.end ())
+  NS_LOG_INFO (this << " Update RLC BSR UE " << ueInfo.m_rnti << " size " << size << " BSR " << ueInfo.m_ceBsr);
+  if (ueInfo.m_ceBsr >= size)
     {
-      NS_LOG_INFO (this << " Update RLC BSR UE " << rnti << " size " << size << " BSR " << (*it).second);
-      if ((*it).second >= size)
-        {
-          (*it).second -= size;
-        }
-      else
-        {
-          (*it).second = 0;
-        }
+      ueInfo.m_ceBsr -= size;
     }
   else
     {
-      NS_LOG_ERROR (this << " Does not find BSR report info of UE " << rnti);
+      ueInfo.m_ceBsr = 0;
     }
-
 }
 
 
@@ -1766,36 +1527,33 @@ MmWaveFlexTtiMacScheduler::DoCschedUeConfigReq (const struct MmWaveMacCschedSapP
 {
   NS_LOG_FUNCTION (this << " RNTI " << params.m_rnti << " txMode " << (uint16_t)params.m_transmissionMode);
 
-  if (m_dlHarqProcessesStatus.find (params.m_rnti) == m_dlHarqProcessesStatus.end ())
+  if (m_ueIndexMap.find (params.m_rnti) != m_ueIndexMap.end ())
   {
-  	//m_dlHarqCurrentProcessId.insert (std::pair <uint16_t,uint8_t > (params.m_rnti, 0));
-  	DlHarqProcessesStatus_t dlHarqPrcStatus;
-  	dlHarqPrcStatus.resize (m_phyMacConfig->GetNumHarqProcess (), 0);
-  	m_dlHarqProcessesStatus.insert (std::pair <uint16_t, DlHarqProcessesStatus_t> (params.m_rnti, dlHarqPrcStatus));
-  	DlHarqProcessesTimer_t dlHarqProcessesTimer;
-  	dlHarqProcessesTimer.resize (m_phyMacConfig->GetNumHarqProcess (),0);
-  	m_dlHarqProcessesTimer.insert (std::pair <uint16_t, DlHarqProcessesTimer_t> (params.m_rnti, dlHarqProcessesTimer));
-  	DlHarqProcessesDciInfoList_t dlHarqTbInfoList;
-  	dlHarqTbInfoList.resize (m_phyMacConfig->GetNumHarqProcess ());
-  	m_dlHarqProcessesDciInfoMap.insert (std::pair <uint16_t, DlHarqProcessesDciInfoList_t> (params.m_rnti, dlHarqTbInfoList));
-  	DlHarqRlcPduList_t dlHarqRlcPduList;
-  	dlHarqRlcPduList.resize (m_phyMacConfig->GetNumHarqProcess ());
-  	m_dlHarqProcessesRlcPduMap.insert (std::pair <uint16_t, DlHarqRlcPduList_t> (params.m_rnti, dlHarqRlcPduList));
+  	return;
   }
 
-  if (m_ulHarqProcessesStatus.find (params.m_rnti) == m_ulHarqProcessesStatus.end ())
+  uint32_t ueIndex;
+  if (m_freeUeIndices.empty ())
+  {
+  	ueIndex = m_ueInfo.size ();
+  	m_ueInfo.push_back (UeInfo ());
+  }
+  else
   {
-  	//				m_ulHarqCurrentProcessId.insert (std::pair <uint16_t,uint8_t > (rnti, 0));
-  	UlHarqProcessesStatus_t ulHarqPrcStatus;
-  	ulHarqPrcStatus.resize (m_phyMacConfig->GetNumHarqProcess (), 0);
-  	m_ulHarqProcessesStatus.insert (std::pair <uint16_t, UlHarqProcessesStatus_t> (params.m_rnti, ulHarqPrcStatus));
-  	UlHarqProcessesTimer_t ulHarqProcessesTimer;
-  	ulHarqProcessesTimer.resize (m_phyMacConfig->GetNumHarqProcess (),0);
-  	m_ulHarqProcessesTimer.insert (std::pair <uint16_t, UlHarqProcessesTimer_t> (params.m_rnti, ulHarqProcessesTimer));
-  	UlHarqProcessesDciInfoList_t ulHarqTbInfoList;
-  	ulHarqTbInfoList.resize (m_phyMacConfig->GetNumHarqProcess ());
-  	m_ulHarqProcessesDciInfoMap.insert (std::pair <uint16_t, UlHarqProcessesDciInfoList_t> (params.m_rnti, ulHarqTbInfoList));
+  	ueIndex = m_freeUeIndices.back ();
+  	m_freeUeIndices.pop_back ();
   }
+  m_ueIndexMap.insert (std::pair <uint16_t, uint32_t> (params.m_rnti, ueIndex));
+
+  UeInfo& ueInfo = m_ueInfo[ueIndex];
+  ueInfo.m_rnti = params.m_rnti;
+  ueInfo.m_dlHarqProcessesStatus.resize (m_phyMacConfig->GetNumHarqProcess (), 0);
+  ueInfo.m_dlHarqProcessesTimer.resize (m_phyMacConfig->GetNumHarqProcess (), 0);
+  ueInfo.m_dlHarqProcessesDciInfo.resize (m_phyMacConfig->GetNumHarqProcess ());
+  ueInfo.m_dlHarqProcessesRlcPdu.resize (m_phyMacConfig->GetNumHarqProcess ());
+  ueInfo.m_ulHarqProcessesStatus.resize (m_phyMacConfig->GetNumHarqProcess (), 0);
+  ueInfo.m_ulHarqProcessesTimer.resize (m_phyMacConfig->GetNumHarqProcess (), 0);
+  ueInfo.m_ulHarqProcessesDciInfo.resize (m_phyMacConfig->GetNumHarqProcess ());
 }
 
 void
@@ -1810,14 +1568,20 @@ void
 MmWaveFlexTtiMacScheduler::DoCschedLcReleaseReq (const struct MmWaveMacCschedSapProvider::CschedLcReleaseReqParameters& params)
 {
   NS_LOG_FUNCTION (this);
-    for (uint16_t i = 0; i < params.m_logicalChannelIdentity.size (); i++)
+  uint32_t ueIndex = GetUeIndex (params.m_rnti);
+  if (ueIndex == m_ueInfo.size ())
+    {
+      return;
+    }
+  std::vector<MmWaveMacSchedSapProvider::SchedDlRlcBufferReqParameters>& rlcBufferReq = m_ueInfo[ueIndex].m_rlcBufferReq;
+  for (uint16_t i = 0; i < params.m_logicalChannelIdentity.size (); i++)
     {
-     std::list<MmWaveMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator it = m_rlcBufferReq.begin ();
-      while (it!=m_rlcBufferReq.end ())
+      std::vector<MmWaveMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator it = rlcBufferReq.begin ();
+      while (it != rlcBufferReq.end ())
         {
-          if (((*it).m_rnti == params.m_rnti)&&((*it).m_logicalChannelIdentity == params.m_logicalChannelIdentity.at (i)))
+          if ((*it).m_logicalChannelIdentity == params.m_logicalChannelIdentity.at (i))
             {
-              it = m_rlcBufferReq.erase (it);
+              it = rlcBufferReq.erase (it);
             }
           else
             {
@@ -1833,28 +1597,14 @@ MmWaveFlexTtiMacScheduler::DoCschedUeReleaseReq (const struct MmWaveMacCschedSap
 {
   NS_LOG_FUNCTION (this << " Release RNTI " << params.m_rnti);
 
-  //m_dlHarqCurrentProcessId.erase (params.m_rnti);
-  m_dlHarqProcessesStatus.erase  (params.m_rnti);
-  m_dlHarqProcessesTimer.erase (params.m_rnti);
-  m_dlHarqProcessesDciInfoMap.erase  (params.m_rnti);
-  m_dlHarqProcessesRlcPduMap.erase  (params.m_rnti);
-  //m_ulHarqCurrentProcessId.erase  (params.m_rnti);
-  m_ulHarqProcessesTimer.erase (params.m_rnti);
-  m_ulHarqProcessesStatus.erase  (params.m_rnti);
-  m_ulHarqProcessesDciInfoMap.erase  (params.m_rnti);
-  m_ceBsrRxed.erase (params.m_rnti);
-  std::list<MmWaveMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator it = m_rlcBufferReq.begin ();
-  while (it != m_rlcBufferReq.end ())
+  std::map <uint16_t, uint32_t>::iterator itIndex = m_ueIndexMap.find (params.m_rnti);
+  if (itIndex != m_ueIndexMap.end ())
     {
-      if ((*it).m_rnti == params.m_rnti)
-        {
-          NS_LOG_INFO (this << " Erase RNTI " << (*it).m_rnti << " LC " << (uint16_t)(*it).m_logicalChannelIdentity);
-          it = m_rlcBufferReq.erase (it);
-        }
-      else
-        {
-          it++;
-        }
+      // the entry is reset and its index reused by the next UE
+      NS_ASSERT (!m_ueInfo[itIndex->second].m_allocated);
+      m_ueInfo[itIndex->second] = UeInfo ();
+      m_freeUeIndices.push_back (itIndex->second);
+      m_ueIndexMap.erase (itIndex);
     }
   if (m_nextRntiUl == params.m_rnti)
     {
@@ -27,8 +27,8 @@
 
 
 
-#ifndef SRC_MMWAVE_MODEL_MMWAVE_RR_MAC_SCHEDULER_H_
-#define SRC_MMWAVE_MODEL_MMWAVE_RR_MAC_SCHEDULER_H_
+#ifndef SRC_MMWAVE_MODEL_MMWAVE_FLEX_TTI_MAC_SCHEDULER_H_
+#define SRC_MMWAVE_MODEL_MMWAVE_FLEX_TTI_MAC_SCHEDULER_H_
 
 
 #include "mmwave-mac-sched-sap.h"
@@ -37,10 +37,20 @@
 #include "mmwave-amc.h"
 #include "string"
 #include <vector>
-#include <set>
+#include <map>
 
 namespace ns3 {
 
+/*
+ * Flexible-TTI scheduler dividing the data symbols of a subframe evenly
+ * among the active DL and UL flows, starting each subframe from the UE at
+ * which the previous one left off.
+ *
+ * The state of each UE (RLC buffers, CQIs, BSR and HARQ processes) lives in
+ * a flat array indexed by a dense UE index that is assigned at UE
+ * configuration time; the RNTI is only looked up when a message refers to a
+ * UE.
+ */
 class MmWaveFlexTtiMacScheduler : public MmWaveMacScheduler
 {
 public:
@@ -74,9 +84,6 @@ public:
 	void RefreshDlCqiMaps (void);
 	void RefreshUlCqiMaps (void);
 
-	void UpdateDlRlcBufferInfo (uint16_t rnti, uint8_t lcid, uint16_t size);
-	void UpdateUlRlcBufferInfo (uint16_t rnti, uint16_t size);
-
 	friend class MmWaveFlexTtiMacSchedSapProvider;
 	friend class MmWaveFlexTtiMacCschedSapProvider;
 
@@ -110,6 +117,94 @@ private:
 		bool			m_ulAllocDone;
 	};
 
+	/*
+	 * Map of UEs' UL-CQI per RBG
+	 */
+	struct UlCqiMapElem
+	{
+		UlCqiMapElem () :
+			m_numSym (0), m_tbSize (0)
+		{
+		}
+		UlCqiMapElem (std::vector<double> ulCqi, uint8_t nSym, uint32_t tbs) :
+			m_ueUlCqi (ulCqi), m_numSym (nSym), m_tbSize (tbs)
+		{
+		}
+		std::vector <double> m_ueUlCqi;
+		uint8_t 	m_numSym;
+		uint32_t	m_tbSize;
+	};
+
+	/*
+	 * Everything the scheduler keeps about one UE across subframes, and its
+	 * allocation in the subframe being scheduled
+	 */
+	struct UeInfo
+	{
+		UeInfo () :
+			m_rnti (0), m_wbCqiRxed (false), m_wbCqi (0), m_wbCqiTimer (0),
+			m_ulCqiRxed (false), m_ulCqiTimer (0), m_ceBsr (0), m_allocated (false)
+		{
+		}
+
+		uint16_t	m_rnti;		// 0 if the entry is free
+		// buffer status of each DL LC, in the order of their last report
+		std::vector <MmWaveMacSchedSapProvider::SchedDlRlcBufferReqParameters> m_rlcBufferReq;
+		// DL wideband CQI and number of TTIs for which it is still valid
+		bool			m_wbCqiRxed;
+		uint8_t		m_wbCqi;
+		uint32_t	m_wbCqiTimer;
+		// UL CQI and number of TTIs for which it is still valid
+		bool			m_ulCqiRxed;
+		UlCqiMapElem m_ulCqi;
+		uint32_t	m_ulCqiTimer;
+		// UL buffer size of the last buffer status report
+		uint32_t	m_ceBsr;
+
+		//HARQ status
+		// 0: process Id available
+		// x>0: process Id equal to `x` trasmission count
+		DlHarqProcessesStatus_t m_dlHarqProcessesStatus;
+		DlHarqProcessesTimer_t m_dlHarqProcessesTimer;
+		DlHarqProcessesDciInfoList_t m_dlHarqProcessesDciInfo;
+		DlHarqRlcPduList_t m_dlHarqProcessesRlcPdu;
+		UlHarqProcessesStatus_t m_ulHarqProcessesStatus;
+		UlHarqProcessesTimer_t m_ulHarqProcessesTimer;
+		UlHarqProcessesDciInfoList_t m_ulHarqProcessesDciInfo;
+
+		UeSchedInfo	m_sched;		// allocation in the current subframe
+		bool			m_allocated;	// in the list of UEs allocated in the current subframe
+	};
+
+	/*
+	 * Orders the indices of UEs by RNTI
+	 */
+	struct CompareUeRnti
+	{
+		CompareUeRnti (const std::vector<UeInfo>& ueInfo) : m_ueInfo (ueInfo)
+		{
+		}
+		bool operator() (uint32_t lhs, uint32_t rhs) const
+		{
+			return m_ueInfo[lhs].m_rnti < m_ueInfo[rhs].m_rnti;
+		}
+		const std::vector<UeInfo>& m_ueInfo;
+	};
+
+	/*
+	 * @return the index in m_ueInfo of a UE, or m_ueInfo.size () if unknown
+	 */
+	uint32_t GetUeIndex (uint16_t rnti) const;
+
+	/*
+	 * @return the allocation of a UE in the current subframe
+	 */
+	UeSchedInfo& AddToAllocList (uint32_t ueIndex);
+	void ResetAllocList (void);
+
+	void UpdateDlRlcBufferInfo (UeInfo& ueInfo, uint8_t lcid, uint16_t size);
+	void UpdateUlRlcBufferInfo (UeInfo& ueInfo, uint16_t size);
+
 	unsigned CalcMinTbSizeNumSym (unsigned mcs, unsigned bufSize, unsigned &tbSize);
 
 	uint32_t
@@ -139,8 +234,8 @@ private:
 	  return (index);
 	}
 
-	uint8_t UpdateDlHarqProcessId (uint16_t rnti);
-	uint8_t UpdateUlHarqProcessId (uint16_t rnti);
+	uint8_t UpdateDlHarqProcessId (UeInfo& ueInfo);
+	uint8_t UpdateUlHarqProcessId (UeInfo& ueInfo);
 
 	//
 	// Implementation of the CSCHED API primitives
@@ -196,46 +291,24 @@ private:
 
 	Ptr<MmWaveAmc> m_amc;
 
-	/*
-	 * Vectors of UE's RLC info
-	 */
-	std::list <MmWaveMacSchedSapProvider::SchedDlRlcBufferReqParameters> m_rlcBufferReq;
+	uint32_t m_cqiTimersThreshold; // # of TTIs for which a CQI can be considered valid
 
 	/*
-	 * Map of UE's DL CQI WB received
-	 */
-	std::map <uint16_t,uint8_t> m_wbCqiRxed;
-	/*
-	 * Map of UE's timers on DL CQI WB received
+	 * State of the UEs, indexed by UE index
 	 */
-	std::map <uint16_t,uint32_t> m_wbCqiTimers;
-
-	uint32_t m_cqiTimersThreshold; // # of TTIs for which a CQI can be considered valid
-
+	std::vector <UeInfo> m_ueInfo;
 	/*
-	 * Map of UEs' UL-CQI per RBG
+	 * Index in m_ueInfo of each configured UE
 	 */
-	struct UlCqiMapElem
-	{
-		UlCqiMapElem (std::vector<double> ulCqi, uint8_t nSym, uint32_t tbs) :
-			m_ueUlCqi (ulCqi), m_numSym (nSym), m_tbSize (tbs)
-		{
-		}
-		std::vector <double> m_ueUlCqi;
-		uint8_t 	m_numSym;
-		uint32_t	m_tbSize;
-	};
-
-	std::map <uint16_t, struct UlCqiMapElem> m_ueUlCqi;
+	std::map <uint16_t, uint32_t> m_ueIndexMap;
 	/*
-	 * Map of UEs' timers on UL-CQI per RBG
+	 * Indices of the released entries of m_ueInfo
 	 */
-	std::map <uint16_t, uint32_t> m_ueCqiTimers;
-
+	std::vector <uint32_t> m_freeUeIndices;
 	/*
-	 * Map of UE's buffer status reports received
+	 * Indices of the UEs allocated in the current subframe
 	 */
-	std::map <uint16_t,uint32_t> m_ceBsrRxed;
+	std::vector <uint32_t> m_ueAllocList;
 
 	uint16_t m_nextRnti;
 	uint64_t m_nextRntiDl;
@@ -279,25 +352,9 @@ private:
 	uint8_t m_numHarqProcess;
 	uint8_t m_harqTimeout;
 
-	std::map <uint16_t, uint8_t> m_dlHarqCurrentProcessId;
-	//HARQ status
-	// 0: process Id available
-	// x>0: process Id equal to `x` trasmission count
-	std::map <uint16_t, DlHarqProcessesStatus_t> m_dlHarqProcessesStatus;
-	std::map <uint16_t, DlHarqProcessesTimer_t> m_dlHarqProcessesTimer;
-	std::map <uint16_t, DlHarqProcessesDciInfoList_t> m_dlHarqProcessesDciInfoMap;
-	std::map <uint16_t, DlHarqRlcPduList_t> m_dlHarqProcessesRlcPduMap;
 	std::vector <DlHarqInfo> m_dlHarqInfoList; // HARQ retx buffered
 	std::vector <UlHarqInfo> m_ulHarqInfoList; // HARQ retx buffered
 
-	std::map <uint16_t, uint8_t> m_ulHarqCurrentProcessId;
-	//HARQ status
-	// 0: process Id available
-	// x>0: process Id equal to `x` trasmission count
-	std::map <uint16_t, UlHarqProcessesStatus_t> 	m_ulHarqProcessesStatus;
-	std::map <uint16_t, UlHarqProcessesTimer_t> 	m_ulHarqProcessesTimer;
-	std::map <uint16_t, UlHarqProcessesDciInfoList_t> m_ulHarqProcessesDciInfoMap;
-
 	// needed to keep track of uplink allocations in later slots
 	std::list <struct SfAllocInfo> m_ulSfAllocInfo;
 
@@ -321,4 +378,4 @@ private:
 }
 
 
-#endif /* SRC_MMWAVE_MODEL_MMWAVE_RR_MAC_SCHEDULER_H_ */
+#endif /* SRC_MMWAVE_MODEL_MMWAVE_FLEX_TTI_MAC_SCHEDULER_H_ */
@@ -0,0 +1,1422 @@
+ /* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+ /*
+ *   Copyright (c) 2015, NYU WIRELESS, Tandon School of Engineering, New York University
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include <ns3/log.h>
+#include <ns3/abort.h>
+#include "mmwave-flex-tti-policy-mac-scheduler.h"
+#include <ns3/lte-common.h>
+#include <ns3/boolean.h>
+#include <ns3/uinteger.h>
+#include <stdlib.h>     /* abs */
+#include "mmwave-mac-pdu-header.h"
+#include "mmwave-mac-pdu-tag.h"
+#include "mmwave-spectrum-value-helper.h"
+#include <cmath>
+#include <algorithm>
+#include <ns3/eps-bearer.h>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MmWaveFlexTtiPolicyMacScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED (MmWaveFlexTtiPolicyMacScheduler);
+
+class MmWaveFlexTtiPolicyMacCschedSapProvider : public MmWaveMacCschedSapProvider
+{
+public:
+  MmWaveFlexTtiPolicyMacCschedSapProvider (MmWaveFlexTtiPolicyMacScheduler* scheduler);
+
+  // inherited from MmWaveMacCschedSapProvider
+  virtual void CschedCellConfigReq (const struct MmWaveMacCschedSapProvider::CschedCellConfigReqParameters& params);
+  virtual void CschedUeConfigReq (const struct MmWaveMacCschedSapProvider::CschedUeConfigReqParameters& params);
+  virtual void CschedLcConfigReq (const struct MmWaveMacCschedSapProvider::CschedLcConfigReqParameters& params);
+  virtual void CschedLcReleaseReq (const struct MmWaveMacCschedSapProvider::CschedLcReleaseReqParameters& params);
+  virtual void CschedUeReleaseReq (const struct MmWaveMacCschedSapProvider::CschedUeReleaseReqParameters& params);
+
+private:
+  MmWaveFlexTtiPolicyMacCschedSapProvider ();
+  MmWaveFlexTtiPolicyMacScheduler* m_scheduler;
+};
+
+MmWaveFlexTtiPolicyMacCschedSapProvider::MmWaveFlexTtiPolicyMacCschedSapProvider ()
+{
+}
+
+MmWaveFlexTtiPolicyMacCschedSapProvider::MmWaveFlexTtiPolicyMacCschedSapProvider (MmWaveFlexTtiPolicyMacScheduler* scheduler)
+	: m_scheduler (scheduler)
+{
+}
+
+void
+MmWaveFlexTtiPolicyMacCschedSapProvider::CschedCellConfigReq (const struct MmWaveMacCschedSapProvider::CschedCellConfigReqParameters& params)
+{
+  m_scheduler->DoCschedCellConfigReq (params);
+}
+
+void
+MmWaveFlexTtiPolicyMacCschedSapProvider::CschedUeConfigReq (const struct MmWaveMacCschedSapProvider::CschedUeConfigReqParameters& params)
+{
+  m_scheduler->DoCschedUeConfigReq (params);
+}
+
+
+void
+MmWaveFlexTtiPolicyMacCschedSapProvider::CschedLcConfigReq (const struct MmWaveMacCschedSapProvider::CschedLcConfigReqParameters& params)
+{
+  m_scheduler->DoCschedLcConfigReq (params);
+}
+
+void
+MmWaveFlexTtiPolicyMacCschedSapProvider::CschedLcReleaseReq (const struct MmWaveMacCschedSapProvider::CschedLcReleaseReqParameters& params)
+{
+  m_scheduler->DoCschedLcReleaseReq (params);
+}
+
+void
+MmWaveFlexTtiPolicyMacCschedSapProvider::CschedUeReleaseReq (const struct MmWaveMacCschedSapProvider::CschedUeReleaseReqParameters& params)
+{
+  m_scheduler->DoCschedUeReleaseReq (params);
+}
+
+class MmWaveFlexTtiPolicyMacSchedSapProvider : public MmWaveMacSchedSapProvider
+{
+public:
+	MmWaveFlexTtiPolicyMacSchedSapProvider (MmWaveFlexTtiPolicyMacScheduler* sched);
+
+	virtual void SchedDlRlcBufferReq (const struct MmWaveMacSchedSapProvider::SchedDlRlcBufferReqParameters& params);
+	virtual void SchedTriggerReq (const struct MmWaveMacSchedSapProvider::SchedTriggerReqParameters& params);
+	virtual void SchedDlCqiInfoReq (const struct MmWaveMacSchedSapProvider::SchedDlCqiInfoReqParameters& params);
+	virtual void SchedUlCqiInfoReq (const struct MmWaveMacSchedSapProvider::SchedUlCqiInfoReqParameters& params);
+	virtual void SchedUlMacCtrlInfoReq (const struct MmWaveMacSchedSapProvider::SchedUlMacCtrlInfoReqParameters& params);
+	virtual void SchedSetMcs (int mcs);
+private:
+  MmWaveFlexTtiPolicyMacSchedSapProvider ();
+	MmWaveFlexTtiPolicyMacScheduler* m_scheduler;
+};
+
+MmWaveFlexTtiPolicyMacSchedSapProvider::MmWaveFlexTtiPolicyMacSchedSapProvider ()
+{
+}
+
+MmWaveFlexTtiPolicyMacSchedSapProvider::MmWaveFlexTtiPolicyMacSchedSapProvider (MmWaveFlexTtiPolicyMacScheduler* sched)
+	:m_scheduler(sched)
+{
+}
+
+void
+MmWaveFlexTtiPolicyMacSchedSapProvider::SchedDlRlcBufferReq (const struct MmWaveMacSchedSapProvider::SchedDlRlcBufferReqParameters& params)
+{
+  m_scheduler->DoSchedDlRlcBufferReq (params);
+}
+
+void
+MmWaveFlexTtiPolicyMacSchedSapProvider::SchedTriggerReq (const struct MmWaveMacSchedSapProvider::SchedTriggerReqParameters& params)
+{
+	m_scheduler->DoSchedTriggerReq(params);
+}
+
+void
+MmWaveFlexTtiPolicyMacSchedSapProvider::SchedDlCqiInfoReq (const struct MmWaveMacSchedSapProvider::SchedDlCqiInfoReqParameters& params)
+{
+	m_scheduler->DoSchedDlCqiInfoReq (params);
+}
+
+void
+MmWaveFlexTtiPolicyMacSchedSapProvider::SchedUlCqiInfoReq (const struct MmWaveMacSchedSapProvider::SchedUlCqiInfoReqParameters& params)
+{
+  m_scheduler->DoSchedUlCqiInfoReq (params);
+}
+
+void
+MmWaveFlexTtiPolicyMacSchedSapProvider::SchedUlMacCtrlInfoReq (const struct MmWaveMacSchedSapProvider::SchedUlMacCtrlInfoReqParameters& params)
+{
+  m_scheduler->DoSchedUlMacCtrlInfoReq (params);
+}
+
+void
+MmWaveFlexTtiPolicyMacSchedSapProvider::SchedSetMcs (int mcs)
+{
+	m_scheduler->DoSchedSetMcs (mcs);
+}
+const unsigned MmWaveFlexTtiPolicyMacScheduler::m_macHdrSize = 0;
+const unsigned MmWaveFlexTtiPolicyMacScheduler::m_subHdrSize = 4;
+const unsigned MmWaveFlexTtiPolicyMacScheduler::m_rlcHdrSize = 3;
+
+
+MmWaveFlexTtiPolicyMacScheduler::MmWaveFlexTtiPolicyMacScheduler ()
+: m_timeWindow (99.0),
+  m_tbUid (0),
+  m_macSchedSapUser (0),
+	m_macCschedSapUser (0)
+{
+	NS_LOG_FUNCTION (this);
+	m_macSchedSapProvider = new MmWaveFlexTtiPolicyMacSchedSapProvider (this);
+	m_macCschedSapProvider = new MmWaveFlexTtiPolicyMacCschedSapProvider (this);
+}
+
+MmWaveFlexTtiPolicyMacScheduler::~MmWaveFlexTtiPolicyMacScheduler ()
+{
+	NS_LOG_FUNCTION (this);
+}
+
+void
+MmWaveFlexTtiPolicyMacScheduler::DoDispose (void)
+{
+	NS_LOG_FUNCTION (this);
+	m_ueSchedInfo.clear ();
+	m_ueIndexMap.clear ();
+	m_freeUeIndices.clear ();
+	m_dlHarqInfoList.clear ();
+	m_ulHarqInfoList.clear ();
+	m_ulAllocationMap.clear ();
+	delete m_macCschedSapProvider;
+	delete m_macSchedSapProvider;
+}
+
+TypeId
+MmWaveFlexTtiPolicyMacScheduler::GetTypeId (void)
+{
+	static TypeId tid = TypeId ("ns3::MmWaveFlexTtiPolicyMacScheduler")
+	    .SetParent<MmWaveMacScheduler> ()
+		;
+
+	return tid;
+}
+
+TypeId
+MmWaveFlexTtiPolicyMacScheduler::AddSchedulerAttributes (TypeId tid)
+{
+	// registered on each scheduler, so that the configuration paths of the
+	// schedulers stay independent, e.g. ns3::MmWaveFlexTtiPfMacScheduler::HarqEnabled
+	return tid
+    .AddAttribute ("CqiTimerThreshold",
+                   "The number of TTIs a CQI is valid (default 1000 - 1 sec.)",
+                   UintegerValue (100),
+                   MakeUintegerAccessor (&MmWaveFlexTtiPolicyMacScheduler::m_cqiTimersThreshold),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("HarqEnabled",
+                   "Activate/Deactivate the HARQ [by default is active].",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&MmWaveFlexTtiPolicyMacScheduler::m_harqOn),
+                   MakeBooleanChecker ())
+	 .AddAttribute ("FixedMcsDl",
+									"Fix MCS to value set in McsDlDefault",
+									BooleanValue (false),
+									MakeBooleanAccessor (&MmWaveFlexTtiPolicyMacScheduler::m_fixedMcsDl),
+									MakeBooleanChecker ())
+	.AddAttribute ("McsDefaultDl",
+								 "Fixed DL MCS",
+								 UintegerValue (1),
+								 MakeUintegerAccessor (&MmWaveFlexTtiPolicyMacScheduler::m_mcsDefaultDl),
+								 MakeUintegerChecker<uint8_t> ())
+	 .AddAttribute ("FixedMcsUl",
+									"Fix MCS to value set in McsUlDefault (for testing)",
+									BooleanValue (false),
+									MakeBooleanAccessor (&MmWaveFlexTtiPolicyMacScheduler::m_fixedMcsUl),
+									MakeBooleanChecker ())
+	.AddAttribute ("McsDefaultUl",
+								 "Fixed UL MCS (for testing)",
+								 UintegerValue (1),
+								 MakeUintegerAccessor (&MmWaveFlexTtiPolicyMacScheduler::m_mcsDefaultUl),
+								 MakeUintegerChecker<uint8_t> ())
+	 .AddAttribute ("DlSchedOnly",
+									"Only schedule downlink traffic (for testing)",
+									BooleanValue (false),
+									MakeBooleanAccessor (&MmWaveFlexTtiPolicyMacScheduler::m_dlOnly),
+									MakeBooleanChecker ())
+	 .AddAttribute ("UlSchedOnly",
+									"Only schedule uplink traffic (for testing)",
+									BooleanValue (false),
+									MakeBooleanAccessor (&MmWaveFlexTtiPolicyMacScheduler::m_ulOnly),
+									MakeBooleanChecker ())
+	 .AddAttribute ("FixedTti",
+									"Fix slot size",
+									BooleanValue (false),
+									MakeBooleanAccessor (&MmWaveFlexTtiPolicyMacScheduler::m_fixedTti),
+									MakeBooleanChecker ())
+	.AddAttribute ("SymPerSlot",
+								 "Number of symbols per slot in Fixed TTI mode",
+								 UintegerValue (6),
+								 MakeUintegerAccessor (&MmWaveFlexTtiPolicyMacScheduler::m_symPerSlot),
+								 MakeUintegerChecker<uint8_t> ())
+		;
+}
+
+void
+MmWaveFlexTtiPolicyMacScheduler::SetMacSchedSapUser (MmWaveMacSchedSapUser* sap)
+{
+	m_macSchedSapUser = sap;
+}
+
+void
+MmWaveFlexTtiPolicyMacScheduler::SetMacCschedSapUser (MmWaveMacCschedSapUser* sap)
+{
+	m_macCschedSapUser = sap;
+}
+
+
+MmWaveMacSchedSapProvider*
+MmWaveFlexTtiPolicyMacScheduler::GetMacSchedSapProvider ()
+{
+	return m_macSchedSapProvider;
+}
+
+MmWaveMacCschedSapProvider*
+MmWaveFlexTtiPolicyMacScheduler::GetMacCschedSapProvider ()
+{
+	return m_macCschedSapProvider;
+}
+
+void
+MmWaveFlexTtiPolicyMacScheduler::ConfigureCommonParameters (Ptr<MmWavePhyMacCommon> config)
+{
+	m_phyMacConfig = config;
+	m_amc = CreateObject <MmWaveAmc> (m_phyMacConfig);
+	m_numRbg = m_phyMacConfig->GetNumRb () / m_phyMacConfig->GetNumRbPerRbg ();
+	m_numHarqProcess = m_phyMacConfig->GetNumHarqProcess ();
+	m_harqTimeout = m_phyMacConfig->GetHarqTimeout ();
+	m_numDataSymbols = m_phyMacConfig->GetSymbolsPerSubframe () -
+			m_phyMacConfig->GetDlCtrlSymbols () - m_phyMacConfig->GetUlCtrlSymbols ();
+	NS_ASSERT_MSG (m_phyMacConfig->GetNumRb () == 1, \
+	               "System must be configured with numRb=1 for TDMA mode");
+}
+
+uint32_t
+MmWaveFlexTtiPolicyMacScheduler::GetUeIndex (uint16_t rnti) const
+{
+	std::map <uint16_t, uint32_t>::const_iterator it = m_ueIndexMap.find (rnti);
+	if (it == m_ueIndexMap.end ())
+	{
+		return m_ueSchedInfo.size ();
+	}
+	return it->second;
+}
+
+void
+MmWaveFlexTtiPolicyMacScheduler::DoSchedDlRlcBufferReq (const struct MmWaveMacSchedSapProvider::SchedDlRlcBufferReqParameters& params)
+{
+  NS_LOG_FUNCTION (this << params.m_rnti << (uint32_t) params.m_logicalChannelIdentity);
+  uint32_t ueIndex = GetUeIndex (params.m_rnti);
+  if (ueIndex == m_ueSchedInfo.size ())
+  {
+  	NS_LOG_ERROR ("UE entry not found in sched info map");
+  	return;
+  }
+  UeSchedInfo& ueInfo = m_ueSchedInfo[ueIndex];
+  uint8_t lcid = params.m_logicalChannelIdentity;
+  if((unsigned)lcid >= ueInfo.m_flowStatsDl.size ())
+  {
+  	NS_LOG_ERROR ("LC not registered");
+  	return;
+  }
+  FlowStats& flow = ueInfo.m_flowStatsDl[lcid];
+  if (params.m_txPacketSizes.size () > 0)
+  {
+  	flow.m_txPacketSizes.clear ();
+  	flow.m_txPacketDelays.clear ();
+  	// add the new DL PDCP packet sizes and their delays
+  	uint32_t totalSize = 0;
+  	double maxDelay = 0.0;
+  	std::list<uint32_t>::const_iterator itSize = params.m_txPacketSizes.begin ();
+  	std::list<double>::const_iterator itDelay = params.m_txPacketDelays.begin ();
+  	while (itSize != params.m_txPacketSizes.end() && itDelay != params.m_txPacketDelays.end ())
+  	{
+  		totalSize += *itSize;
+  		if (totalSize > flow.m_totalSchedSize)
+  		{
+  			flow.m_totalBufSize = params.m_rlcTransmissionQueueSize;
+  			flow.m_txPacketSizes.push_back (*itSize);
+  			flow.m_txPacketDelays.push_back (*itDelay);
+  			if (*itDelay > maxDelay)
+  			{
+  				maxDelay = *itDelay;
+  			}
+  		}
+  		itSize++;
+  		itDelay++;
+  	}
+  	flow.m_txQueueHolDelay = maxDelay;
+  }
+  else if (params.m_rlcTransmissionQueueSize > 0)  // case for RlcSm
+  {
+  	flow.m_totalBufSize = params.m_rlcTransmissionQueueSize;
+  }
+}
+
+
+void
+MmWaveFlexTtiPolicyMacScheduler::DoSchedUlMacCtrlInfoReq (const struct MmWaveMacSchedSapProvider::SchedUlMacCtrlInfoReqParameters& params)
+{
+	NS_LOG_FUNCTION (this);
+
+	for (unsigned int i = 0; i < params.m_macCeList.size (); i++)
+	{
+		if ( params.m_macCeList.at (i).m_macCeType == MacCeElement::BSR )
+		{
+			// buffer status report
+			// note that this scheduler does not differentiate the
+			// allocation according to which LCGs have more/less bytes
+			// to send.
+			// Hence the BSR of different LCGs are just summed up to get
+			// a total queue size that is used for allocation purposes.
+			uint16_t rnti = params.m_macCeList.at (i).m_rnti;
+			uint32_t ueIndex = GetUeIndex (rnti);
+
+			for (uint8_t lcg = 1; lcg <= 3; ++lcg)
+			{
+				uint8_t bsrId = params.m_macCeList.at (i).m_macCeValue.m_bufferStatus.at (lcg-1);
+				uint32_t bufSize = BsrId2BufferSize (bsrId);
+				if (bufSize > 0)
+				{
+					if (ueIndex == m_ueSchedInfo.size ())
+					{
+						NS_LOG_ERROR ("UE entry not found in sched info map");
+						continue;
+					}
+					FlowStats& flow = m_ueSchedInfo[ueIndex].m_flowStatsUl[lcg];
+					int diff = bufSize - (flow.m_totalBufSize + flow.m_totalSchedSize);
+					if (diff > 0)
+					{	// estimate additional packet sizes
+						flow.m_totalBufSize += diff;
+						flow.m_txPacketSizes.push_back (diff);
+						// since we expect the BSR to be generated following a packet arrival and sent at least by the end of the prev. subframe,
+						// the maximum delay is one SF (in microseconds)
+						flow.m_txPacketDelays.push_back (m_phyMacConfig->GetSubframePeriod ());
+						if (flow.m_txQueueHolDelay == 0)
+						{
+							flow.m_txQueueHolDelay = m_phyMacConfig->GetSubframePeriod ();
+						}
+					}
+				}
+			}
+		}
+	}
+
+	return;
+}
+
+void
+MmWaveFlexTtiPolicyMacScheduler::DoSchedDlCqiInfoReq (const struct MmWaveMacSchedSapProvider::SchedDlCqiInfoReqParameters& params)
+{
+  NS_LOG_FUNCTION (this);
+
+  for (unsigned int i = 0; i < params.m_cqiList.size (); i++)
+    {
+      if ( params.m_cqiList.at (i).m_cqiType == DlCqiInfo::WB )
+        {
+          // wideband CQI reporting
+          uint16_t rnti = params.m_cqiList.at (i).m_rnti;
+          uint32_t ueIndex = GetUeIndex (rnti);
+          if (ueIndex == m_ueSchedInfo.size ())
+            {
+              NS_LOG_ERROR ("UE entry not found in sched info map");
+              continue;
+            }
+          // update the CQI value (only codeword 0 at this stage (SISO)) and the correspondent timer
+          UeSchedInfo& ueInfo = m_ueSchedInfo[ueIndex];
+          ueInfo.m_wbCqiRxed = true;
+          ueInfo.m_wbCqi = params.m_cqiList.at (i).m_wbCqi;
+          ueInfo.m_wbCqiTimer = m_cqiTimersThreshold;
+        }
+      else if ( params.m_cqiList.at (i).m_cqiType == DlCqiInfo::SB )
+        {
+          // subband CQI reporting high layer configured
+          // Not used by RR Scheduler
+        }
+      else
+        {
+          NS_LOG_ERROR (this << " CQI type unknown");
+        }
+    }
+}
+
+
+void
+MmWaveFlexTtiPolicyMacScheduler::DoSchedUlCqiInfoReq (const struct MmWaveMacSchedSapProvider::SchedUlCqiInfoReqParameters& params)
+{
+  NS_LOG_FUNCTION (this);
+
+	unsigned frameNum = params.m_sfnSf.m_frameNum;
+	unsigned subframeNum =  params.m_sfnSf.m_sfNum;
+	unsigned startSymIdx =  params.m_sfnSf.m_slotNum;
+
+	switch (params.m_ulCqi.m_type)
+	{
+		case UlCqiInfo::PUSCH:
+		{
+			std::map <uint32_t, struct AllocMapElem>::iterator itMap;
+			itMap = m_ulAllocationMap.find (params.m_sfnSf.Encode ());
+			if (itMap == m_ulAllocationMap.end ())
+			{
+				NS_LOG_INFO (this << " Does not find info on allocation, size : " << m_ulAllocationMap.size ());
+				return;
+			}
+			NS_ASSERT_MSG (itMap->second.m_rntiPerChunk.size () == m_phyMacConfig->GetTotalNumChunk (), "SINR chunk map must cover full BW in TDMA mode");
+			for (unsigned i = 0; i < itMap->second.m_rntiPerChunk.size (); i++)
+			{
+				uint32_t ueIndex = GetUeIndex (itMap->second.m_rntiPerChunk.at (i));
+				if (ueIndex == m_ueSchedInfo.size ())
+				{
+					NS_LOG_INFO ("UL CQI report for released RNTI " << itMap->second.m_rntiPerChunk.at (i));
+					continue;
+				}
+				UeSchedInfo& ueInfo = m_ueSchedInfo[ueIndex];
+				if (!ueInfo.m_ulCqiRxed)
+				{
+					// create a new entry, initialized with NO_SINR value.
+					ueInfo.m_ulCqiRxed = true;
+					ueInfo.m_ulCqi.m_ueUlCqi.assign (m_phyMacConfig->GetTotalNumChunk (), 30.0);
+				}
+				ueInfo.m_ulCqi.m_ueUlCqi.at (i) = params.m_ulCqi.m_sinr.at (i);
+				ueInfo.m_ulCqi.m_numSym = itMap->second.m_numSym;
+				ueInfo.m_ulCqi.m_tbSize = itMap->second.m_tbSize;
+				// update correspondent timer
+				ueInfo.m_ulCqiTimer = m_cqiTimersThreshold;
+
+				NS_LOG_INFO ("UL CQI report for RNTI " << itMap->second.m_rntiPerChunk.at (i) << " chunk " << i << " SINR " << params.m_ulCqi.m_sinr.at (i) << \
+				             " frame " << frameNum << " subframe " << subframeNum << " startSym " << startSymIdx);
+			}
+			// remove obsolete info on allocation
+			m_ulAllocationMap.erase (itMap);
+		}
+		break;
+		default:
+			NS_FATAL_ERROR ("Unknown type of UL-CQI");
+	}
+	return;
+}
+
+void
+MmWaveFlexTtiPolicyMacScheduler::DoSchedSetMcs (int mcs)
+{
+	if (mcs >= 0 && mcs <= 28)
+	{
+		m_mcsDefaultDl = mcs;
+		m_mcsDefaultUl = mcs;
+	}
+}
+
+void
+MmWaveFlexTtiPolicyMacScheduler::RefreshHarqProcesses ()
+{
+	NS_LOG_FUNCTION (this);
+
+	for (unsigned j = 0; j < m_ueSchedInfo.size (); j++)
+	{
+		UeSchedInfo& ueInfo = m_ueSchedInfo[j];
+		if (ueInfo.m_rnti == 0)
+		{
+			continue;
+		}
+		for (uint16_t i = 0; i < m_numHarqProcess; i++)
+		{
+			if (ueInfo.m_dlHarqProcessesTimer[i] == m_harqTimeout)
+			{ // reset HARQ process
+				NS_LOG_INFO (this << " Reset HARQ proc " << i << " for RNTI " << ueInfo.m_rnti);
+				ueInfo.m_dlHarqProcessesStatus[i] = 0;
+				ueInfo.m_dlHarqProcessesTimer[i] = 0;
+			}
+			else
+			{
+				ueInfo.m_dlHarqProcessesTimer[i]++;
+			}
+			if (ueInfo.m_ulHarqProcessesTimer[i] == m_harqTimeout)
+			{ // reset HARQ process
+				NS_LOG_INFO (this << " Reset HARQ proc " << i << " for RNTI " << ueInfo.m_rnti);
+				ueInfo.m_ulHarqProcessesStatus[i] = 0;
+				ueInfo.m_ulHarqProcessesTimer[i] = 0;
+			}
+			else
+			{
+				ueInfo.m_ulHarqProcessesTimer[i]++;
+			}
+		}
+	}
+}
+
+uint8_t
+MmWaveFlexTtiPolicyMacScheduler::UpdateDlHarqProcessId (UeSchedInfo& ueInfo)
+{
+	NS_LOG_FUNCTION (this << ueInfo.m_rnti);
+
+	if (m_harqOn == false)
+	{
+		uint8_t tbUid = m_tbUid;
+		m_tbUid = (m_tbUid+1) % m_numHarqProcess;
+		return tbUid;
+	}
+
+	// search for available process ID, if none available return numHarqProcess
+	uint8_t harqId = m_numHarqProcess;
+	for (unsigned i = 0; i < m_numHarqProcess; i++)
+	{
+		if(ueInfo.m_dlHarqProcessesStatus[i] == 0)
+		{
+			ueInfo.m_dlHarqProcessesStatus[i] = 1;
+			harqId = i;
+			break;
+		}
+	}
+	return harqId;
+}
+
+uint8_t
+MmWaveFlexTtiPolicyMacScheduler::UpdateUlHarqProcessId (UeSchedInfo& ueInfo)
+{
+	NS_LOG_FUNCTION (this << ueInfo.m_rnti);
+
+	if (m_harqOn == false)
+	{
+		uint8_t tbUid = m_tbUid;
+		m_tbUid = (m_tbUid+1) % m_numHarqProcess;
+		return tbUid;
+	}
+
+	// search for available process ID, if none available return numHarqProcess
+	uint8_t harqId = m_numHarqProcess;
+	for (unsigned i = 0; i < m_numHarqProcess; i++)
+	{
+		if(ueInfo.m_ulHarqProcessesStatus[i] == 0)
+		{
+			ueInfo.m_ulHarqProcessesStatus[i] = 1;
+			harqId = i;
+			break;
+		}
+	}
+	return harqId;
+}
+
+unsigned MmWaveFlexTtiPolicyMacScheduler::CalcMinTbSizeNumSym (unsigned mcs, unsigned bufSize, unsigned &tbSize)
+{
+	// bisection line search to find minimum number of slots needed to encode entire buffer
+	MmWaveMacPduHeader dummyMacHeader;
+	int numSymLow = 0;
+	int numSymHigh = m_phyMacConfig->GetSymbolsPerSubframe();
+
+	int diff = 0;
+	tbSize = (m_amc->GetTbSizeFromMcsSymbols (mcs, numSymHigh) / 8); // start with max value
+	while ((unsigned)tbSize > bufSize)
+	{
+		diff = abs(numSymHigh-numSymLow)/2;
+		if (diff == 0)
+		{
+			tbSize = (m_amc->GetTbSizeFromMcsSymbols (mcs, numSymHigh) / 8);
+			return numSymHigh;
+		}
+		tbSize = (m_amc->GetTbSizeFromMcsSymbols (mcs, numSymHigh - diff) / 8);
+		if ((unsigned)tbSize > bufSize)
+		{
+			numSymHigh -= diff;
+		}
+		while ((unsigned)tbSize < bufSize)
+		{
+			diff = abs(numSymHigh-numSymLow)/2;
+			if (diff == 0)
+			{
+				tbSize = (m_amc->GetTbSizeFromMcsSymbols (mcs, numSymHigh) / 8);
+				return numSymHigh;
+			}
+			tbSize = (m_amc->GetTbSizeFromMcsSymbols (mcs, numSymLow + diff) / 8);
+			if ((unsigned)tbSize < bufSize)
+			{
+				numSymLow += diff;
+			}
+		}
+	}
+
+	tbSize = (m_amc->GetTbSizeFromMcsSymbols (mcs, numSymHigh) / 8);
+	return (unsigned)numSymHigh;
+}
+
+void
+MmWaveFlexTtiPolicyMacScheduler::AddToAllocList (uint32_t ueIndex)
+{
+	if (!m_ueSchedInfo[ueIndex].m_allocated)
+	{
+		m_ueSchedInfo[ueIndex].m_allocated = true;
+		m_ueAllocList.push_back (ueIndex);
+	}
+}
+
+void
+MmWaveFlexTtiPolicyMacScheduler::ResetAllocList (void)
+{
+	// reset the alloc info for the next scheduler call
+	for (unsigned i = 0; i < m_ueAllocList.size (); i++)
+	{
+		UeSchedInfo& ueInfo = m_ueSchedInfo[m_ueAllocList[i]];
+		ueInfo.m_dlSymbols = 0;
+		ueInfo.m_ulSymbols = 0;
+		ueInfo.m_dlTbSize = 0;
+		ueInfo.m_ulTbSize = 0;
+		ueInfo.m_dlSymbolsRetx = 0;
+		ueInfo.m_ulSymbolsRetx = 0;
+		ueInfo.m_currTputDl = 0;
+		ueInfo.m_currTputUl = 0;
+		ueInfo.m_avgTputDl = 0;
+		ueInfo.m_avgTputUl = 0;
+		ueInfo.m_totBufDl = 0;
+		ueInfo.m_totBufUl = 0;
+		ueInfo.m_dlAllocDone = false;
+		ueInfo.m_ulAllocDone = false;
+		ueInfo.m_rlcPduInfo.clear ();
+		ueInfo.m_allocated = false;
+	}
+	m_ueAllocList.clear ();
+	m_ueNewDataList.clear ();
+}
+
+void
+MmWaveFlexTtiPolicyMacScheduler::GrantSymbol (UeSchedInfo& ueInfo)
+{
+	// evenly distribute symbols between DL and UL flows of same UE
+	if ((ueInfo.m_allocUlLast || ueInfo.m_dlAllocDone) && !ueInfo.m_ulAllocDone)
+	{
+		ueInfo.m_ulSymbols++;
+		ueInfo.m_ulTbSize = m_amc->GetTbSizeFromMcsSymbols (ueInfo.m_ulMcs, ueInfo.m_ulSymbols) / 8;
+		if (ueInfo.m_ulTbSize >= ueInfo.m_totBufUl)
+		{
+			ueInfo.m_ulAllocDone = true;
+			ueInfo.m_lastAvgTputUl = ueInfo.m_avgTputUl;
+		}
+		ueInfo.m_allocUlLast = true;
+
+		uint32_t tbSize = m_amc->GetTbSizeFromMcsSymbols (ueInfo.m_ulMcs, ueInfo.m_ulSymbols);
+		ueInfo.m_currTputUl = std::min(ueInfo.m_totBufUl,tbSize) / (m_phyMacConfig->GetSubframePeriod () * 1E-6);
+		ueInfo.m_avgTputUl = ((1.0 - (1.0 / m_timeWindow)) * ueInfo.m_lastAvgTputUl) +
+				((1.0 / m_timeWindow) * ((double)ueInfo.m_ulTbSize / (m_phyMacConfig->GetSubframePeriod () * 1E-6)));
+	}
+	else
+	{
+		NS_ASSERT (!ueInfo.m_dlAllocDone);
+		ueInfo.m_dlSymbols++;
+		ueInfo.m_dlTbSize = m_amc->GetTbSizeFromMcsSymbols (ueInfo.m_dlMcs, ueInfo.m_dlSymbols) / 8;
+		if (ueInfo.m_dlTbSize >= ueInfo.m_totBufDl)
+		{
+			ueInfo.m_dlAllocDone = true;
+			ueInfo.m_lastAvgTputDl = ueInfo.m_avgTputDl;
+		}
+		ueInfo.m_allocUlLast = false;
+
+		uint32_t tbSize = m_amc->GetTbSizeFromMcsSymbols (ueInfo.m_dlMcs, ueInfo.m_dlSymbols);
+		ueInfo.m_currTputDl = std::min(ueInfo.m_totBufDl,tbSize) / (m_phyMacConfig->GetSubframePeriod () * 1E-6);
+		ueInfo.m_avgTputDl = ((1.0 - (1.0 / m_timeWindow)) * ueInfo.m_lastAvgTputDl) +
+				((1.0 / m_timeWindow) * ((double)ueInfo.m_dlTbSize / (m_phyMacConfig->GetSubframePeriod () * 1E-6)));
+	}
+}
+
+static bool
+CompareRnti (const MmWaveFlexTtiPolicyMacScheduler::UeSchedInfo* lue, const MmWaveFlexTtiPolicyMacScheduler::UeSchedInfo* rue)
+{
+	return lue->m_rnti < rue->m_rnti;
+}
+
+void
+MmWaveFlexTtiPolicyMacScheduler::DoSchedTriggerReq (const struct MmWaveMacSchedSapProvider::SchedTriggerReqParameters& params)
+{
+	uint16_t frameNum = params.m_snfSf.m_frameNum;
+	uint8_t	sfNum = params.m_snfSf.m_sfNum;
+
+	MmWaveMacSchedSapUser::SchedConfigIndParameters ret;
+	ret.m_sfnSf = params.m_snfSf;
+	ret.m_sfAllocInfo.m_sfnSf = ret.m_sfnSf;
+	SfnSf ulSfn = ret.m_sfnSf;
+	if (ret.m_sfnSf.m_sfNum + m_phyMacConfig->GetUlSchedDelay () >=  m_phyMacConfig->GetSubframesPerFrame ())
+	{
+		ulSfn.m_frameNum++;
+	}
+	ulSfn.m_sfNum = (ret.m_sfnSf.m_sfNum + m_phyMacConfig->GetUlSchedDelay ()) % m_phyMacConfig->GetSubframesPerFrame ();
+	NS_LOG_DEBUG ("Scheduling DL frame "<< (unsigned)frameNum << " subframe " << (unsigned)sfNum
+								<< " UL frame " << (unsigned)ulSfn.m_frameNum << " subframe " << (unsigned)ulSfn.m_sfNum);
+
+	// add slot for DL control
+	SlotAllocInfo dlCtrlSlot (0, SlotAllocInfo::DL, SlotAllocInfo::CTRL, SlotAllocInfo::DIGITAL, 0);
+	dlCtrlSlot.m_dci.m_numSym = 1;
+	dlCtrlSlot.m_dci.m_symStart = 0;
+	ret.m_sfAllocInfo.m_slotAllocInfo.push_back (dlCtrlSlot);
+
+	int symAvail = m_phyMacConfig->GetSymbolsPerSubframe () - m_phyMacConfig->GetDlCtrlSymbols() - m_phyMacConfig->GetUlCtrlSymbols();
+	uint8_t slotIdx = 1;
+	uint8_t symIdx = m_phyMacConfig->GetDlCtrlSymbols(); // symbols reserved for control at beginning of subframe
+
+	// process received CQIs
+	RefreshDlCqiMaps ();
+	RefreshUlCqiMaps ();
+
+	// Process DL HARQ feedback
+	RefreshHarqProcesses ();
+
+	// retrieve past HARQ retx buffered
+	if (m_dlHarqInfoList.size () > 0 && params.m_dlHarqInfoList.size () > 0)
+	{
+		m_dlHarqInfoList.insert (m_dlHarqInfoList.end (), params.m_dlHarqInfoList.begin (), params.m_dlHarqInfoList.end ());
+	}
+	else if (params.m_dlHarqInfoList.size () > 0)
+	{
+		m_dlHarqInfoList = params.m_dlHarqInfoList;
+	}
+	if (m_ulHarqInfoList.size () > 0 && params.m_ulHarqInfoList.size () > 0)
+	{
+		m_ulHarqInfoList.insert (m_ulHarqInfoList.end (), params.m_ulHarqInfoList.begin (), params.m_ulHarqInfoList.end ());
+	}
+	else if (params.m_ulHarqInfoList.size () > 0)
+	{
+		m_ulHarqInfoList = params.m_ulHarqInfoList;
+	}
+
+	if (m_harqOn == false)		// Ignore HARQ feedback
+	{
+		m_dlHarqInfoList.clear ();
+	}
+	else
+	{
+		// Process DL HARQ feedback and assign slots for RETX if resources available
+		std::vector <struct DlHarqInfo> dlInfoListUntxed;  // TBs not able to be retransmitted in this sf
+		std::vector <struct UlHarqInfo> ulInfoListUntxed;
+
+		for (unsigned i = 0; i < m_dlHarqInfoList.size (); i++)
+		{
+			if (symAvail == 0)
+			{
+				break;	// no symbols left to allocate
+			}
+			uint8_t harqId = m_dlHarqInfoList.at (i).m_harqProcessId;
+			uint16_t rnti = m_dlHarqInfoList.at (i).m_rnti;
+			uint32_t ueIndex = GetUeIndex (rnti);
+			if (ueIndex == m_ueSchedInfo.size ())
+			{
+				NS_FATAL_ERROR ("No HARQ status info found for UE " << rnti);
+			}
+			UeSchedInfo& ueInfo = m_ueSchedInfo[ueIndex];
+			if(m_dlHarqInfoList.at (i).m_harqStatus == DlHarqInfo::ACK || ueInfo.m_dlHarqProcessesStatus.at (harqId) == 0)
+			{ // acknowledgment or process timeout, reset process
+				ueInfo.m_dlHarqProcessesStatus.at (harqId) = 0;    // release process ID
+				ueInfo.m_dlHarqProcessesRlcPdu.at (harqId).clear ();		// clear RLC buffers
+				continue;
+			}
+			else if(m_dlHarqInfoList.at (i).m_harqStatus == DlHarqInfo::NACK)
+			{
+				DciInfoElementTdma dciInfoReTx = ueInfo.m_dlHarqProcessesDciInfo.at (harqId);
+				NS_ASSERT (harqId == dciInfoReTx.m_harqProcess);
+				NS_ASSERT(ueInfo.m_dlHarqProcessesStatus.at (harqId)-1 == dciInfoReTx.m_rv);
+				if (dciInfoReTx.m_rv == 3) // maximum number of retx reached -> drop process
+				{
+					NS_LOG_INFO ("Max number of retransmissions reached -> drop process");
+					ueInfo.m_dlHarqProcessesStatus.at (harqId) = 0;
+					ueInfo.m_dlHarqProcessesRlcPdu.at (harqId).clear ();
+					continue;
+				}
+				// allocate retx if enough symbols are available
+				if (symAvail >= dciInfoReTx.m_numSym)
+				{
+					symAvail -= dciInfoReTx.m_numSym;
+					dciInfoReTx.m_symStart = symIdx;
+					symIdx += dciInfoReTx.m_numSym;
+					NS_ASSERT (symIdx <= m_phyMacConfig->GetSymbolsPerSubframe () - m_phyMacConfig->GetUlCtrlSymbols ());
+					dciInfoReTx.m_rv++;
+					dciInfoReTx.m_ndi = 0;
+					ueInfo.m_dlHarqProcessesDciInfo.at (harqId) = dciInfoReTx;
+					ueInfo.m_dlHarqProcessesStatus.at (harqId) = ueInfo.m_dlHarqProcessesStatus.at (harqId) + 1;
+					SlotAllocInfo slotInfo (slotIdx++, SlotAllocInfo::DL, SlotAllocInfo::CTRL_DATA, SlotAllocInfo::DIGITAL, rnti);
+					slotInfo.m_dci = dciInfoReTx;
+					NS_LOG_DEBUG ("UE" << dciInfoReTx.m_rnti << " gets DL slots " << (unsigned)dciInfoReTx.m_symStart << "-" << (unsigned)(dciInfoReTx.m_symStart+dciInfoReTx.m_numSym-1) <<
+												" tbs " << dciInfoReTx.m_tbSize << " harqId " << (unsigned)dciInfoReTx.m_harqProcess <<
+												" rv " << (unsigned)dciInfoReTx.m_rv << " in frame " << ret.m_sfnSf.m_frameNum << " subframe " << (unsigned)ret.m_sfnSf.m_sfNum << " RETX");
+					const std::vector<struct RlcPduInfo>& rlcPdus = ueInfo.m_dlHarqProcessesRlcPdu.at (dciInfoReTx.m_harqProcess);
+					slotInfo.m_rlcPduInfo.insert (slotInfo.m_rlcPduInfo.end (), rlcPdus.begin (), rlcPdus.end ());
+					ret.m_sfAllocInfo.m_slotAllocInfo.push_back (slotInfo);
+					ret.m_sfAllocInfo.m_numSymAlloc += dciInfoReTx.m_numSym;
+
+					ueInfo.m_dlSymbolsRetx = dciInfoReTx.m_numSym;
+					AddToAllocList (ueIndex);
+				}
+				else
+				{
+					NS_LOG_INFO ("No resource for this retx -> buffer it");
+					dlInfoListUntxed.push_back (m_dlHarqInfoList.at (i));
+				}
+			}
+		}
+
+		m_dlHarqInfoList.clear ();
+		m_dlHarqInfoList = dlInfoListUntxed;
+
+		// Process UL HARQ feedback
+		for (uint16_t i = 0; i < m_ulHarqInfoList.size (); i++)
+		{
+			if (symAvail == 0)
+			{
+				break;	// no symbols left to allocate
+			}
+			UlHarqInfo harqInfo = m_ulHarqInfoList.at (i);
+			uint8_t harqId = harqInfo.m_harqProcessId;
+			uint16_t rnti = harqInfo.m_rnti;
+			uint32_t ueIndex = GetUeIndex (rnti);
+			if (ueIndex == m_ueSchedInfo.size ())
+			{
+				NS_LOG_ERROR ("No info found in HARQ buffer for UE (might have changed eNB) " << rnti);
+				continue;
+			}
+			UeSchedInfo& ueInfo = m_ueSchedInfo[ueIndex];
+			if (harqInfo.m_receptionStatus == UlHarqInfo::Ok || ueInfo.m_ulHarqProcessesStatus.at (harqId) == 0)
+			{
+				ueInfo.m_ulHarqProcessesStatus.at (harqId) = 0;  // release process ID
+			}
+			else if (harqInfo.m_receptionStatus == UlHarqInfo::NotOk)
+			{
+				// retx correspondent block: retrieve the UL-DCI
+				DciInfoElementTdma dciInfoReTx = ueInfo.m_ulHarqProcessesDciInfo.at (harqId);
+				NS_ASSERT (harqId == dciInfoReTx.m_harqProcess);
+				NS_ASSERT(ueInfo.m_ulHarqProcessesStatus.at (harqId) > 0);
+				NS_ASSERT(ueInfo.m_ulHarqProcessesStatus.at (harqId)-1 == dciInfoReTx.m_rv);
+				if (dciInfoReTx.m_rv == 3)
+				{
+					NS_LOG_INFO ("Max number of retransmissions reached (UL)-> drop process");
+					ueInfo.m_ulHarqProcessesStatus.at (harqId) = 0;
+					continue;
+				}
+
+				if (symAvail >= dciInfoReTx.m_numSym)
+				{
+					symAvail -= dciInfoReTx.m_numSym;
+					dciInfoReTx.m_symStart = symIdx;
+					symIdx += dciInfoReTx.m_numSym;
+					NS_ASSERT (symIdx <= m_phyMacConfig->GetSymbolsPerSubframe () - m_phyMacConfig->GetUlCtrlSymbols ());
+					dciInfoReTx.m_rv++;
+					dciInfoReTx.m_ndi = 0;
+					ueInfo.m_ulHarqProcessesStatus.at (harqId) = ueInfo.m_ulHarqProcessesStatus.at (harqId) + 1;
+					ueInfo.m_ulHarqProcessesDciInfo.at (harqId) = dciInfoReTx;
+					SlotAllocInfo slotInfo (slotIdx++, SlotAllocInfo::UL, SlotAllocInfo::CTRL_DATA, SlotAllocInfo::DIGITAL, rnti);
+					slotInfo.m_dci = dciInfoReTx;
+					NS_LOG_DEBUG ("UE" << dciInfoReTx.m_rnti << " gets UL slots " << (unsigned)dciInfoReTx.m_symStart << "-" << (unsigned)(dciInfoReTx.m_symStart+dciInfoReTx.m_numSym-1) <<
+												" tbs " << dciInfoReTx.m_tbSize << " harqId " << (unsigned)dciInfoReTx.m_harqProcess << " rv " << (unsigned)dciInfoReTx.m_rv << " in frame " << ulSfn.m_frameNum << " subframe " << (unsigned)ulSfn.m_sfNum <<
+												" RETX");
+					ret.m_sfAllocInfo.m_slotAllocInfo.push_back (slotInfo);
+					ret.m_sfAllocInfo.m_numSymAlloc += dciInfoReTx.m_numSym;
+
+					ueInfo.m_ulSymbolsRetx = dciInfoReTx.m_numSym;
+					AddToAllocList (ueIndex);
+				}
+				else
+				{
+					ulInfoListUntxed.push_back (m_ulHarqInfoList.at (i));
+				}
+			}
+		}
+
+		m_ulHarqInfoList.clear ();
+		m_ulHarqInfoList = ulInfoListUntxed;
+	}
+
+	// add slot for UL control
+	SlotAllocInfo ulCtrlSlot (0xFF, SlotAllocInfo::UL, SlotAllocInfo::CTRL, SlotAllocInfo::DIGITAL, 0);
+	ulCtrlSlot.m_dci.m_numSym = 1;
+	ulCtrlSlot.m_dci.m_symStart = m_phyMacConfig->GetSymbolsPerSubframe()-1;
+
+	// no further allocations
+	if (symAvail == 0)
+	{
+		ret.m_sfAllocInfo.m_slotAllocInfo.push_back (ulCtrlSlot);
+		m_macSchedSapUser->SchedConfigInd (ret);
+		ResetAllocList ();
+		return;
+	}
+
+	// ********************* END OF HARQ SECTION, START OF NEW DATA SCHEDULING ********************* //
+
+	// compute achievable rates in current subframe
+	for (unsigned ueIndex = 0; ueIndex < m_ueSchedInfo.size (); ueIndex++)
+	{
+		UeSchedInfo& ueInfo = m_ueSchedInfo[ueIndex];
+		if (ueInfo.m_rnti == 0)
+		{
+			continue;
+		}
+
+		// get DL-CQI and compute DL rate per symbol
+		uint8_t cqi = 0;
+		if (ueInfo.m_wbCqiRxed)
+		{
+			cqi = ueInfo.m_wbCqi;
+		}
+		else // no CQI available
+		{
+			NS_LOG_INFO (this << " UE " << ueInfo.m_rnti << " does not have DL-CQI");
+			cqi = 1; // lowest value for trying a transmission
+		}
+		if (cqi != 0)
+		{
+			ueInfo.m_dlMcs = m_amc->GetMcsFromCqi (cqi);  // update MCS
+			// compute total DL and UL bytes buffered
+			for (unsigned iflow = 0; iflow < ueInfo.m_flowStatsDl.size(); iflow++)
+			{
+				if (ueInfo.m_flowStatsDl[iflow].m_totalBufSize > 0)
+				{
+					ueInfo.m_totBufDl += ueInfo.m_flowStatsDl[iflow].m_totalBufSize;
+					RlcPduInfo newRlcEl;
+					newRlcEl.m_lcid = ueInfo.m_flowStatsDl[iflow].m_lcid;
+					newRlcEl.m_size = ueInfo.m_flowStatsDl[iflow].m_totalBufSize;
+					ueInfo.m_rlcPduInfo.push_back (newRlcEl);
+				}
+			}
+			if (ueInfo.m_totBufDl > 0)
+			{
+				uint32_t tbSizeMax = m_amc->GetTbSizeFromMcsSymbols (ueInfo.m_dlMcs, 1);
+				ueInfo.m_currTputDl = std::min(ueInfo.m_totBufDl,tbSizeMax) / (m_phyMacConfig->GetSubframePeriod () * 1E-6);
+			}
+		}
+
+		// get UL-CQI and compute UL rate per symbol
+		int mcs = 0;
+		if (ueInfo.m_ulCqiRxed)
+		{
+			// translate vector of doubles to SpectrumValue's
+			SpectrumValue specVals (MmWaveSpectrumValueHelper::GetSpectrumModel (m_phyMacConfig));
+			Values::iterator specIt = specVals.ValuesBegin();
+			for (unsigned ichunk = 0; ichunk < m_phyMacConfig->GetTotalNumChunk (); ichunk++)
+			{
+				NS_ASSERT (specIt != specVals.ValuesEnd());
+				*specIt = ueInfo.m_ulCqi.m_ueUlCqi.at (ichunk); //sinrLin;
+				specIt++;
+			}
+			// for UL CQI, we need to know the TB size previously allocated to accurately compute CQI/MCS
+			cqi = m_amc->CreateCqiFeedbackWbTdma (specVals, ueInfo.m_ulCqi.m_numSym, ueInfo.m_ulCqi.m_tbSize, mcs);
+		}
+		else
+		{
+			NS_LOG_INFO (this << " UE " << ueInfo.m_rnti << " does not have UL-CQI");
+			cqi = 1;
+			mcs = 0;
+		}
+		if (cqi != 0)
+		{
+			ueInfo.m_ulMcs = mcs;
+			for (unsigned iflow = 0; iflow < ueInfo.m_flowStatsUl.size(); iflow++)
+			{
+				ueInfo.m_totBufUl += ueInfo.m_flowStatsUl[iflow].m_totalBufSize;
+			}
+			if (ueInfo.m_totBufUl > 0)
+			{
+				uint32_t tbSizeMax = m_amc->GetTbSizeFromMcsSymbols (ueInfo.m_ulMcs, 1);
+				ueInfo.m_currTputUl = std::min(ueInfo.m_totBufUl,tbSizeMax) / (m_phyMacConfig->GetSubframePeriod () * 1E-6);
+			}
+		}
+
+		ueInfo.m_dlAllocDone = (ueInfo.m_totBufDl == 0);
+		ueInfo.m_ulAllocDone = (ueInfo.m_totBufUl == 0);
+		if (!ueInfo.m_dlAllocDone || !ueInfo.m_ulAllocDone)
+		{
+			m_ueNewDataList.push_back (ueIndex);
+			AddToAllocList (ueIndex);
+		}
+	}
+
+	symAvail = AllocateSymbols (m_ueNewDataList, symAvail);
+
+	// no further allocations
+	if (m_ueAllocList.empty ())
+	{
+		ret.m_sfAllocInfo.m_slotAllocInfo.push_back (ulCtrlSlot);
+		m_macSchedSapUser->SchedConfigInd (ret);
+		return;
+	}
+
+	// create the DCIs of the allocated UEs in RNTI order
+	std::vector<UeSchedInfo*> ueAllocList;
+	ueAllocList.reserve (m_ueAllocList.size ());
+	for (unsigned i = 0; i < m_ueAllocList.size (); i++)
+	{
+		ueAllocList.push_back (&m_ueSchedInfo[m_ueAllocList[i]]);
+	}
+	std::sort (ueAllocList.begin (), ueAllocList.end (), CompareRnti);
+
+	// iterate through the allocated UEs, assign TDMA symbol indices and create DCIs
+	for (unsigned iue = 0; iue < ueAllocList.size (); iue++)
+	{
+		UeSchedInfo& ueInfo = *ueAllocList[iue];
+		if (ueInfo.m_dlSymbols > 0)
+		{
+			DciInfoElementTdma dci;
+			dci.m_rnti = ueInfo.m_rnti;
+			dci.m_format = 0;
+			dci.m_symStart = symIdx;
+			dci.m_numSym = ueInfo.m_dlSymbols;
+			symIdx += ueInfo.m_dlSymbols;
+			NS_ASSERT (symIdx <= m_phyMacConfig->GetSymbolsPerSubframe () - m_phyMacConfig->GetUlCtrlSymbols ());
+			dci.m_mcs = ueInfo.m_dlMcs;
+			dci.m_rv = 0;
+			dci.m_ndi = 1;
+			dci.m_tbSize = m_amc->GetTbSizeFromMcsSymbols (dci.m_mcs, dci.m_numSym) / 8;
+			dci.m_harqProcess = UpdateDlHarqProcessId (ueInfo);
+			NS_ASSERT (dci.m_harqProcess < m_numHarqProcess);
+			SlotAllocInfo slotInfo (slotIdx++, SlotAllocInfo::DL, SlotAllocInfo::CTRL_DATA, SlotAllocInfo::DIGITAL, ueInfo.m_rnti);
+			slotInfo.m_dci = dci;
+			NS_LOG_DEBUG ("UE" << dci.m_rnti << " gets DL symbols " << (unsigned)dci.m_symStart << "-" << (unsigned)(dci.m_symStart+dci.m_numSym-1) <<
+										" tbs " << dci.m_tbSize << " mcs " << (unsigned)dci.m_mcs << " harqId " << (unsigned)dci.m_harqProcess << " rv " << (unsigned)dci.m_rv << " in frame " << ret.m_sfnSf.m_frameNum << " subframe " << (unsigned)ret.m_sfnSf.m_sfNum);
+
+			if (m_harqOn == true)
+			{	// store DCI for HARQ buffer and refresh timer
+				ueInfo.m_dlHarqProcessesDciInfo.at (dci.m_harqProcess) = dci;
+				ueInfo.m_dlHarqProcessesTimer.at (dci.m_harqProcess) = 0;
+			}
+
+			// distribute bytes between active RLC queues
+			unsigned numLc = ueInfo.m_rlcPduInfo.size ();
+			unsigned bytesRem = dci.m_tbSize;
+			unsigned numFulfilled = 0;
+			uint16_t avgPduSize = bytesRem / numLc;
+			// first for loop computes extra to add to average if some flows are less than average
+			for (unsigned i = 0; i < ueInfo.m_rlcPduInfo.size (); i++)
+			{
+				if (ueInfo.m_rlcPduInfo[i].m_size < avgPduSize)
+				{
+					bytesRem -= ueInfo.m_rlcPduInfo[i].m_size;
+					numFulfilled++;
+				}
+			}
+
+			if (numFulfilled < ueInfo.m_rlcPduInfo.size ())
+			{
+				avgPduSize = bytesRem / (ueInfo.m_rlcPduInfo.size () - numFulfilled);
+			}
+
+			for (unsigned i = 0; i < ueInfo.m_rlcPduInfo.size (); i++)
+			{
+				if (ueInfo.m_rlcPduInfo[i].m_size > avgPduSize)
+				{
+					ueInfo.m_rlcPduInfo[i].m_size = avgPduSize;
+				}
+				// else tbSize equals RLC queue size
+				NS_ASSERT(ueInfo.m_rlcPduInfo[i].m_size > 0);
+				slotInfo.m_rlcPduInfo.push_back (ueInfo.m_rlcPduInfo[i]);
+				if (m_harqOn == true)
+				{
+					// store RLC PDU list for HARQ
+					ueInfo.m_dlHarqProcessesRlcPdu.at (dci.m_harqProcess).push_back (ueInfo.m_rlcPduInfo[i]);
+				}
+			}
+
+			for (unsigned i = 0; i < ueInfo.m_rlcPduInfo.size (); i++)
+			{
+				slotInfo.m_rlcPduInfo.push_back (ueInfo.m_rlcPduInfo[i]);
+				if (m_harqOn == true)
+				{
+					// store RLC PDU list for HARQ
+					ueInfo.m_dlHarqProcessesRlcPdu.at (dci.m_harqProcess).push_back (ueInfo.m_rlcPduInfo[i]);
+				}
+			}
+
+			if (m_harqOn == true)
+			{
+				// reorder/reindex slots to maintain DL before UL slot order
+				bool reordered = false;
+				std::deque <SlotAllocInfo>::iterator itSlot = ret.m_sfAllocInfo.m_slotAllocInfo.begin ();
+				for (unsigned islot = 0; islot < ret.m_sfAllocInfo.m_slotAllocInfo.size (); islot++)
+				{
+					if (ret.m_sfAllocInfo.m_slotAllocInfo [islot].m_tddMode == SlotAllocInfo::UL)
+					{
+						slotInfo.m_slotIdx = ret.m_sfAllocInfo.m_slotAllocInfo [islot].m_slotIdx;
+						slotInfo.m_dci.m_symStart = ret.m_sfAllocInfo.m_slotAllocInfo [islot].m_dci.m_symStart;
+						ret.m_sfAllocInfo.m_slotAllocInfo.insert (itSlot, slotInfo);
+						for (unsigned jslot = islot+1; jslot < ret.m_sfAllocInfo.m_slotAllocInfo.size (); jslot++)
+						{
+							ret.m_sfAllocInfo.m_slotAllocInfo[jslot].m_slotIdx++;	// increase indices of UL slots
+							ret.m_sfAllocInfo.m_slotAllocInfo[jslot].m_dci.m_symStart =
+									ret.m_sfAllocInfo.m_slotAllocInfo[jslot-1].m_dci.m_symStart +
+									ret.m_sfAllocInfo.m_slotAllocInfo[jslot-1].m_dci.m_numSym;
+						}
+						reordered = true;
+						break;
+					}
+					itSlot++;
+				}
+				if (!reordered)
+				{
+					ret.m_sfAllocInfo.m_slotAllocInfo.push_back (slotInfo);
+				}
+			}
+			else
+			{
+				ret.m_sfAllocInfo.m_slotAllocInfo.push_back (slotInfo);
+			}
+			ret.m_sfAllocInfo.m_numSymAlloc += dci.m_numSym;
+		}
+	}
+	slotIdx = ret.m_sfAllocInfo.m_slotAllocInfo.back ().m_slotIdx + 1;
+	symIdx = ret.m_sfAllocInfo.m_slotAllocInfo.back ().m_dci.m_symStart + ret.m_sfAllocInfo.m_slotAllocInfo.back ().m_dci.m_numSym;
+
+	for (unsigned iue = 0; iue < ueAllocList.size (); iue++)
+	{
+		UeSchedInfo& ueInfo = *ueAllocList[iue];
+		// Note: UL-DCI applies to subframe i+Tsched
+		if (ueInfo.m_ulSymbols > 0)
+		{
+			DciInfoElementTdma dci;
+			dci.m_rnti = ueInfo.m_rnti;
+			dci.m_format = 1;
+			dci.m_symStart = symIdx;
+			dci.m_numSym = ueInfo.m_ulSymbols;
+			symIdx += ueInfo.m_ulSymbols;
+			NS_ASSERT (symIdx <= m_phyMacConfig->GetSymbolsPerSubframe () - m_phyMacConfig->GetUlCtrlSymbols ());
+			dci.m_mcs = ueInfo.m_ulMcs;
+			dci.m_ndi = 1;
+			dci.m_tbSize = m_amc->GetTbSizeFromMcsSymbols (dci.m_mcs, dci.m_numSym) / 8;
+			dci.m_harqProcess = UpdateUlHarqProcessId (ueInfo);
+			NS_ASSERT (dci.m_harqProcess < m_numHarqProcess);
+			SlotAllocInfo slotInfo (slotIdx++, SlotAllocInfo::UL, SlotAllocInfo::CTRL_DATA, SlotAllocInfo::DIGITAL, ueInfo.m_rnti);
+			slotInfo.m_dci = dci;
+			NS_LOG_DEBUG ("UE" << dci.m_rnti << " gets UL symbols " << (unsigned)dci.m_symStart << "-" << (unsigned)(dci.m_symStart+dci.m_numSym-1) <<
+										" tbs " << dci.m_tbSize << " mcs " << (unsigned)dci.m_mcs << " harqId " << (unsigned)dci.m_harqProcess << " rv " << (unsigned)dci.m_rv << " in frame " << ret.m_sfnSf.m_frameNum << " subframe " << (unsigned)ret.m_sfnSf.m_sfNum);
+			ret.m_sfAllocInfo.m_slotAllocInfo.push_back (slotInfo);
+			ret.m_sfAllocInfo.m_numSymAlloc += dci.m_numSym;
+			std::vector<uint16_t> ueChunkMap (m_phyMacConfig->GetTotalNumChunk (), dci.m_rnti);
+			SfnSf slotSfn = ret.m_sfAllocInfo.m_sfnSf;
+			slotSfn.m_slotNum = dci.m_symStart;  // use the start symbol index of the slot because the absolute UL slot index depends on the future DL allocation
+			// insert into allocation map to recall previous allocations upon receiving UL-CQI
+			m_ulAllocationMap.insert ( std::pair<uint32_t, struct AllocMapElem> (slotSfn.Encode (), AllocMapElem(ueChunkMap, dci.m_numSym, dci.m_tbSize)) );
+
+			if (m_harqOn == true)
+			{
+				// store DCI for HARQ buffer and refresh timer
+				NS_ASSERT (ueInfo.m_ulHarqProcessesStatus[dci.m_harqProcess] > 0);
+				ueInfo.m_ulHarqProcessesDciInfo.at (dci.m_harqProcess) = dci;
+				ueInfo.m_ulHarqProcessesTimer.at (dci.m_harqProcess) = 0;
+			}
+		}
+	}
+
+	ResetAllocList ();
+
+	ret.m_sfAllocInfo.m_slotAllocInfo.push_back (ulCtrlSlot);
+	m_macSchedSapUser->SchedConfigInd (ret);
+	return;
+}
+
+void
+MmWaveFlexTtiPolicyMacScheduler::RefreshDlCqiMaps (void)
+{
+  NS_LOG_FUNCTION (this);
+  // refresh DL CQI P01 Map
+  for (unsigned i = 0; i < m_ueSchedInfo.size (); i++)
+    {
+      UeSchedInfo& ueInfo = m_ueSchedInfo[i];
+      if (!ueInfo.m_wbCqiRxed)
+        {
+          continue;
+        }
+      NS_LOG_INFO (this << " P10-CQI for user " << ueInfo.m_rnti << " is " << (uint32_t)ueInfo.m_wbCqiTimer << " thr " << (uint32_t)m_cqiTimersThreshold);
+      if (ueInfo.m_wbCqiTimer == 0)
+        {
+          NS_LOG_INFO (this << " P10-CQI exired for user " << ueInfo.m_rnti);
+          ueInfo.m_wbCqiRxed = false;
+        }
+      else
+        {
+          ueInfo.m_wbCqiTimer--;
+        }
+    }
+
+  return;
+}
+
+
+void
+MmWaveFlexTtiPolicyMacScheduler::RefreshUlCqiMaps (void)
+{
+  // refresh UL CQI  Map
+  for (unsigned i = 0; i < m_ueSchedInfo.size (); i++)
+    {
+      UeSchedInfo& ueInfo = m_ueSchedInfo[i];
+      if (!ueInfo.m_ulCqiRxed)
+        {
+          continue;
+        }
+      NS_LOG_INFO (this << " UL-CQI for user " << ueInfo.m_rnti << " is " << (uint32_t)ueInfo.m_ulCqiTimer << " thr " << (uint32_t)m_cqiTimersThreshold);
+      if (ueInfo.m_ulCqiTimer == 0)
+        {
+          NS_LOG_INFO (this << " UL-CQI expired for user " << ueInfo.m_rnti);
+          ueInfo.m_ulCqiRxed = false;
+          ueInfo.m_ulCqi.m_ueUlCqi.clear ();
+        }
+      else
+        {
+          ueInfo.m_ulCqiTimer--;
+        }
+    }
+
+  return;
+}
+
+void
+MmWaveFlexTtiPolicyMacScheduler::DoCschedCellConfigReq (const struct MmWaveMacCschedSapProvider::CschedCellConfigReqParameters& params)
+{
+  NS_LOG_FUNCTION (this);
+  // Read the subset of parameters used
+  m_cschedCellConfig = params;
+  MmWaveMacCschedSapUser::CschedUeConfigCnfParameters cnf;
+  cnf.m_result = SUCCESS;
+  m_macCschedSapUser->CschedUeConfigCnf (cnf);
+  return;
+}
+
+void
+MmWaveFlexTtiPolicyMacScheduler::DoCschedUeConfigReq (const struct MmWaveMacCschedSapProvider::CschedUeConfigReqParameters& params)
+{
+  NS_LOG_FUNCTION (this << " RNTI " << params.m_rnti << " txMode " << (uint16_t)params.m_transmissionMode);
+
+  if (m_ueIndexMap.find (params.m_rnti) != m_ueIndexMap.end ())
+  {
+  	return;
+  }
+
+  // reuse the entry of a released UE, if any
+  uint32_t ueIndex;
+  if (m_freeUeIndices.empty ())
+  {
+  	ueIndex = m_ueSchedInfo.size ();
+  	m_ueSchedInfo.push_back (UeSchedInfo ());
+  }
+  else
+  {
+  	ueIndex = m_freeUeIndices.back ();
+  	m_freeUeIndices.pop_back ();
+  	m_ueSchedInfo[ueIndex] = UeSchedInfo ();
+  }
+  m_ueIndexMap.insert (std::pair <uint16_t, uint32_t> (params.m_rnti, ueIndex));
+
+  UeSchedInfo& ueInfo = m_ueSchedInfo[ueIndex];
+  ueInfo.m_rnti = params.m_rnti;
+  for (unsigned i = 0; i <= 3; i++)
+  {
+  	ueInfo.m_flowStatsDl.push_back (FlowStats (false, i));
+  	ueInfo.m_flowStatsUl.push_back (FlowStats (true, i));
+  }
+
+  ueInfo.m_dlHarqProcessesStatus.resize (m_numHarqProcess, 0);
+  ueInfo.m_dlHarqProcessesTimer.resize (m_numHarqProcess, 0);
+  ueInfo.m_dlHarqProcessesDciInfo.resize (m_numHarqProcess);
+  ueInfo.m_dlHarqProcessesRlcPdu.resize (m_numHarqProcess);
+  ueInfo.m_ulHarqProcessesStatus.resize (m_numHarqProcess, 0);
+  ueInfo.m_ulHarqProcessesTimer.resize (m_numHarqProcess, 0);
+  ueInfo.m_ulHarqProcessesDciInfo.resize (m_numHarqProcess);
+}
+
+void
+MmWaveFlexTtiPolicyMacScheduler::DoCschedLcConfigReq (const struct MmWaveMacCschedSapProvider::CschedLcConfigReqParameters& params)
+{
+	NS_LOG_FUNCTION (this);
+  uint32_t ueIndex = GetUeIndex (params.m_rnti);
+  if (ueIndex == m_ueSchedInfo.size ())
+  {
+  	NS_LOG_ERROR ("Cannot find UE info entry");
+  	return;
+  }
+  UeSchedInfo& ueInfo = m_ueSchedInfo[ueIndex];
+  for (uint16_t i = 0; i < params.m_logicalChannelConfigList.size (); i++)
+  {
+  	const LogicalChannelConfigListElement_s& lcConfig = params.m_logicalChannelConfigList[i];
+  	if (lcConfig.m_direction == LogicalChannelConfigListElement_s::DIR_DL)
+  	{
+  		uint8_t lcid = lcConfig.m_logicalChannelIdentity;
+  		for (unsigned j = ueInfo.m_flowStatsDl.size (); j <= lcid; j++)
+  		{
+  			ueInfo.m_flowStatsDl.push_back (FlowStats (false, j));
+  		}
+  		ueInfo.m_flowStatsDl[lcid].m_qci = lcConfig.m_qci;
+  		if (lcConfig.m_qci == EpsBearer::GBR_ULTRA_LOW_LAT)
+  		{
+  			EpsBearer lowLatBearer (EpsBearer::GBR_ULTRA_LOW_LAT);
+  			ueInfo.m_flowStatsDl[lcid].m_deadlineUs = lowLatBearer.GetPacketDelayBudgetMs () * 1000;
+  		}
+  	}
+  	else if (lcConfig.m_direction == LogicalChannelConfigListElement_s::DIR_UL)
+  	{
+  		uint8_t lcid = lcConfig.m_logicalChannelGroup; // use LCG ID instead of LCID
+  		for (unsigned j = ueInfo.m_flowStatsUl.size (); j <= lcid; j++)
+  		{
+  			ueInfo.m_flowStatsUl.push_back (FlowStats (true, j));
+  		}
+  		ueInfo.m_flowStatsUl[lcid].m_qci = lcConfig.m_qci;
+  		if (lcConfig.m_qci == EpsBearer::GBR_ULTRA_LOW_LAT)
+  		{
+  			EpsBearer lowLatBearer (EpsBearer::GBR_ULTRA_LOW_LAT);
+  			ueInfo.m_flowStatsUl[lcid].m_deadlineUs = lowLatBearer.GetPacketDelayBudgetMs () * 1000;
+  		}
+  	}
+  	else if (lcConfig.m_direction == LogicalChannelConfigListElement_s::DIR_BOTH)
+  	{
+  		uint8_t lcid = lcConfig.m_logicalChannelIdentity;
+  		for (unsigned j = ueInfo.m_flowStatsDl.size (); j <= lcid; j++)
+  		{
+  			ueInfo.m_flowStatsDl.push_back (FlowStats (false, j));
+  			ueInfo.m_flowStatsUl.push_back (FlowStats (true, j));
+  		}
+  		ueInfo.m_flowStatsDl[lcid].m_qci = lcConfig.m_qci;
+  		ueInfo.m_flowStatsUl[lcid].m_qci = lcConfig.m_qci;
+
+  		EpsBearer lowLatBearer (EpsBearer::GBR_ULTRA_LOW_LAT);
+  		ueInfo.m_flowStatsDl[lcid].m_deadlineUs = lowLatBearer.GetPacketDelayBudgetMs () * 1000;
+  		ueInfo.m_flowStatsUl[lcid].m_deadlineUs = lowLatBearer.GetPacketDelayBudgetMs () * 1000;
+  	}
+  }
+  return;
+}
+
+void
+MmWaveFlexTtiPolicyMacScheduler::DoCschedLcReleaseReq (const struct MmWaveMacCschedSapProvider::CschedLcReleaseReqParameters& params)
+{
+  NS_LOG_FUNCTION (this);
+  uint32_t ueIndex = GetUeIndex (params.m_rnti);
+  if (ueIndex == m_ueSchedInfo.size ())
+  {
+  	return;
+  }
+  // stop scheduling the released LCs
+  UeSchedInfo& ueInfo = m_ueSchedInfo[ueIndex];
+  for (uint16_t i = 0; i < params.m_logicalChannelIdentity.size (); i++)
+  {
+  	uint8_t lcid = params.m_logicalChannelIdentity.at (i);
+  	if (lcid < ueInfo.m_flowStatsDl.size ())
+  	{
+  		ueInfo.m_flowStatsDl[lcid].m_totalBufSize = 0;
+  	}
+  }
+  return;
+}
+
+void
+MmWaveFlexTtiPolicyMacScheduler::DoCschedUeReleaseReq (const struct MmWaveMacCschedSapProvider::CschedUeReleaseReqParameters& params)
+{
+  NS_LOG_FUNCTION (this << " Release RNTI " << params.m_rnti);
+
+  std::map <uint16_t, uint32_t>::iterator it = m_ueIndexMap.find (params.m_rnti);
+  if (it == m_ueIndexMap.end ())
+  {
+  	return;
+  }
+  // the entry is reused by the next UE that is configured
+  m_ueSchedInfo[it->second] = UeSchedInfo ();
+  m_freeUeIndices.push_back (it->second);
+  m_ueIndexMap.erase (it);
+
+  return;
+}
+
+
+}
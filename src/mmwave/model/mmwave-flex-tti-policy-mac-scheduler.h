@@ -0,0 +1,443 @@
+ /* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+ /*
+ *   Copyright (c) 2015, NYU WIRELESS, Tandon School of Engineering, New York University
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef SRC_MMWAVE_MODEL_MMWAVE_FLEX_TTI_POLICY_MAC_SCHEDULER_H_
+#define SRC_MMWAVE_MODEL_MMWAVE_FLEX_TTI_POLICY_MAC_SCHEDULER_H_
+
+
+#include "mmwave-mac-sched-sap.h"
+#include "mmwave-mac-csched-sap.h"
+#include "mmwave-mac-scheduler.h"
+#include "mmwave-amc.h"
+#include <vector>
+#include <list>
+#include <map>
+#include <algorithm>
+
+namespace ns3 {
+
+/*
+ * Scheduling engine shared by the flexible-TTI schedulers that grant the data
+ * symbols of a subframe one at a time to the UE with the best metric
+ * (MmWaveFlexTtiPfMacScheduler, MmWaveFlexTtiMaxRateMacScheduler).
+ *
+ * The engine implements the SAPs, CQI/BSR bookkeeping, HARQ and DCI creation.
+ * The state of each UE lives in a flat array indexed by a dense UE index that
+ * is assigned at UE configuration time; the RNTI is only looked up when a
+ * message refers to a UE. A subclass only chooses the policy that ranks the
+ * UEs, by implementing AllocateSymbols with AllocateSymbolsWithPolicy, e.g.:
+ *
+ *   struct MyPolicy
+ *   {
+ *     double GetMetric (const MmWaveFlexTtiPolicyMacScheduler::UeSchedInfo& ue) const;
+ *   };
+ *
+ * The UE with the highest metric gets the next symbol, ties go to the UE with
+ * fewer symbols in the current subframe and then to the lowest RNTI.
+ */
+class MmWaveFlexTtiPolicyMacScheduler : public MmWaveMacScheduler
+{
+public:
+	typedef std::vector < uint8_t > DlHarqProcessesStatus_t;
+	typedef std::vector < uint8_t > DlHarqProcessesTimer_t;
+	typedef std::vector < DciInfoElementTdma > DlHarqProcessesDciInfoList_t;
+	typedef std::vector < std::vector <struct RlcPduInfo> > DlHarqRlcPduList_t; // vector of the LCs per per UE HARQ process
+
+	typedef std::vector < uint8_t > UlHarqProcessesTimer_t;
+	typedef std::vector < DciInfoElementTdma > UlHarqProcessesDciInfoList_t;
+	typedef std::vector < uint8_t > UlHarqProcessesStatus_t;
+
+	struct FlowStats
+	{
+		FlowStats (bool uplink, uint8_t lcid) :
+			m_isUplink (uplink),
+			m_lcid (lcid), m_arrivalRate (0.0), m_grantedRate(0.0),
+			m_qci (0), m_txQueueHolDelay (0), m_reTxQueueHolDelay (0), m_probErr (0.0),
+			m_deadlineUs (0), m_totalBufSize (0), m_totalSchedSize(0)
+		{
+		}
+
+		bool			m_isUplink;					// is uplink?
+		uint8_t		m_lcid;						// LCID (for DL) or LC Group ID (for UL)
+		double 		m_arrivalRate;		// Mbps
+		double 		m_grantedRate;		// Mbps
+		uint8_t		m_qci;						// We interpret QCI 69 as delay critical
+		double	m_txQueueHolDelay;
+		uint32_t	m_reTxQueueHolDelay;
+		double		m_probErr;				// expected probability of each HARQ TX/reTX failure (i.e. 1/E[num TX to success])
+		double	m_deadlineUs;			// relative deadline
+		std::list<uint32_t> m_txPacketSizes;		// estimated packet sizes from consecutive BSRs
+		uint32_t	m_totalBufSize;
+		std::list<uint32_t> m_retxPacketSizes;
+		std::list<double> m_txPacketDelays;		// estimated delays for each packet
+		std::list<double> m_retxPacketDelays;
+
+		// We maintain a queue of PDU sizes scheduled in the last M subframes.
+		// M = delay between scheduling and transmission (default DL = 1, UL = 2)
+		// The sum of these M elements is subtracted from the BSR to account for
+		// data that has been scheduled but not yet extracted from the DL or UL queue.
+		std::list<uint32_t> m_schedPacketSizes;
+		uint32_t 	m_totalSchedSize;		// total of last M elements in list
+	};
+
+	/*
+	 * Map of UEs' UL-CQI per RBG
+	 */
+	struct UlCqiMapElem
+	{
+		UlCqiMapElem () :
+			m_numSym (0), m_tbSize (0)
+		{
+		}
+		UlCqiMapElem (std::vector<double> ulCqi, uint8_t nSym, uint32_t tbs) :
+			m_ueUlCqi (ulCqi), m_numSym (nSym), m_tbSize (tbs)
+		{
+		}
+		std::vector <double> m_ueUlCqi;
+		uint8_t 	m_numSym;
+		uint32_t	m_tbSize;
+	};
+
+	/*
+	 * Everything the scheduler knows about one UE: link quality, buffers,
+	 * HARQ processes and the allocation of the subframe being scheduled
+	 */
+	struct UeSchedInfo
+	{
+		UeSchedInfo () :
+			m_rnti (0), m_dlMcs (0), m_ulMcs (0), m_maxDlBufSize (0),
+			m_maxUlBufSize (0), m_maxDlSymbols (0), m_maxUlSymbols (0),
+			m_dlSymbols (0), m_ulSymbols (0),
+			m_dlSymbolsRetx (0), m_ulSymbolsRetx (0),
+			m_dlTbSize (0), m_ulTbSize (0),
+			m_dlAllocDone (false), m_ulAllocDone (false),
+			m_avgTputDl (0.0), m_avgTputUl (0.0),
+			m_lastAvgTputDl (0.0), m_lastAvgTputUl (0.0),
+			m_currTputDl (0.0), m_currTputUl (0.0),
+			m_totBufDl (0), m_totBufUl (0),
+			m_allocUlLast (false), m_allocated (false),
+			m_wbCqiRxed (false), m_wbCqi (0), m_wbCqiTimer (0),
+			m_ulCqiRxed (false), m_ulCqiTimer (0)
+		{
+		}
+
+		uint16_t	m_rnti;		// 0 if the entry is free
+		uint8_t		m_dlMcs;
+		uint8_t		m_ulMcs;
+		uint32_t	m_maxDlBufSize;
+		uint32_t	m_maxUlBufSize;
+		uint8_t		m_maxDlSymbols;
+		uint8_t		m_maxUlSymbols;
+		uint8_t		m_dlSymbols;
+		uint8_t		m_ulSymbols;
+		uint8_t		m_dlSymbolsRetx;
+		uint8_t		m_ulSymbolsRetx;
+		uint32_t	m_dlTbSize;
+		uint32_t	m_ulTbSize;
+		std::vector <struct RlcPduInfo> m_rlcPduInfo;
+		bool			m_dlAllocDone;
+		bool			m_ulAllocDone;
+		std::vector<FlowStats> m_flowStatsDl;		// for each LC
+		std::vector<FlowStats> m_flowStatsUl;
+		double 		m_avgTputDl;
+		double 		m_avgTputUl;
+		double 		m_lastAvgTputDl;
+		double 		m_lastAvgTputUl;
+		double 		m_currTputDl;
+		double 		m_currTputUl;
+		uint32_t	m_totBufDl;
+		uint32_t	m_totBufUl;
+		bool 			m_allocUlLast;
+		bool			m_allocated;		// in the list of UEs allocated in the current subframe
+
+		// DL wideband CQI and number of TTIs for which it is still valid
+		bool			m_wbCqiRxed;
+		uint8_t		m_wbCqi;
+		uint32_t	m_wbCqiTimer;
+		// UL CQI and number of TTIs for which it is still valid
+		bool			m_ulCqiRxed;
+		UlCqiMapElem m_ulCqi;
+		uint32_t	m_ulCqiTimer;
+
+		//HARQ status
+		// 0: process Id available
+		// x>0: process Id equal to `x` trasmission count
+		DlHarqProcessesStatus_t m_dlHarqProcessesStatus;
+		DlHarqProcessesTimer_t m_dlHarqProcessesTimer;
+		DlHarqProcessesDciInfoList_t m_dlHarqProcessesDciInfo;
+		DlHarqRlcPduList_t m_dlHarqProcessesRlcPdu;
+		UlHarqProcessesStatus_t m_ulHarqProcessesStatus;
+		UlHarqProcessesTimer_t m_ulHarqProcessesTimer;
+		UlHarqProcessesDciInfoList_t m_ulHarqProcessesDciInfo;
+	};
+
+	MmWaveFlexTtiPolicyMacScheduler ();
+
+	virtual ~MmWaveFlexTtiPolicyMacScheduler ();
+	virtual void DoDispose (void);
+	static TypeId GetTypeId (void);
+
+	virtual void SetMacSchedSapUser (MmWaveMacSchedSapUser* sap);
+	virtual void SetMacCschedSapUser (MmWaveMacCschedSapUser* s);
+
+	virtual MmWaveMacSchedSapProvider* GetMacSchedSapProvider ();
+	virtual MmWaveMacCschedSapProvider* GetMacCschedSapProvider ();
+
+	virtual void ConfigureCommonParameters (Ptr<MmWavePhyMacCommon> config);
+
+	void RefreshDlCqiMaps (void);
+	void RefreshUlCqiMaps (void);
+
+	friend class MmWaveFlexTtiPolicyMacSchedSapProvider;
+	friend class MmWaveFlexTtiPolicyMacCschedSapProvider;
+
+protected:
+	/*
+	 * Distribute the data symbols left after the HARQ retransmissions among
+	 * the UEs with new data.
+	 * @params ueIndices the indices in m_ueSchedInfo of the UEs with new data
+	 * @params symAvail the number of symbols available
+	 * @return the number of symbols left
+	 */
+	virtual int AllocateSymbols (const std::vector<uint32_t>& ueIndices, int symAvail) = 0;
+
+	/*
+	 * Register the attributes of the engine on the TypeId of a scheduler
+	 * @params tid the TypeId of the scheduler
+	 * @return tid
+	 */
+	static TypeId AddSchedulerAttributes (TypeId tid);
+
+	/*
+	 * Implementation of AllocateSymbols for a given ranking policy: the
+	 * candidates are kept in a binary heap, so that granting S symbols
+	 * among U UEs takes O((U + S) log U)
+	 */
+	template <class Policy>
+	int AllocateSymbolsWithPolicy (const Policy& policy, const std::vector<uint32_t>& ueIndices, int symAvail);
+
+	/*
+	 * Give one more symbol to a UE, alternating between its UL and DL data,
+	 * and update its current and average throughput
+	 */
+	void GrantSymbol (UeSchedInfo& ueInfo);
+
+	std::vector<UeSchedInfo> m_ueSchedInfo;		// indexed by UE index
+
+	Ptr<MmWaveAmc> m_amc;
+
+	double m_timeWindow;
+
+private:
+	struct HeapEntry
+	{
+		HeapEntry (double metric, const UeSchedInfo& ueInfo, uint32_t ueIndex) :
+			m_metric (metric), m_numSym (ueInfo.m_dlSymbols + ueInfo.m_ulSymbols),
+			m_rnti (ueInfo.m_rnti), m_ueIndex (ueIndex)
+		{
+		}
+
+		// the top of the heap is the UE to be served first
+		bool operator< (const HeapEntry& other) const
+		{
+			if (m_metric != other.m_metric)
+			{
+				return m_metric < other.m_metric;
+			}
+			if (m_numSym != other.m_numSym)
+			{
+				return m_numSym > other.m_numSym;
+			}
+			return m_rnti > other.m_rnti;
+		}
+
+		double		m_metric;
+		uint32_t	m_numSym;
+		uint16_t	m_rnti;
+		uint32_t	m_ueIndex;
+	};
+
+	/*
+	 * @return the index in m_ueSchedInfo of a UE, or m_ueSchedInfo.size () if unknown
+	 */
+	uint32_t GetUeIndex (uint16_t rnti) const;
+
+	void AddToAllocList (uint32_t ueIndex);
+	void ResetAllocList (void);
+
+	unsigned CalcMinTbSizeNumSym (unsigned mcs, unsigned bufSize, unsigned &tbSize);
+
+	uint32_t
+	BsrId2BufferSize (uint8_t val)
+	{
+	  NS_ABORT_MSG_UNLESS (val < 64, "val = " << val << " is out of range");
+	  return BufferSizeLevelBsrTable[val];
+	}
+
+	uint8_t UpdateDlHarqProcessId (UeSchedInfo& ueInfo);
+	uint8_t UpdateUlHarqProcessId (UeSchedInfo& ueInfo);
+
+	//
+	// Implementation of the CSCHED API primitives
+	// (See 4.1 for description of the primitives)
+	//
+
+	void DoCschedCellConfigReq (const struct MmWaveMacCschedSapProvider::CschedCellConfigReqParameters& params);
+
+	void DoCschedUeConfigReq (const struct MmWaveMacCschedSapProvider::CschedUeConfigReqParameters& params);
+
+	void DoCschedLcConfigReq (const struct MmWaveMacCschedSapProvider::CschedLcConfigReqParameters& params);
+
+	void DoCschedLcReleaseReq (const struct MmWaveMacCschedSapProvider::CschedLcReleaseReqParameters& params);
+
+	void DoCschedUeReleaseReq (const struct MmWaveMacCschedSapProvider::CschedUeReleaseReqParameters& params);
+
+	//
+	// Implementation of the SCHED API primitives
+	// (See 4.2 for description of the primitives)
+	//
+
+	void DoSchedDlRlcBufferReq (const struct MmWaveMacSchedSapProvider::SchedDlRlcBufferReqParameters& params);
+
+	void DoSchedDlCqiInfoReq (const MmWaveMacSchedSapProvider::SchedDlCqiInfoReqParameters& params);
+
+	void DoSchedUlCqiInfoReq (const struct MmWaveMacSchedSapProvider::SchedUlCqiInfoReqParameters& params);
+
+	void DoSchedUlMacCtrlInfoReq (const struct MmWaveMacSchedSapProvider::SchedUlMacCtrlInfoReqParameters& params);
+
+	void DoSchedTriggerReq (const struct MmWaveMacSchedSapProvider::SchedTriggerReqParameters& params);
+
+	void DoSchedSetMcs (int mcs);
+  /**
+   * \brief Refresh HARQ processes according to the timers
+   *
+   */
+	void RefreshHarqProcesses ();
+
+	/*
+	 * Index in m_ueSchedInfo of each configured UE
+	 */
+	std::map <uint16_t, uint32_t> m_ueIndexMap;
+	/*
+	 * Indices of the released entries of m_ueSchedInfo
+	 */
+	std::vector <uint32_t> m_freeUeIndices;
+	/*
+	 * Indices of the UEs allocated in the current subframe
+	 */
+	std::vector <uint32_t> m_ueAllocList;
+	/*
+	 * Indices of the UEs with new data in the current subframe
+	 */
+	std::vector <uint32_t> m_ueNewDataList;
+
+	uint32_t m_cqiTimersThreshold; // # of TTIs for which a CQI can be considered valid
+
+	uint8_t m_tbUid;
+	uint32_t m_numDataSymbols;
+
+	MmWaveMacSchedSapProvider* m_macSchedSapProvider;
+	MmWaveMacSchedSapUser* m_macSchedSapUser;
+	MmWaveMacCschedSapUser* m_macCschedSapUser;
+	MmWaveMacCschedSapProvider* m_macCschedSapProvider;
+
+	MmWaveMacCschedSapProvider::CschedCellConfigReqParameters m_cschedCellConfig;
+
+	struct AllocMapElem
+	{
+		AllocMapElem (std::vector<uint16_t> rntiMap, uint8_t nSym, uint32_t tbs) :
+			m_rntiPerChunk (rntiMap), m_numSym (nSym), m_tbSize (tbs)
+		{
+		}
+
+		std::vector <uint16_t> m_rntiPerChunk;
+		uint8_t m_numSym;
+		uint32_t m_tbSize;
+	};
+	/*
+	 * Map of previous allocated UE per RBG
+	 * (used to retrieve info from UL-CQI)
+	 */
+	std::map <uint32_t, struct AllocMapElem> m_ulAllocationMap;
+
+	// HARQ attributes
+	/**
+	 * m_harqOn when false inhibit te HARQ mechanisms (by default active)
+	 */
+	bool m_harqOn;
+	uint8_t m_numHarqProcess;
+	uint8_t m_harqTimeout;
+
+	std::vector <DlHarqInfo> m_dlHarqInfoList; // HARQ retx buffered
+	std::vector <UlHarqInfo> m_ulHarqInfoList; // HARQ retx buffered
+
+	static const unsigned m_macHdrSize;
+	static const unsigned m_subHdrSize;
+	static const unsigned m_rlcHdrSize;
+
+	//for testing
+	bool 		m_fixedMcsDl;
+	bool 		m_fixedMcsUl;
+	uint8_t m_mcsDefaultDl;
+	uint8_t m_mcsDefaultUl;
+	bool m_dlOnly;
+	bool m_ulOnly;
+
+	bool m_fixedTti;		// one slot per TTI
+	uint8_t	m_symPerSlot; // symbols per slot
+};
+
+template <class Policy>
+int
+MmWaveFlexTtiPolicyMacScheduler::AllocateSymbolsWithPolicy (const Policy& policy, const std::vector<uint32_t>& ueIndices, int symAvail)
+{
+	std::vector<HeapEntry> heap;
+	heap.reserve (ueIndices.size ());
+	for (unsigned i = 0; i < ueIndices.size (); i++)
+	{
+		const UeSchedInfo& ueInfo = m_ueSchedInfo[ueIndices[i]];
+		if (!ueInfo.m_dlAllocDone || !ueInfo.m_ulAllocDone)
+		{
+			heap.push_back (HeapEntry (policy.GetMetric (ueInfo), ueInfo, ueIndices[i]));
+		}
+	}
+	std::make_heap (heap.begin (), heap.end ());
+
+	// give each symbol to the UE with the best metric, then update its metric
+	while (symAvail > 0 && !heap.empty ())
+	{
+		std::pop_heap (heap.begin (), heap.end ());
+		uint32_t ueIndex = heap.back ().m_ueIndex;
+		heap.pop_back ();
+		UeSchedInfo& ueInfo = m_ueSchedInfo[ueIndex];
+		GrantSymbol (ueInfo);
+		symAvail--;
+		if (!ueInfo.m_dlAllocDone || !ueInfo.m_ulAllocDone)
+		{
+			heap.push_back (HeapEntry (policy.GetMetric (ueInfo), ueInfo, ueIndex));
+			std::push_heap (heap.begin (), heap.end ());
+		}
+	}
+	return symAvail;
+}
+
+}
+
+
+#endif /* SRC_MMWAVE_MODEL_MMWAVE_FLEX_TTI_POLICY_MAC_SCHEDULER_H_ */
@@ -30,6 +30,7 @@
 #include "mmwave-interference.h"
 #include <ns3/simulator.h>
 #include <ns3/log.h>
+#include <ns3/boolean.h>
 #include "mmwave-chunk-processor.h"
 #include <stdio.h>
 
@@ -39,11 +40,13 @@ NS_LOG_COMPONENT_DEFINE ("mmWaveInterference");
 
 namespace ns3 {
 
+NS_OBJECT_ENSURE_REGISTERED (mmWaveInterference);
 
 mmWaveInterference::mmWaveInterference ()
  	 : m_receiving (false),
 	   m_lastSignalId (0),
-	   m_lastSignalIdBeforeReset (0)
+	   m_lastSignalIdBeforeReset (0),
+	   m_slotAccumulator (true)
 {
 	NS_LOG_FUNCTION (this);
 }
@@ -62,6 +65,9 @@ mmWaveInterference::DoDispose ()
 	m_rxSignal = 0;
 	m_allSignals = 0;
 	m_noise = 0;
+	ClearBuckets ();
+	m_freeSums.clear ();
+	m_sinr = 0;
 	Object::DoDispose ();
 } 
 
@@ -71,6 +77,13 @@ mmWaveInterference::GetTypeId (void)
 {
 	static TypeId tid = TypeId ("ns3::mmWaveInterference")
 			.SetParent<Object> ()
+			.AddAttribute ("SlotAccumulator",
+						   "If true, the signals that end at the same time are summed "
+						   "and subtracted from the interference by a single event; "
+						   "if false, each signal is subtracted by its own event",
+						   BooleanValue (true),
+						   MakeBooleanAccessor (&mmWaveInterference::m_slotAccumulator),
+						   MakeBooleanChecker ())
 	;
 	return tid;
 }
@@ -136,6 +149,30 @@ mmWaveInterference::AddSignal (Ptr<const SpectrumValue> spd, const Time duration
 {
 	NS_LOG_FUNCTION (this << *spd << duration);
 	DoAddSignal (spd);
+	if (m_slotAccumulator)
+	{
+		Time expiry = Now () + duration;
+		std::map<Time, ExpiryBucket>::iterator it = m_expiryBuckets.find (expiry);
+		if (it != m_expiryBuckets.end ())
+		{
+			(*it->second.m_sum) += (*spd);
+			return;
+		}
+		ExpiryBucket bucket;
+		if (m_freeSums.empty ())
+		{
+			bucket.m_sum = spd->Copy ();
+		}
+		else
+		{
+			bucket.m_sum = m_freeSums.back ();
+			m_freeSums.pop_back ();
+			(*bucket.m_sum) = (*spd);
+		}
+		bucket.m_event = Simulator::Schedule (duration, &mmWaveInterference::DoSubtractBucket, this, expiry);
+		m_expiryBuckets.insert (std::make_pair (expiry, bucket));
+		return;
+	}
 	uint32_t signalId = ++m_lastSignalId;
 	if (signalId == m_lastSignalIdBeforeReset)
     {
@@ -174,6 +211,30 @@ mmWaveInterference::DoSubtractSignal  (Ptr<const SpectrumValue> spd, uint32_t si
     }
 }
 
+void
+mmWaveInterference::DoSubtractBucket (Time expiry)
+{
+	NS_LOG_FUNCTION (this << expiry);
+	ConditionallyEvaluateChunk ();
+	std::map<Time, ExpiryBucket>::iterator it = m_expiryBuckets.find (expiry);
+	NS_ASSERT (it != m_expiryBuckets.end ());
+	(*m_allSignals) -= (*it->second.m_sum);
+	m_freeSums.push_back (it->second.m_sum);
+	m_expiryBuckets.erase (it);
+}
+
+void
+mmWaveInterference::ClearBuckets ()
+{
+	NS_LOG_FUNCTION (this);
+	for (std::map<Time, ExpiryBucket>::iterator it = m_expiryBuckets.begin (); it != m_expiryBuckets.end (); ++it)
+	{
+		it->second.m_event.Cancel ();
+		m_freeSums.push_back (it->second.m_sum);
+	}
+	m_expiryBuckets.clear ();
+}
+
 
 void
 mmWaveInterference::ConditionallyEvaluateChunk ()
@@ -187,8 +248,8 @@ mmWaveInterference::ConditionallyEvaluateChunk ()
 	if (m_receiving && (Now () > m_lastChangeTime))
     {
 		NS_LOG_LOGIC (this << " signal = " << *m_rxSignal << " allSignals = " << *m_allSignals << " noise = " << *m_noise);
-		SpectrumValue interf =  (*m_allSignals) - (*m_rxSignal) + (*m_noise);
-		SpectrumValue sinr = (*m_rxSignal) / interf;
+		// sinr = rxSignal / (allSignals - rxSignal + noise), evaluated in place
+		const SpectrumValue& sinr = m_sinr->SetSinr (*m_rxSignal, *m_allSignals, *m_noise);
 		Time duration = Now () - m_lastChangeTime;
 		for (std::list<Ptr<mmWaveChunkProcessor> >::const_iterator it = m_PowerChunkProcessorList.begin (); it != m_PowerChunkProcessorList.end (); ++it)
 		{
@@ -209,6 +270,10 @@ mmWaveInterference::SetNoisePowerSpectralDensity (Ptr<const SpectrumValue> noise
 	ConditionallyEvaluateChunk ();
 	m_noise = noisePsd;
 	m_allSignals = Create<SpectrumValue> (noisePsd->GetSpectrumModel ());
+	m_sinr = Create<SpectrumValue> (noisePsd->GetSpectrumModel ());
+	// the pending signals are dropped with m_allSignals
+	ClearBuckets ();
+	m_freeSums.clear ();
 	if (m_receiving == true)
     {
 		// abort rx
@@ -33,8 +33,11 @@
 #include <ns3/object.h>
 #include <ns3/packet.h>
 #include <ns3/nstime.h>
+#include <ns3/event-id.h>
 #include <ns3/spectrum-value.h>
 #include <string.h>
+#include <map>
+#include <vector>
 #include <ns3/mmwave-chunk-processor.h>
 
 
@@ -58,6 +61,15 @@ private:
 	void ConditionallyEvaluateChunk ();
 	void DoAddSignal (Ptr<const SpectrumValue> spd);
 	void DoSubtractSignal  (Ptr<const SpectrumValue> spd, uint32_t signalId);
+	/*
+	 * Subtract the sum of the signals that end now, in accumulator mode
+	 * @params expiry the end time of the signals, i.e., now
+	 */
+	void DoSubtractBucket (Time expiry);
+	/*
+	 * Cancel the subtraction of all pending signals, in accumulator mode
+	 */
+	void ClearBuckets ();
 	std::list<Ptr<mmWaveChunkProcessor> > m_PowerChunkProcessorList;
 	std::list<Ptr<mmWaveChunkProcessor> > m_sinrChunkProcessorList;
 
@@ -72,6 +84,23 @@ private:
 
 	uint32_t m_lastSignalId;
 	uint32_t m_lastSignalIdBeforeReset;
+
+	/*
+	 * Accumulator mode: since the mmWave transmissions are aligned to the
+	 * slots and symbols, many signals end at the same time. The signals
+	 * that end at the same time are summed in one bucket, which is
+	 * subtracted from m_allSignals by a single event.
+	 */
+	bool m_slotAccumulator;
+	struct ExpiryBucket
+	{
+		Ptr<SpectrumValue> m_sum;	// sum of the PSDs of the signals ending at this time
+		EventId m_event;			// subtraction event
+	};
+	std::map<Time, ExpiryBucket> m_expiryBuckets;
+	std::vector<Ptr<SpectrumValue> > m_freeSums;	// sums of expired buckets, reused for new buckets
+
+	Ptr<SpectrumValue> m_sinr;	// preallocated SINR of the chunk being evaluated
 };
 
 } // namespace ns3
@@ -0,0 +1,256 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015, NYU WIRELESS, Tandon School of Engineering, New York University
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "mmwave-raytracing-traces.h"
+#include <ns3/log.h>
+#include <ns3/fatal-error.h>
+#include <ns3/abort.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MmWaveRaytracingTraces");
+
+namespace {
+
+const char g_binaryMagic[8] = { 'M', 'M', 'W', 'R', 'A', 'Y', 'T', 'R' };
+
+static_assert (sizeof (MmWaveRaytracingTraces::BinaryHeader) == 32, "unexpected padding in the binary header");
+
+/// size of the array of path counts, padded to keep the following arrays aligned
+uint64_t
+GetPathArraySize (uint64_t nTraces)
+{
+  return (nTraces * sizeof (uint32_t) + 7) & ~static_cast<uint64_t> (7);
+}
+
+} // anonymous namespace
+
+MmWaveRaytracingTraces::MmWaveRaytracingTraces ()
+  : m_map (0),
+    m_mapSize (0),
+    m_nTraces (0),
+    m_paths (0),
+    m_offsets (0),
+    m_values (0)
+{
+}
+
+MmWaveRaytracingTraces::~MmWaveRaytracingTraces ()
+{
+  if (m_map != 0)
+    {
+      munmap (m_map, m_mapSize);
+    }
+}
+
+Ptr<MmWaveRaytracingTraces>
+MmWaveRaytracingTraces::Load (std::string filename)
+{
+  NS_LOG_FUNCTION (filename);
+  Ptr<MmWaveRaytracingTraces> traces = Create<MmWaveRaytracingTraces> ();
+  if (!traces->LoadBinary (filename))
+    {
+      traces->LoadText (filename);
+    }
+  NS_LOG_INFO ("Loaded " << traces->GetNTraces () << " traces from " << filename
+                         << (traces->IsMapped () ? " (binary)" : " (text)"));
+  return traces;
+}
+
+bool
+MmWaveRaytracingTraces::LoadBinary (const std::string& filename)
+{
+  int fd = open (filename.c_str (), O_RDONLY);
+  if (fd < 0)
+    {
+      NS_FATAL_ERROR ("Raytracing file " << filename << " not found");
+    }
+  struct stat st;
+  if (fstat (fd, &st) != 0)
+    {
+      close (fd);
+      NS_FATAL_ERROR ("Cannot stat raytracing file " << filename);
+    }
+  BinaryHeader header;
+  if (static_cast<uint64_t> (st.st_size) < sizeof (header)
+      || pread (fd, &header, sizeof (header), 0) != static_cast<ssize_t> (sizeof (header))
+      || std::memcmp (header.m_magic, g_binaryMagic, sizeof (g_binaryMagic)) != 0)
+    {
+      // not a binary file
+      close (fd);
+      return false;
+    }
+  if (header.m_byteOrder != BYTE_ORDER_MARK)
+    {
+      close (fd);
+      NS_FATAL_ERROR ("Raytracing file " << filename << " was written with another byte order");
+    }
+  if (header.m_version != BINARY_VERSION || header.m_nFields != NUM_FIELDS)
+    {
+      close (fd);
+      NS_FATAL_ERROR ("Raytracing file " << filename << " has unsupported version " << header.m_version);
+    }
+  uint64_t pathBytes = GetPathArraySize (header.m_nTraces);
+  uint64_t offsetBytes = (header.m_nTraces * NUM_FIELDS + 1) * sizeof (uint64_t);
+  uint64_t expectedSize = sizeof (header) + pathBytes + offsetBytes + header.m_nValues * sizeof (double);
+  if (static_cast<uint64_t> (st.st_size) != expectedSize)
+    {
+      close (fd);
+      NS_FATAL_ERROR ("Raytracing file " << filename << " is truncated: " << st.st_size
+                      << " bytes instead of " << expectedSize);
+    }
+
+  m_mapSize = st.st_size;
+  m_map = mmap (0, m_mapSize, PROT_READ, MAP_SHARED, fd, 0);
+  // the mapping stays valid after the descriptor is closed
+  close (fd);
+  if (m_map == MAP_FAILED)
+    {
+      m_map = 0;
+      NS_FATAL_ERROR ("Cannot map raytracing file " << filename);
+    }
+
+  const uint8_t* base = static_cast<const uint8_t*> (m_map);
+  m_nTraces = header.m_nTraces;
+  m_paths = reinterpret_cast<const uint32_t*> (base + sizeof (header));
+  m_offsets = reinterpret_cast<const uint64_t*> (base + sizeof (header) + pathBytes);
+  m_values = reinterpret_cast<const double*> (base + sizeof (header) + pathBytes + offsetBytes);
+
+  if (m_offsets[0] != 0 || m_offsets[m_nTraces * NUM_FIELDS] != header.m_nValues)
+    {
+      NS_FATAL_ERROR ("Raytracing file " << filename << " has inconsistent offsets");
+    }
+  return true;
+}
+
+void
+MmWaveRaytracingTraces::LoadText (const std::string& filename)
+{
+  std::ifstream file (filename.c_str (), std::ifstream::in);
+  NS_ABORT_MSG_UNLESS (file.good (), "Raytracing file " << filename << " not found");
+
+  m_offsetStorage.push_back (0);
+  std::string line;
+  uint16_t counter = 0;
+  while (std::getline (file, line)) // each line holds one field of a trace
+    {
+      if (line.empty () || line == "\r")
+        {
+          continue;
+        }
+      // parse each comma separated value of the line
+      const char* token = line.c_str ();
+      const char* lineEnd = token + line.size ();
+      uint64_t first = m_valueStorage.size ();
+      while (token < lineEnd)
+        {
+          const char* comma = std::strchr (token, ',');
+          const char* tokenEnd = comma != 0 ? comma : lineEnd;
+          // an empty token reads as 0
+          m_valueStorage.push_back (std::strtod (token, 0));
+          token = tokenEnd + 1;
+        }
+
+      if (counter == 0)
+        {
+          NS_ABORT_MSG_IF (m_valueStorage.size () == first, "Raytracing file " << filename << ": missing number of paths");
+          m_pathStorage.push_back (static_cast<uint32_t> (m_valueStorage[first]));
+          m_valueStorage.resize (first);
+        }
+      else
+        {
+          m_offsetStorage.push_back (m_valueStorage.size ());
+        }
+      counter = (counter + 1) % (NUM_FIELDS + 1);
+    }
+  NS_ABORT_MSG_IF (counter != 0, "Raytracing file " << filename << " ends with an incomplete trace");
+
+  m_nTraces = m_pathStorage.size ();
+  m_paths = m_pathStorage.empty () ? 0 : &m_pathStorage[0];
+  m_offsets = &m_offsetStorage[0];
+  m_values = m_valueStorage.empty () ? 0 : &m_valueStorage[0];
+}
+
+bool
+MmWaveRaytracingTraces::WriteBinary (std::string filename) const
+{
+  NS_LOG_FUNCTION (this << filename);
+  FILE* file = std::fopen (filename.c_str (), "wb");
+  if (file == 0)
+    {
+      return false;
+    }
+  BinaryHeader header;
+  std::memset (&header, 0, sizeof (header));
+  std::memcpy (header.m_magic, g_binaryMagic, sizeof (g_binaryMagic));
+  header.m_version = BINARY_VERSION;
+  header.m_nFields = NUM_FIELDS;
+  header.m_byteOrder = BYTE_ORDER_MARK;
+  header.m_nTraces = m_nTraces;
+  header.m_nValues = m_offsets[m_nTraces * NUM_FIELDS];
+
+  uint64_t pathBytes = GetPathArraySize (m_nTraces);
+  uint64_t padding = pathBytes - m_nTraces * sizeof (uint32_t);
+  const uint8_t zeros[8] = { 0 };
+  uint64_t nOffsets = m_nTraces * NUM_FIELDS + 1;
+  bool ok = std::fwrite (&header, sizeof (header), 1, file) == 1
+    && std::fwrite (m_paths, sizeof (uint32_t), m_nTraces, file) == m_nTraces
+    && std::fwrite (zeros, 1, padding, file) == padding
+    && std::fwrite (m_offsets, sizeof (uint64_t), nOffsets, file) == nOffsets
+    && std::fwrite (m_values, sizeof (double), header.m_nValues, file) == header.m_nValues;
+  ok = (std::fclose (file) == 0) && ok;
+  return ok;
+}
+
+uint64_t
+MmWaveRaytracingTraces::GetNTraces (void) const
+{
+  return m_nTraces;
+}
+
+uint32_t
+MmWaveRaytracingTraces::GetNPaths (uint64_t trace) const
+{
+  NS_ASSERT_MSG (trace < m_nTraces, "trace " << trace << " out of " << m_nTraces);
+  return m_paths[trace];
+}
+
+MmWaveRaytracingTraces::Span
+MmWaveRaytracingTraces::Get (uint64_t trace, Field field) const
+{
+  NS_ASSERT_MSG (trace < m_nTraces, "trace " << trace << " out of " << m_nTraces);
+  NS_ASSERT (field < NUM_FIELDS);
+  uint64_t index = trace * NUM_FIELDS + field;
+  return Span (m_values + m_offsets[index], m_offsets[index + 1] - m_offsets[index]);
+}
+
+bool
+MmWaveRaytracingTraces::IsMapped (void) const
+{
+  return m_map != 0;
+}
+
+} /* namespace ns3 */
@@ -0,0 +1,195 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015, NYU WIRELESS, Tandon School of Engineering, New York University
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SRC_MMWAVE_MODEL_MMWAVE_RAYTRACING_TRACES_H_
+#define SRC_MMWAVE_MODEL_MMWAVE_RAYTRACING_TRACES_H_
+
+#include <ns3/simple-ref-count.h>
+#include <ns3/ptr.h>
+#include <ns3/assert.h>
+#include <string>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup mmwave
+ *
+ * Read-only set of ray-traced channel snapshots used by
+ * MmWaveChannelRaytracing.
+ *
+ * Each trace (one snapshot of the channel) holds a number of paths and,
+ * for each of the fields in Field, one value per path. The traces can be
+ * loaded from two formats:
+ *
+ * - the text format exported by Quadriga, where each trace is 8 lines
+ *   of comma separated values: the number of paths, then the fields in
+ *   the order of Field;
+ * - a binary format, which is mapped in memory read-only, so that the
+ *   loading time does not depend on the number of traces and the
+ *   processes that use the same file share the page cache.
+ *
+ * The binary file starts with a 32-byte BinaryHeader, followed by
+ *
+ * - uint32 number of paths of each trace, padded to a multiple of 8 bytes
+ * - uint64 offsets[nTraces * NUM_FIELDS + 1], the index in the value
+ *   array of the first value of each field of each trace
+ * - double values[nValues]
+ *
+ * All the fields are in the byte order of the host that wrote the file;
+ * a file written with another byte order is rejected.
+ * utils/mmwave-raytracing-convert converts a text file to this format.
+ */
+class MmWaveRaytracingTraces : public SimpleRefCount<MmWaveRaytracingTraces>
+{
+public:
+  enum Field
+  {
+    DELAY = 0,          ///< delay spread in ns
+    PATHLOSS = 1,       ///< pathloss in dB
+    PHASE = 2,          ///< phase
+    AOD_ELEVATION = 3,  ///< degree
+    AOD_AZIMUTH = 4,    ///< degree
+    AOA_ELEVATION = 5,  ///< degree
+    AOA_AZIMUTH = 6,    ///< degree
+    NUM_FIELDS = 7
+  };
+
+  /// Header at the beginning of each binary file
+  struct BinaryHeader
+  {
+    char m_magic[8];       ///< "MMWRAYTR"
+    uint16_t m_version;    ///< format version, currently 1
+    uint16_t m_nFields;    ///< NUM_FIELDS
+    uint32_t m_byteOrder;  ///< BYTE_ORDER_MARK in the byte order of the writer
+    uint64_t m_nTraces;    ///< number of traces
+    uint64_t m_nValues;    ///< total number of values
+  };
+
+  static const uint16_t BINARY_VERSION = 1;
+  static const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+  /**
+   * Contiguous, read-only view of the values of one field of a trace.
+   * The view is valid as long as the MmWaveRaytracingTraces it comes from.
+   */
+  class Span
+  {
+  public:
+    Span ()
+      : m_data (0),
+        m_size (0)
+    {
+    }
+    Span (const double* data, uint64_t size)
+      : m_data (data),
+        m_size (size)
+    {
+    }
+    const double* begin (void) const
+    {
+      return m_data;
+    }
+    const double* end (void) const
+    {
+      return m_data + m_size;
+    }
+    uint64_t size (void) const
+    {
+      return m_size;
+    }
+    double operator[] (uint64_t i) const
+    {
+      return m_data[i];
+    }
+    double at (uint64_t i) const
+    {
+      NS_ASSERT_MSG (i < m_size, "index " << i << " out of a span of " << m_size << " values");
+      return m_data[i];
+    }
+    std::vector<double> ToVector (void) const
+    {
+      return std::vector<double> (begin (), end ());
+    }
+  private:
+    const double* m_data;
+    uint64_t m_size;
+  };
+
+  MmWaveRaytracingTraces ();
+  ~MmWaveRaytracingTraces ();
+
+  /**
+   * Load the traces of a file, in the binary format if the file starts
+   * with the binary magic, in the text format otherwise. A missing or
+   * malformed file is a fatal error.
+   *
+   * \param filename the file to load
+   * \return the traces
+   */
+  static Ptr<MmWaveRaytracingTraces> Load (std::string filename);
+
+  /**
+   * Write the traces to a file in the binary format
+   * \param filename the file to write
+   * \return true on success
+   */
+  bool WriteBinary (std::string filename) const;
+
+  /// \return the number of traces
+  uint64_t GetNTraces (void) const;
+
+  /**
+   * \param trace the index of the trace
+   * \return the number of paths of the trace
+   */
+  uint32_t GetNPaths (uint64_t trace) const;
+
+  /**
+   * \param trace the index of the trace
+   * \param field the field
+   * \return the values of the field of the trace
+   */
+  Span Get (uint64_t trace, Field field) const;
+
+  /// \return true if the traces are mapped from a binary file
+  bool IsMapped (void) const;
+
+private:
+  bool LoadBinary (const std::string& filename);
+  void LoadText (const std::string& filename);
+
+  /// Memory mapped binary file, 0 for text files
+  void* m_map;
+  size_t m_mapSize;
+
+  /// Storage of the traces loaded from a text file
+  std::vector<uint32_t> m_pathStorage;
+  std::vector<uint64_t> m_offsetStorage;
+  std::vector<double> m_valueStorage;
+
+  /// Views of either the mapped file or the storage above
+  uint64_t m_nTraces;
+  const uint32_t* m_paths;
+  const uint64_t* m_offsets;
+  const double* m_values;
+};
+
+} /* namespace ns3 */
+
+#endif /* SRC_MMWAVE_MODEL_MMWAVE_RAYTRACING_TRACES_H_ */
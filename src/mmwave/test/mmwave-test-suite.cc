@@ -28,6 +28,24 @@
 
 // Include a header file from your module to test.
 #include "ns3/mmwave-helper.h"
+#include "ns3/mmwave-flex-tti-maxrate-mac-scheduler.h"
+#include "ns3/mmwave-flex-tti-pf-mac-scheduler.h"
+#include "ns3/mmwave-3gpp-channel.h"
+#include "ns3/mmwave-spectrum-value-helper.h"
+#include "ns3/antenna-array-model.h"
+#include "ns3/config.h"
+#include "ns3/boolean.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/double.h"
+#include "ns3/nstime.h"
+#include "ns3/simulator.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/enum.h"
+#include "ns3/mmwave-amc.h"
+#include "ns3/mmwave-mi-error-model.h"
+#include "ns3/mmwave-interference.h"
+#include "ns3/mmwave-chunk-processor.h"
 
 // An essential include is test.h
 #include "ns3/test.h"
@@ -72,6 +90,890 @@ MmwaveTestCase1::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ_TOL (0.01, 0.01, 0.001, "Numbers are not equal within tolerance");
 }
 
+// MaxRate scheduler giving access to its symbol allocation
+class TestMaxRateMacScheduler : public MmWaveFlexTtiMaxRateMacScheduler
+{
+public:
+  void AddUe (uint16_t rnti, uint8_t mcs, uint32_t dlBuffer)
+  {
+    UeSchedInfo ue;
+    ue.m_rnti = rnti;
+    ue.m_dlMcs = mcs;
+    ue.m_ulMcs = mcs;
+    ue.m_totBufDl = dlBuffer;
+    ue.m_ulAllocDone = true;
+    m_ueSchedInfo.push_back (ue);
+  }
+  int Allocate (int symAvail)
+  {
+    std::vector<uint32_t> ueIndices;
+    for (uint32_t i = 0; i < m_ueSchedInfo.size (); i++)
+      {
+        ueIndices.push_back (i);
+      }
+    return AllocateSymbols (ueIndices, symAvail);
+  }
+  uint8_t GetDlSymbols (uint32_t ueIndex) const
+  {
+    return m_ueSchedInfo[ueIndex].m_dlSymbols;
+  }
+};
+
+// Check that the MaxRate scheduler serves the best MCS first, and shares
+// the symbols among the UEs with the same MCS
+class MmwaveMaxRateSchedulerTestCase : public TestCase
+{
+public:
+  MmwaveMaxRateSchedulerTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+MmwaveMaxRateSchedulerTestCase::MmwaveMaxRateSchedulerTestCase ()
+  : TestCase ("MaxRate scheduler shares the symbols among the UEs with the same rate")
+{
+}
+
+void
+MmwaveMaxRateSchedulerTestCase::DoRun (void)
+{
+  Ptr<MmWavePhyMacCommon> config = CreateObject<MmWavePhyMacCommon> ();
+  Ptr<TestMaxRateMacScheduler> scheduler = CreateObject<TestMaxRateMacScheduler> ();
+  scheduler->ConfigureCommonParameters (config);
+
+  // two backlogged UEs with the same MCS, and one with a lower MCS
+  scheduler->AddUe (1, 20, 10000000);
+  scheduler->AddUe (2, 20, 10000000);
+  scheduler->AddUe (3, 10, 10000000);
+  NS_TEST_ASSERT_MSG_EQ (scheduler->Allocate (21), 0, "Symbols left");
+  NS_TEST_EXPECT_MSG_EQ ((uint32_t) scheduler->GetDlSymbols (0), 11, "Wrong symbols of the first UE");
+  NS_TEST_EXPECT_MSG_EQ ((uint32_t) scheduler->GetDlSymbols (1), 10, "Wrong symbols of the second UE");
+  NS_TEST_EXPECT_MSG_EQ ((uint32_t) scheduler->GetDlSymbols (2), 0, "UE with a lower MCS served");
+  scheduler->Dispose ();
+}
+
+// Check that the attributes of the PF and MaxRate schedulers are
+// configured independently through the path of each scheduler
+class MmwaveSchedulerAttributesTestCase : public TestCase
+{
+public:
+  MmwaveSchedulerAttributesTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+MmwaveSchedulerAttributesTestCase::MmwaveSchedulerAttributesTestCase ()
+  : TestCase ("PF and MaxRate scheduler attributes are set per scheduler")
+{
+}
+
+void
+MmwaveSchedulerAttributesTestCase::DoRun (void)
+{
+  Config::SetDefault ("ns3::MmWaveFlexTtiPfMacScheduler::HarqEnabled", BooleanValue (true));
+  Config::SetDefault ("ns3::MmWaveFlexTtiMaxRateMacScheduler::FixedTti", BooleanValue (true));
+  Ptr<MmWaveFlexTtiPfMacScheduler> pf = CreateObject<MmWaveFlexTtiPfMacScheduler> ();
+  Ptr<MmWaveFlexTtiMaxRateMacScheduler> maxRate = CreateObject<MmWaveFlexTtiMaxRateMacScheduler> ();
+
+  BooleanValue value;
+  pf->GetAttribute ("HarqEnabled", value);
+  NS_TEST_EXPECT_MSG_EQ (value.Get (), true, "HarqEnabled not set on the PF scheduler");
+  pf->GetAttribute ("FixedTti", value);
+  NS_TEST_EXPECT_MSG_EQ (value.Get (), false, "FixedTti of the MaxRate scheduler set on the PF scheduler");
+  maxRate->GetAttribute ("HarqEnabled", value);
+  NS_TEST_EXPECT_MSG_EQ (value.Get (), false, "HarqEnabled of the PF scheduler set on the MaxRate scheduler");
+  maxRate->GetAttribute ("FixedTti", value);
+  NS_TEST_EXPECT_MSG_EQ (value.Get (), true, "FixedTti not set on the MaxRate scheduler");
+
+  Config::SetDefault ("ns3::MmWaveFlexTtiPfMacScheduler::HarqEnabled", BooleanValue (false));
+  Config::SetDefault ("ns3::MmWaveFlexTtiMaxRateMacScheduler::FixedTti", BooleanValue (false));
+  pf->Dispose ();
+  maxRate->Dispose ();
+}
+
+// Check the update and reuse counters and the ChannelUpdate trace of the
+// 3GPP channel for a static link, with and without UpdateStaticLinks
+class MmwaveStaticLinkChannelUpdateTestCase : public TestCase
+{
+public:
+  MmwaveStaticLinkChannelUpdateTestCase (bool updateStaticLinks);
+
+private:
+  virtual void DoRun (void);
+  void ChannelUpdate (Ptr<NetDevice> txDevice, Ptr<NetDevice> rxDevice, bool updated);
+  void CalcRxPsd (Ptr<MmWave3gppChannel> channel, Ptr<const SpectrumValue> txPsd,
+                  Ptr<NetDevice> enbDevice, Ptr<NetDevice> ueDevice);
+
+  bool m_updateStaticLinks;
+  uint32_t m_tracedUpdates;
+  uint32_t m_tracedReuses;
+};
+
+MmwaveStaticLinkChannelUpdateTestCase::MmwaveStaticLinkChannelUpdateTestCase (bool updateStaticLinks)
+  : TestCase (updateStaticLinks ? "The channel of a static link is updated by age"
+                                : "The channel of a static link is reused when UpdateStaticLinks is false"),
+    m_updateStaticLinks (updateStaticLinks),
+    m_tracedUpdates (0),
+    m_tracedReuses (0)
+{
+}
+
+void
+MmwaveStaticLinkChannelUpdateTestCase::ChannelUpdate (Ptr<NetDevice> txDevice, Ptr<NetDevice> rxDevice, bool updated)
+{
+  if (updated)
+    {
+      m_tracedUpdates++;
+    }
+  else
+    {
+      m_tracedReuses++;
+    }
+}
+
+void
+MmwaveStaticLinkChannelUpdateTestCase::CalcRxPsd (Ptr<MmWave3gppChannel> channel, Ptr<const SpectrumValue> txPsd,
+                                                  Ptr<NetDevice> enbDevice, Ptr<NetDevice> ueDevice)
+{
+  // the eNB PHY sends the control symbols omni, which the channel skips
+  Ptr<AntennaArrayModel> enbAntenna = DynamicCast<AntennaArrayModel> (
+      DynamicCast<MmWaveEnbNetDevice> (enbDevice)->GetPhy ()->GetDlSpectrumPhy ()->GetRxAntenna ());
+  bool omni = enbAntenna->IsOmniTx ();
+  enbAntenna->ChangeBeamformingVector (ueDevice);
+  channel->CalcRxPowerSpectralDensity (txPsd, enbDevice->GetNode ()->GetObject<MobilityModel> (),
+                                       ueDevice->GetNode ()->GetObject<MobilityModel> ());
+  if (omni)
+    {
+      enbAntenna->ChangeToOmniTx ();
+    }
+}
+
+void
+MmwaveStaticLinkChannelUpdateTestCase::DoRun (void)
+{
+  Config::SetDefault ("ns3::MmWaveHelper::ChannelModel", StringValue ("ns3::MmWave3gppChannel"));
+  Config::SetDefault ("ns3::MmWaveHelper::PathlossModel", StringValue ("ns3::MmWave3gppPropagationLossModel"));
+  Config::SetDefault ("ns3::MmWave3gppPropagationLossModel::ChannelCondition", StringValue ("l"));
+  Config::SetDefault ("ns3::MmWave3gppChannel::UpdatePeriod", TimeValue (MilliSeconds (5)));
+  Config::SetDefault ("ns3::MmWave3gppChannel::UpdateStaticLinks", BooleanValue (m_updateStaticLinks));
+
+  Ptr<MmWaveHelper> helper = CreateObject<MmWaveHelper> ();
+  NodeContainer enbNodes;
+  enbNodes.Create (1);
+  NodeContainer ueNodes;
+  ueNodes.Create (1);
+  Ptr<ListPositionAllocator> positions = CreateObject<ListPositionAllocator> ();
+  positions->Add (Vector (0.0, 0.0, 35.0));
+  positions->Add (Vector (50.0, 0.0, 1.5));
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.SetPositionAllocator (positions);
+  mobility.Install (enbNodes);
+  mobility.Install (ueNodes);
+  NetDeviceContainer enbDevs = helper->InstallEnbDevice (enbNodes);
+  NetDeviceContainer ueDevs = helper->InstallUeDevice (ueNodes);
+  helper->AttachToClosestEnb (ueDevs, enbDevs);
+
+  // a channel of its own, so that only the signals below use it
+  Ptr<MmWave3gppChannel> channel = CreateObject<MmWave3gppChannel> ();
+  channel->SetConfigurationParameters (helper->GetPhyMacConfigurable ());
+  channel->SetPathlossModel (helper->GetPathLossModel ());
+  channel->TraceConnectWithoutContext ("ChannelUpdate",
+                                       MakeCallback (&MmwaveStaticLinkChannelUpdateTestCase::ChannelUpdate, this));
+  // creates the channel of the link at time 0
+  channel->Initial (ueDevs, enbDevs);
+
+  std::vector<int> subchannels;
+  for (unsigned i = 0; i < helper->GetPhyMacConfigurable ()->GetTotalNumChunk (); i++)
+    {
+      subchannels.push_back (i);
+    }
+  Ptr<const SpectrumValue> txPsd =
+    MmWaveSpectrumValueHelper::CreateTxPowerSpectralDensity (helper->GetPhyMacConfigurable (), 30, subchannels);
+  for (uint32_t i = 1; i <= 20; i++)
+    {
+      Simulator::Schedule (MilliSeconds (i), &MmwaveStaticLinkChannelUpdateTestCase::CalcRxPsd,
+                           this, channel, txPsd, enbDevs.Get (0), ueDevs.Get (0));
+    }
+  Simulator::Stop (MilliSeconds (21));
+  Simulator::Run ();
+
+  uint64_t updates = channel->GetNumChannelUpdates (enbDevs.Get (0), ueDevs.Get (0));
+  uint64_t reuses = channel->GetNumChannelReuses (enbDevs.Get (0), ueDevs.Get (0));
+  if (m_updateStaticLinks)
+    {
+      // the channel is 5 ms old at 5, 10, 15 and 20 ms
+      NS_TEST_EXPECT_MSG_EQ (updates, 4, "Wrong number of updates of the static link");
+      NS_TEST_EXPECT_MSG_EQ (reuses, 16, "Wrong number of reuses of the static link");
+    }
+  else
+    {
+      NS_TEST_EXPECT_MSG_EQ (updates, 0, "The channel of the static link was updated");
+      NS_TEST_EXPECT_MSG_EQ (reuses, 20, "Wrong number of reuses of the static link");
+    }
+  UintegerValue total;
+  channel->GetAttribute ("NumChannelUpdates", total);
+  NS_TEST_EXPECT_MSG_EQ (total.Get (), updates, "NumChannelUpdates does not count the updates of the link");
+  channel->GetAttribute ("NumChannelReuses", total);
+  NS_TEST_EXPECT_MSG_EQ (total.Get (), reuses, "NumChannelReuses does not count the reuses of the link");
+  NS_TEST_EXPECT_MSG_EQ (m_tracedUpdates, updates, "Updates not traced");
+  NS_TEST_EXPECT_MSG_EQ (m_tracedReuses, reuses, "Reuses not traced");
+
+  Simulator::Destroy ();
+  Config::SetDefault ("ns3::MmWaveHelper::ChannelModel", StringValue ("ns3::MmWaveBeamforming"));
+  Config::SetDefault ("ns3::MmWaveHelper::PathlossModel", StringValue ("ns3::MmWavePropagationLossModel"));
+  Config::SetDefault ("ns3::MmWave3gppPropagationLossModel::ChannelCondition", StringValue ("a"));
+  Config::SetDefault ("ns3::MmWave3gppChannel::UpdatePeriod", TimeValue (MilliSeconds (0)));
+  Config::SetDefault ("ns3::MmWave3gppChannel::UpdateStaticLinks", BooleanValue (true));
+}
+
+// Check the beam pair selected by the codebook search of the 3GPP channel against
+// the previous search, which set each pair of sectors on the antennas and
+// evaluated the PSD gain with CalLongTerm and CalBeamformingGain
+class MmwaveBeamSearchTestCase : public TestCase
+{
+public:
+  MmwaveBeamSearchTestCase (MmWave3gppChannel::BeamSearchMethod_t method);
+
+private:
+  virtual void DoRun (void);
+
+  MmWave3gppChannel::BeamSearchMethod_t m_method;
+};
+
+MmwaveBeamSearchTestCase::MmwaveBeamSearchTestCase (MmWave3gppChannel::BeamSearchMethod_t method)
+  : TestCase (method == MmWave3gppChannel::EXHAUSTIVE_BEAM_SEARCH
+              ? "The exhaustive codebook search selects the best beam pair of the previous search"
+              : "The hierarchical codebook search selects a beam pair of the previous search"),
+    m_method (method)
+{
+}
+
+void
+MmwaveBeamSearchTestCase::DoRun (void)
+{
+  Config::SetDefault ("ns3::MmWaveHelper::ChannelModel", StringValue ("ns3::MmWave3gppChannel"));
+  Config::SetDefault ("ns3::MmWaveHelper::PathlossModel", StringValue ("ns3::MmWave3gppPropagationLossModel"));
+  Config::SetDefault ("ns3::MmWave3gppPropagationLossModel::ChannelCondition", StringValue ("n"));
+
+  Ptr<MmWaveHelper> helper = CreateObject<MmWaveHelper> ();
+  NodeContainer enbNodes;
+  enbNodes.Create (1);
+  NodeContainer ueNodes;
+  ueNodes.Create (3);
+  Ptr<ListPositionAllocator> positions = CreateObject<ListPositionAllocator> ();
+  positions->Add (Vector (0.0, 0.0, 35.0));
+  positions->Add (Vector (50.0, 0.0, 1.5));
+  positions->Add (Vector (30.0, 40.0, 1.5));
+  positions->Add (Vector (-20.0, 60.0, 1.5));
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.SetPositionAllocator (positions);
+  mobility.Install (enbNodes);
+  mobility.Install (ueNodes);
+  NetDeviceContainer enbDevs = helper->InstallEnbDevice (enbNodes);
+  NetDeviceContainer ueDevs = helper->InstallUeDevice (ueNodes);
+  helper->AttachToClosestEnb (ueDevs, enbDevs);
+
+  Ptr<MmWave3gppChannel> channel = CreateObject<MmWave3gppChannel> ();
+  channel->SetAttribute ("CellScan", BooleanValue (true));
+  channel->SetAttribute ("BeamSearchMethod", EnumValue (m_method));
+  channel->SetConfigurationParameters (helper->GetPhyMacConfigurable ());
+  channel->SetPathlossModel (helper->GetPathLossModel ());
+  // creates the channel of the downlink of each UE
+  channel->Initial (ueDevs, enbDevs);
+
+  std::vector<int> subchannels;
+  for (unsigned i = 0; i < helper->GetPhyMacConfigurable ()->GetTotalNumChunk (); i++)
+    {
+      subchannels.push_back (i);
+    }
+  Ptr<const SpectrumValue> txPsd =
+    MmWaveSpectrumValueHelper::CreateTxPowerSpectralDensity (helper->GetPhyMacConfigurable (), 0, subchannels);
+
+  uint32_t enbId = channel->GetDeviceId (enbDevs.Get (0));
+  Ptr<AntennaArrayModel> txAntenna = channel->m_devices[enbId].m_antennaArray;
+  uint8_t* txAntennaNum = channel->m_devices[enbId].m_antennaNum;
+  for (uint32_t u = 0; u < ueDevs.GetN (); u++)
+    {
+      uint32_t ueId = channel->GetDeviceId (ueDevs.Get (u));
+      Ptr<AntennaArrayModel> rxAntenna = channel->m_devices[ueId].m_antennaArray;
+      uint8_t* rxAntennaNum = channel->m_devices[ueId].m_antennaNum;
+      Ptr<Params3gpp> params = channel->m_devices[enbId].m_links[ueId].m_channel;
+      NS_TEST_ASSERT_MSG_NE (params, 0, "No channel for UE " << u);
+
+      channel->BeamSearchBeamforming (txPsd, params, txAntenna, rxAntenna, txAntennaNum, rxAntennaNum);
+      channel->CalLongTerm (params);
+      double gain = channel->CalBeamformingGain (*txPsd, 0, params, Vector (0, 0, 0));
+
+      // the previous search
+      double maxGain = 0;
+      for (uint16_t txTheta = 60; txTheta < 121; txTheta = txTheta + 10)
+        {
+          for (uint16_t tx = 0; tx <= txAntennaNum[1]; tx++)
+            {
+              for (uint16_t rxTheta = 60; rxTheta < 121; rxTheta = rxTheta + 10)
+                {
+                  for (uint16_t rx = 0; rx <= rxAntennaNum[1]; rx++)
+                    {
+                      txAntenna->SetSector (tx, txAntennaNum, txTheta);
+                      rxAntenna->SetSector (rx, rxAntennaNum, rxTheta);
+                      params->m_txW = txAntenna->GetBeamformingVector ();
+                      params->m_rxW = rxAntenna->GetBeamformingVector ();
+                      channel->CalLongTerm (params);
+                      double power = channel->CalBeamformingGain (*txPsd, 0, params, Vector (0, 0, 0));
+                      maxGain = std::max (maxGain, power);
+                      if (u == 0)
+                        {
+                          // the cached codebook holds the vectors set by SetSector
+                          complexVector_t txW = txAntenna->GetSectorVector (tx, txAntennaNum, txTheta);
+                          complexVector_t rxW = rxAntenna->GetSectorVector (rx, rxAntennaNum, rxTheta);
+                          NS_TEST_ASSERT_MSG_EQ ((txW == params->m_txW), true, "Wrong tx codeword " << tx << " " << txTheta);
+                          NS_TEST_ASSERT_MSG_EQ ((rxW == params->m_rxW), true, "Wrong rx codeword " << rx << " " << rxTheta);
+                        }
+                    }
+                }
+            }
+        }
+
+      NS_TEST_ASSERT_MSG_GT (gain, 0, "No gain with the selected beams of UE " << u);
+      if (m_method == MmWave3gppChannel::EXHAUSTIVE_BEAM_SEARCH)
+        {
+          NS_TEST_EXPECT_MSG_EQ_TOL (gain, maxGain, maxGain * 1e-9, "Not the best beam pair for UE " << u);
+        }
+      else
+        {
+          NS_TEST_EXPECT_MSG_LT_OR_EQ (gain, maxGain * (1 + 1e-9), "Gain above the best beam pair for UE " << u);
+        }
+    }
+
+  Simulator::Destroy ();
+  Config::SetDefault ("ns3::MmWaveHelper::ChannelModel", StringValue ("ns3::MmWaveBeamforming"));
+  Config::SetDefault ("ns3::MmWaveHelper::PathlossModel", StringValue ("ns3::MmWavePropagationLossModel"));
+  Config::SetDefault ("ns3::MmWave3gppPropagationLossModel::ChannelCondition", StringValue ("a"));
+}
+
+// Check the CQI and MCS of the MiErrorModel AMC against the previous
+// computation, which increased the MCS from 0 until the TBLER exceeded 10 %
+class MmwaveAmcMcsTestCase : public TestCase
+{
+public:
+  MmwaveAmcMcsTestCase (bool useMcsTable);
+
+private:
+  virtual void DoRun (void);
+  /**
+   * The MCS and CQI of the previous linear scan
+   * \param sinr the SINR of the chunks
+   * \param chunks the chunks of the TB
+   * \param tbSizes the TB size in bytes of each MCS
+   * \param mcs set to the MCS
+   * \return the CQI
+   */
+  int GetReferenceCqi (const SpectrumValue& sinr, const std::vector<int>& chunks,
+                       const std::vector<uint32_t>& tbSizes, int& mcs);
+
+  bool m_useMcsTable;
+};
+
+MmwaveAmcMcsTestCase::MmwaveAmcMcsTestCase (bool useMcsTable)
+  : TestCase (useMcsTable ? "The MCS table of MmWaveAmc gives the MCS of the linear scan"
+                          : "The MCS search of MmWaveAmc gives the MCS of the linear scan"),
+    m_useMcsTable (useMcsTable)
+{
+}
+
+int
+MmwaveAmcMcsTestCase::GetReferenceCqi (const SpectrumValue& sinr, const std::vector<int>& chunks,
+                                       const std::vector<uint32_t>& tbSizes, int& mcs)
+{
+  // spectral efficiencies of mmwave-amc.cc
+  static const double spectralEfficiencyForCqi[16] = {
+    0.0, 0.15, 0.23, 0.38, 0.6, 0.88, 1.18, 1.48, 1.91, 2.41, 2.73, 3.32, 3.9, 4.52, 5.12, 5.55
+  };
+  static const double spectralEfficiencyForMcs[29] = {
+    0.15, 0.19, 0.23, 0.31, 0.38, 0.49, 0.6, 0.74, 0.88, 1.03, 1.18, 1.33, 1.48, 1.7, 1.91,
+    2.16, 2.41, 2.57, 2.73, 3.03, 3.32, 3.61, 3.9, 4.21, 4.52, 4.82, 5.12, 5.33, 5.55
+  };
+
+  mcs = 0;
+  TbStats_t tbStats;
+  while (mcs <= 28)
+    {
+      MmWaveHarqProcessInfoList_t harqInfoList;
+      tbStats = MmWaveMiErrorModel::GetTbDecodificationStats (sinr, chunks, tbSizes[mcs], mcs, harqInfoList);
+      if (tbStats.tbler > 0.1)
+        {
+          break;
+        }
+      mcs++;
+    }
+  if (mcs > 0)
+    {
+      mcs--;
+    }
+  if ((tbStats.tbler > 0.1) && (mcs == 0))
+    {
+      return 0;
+    }
+  if (mcs == 28)
+    {
+      return 15;
+    }
+  double se = spectralEfficiencyForMcs[mcs];
+  int cqi = 0;
+  while ((cqi < 15) && (spectralEfficiencyForCqi[cqi + 1] <= se))
+    {
+      ++cqi;
+    }
+  return cqi;
+}
+
+void
+MmwaveAmcMcsTestCase::DoRun (void)
+{
+  Ptr<MmWavePhyMacCommon> config = CreateObject<MmWavePhyMacCommon> ();
+  Ptr<MmWaveAmc> amc = CreateObject<MmWaveAmc> (config);
+  amc->SetAttribute ("AmcModel", EnumValue (MmWaveAmc::MiErrorModel));
+  amc->SetAttribute ("UseMcsTable", BooleanValue (m_useMcsTable));
+
+  SpectrumValue sinr (MmWaveSpectrumValueHelper::GetSpectrumModel (config));
+  std::vector<int> allChunks;
+  for (uint32_t i = 0; i < sinr.GetSpectrumModel ()->GetNumBands (); i++)
+    {
+      allChunks.push_back (i);
+    }
+  const uint8_t numSym = 6;
+  std::vector<uint32_t> tdmaTbSizes;
+  for (unsigned mcs = 0; mcs <= 28; mcs++)
+    {
+      tdmaTbSizes.push_back (amc->GetTbSizeFromMcsSymbols (mcs, numSym) / 8);
+    }
+
+  // flat and frequency selective SINRs from -10 to 30 dB
+  int minMcs = 28;
+  int maxMcs = 0;
+  for (int selective = 0; selective <= 1; selective++)
+    {
+      for (double sinrDb = -10; sinrDb <= 30; sinrDb += 0.5)
+        {
+          for (uint32_t i = 0; i < allChunks.size (); i++)
+            {
+              sinr[i] = std::pow (10.0, (sinrDb + selective * 8 * std::sin (0.3 * i)) / 10);
+            }
+
+          uint32_t tbSizes[] = {100, 1000, 10000};
+          for (uint32_t t = 0; t < 3; t++)
+            {
+              int mcs;
+              int cqi = amc->CreateCqiFeedbackWbTdma (sinr, numSym, tbSizes[t], mcs);
+              int refMcs;
+              int refCqi = GetReferenceCqi (sinr, allChunks, std::vector<uint32_t> (29, tbSizes[t]), refMcs);
+              NS_TEST_ASSERT_MSG_EQ (mcs, refMcs, "Wideband MCS at " << sinrDb << " dB for " << tbSizes[t] << " bytes");
+              NS_TEST_ASSERT_MSG_EQ (cqi, refCqi, "Wideband CQI at " << sinrDb << " dB for " << tbSizes[t] << " bytes");
+              minMcs = std::min (minMcs, mcs);
+              maxMcs = std::max (maxMcs, mcs);
+            }
+
+          std::vector<int> cqis = amc->CreateCqiFeedbacksTdma (sinr, numSym);
+          NS_TEST_ASSERT_MSG_EQ (cqis.size (), allChunks.size (), "One CQI per chunk");
+          for (uint32_t i = 0; i < allChunks.size (); i += 7)
+            {
+              int refMcs;
+              int refCqi = GetReferenceCqi (sinr, std::vector<int> (1, i), tdmaTbSizes, refMcs);
+              NS_TEST_ASSERT_MSG_EQ (cqis[i], refCqi, "CQI of chunk " << i << " at " << sinrDb << " dB");
+            }
+        }
+    }
+  NS_TEST_ASSERT_MSG_EQ (minMcs, 0, "The SINRs should cover the lowest MCS");
+  NS_TEST_ASSERT_MSG_EQ (maxMcs, 28, "The SINRs should cover the highest MCS");
+}
+
+// Check the precomputed ParamsTable of the 3GPP channel against the table that
+// Get3gppTable used to build on every call, for all the scenarios and conditions
+class Mmwave3gppTableTestCase : public TestCase
+{
+public:
+  Mmwave3gppTableTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * The table previously built by Get3gppTable, without the correlation matrix
+   * \param scenario the scenario
+   * \param fcGHz the centre frequency in GHz
+   * \param los the los condition
+   * \param o2i the o2i condition
+   * \param hBS the BS height
+   * \param hUT the UT height
+   * \param distance2D the 2D distance
+   * \return the table
+   */
+  Ptr<ParamsTable> GetReferenceTable (std::string scenario, double fcGHz, bool los, bool o2i,
+                                      double hBS, double hUT, double distance2D);
+};
+
+Mmwave3gppTableTestCase::Mmwave3gppTableTestCase ()
+  : TestCase ("The precomputed 3GPP tables match the tables built per channel")
+{
+}
+
+Ptr<ParamsTable>
+Mmwave3gppTableTestCase::GetReferenceTable (std::string scenario, double fcGHz, bool los, bool o2i,
+                                            double hBS, double hUT, double distance2D)
+{
+  Ptr<ParamsTable> table3gpp = CreateObject<ParamsTable> ();
+  if (scenario == "RMa")
+    {
+      if (los)
+        {
+          table3gpp->SetParams (11, 20, -7.49, 0.55, 0.90, 0.38, 1.52, 0.24, 0.60, 0.16,
+                                0.3, 0.4, 0, 3.91e-9, 2, 3, 3, 7, 4, 3.8, 3);
+        }
+      else
+        {
+          double offsetZod = atan ((35 - 5) / distance2D) - atan ((35 - 1.5) / distance2D);
+          table3gpp->SetParams (10, 20, -7.43, 0.48, 0.95, 0.45, 1.52, 0.13, 0.88, 0.16,
+                                0.3, 0.49, offsetZod, 3.91e-9, 2, 3, 3, 0, 0, 1.7,3);
+        }
+    }
+  else if (scenario == "UMa")
+    {
+      if (los && !o2i)
+        {
+          double uLgZSD = std::max (-0.5, -2.1 * distance2D / 1000 - 0.01 * (hUT - 1.5) + 0.75);
+          double cDs = std::max (0.25, -3.4084 * log10 (fcGHz) + 6.5622) * 1e-9;
+          table3gpp->SetParams (12, 20, -6.955 - 0.0963 * log10 (fcGHz), 0.66, 1.06 + 0.1114 * log10 (fcGHz),
+                                0.28, 1.81, 0.20, 0.95, 0.16, uLgZSD, 0.40, 0, cDs, 5, 11, 7, 9, 3.5, 2.5, 3);
+        }
+      else
+        {
+          double uLgZSD = std::max (-0.5, -2.1 * distance2D / 1000 - 0.01 * (hUT - 1.5) + 0.9);
+          double afc = 0.208 * log10 (fcGHz) - 0.782;
+          double bfc = 25;
+          double cfc = -0.13 * log10 (fcGHz) + 2.03;
+          double efc = 7.66 * log10 (fcGHz) - 5.96;
+          double offsetZOD = efc - std::pow (10, afc * log10 (std::max (bfc, distance2D)) + cfc);
+          double cDS = std::max (0.25, -3.4084 * log10 (fcGHz) + 6.5622) * 1e-9;
+          if (!los && !o2i)
+            {
+              table3gpp->SetParams (20, 20, -6.28 - 0.204 * log10 (fcGHz), 0.39, 1.5 - 0.1144 * log10 (fcGHz),
+                                    0.28, 2.08 - 0.27 * log10 (fcGHz), 0.11, -0.3236 * log10 (fcGHz) + 1.512, 0.16, uLgZSD,
+                                    0.49, offsetZOD, cDS, 2, 15, 7, 0, 0, 2.3, 3);
+            }
+          else
+            {
+              table3gpp->SetParams (12, 20, -6.62, 0.32, 1.25, 0.42, 1.76, 0.16, 1.01, 0.43,
+                                    uLgZSD, 0.49, offsetZOD, 11e-9, 5, 20, 6, 0, 0, 2.2, 4);
+            }
+        }
+    }
+  else if (scenario == "UMi-StreetCanyon")
+    {
+      if (los && !o2i)
+        {
+          double uLgZSD = std::max (-0.21, -14.8 * distance2D / 1000 + 0.01 * std::abs (hUT - hBS) + 0.83);
+          table3gpp->SetParams (12, 20, -0.24 * log10 (1 + fcGHz) - 7.14, 0.38, -0.05 * log10 (1 + fcGHz) + 1.21, 0.41,
+                                -0.08 * log10 (1 + fcGHz) + 1.73, 0.014 * log10 (1 + fcGHz) + 0.28, -0.1 * log10 (1 + fcGHz) + 0.73,
+                                -0.04 * log10 (1 + fcGHz) + 0.34, uLgZSD, 0.35, 0, 5e-9, 3, 17, 7, 9, 5, 3, 3);
+        }
+      else
+        {
+          double uLgZSD = std::max (-0.5, -3.1 * distance2D / 1000 + 0.01 * std::max (hUT - hBS, 0.0) + 0.2);
+          double offsetZOD = -1 * std::pow (10, -1.5 * log10 (std::max (10.0, distance2D)) + 3.3);
+          if (!los && !o2i)
+            {
+              table3gpp->SetParams (19, 20, -0.24 * log10 (1 + fcGHz) - 6.83, 0.16 * log10 (1 + fcGHz) + 0.28,
+                                    -0.23 * log10 (1 + fcGHz) + 1.53, 0.11 * log10 (1 + fcGHz) + 0.33,
+                                    -0.08 * log10 (1 + fcGHz) + 1.81, 0.05 * log10 (1 + fcGHz) + 0.3,
+                                    -0.04 * log10 (1 + fcGHz) + 0.92, -0.07 * log10 (1 + fcGHz) + 0.41, uLgZSD, 0.35, offsetZOD,
+                                    11e-9, 10, 22, 7, 0, 0, 2.1, 3);
+            }
+          else
+            {
+              table3gpp->SetParams (12, 20, -6.62, 0.32, 1.25, 0.42, 1.76, 0.16, 1.01, 0.43,
+                                    uLgZSD, 0.35, offsetZOD, 11e-9, 5, 20, 6, 0, 0, 2.2, 4);
+            }
+        }
+    }
+  else
+    {
+      if (los)
+        {
+          table3gpp->SetParams (8, 20, -0.01 * log10 (1 + fcGHz) - 7.79, -0.16 * log10 (1 + fcGHz) + 0.50, 1.60, 0.18,
+                                -0.19 * log10 (1 + fcGHz) + 1.86, 0.12 * log10 (1 + fcGHz), -0.26 * log10 (1 + fcGHz) + 1.21,
+                                -0.04 * log10 (1 + fcGHz) + 0.17, -1.43 * log10 (1 + fcGHz) + 2.25, 0.13 * log10 (1 + fcGHz) + 0.15,
+                                0, 3.91e-9, 7, -6.2 * log10 (1 + fcGHz) + 16.72, -3.85 * log10 (1 + fcGHz) + 10.28,
+                                0.84 * log10 (1 + fcGHz) + 2.12, -0.58 * log10 (1 + fcGHz) + 6.19, 2.15, 6);
+        }
+      else
+        {
+          table3gpp->SetParams (10, 20, -0.28 * log10 (1 + fcGHz) - 7.29, 0.1 * log10 (1 + fcGHz) + 0.11, 1.49, 0.17,
+                                -0.11 * log10 (1 + fcGHz) + 1.8, 0.12 * log10 (1 + fcGHz), -0.15 * log10 (1 + fcGHz) + 1.04,
+                                -0.09 * log10 (1 + fcGHz) + 0.24, 1.37, 0.38, 0, 3.91e-9, 3, -13.0 * log10 (1 + fcGHz) + 30.53,
+                                -3.72 * log10 (1 + fcGHz) + 10.25, 0, 0, 1.84, 3);
+        }
+    }
+  return table3gpp;
+}
+
+void
+Mmwave3gppTableTestCase::DoRun (void)
+{
+  std::string scenarios[] = {"RMa", "UMa", "UMi-StreetCanyon", "InH-OfficeMixed", "InH-OfficeOpen"};
+  double fcs[] = {28e9, 73e9};
+  double distances[] = {5, 30, 200, 1000};
+  double hUTs[] = {1.5, 12};
+  const double hBS = 10;
+
+  for (uint32_t s = 0; s < 5; s++)
+    {
+      Ptr<MmWavePhyMacCommon> config = CreateObject<MmWavePhyMacCommon> ();
+      Ptr<MmWave3gppPropagationLossModel> pathloss = CreateObject<MmWave3gppPropagationLossModel> ();
+      pathloss->SetAttribute ("Scenario", StringValue (scenarios[s]));
+      Ptr<MmWave3gppChannel> channel = CreateObject<MmWave3gppChannel> ();
+      channel->SetConfigurationParameters (config);
+      channel->SetPathlossModel (pathloss);
+      bool indoor = (scenarios[s] == "InH-OfficeMixed" || scenarios[s] == "InH-OfficeOpen");
+
+      // the tables are rebuilt when the centre frequency changes
+      for (uint32_t f = 0; f < 2; f++)
+        {
+          config->SetAttribute ("CenterFreq", DoubleValue (fcs[f]));
+          for (uint32_t c = 0; c < (indoor ? 2u : 4u); c++)
+            {
+              bool los = (c % 2 == 0);
+              bool o2i = (c >= 2);
+              // the precomputed tables are shared, so the calls for different
+              // positions must not leak into each other
+              for (uint32_t d = 0; d < 4; d++)
+                {
+                  for (uint32_t h = 0; h < 2; h++)
+                    {
+                      Ptr<ParamsTable> table = channel->Get3gppTable (los, o2i, hBS, hUTs[h], distances[d]);
+                      Ptr<ParamsTable> ref = GetReferenceTable (scenarios[s], fcs[f] / 1e9, los, o2i,
+                                                                hBS, hUTs[h], distances[d]);
+                      std::ostringstream where;
+                      where << scenarios[s] << " fc " << fcs[f] << " los " << los << " o2i " << o2i
+                            << " d " << distances[d] << " hUT " << hUTs[h];
+                      NS_TEST_ASSERT_MSG_EQ ((uint16_t) table->m_numOfCluster, (uint16_t) ref->m_numOfCluster, where.str ());
+                      NS_TEST_ASSERT_MSG_EQ ((uint16_t) table->m_raysPerCluster, (uint16_t) ref->m_raysPerCluster, where.str ());
+                      double values[][2] = {
+                        {table->m_uLgDS, ref->m_uLgDS}, {table->m_sigLgDS, ref->m_sigLgDS},
+                        {table->m_uLgASD, ref->m_uLgASD}, {table->m_sigLgASD, ref->m_sigLgASD},
+                        {table->m_uLgASA, ref->m_uLgASA}, {table->m_sigLgASA, ref->m_sigLgASA},
+                        {table->m_uLgZSA, ref->m_uLgZSA}, {table->m_sigLgZSA, ref->m_sigLgZSA},
+                        {table->m_uLgZSD, ref->m_uLgZSD}, {table->m_sigLgZSD, ref->m_sigLgZSD},
+                        {table->m_offsetZOD, ref->m_offsetZOD}, {table->m_cDS, ref->m_cDS},
+                        {table->m_cASD, ref->m_cASD}, {table->m_cASA, ref->m_cASA},
+                        {table->m_cZSA, ref->m_cZSA}, {table->m_uK, ref->m_uK}, {table->m_sigK, ref->m_sigK},
+                        {table->m_rTau, ref->m_rTau}, {table->m_shadowingStd, ref->m_shadowingStd}
+                      };
+                      for (uint32_t v = 0; v < sizeof (values) / sizeof (values[0]); v++)
+                        {
+                          NS_TEST_ASSERT_MSG_EQ_TOL (values[v][0], values[v][1], std::abs (values[v][1]) * 1e-12,
+                                                     where.str () << " parameter " << v);
+                        }
+
+                      // the square-root correlation matrix is lower triangular, with
+                      // unit rows, over [SF,K,DS,ASD,ASA,ZSD,ZSA] or without K
+                      uint8_t size = ref->m_sigK != 0 ? 7 : 6;
+                      for (uint8_t row = 0; row < size; row++)
+                        {
+                          double norm = 0;
+                          for (uint8_t column = 0; column < size; column++)
+                            {
+                              if (column > row)
+                                {
+                                  NS_TEST_ASSERT_MSG_EQ (table->m_sqrtC[row][column], 0, where.str () << " sqrtC not triangular");
+                                }
+                              norm += table->m_sqrtC[row][column] * table->m_sqrtC[row][column];
+                            }
+                          NS_TEST_ASSERT_MSG_EQ_TOL (norm, 1, 1e-4, where.str () << " sqrtC row " << (uint16_t) row);
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Check the SINR of mmWaveInterference with and without SlotAccumulator against
+// the time-averaged SINR, for signals ending at the same time, a noise reset
+// with pending signals and a reception after the reset
+class MmwaveInterferenceAccumulatorTestCase : public TestCase
+{
+public:
+  MmwaveInterferenceAccumulatorTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Create a PSD with the given value in each band
+   * \param base the value in the first band
+   * \param step the increment per band
+   * \return the PSD
+   */
+  Ptr<SpectrumValue> CreatePsd (double base, double step);
+  // first rx, from 0 to 4 us, with two interferers ending with it
+  void StartFirstRx (Ptr<mmWaveInterference> interference);
+  // interferer starting in the middle of the first rx
+  void AddInterferer (Ptr<mmWaveInterference> interference);
+  // noise reset at 5 us, while two interferers are pending, and second rx
+  void StartSecondRx (Ptr<mmWaveInterference> interference);
+  // third rx, from 10 to 12 us
+  void StartThirdRx (Ptr<mmWaveInterference> interference);
+  void ReportSinrAccumulator (const SpectrumValue& sinr);
+  void ReportSinrPerSignal (const SpectrumValue& sinr);
+
+  Ptr<SpectrumModel> m_model;
+  Ptr<SpectrumValue> m_noise;
+  Ptr<SpectrumValue> m_rx1, m_a, m_b, m_c, m_d;
+  Ptr<SpectrumValue> m_rx2, m_e;
+  Ptr<SpectrumValue> m_rx3, m_f;
+  std::vector<SpectrumValue> m_sinrAccumulator;
+  std::vector<SpectrumValue> m_sinrPerSignal;
+};
+
+MmwaveInterferenceAccumulatorTestCase::MmwaveInterferenceAccumulatorTestCase ()
+  : TestCase ("The SINR of mmWaveInterference is the same with and without SlotAccumulator")
+{
+}
+
+Ptr<SpectrumValue>
+MmwaveInterferenceAccumulatorTestCase::CreatePsd (double base, double step)
+{
+  Ptr<SpectrumValue> psd = Create<SpectrumValue> (m_model);
+  for (uint32_t i = 0; i < m_model->GetNumBands (); i++)
+    {
+      (*psd)[i] = base + step * i;
+    }
+  return psd;
+}
+
+void
+MmwaveInterferenceAccumulatorTestCase::StartFirstRx (Ptr<mmWaveInterference> interference)
+{
+  interference->AddSignal (m_rx1, MicroSeconds (4));
+  interference->AddSignal (m_a, MicroSeconds (4));
+  interference->AddSignal (m_b, MicroSeconds (4));
+  interference->AddSignal (m_c, MicroSeconds (6));
+  interference->StartRx (m_rx1);
+  Simulator::Schedule (MicroSeconds (4), &mmWaveInterference::EndRx, interference);
+}
+
+void
+MmwaveInterferenceAccumulatorTestCase::AddInterferer (Ptr<mmWaveInterference> interference)
+{
+  interference->AddSignal (m_d, MicroSeconds (6));
+}
+
+void
+MmwaveInterferenceAccumulatorTestCase::StartSecondRx (Ptr<mmWaveInterference> interference)
+{
+  interference->SetNoisePowerSpectralDensity (m_noise);
+  interference->AddSignal (m_rx2, MicroSeconds (4));
+  interference->AddSignal (m_e, MicroSeconds (2));
+  interference->StartRx (m_rx2);
+  Simulator::Schedule (MicroSeconds (4), &mmWaveInterference::EndRx, interference);
+}
+
+void
+MmwaveInterferenceAccumulatorTestCase::StartThirdRx (Ptr<mmWaveInterference> interference)
+{
+  interference->AddSignal (m_rx3, MicroSeconds (2));
+  interference->AddSignal (m_f, MicroSeconds (1));
+  interference->StartRx (m_rx3);
+  Simulator::Schedule (MicroSeconds (2), &mmWaveInterference::EndRx, interference);
+}
+
+void
+MmwaveInterferenceAccumulatorTestCase::ReportSinrAccumulator (const SpectrumValue& sinr)
+{
+  m_sinrAccumulator.push_back (sinr);
+}
+
+void
+MmwaveInterferenceAccumulatorTestCase::ReportSinrPerSignal (const SpectrumValue& sinr)
+{
+  m_sinrPerSignal.push_back (sinr);
+}
+
+void
+MmwaveInterferenceAccumulatorTestCase::DoRun (void)
+{
+  std::vector<double> freqs;
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      freqs.push_back (28e9 + i * 1e6);
+    }
+  m_model = Create<SpectrumModel> (freqs);
+  m_noise = CreatePsd (1e-3, 1e-3);
+  m_rx1 = CreatePsd (5e-2, 1e-2);
+  m_a = CreatePsd (4e-3, -1e-3);
+  m_b = CreatePsd (2e-3, 0);
+  m_c = CreatePsd (5e-4, 5e-4);
+  m_d = CreatePsd (1e-3, 0);
+  m_rx2 = CreatePsd (3e-2, -5e-3);
+  m_e = CreatePsd (2e-3, 1e-3);
+  m_rx3 = CreatePsd (1e-2, 1e-2);
+  m_f = CreatePsd (3e-3, -5e-4);
+
+  Ptr<mmWaveInterference> interference[2];
+  for (uint32_t mode = 0; mode < 2; mode++)
+    {
+      interference[mode] = CreateObject<mmWaveInterference> ();
+      interference[mode]->SetAttribute ("SlotAccumulator", BooleanValue (mode == 0));
+      Ptr<mmWaveChunkProcessor> processor = Create<mmWaveChunkProcessor> ();
+      if (mode == 0)
+        {
+          processor->AddCallback (MakeCallback (&MmwaveInterferenceAccumulatorTestCase::ReportSinrAccumulator, this));
+        }
+      else
+        {
+          processor->AddCallback (MakeCallback (&MmwaveInterferenceAccumulatorTestCase::ReportSinrPerSignal, this));
+        }
+      interference[mode]->AddSinrChunkProcessor (processor);
+      interference[mode]->SetNoisePowerSpectralDensity (m_noise);
+
+      Simulator::Schedule (MicroSeconds (0), &MmwaveInterferenceAccumulatorTestCase::StartFirstRx, this, interference[mode]);
+      Simulator::Schedule (MicroSeconds (2), &MmwaveInterferenceAccumulatorTestCase::AddInterferer, this, interference[mode]);
+      Simulator::Schedule (MicroSeconds (5), &MmwaveInterferenceAccumulatorTestCase::StartSecondRx, this, interference[mode]);
+      Simulator::Schedule (MicroSeconds (10), &MmwaveInterferenceAccumulatorTestCase::StartThirdRx, this, interference[mode]);
+    }
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_sinrAccumulator.size (), 3, "one SINR per rx with SlotAccumulator");
+  NS_TEST_ASSERT_MSG_EQ (m_sinrPerSignal.size (), 3, "one SINR per rx without SlotAccumulator");
+  for (uint32_t i = 0; i < m_model->GetNumBands (); i++)
+    {
+      double noise = (*m_noise)[i];
+      // the interferers A, B and C for 2 us, then also D for 2 us
+      double interf1 = (*m_a)[i] + (*m_b)[i] + (*m_c)[i];
+      double expected[3];
+      expected[0] = 0.5 * (*m_rx1)[i] / (interf1 + noise) + 0.5 * (*m_rx1)[i] / (interf1 + (*m_d)[i] + noise);
+      // C and D are dropped by the reset, E ends after 2 us
+      expected[1] = 0.5 * (*m_rx2)[i] / ((*m_e)[i] + noise) + 0.5 * (*m_rx2)[i] / noise;
+      // F ends after 1 us
+      expected[2] = 0.5 * (*m_rx3)[i] / ((*m_f)[i] + noise) + 0.5 * (*m_rx3)[i] / noise;
+      for (uint32_t rx = 0; rx < 3; rx++)
+        {
+          NS_TEST_ASSERT_MSG_EQ_TOL (m_sinrAccumulator[rx][i], expected[rx], expected[rx] * 1e-9,
+                                     "SINR of rx " << rx << " band " << i << " with SlotAccumulator");
+          NS_TEST_ASSERT_MSG_EQ_TOL (m_sinrPerSignal[rx][i], expected[rx], expected[rx] * 1e-9,
+                                     "SINR of rx " << rx << " band " << i << " without SlotAccumulator");
+          NS_TEST_ASSERT_MSG_EQ_TOL (m_sinrAccumulator[rx][i], m_sinrPerSignal[rx][i], expected[rx] * 1e-12,
+                                     "SINR of rx " << rx << " band " << i << " differs between the modes");
+        }
+    }
+
+  interference[0]->Dispose ();
+  interference[1]->Dispose ();
+  Simulator::Destroy ();
+}
+
 // The TestSuite class names the TestSuite, identifies what type of TestSuite,
 // and enables the TestCases to be run.  Typically, only the constructor for
 // this class must be defined
@@ -87,6 +989,16 @@ MmwaveTestSuite::MmwaveTestSuite ()
 {
   // TestDuration for TestCase can be QUICK, EXTENSIVE or TAKES_FOREVER
   AddTestCase (new MmwaveTestCase1, TestCase::QUICK);
+  AddTestCase (new MmwaveMaxRateSchedulerTestCase, TestCase::QUICK);
+  AddTestCase (new MmwaveSchedulerAttributesTestCase, TestCase::QUICK);
+  AddTestCase (new MmwaveStaticLinkChannelUpdateTestCase (false), TestCase::QUICK);
+  AddTestCase (new MmwaveStaticLinkChannelUpdateTestCase (true), TestCase::QUICK);
+  AddTestCase (new MmwaveBeamSearchTestCase (MmWave3gppChannel::EXHAUSTIVE_BEAM_SEARCH), TestCase::QUICK);
+  AddTestCase (new MmwaveBeamSearchTestCase (MmWave3gppChannel::HIERARCHICAL_BEAM_SEARCH), TestCase::QUICK);
+  AddTestCase (new MmwaveAmcMcsTestCase (false), TestCase::QUICK);
+  AddTestCase (new MmwaveAmcMcsTestCase (true), TestCase::QUICK);
+  AddTestCase (new Mmwave3gppTableTestCase, TestCase::QUICK);
+  AddTestCase (new MmwaveInterferenceAccumulatorTestCase, TestCase::QUICK);
 }
 
 // Do not forget to allocate an instance of this TestSuite
@@ -0,0 +1,824 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "threaded-simulator-impl.h"
+
+#include "ns3/simulator.h"
+#include "ns3/scheduler.h"
+#include "ns3/event-impl.h"
+#include "ns3/channel.h"
+#include "ns3/net-device.h"
+#include "ns3/node.h"
+#include "ns3/node-list.h"
+#include "ns3/ptr.h"
+#include "ns3/assert.h"
+#include "ns3/log.h"
+#include "ns3/core-config.h"
+
+#include <algorithm>
+#include <map>
+#include <thread>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("ThreadedSimulatorImpl");
+
+NS_OBJECT_ENSURE_REGISTERED (ThreadedSimulatorImpl);
+
+/**
+ * Single producer, single consumer queue, as a linked list starting with
+ * a dummy node: the producer only writes the tail, the consumer only
+ * writes the head.
+ */
+class ThreadedSimulatorImpl::EventQueue
+{
+public:
+  EventQueue ()
+  {
+    m_head = new Node;
+    m_head->next.store (0, std::memory_order_relaxed);
+    m_tail = m_head;
+  }
+  ~EventQueue ()
+  {
+    while (m_head != 0)
+      {
+        Node *next = m_head->next.load (std::memory_order_relaxed);
+        delete m_head;
+        m_head = next;
+      }
+  }
+  /**
+   * \brief Append an event, from the thread of the sender
+   * \param ev the event
+   */
+  void Push (const Scheduler::Event &ev)
+  {
+    Node *node = new Node;
+    node->ev = ev;
+    node->next.store (0, std::memory_order_relaxed);
+    m_tail->next.store (node, std::memory_order_release);
+    m_tail = node;
+  }
+  /**
+   * \brief Remove the first event, from the thread of the receiver
+   * \param [out] ev the event
+   * \return false if the queue is empty
+   */
+  bool Pop (Scheduler::Event &ev)
+  {
+    Node *next = m_head->next.load (std::memory_order_acquire);
+    if (next == 0)
+      {
+        return false;
+      }
+    ev = next->ev;
+    delete m_head;
+    m_head = next;
+    return true;
+  }
+
+private:
+  /** Node of the list */
+  struct Node
+  {
+    Scheduler::Event ev;            //!< The event, unused in the dummy node
+    std::atomic<Node *> next;       //!< The next node
+  };
+  Node *m_head;                     //!< Dummy node, before the first event
+  Node *m_tail;                     //!< Last node
+};
+
+/**
+ * The state of the simulator for one logical process: its events and its
+ * own clock. Only the thread of the logical process uses it while the
+ * window is processed.
+ */
+struct ThreadedSimulatorImpl::LogicalProcess
+{
+  uint32_t m_index;                 //!< Index in the LPs, their count for the global LP
+  uint32_t m_systemId;              //!< System id of the nodes
+  ThreadedSimulatorImpl *m_impl;    //!< The simulator
+  Ptr<Scheduler> m_events;          //!< The events of the nodes
+  uint64_t m_currentTs;             //!< Timestamp of the current event
+  uint32_t m_currentContext;        //!< Context of the current event
+  uint32_t m_currentUid;            //!< Uid of the current event
+  uint32_t m_uid;                   //!< Next uid
+  int m_unscheduledEvents;          //!< Number of events in m_events
+  bool m_stop;                      //!< True if Stop was called
+  uint64_t m_nextTs;                //!< Timestamp of the next event, at the end of the window
+  uint64_t m_minSent;               //!< Smallest timestamp sent to other LPs in the window
+  uint32_t m_lastWindow;            //!< Last window started by the thread
+};
+
+thread_local ThreadedSimulatorImpl::LogicalProcess *ThreadedSimulatorImpl::m_currentLp = 0;
+
+/** Largest timestamp, for the logical processes without events. */
+static const uint64_t MAX_TS = 0x7fffffffffffffffULL;
+
+TypeId
+ThreadedSimulatorImpl::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::ThreadedSimulatorImpl")
+    .SetParent<SimulatorImpl> ()
+    .SetGroupName ("Mpi")
+    .AddConstructor<ThreadedSimulatorImpl> ()
+  ;
+  return tid;
+}
+
+ThreadedSimulatorImpl::ThreadedSimulatorImpl ()
+  : m_partitioned (false),
+    m_running (false),
+    m_lookAhead (MAX_TS),
+    m_windowEnd (0),
+    m_window (0),
+    m_pending (0),
+    m_exit (false)
+{
+  NS_LOG_FUNCTION (this);
+
+  m_global = new LogicalProcess;
+  m_global->m_index = 0;
+  m_global->m_systemId = 0;
+  m_global->m_impl = this;
+  // uids are allocated from 4.
+  // uid 0 is "invalid" events
+  // uid 1 is "now" events
+  // uid 2 is "destroy" events
+  m_global->m_uid = 4;
+  // before ::Run is entered, the m_currentUid will be zero
+  m_global->m_currentUid = 0;
+  m_global->m_currentTs = 0;
+  m_global->m_currentContext = Simulator::NO_CONTEXT;
+  m_global->m_unscheduledEvents = 0;
+  m_global->m_stop = false;
+  m_global->m_nextTs = MAX_TS;
+  m_global->m_minSent = MAX_TS;
+  m_global->m_lastWindow = 0;
+}
+
+ThreadedSimulatorImpl::~ThreadedSimulatorImpl ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+ThreadedSimulatorImpl::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  std::vector<LogicalProcess *> lps = m_lps;
+  lps.push_back (m_global);
+  if (m_partitioned)
+    {
+      for (std::vector<LogicalProcess *>::iterator i = lps.begin (); i != lps.end (); ++i)
+        {
+          ReceiveEvents (*i);
+        }
+    }
+  for (std::vector<LogicalProcess *>::iterator i = lps.begin (); i != lps.end (); ++i)
+    {
+      LogicalProcess *lp = *i;
+      while (!lp->m_events->IsEmpty ())
+        {
+          Scheduler::Event next = lp->m_events->RemoveNext ();
+          next.impl->Unref ();
+        }
+      lp->m_events = 0;
+      delete lp;
+    }
+  m_lps.clear ();
+  m_global = 0;
+  for (std::vector<EventQueue *>::iterator i = m_queues.begin (); i != m_queues.end (); ++i)
+    {
+      delete *i;
+    }
+  m_queues.clear ();
+  SimulatorImpl::DoDispose ();
+}
+
+void
+ThreadedSimulatorImpl::Destroy ()
+{
+  NS_LOG_FUNCTION (this);
+
+  while (!m_destroyEvents.empty ())
+    {
+      Ptr<EventImpl> ev = m_destroyEvents.front ().PeekEventImpl ();
+      m_destroyEvents.pop_front ();
+      NS_LOG_LOGIC ("handle destroy " << ev);
+      if (!ev->IsCancelled ())
+        {
+          ev->Invoke ();
+        }
+    }
+}
+
+void
+ThreadedSimulatorImpl::SetScheduler (ObjectFactory schedulerFactory)
+{
+  NS_LOG_FUNCTION (this << schedulerFactory);
+
+  m_schedulerFactory = schedulerFactory;
+  std::vector<LogicalProcess *> lps = m_lps;
+  lps.push_back (m_global);
+  for (std::vector<LogicalProcess *>::iterator i = lps.begin (); i != lps.end (); ++i)
+    {
+      LogicalProcess *lp = *i;
+      Ptr<Scheduler> scheduler = schedulerFactory.Create<Scheduler> ();
+      if (lp->m_events != 0)
+        {
+          while (!lp->m_events->IsEmpty ())
+            {
+              Scheduler::Event next = lp->m_events->RemoveNext ();
+              scheduler->Insert (next);
+            }
+        }
+      lp->m_events = scheduler;
+    }
+}
+
+uint32_t
+ThreadedSimulatorImpl::GetSystemId (void) const
+{
+  return GetCurrentLp ()->m_systemId;
+}
+
+uint32_t
+ThreadedSimulatorImpl::GetLpCount (void) const
+{
+  return m_lps.size ();
+}
+
+Time
+ThreadedSimulatorImpl::GetLookAhead (void) const
+{
+  return TimeStep (m_lookAhead);
+}
+
+void
+ThreadedSimulatorImpl::Partition (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  // One LP per system id, in increasing order
+  std::map<uint32_t, uint32_t> systemIds;
+  for (NodeList::Iterator i = NodeList::Begin (); i != NodeList::End (); ++i)
+    {
+      systemIds[(*i)->GetSystemId ()] = 0;
+    }
+  for (std::map<uint32_t, uint32_t>::iterator i = systemIds.begin (); i != systemIds.end (); ++i)
+    {
+      LogicalProcess *lp = new LogicalProcess;
+      i->second = m_lps.size ();
+      lp->m_index = m_lps.size ();
+      lp->m_systemId = i->first;
+      lp->m_impl = this;
+      lp->m_events = m_schedulerFactory.Create<Scheduler> ();
+      // The uids stay unique in the context of the events moved below
+      lp->m_uid = m_global->m_uid;
+      lp->m_currentUid = 0;
+      lp->m_currentTs = m_global->m_currentTs;
+      lp->m_currentContext = Simulator::NO_CONTEXT;
+      lp->m_unscheduledEvents = 0;
+      lp->m_stop = false;
+      lp->m_nextTs = MAX_TS;
+      lp->m_minSent = MAX_TS;
+      lp->m_lastWindow = 0;
+      m_lps.push_back (lp);
+    }
+  m_global->m_index = m_lps.size ();
+
+  for (NodeList::Iterator i = NodeList::Begin (); i != NodeList::End (); ++i)
+    {
+      m_nodeLp.push_back (systemIds[(*i)->GetSystemId ()]);
+    }
+
+  // Queues from each LP to each LP and to the global LP
+  for (uint32_t i = 0; i < m_lps.size () * (m_lps.size () + 1); ++i)
+    {
+      m_queues.push_back (new EventQueue);
+    }
+
+  m_partitioned = true;
+
+  // Move the events of the nodes, keeping their keys
+  Ptr<Scheduler> global = m_schedulerFactory.Create<Scheduler> ();
+  while (!m_global->m_events->IsEmpty ())
+    {
+      Scheduler::Event next = m_global->m_events->RemoveNext ();
+      LogicalProcess *lp = GetLp (next.key.m_context);
+      if (lp == m_global)
+        {
+          global->Insert (next);
+        }
+      else
+        {
+          lp->m_events->Insert (next);
+          lp->m_unscheduledEvents++;
+          m_global->m_unscheduledEvents--;
+        }
+    }
+  m_global->m_events = global;
+
+  CalculateLookAhead ();
+
+  NS_LOG_INFO (m_lps.size () << " logical processes, lookahead " << GetLookAhead ());
+}
+
+void
+ThreadedSimulatorImpl::CalculateLookAhead (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  m_lookAhead = MAX_TS;
+  for (NodeList::Iterator i = NodeList::Begin (); i != NodeList::End (); ++i)
+    {
+      Ptr<Node> node = *i;
+      for (uint32_t j = 0; j < node->GetNDevices (); ++j)
+        {
+          Ptr<NetDevice> localNetDevice = node->GetDevice (j);
+          Ptr<Channel> channel = localNetDevice->GetChannel ();
+          if (channel == 0)
+            {
+              continue;
+            }
+
+          bool remote = false;
+          for (uint32_t k = 0; k < channel->GetNDevices (); ++k)
+            {
+              Ptr<Node> remoteNode = channel->GetDevice (k)->GetNode ();
+              if (m_nodeLp[remoteNode->GetId ()] != m_nodeLp[node->GetId ()])
+                {
+                  remote = true;
+                }
+            }
+          if (!remote)
+            {
+              continue;
+            }
+
+#ifndef ENABLE_THREADED_SIMULATOR
+          // the packets sent between the threads need the thread-safe buffers
+          NS_FATAL_ERROR ("Channel of node " << node->GetId () << " device " << j <<
+                          " between logical processes requires --enable-threaded-simulator");
+#endif
+
+          // The delay of the channel is the lookahead of the link
+          TimeValue delay;
+          if (!localNetDevice->IsPointToPoint ()
+              || !channel->GetAttributeFailSafe ("Delay", delay))
+            {
+              NS_FATAL_ERROR ("Channel of node " << node->GetId () << " device " << j <<
+                              " between logical processes is not a point-to-point channel with a delay");
+            }
+          if (!delay.Get ().IsStrictlyPositive ())
+            {
+              NS_FATAL_ERROR ("Channel of node " << node->GetId () << " device " << j <<
+                              " between logical processes has no delay");
+            }
+          m_lookAhead = std::min<uint64_t> (m_lookAhead, delay.Get ().GetTimeStep ());
+        }
+    }
+}
+
+ThreadedSimulatorImpl::LogicalProcess *
+ThreadedSimulatorImpl::GetLp (uint32_t context) const
+{
+  if (!m_partitioned || context >= m_nodeLp.size ())
+    {
+      return m_global;
+    }
+  return m_lps[m_nodeLp[context]];
+}
+
+ThreadedSimulatorImpl::LogicalProcess *
+ThreadedSimulatorImpl::GetCurrentLp (void) const
+{
+  if (m_currentLp == 0)
+    {
+      return m_global;
+    }
+  return m_currentLp;
+}
+
+ThreadedSimulatorImpl::EventQueue *
+ThreadedSimulatorImpl::GetQueue (const LogicalProcess *src, const LogicalProcess *dst) const
+{
+  NS_ASSERT (src != m_global);
+  return m_queues[src->m_index * (m_lps.size () + 1) + dst->m_index];
+}
+
+Scheduler::Event
+ThreadedSimulatorImpl::Insert (LogicalProcess *lp, Scheduler::Event ev)
+{
+  ev.key.m_uid = lp->m_uid;
+  lp->m_uid++;
+  lp->m_unscheduledEvents++;
+  lp->m_events->Insert (ev);
+  return ev;
+}
+
+void
+ThreadedSimulatorImpl::ReceiveEvents (LogicalProcess *lp)
+{
+  for (std::vector<LogicalProcess *>::iterator i = m_lps.begin (); i != m_lps.end (); ++i)
+    {
+      if (*i == lp)
+        {
+          continue;
+        }
+      EventQueue *queue = GetQueue (*i, lp);
+      Scheduler::Event ev;
+      while (queue->Pop (ev))
+        {
+          Insert (lp, ev);
+        }
+    }
+}
+
+uint64_t
+ThreadedSimulatorImpl::NextTs (const LogicalProcess *lp) const
+{
+  if (lp->m_events->IsEmpty ())
+    {
+      return MAX_TS;
+    }
+  return lp->m_events->PeekNext ().key.m_ts;
+}
+
+void
+ThreadedSimulatorImpl::ProcessOneEvent (LogicalProcess *lp)
+{
+  Scheduler::Event next = lp->m_events->RemoveNext ();
+
+  NS_ASSERT (next.key.m_ts >= lp->m_currentTs);
+  lp->m_unscheduledEvents--;
+
+  NS_LOG_LOGIC ("handle " << next.key.m_ts);
+  lp->m_currentTs = next.key.m_ts;
+  lp->m_currentContext = next.key.m_context;
+  lp->m_currentUid = next.key.m_uid;
+  next.impl->Invoke ();
+  next.impl->Unref ();
+}
+
+void
+ThreadedSimulatorImpl::ProcessWindow (LogicalProcess *lp)
+{
+  ReceiveEvents (lp);
+  lp->m_minSent = MAX_TS;
+  while (!lp->m_events->IsEmpty () && !lp->m_stop
+         && lp->m_events->PeekNext ().key.m_ts < m_windowEnd)
+    {
+      ProcessOneEvent (lp);
+    }
+  lp->m_nextTs = NextTs (lp);
+}
+
+void
+ThreadedSimulatorImpl::LpThread (LogicalProcess *lp)
+{
+  ThreadedSimulatorImpl *impl = lp->m_impl;
+  m_currentLp = lp;
+  for (;;)
+    {
+      uint32_t window;
+      while ((window = impl->m_window.load (std::memory_order_acquire)) == lp->m_lastWindow)
+        {
+          std::this_thread::yield ();
+        }
+      lp->m_lastWindow = window;
+      if (impl->m_exit)
+        {
+          break;
+        }
+      impl->ProcessWindow (lp);
+      impl->m_pending.fetch_sub (1, std::memory_order_release);
+    }
+  m_currentLp = 0;
+}
+
+bool
+ThreadedSimulatorImpl::IsFinished (void) const
+{
+  bool empty = m_global->m_events->IsEmpty ();
+  bool stop = m_global->m_stop;
+  for (std::vector<LogicalProcess *>::const_iterator i = m_lps.begin (); i != m_lps.end (); ++i)
+    {
+      empty = empty && (*i)->m_events->IsEmpty () && (*i)->m_minSent == MAX_TS;
+      stop = stop || (*i)->m_stop;
+    }
+  return empty || stop;
+}
+
+void
+ThreadedSimulatorImpl::Run (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  if (!m_partitioned)
+    {
+      Partition ();
+    }
+  m_global->m_stop = false;
+  for (std::vector<LogicalProcess *>::iterator i = m_lps.begin (); i != m_lps.end (); ++i)
+    {
+      (*i)->m_stop = false;
+      (*i)->m_nextTs = NextTs (*i);
+    }
+
+  // The calling thread runs the first LP, and the global events
+  m_running = true;
+  m_exit = false;
+  std::vector<Ptr<SystemThread> > threads;
+  for (uint32_t i = 1; i < m_lps.size (); ++i)
+    {
+      m_lps[i]->m_lastWindow = m_window.load (std::memory_order_relaxed);
+      threads.push_back (Create<SystemThread> (MakeBoundCallback (&ThreadedSimulatorImpl::LpThread, m_lps[i])));
+      threads.back ()->Start ();
+    }
+
+  for (;;)
+    {
+      ReceiveEvents (m_global);
+
+      // Lower bound on the timestamps of the events of the LPs
+      uint64_t lbts = MAX_TS;
+      bool stop = m_global->m_stop;
+      for (std::vector<LogicalProcess *>::iterator i = m_lps.begin (); i != m_lps.end (); ++i)
+        {
+          lbts = std::min (lbts, std::min ((*i)->m_nextTs, (*i)->m_minSent));
+          stop = stop || (*i)->m_stop;
+        }
+      uint64_t globalTs = NextTs (m_global);
+      if (stop || (lbts == MAX_TS && globalTs == MAX_TS))
+        {
+          break;
+        }
+
+      if (globalTs <= lbts)
+        {
+          // The global events run alone, and may schedule events in any LP
+          for (std::vector<LogicalProcess *>::iterator i = m_lps.begin (); i != m_lps.end (); ++i)
+            {
+              ReceiveEvents (*i);
+              (*i)->m_minSent = MAX_TS;
+            }
+          while (!m_global->m_events->IsEmpty () && !m_global->m_stop
+                 && NextTs (m_global) == globalTs)
+            {
+              ProcessOneEvent (m_global);
+            }
+          for (std::vector<LogicalProcess *>::iterator i = m_lps.begin (); i != m_lps.end (); ++i)
+            {
+              (*i)->m_nextTs = NextTs (*i);
+            }
+          continue;
+        }
+
+      // No LP can receive an event earlier than lbts plus the lookahead
+      m_windowEnd = std::min (lbts + m_lookAhead, globalTs);
+      m_pending.store (m_lps.size () - 1, std::memory_order_relaxed);
+      m_window.fetch_add (1, std::memory_order_release);
+      m_currentLp = m_lps[0];
+      ProcessWindow (m_lps[0]);
+      m_currentLp = 0;
+      while (m_pending.load (std::memory_order_acquire) != 0)
+        {
+          std::this_thread::yield ();
+        }
+    }
+
+  m_exit = true;
+  m_window.fetch_add (1, std::memory_order_release);
+  for (std::vector<Ptr<SystemThread> >::iterator i = threads.begin (); i != threads.end (); ++i)
+    {
+      (*i)->Join ();
+    }
+  m_running = false;
+  m_windowEnd = 0;
+
+  // The main program continues at the latest time of the LPs
+  for (std::vector<LogicalProcess *>::iterator i = m_lps.begin (); i != m_lps.end (); ++i)
+    {
+      m_global->m_currentTs = std::max (m_global->m_currentTs, (*i)->m_currentTs);
+    }
+}
+
+void
+ThreadedSimulatorImpl::Stop (void)
+{
+  NS_LOG_FUNCTION (this);
+  GetCurrentLp ()->m_stop = true;
+}
+
+void
+ThreadedSimulatorImpl::Stop (Time const &delay)
+{
+  NS_LOG_FUNCTION (this << delay.GetTimeStep ());
+  Simulator::Schedule (delay, &Simulator::Stop);
+}
+
+EventId
+ThreadedSimulatorImpl::Schedule (Time const &delay, EventImpl *event)
+{
+  NS_LOG_FUNCTION (this << delay.GetTimeStep () << event);
+
+  LogicalProcess *lp = GetCurrentLp ();
+  Time tAbsolute = delay + TimeStep (lp->m_currentTs);
+  NS_ASSERT (tAbsolute.IsPositive ());
+  NS_ASSERT (tAbsolute >= TimeStep (lp->m_currentTs));
+
+  Scheduler::Event ev;
+  ev.impl = event;
+  ev.key.m_ts = (uint64_t) tAbsolute.GetTimeStep ();
+  ev.key.m_context = lp->m_currentContext;
+  ev = Insert (lp, ev);
+  return EventId (event, ev.key.m_ts, ev.key.m_context, ev.key.m_uid);
+}
+
+void
+ThreadedSimulatorImpl::ScheduleWithContext (uint32_t context, Time const &delay, EventImpl *event)
+{
+  NS_LOG_FUNCTION (this << context << delay.GetTimeStep () << event);
+
+  LogicalProcess *src = GetCurrentLp ();
+  LogicalProcess *dst = GetLp (context);
+  Time tAbsolute = delay + TimeStep (src->m_currentTs);
+
+  Scheduler::Event ev;
+  ev.impl = event;
+  ev.key.m_ts = (uint64_t) tAbsolute.GetTimeStep ();
+  ev.key.m_context = context;
+
+  if (!m_running || src == dst || src == m_global)
+    {
+      // The other LPs do not run
+      Insert (dst, ev);
+      return;
+    }
+
+  if (ev.key.m_ts < m_windowEnd)
+    {
+      NS_FATAL_ERROR ("Event for context " << context << " at " << tAbsolute <<
+                      " scheduled by another logical process within the lookahead " <<
+                      GetLookAhead ());
+    }
+  // The uid is allocated by the receiver
+  GetQueue (src, dst)->Push (ev);
+  src->m_minSent = std::min (src->m_minSent, ev.key.m_ts);
+}
+
+EventId
+ThreadedSimulatorImpl::ScheduleNow (EventImpl *event)
+{
+  LogicalProcess *lp = GetCurrentLp ();
+  Scheduler::Event ev;
+  ev.impl = event;
+  ev.key.m_ts = lp->m_currentTs;
+  ev.key.m_context = lp->m_currentContext;
+  ev = Insert (lp, ev);
+  return EventId (event, ev.key.m_ts, ev.key.m_context, ev.key.m_uid);
+}
+
+EventId
+ThreadedSimulatorImpl::ScheduleDestroy (EventImpl *event)
+{
+  EventId id (Ptr<EventImpl> (event, false), GetCurrentLp ()->m_currentTs, 0xffffffff, 2);
+  CriticalSection cs (m_destroyEventsMutex);
+  m_destroyEvents.push_back (id);
+  return id;
+}
+
+Time
+ThreadedSimulatorImpl::Now (void) const
+{
+  // Do not add function logging here, to avoid stack overflow
+  return TimeStep (GetCurrentLp ()->m_currentTs);
+}
+
+Time
+ThreadedSimulatorImpl::GetDelayLeft (const EventId &id) const
+{
+  if (IsExpired (id))
+    {
+      return TimeStep (0);
+    }
+  else
+    {
+      return TimeStep (id.GetTs () - GetCurrentLp ()->m_currentTs);
+    }
+}
+
+void
+ThreadedSimulatorImpl::Remove (const EventId &id)
+{
+  if (id.GetUid () == 2)
+    {
+      // destroy events.
+      CriticalSection cs (m_destroyEventsMutex);
+      for (DestroyEvents::iterator i = m_destroyEvents.begin (); i != m_destroyEvents.end (); i++)
+        {
+          if (*i == id)
+            {
+              m_destroyEvents.erase (i);
+              break;
+            }
+        }
+      return;
+    }
+  if (IsExpired (id))
+    {
+      return;
+    }
+  // Only the LP of the event may remove it
+  LogicalProcess *lp = GetLp (id.GetContext ());
+  NS_ASSERT (!m_running || lp == GetCurrentLp () || GetCurrentLp () == m_global);
+  Scheduler::Event event;
+  event.impl = id.PeekEventImpl ();
+  event.key.m_ts = id.GetTs ();
+  event.key.m_context = id.GetContext ();
+  event.key.m_uid = id.GetUid ();
+  lp->m_events->Remove (event);
+  event.impl->Cancel ();
+  // whenever we remove an event from the event list, we have to unref it.
+  event.impl->Unref ();
+
+  lp->m_unscheduledEvents--;
+}
+
+void
+ThreadedSimulatorImpl::Cancel (const EventId &id)
+{
+  if (!IsExpired (id))
+    {
+      id.PeekEventImpl ()->Cancel ();
+    }
+}
+
+bool
+ThreadedSimulatorImpl::IsExpired (const EventId &id) const
+{
+  if (id.GetUid () == 2)
+    {
+      if (id.PeekEventImpl () == 0 ||
+          id.PeekEventImpl ()->IsCancelled ())
+        {
+          return true;
+        }
+      // destroy events.
+      CriticalSection cs (m_destroyEventsMutex);
+      for (DestroyEvents::const_iterator i = m_destroyEvents.begin (); i != m_destroyEvents.end (); i++)
+        {
+          if (*i == id)
+            {
+              return false;
+            }
+        }
+      return true;
+    }
+  // Compare to the clock of the LP of the event
+  const LogicalProcess *lp = GetLp (id.GetContext ());
+  if (id.PeekEventImpl () == 0 ||
+      id.GetTs () < lp->m_currentTs ||
+      (id.GetTs () == lp->m_currentTs &&
+       id.GetUid () <= lp->m_currentUid) ||
+      id.PeekEventImpl ()->IsCancelled ())
+    {
+      return true;
+    }
+  else
+    {
+      return false;
+    }
+}
+
+Time
+ThreadedSimulatorImpl::GetMaximumSimulationTime (void) const
+{
+  return TimeStep (MAX_TS);
+}
+
+uint32_t
+ThreadedSimulatorImpl::GetContext (void) const
+{
+  return GetCurrentLp ()->m_currentContext;
+}
+
+} // namespace ns3
@@ -0,0 +1,220 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef NS3_THREADED_SIMULATOR_IMPL_H
+#define NS3_THREADED_SIMULATOR_IMPL_H
+
+#include "ns3/simulator-impl.h"
+#include "ns3/scheduler.h"
+#include "ns3/event-impl.h"
+#include "ns3/system-thread.h"
+#include "ns3/system-mutex.h"
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+
+#include <atomic>
+#include <list>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup simulator
+ * \ingroup mpi
+ *
+ * \brief Parallel simulator implementation running the logical processes
+ * in the threads of a single process
+ *
+ * The nodes are partitioned into logical processes (LPs) by their system
+ * id, as with DistributedSimulatorImpl: the nodes created with system id
+ * \c i run in the \c i-th LP, in increasing order of the ids used. The
+ * events are dispatched to the LPs by their context, i.e., by node id.
+ * Each LP has its own Scheduler and runs in its own thread; the thread
+ * calling Simulator::Run runs the first LP.
+ *
+ * The LPs synchronize conservatively, in windows: all the LPs process
+ * their events earlier than the smallest next event timestamp plus the
+ * lookahead, then wait for each other. The lookahead is the smallest delay
+ * of the point-to-point channels between nodes of different LPs; other
+ * channels may not cross LPs. An event scheduled for another LP goes
+ * through a lock-free queue specific to the pair of LPs, and is inserted
+ * in the Scheduler of the receiver at the start of the next window. An
+ * event scheduled for another LP within the current window is a fatal
+ * error.
+ *
+ * The events without a node context (e.g., scheduled by the main program
+ * with Simulator::Schedule) are global: they run in the thread calling
+ * Simulator::Run while the LPs wait, after all the events with a smaller
+ * timestamp, and may access any node. Simulator::Stop called by an LP
+ * ends the simulation at the end of the window.
+ *
+ * The models may only interact across LPs through the channels: the
+ * objects of a node are only used by the thread of its LP. The channels
+ * between LPs require ns-3 to be configured with
+ * --enable-threaded-simulator, which makes the reference counts and the
+ * packet buffers thread-safe.
+ */
+class ThreadedSimulatorImpl : public SimulatorImpl
+{
+public:
+  /**
+   *  Register this type.
+   *  \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  ThreadedSimulatorImpl ();
+  ~ThreadedSimulatorImpl ();
+
+  // virtual from SimulatorImpl
+  virtual void Destroy ();
+  virtual bool IsFinished (void) const;
+  virtual void Stop (void);
+  virtual void Stop (Time const &delay);
+  virtual EventId Schedule (Time const &delay, EventImpl *event);
+  virtual void ScheduleWithContext (uint32_t context, Time const &delay, EventImpl *event);
+  virtual EventId ScheduleNow (EventImpl *event);
+  virtual EventId ScheduleDestroy (EventImpl *event);
+  virtual void Remove (const EventId &id);
+  virtual void Cancel (const EventId &id);
+  virtual bool IsExpired (const EventId &id) const;
+  virtual void Run (void);
+  virtual Time Now (void) const;
+  virtual Time GetDelayLeft (const EventId &id) const;
+  virtual Time GetMaximumSimulationTime (void) const;
+  virtual void SetScheduler (ObjectFactory schedulerFactory);
+  virtual uint32_t GetSystemId (void) const;
+  virtual uint32_t GetContext (void) const;
+
+  /**
+   * \brief Get the number of logical processes
+   *
+   * The nodes are partitioned by the first call to Run.
+   *
+   * \return the number of logical processes, 0 before the partitioning
+   */
+  uint32_t GetLpCount (void) const;
+
+  /**
+   * \brief Get the lookahead of the synchronization
+   * \return the smallest delay of the channels between logical processes,
+   * the maximum simulation time if there is none
+   */
+  Time GetLookAhead (void) const;
+
+private:
+  virtual void DoDispose (void);
+
+  /**
+   * \brief Lock-free queue of the events sent by one logical process to
+   * another
+   */
+  class EventQueue;
+  /**
+   * \brief State of a logical process
+   */
+  struct LogicalProcess;
+
+  /**
+   * \brief Create the logical processes, and move the events scheduled
+   * before the first Run to them
+   */
+  void Partition (void);
+  /**
+   * \brief Compute the lookahead from the channels between logical processes
+   */
+  void CalculateLookAhead (void);
+  /**
+   * \brief Get the logical process running the events of a context
+   * \param context the context
+   * \return the logical process, m_global for the global events
+   */
+  LogicalProcess * GetLp (uint32_t context) const;
+  /**
+   * \brief Get the logical process of the calling thread
+   * \return the logical process, m_global outside of the LP threads
+   */
+  LogicalProcess * GetCurrentLp (void) const;
+  /**
+   * \brief Get the queue of the events sent by a logical process to another
+   * \param src the sending logical process
+   * \param dst the receiving logical process
+   * \return the queue
+   */
+  EventQueue * GetQueue (const LogicalProcess *src, const LogicalProcess *dst) const;
+  /**
+   * \brief Insert an event in the scheduler of a logical process
+   * \param lp the logical process
+   * \param ev the event, whose uid is allocated by the logical process
+   * \return the event inserted
+   */
+  Scheduler::Event Insert (LogicalProcess *lp, Scheduler::Event ev);
+  /**
+   * \brief Insert the events received by a logical process in its scheduler
+   * \param lp the receiving logical process
+   */
+  void ReceiveEvents (LogicalProcess *lp);
+  /**
+   * \brief Process the next event of a logical process
+   * \param lp the logical process
+   */
+  void ProcessOneEvent (LogicalProcess *lp);
+  /**
+   * \brief Process the events of a logical process earlier than the end of
+   * the window
+   * \param lp the logical process
+   */
+  void ProcessWindow (LogicalProcess *lp);
+  /**
+   * \brief Get the timestamp of the next event of a logical process
+   * \param lp the logical process
+   * \return the timestamp, or the maximum simulation time if none
+   */
+  uint64_t NextTs (const LogicalProcess *lp) const;
+  /**
+   * \brief Body of the threads of the logical processes but the first
+   * \param lp the logical process
+   */
+  static void LpThread (LogicalProcess *lp);
+
+  /** Container type for the events to run at Simulator::Destroy() */
+  typedef std::list<EventId> DestroyEvents;
+  /** The container of events to run at Destroy. */
+  DestroyEvents m_destroyEvents;
+  /** Mutex to control access to the destroy events. */
+  mutable SystemMutex m_destroyEventsMutex;
+
+  ObjectFactory m_schedulerFactory;           //!< Scheduler of the logical processes
+  LogicalProcess *m_global;                   //!< Logical process of the global events
+  std::vector<LogicalProcess *> m_lps;        //!< Logical processes of the nodes
+  std::vector<uint32_t> m_nodeLp;             //!< Logical process of each node
+  std::vector<EventQueue *> m_queues;         //!< Queues between the logical processes
+  bool m_partitioned;                         //!< True once the nodes are partitioned
+  bool m_running;                             //!< True while the logical processes run
+  uint64_t m_lookAhead;                       //!< Lookahead, in time steps
+  uint64_t m_windowEnd;                       //!< End of the current window, excluded
+
+  std::atomic<uint32_t> m_window;             //!< Count of windows, which starts the threads
+  std::atomic<uint32_t> m_pending;            //!< Threads processing the current window
+  bool m_exit;                                //!< True when the threads must return
+
+  static thread_local LogicalProcess *m_currentLp; //!< Logical process of the thread
+};
+
+} // namespace ns3
+
+#endif /* NS3_THREADED_SIMULATOR_IMPL_H */
@@ -0,0 +1,524 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/core-config.h"
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/config.h"
+#include "ns3/string.h"
+#include "ns3/boolean.h"
+#include "ns3/node.h"
+#include "ns3/packet.h"
+#include "ns3/simple-channel.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/threaded-simulator-impl.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup mpi
+ * \defgroup mpi-test mpi module tests
+ */
+
+/**
+ * \ingroup mpi-test
+ * \ingroup tests
+ *
+ * \brief Events of 4 nodes in 4 logical processes that do not interact
+ *
+ * Each node runs a chain of events with its own period, and a global event
+ * counts the events run so far. No packet crosses the logical processes,
+ * so the test does not need --enable-threaded-simulator. The events are
+ * compared to the ones of DefaultSimulatorImpl.
+ */
+class ThreadedSimulatorImplLpTestCase : public TestCase
+{
+public:
+  ThreadedSimulatorImplLpTestCase ();
+
+private:
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+
+  /**
+   * \brief Run the events with a simulator implementation
+   * \param type the simulator implementation
+   * \return the times of the events of each node
+   */
+  std::vector<std::vector<Time> > RunEvents (std::string type);
+  /**
+   * \brief Record an event of a node, and schedule the next one
+   * \param node the node
+   * \param n the number of the event
+   */
+  void Tick (uint32_t node, uint32_t n);
+  /**
+   * \brief Count the events of all the nodes, from a global event
+   */
+  void Snapshot (void);
+
+  bool m_threaded;                          //!< True with ThreadedSimulatorImpl
+  std::vector<std::vector<Time> > m_ticks;  //!< Times of the events of each node
+  std::vector<uint32_t> m_errors;           //!< Wrong context or system id of each node
+  uint32_t m_snapshot;                      //!< Events run at the snapshot
+};
+
+ThreadedSimulatorImplLpTestCase::ThreadedSimulatorImplLpTestCase ()
+  : TestCase ("Events of 4 independent logical processes"),
+    m_threaded (false),
+    m_snapshot (0)
+{
+}
+
+void
+ThreadedSimulatorImplLpTestCase::Tick (uint32_t node, uint32_t n)
+{
+  if (Simulator::GetContext () != node
+      || (m_threaded && Simulator::GetSystemId () != node))
+    {
+      m_errors[node]++;
+    }
+  m_ticks[node].push_back (Simulator::Now ());
+  if (n < 20)
+    {
+      Simulator::Schedule (MicroSeconds (10 * (node + 1)), &ThreadedSimulatorImplLpTestCase::Tick,
+                           this, node, n + 1);
+    }
+}
+
+void
+ThreadedSimulatorImplLpTestCase::Snapshot (void)
+{
+  m_snapshot = 0;
+  for (uint32_t i = 0; i < m_ticks.size (); ++i)
+    {
+      m_snapshot += m_ticks[i].size ();
+    }
+}
+
+std::vector<std::vector<Time> >
+ThreadedSimulatorImplLpTestCase::RunEvents (std::string type)
+{
+  Simulator::Destroy ();
+  Config::SetGlobal ("SimulatorImplementationType", StringValue (type));
+  m_threaded = (type == "ns3::ThreadedSimulatorImpl");
+
+  const uint32_t nNodes = 4;
+  m_ticks = std::vector<std::vector<Time> > (nNodes);
+  m_errors = std::vector<uint32_t> (nNodes, 0);
+  m_snapshot = 0;
+
+  std::vector<Ptr<Node> > nodes;
+  for (uint32_t i = 0; i < nNodes; ++i)
+    {
+      nodes.push_back (CreateObject<Node> (i));
+      Simulator::ScheduleWithContext (i, MicroSeconds (i), &ThreadedSimulatorImplLpTestCase::Tick,
+                                      this, i, 0);
+    }
+  Simulator::Schedule (MicroSeconds (105), &ThreadedSimulatorImplLpTestCase::Snapshot, this);
+  Simulator::Run ();
+
+  if (m_threaded)
+    {
+      Ptr<ThreadedSimulatorImpl> impl = DynamicCast<ThreadedSimulatorImpl> (Simulator::GetImplementation ());
+      NS_TEST_EXPECT_MSG_NE (impl, 0, "Wrong simulator implementation");
+      if (impl != 0)
+        {
+          NS_TEST_EXPECT_MSG_EQ (impl->GetLpCount (), 4, "One logical process per system id");
+        }
+    }
+  for (uint32_t i = 0; i < nNodes; ++i)
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_errors[i], 0, "Wrong context or system id in node " << i);
+    }
+
+  Simulator::Destroy ();
+  return m_ticks;
+}
+
+void
+ThreadedSimulatorImplLpTestCase::DoRun (void)
+{
+  std::vector<std::vector<Time> > expected = RunEvents ("ns3::DefaultSimulatorImpl");
+  uint32_t expectedSnapshot = m_snapshot;
+
+  std::vector<std::vector<Time> > ticks = RunEvents ("ns3::ThreadedSimulatorImpl");
+
+  NS_TEST_ASSERT_MSG_GT (expectedSnapshot, 0, "The snapshot should see events");
+  NS_TEST_EXPECT_MSG_EQ (m_snapshot, expectedSnapshot, "Global event saw different events");
+  for (uint32_t i = 0; i < ticks.size (); ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (ticks[i].size (), expected[i].size (), "Node " << i << " ran different events");
+      for (uint32_t j = 0; j < ticks[i].size (); ++j)
+        {
+          NS_TEST_EXPECT_MSG_EQ (ticks[i][j], expected[i][j], "Node " << i << " event " << j);
+        }
+    }
+}
+
+void
+ThreadedSimulatorImplLpTestCase::DoTeardown (void)
+{
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::DefaultSimulatorImpl"));
+}
+
+#ifdef ENABLE_THREADED_SIMULATOR
+/**
+ * \ingroup mpi-test
+ * \ingroup tests
+ *
+ * \brief Packets relayed around a ring of nodes in 4 logical processes
+ *
+ * Two packets go around a ring of 8 nodes, 2 per system id, losing one
+ * byte per hop. The packets received by each node are compared to the ones
+ * of DefaultSimulatorImpl.
+ */
+class ThreadedSimulatorImplRingTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor.
+   * \param stop time of Simulator::Stop, zero to run out of events
+   */
+  ThreadedSimulatorImplRingTestCase (Time stop);
+
+private:
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+
+  /** Packets received by a node, as their time and size */
+  typedef std::vector<std::pair<Time, uint32_t> > RxLog;
+
+  /**
+   * \brief Run the ring with a simulator implementation
+   * \param type the simulator implementation
+   * \return the packets received by each node
+   */
+  std::vector<RxLog> RunRing (std::string type);
+  /**
+   * \brief Receive a packet, and forward it on the next link
+   * \param device the receiving device
+   * \param packet the packet
+   * \param protocol the protocol number
+   * \param from the sender
+   * \return true
+   */
+  bool Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol, const Address &from);
+  /**
+   * \brief Send a packet on the other link of a node
+   * \param device the device the packet was received on
+   * \param packet the packet
+   */
+  void Forward (Ptr<NetDevice> device, Ptr<Packet> packet);
+  /**
+   * \brief Count the watchdogs expired
+   * \param node the node
+   */
+  void Watchdog (uint32_t node);
+  /**
+   * \brief Count the packets received by all the nodes, from a global event
+   */
+  void Snapshot (void);
+
+  Time m_stop;                          //!< Time of Simulator::Stop
+  bool m_threaded;                      //!< True with ThreadedSimulatorImpl
+  std::vector<RxLog> m_rx;              //!< Packets received by each node
+  std::vector<EventId> m_watchdog;      //!< Watchdog of each node
+  std::vector<uint32_t> m_watchdogs;    //!< Expired watchdogs of each node
+  std::vector<uint32_t> m_errors;       //!< Wrong context or system id of each node
+  uint32_t m_snapshot;                  //!< Packets received at the snapshot
+};
+
+ThreadedSimulatorImplRingTestCase::ThreadedSimulatorImplRingTestCase (Time stop)
+  : TestCase (stop.IsZero () ? "Ring of 4 logical processes" : "Ring of 4 logical processes, stopped"),
+    m_stop (stop),
+    m_threaded (false),
+    m_snapshot (0)
+{
+}
+
+bool
+ThreadedSimulatorImplRingTestCase::Receive (Ptr<NetDevice> device, Ptr<const Packet> packet,
+                                            uint16_t protocol, const Address &from)
+{
+  Ptr<Node> node = device->GetNode ();
+  uint32_t id = node->GetId ();
+  if (Simulator::GetContext () != id
+      || (m_threaded && Simulator::GetSystemId () != node->GetSystemId ()))
+    {
+      m_errors[id]++;
+    }
+  m_rx[id].push_back (std::make_pair (Simulator::Now (), packet->GetSize ()));
+
+  Simulator::Remove (m_watchdog[id]);
+  m_watchdog[id] = Simulator::Schedule (Seconds (10), &ThreadedSimulatorImplRingTestCase::Watchdog, this, id);
+
+  if (packet->GetSize () > 1)
+    {
+      Simulator::Schedule (MicroSeconds (7 * (id + 1)), &ThreadedSimulatorImplRingTestCase::Forward,
+                           this, device, packet->CreateFragment (0, packet->GetSize () - 1));
+    }
+  return true;
+}
+
+void
+ThreadedSimulatorImplRingTestCase::Forward (Ptr<NetDevice> device, Ptr<Packet> packet)
+{
+  Ptr<Node> node = device->GetNode ();
+  Ptr<NetDevice> next = node->GetDevice (1 - device->GetIfIndex ());
+  next->Send (packet, next->GetBroadcast (), 0x800);
+}
+
+void
+ThreadedSimulatorImplRingTestCase::Watchdog (uint32_t node)
+{
+  m_watchdogs[node]++;
+}
+
+void
+ThreadedSimulatorImplRingTestCase::Snapshot (void)
+{
+  m_snapshot = 0;
+  for (std::vector<RxLog>::const_iterator i = m_rx.begin (); i != m_rx.end (); ++i)
+    {
+      m_snapshot += i->size ();
+    }
+}
+
+std::vector<ThreadedSimulatorImplRingTestCase::RxLog>
+ThreadedSimulatorImplRingTestCase::RunRing (std::string type)
+{
+  Simulator::Destroy ();
+  Config::SetGlobal ("SimulatorImplementationType", StringValue (type));
+  m_threaded = (type == "ns3::ThreadedSimulatorImpl");
+
+  const uint32_t nNodes = 8;
+  m_rx = std::vector<RxLog> (nNodes);
+  m_watchdog = std::vector<EventId> (nNodes);
+  m_watchdogs = std::vector<uint32_t> (nNodes, 0);
+  m_errors = std::vector<uint32_t> (nNodes, 0);
+  m_snapshot = 0;
+
+  std::vector<Ptr<Node> > nodes;
+  for (uint32_t i = 0; i < nNodes; ++i)
+    {
+      nodes.push_back (CreateObject<Node> (i / 2));
+    }
+  // Device 0 goes to the next node, device 1 to the previous one
+  std::vector<Ptr<SimpleNetDevice> > devices;
+  for (uint32_t i = 0; i < 2 * nNodes; ++i)
+    {
+      Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice> ();
+      device->SetAttribute ("PointToPointMode", BooleanValue (true));
+      device->SetAddress (Mac48Address::Allocate ());
+      nodes[i / 2]->AddDevice (device);
+      device->SetReceiveCallback (MakeCallback (&ThreadedSimulatorImplRingTestCase::Receive, this));
+      devices.push_back (device);
+    }
+  for (uint32_t i = 0; i < nNodes; ++i)
+    {
+      uint32_t next = (i + 1) % nNodes;
+      Ptr<SimpleChannel> channel = CreateObject<SimpleChannel> ();
+      // The links between the logical processes are the slowest ones
+      channel->SetAttribute ("Delay", TimeValue (next % 2 == 0 ? MilliSeconds (2) : MicroSeconds (500)));
+      devices[2 * i]->SetChannel (channel);
+      devices[2 * next + 1]->SetChannel (channel);
+    }
+
+  Simulator::ScheduleWithContext (0, Seconds (0), &ThreadedSimulatorImplRingTestCase::Forward,
+                                  this, devices[1], Create<Packet> (100));
+  Simulator::ScheduleWithContext (5, MicroSeconds (300), &ThreadedSimulatorImplRingTestCase::Forward,
+                                  this, devices[10], Create<Packet> (60));
+  Simulator::Schedule (MicroSeconds (50003), &ThreadedSimulatorImplRingTestCase::Snapshot, this);
+  if (!m_stop.IsZero ())
+    {
+      Simulator::Stop (m_stop);
+    }
+  Simulator::Run ();
+
+  if (m_threaded)
+    {
+      Ptr<ThreadedSimulatorImpl> impl = DynamicCast<ThreadedSimulatorImpl> (Simulator::GetImplementation ());
+      NS_TEST_EXPECT_MSG_NE (impl, 0, "Wrong simulator implementation");
+      if (impl != 0)
+        {
+          NS_TEST_EXPECT_MSG_EQ (impl->GetLpCount (), 4, "One logical process per system id");
+          NS_TEST_EXPECT_MSG_EQ (impl->GetLookAhead (), MilliSeconds (2), "Lookahead is the delay between the LPs");
+        }
+    }
+  if (!m_stop.IsZero ())
+    {
+      NS_TEST_EXPECT_MSG_EQ (Simulator::Now (), m_stop, "Simulator stopped at the wrong time");
+    }
+  for (uint32_t i = 0; i < nNodes; ++i)
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_errors[i], 0, "Wrong context or system id in node " << i);
+      std::sort (m_rx[i].begin (), m_rx[i].end ());
+    }
+
+  Simulator::Destroy ();
+  return m_rx;
+}
+
+void
+ThreadedSimulatorImplRingTestCase::DoRun (void)
+{
+  std::vector<RxLog> expected = RunRing ("ns3::DefaultSimulatorImpl");
+  std::vector<uint32_t> expectedWatchdogs = m_watchdogs;
+  uint32_t expectedSnapshot = m_snapshot;
+
+  std::vector<RxLog> rx = RunRing ("ns3::ThreadedSimulatorImpl");
+
+  NS_TEST_ASSERT_MSG_GT (expectedSnapshot, 0, "The snapshot should see packets");
+  NS_TEST_EXPECT_MSG_EQ (m_snapshot, expectedSnapshot, "Global event saw different packets");
+  for (uint32_t i = 0; i < rx.size (); ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (rx[i].size (), expected[i].size (), "Node " << i << " received different packets");
+      for (uint32_t j = 0; j < rx[i].size (); ++j)
+        {
+          NS_TEST_EXPECT_MSG_EQ (rx[i][j].first, expected[i][j].first, "Node " << i << " packet " << j);
+          NS_TEST_EXPECT_MSG_EQ (rx[i][j].second, expected[i][j].second, "Node " << i << " packet " << j);
+        }
+      NS_TEST_EXPECT_MSG_EQ (m_watchdogs[i], expectedWatchdogs[i], "Node " << i << " watchdogs");
+    }
+}
+
+void
+ThreadedSimulatorImplRingTestCase::DoTeardown (void)
+{
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::DefaultSimulatorImpl"));
+}
+#endif /* ENABLE_THREADED_SIMULATOR */
+
+/**
+ * \ingroup mpi-test
+ * \ingroup tests
+ *
+ * \brief Scheduling API of ThreadedSimulatorImpl without nodes
+ *
+ * All the events are global.
+ */
+class ThreadedSimulatorImplApiTestCase : public TestCase
+{
+public:
+  ThreadedSimulatorImplApiTestCase ();
+
+private:
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+
+  /**
+   * \brief Record an event
+   * \param value the value recorded
+   */
+  void Event (int value);
+
+  std::vector<int> m_events;            //!< Values recorded, in order
+  std::vector<Time> m_times;            //!< Times of the values recorded
+};
+
+ThreadedSimulatorImplApiTestCase::ThreadedSimulatorImplApiTestCase ()
+  : TestCase ("Scheduling API without nodes")
+{
+}
+
+void
+ThreadedSimulatorImplApiTestCase::Event (int value)
+{
+  m_events.push_back (value);
+  m_times.push_back (Simulator::Now ());
+  if (value == 1)
+    {
+      Simulator::ScheduleNow (&ThreadedSimulatorImplApiTestCase::Event, this, 10);
+      Simulator::Schedule (Seconds (0.5), &ThreadedSimulatorImplApiTestCase::Event, this, 11);
+    }
+}
+
+void
+ThreadedSimulatorImplApiTestCase::DoRun (void)
+{
+  Simulator::Destroy ();
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::ThreadedSimulatorImpl"));
+
+  EventId a = Simulator::Schedule (Seconds (1), &ThreadedSimulatorImplApiTestCase::Event, this, 1);
+  EventId b = Simulator::Schedule (Seconds (2), &ThreadedSimulatorImplApiTestCase::Event, this, 2);
+  EventId c = Simulator::Schedule (Seconds (3), &ThreadedSimulatorImplApiTestCase::Event, this, 3);
+  Simulator::Schedule (Seconds (4), &ThreadedSimulatorImplApiTestCase::Event, this, 4);
+  EventId d = Simulator::ScheduleDestroy (&ThreadedSimulatorImplApiTestCase::Event, this, 5);
+
+  NS_TEST_EXPECT_MSG_EQ (Simulator::GetDelayLeft (b), Seconds (2), "Wrong delay left");
+  Simulator::Cancel (b);
+  Simulator::Remove (c);
+  NS_TEST_EXPECT_MSG_EQ (a.IsExpired (), false, "Event a is pending");
+  NS_TEST_EXPECT_MSG_EQ (b.IsExpired (), true, "Event b is cancelled");
+  NS_TEST_EXPECT_MSG_EQ (c.IsExpired (), true, "Event c is removed");
+  NS_TEST_EXPECT_MSG_EQ (d.IsExpired (), false, "Destroy event d is pending");
+
+  Simulator::Stop (Seconds (3.5));
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_EQ (a.IsExpired (), true, "Event a ran");
+  NS_TEST_EXPECT_MSG_EQ (Simulator::Now (), Seconds (3.5), "Stopped at the wrong time");
+
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_EQ (Simulator::IsFinished (), true, "No event is pending");
+  Simulator::Destroy ();
+
+  int events[] = { 1, 10, 11, 4, 5 };
+  double times[] = { 1, 1, 1.5, 4, 4 };
+  NS_TEST_ASSERT_MSG_EQ (m_events.size (), 5, "Wrong number of events");
+  for (uint32_t i = 0; i < m_events.size (); ++i)
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_events[i], events[i], "Wrong event " << i);
+      NS_TEST_EXPECT_MSG_EQ (m_times[i], Seconds (times[i]), "Wrong time of event " << i);
+    }
+}
+
+void
+ThreadedSimulatorImplApiTestCase::DoTeardown (void)
+{
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::DefaultSimulatorImpl"));
+}
+
+/**
+ * \ingroup mpi-test
+ * \ingroup tests
+ *
+ * \brief ThreadedSimulatorImpl TestSuite
+ */
+class ThreadedSimulatorImplTestSuite : public TestSuite
+{
+public:
+  ThreadedSimulatorImplTestSuite ();
+};
+
+ThreadedSimulatorImplTestSuite::ThreadedSimulatorImplTestSuite ()
+  : TestSuite ("threaded-simulator-impl", UNIT)
+{
+  AddTestCase (new ThreadedSimulatorImplApiTestCase, TestCase::QUICK);
+  AddTestCase (new ThreadedSimulatorImplLpTestCase, TestCase::QUICK);
+#ifdef ENABLE_THREADED_SIMULATOR
+  // the packets crossing the logical processes need the thread-safe packets
+  AddTestCase (new ThreadedSimulatorImplRingTestCase (Seconds (0)), TestCase::QUICK);
+  AddTestCase (new ThreadedSimulatorImplRingTestCase (MilliSeconds (100)), TestCase::QUICK);
+#endif
+}
+
+static ThreadedSimulatorImplTestSuite g_threadedSimulatorImplTestSuite; //!< Static variable for test initialization
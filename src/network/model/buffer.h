@@ -24,8 +24,15 @@
 #include <vector>
 #include <ostream>
 #include "ns3/assert.h"
+#include "ns3/core-config.h"
+#ifdef ENABLE_THREADED_SIMULATOR
+#include <atomic>
+#endif
 
+// The free list is shared by all the buffers, whichever thread they live in
+#ifndef ENABLE_THREADED_SIMULATOR
 #define BUFFER_FREE_LIST 1
+#endif
 
 namespace ns3 {
 
@@ -655,6 +662,8 @@ private:
    * New user data can be safely written only outside of the "dirty
    * area" if the reference count is higher than 1 (that is, if
    * more than one Buffer instance references the same BufferData).
+   * With --enable-threaded-simulator, the other instances may be used by
+   * other threads, and new data is never written in shared data.
    */
   struct Data
   {
@@ -662,7 +671,11 @@ private:
      * The reference count of an instance of this data structure.
      * Each buffer which references an instance holds a count.
      */
+#ifdef ENABLE_THREADED_SIMULATOR
+    std::atomic<uint32_t> m_count;
+#else
     uint32_t m_count;
+#endif
     /**
      * the size of the m_data field below.
      */
@@ -766,7 +779,11 @@ private:
    * writing data. i.e., m_start should be initialized to this 
    * value.
    */
+#ifdef ENABLE_THREADED_SIMULATOR
+  static thread_local uint32_t g_recommendedStart;
+#else
   static uint32_t g_recommendedStart;
+#endif
 
   /**
    * offset to the start of the virtual zero area from the start
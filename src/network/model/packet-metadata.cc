@@ -33,8 +33,13 @@ NS_LOG_COMPONENT_DEFINE ("PacketMetadata");
 
 bool PacketMetadata::m_enable = false;
 bool PacketMetadata::m_enableChecking = false;
+#ifdef ENABLE_THREADED_SIMULATOR
+thread_local bool PacketMetadata::m_metadataSkipped = false;
+thread_local uint32_t PacketMetadata::m_maxSize = 0;
+#else
 bool PacketMetadata::m_metadataSkipped = false;
 uint32_t PacketMetadata::m_maxSize = 0;
+#endif
 uint16_t PacketMetadata::m_chunkUid = 0;
 PacketMetadata::DataFreeList PacketMetadata::m_freeList;
 
@@ -77,8 +82,7 @@ PacketMetadata::ReserveCopy (uint32_t size)
   struct PacketMetadata::Data *newData = PacketMetadata::Create (m_used + size);
   memcpy (newData->m_data, m_data->m_data, m_used);
   newData->m_dirtyEnd = m_used;
-  m_data->m_count--;
-  if (m_data->m_count == 0) 
+  if (--m_data->m_count == 0)
     {
       PacketMetadata::Recycle (m_data);
     }
@@ -100,10 +104,7 @@ PacketMetadata::Reserve (uint32_t size)
 {
   NS_LOG_FUNCTION (this << size);
   NS_ASSERT (m_data != 0);
-  if (m_data->m_size >= m_used + size &&
-      (m_head == 0xffff ||
-       m_data->m_count == 1 ||
-       m_data->m_dirtyEnd == m_used))
+  if (m_data->m_size >= m_used + size && !IsDirty ())
     {
       /* enough room, not dirty. */
     }
@@ -371,6 +372,17 @@ PacketMetadata::UpdateHead (uint16_t written)
   m_data->m_dirtyEnd = m_used;
 }
 
+bool
+PacketMetadata::IsDirty (void) const
+{
+#ifdef ENABLE_THREADED_SIMULATOR
+  // The other references may be used by other threads
+  return m_data->m_count != 1;
+#else
+  return m_head != 0xffff && m_data->m_count != 1 && m_used != m_data->m_dirtyEnd;
+#endif
+}
+
 uint16_t
 PacketMetadata::AddSmall (const struct PacketMetadata::SmallItem *item)
 {
@@ -381,9 +393,7 @@ PacketMetadata::AddSmall (const struct PacketMetadata::SmallItem *item)
   uint32_t sizeSize = GetUleb128Size (item->size);
   uint32_t n =  2 + 2 + typeUidSize + sizeSize + 2;
   if (m_used + n > m_data->m_size ||
-      (m_head != 0xffff &&
-       m_data->m_count != 1 &&
-       m_used != m_data->m_dirtyEnd))
+      IsDirty ())
     {
       ReserveCopy (n);
     }
@@ -419,9 +429,7 @@ PacketMetadata::AddBig (uint32_t next, uint32_t prev,
   uint32_t n = 2 + 2 + typeUidSize + sizeSize + 2 + fragStartSize + fragEndSize + 4;
 
   if (m_used + n > m_data->m_size ||
-      (m_head != 0xffff &&
-       m_data->m_count != 1 &&
-       m_used != m_data->m_dirtyEnd))
+      IsDirty ())
     {
       ReserveCopy (n);
     }
@@ -576,6 +584,7 @@ PacketMetadata::Create (uint32_t size)
     {
       m_maxSize = size;
     }
+#ifndef ENABLE_THREADED_SIMULATOR
   while (!m_freeList.empty ()) 
     {
       struct PacketMetadata::Data *data = m_freeList.back ();
@@ -589,6 +598,7 @@ PacketMetadata::Create (uint32_t size)
       PacketMetadata::Deallocate (data);
       NS_LOG_LOGIC ("create dealloc size="<<data->m_size);
     }
+#endif
   NS_LOG_LOGIC ("create alloc size="<<m_maxSize);
   return PacketMetadata::Allocate (m_maxSize);
 }
@@ -597,6 +607,10 @@ void
 PacketMetadata::Recycle (struct PacketMetadata::Data *data)
 {
   NS_LOG_FUNCTION (data);
+#ifdef ENABLE_THREADED_SIMULATOR
+  // The free list is shared by all the threads
+  PacketMetadata::Deallocate (data);
+#else
   if (!m_enable)
     {
       PacketMetadata::Deallocate (data);
@@ -613,6 +627,7 @@ PacketMetadata::Recycle (struct PacketMetadata::Data *data)
     {
       m_freeList.push_back (data);
     }
+#endif
 }
 
 struct PacketMetadata::Data *
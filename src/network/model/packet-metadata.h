@@ -23,6 +23,10 @@
 #include <stdint.h>
 #include <vector>
 #include <limits>
+#include "ns3/core-config.h"
+#ifdef ENABLE_THREADED_SIMULATOR
+#include <atomic>
+#endif
 #include "ns3/callback.h"
 #include "ns3/assert.h"
 #include "ns3/type-id.h"
@@ -410,7 +414,11 @@ private:
    */
   struct Data {
     /** number of references to this struct Data instance. */
+#ifdef ENABLE_THREADED_SIMULATOR
+    std::atomic<uint32_t> m_count;
+#else
     uint32_t m_count;
+#endif
     /** size (in bytes) of m_data buffer below */
     uint16_t m_size;
     /** max of the m_used field over all objects which
@@ -593,6 +601,12 @@ public:
    * \param n space to reserve
    */
   void ReserveCopy (uint32_t n);
+  /**
+   * \brief Check if data cannot be appended in place, since other
+   * references use the data past m_used
+   * \returns true if the data must be copied before appending to it
+   */
+  bool IsDirty (void) const;
 
   /**
    * \brief Get the total size used by the metadata
@@ -665,9 +679,13 @@ public:
    * m_enable is false; used to detect enabling of metadata in the
    * middle of a simulation, which isn't allowed.
    */
+#ifdef ENABLE_THREADED_SIMULATOR
+  static thread_local bool m_metadataSkipped;
+  static thread_local uint32_t m_maxSize; //!< maximum metadata size
+#else
   static bool m_metadataSkipped;
-
   static uint32_t m_maxSize; //!< maximum metadata size
+#endif
   static uint16_t m_chunkUid; //!< Chunk Uid
 
   struct Data *m_data; //!< Metadata storage
@@ -717,8 +735,7 @@ PacketMetadata::operator = (PacketMetadata const& o)
     {
       // not self assignment
       NS_ASSERT (m_data != 0);
-      m_data->m_count--;
-      if (m_data->m_count == 0) 
+      if (--m_data->m_count == 0)
         {
           PacketMetadata::Recycle (m_data);
         }
@@ -735,8 +752,7 @@ PacketMetadata::operator = (PacketMetadata const& o)
 PacketMetadata::~PacketMetadata ()
 {
   NS_ASSERT (m_data != 0);
-  m_data->m_count--;
-  if (m_data->m_count == 0) 
+  if (--m_data->m_count == 0)
     {
       PacketMetadata::Recycle (m_data);
     }
@@ -284,5 +284,25 @@ PacketTagList::Head (void) const
   return m_next;
 }
 
+#ifdef ENABLE_THREADED_SIMULATOR
+struct PacketTagList::TagData *
+PacketTagList::Copy (const struct TagData * head)
+{
+  struct TagData * copy = 0;
+  struct TagData ** prevNext = &copy;
+  for (const struct TagData *cur = head; cur != 0; cur = cur->next)
+    {
+      struct TagData * tag = new struct TagData ();
+      tag->tid = cur->tid;
+      tag->count = 1;
+      tag->next = 0;
+      memcpy (tag->data, cur->data, TagData::MAX_SIZE);
+      *prevNext = tag;
+      prevNext = &tag->next;
+    }
+  return copy;
+}
+#endif
+
 } /* namespace ns3 */
 
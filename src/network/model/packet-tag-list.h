@@ -28,6 +28,7 @@
 #include <stdint.h>
 #include <ostream>
 #include "ns3/type-id.h"
+#include "ns3/core-config.h"
 
 namespace ns3 {
 
@@ -178,6 +179,8 @@ public:
    *
    * This makes a light-weight copy by #RemoveAll, then
    * pointing to the same \ref TagData as \pname{o}.
+   * With --enable-threaded-simulator, the tags are copied instead, since
+   * the copy may be used by another thread.
    */
   inline PacketTagList (PacketTagList const &o);
   /**
@@ -188,6 +191,7 @@ public:
    *
    * This makes a light-weight copy by #RemoveAll, then
    * pointing to the same \ref TagData as \pname{o}.
+   * With --enable-threaded-simulator, the tags are copied instead.
    */
   inline PacketTagList &operator = (PacketTagList const &o);
   /**
@@ -239,6 +243,15 @@ public:
   const struct PacketTagList::TagData *Head (void) const;
 
 private:
+#ifdef ENABLE_THREADED_SIMULATOR
+  /**
+   * Copy a list of tags
+   *
+   * \param [in] head The first tag of the list to copy.
+   * \returns The first tag of the copy, which shares no TagData.
+   */
+  static struct TagData * Copy (const struct TagData * head);
+#endif
   /**
    * Typedef of method function pointer for copy-on-write operations
    *
@@ -309,10 +322,14 @@ PacketTagList::PacketTagList ()
 PacketTagList::PacketTagList (PacketTagList const &o)
   : m_next (o.m_next)
 {
+#ifdef ENABLE_THREADED_SIMULATOR
+  m_next = Copy (o.m_next);
+#else
   if (m_next != 0)
     {
       m_next->count++;
     }
+#endif
 }
 
 PacketTagList &
@@ -324,11 +341,15 @@ PacketTagList::operator = (PacketTagList const &o)
       return *this;
     }
   RemoveAll ();
+#ifdef ENABLE_THREADED_SIMULATOR
+  m_next = Copy (o.m_next);
+#else
   m_next = o.m_next;
   if (m_next != 0) 
     {
       m_next->count++;
     }
+#endif
   return *this;
 }
 
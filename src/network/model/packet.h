@@ -21,6 +21,10 @@
 #define PACKET_H
 
 #include <stdint.h>
+#include "ns3/core-config.h"
+#ifdef ENABLE_THREADED_SIMULATOR
+#include <atomic>
+#endif
 #include "buffer.h"
 #include "header.h"
 #include "trailer.h"
@@ -727,7 +731,11 @@ private:
   /* Please see comments above about nix-vector */
   Ptr<NixVector> m_nixVector; //!< the packet's Nix vector
 
+#ifdef ENABLE_THREADED_SIMULATOR
+  static std::atomic<uint32_t> m_globalUid; //!< Global counter of packets Uid
+#else
   static uint32_t m_globalUid; //!< Global counter of packets Uid
+#endif
 };
 
 /**
@@ -241,6 +241,19 @@ std::istream &operator >> (std::istream &is, DataRate &rate);
 
 ATTRIBUTE_HELPER_HEADER (DataRate);
 
+namespace TracedValueCallback {
+
+/**
+ * \ingroup network
+ * TracedValue callback signature for DataRate
+ *
+ * \param [in] oldValue original value of the traced variable
+ * \param [in] newValue new value of the traced variable
+ */
+typedef void (* DataRate)(DataRate oldValue, DataRate newValue);
+
+}  // namespace TracedValueCallback
+
 
 /**
  * \brief Multiply datarate by a time value
@@ -26,6 +26,7 @@
 #include <ns3/net-device.h>
 #include <ns3/node.h>
 #include <ns3/double.h>
+#include <ns3/boolean.h>
 #include <ns3/mobility-model.h>
 #include <ns3/spectrum-phy.h>
 #include <ns3/spectrum-converter.h>
@@ -82,6 +83,8 @@ RxSpectrumModelInfo::RxSpectrumModelInfo (Ptr<const SpectrumModel> rxSpectrumMod
 
 
 MultiModelSpectrumChannel::MultiModelSpectrumChannel ()
+  : m_numDevices (0),
+    m_nCulledLinks (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -94,7 +97,17 @@ MultiModelSpectrumChannel::DoDispose ()
   m_propagationLoss = 0;
   m_spectrumPropagationLoss = 0;
   m_txSpectrumModelInfoMap.clear ();
+  for (RxSpectrumModelInfoMap_t::iterator rxInfoIterator = m_rxSpectrumModelInfoMap.begin ();
+       rxInfoIterator != m_rxSpectrumModelInfoMap.end ();
+       ++rxInfoIterator)
+    {
+      if (rxInfoIterator->second.m_rxPhyIndex)
+        {
+          rxInfoIterator->second.m_rxPhyIndex->Clear ();
+        }
+    }
   m_rxSpectrumModelInfoMap.clear ();
+  m_rxCandidates.clear ();
   SpectrumChannel::DoDispose ();
 }
 
@@ -119,6 +132,35 @@ MultiModelSpectrumChannel::GetTypeId (void)
                    DoubleValue (1.0e9),
                    MakeDoubleAccessor (&MultiModelSpectrumChannel::m_maxLossDb),
                    MakeDoubleChecker<double> ())
+    .AddAttribute ("MaxRange",
+                   "Maximum distance in meters between transmitter and "
+                   "receiver for which transmissions will be passed to the "
+                   "receiving PHY. Receivers that are farther away are "
+                   "skipped before any propagation loss model is evaluated. "
+                   "A value of zero disables this cutoff.",
+                   DoubleValue (0.0),
+                   MakeDoubleAccessor (&MultiModelSpectrumChannel::m_maxRange),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("MinRxPowerDbm",
+                   "Minimum received power in dBm for which transmissions "
+                   "will be passed to the receiving PHY. The received power "
+                   "is estimated from the total transmitted power, the "
+                   "antenna gains and the single-frequency "
+                   "PropagationLossModel, before the (usually much more "
+                   "expensive) SpectrumPropagationLossModel is evaluated. "
+                   "The default value corresponds to considering all signals "
+                   "for reception.",
+                   DoubleValue (-1.0e9),
+                   MakeDoubleAccessor (&MultiModelSpectrumChannel::m_minRxPowerDbm),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("SpatialIndex",
+                   "If true and MaxRange is set, the receivers are kept in a "
+                   "grid indexed by their position, so that each transmission "
+                   "only visits the receivers in the grid cells around the "
+                   "transmitter.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&MultiModelSpectrumChannel::m_spatialIndex),
+                   MakeBooleanChecker ())
     .AddTraceSource ("PathLoss",
                      "This trace is fired whenever a new path loss value "
                      "is calculated. The first and second parameters "
@@ -134,6 +176,12 @@ MultiModelSpectrumChannel::GetTypeId (void)
                      "reported in this trace. ",
                      MakeTraceSourceAccessor (&MultiModelSpectrumChannel::m_pathLossTrace),
                      "ns3::SpectrumChannel::LossTracedCallback")
+    .AddTraceSource ("CulledLinks",
+                     "Number of transmitter-receiver links that were not "
+                     "evaluated because of the MaxRange or MinRxPowerDbm "
+                     "cutoffs.",
+                     MakeTraceSourceAccessor (&MultiModelSpectrumChannel::m_nCulledLinks),
+                     "ns3::TracedValueCallback::Uint64")
   ;
   return tid;
 }
@@ -164,6 +212,10 @@ MultiModelSpectrumChannel::AddRx (Ptr<SpectrumPhy> phy)
       std::set<Ptr<SpectrumPhy> >::iterator phyIt = rxInfoIterator->second.m_rxPhySet.find (phy);
       if (phyIt !=  rxInfoIterator->second.m_rxPhySet.end ())
         {
+          if (rxInfoIterator->second.m_rxPhyIndex)
+            {
+              rxInfoIterator->second.m_rxPhyIndex->Remove (phy);
+            }
           rxInfoIterator->second.m_rxPhySet.erase (phyIt);
           --m_numDevices;
           break; // there should be at most one entry
@@ -202,6 +254,10 @@ MultiModelSpectrumChannel::AddRx (Ptr<SpectrumPhy> phy)
       // spectrum model is already known, just add the device to the corresponding list
       std::pair<std::set<Ptr<SpectrumPhy> >::iterator, bool> ret2 = rxInfoIterator->second.m_rxPhySet.insert (phy);
       NS_ASSERT (ret2.second);
+      if (rxInfoIterator->second.m_rxPhyIndex)
+        {
+          rxInfoIterator->second.m_rxPhyIndex->Add (phy);
+        }
     }
 
 }
@@ -272,7 +328,14 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
   NS_LOG_LOGIC ("converter map size: " << txInfoIteratorerator->second.m_spectrumConverterMap.size ());
   NS_LOG_LOGIC ("converter map first element: " << txInfoIteratorerator->second.m_spectrumConverterMap.begin ()->first);
 
-  for (RxSpectrumModelInfoMap_t::const_iterator rxInfoIterator = m_rxSpectrumModelInfoMap.begin ();
+  double txPowerDbm = 0;
+  if (m_minRxPowerDbm > -1.0e9)
+    {
+      txPowerDbm = 10 * std::log10 (Integral (*(txParams->psd))) + 30;
+    }
+  bool useIndex = m_spatialIndex && m_maxRange > 0 && txMobility;
+
+  for (RxSpectrumModelInfoMap_t::iterator rxInfoIterator = m_rxSpectrumModelInfoMap.begin ();
        rxInfoIterator != m_rxSpectrumModelInfoMap.end ();
        ++rxInfoIterator)
     {
@@ -293,87 +356,139 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
           convertedTxPowerSpectrum = rxConverterIterator->second.Convert (txParams->psd);
         }
 
+      if (useIndex)
+        {
+          RxSpectrumModelInfo &rxInfo = rxInfoIterator->second;
+          if (!rxInfo.m_rxPhyIndex)
+            {
+              NS_LOG_LOGIC ("building spatial index for SpectrumModelUid " << rxSpectrumModelUid);
+              rxInfo.m_rxPhyIndex = Create<SpectrumPhyGridIndex> (m_maxRange);
+              for (std::set<Ptr<SpectrumPhy> >::const_iterator rxPhyIterator = rxInfo.m_rxPhySet.begin ();
+                   rxPhyIterator != rxInfo.m_rxPhySet.end ();
+                   ++rxPhyIterator)
+                {
+                  rxInfo.m_rxPhyIndex->Add (*rxPhyIterator);
+                }
+            }
+          m_rxCandidates.clear ();
+          rxInfo.m_rxPhyIndex->GetCandidates (txMobility->GetPosition (), m_maxRange, m_rxCandidates);
+          m_nCulledLinks += rxInfo.m_rxPhySet.size () - m_rxCandidates.size ();
+          for (std::vector<Ptr<SpectrumPhy> >::const_iterator rxPhyIterator = m_rxCandidates.begin ();
+               rxPhyIterator != m_rxCandidates.end ();
+               ++rxPhyIterator)
+            {
+              StartTxToReceiver (txParams, txMobility, convertedTxPowerSpectrum, txPowerDbm, *rxPhyIterator);
+            }
+        }
+      else
+        {
+          for (std::set<Ptr<SpectrumPhy> >::const_iterator rxPhyIterator = rxInfoIterator->second.m_rxPhySet.begin ();
+               rxPhyIterator != rxInfoIterator->second.m_rxPhySet.end ();
+               ++rxPhyIterator)
+            {
+              StartTxToReceiver (txParams, txMobility, convertedTxPowerSpectrum, txPowerDbm, *rxPhyIterator);
+            }
+        }
+    }
+}
 
-      for (std::set<Ptr<SpectrumPhy> >::const_iterator rxPhyIterator = rxInfoIterator->second.m_rxPhySet.begin ();
-           rxPhyIterator != rxInfoIterator->second.m_rxPhySet.end ();
-           ++rxPhyIterator)
+void
+MultiModelSpectrumChannel::StartTxToReceiver (Ptr<SpectrumSignalParameters> txParams, Ptr<MobilityModel> txMobility,
+                                              Ptr<SpectrumValue> convertedTxPowerSpectrum, double txPowerDbm,
+                                              Ptr<SpectrumPhy> rxPhy)
+{
+  NS_ASSERT_MSG (rxPhy->GetRxSpectrumModel ()->GetUid () == convertedTxPowerSpectrum->GetSpectrumModelUid (),
+                 "SpectrumModel change was not notified to MultiModelSpectrumChannel (i.e., AddRx should be called again after model is changed)");
+
+  if (rxPhy == txParams->txPhy)
+    {
+      return;
+    }
+
+  Ptr<MobilityModel> receiverMobility = rxPhy->GetMobility ();
+  double pathGainLinear = 1.0;
+  Time delay = MicroSeconds (0);
+
+  if (txMobility && receiverMobility)
+    {
+      if (m_maxRange > 0 && txMobility->GetDistanceFrom (receiverMobility) > m_maxRange)
         {
-          NS_ASSERT_MSG ((*rxPhyIterator)->GetRxSpectrumModel ()->GetUid () == rxSpectrumModelUid,
-                         "SpectrumModel change was not notified to MultiModelSpectrumChannel (i.e., AddRx should be called again after model is changed)");
+          NS_LOG_LOGIC ("receiver " << rxPhy << " beyond MaxRange");
+          ++m_nCulledLinks;
+          return;
+        }
 
-          if ((*rxPhyIterator) != txParams->txPhy)
-            {
-              NS_LOG_LOGIC (" copying signal parameters " << txParams);
-              Ptr<SpectrumSignalParameters> rxParams = txParams->Copy ();
-              rxParams->psd = Copy<SpectrumValue> (convertedTxPowerSpectrum);
-              Time delay = MicroSeconds (0);
+      double pathLossDb = 0;
+      if (txParams->txAntenna != 0)
+        {
+          Angles txAngles (receiverMobility->GetPosition (), txMobility->GetPosition ());
+          double txAntennaGain = txParams->txAntenna->GetGainDb (txAngles);
+          NS_LOG_LOGIC ("txAntennaGain = " << txAntennaGain << " dB");
+          pathLossDb -= txAntennaGain;
+        }
+      Ptr<AntennaModel> rxAntenna = rxPhy->GetRxAntenna ();
+      if (rxAntenna != 0)
+        {
+          Angles rxAngles (txMobility->GetPosition (), receiverMobility->GetPosition ());
+          double rxAntennaGain = rxAntenna->GetGainDb (rxAngles);
+          NS_LOG_LOGIC ("rxAntennaGain = " << rxAntennaGain << " dB");
+          pathLossDb -= rxAntennaGain;
+        }
+      if (m_propagationLoss)
+        {
+          double propagationGainDb = m_propagationLoss->CalcRxPower (0, txMobility, receiverMobility);
+          NS_LOG_LOGIC ("propagationGainDb = " << propagationGainDb << " dB");
+          pathLossDb -= propagationGainDb;
+        }
+      NS_LOG_LOGIC ("total pathLoss = " << pathLossDb << " dB");
+      m_pathLossTrace (txParams->txPhy, rxPhy, pathLossDb);
+      if ( pathLossDb > m_maxLossDb)
+        {
+          // beyond range
+          return;
+        }
+      if (txPowerDbm - pathLossDb < m_minRxPowerDbm)
+        {
+          NS_LOG_LOGIC ("receiver " << rxPhy << " below MinRxPowerDbm");
+          ++m_nCulledLinks;
+          return;
+        }
+      pathGainLinear = std::pow (10.0, (-pathLossDb) / 10.0);
+    }
 
-              Ptr<MobilityModel> receiverMobility = (*rxPhyIterator)->GetMobility ();
+  NS_LOG_LOGIC (" copying signal parameters " << txParams);
+  Ptr<SpectrumSignalParameters> rxParams = txParams->Copy ();
+  rxParams->psd = Copy<SpectrumValue> (convertedTxPowerSpectrum);
 
-              if (txMobility && receiverMobility)
-                {
-                  double pathLossDb = 0;
-                  if (rxParams->txAntenna != 0)
-                    {
-                      Angles txAngles (receiverMobility->GetPosition (), txMobility->GetPosition ());
-                      double txAntennaGain = rxParams->txAntenna->GetGainDb (txAngles);
-                      NS_LOG_LOGIC ("txAntennaGain = " << txAntennaGain << " dB");
-                      pathLossDb -= txAntennaGain;
-                    }
-                  Ptr<AntennaModel> rxAntenna = (*rxPhyIterator)->GetRxAntenna ();
-                  if (rxAntenna != 0)
-                    {
-                      Angles rxAngles (txMobility->GetPosition (), receiverMobility->GetPosition ());
-                      double rxAntennaGain = rxAntenna->GetGainDb (rxAngles);
-                      NS_LOG_LOGIC ("rxAntennaGain = " << rxAntennaGain << " dB");
-                      pathLossDb -= rxAntennaGain;
-                    }
-                  if (m_propagationLoss)
-                    {
-                      double propagationGainDb = m_propagationLoss->CalcRxPower (0, txMobility, receiverMobility);
-                      NS_LOG_LOGIC ("propagationGainDb = " << propagationGainDb << " dB");
-                      pathLossDb -= propagationGainDb;
-                    }                    
-                  NS_LOG_LOGIC ("total pathLoss = " << pathLossDb << " dB");    
-                  m_pathLossTrace (txParams->txPhy, *rxPhyIterator, pathLossDb);
-                  if ( pathLossDb > m_maxLossDb)
-                    {
-                      // beyond range
-                      continue;
-                    }
-                  double pathGainLinear = std::pow (10.0, (-pathLossDb) / 10.0);
-                  *(rxParams->psd) *= pathGainLinear;              
-
-                  if (m_spectrumPropagationLoss)
-                    {
-                      rxParams->psd = m_spectrumPropagationLoss->CalcRxPowerSpectralDensity (rxParams->psd, txMobility, receiverMobility);
-                    }
-
-                  if (m_propagationDelay)
-                    {
-                      delay = m_propagationDelay->GetDelay (txMobility, receiverMobility);
-                    }
-                }
+  if (txMobility && receiverMobility)
+    {
+      *(rxParams->psd) *= pathGainLinear;
 
-              Ptr<NetDevice> netDev = (*rxPhyIterator)->GetDevice ();
-              if (netDev)
-                {
-                  // the receiver has a NetDevice, so we expect that it is attached to a Node
-                  uint32_t dstNode =  netDev->GetNode ()->GetId ();
-                  Simulator::ScheduleWithContext (dstNode, delay, &MultiModelSpectrumChannel::StartRx, this,
-                                                  rxParams, *rxPhyIterator);
-                }
-              else
-                {
-                  // the receiver is not attached to a NetDevice, so we cannot assume that it is attached to a node
-                  Simulator::Schedule (delay, &MultiModelSpectrumChannel::StartRx, this,
-                                       rxParams, *rxPhyIterator);
-                }
-            }
+      if (m_spectrumPropagationLoss)
+        {
+          rxParams->psd = m_spectrumPropagationLoss->CalcRxPowerSpectralDensity (rxParams->psd, txMobility, receiverMobility);
         }
 
+      if (m_propagationDelay)
+        {
+          delay = m_propagationDelay->GetDelay (txMobility, receiverMobility);
+        }
     }
 
+  Ptr<NetDevice> netDev = rxPhy->GetDevice ();
+  if (netDev)
+    {
+      // the receiver has a NetDevice, so we expect that it is attached to a Node
+      uint32_t dstNode =  netDev->GetNode ()->GetId ();
+      Simulator::ScheduleWithContext (dstNode, delay, &MultiModelSpectrumChannel::StartRx, this,
+                                      rxParams, rxPhy);
+    }
+  else
+    {
+      // the receiver is not attached to a NetDevice, so we cannot assume that it is attached to a node
+      Simulator::Schedule (delay, &MultiModelSpectrumChannel::StartRx, this,
+                           rxParams, rxPhy);
+    }
 }
 
 void
@@ -385,6 +500,13 @@ MultiModelSpectrumChannel::StartRx (Ptr<SpectrumSignalParameters> params, Ptr<Sp
 
 
 
+uint64_t
+MultiModelSpectrumChannel::GetNCulledLinks (void) const
+{
+  return m_nCulledLinks;
+}
+
+
 uint32_t
 MultiModelSpectrumChannel::GetNDevices (void) const
 {
@@ -25,6 +25,8 @@
 #include <ns3/spectrum-value.h>
 #include <ns3/spectrum-converter.h>
 #include <ns3/spectrum-channel.h>
+#include <ns3/spectrum-phy-grid-index.h>
+#include <ns3/traced-value.h>
 #include <ns3/spectrum-propagation-loss-model.h>
 #include <ns3/propagation-delay-model.h>
 #include <map>
@@ -81,6 +83,7 @@ public:
 
   Ptr<const SpectrumModel> m_rxSpectrumModel;  //!< Rx Spectrum model.
   std::set<Ptr<SpectrumPhy> > m_rxPhySet;      //!< Container of the Rx Spectrum phy objects.
+  Ptr<SpectrumPhyGridIndex> m_rxPhyIndex;      //!< Spatial index of m_rxPhySet, if enabled.
 };
 
 /**
@@ -133,6 +136,12 @@ public:
    */
   virtual Ptr<SpectrumPropagationLossModel> GetSpectrumPropagationLossModel (void);
 
+  /**
+   * \return the number of transmitter-receiver links that were not
+   * evaluated because of the MaxRange or MinRxPowerDbm cutoffs
+   */
+  uint64_t GetNCulledLinks (void) const;
+
 
 protected:
   void DoDispose ();
@@ -150,6 +159,19 @@ private:
    */
   TxSpectrumModelInfoMap_t::const_iterator FindAndEventuallyAddTxSpectrumModel (Ptr<const SpectrumModel> txSpectrumModel);
 
+  /**
+   * Compute the signal received by one receiver and schedule its reception.
+   *
+   * @param txParams The signal parameters of the transmission.
+   * @param txMobility The mobility of the transmitter, possibly 0.
+   * @param convertedTxPowerSpectrum The transmitted PSD converted to the RX spectrum model.
+   * @param txPowerDbm The total transmitted power [dBm].
+   * @param rxPhy The receiver.
+   */
+  void StartTxToReceiver (Ptr<SpectrumSignalParameters> txParams, Ptr<MobilityModel> txMobility,
+                          Ptr<SpectrumValue> convertedTxPowerSpectrum, double txPowerDbm,
+                          Ptr<SpectrumPhy> rxPhy);
+
   /**
    * Used internally to reschedule transmission after the propagation delay.
    *
@@ -207,6 +229,37 @@ private:
    * in a future release.
    */
   TracedCallback<Ptr<SpectrumPhy>, Ptr<SpectrumPhy>, double > m_pathLossTrace;
+
+  /**
+   * Maximum distance [m] between transmitter and receiver.
+   *
+   * Receivers farther than this are not passed the signal. Zero disables
+   * the cutoff.
+   */
+  double m_maxRange;
+
+  /**
+   * Minimum received power [dBm], computed from the single-frequency
+   * propagation loss and antenna gains, for a signal to be passed to the
+   * receiver.
+   */
+  double m_minRxPowerDbm;
+
+  /**
+   * Whether a spatial index of the receivers is used to apply m_maxRange.
+   */
+  bool m_spatialIndex;
+
+  /**
+   * Number of links that were not evaluated because of the cutoffs.
+   */
+  TracedValue<uint64_t> m_nCulledLinks;
+
+  /**
+   * Scratch container for the candidate receivers returned by the
+   * spatial index.
+   */
+  std::vector<Ptr<SpectrumPhy> > m_rxCandidates;
 };
 
 
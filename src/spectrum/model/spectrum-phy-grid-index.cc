@@ -0,0 +1,215 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2009 CTTC
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/log.h>
+#include <ns3/assert.h>
+#include <ns3/mobility-model.h>
+#include <ns3/spectrum-phy.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include "spectrum-phy-grid-index.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("SpectrumPhyGridIndex");
+
+SpectrumPhyGridIndex::SpectrumPhyGridIndex (double cellSize)
+  : m_cellSize (cellSize)
+{
+  NS_LOG_FUNCTION (this << cellSize);
+  NS_ASSERT (cellSize > 0);
+}
+
+SpectrumPhyGridIndex::CellKey_t
+SpectrumPhyGridIndex::GetCellKey (const Vector &position) const
+{
+  return CellKey_t (static_cast<int64_t> (std::floor (position.x / m_cellSize)),
+                    static_cast<int64_t> (std::floor (position.y / m_cellSize)));
+}
+
+void
+SpectrumPhyGridIndex::Add (Ptr<SpectrumPhy> phy)
+{
+  NS_LOG_FUNCTION (this << phy);
+  Ptr<MobilityModel> mobility = phy->GetMobility ();
+  if (mobility == 0)
+    {
+      m_unindexed.insert (phy);
+      return;
+    }
+  MobilityEntry &entry = m_physOf[PeekPointer (mobility)];
+  if (entry.phys.empty ())
+    {
+      entry.mobility = mobility;
+      mobility->TraceConnectWithoutContext ("CourseChange",
+                                            MakeCallback (&SpectrumPhyGridIndex::CourseChanged,
+                                                          Ptr<SpectrumPhyGridIndex> (this)));
+    }
+  entry.phys.push_back (phy);
+  m_mobilityOf[phy] = PeekPointer (mobility);
+  Insert (phy, mobility);
+}
+
+void
+SpectrumPhyGridIndex::Remove (Ptr<SpectrumPhy> phy)
+{
+  NS_LOG_FUNCTION (this << phy);
+  Erase (phy);
+  std::map<Ptr<SpectrumPhy>, const MobilityModel *>::iterator mobilityIt = m_mobilityOf.find (phy);
+  if (mobilityIt == m_mobilityOf.end ())
+    {
+      return;
+    }
+  std::map<const MobilityModel *, MobilityEntry>::iterator entryIt = m_physOf.find (mobilityIt->second);
+  m_mobilityOf.erase (mobilityIt);
+  NS_ASSERT (entryIt != m_physOf.end ());
+  std::vector<Ptr<SpectrumPhy> > &phys = entryIt->second.phys;
+  phys.erase (std::find (phys.begin (), phys.end (), phy));
+  if (phys.empty ())
+    {
+      // stop listening when the last receiver of the mobility model leaves
+      Disconnect (entryIt->second.mobility);
+      m_physOf.erase (entryIt);
+    }
+}
+
+void
+SpectrumPhyGridIndex::Disconnect (Ptr<MobilityModel> mobility)
+{
+  mobility->TraceDisconnectWithoutContext ("CourseChange",
+                                           MakeCallback (&SpectrumPhyGridIndex::CourseChanged,
+                                                         Ptr<SpectrumPhyGridIndex> (this)));
+}
+
+void
+SpectrumPhyGridIndex::Insert (Ptr<SpectrumPhy> phy, Ptr<const MobilityModel> mobility)
+{
+  Vector velocity = mobility->GetVelocity ();
+  if (velocity.x != 0 || velocity.y != 0)
+    {
+      NS_LOG_LOGIC ("phy " << phy << " is moving, not indexed");
+      m_unindexed.insert (phy);
+      return;
+    }
+  CellKey_t key = GetCellKey (mobility->GetPosition ());
+  NS_LOG_LOGIC ("phy " << phy << " in cell (" << key.first << "," << key.second << ")");
+  m_cells[key].push_back (phy);
+  m_cellOf[phy] = key;
+}
+
+void
+SpectrumPhyGridIndex::Erase (Ptr<SpectrumPhy> phy)
+{
+  std::map<Ptr<SpectrumPhy>, CellKey_t>::iterator cellIt = m_cellOf.find (phy);
+  if (cellIt != m_cellOf.end ())
+    {
+      std::vector<Ptr<SpectrumPhy> > &cell = m_cells[cellIt->second];
+      cell.erase (std::find (cell.begin (), cell.end (), phy));
+      if (cell.empty ())
+        {
+          m_cells.erase (cellIt->second);
+        }
+      m_cellOf.erase (cellIt);
+    }
+  m_unindexed.erase (phy);
+}
+
+void
+SpectrumPhyGridIndex::CourseChanged (Ptr<const MobilityModel> mobility)
+{
+  NS_LOG_FUNCTION (this << mobility);
+  std::map<const MobilityModel *, MobilityEntry>::iterator it = m_physOf.find (PeekPointer (mobility));
+  if (it == m_physOf.end ())
+    {
+      return;
+    }
+  // all the receivers sharing the mobility model move together
+  for (std::vector<Ptr<SpectrumPhy> >::iterator phy = it->second.phys.begin ();
+       phy != it->second.phys.end ();
+       ++phy)
+    {
+      Erase (*phy);
+      Insert (*phy, mobility);
+    }
+}
+
+void
+SpectrumPhyGridIndex::GetCandidates (const Vector &position, double range,
+                                     std::vector<Ptr<SpectrumPhy> > &candidates) const
+{
+  NS_LOG_FUNCTION (this << position << range);
+  std::vector<Ptr<SpectrumPhy> >::size_type first = candidates.size ();
+  CellKey_t center = GetCellKey (position);
+  double cellsPerSide = 2 * std::ceil (range / m_cellSize) + 1;
+  int64_t span = static_cast<int64_t> (std::min (std::ceil (range / m_cellSize), 1.0e15));
+  if (cellsPerSide * cellsPerSide > m_cells.size ())
+    {
+      // the search area covers more cells than are occupied
+      for (std::map<CellKey_t, std::vector<Ptr<SpectrumPhy> > >::const_iterator it = m_cells.begin ();
+           it != m_cells.end ();
+           ++it)
+        {
+          if (std::abs (it->first.first - center.first) <= span
+              && std::abs (it->first.second - center.second) <= span)
+            {
+              candidates.insert (candidates.end (), it->second.begin (), it->second.end ());
+            }
+        }
+    }
+  else
+    {
+      for (int64_t x = center.first - span; x <= center.first + span; ++x)
+        {
+          // cells are sorted by x first, so a row is a contiguous range
+          std::map<CellKey_t, std::vector<Ptr<SpectrumPhy> > >::const_iterator it = m_cells.lower_bound (CellKey_t (x, center.second - span));
+          std::map<CellKey_t, std::vector<Ptr<SpectrumPhy> > >::const_iterator end = m_cells.upper_bound (CellKey_t (x, center.second + span));
+          for (; it != end; ++it)
+            {
+              candidates.insert (candidates.end (), it->second.begin (), it->second.end ());
+            }
+        }
+    }
+  candidates.insert (candidates.end (), m_unindexed.begin (), m_unindexed.end ());
+  std::sort (candidates.begin () + first, candidates.end ());
+}
+
+uint32_t
+SpectrumPhyGridIndex::GetN (void) const
+{
+  return m_cellOf.size () + m_unindexed.size ();
+}
+
+void
+SpectrumPhyGridIndex::Clear (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (std::map<const MobilityModel *, MobilityEntry>::iterator it = m_physOf.begin ();
+       it != m_physOf.end ();
+       ++it)
+    {
+      Disconnect (it->second.mobility);
+    }
+  m_physOf.clear ();
+  m_mobilityOf.clear ();
+  m_cells.clear ();
+  m_cellOf.clear ();
+  m_unindexed.clear ();
+}
+
+} // namespace ns3
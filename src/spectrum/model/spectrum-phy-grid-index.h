@@ -0,0 +1,123 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2009 CTTC
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SPECTRUM_PHY_GRID_INDEX_H
+#define SPECTRUM_PHY_GRID_INDEX_H
+
+#include <ns3/simple-ref-count.h>
+#include <ns3/ptr.h>
+#include <ns3/vector.h>
+#include <map>
+#include <set>
+#include <vector>
+
+namespace ns3 {
+
+class SpectrumPhy;
+class MobilityModel;
+
+/**
+ * \ingroup spectrum
+ *
+ * Uniform 2D grid (on the x-y plane) of SpectrumPhy instances keyed by
+ * the position of their MobilityModel, used by MultiModelSpectrumChannel
+ * to find the receivers that lie within a given range of a transmitter
+ * without visiting every receiver attached to the channel.
+ *
+ * Only receivers that are not moving are stored in the grid. The index
+ * listens to the CourseChange trace of their MobilityModel and moves them
+ * to another cell (or to the set of moving receivers) when their position
+ * or velocity changes. Receivers with a non-zero velocity, and receivers
+ * without a MobilityModel, are always returned as candidates: the caller
+ * is expected to check the exact distance of each candidate.
+ */
+class SpectrumPhyGridIndex : public SimpleRefCount<SpectrumPhyGridIndex>
+{
+public:
+  /**
+   * \param cellSize the side of a grid cell in meters
+   */
+  SpectrumPhyGridIndex (double cellSize);
+
+  /**
+   * Add a receiver to the index
+   * \param phy the receiver
+   */
+  void Add (Ptr<SpectrumPhy> phy);
+
+  /**
+   * Remove a receiver from the index
+   * \param phy the receiver
+   */
+  void Remove (Ptr<SpectrumPhy> phy);
+
+  /**
+   * Get the receivers that might be within a given range of a position.
+   *
+   * The candidates are appended to \p candidates sorted like the
+   * std::set<Ptr<SpectrumPhy> > used by the channel, so that the order
+   * in which receptions are scheduled does not depend on the index.
+   *
+   * \param position the center of the search
+   * \param range the search radius in meters
+   * \param candidates the container the candidates are appended to
+   */
+  void GetCandidates (const Vector &position, double range, std::vector<Ptr<SpectrumPhy> > &candidates) const;
+
+  /**
+   * \return the number of receivers in the index
+   */
+  uint32_t GetN (void) const;
+
+  /**
+   * Remove all the receivers and stop listening to their course changes
+   */
+  void Clear (void);
+
+private:
+  /// integer coordinates of a grid cell
+  typedef std::pair<int64_t, int64_t> CellKey_t;
+
+  CellKey_t GetCellKey (const Vector &position) const;
+  void Insert (Ptr<SpectrumPhy> phy, Ptr<const MobilityModel> mobility);
+  void Erase (Ptr<SpectrumPhy> phy);
+  void CourseChanged (Ptr<const MobilityModel> mobility);
+  void Disconnect (Ptr<MobilityModel> mobility);
+
+  double m_cellSize;
+  /// static receivers, per grid cell
+  std::map<CellKey_t, std::vector<Ptr<SpectrumPhy> > > m_cells;
+  /// cell of each static receiver
+  std::map<Ptr<SpectrumPhy>, CellKey_t> m_cellOf;
+  /// receivers that are moving or have no mobility model
+  std::set<Ptr<SpectrumPhy> > m_unindexed;
+  /// a mobility model the index is listening to, and its receivers
+  struct MobilityEntry
+  {
+    Ptr<MobilityModel> mobility;
+    std::vector<Ptr<SpectrumPhy> > phys;
+  };
+  /// receivers of each mobility model the index is listening to
+  std::map<const MobilityModel *, MobilityEntry> m_physOf;
+  /// mobility model of each receiver that has one
+  std::map<Ptr<SpectrumPhy>, const MobilityModel *> m_mobilityOf;
+};
+
+} // namespace ns3
+
+#endif /* SPECTRUM_PHY_GRID_INDEX_H */
@@ -0,0 +1,142 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2009 CTTC
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/spectrum-value-allocator.h>
+
+#include <map>
+#include <new>
+#include <vector>
+
+namespace ns3 {
+
+namespace {
+
+/// Maximum number of free blocks kept for each size
+const std::size_t MAX_FREE_BLOCKS = 4096;
+
+/// Set when the pool of the thread is destroyed, at thread or program exit
+thread_local bool g_poolDestroyed = false;
+
+/// Free lists of the calling thread
+class Pool
+{
+public:
+  Pool ()
+    : m_lastBytes (0),
+      m_lastList (0),
+      m_heapAllocations (0),
+      m_poolAllocations (0)
+  {
+  }
+
+  ~Pool ()
+  {
+    for (std::map<std::size_t, std::vector<void*> >::iterator it = m_freeLists.begin ();
+         it != m_freeLists.end (); ++it)
+      {
+        for (std::size_t i = 0; i < it->second.size (); i++)
+          {
+            ::operator delete (it->second[i]);
+          }
+      }
+    // the SpectrumValue instances destroyed after this point free their
+    // values directly
+    g_poolDestroyed = true;
+  }
+
+  /**
+   * \param bytes the size of the blocks
+   * \return the free list of the blocks of that size
+   */
+  std::vector<void*>& GetFreeList (std::size_t bytes)
+  {
+    // the nodes of a std::map do not move, so the last list can be cached
+    if (m_lastList == 0 || bytes != m_lastBytes)
+      {
+        m_lastList = &m_freeLists[bytes];
+        m_lastBytes = bytes;
+      }
+    return *m_lastList;
+  }
+
+  std::map<std::size_t, std::vector<void*> > m_freeLists; ///< free blocks by size
+  std::size_t m_lastBytes;          ///< size of the last list used
+  std::vector<void*>* m_lastList;   ///< last list used
+  uint64_t m_heapAllocations;       ///< allocations served by the heap
+  uint64_t m_poolAllocations;       ///< allocations served by a free list
+};
+
+Pool&
+GetPool (void)
+{
+  static thread_local Pool pool;
+  return pool;
+}
+
+} // anonymous namespace
+
+void*
+SpectrumValuePool::Allocate (std::size_t bytes)
+{
+  if (g_poolDestroyed)
+    {
+      return ::operator new (bytes);
+    }
+  Pool& pool = GetPool ();
+  std::vector<void*>& freeList = pool.GetFreeList (bytes);
+  if (freeList.empty ())
+    {
+      pool.m_heapAllocations++;
+      return ::operator new (bytes);
+    }
+  pool.m_poolAllocations++;
+  void* p = freeList.back ();
+  freeList.pop_back ();
+  return p;
+}
+
+void
+SpectrumValuePool::Deallocate (void* p, std::size_t bytes)
+{
+  if (g_poolDestroyed)
+    {
+      ::operator delete (p);
+      return;
+    }
+  std::vector<void*>& freeList = GetPool ().GetFreeList (bytes);
+  if (freeList.size () >= MAX_FREE_BLOCKS)
+    {
+      ::operator delete (p);
+      return;
+    }
+  freeList.push_back (p);
+}
+
+uint64_t
+SpectrumValuePool::GetHeapAllocations (void)
+{
+  return g_poolDestroyed ? 0 : GetPool ().m_heapAllocations;
+}
+
+uint64_t
+SpectrumValuePool::GetPoolAllocations (void)
+{
+  return g_poolDestroyed ? 0 : GetPool ().m_poolAllocations;
+}
+
+} // namespace ns3
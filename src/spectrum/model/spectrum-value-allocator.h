@@ -0,0 +1,128 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2009 CTTC
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SPECTRUM_VALUE_ALLOCATOR_H
+#define SPECTRUM_VALUE_ALLOCATOR_H
+
+#include <cstddef>
+#include <stdint.h>
+
+namespace ns3 {
+
+/**
+ * \ingroup spectrum
+ *
+ * \brief Pool of the memory blocks that store the values of SpectrumValue
+ *
+ * A simulation uses a handful of SpectrumModel instances, so the values of
+ * all its SpectrumValue instances come in a handful of sizes. The pool
+ * keeps the blocks that are released in one free list per size and hands
+ * them out again, so that creating a temporary SpectrumValue does not go
+ * through the heap once the pool is warm.
+ *
+ * Each thread has its own pool, so no lock is taken. A block can be
+ * released by another thread than the one that allocated it: it goes to
+ * the pool of the releasing thread.
+ */
+class SpectrumValuePool
+{
+public:
+  /**
+   * \param bytes the size of the block
+   * \return a block of at least bytes bytes, suitably aligned for double
+   */
+  static void* Allocate (std::size_t bytes);
+
+  /**
+   * \param p a block returned by Allocate
+   * \param bytes the size passed to Allocate
+   */
+  static void Deallocate (void* p, std::size_t bytes);
+
+  /**
+   * \return the number of blocks the pool of the calling thread took
+   * from the heap, i.e., the allocations that were not served by a free
+   * list
+   */
+  static uint64_t GetHeapAllocations (void);
+
+  /**
+   * \return the number of allocations the pool of the calling thread
+   * served from a free list
+   */
+  static uint64_t GetPoolAllocations (void);
+};
+
+/**
+ * \ingroup spectrum
+ *
+ * \brief Standard allocator backed by SpectrumValuePool
+ */
+template <class T>
+class SpectrumValueAllocator
+{
+public:
+  /// type of the elements
+  typedef T value_type;
+
+  SpectrumValueAllocator ()
+  {
+  }
+
+  /// Conversion from the allocator of another type
+  template <class U>
+  SpectrumValueAllocator (const SpectrumValueAllocator<U>&)
+  {
+  }
+
+  /**
+   * \param n the number of elements
+   * \return storage for n elements
+   */
+  T* allocate (std::size_t n)
+  {
+    return static_cast<T*> (SpectrumValuePool::Allocate (n * sizeof (T)));
+  }
+
+  /**
+   * \param p the storage returned by allocate
+   * \param n the number of elements passed to allocate
+   */
+  void deallocate (T* p, std::size_t n)
+  {
+    SpectrumValuePool::Deallocate (p, n * sizeof (T));
+  }
+};
+
+/// All the instances share the pool, so they are all equal
+template <class T, class U>
+bool operator== (const SpectrumValueAllocator<T>&, const SpectrumValueAllocator<U>&)
+{
+  return true;
+}
+
+/// All the instances share the pool, so they are all equal
+template <class T, class U>
+bool operator!= (const SpectrumValueAllocator<T>&, const SpectrumValueAllocator<U>&)
+{
+  return false;
+}
+
+} // namespace ns3
+
+#endif /* SPECTRUM_VALUE_ALLOCATOR_H */
@@ -675,6 +675,85 @@ SpectrumValue::operator= (double rhs)
 }
 
 
+void
+SpectrumValue::PrepareFused (const SpectrumValue& x)
+{
+  if (m_spectrumModel == 0)
+    {
+      m_spectrumModel = x.m_spectrumModel;
+      m_values.resize (x.m_values.size ());
+    }
+  NS_ASSERT (m_spectrumModel == x.m_spectrumModel);
+  NS_ASSERT (m_values.size () == x.m_values.size ());
+}
+
+SpectrumValue&
+SpectrumValue::AddScaled (const SpectrumValue& x, double s)
+{
+  PrepareFused (x);
+  double* r = m_values.data ();
+  const double* a = x.m_values.data ();
+  const std::size_t n = m_values.size ();
+  for (std::size_t i = 0; i < n; ++i)
+    {
+      r[i] += a[i] * s;
+    }
+  return *this;
+}
+
+SpectrumValue&
+SpectrumValue::SetProduct (const SpectrumValue& lhs, const SpectrumValue& rhs)
+{
+  PrepareFused (lhs);
+  NS_ASSERT (lhs.m_spectrumModel == rhs.m_spectrumModel);
+  double* r = m_values.data ();
+  const double* a = lhs.m_values.data ();
+  const double* b = rhs.m_values.data ();
+  const std::size_t n = m_values.size ();
+  for (std::size_t i = 0; i < n; ++i)
+    {
+      r[i] = a[i] * b[i];
+    }
+  return *this;
+}
+
+SpectrumValue&
+SpectrumValue::SetQuotient (const SpectrumValue& lhs, const SpectrumValue& rhs)
+{
+  PrepareFused (lhs);
+  NS_ASSERT (lhs.m_spectrumModel == rhs.m_spectrumModel);
+  double* r = m_values.data ();
+  const double* a = lhs.m_values.data ();
+  const double* b = rhs.m_values.data ();
+  const std::size_t n = m_values.size ();
+  for (std::size_t i = 0; i < n; ++i)
+    {
+      r[i] = a[i] / b[i];
+    }
+  return *this;
+}
+
+SpectrumValue&
+SpectrumValue::SetSinr (const SpectrumValue& signal, const SpectrumValue& allSignals,
+                        const SpectrumValue& noise)
+{
+  PrepareFused (signal);
+  NS_ASSERT (signal.m_spectrumModel == allSignals.m_spectrumModel);
+  NS_ASSERT (signal.m_spectrumModel == noise.m_spectrumModel);
+  double* r = m_values.data ();
+  const double* s = signal.m_values.data ();
+  const double* a = allSignals.m_values.data ();
+  const double* w = noise.m_values.data ();
+  const std::size_t n = m_values.size ();
+  for (std::size_t i = 0; i < n; ++i)
+    {
+      // same order of the operations as (allSignals - signal + noise)
+      r[i] = s[i] / ((a[i] - s[i]) + w[i]);
+    }
+  return *this;
+}
+
+
 
 SpectrumValue
 SpectrumValue::operator<< (int n) const
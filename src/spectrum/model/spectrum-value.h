@@ -24,14 +24,15 @@
 #include <ns3/ptr.h>
 #include <ns3/simple-ref-count.h>
 #include <ns3/spectrum-model.h>
+#include <ns3/spectrum-value-allocator.h>
 #include <ostream>
 #include <vector>
 
 namespace ns3 {
 
 
-/// Container for element values
-typedef std::vector<double> Values;
+/// Container for element values, whose storage comes from SpectrumValuePool
+typedef std::vector<double, SpectrumValueAllocator<double> > Values;
 
 /**
  * \ingroup spectrum
@@ -410,6 +411,65 @@ public:
   SpectrumValue& operator= (double rhs);
 
 
+  /**
+   * \name Fused operations
+   *
+   * The operators above return a new SpectrumValue for each operation.
+   * The following methods compute a whole expression in one pass over
+   * the bands and store it in *this, so that a SpectrumValue that is
+   * reused (e.g., a member of the caller) makes them allocation free.
+   * If *this has no SpectrumModel yet, it takes the one of the
+   * operands; otherwise all the SpectrumModel instances must be the same.
+   * The operands can be *this.
+   * @{
+   */
+
+  /**
+   * Add x * s to *this
+   *
+   * @param x the SpectrumValue to scale
+   * @param s the scale
+   *
+   * @return *this
+   */
+  SpectrumValue& AddScaled (const SpectrumValue& x, double s);
+
+  /**
+   * Set *this to lhs * rhs
+   *
+   * @param lhs Left Hand Side of the product
+   * @param rhs Right Hand Side of the product
+   *
+   * @return *this
+   */
+  SpectrumValue& SetProduct (const SpectrumValue& lhs, const SpectrumValue& rhs);
+
+  /**
+   * Set *this to lhs / rhs
+   *
+   * @param lhs the numerator
+   * @param rhs the denominator
+   *
+   * @return *this
+   */
+  SpectrumValue& SetQuotient (const SpectrumValue& lhs, const SpectrumValue& rhs);
+
+  /**
+   * Set *this to signal / (allSignals - signal + noise), the SINR of
+   * a signal received among allSignals
+   *
+   * @param signal the PSD of the signal
+   * @param allSignals the PSD of all the signals, including signal
+   * @param noise the PSD of the noise
+   *
+   * @return *this
+   */
+  SpectrumValue& SetSinr (const SpectrumValue& signal, const SpectrumValue& allSignals,
+                          const SpectrumValue& noise);
+
+  /** @} */
+
+
 
   /**
    *
@@ -593,6 +653,14 @@ private:
    */
   void Log ();
 
+  /**
+   * Take the SpectrumModel of x if *this has none, then check that both
+   * have the same
+   *
+   * @param x the operand of a fused operation
+   */
+  void PrepareFused (const SpectrumValue& x);
+
   Ptr<const SpectrumModel> m_spectrumModel; //!< The spectrum model
 
 
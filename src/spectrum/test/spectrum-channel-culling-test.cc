@@ -0,0 +1,240 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2009 CTTC
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/log.h>
+#include <ns3/test.h>
+#include <ns3/simulator.h>
+#include <ns3/double.h>
+#include <ns3/boolean.h>
+#include <ns3/spectrum-phy.h>
+#include <ns3/net-device.h>
+#include <ns3/antenna-model.h>
+#include <ns3/spectrum-signal-parameters.h>
+#include <ns3/spectrum-model.h>
+#include <ns3/spectrum-value.h>
+#include <ns3/multi-model-spectrum-channel.h>
+#include <ns3/propagation-loss-model.h>
+#include <ns3/constant-position-mobility-model.h>
+#include <ns3/constant-velocity-mobility-model.h>
+#include <vector>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("SpectrumChannelCullingTest");
+
+/**
+ * \ingroup spectrum-tests
+ *
+ * Minimal SpectrumPhy counting the signals it receives
+ */
+class CountingSpectrumPhy : public SpectrumPhy
+{
+public:
+  CountingSpectrumPhy (Ptr<const SpectrumModel> model, Ptr<MobilityModel> mobility)
+    : m_model (model),
+      m_mobility (mobility),
+      m_nRx (0)
+  {
+  }
+  virtual void SetDevice (Ptr<NetDevice> d)
+  {
+  }
+  virtual Ptr<NetDevice> GetDevice () const
+  {
+    return 0;
+  }
+  virtual void SetMobility (Ptr<MobilityModel> m)
+  {
+    m_mobility = m;
+  }
+  virtual Ptr<MobilityModel> GetMobility ()
+  {
+    return m_mobility;
+  }
+  virtual void SetChannel (Ptr<SpectrumChannel> c)
+  {
+  }
+  virtual Ptr<const SpectrumModel> GetRxSpectrumModel () const
+  {
+    return m_model;
+  }
+  virtual Ptr<AntennaModel> GetRxAntenna ()
+  {
+    return 0;
+  }
+  virtual void StartRx (Ptr<SpectrumSignalParameters> params)
+  {
+    ++m_nRx;
+  }
+  uint32_t GetNRx (void) const
+  {
+    return m_nRx;
+  }
+private:
+  Ptr<const SpectrumModel> m_model;
+  Ptr<MobilityModel> m_mobility;
+  uint32_t m_nRx;
+};
+
+/**
+ * \ingroup spectrum-tests
+ *
+ * Check that the MaxRange and MinRxPowerDbm cutoffs of
+ * MultiModelSpectrumChannel deliver a signal only to the receivers in
+ * range, with and without the spatial index, and that moving receivers
+ * are not missed by the index.
+ */
+class SpectrumChannelCullingTestCase : public TestCase
+{
+public:
+  SpectrumChannelCullingTestCase (bool spatialIndex, bool useMinRxPower);
+  virtual ~SpectrumChannelCullingTestCase ();
+
+private:
+  virtual void DoRun (void);
+  void Transmit (Ptr<SpectrumChannel> channel, Ptr<SpectrumPhy> txPhy, Ptr<SpectrumValue> psd);
+
+  bool m_spatialIndex;
+  bool m_useMinRxPower;
+};
+
+SpectrumChannelCullingTestCase::SpectrumChannelCullingTestCase (bool spatialIndex, bool useMinRxPower)
+  : TestCase (std::string ("MultiModelSpectrumChannel culling")
+              + (useMinRxPower ? " by MinRxPowerDbm" : " by MaxRange")
+              + (spatialIndex ? " with spatial index" : "")),
+    m_spatialIndex (spatialIndex),
+    m_useMinRxPower (useMinRxPower)
+{
+}
+
+SpectrumChannelCullingTestCase::~SpectrumChannelCullingTestCase ()
+{
+}
+
+void
+SpectrumChannelCullingTestCase::Transmit (Ptr<SpectrumChannel> channel, Ptr<SpectrumPhy> txPhy, Ptr<SpectrumValue> psd)
+{
+  Ptr<SpectrumSignalParameters> params = Create<SpectrumSignalParameters> ();
+  params->duration = MicroSeconds (10);
+  params->txPhy = txPhy;
+  params->psd = psd;
+  channel->StartTx (params);
+}
+
+void
+SpectrumChannelCullingTestCase::DoRun (void)
+{
+  std::vector<double> freqs;
+  freqs.push_back (1.0e9);
+  freqs.push_back (1.1e9);
+  Ptr<SpectrumModel> model = Create<SpectrumModel> (freqs);
+  Ptr<SpectrumValue> psd = Create<SpectrumValue> (model);
+  // 1 W in total over the two 100 MHz bands
+  (*psd) = 0.5e-8;
+
+  Ptr<MultiModelSpectrumChannel> channel = CreateObject<MultiModelSpectrumChannel> ();
+  // a loss of 1 dB per meter, so that the received power is 30 - d dBm
+  Ptr<MatrixPropagationLossModel> loss = CreateObject<MatrixPropagationLossModel> ();
+  if (m_useMinRxPower)
+    {
+      channel->SetAttribute ("MinRxPowerDbm", DoubleValue (-220));
+    }
+  else
+    {
+      channel->SetAttribute ("MaxRange", DoubleValue (250));
+    }
+  channel->SetAttribute ("SpatialIndex", BooleanValue (m_spatialIndex));
+  channel->AddPropagationLossModel (loss);
+
+  double distances[] = { 0, 10, 100, 240, 260, 1000, 5000 };
+  std::vector<Ptr<CountingSpectrumPhy> > phys;
+  for (uint32_t i = 0; i < sizeof (distances) / sizeof (double); ++i)
+    {
+      Ptr<ConstantPositionMobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+      mobility->SetPosition (Vector (distances[i], 0, 0));
+      phys.push_back (CreateObject<CountingSpectrumPhy> (model, mobility));
+      channel->AddRx (phys.back ());
+      if (i > 0)
+        {
+          loss->SetLoss (phys[0]->GetMobility (), mobility, distances[i]);
+        }
+    }
+  // a receiver that starts far away and moves towards the transmitter
+  Ptr<ConstantVelocityMobilityModel> moving = CreateObject<ConstantVelocityMobilityModel> ();
+  moving->SetPosition (Vector (2000, 0, 0));
+  moving->SetVelocity (Vector (-100, 0, 0));
+  phys.push_back (CreateObject<CountingSpectrumPhy> (model, moving));
+  channel->AddRx (phys.back ());
+  loss->SetLoss (phys[0]->GetMobility (), moving, 1000);
+
+  Simulator::Schedule (Seconds (0), &SpectrumChannelCullingTestCase::Transmit, this, channel, phys[0], psd);
+  Simulator::Run ();
+
+  uint32_t expected[] = { 0, 1, 1, 1, 0, 0, 0, 0 };
+  for (uint32_t i = 0; i < phys.size (); ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (phys[i]->GetNRx (), expected[i], "unexpected number of receptions for receiver " << i);
+    }
+  NS_TEST_ASSERT_MSG_EQ (channel->GetNCulledLinks (), 4u, "unexpected number of culled links");
+
+  if (!m_useMinRxPower)
+    {
+      // the moving receiver is now 100 m away from the transmitter
+      Simulator::Schedule (Seconds (19), &SpectrumChannelCullingTestCase::Transmit, this, channel, phys[0], psd);
+      Simulator::Run ();
+      NS_TEST_ASSERT_MSG_EQ (phys.back ()->GetNRx (), 1u, "moving receiver in range did not receive the signal");
+
+      // a receiver sharing the mobility model of another one, added twice
+      Ptr<CountingSpectrumPhy> shared = CreateObject<CountingSpectrumPhy> (model, phys[1]->GetMobility ());
+      channel->AddRx (shared);
+      channel->AddRx (shared);
+
+      // a receiver that is moved far away is culled, with the receivers sharing its mobility model
+      phys[1]->GetMobility ()->SetPosition (Vector (3000, 0, 0));
+      Simulator::Schedule (Seconds (0), &SpectrumChannelCullingTestCase::Transmit, this, channel, phys[0], psd);
+      Simulator::Run ();
+      NS_TEST_ASSERT_MSG_EQ (phys[1]->GetNRx (), 2u, "receiver moved out of range received the signal");
+      NS_TEST_ASSERT_MSG_EQ (shared->GetNRx (), 0u, "receiver sharing a mobility model moved out of range received the signal");
+      NS_TEST_ASSERT_MSG_EQ (phys[2]->GetNRx (), 3u, "receiver in range missed a signal");
+    }
+
+  channel->Dispose ();
+  Simulator::Destroy ();
+}
+
+
+/**
+ * \ingroup spectrum-tests
+ *
+ * Test suite for the receiver culling of MultiModelSpectrumChannel
+ */
+class SpectrumChannelCullingTestSuite : public TestSuite
+{
+public:
+  SpectrumChannelCullingTestSuite ();
+};
+
+SpectrumChannelCullingTestSuite::SpectrumChannelCullingTestSuite ()
+  : TestSuite ("spectrum-channel-culling", UNIT)
+{
+  AddTestCase (new SpectrumChannelCullingTestCase (false, false), TestCase::QUICK);
+  AddTestCase (new SpectrumChannelCullingTestCase (true, false), TestCase::QUICK);
+  AddTestCase (new SpectrumChannelCullingTestCase (false, true), TestCase::QUICK);
+}
+
+static SpectrumChannelCullingTestSuite g_spectrumChannelCullingTestSuite;
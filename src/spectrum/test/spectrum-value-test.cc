@@ -25,6 +25,7 @@
 #include <ns3/test.h>
 #include <iostream>
 #include <cmath>
+#include <ctime>
 
 #include "spectrum-test.h"
 
@@ -242,6 +243,22 @@ SpectrumValueTestSuite::SpectrumValueTestSuite ()
   AddTestCase (new SpectrumValueTestCase (tv1rs3, v1rs3, "tv1rs3 = v1 >> 3"), TestCase::QUICK);
 
 
+  // the fused operations give the same values as the operator chains
+  SpectrumValue fAddScaled = v1;
+  fAddScaled.AddScaled (v2, doubleValue);
+  AddTestCase (new SpectrumValueTestCase (fAddScaled, v1 + v2 * doubleValue, "AddScaled (v2, doubleValue)"), TestCase::QUICK);
+
+  SpectrumValue fProduct (f), fQuotient (f);
+  fProduct.SetProduct (v1, v2);
+  fQuotient.SetQuotient (v1, v2);
+  AddTestCase (new SpectrumValueTestCase (fProduct, v5, "SetProduct (v1, v2)"), TestCase::QUICK);
+  AddTestCase (new SpectrumValueTestCase (fQuotient, v6, "SetQuotient (v1, v2)"), TestCase::QUICK);
+
+  // a value without a model takes the model of the operands
+  SpectrumValue fSinr;
+  fSinr.SetSinr (v1, v3, v7);
+  AddTestCase (new SpectrumValueTestCase (fSinr, v1 / (v3 - v1 + v7), "SetSinr (v1, v3, v7)"), TestCase::QUICK);
+
 }
 
 
@@ -336,6 +353,105 @@ SpectrumConverterTestSuite::SpectrumConverterTestSuite ()
 
 
 
+/**
+ * Time the SINR and the accumulation of the chunk processors, once with
+ * the operators, which create a temporary SpectrumValue for each
+ * operation, and once with the fused operations, which write in place.
+ */
+class SpectrumValueFusedTimeTestCase : public TestCase
+{
+public:
+  SpectrumValueFusedTimeTestCase ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Print the time taken by a pass
+   * \param how the name of the pass
+   * \param ticks the clock ticks taken by the pass
+   * \param heap the heap allocations of the pool during the pass
+   */
+  void Report (std::string how, clock_t ticks, uint64_t heap) const;
+};
+
+/// Number of bands of the values
+#define FUSED_TIME_BANDS 1024
+/// Number of chunks evaluated by each pass
+#define FUSED_TIME_REPETITIONS 20000
+
+SpectrumValueFusedTimeTestCase::SpectrumValueFusedTimeTestCase ()
+  : TestCase ("SINR evaluation time, operators vs fused operations")
+{
+}
+
+void
+SpectrumValueFusedTimeTestCase::Report (std::string how, clock_t ticks, uint64_t heap) const
+{
+  double per = 1E6 * double (ticks) / (double (FUSED_TIME_REPETITIONS) * double (CLOCKS_PER_SEC));
+  std::cout << "spectrum-value-fused-perf: " << how << ": ticks: " << ticks
+            << "\tper: " << per << " microsec/chunk"
+            << "\theap allocations: " << heap
+            << std::endl;
+}
+
+void
+SpectrumValueFusedTimeTestCase::DoRun (void)
+{
+  std::vector<double> freqs;
+  for (int i = 0; i < FUSED_TIME_BANDS; i++)
+    {
+      freqs.push_back (28e9 + i * 1e6);
+    }
+  Ptr<SpectrumModel> f = Create<SpectrumModel> (freqs);
+
+  SpectrumValue rx (f), all (f), noise (f);
+  for (int i = 0; i < FUSED_TIME_BANDS; i++)
+    {
+      rx[i] = 1e-12 * (1 + i % 7);
+      all[i] = rx[i] + 1e-13 * (1 + i % 3);
+      noise[i] = 4e-21;
+    }
+
+  SpectrumValue sumOperators (f);
+  uint64_t heap = SpectrumValuePool::GetHeapAllocations ();
+  clock_t start = clock ();
+  for (int n = 0; n < FUSED_TIME_REPETITIONS; n++)
+    {
+      SpectrumValue sinr = rx / (all - rx + noise);
+      sumOperators += sinr * 1e-6;
+    }
+  Report ("operators", clock () - start, SpectrumValuePool::GetHeapAllocations () - heap);
+
+  SpectrumValue sumFused (f), sinr (f);
+  heap = SpectrumValuePool::GetHeapAllocations ();
+  start = clock ();
+  for (int n = 0; n < FUSED_TIME_REPETITIONS; n++)
+    {
+      sinr.SetSinr (rx, all, noise);
+      sumFused.AddScaled (sinr, 1e-6);
+    }
+  Report ("fused", clock () - start, SpectrumValuePool::GetHeapAllocations () - heap);
+
+  NS_TEST_ASSERT_MSG_EQ_TOL (Sum (sumFused), Sum (sumOperators), 1e-9 * Sum (sumOperators),
+                             "the fused operations changed the result");
+}
+
+
+class SpectrumValuePerformanceTestSuite : public TestSuite
+{
+public:
+  SpectrumValuePerformanceTestSuite ();
+};
+
+SpectrumValuePerformanceTestSuite::SpectrumValuePerformanceTestSuite ()
+  : TestSuite ("spectrum-value-fused-perf", PERFORMANCE)
+{
+  AddTestCase (new SpectrumValueFusedTimeTestCase, TestCase::QUICK);
+}
+
+
+
 // static instance of test suites
 static SpectrumValueTestSuite g_SpectrumValueTestSuite;
 static SpectrumConverterTestSuite g_SpectrumConverterTestSuite;
+static SpectrumValuePerformanceTestSuite g_SpectrumValuePerformanceTestSuite;
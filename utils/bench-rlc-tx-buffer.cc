@@ -0,0 +1,109 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+#include "ns3/packet.h"
+#include "ns3/lte-rlc-um.h"
+#include "ns3/lte-rlc-sap.h"
+#include "ns3/lte-mac-sap.h"
+#include <iostream>
+
+using namespace ns3;
+
+/// MAC that drops every PDU, so that only the RLC transmission path is measured
+class BenchMacSapProvider : public LteMacSapProvider
+{
+public:
+  BenchMacSapProvider ()
+    : m_nPdus (0),
+      m_nBytes (0)
+  {
+  }
+  virtual void TransmitPdu (TransmitPduParameters params)
+  {
+    m_nPdus++;
+    m_nBytes += params.pdu->GetSize ();
+  }
+  virtual void ReportBufferStatus (ReportBufferStatusParameters params)
+  {
+  }
+  uint64_t m_nPdus;
+  uint64_t m_nBytes;
+};
+
+int main (int argc, char *argv[])
+{
+  uint32_t bufferSize = 10 * 1024 * 1024;
+  uint32_t sduSize = 1400;
+  uint32_t txOpportunity = 1000;
+
+  CommandLine cmd;
+  cmd.Usage ("Fill the transmission buffer of an UM RLC entity with SDUs,\n"
+             "then drain it with fixed size transmission opportunities.");
+  cmd.AddValue ("bufferSize", "size of the RLC transmission buffer in bytes", bufferSize);
+  cmd.AddValue ("sduSize", "size of each SDU in bytes", sduSize);
+  cmd.AddValue ("txOpportunity", "size of each transmission opportunity in bytes", txOpportunity);
+  cmd.Parse (argc, argv);
+
+  BenchMacSapProvider mac;
+  Ptr<LteRlcUm> rlc = CreateObject<LteRlcUm> ();
+  rlc->SetAttribute ("MaxTxBufferSize", UintegerValue (bufferSize));
+  rlc->SetRnti (1);
+  rlc->SetLcId (3);
+  rlc->SetLteMacSapProvider (&mac);
+
+  uint32_t nSdus = bufferSize / sduSize;
+  SystemWallClockMs clock;
+
+  clock.Start ();
+  for (uint32_t i = 0; i < nSdus; i++)
+    {
+      LteRlcSapProvider::TransmitPdcpPduParameters params;
+      params.pdcpPdu = Create<Packet> (sduSize);
+      params.rnti = 1;
+      params.lcid = 3;
+      rlc->GetLteRlcSapProvider ()->TransmitPdcpPdu (params);
+    }
+  int64_t fillMs = clock.End ();
+
+  // with txOpportunity < sduSize most SDUs are segmented, and the
+  // remaining segment goes back to the head of the buffer
+  clock.Start ();
+  uint64_t nOpportunities = 0;
+  uint64_t nPdus;
+  do
+    {
+      // an empty buffer does not send any PDU
+      nPdus = mac.m_nPdus;
+      rlc->GetLteMacSapUser ()->NotifyTxOpportunity (txOpportunity, 0, 0);
+      nOpportunities++;
+    }
+  while (mac.m_nPdus != nPdus);
+  int64_t drainMs = clock.End ();
+
+  std::cout << "sdus=" << nSdus
+            << " fill=" << fillMs << "ms"
+            << " opportunities=" << nOpportunities
+            << " pdus=" << mac.m_nPdus
+            << " drain=" << drainMs << "ms" << std::endl;
+
+  rlc->Dispose ();
+  Simulator::Destroy ();
+  return 0;
+}
@@ -0,0 +1,216 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/object-factory.h"
+#include "ns3/scheduler.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/double.h"
+#include <iomanip>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+/** An event of the workload: the time it is scheduled at, and its timestamp. */
+struct Record
+{
+  uint64_t now;
+  uint64_t ts;
+};
+
+/**
+ * Read the events of a DES metrics trace, recorded by running a
+ * scenario with --enable-des-metrics. Each event is a line
+ *   ["send context","now","receive context","timestamp"]
+ * in the order of their scheduling.
+ */
+static bool
+ReadTrace (std::string filename, std::vector<Record> &records)
+{
+  std::ifstream input (filename.c_str ());
+  if (!input.is_open ())
+    {
+      return false;
+    }
+  std::string line;
+  while (std::getline (input, line))
+    {
+      std::vector<std::string> fields;
+      std::string::size_type start = line.find ('"');
+      while (start != std::string::npos)
+        {
+          std::string::size_type end = line.find ('"', start + 1);
+          if (end == std::string::npos)
+            {
+              break;
+            }
+          fields.push_back (line.substr (start + 1, end - start - 1));
+          start = line.find ('"', end + 1);
+        }
+      // The header lines are "key" : "value"
+      if (fields.size () != 4 || line.find ('[') == std::string::npos)
+        {
+          continue;
+        }
+      Record record;
+      std::istringstream now (fields[1]);
+      std::istringstream ts (fields[3]);
+      if ((now >> record.now) && (ts >> record.ts))
+        {
+          records.push_back (record);
+        }
+    }
+  return true;
+}
+
+/**
+ * Generate the events of slotted PHYs: at the start of each slot, a burst
+ * of events at the start of the next slot, one event per symbol, and
+ * sometimes a timer a few milliseconds later.
+ */
+static void
+GenerateSlots (uint32_t slots, uint32_t burst, std::vector<Record> &records)
+{
+  const uint64_t slot = 125000;           // 125 us, in ns
+  const uint64_t symbol = slot / 14;
+  Ptr<UniformRandomVariable> timer = CreateObject<UniformRandomVariable> ();
+  timer->SetAttribute ("Min", DoubleValue (1e6));
+  timer->SetAttribute ("Max", DoubleValue (200e6));
+
+  for (uint64_t i = 0; i < slots; i++)
+    {
+      Record record;
+      record.now = i * slot;
+      for (uint32_t j = 0; j < burst; j++)
+        {
+          record.ts = record.now + slot;
+          records.push_back (record);
+        }
+      for (uint32_t j = 1; j < 14; j++)
+        {
+          record.ts = record.now + j * symbol;
+          records.push_back (record);
+        }
+      if (i % 8 == 0)
+        {
+          record.ts = record.now + timer->GetInteger ();
+          records.push_back (record);
+        }
+    }
+}
+
+/**
+ * Replay the events against a scheduler: the events earlier than the time
+ * an event is scheduled at are removed before it is inserted.
+ *
+ * \returns The wall clock time, in ms.
+ */
+static int64_t
+Replay (std::string type, const std::vector<Record> &records)
+{
+  ObjectFactory factory (type);
+  Ptr<Scheduler> scheduler = factory.Create<Scheduler> ();
+  Scheduler::Event ev;
+  ev.impl = 0;
+  ev.key.m_context = 0;
+  ev.key.m_uid = 0;
+  SystemWallClockMs clock;
+
+  clock.Start ();
+  for (std::vector<Record>::const_iterator i = records.begin (); i != records.end (); i++)
+    {
+      while (!scheduler->IsEmpty () && scheduler->PeekNext ().key.m_ts < i->now)
+        {
+          scheduler->RemoveNext ();
+        }
+      ev.key.m_ts = i->ts;
+      ev.key.m_uid++;
+      scheduler->Insert (ev);
+    }
+  while (!scheduler->IsEmpty ())
+    {
+      scheduler->RemoveNext ();
+    }
+  return clock.End ();
+}
+
+int main (int argc, char *argv[])
+{
+  std::string filename = "";
+  uint32_t slots = 200000;
+  uint32_t burst = 20;
+  uint32_t runs = 1;
+
+  CommandLine cmd;
+  cmd.Usage ("Replay a workload of events against each scheduler.\n"
+             "\n"
+             "The workload is the events of a DES metrics trace, given by the\n"
+             "--file=\"<filename>\" argument and recorded by running a scenario\n"
+             "with ns-3 configured with --enable-des-metrics. Without a trace,\n"
+             "the workload is a burst of events at the start of each 125 us slot.");
+  cmd.AddValue ("file", "DES metrics trace to replay", filename);
+  cmd.AddValue ("slots", "number of slots of the generated workload", slots);
+  cmd.AddValue ("burst", "number of events at the start of each slot", burst);
+  cmd.AddValue ("runs", "number of runs per scheduler", runs);
+  cmd.Parse (argc, argv);
+
+  std::vector<Record> records;
+  if (filename != "")
+    {
+      if (!ReadTrace (filename, records))
+        {
+          std::cerr << "cannot open " << filename << std::endl;
+          return 1;
+        }
+    }
+  else
+    {
+      GenerateSlots (slots, burst, records);
+    }
+  std::cout << "events: " << records.size () << std::endl;
+
+  const char *schedulers[] = {
+    "ns3::ListScheduler",
+    "ns3::MapScheduler",
+    "ns3::HeapScheduler",
+    "ns3::CalendarScheduler",
+    "ns3::LadderScheduler"
+  };
+  std::cout << std::left << std::setw (24) << "Scheduler"
+            << std::setw (12) << "Time (ms)"
+            << "Rate (ev/s)" << std::endl;
+  for (uint32_t i = 0; i < sizeof (schedulers) / sizeof (schedulers[0]); i++)
+    {
+      // The ListScheduler is quadratic: skip it for large workloads
+      if (i == 0 && records.size () > 1000000)
+        {
+          continue;
+        }
+      for (uint32_t run = 0; run < runs; run++)
+        {
+          int64_t ms = Replay (schedulers[i], records);
+          std::cout << std::left << std::setw (24) << schedulers[i]
+                    << std::setw (12) << ms
+                    << (ms > 0 ? records.size () * 1000.0 / ms : 0) << std::endl;
+        }
+    }
+  return 0;
+}
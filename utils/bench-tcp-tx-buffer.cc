@@ -0,0 +1,86 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/packet.h"
+#include "ns3/tcp-tx-buffer.h"
+#include <iostream>
+
+using namespace ns3;
+
+int main (int argc, char *argv[])
+{
+  uint32_t segments = 10000;
+  uint32_t segmentSize = 1448;
+  uint32_t writeSize = 1000;
+  uint32_t retransmissions = 1000;
+
+  CommandLine cmd;
+  cmd.Usage ("Fill a TCP transmission buffer with a window of segments, send\n"
+             "every segment of the window, retransmit some of them, then\n"
+             "acknowledge the window one segment at a time.");
+  cmd.AddValue ("segments", "number of segments in the window", segments);
+  cmd.AddValue ("segmentSize", "size of each segment in bytes", segmentSize);
+  cmd.AddValue ("writeSize", "size of each application write in bytes", writeSize);
+  cmd.AddValue ("retransmissions", "number of segments retransmitted", retransmissions);
+  cmd.Parse (argc, argv);
+
+  uint32_t window = segments * segmentSize;
+  Ptr<TcpTxBuffer> buffer = CreateObject<TcpTxBuffer> ();
+  buffer->SetMaxBufferSize (window);
+  SequenceNumber32 head = buffer->HeadSequence ();
+  SystemWallClockMs clock;
+
+  clock.Start ();
+  while (buffer->Available () > 0)
+    {
+      buffer->Add (Create<Packet> (std::min (writeSize, buffer->Available ())));
+    }
+  int64_t fillMs = clock.End ();
+
+  clock.Start ();
+  uint64_t bytes = 0;
+  for (uint32_t i = 0; i < segments; i++)
+    {
+      bytes += buffer->CopyFromSequence (segmentSize, head + i * segmentSize)->GetSize ();
+    }
+  int64_t sendMs = clock.End ();
+
+  // the retransmitted segments are spread over the window
+  clock.Start ();
+  for (uint32_t i = 0; i < retransmissions; i++)
+    {
+      uint32_t segment = (uint64_t) i * segments / retransmissions;
+      bytes += buffer->CopyFromSequence (segmentSize, head + segment * segmentSize)->GetSize ();
+    }
+  int64_t retxMs = clock.End ();
+
+  clock.Start ();
+  for (uint32_t i = 1; i <= segments; i++)
+    {
+      buffer->DiscardUpTo (head + i * segmentSize);
+    }
+  int64_t ackMs = clock.End ();
+
+  std::cout << "segments=" << segments
+            << " fill=" << fillMs << "ms"
+            << " send=" << sendMs << "ms"
+            << " retransmit=" << retxMs << "ms"
+            << " ack=" << ackMs << "ms"
+            << " bytes=" << bytes << std::endl;
+  return 0;
+}
@@ -0,0 +1,159 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/command-line.h"
+#include "ns3/flow-monitor-stream.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace ns3;
+
+int main (int argc, char *argv[])
+{
+  std::string input = "";
+  std::string output = "-";
+  bool totals = false;
+  bool follow = false;
+
+  CommandLine cmd;
+  cmd.Usage ("Convert a binary flow statistics file (written by ns3::FlowMonitorStream\n"
+             "with Format=Binary) to CSV, or sum the records of each flow.");
+  cmd.AddValue ("input",  "binary flow statistics file to read",                  input);
+  cmd.AddValue ("output", "CSV file to write, \"-\" for standard output",        output);
+  cmd.AddValue ("totals", "write one line per flow with the sum of its records",  totals);
+  cmd.AddValue ("follow", "keep reading the records appended by a running simulation", follow);
+  cmd.Parse (argc, argv);
+
+  if (input.empty ())
+    {
+      std::cerr << cmd.GetName () << ": --input is required" << std::endl;
+      return 1;
+    }
+  if (totals && follow)
+    {
+      std::cerr << cmd.GetName () << ": --totals and --follow are exclusive" << std::endl;
+      return 1;
+    }
+
+  FILE *in = fopen (input.c_str (), "rb");
+  if (in == 0)
+    {
+      std::cerr << cmd.GetName () << ": cannot open " << input << std::endl;
+      return 1;
+    }
+  FILE *out = stdout;
+  if (output != "-")
+    {
+      out = fopen (output.c_str (), "w");
+      if (out == 0)
+        {
+          std::cerr << cmd.GetName () << ": cannot open " << output << std::endl;
+          fclose (in);
+          return 1;
+        }
+    }
+
+  uint8_t headerData[FlowMonitorStream::BINARY_HEADER_SIZE];
+  FlowMonitorStream::BinaryHeader header;
+  if (fread (headerData, 1, sizeof (headerData), in) != sizeof (headerData)
+      || !FlowMonitorStream::DecodeHeader (headerData, header))
+    {
+      std::cerr << cmd.GetName () << ": " << input << " is not a flow statistics binary file" << std::endl;
+      fclose (in);
+      return 1;
+    }
+
+  std::string line = FlowMonitorStream::GetCsvHeader ();
+  fwrite (line.data (), 1, line.size (), out);
+
+  // read in large blocks of whole records
+  const size_t recordsPerBlock = 4096;
+  std::vector<uint8_t> block (recordsPerBlock * FlowMonitorStream::RECORD_SIZE);
+  std::map<FlowId, FlowMonitorStream::Record> sums;
+  uint64_t records = 0;
+  size_t used = 0;
+  while (true)
+    {
+      // a running simulation may have written a part of a record
+      size_t n = fread (&block[used], 1, block.size () - used, in);
+      used += n;
+      size_t complete = used / FlowMonitorStream::RECORD_SIZE;
+      for (size_t i = 0; i < complete; i++)
+        {
+          FlowMonitorStream::Record record;
+          FlowMonitorStream::DecodeRecord (&block[i * FlowMonitorStream::RECORD_SIZE], record);
+          if (!totals)
+            {
+              line = FlowMonitorStream::FormatCsv (record);
+              fwrite (line.data (), 1, line.size (), out);
+              continue;
+            }
+          std::map<FlowId, FlowMonitorStream::Record>::iterator sum = sums.find (record.flowId);
+          if (sum == sums.end ())
+            {
+              sums.insert (std::make_pair (record.flowId, record));
+              continue;
+            }
+          sum->second.timeNs = record.timeNs;
+          sum->second.txPackets += record.txPackets;
+          sum->second.txBytes += record.txBytes;
+          sum->second.rxPackets += record.rxPackets;
+          sum->second.lostPackets += record.lostPackets;
+          sum->second.rxBytes += record.rxBytes;
+          sum->second.delaySumNs += record.delaySumNs;
+          sum->second.jitterSumNs += record.jitterSumNs;
+          sum->second.timesForwarded += record.timesForwarded;
+          sum->second.packetsDropped += record.packetsDropped;
+          sum->second.bytesDropped += record.bytesDropped;
+        }
+      records += complete;
+      size_t rest = used - complete * FlowMonitorStream::RECORD_SIZE;
+      std::copy (block.begin () + complete * FlowMonitorStream::RECORD_SIZE, block.begin () + used,
+                 block.begin ());
+      used = rest;
+      if (n == 0)
+        {
+          if (!follow)
+            {
+              break;
+            }
+          fflush (out);
+          std::this_thread::sleep_for (std::chrono::milliseconds (500));
+          clearerr (in);
+        }
+    }
+
+  for (std::map<FlowId, FlowMonitorStream::Record>::const_iterator sum = sums.begin ();
+       sum != sums.end (); ++sum)
+    {
+      line = FlowMonitorStream::FormatCsv (sum->second);
+      fwrite (line.data (), 1, line.size (), out);
+    }
+
+  fclose (in);
+  if (out != stdout)
+    {
+      fclose (out);
+    }
+  std::cerr << cmd.GetName () << ": read " << records << " records" << std::endl;
+  return 0;
+}
@@ -0,0 +1,60 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015, NYU WIRELESS, Tandon School of Engineering, New York University
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/command-line.h"
+#include "ns3/mmwave-raytracing-traces.h"
+#include <iostream>
+#include <string>
+
+using namespace ns3;
+
+int main (int argc, char *argv[])
+{
+  std::string input = "";
+  std::string output = "";
+
+  CommandLine cmd;
+  cmd.Usage ("Convert a Quadriga raytracing text file to the binary format\n"
+             "that ns3::MmWaveChannelRaytracing::TraceFile maps in memory.");
+  cmd.AddValue ("input",  "raytracing text file to read", input);
+  cmd.AddValue ("output", "binary file to write",         output);
+  cmd.Parse (argc, argv);
+
+  if (input.empty () || output.empty ())
+    {
+      std::cerr << cmd.GetName () << ": --input and --output are required" << std::endl;
+      return 1;
+    }
+
+  Ptr<MmWaveRaytracingTraces> traces = MmWaveRaytracingTraces::Load (input);
+  if (!traces->WriteBinary (output))
+    {
+      std::cerr << cmd.GetName () << ": cannot write " << output << std::endl;
+      return 1;
+    }
+
+  // read the file back, so that a broken output is reported here
+  Ptr<MmWaveRaytracingTraces> check = MmWaveRaytracingTraces::Load (output);
+  if (!check->IsMapped () || check->GetNTraces () != traces->GetNTraces ())
+    {
+      std::cerr << cmd.GetName () << ": " << output << " does not read back" << std::endl;
+      return 1;
+    }
+  std::cout << "Converted " << traces->GetNTraces () << " traces to " << output << std::endl;
+  return 0;
+}
@@ -0,0 +1,97 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015, NYU WIRELESS, Tandon School of Engineering, New York University
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/command-line.h"
+#include "ns3/mmwave-trace-writer.h"
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+int main (int argc, char *argv[])
+{
+  std::string input = "";
+  std::string output = "-";
+
+  CommandLine cmd;
+  cmd.Usage ("Convert a binary mmWave PHY trace file (written with\n"
+             "ns3::MmWaveTraceWriter::Format=Binary) to the text format.");
+  cmd.AddValue ("input",  "binary trace file to read",                      input);
+  cmd.AddValue ("output", "text file to write, \"-\" for standard output", output);
+  cmd.Parse (argc, argv);
+
+  if (input.empty ())
+    {
+      std::cerr << cmd.GetName () << ": --input is required" << std::endl;
+      return 1;
+    }
+
+  FILE *in = fopen (input.c_str (), "rb");
+  if (in == 0)
+    {
+      std::cerr << cmd.GetName () << ": cannot open " << input << std::endl;
+      return 1;
+    }
+  FILE *out = stdout;
+  if (output != "-")
+    {
+      out = fopen (output.c_str (), "w");
+      if (out == 0)
+        {
+          std::cerr << cmd.GetName () << ": cannot open " << output << std::endl;
+          fclose (in);
+          return 1;
+        }
+    }
+
+  uint8_t headerData[MmWaveTraceWriter::BINARY_HEADER_SIZE];
+  MmWaveTraceWriter::BinaryHeader header;
+  if (fread (headerData, 1, sizeof (headerData), in) != sizeof (headerData)
+      || !MmWaveTraceWriter::DecodeHeader (headerData, header))
+    {
+      std::cerr << cmd.GetName () << ": " << input << " is not a mmWave binary trace" << std::endl;
+      fclose (in);
+      return 1;
+    }
+
+  // read in large blocks of whole records
+  const size_t recordsPerBlock = 4096;
+  std::vector<uint8_t> block (recordsPerBlock * header.m_recordSize);
+  uint64_t records = 0;
+  size_t n;
+  while ((n = fread (&block[0], header.m_recordSize, recordsPerBlock, in)) > 0)
+    {
+      for (size_t i = 0; i < n; i++)
+        {
+          std::string line = MmWaveTraceWriter::DecodeRecordToText (header.m_recordType,
+                                                                    &block[i * header.m_recordSize]);
+          fwrite (line.data (), 1, line.size (), out);
+        }
+      records += n;
+    }
+
+  fclose (in);
+  if (out != stdout)
+    {
+      fclose (out);
+    }
+  std::cerr << cmd.GetName () << ": converted " << records << " records" << std::endl;
+  return 0;
+}